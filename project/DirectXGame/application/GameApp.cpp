@@ -18,7 +18,8 @@ void GameApp::Initialize() {
   services.imgui = &GetImGui();
   services.framework = this;
 
-  Renderer::GetInstance()->Initialize(&GetDX());
+  // モデルの頂点は 16 バイトの圧縮形式で持つ
+  Renderer::GetInstance()->Initialize(&GetDX(), ModelVertexFormat::Packed);
   sceneManager_->Initialize(services);
   sceneManager_->SetFactory(std::make_unique<SceneFactory>());
   sceneManager_->Start(SceneId::Title);
@@ -36,6 +37,10 @@ void GameApp::Update() {
     return;
   }
   sceneManager_->Update();
+  if (sceneManager_->HasPendingChange()) {
+    // 旧シーンのリソースを先行フレームがまだ参照しているので、破棄前に GPU を待つ
+    GetDX().WaitForGpuIdle();
+  }
   sceneManager_->ApplySceneChangeIfNeeded();
 }
 
@@ -45,4 +50,7 @@ void GameApp::Draw() {
   if (sceneManager_) {
     sceneManager_->Draw();
   }
+
+  // シーンが積んだ描画をソートしてまとめて記録
+  Renderer::GetInstance()->Flush();
 }
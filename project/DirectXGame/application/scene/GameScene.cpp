@@ -1,8 +1,13 @@
 #define NOMINMAX
 #include "GameScene.h"
 
+#include "AssetLoadQueue.h"
+#include "AssetLoader.h"
 #include "DebugCamera.h"
+#include "DirectXCommon.h"
+#include "FrameWork.h"
 #include "GameCamera.h"
+#include "GpuMemoryAllocator.h"
 #include "ModelManager.h"
 #include "ParticleManager.h"
 #include "Renderer.h"
@@ -353,6 +358,71 @@ void GameScene::Update() {
                     10.0f);
   ImGui::SliderAngle("UVRotate", &uvTransformSprite_.rotate.z);
 
+  ImGui::Separator();
+  {
+    // 直前フレームの RenderQueue 統計
+    const RenderQueueStats &rq = Renderer::GetInstance()->GetQueueStats();
+    ImGui::Text("RenderQueue: draws %u / binds %u / saved %u", rq.drawn,
+                rq.TotalBinds(), rq.TotalSaved());
+    bool parallel = Renderer::GetInstance()->IsParallelRecording();
+    if (ImGui::Checkbox("Parallel Recording", &parallel)) {
+      Renderer::GetInstance()->SetParallelRecording(parallel);
+    }
+    ImGui::SameLine();
+    ImGui::Text("worker lists: %u",
+                Renderer::GetInstance()->GetLastWorkerListCount());
+
+    // 先行投入フレーム数と、直近のフレーム終了で GPU 待ちが発生したか
+    FramePacer &pacer = Renderer::GetInstance()->GetDX()->GetFramePacer();
+    ImGui::Text("Frames in flight: %u (slot %u)%s", pacer.GetFramesInFlight(),
+                pacer.GetFrameIndex(),
+                pacer.DidStallLastAdvance() ? " / GPU bound" : "");
+
+    // 静的バッファの転送（読み込みがまとめて投入されているか）
+    const GpuUploadQueue::Stats up =
+        Renderer::GetInstance()->GetDX()->GetUploadQueue().GetStats();
+    ImGui::Text("Uploads: %u copies / %u submits / %u stalls (%.1f MB)",
+                up.copies, up.submissions, up.stagingStalls,
+                up.uploadedBytes / (1024.0 * 1024.0));
+
+    // 非同期読み込み（ワーカーの作業 / 描画スレッドでの仕上げ待ち）
+    const AssetLoadQueue::Stats load = AssetLoadQueue::GetInstance()->GetStats();
+    ImGui::Text("Asset loads: %u working / %u finalizing / %llu done",
+                load.working, load.finalizing,
+                static_cast<unsigned long long>(load.completedFinalize));
+    // アセットキャッシュ（種類ごとの使用量 / 予算と、ヒット・追い出しの回数）
+    auto cacheLine = [](const char *name, const auto &st) {
+      ImGui::Text("%s: %.1f / %.1f MB, %u entries (%u pinned) / hit %llu / "
+                  "shared %llu / miss %llu / evicted %llu",
+                  name, st.bytes / (1024.0 * 1024.0),
+                  st.budget / (1024.0 * 1024.0), st.entries, st.pinned,
+                  static_cast<unsigned long long>(st.hits),
+                  static_cast<unsigned long long>(st.inFlightHits),
+                  static_cast<unsigned long long>(st.misses),
+                  static_cast<unsigned long long>(st.evictions));
+    };
+    cacheLine("ModelData (CPU)", AssetLoader::GetInstance()->GetCacheStats());
+    cacheLine("Models (VB/IB)", ModelManager::GetInstance()->GetCacheStats());
+    cacheLine("Textures", TextureManager::GetInstance()->GetCacheStats());
+
+    // 共有ヒープの使用量・断片化と、OS から見た VRAM 予算
+    auto *gpuMem = GpuMemoryAllocator::GetInstance();
+    const auto budget = gpuMem->GetBudgetReport();
+    ImGui::Text("VRAM: %.1f / %.1f MB (heaps %.1f MB, used %.1f MB)",
+                budget.localUsage / (1024.0 * 1024.0),
+                budget.localBudget / (1024.0 * 1024.0),
+                budget.heapBytes / (1024.0 * 1024.0),
+                budget.usedBytes / (1024.0 * 1024.0));
+    for (uint32_t i = 0; i < static_cast<uint32_t>(GpuMemoryPool::Count); ++i) {
+      const GpuMemoryPool pool = static_cast<GpuMemoryPool>(i);
+      const auto stats = gpuMem->GetPoolStats(pool);
+      ImGui::Text("  %s: heaps %u / allocs %u / frag %.2f / dedicated %u",
+                  GpuMemoryAllocator::GetPoolName(pool), stats.heapCount,
+                  stats.allocationCount, stats.Fragmentation(),
+                  stats.dedicatedCount);
+    }
+  }
+
   ImGui::End();
 
   // Transform Camera override
@@ -363,14 +433,22 @@ void GameScene::Update() {
 
 #endif
 
-  const float deltaTime = 1.0f / 60.0f;
+  const float frameDeltaTime = services_.framework
+                                   ? services_.framework->GetDeltaTime()
+                                   : particleClock_.GetStep();
 
-  particleEmitter_.Update(deltaTime);
+  auto *particleManager = ParticleManager::GetInstance();
+  particleManager->SetEnableAccelerationField(enableAccelerationField_);
+  particleManager->SetAccelerationField(accelerationField_);
 
-  ParticleManager::GetInstance()->SetEnableAccelerationField(
-      enableAccelerationField_);
-  ParticleManager::GetInstance()->SetAccelerationField(accelerationField_);
-  ParticleManager::GetInstance()->Update(deltaTime);
+  // 固定刻みで発生・積分し、描画は端数 alpha で補間する
+  const uint32_t steps = particleClock_.Advance(frameDeltaTime);
+  const float step = particleClock_.GetStep();
+  for (uint32_t i = 0; i < steps; ++i) {
+    particleEmitter_.Update(step);
+    particleManager->Simulate(step);
+  }
+  particleManager->UpdateInstances(particleClock_.GetAlpha());
 }
 
 void GameScene::Draw() {
@@ -459,11 +537,23 @@ void GameScene::InitLogging_() {
 }
 
 void GameScene::InitResources_() {
-  resSphere_ = ModelManager::GetInstance()->Load("resources/sphere/sphere.obj");
-  resPlane_ = ModelManager::GetInstance()->Load("resources/plane/plane.gltf");
-  resCube_ = ModelManager::GetInstance()->Load("resources/cube/cube.obj");
-  resTerrain_ =
-      ModelManager::GetInstance()->Load("resources/terrain/terrain.obj");
+  // 全ての読み込みを先に投げてワーカーで並列に進め、まとめて待つ
+  auto *models = ModelManager::GetInstance();
+  auto *textures = TextureManager::GetInstance();
+  auto sphere = models->LoadAsync("resources/sphere/sphere.obj");
+  auto plane = models->LoadAsync("resources/plane/plane.gltf");
+  auto cube = models->LoadAsync("resources/cube/cube.obj");
+  auto terrain = models->LoadAsync("resources/terrain/terrain.obj");
+  // Sprite / パーティクルの同期 Load がキャッシュに当たるよう先読みしておく
+  // （future が結果を持つので、この関数を抜けるまでは解放されない）
+  auto uvChecker = textures->LoadAsync("resources/plane/uvChecker.png");
+  auto circle = textures->LoadAsync("resources/particle/circle.png");
+  AssetLoadQueue::GetInstance()->WaitAll();
+
+  resSphere_ = sphere.Get();
+  resPlane_ = plane.Get();
+  resCube_ = cube.Get();
+  resTerrain_ = terrain.Get();
 
   CheckFileExists_("resources/particle/circle.png");
   CheckFileExists_("resources/sound/select.mp3");
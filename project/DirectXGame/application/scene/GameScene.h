@@ -9,6 +9,7 @@
 #include "BaseScene.h"
 
 #include "Camera.h"
+#include "FixedStepClock.h"
 #include "LightTypes.h"
 #include "Matrix.h"
 #include "Method.h"
@@ -61,6 +62,9 @@ private:
 
   ParticleEmitter particleEmitter_;
 
+  // パーティクルの固定ステップ（60Hz、ヒッチ時は最大8ステップで打ち切り）
+  FixedStepClock particleClock_{1.0f / 60.0f, 8};
+
   // ライト（高レベル記述子）
   std::vector<DirLight> dirLights_;
   bool enableDirectionalLight_ = false;
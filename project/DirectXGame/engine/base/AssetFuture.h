@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// 非同期読み込みの結果（コピーしても同じ結果を指す）
+// - 完了前の Get はプレースホルダ（無ければ nullptr）を返す
+// - Resolve は 1 度だけ。nullptr で Resolve すると失敗扱い
+template <class T> class AssetFuture {
+public:
+  enum class Status : uint32_t { Pending, Ready, Failed };
+
+  AssetFuture() = default;
+
+  static AssetFuture MakePending(std::shared_ptr<T> placeholder) {
+    AssetFuture f;
+    f.state_ = std::make_shared<State>();
+    f.state_->placeholder = std::move(placeholder);
+    return f;
+  }
+  static AssetFuture MakeReady(std::shared_ptr<T> value) {
+    AssetFuture f = MakePending(nullptr);
+    f.Resolve(std::move(value));
+    return f;
+  }
+
+  bool IsValid() const { return state_ != nullptr; }
+  Status GetStatus() const {
+    return state_ ? state_->status.load(std::memory_order_acquire)
+                  : Status::Failed;
+  }
+  // 成功・失敗のどちらかで終わっている
+  bool IsReady() const { return GetStatus() != Status::Pending; }
+
+  // 完了していれば結果、未完了・失敗ならプレースホルダ
+  std::shared_ptr<T> Get() const {
+    if (!state_) {
+      return nullptr;
+    }
+    if (state_->status.load(std::memory_order_acquire) == Status::Ready) {
+      return state_->value;
+    }
+    return state_->placeholder;
+  }
+
+  // 完了まで呼び出し元スレッドを止める
+  // 描画スレッドで仕上げる資源は AssetLoadQueue::Wait を使う（こちらは仕上げを回さない）
+  void Wait() const {
+    if (!state_) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->cv.wait(lock, [this]() {
+      return state_->status.load(std::memory_order_acquire) != Status::Pending;
+    });
+  }
+
+  // 同じ結果を指す future か（コピー元・コピー先同士なら true）
+  bool IsSameState(const AssetFuture &other) const {
+    return state_ == other.state_;
+  }
+
+  void Resolve(std::shared_ptr<T> value) const {
+    if (!state_) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(state_->mutex);
+      if (state_->status.load(std::memory_order_relaxed) != Status::Pending) {
+        return;
+      }
+      const Status status = value ? Status::Ready : Status::Failed;
+      state_->value = std::move(value);
+      state_->status.store(status, std::memory_order_release);
+    }
+    state_->cv.notify_all();
+  }
+
+private:
+  struct State {
+    std::atomic<Status> status{Status::Pending};
+    std::shared_ptr<T> value;
+    std::shared_ptr<T> placeholder;
+    std::mutex mutex;
+    std::condition_variable cv;
+  };
+  std::shared_ptr<State> state_;
+};
@@ -0,0 +1,128 @@
+#include "AssetLoadQueue.h"
+#include <cassert>
+#include <chrono>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <objbase.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+// CoInitializeEx が成功したスレッドだけ CoUninitialize する（S_FALSE も成功）
+thread_local bool comInitialized = false;
+#endif
+
+void OnWorkerStart() {
+#ifdef _WIN32
+  comInitialized = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+#endif
+}
+
+void OnWorkerExit() {
+#ifdef _WIN32
+  if (comInitialized) {
+    CoUninitialize();
+    comInitialized = false;
+  }
+#endif
+}
+} // namespace
+
+AssetLoadQueue *AssetLoadQueue::GetInstance() {
+  static AssetLoadQueue instance;
+  return &instance;
+}
+
+JobSystem::WorkerHooks AssetLoadQueue::GetWorkerHooks() {
+  return {&OnWorkerStart, &OnWorkerExit};
+}
+
+void AssetLoadQueue::Submit(std::function<void()> work) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++working_;
+  }
+  JobSystem::GetInstance()->Submit([this, work = std::move(work)]() {
+    work();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      --working_;
+      ++completedWork_;
+    }
+    cv_.notify_all();
+  });
+}
+
+void AssetLoadQueue::PostToRenderThread(std::function<bool()> finalize) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finalizers_.push_back(std::move(finalize));
+  }
+  cv_.notify_all();
+}
+
+void AssetLoadQueue::Pump() {
+  // 仕上げの中で Load/Wait が呼ばれても二重に回さない
+  if (pumping_) {
+    return;
+  }
+  pumping_ = true;
+
+  // 実行中に積まれた分は次の Pump へ回す（ロックは持たずに実行する）
+  std::vector<std::function<bool()>> current;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    current.swap(finalizers_);
+  }
+
+  std::vector<std::function<bool()>> retry;
+  uint64_t done = 0;
+  for (auto &finalize : current) {
+    if (finalize()) {
+      ++done;
+    } else {
+      retry.push_back(std::move(finalize));
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    completedFinalize_ += done;
+    finalizers_.insert(finalizers_.begin(),
+                       std::make_move_iterator(retry.begin()),
+                       std::make_move_iterator(retry.end()));
+  }
+  pumping_ = false;
+}
+
+void AssetLoadQueue::WaitAll() {
+  WaitUntil_([this]() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return working_ == 0 && finalizers_.empty();
+  });
+}
+
+void AssetLoadQueue::WaitUntil_(const std::function<bool()> &done) {
+  // 仕上げの中から待つと、待っている相手の仕上げを回せず止まる
+  assert(!pumping_);
+  for (;;) {
+    Pump();
+    if (done()) {
+      return;
+    }
+    // 作業の完了か仕上げの追加で起きる。再試行待ちの仕上げもあるので時間でも起きる
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, std::chrono::milliseconds(1));
+  }
+}
+
+AssetLoadQueue::Stats AssetLoadQueue::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats s{};
+  s.working = working_;
+  s.finalizing = static_cast<uint32_t>(finalizers_.size());
+  s.completedWork = completedWork_;
+  s.completedFinalize = completedFinalize_;
+  return s;
+}
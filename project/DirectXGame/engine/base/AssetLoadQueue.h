@@ -0,0 +1,62 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "AssetFuture.h"
+#include "JobSystem.h"
+
+// アセットの非同期読み込み
+// - Submit した作業（ファイル I/O・デコード・取り込み・ミップ生成）は JobSystem のワーカーで動く
+// - GPU リソースの作成は PostToRenderThread で積み、描画スレッドが Pump で実行する
+//   （コマンドリスト・アップロードキューは描画スレッドからしか触らないため）
+// - ワーカーは JobSystem のもの。JobSystem::Initialize に GetWorkerHooks を渡しておくこと
+class AssetLoadQueue {
+public:
+  static AssetLoadQueue *GetInstance();
+
+  // ワーカーの入口で COM を初期化し、出口で解放する（WIC のデコードに要る）
+  static JobSystem::WorkerHooks GetWorkerHooks();
+
+  // ワーカーで work を実行する（任意のスレッドから呼べる）
+  void Submit(std::function<void()> work);
+
+  // 描画スレッドで実行する仕上げを積む（任意のスレッドから呼べる）
+  // finalize が false を返したら次の Pump でもう一度呼ぶ（依存先の完了待ちなど）
+  void PostToRenderThread(std::function<bool()> finalize);
+
+  // 描画スレッド: 積まれた仕上げを実行する（毎フレーム 1 回）
+  void Pump();
+
+  // 描画スレッド: future が完了するまで Pump しながら待つ
+  template <class T> void Wait(const AssetFuture<T> &future) {
+    WaitUntil_([&future]() { return future.IsReady(); });
+  }
+  // 描画スレッド: 作業・仕上げが全て無くなるまで Pump しながら待つ
+  void WaitAll();
+
+  struct Stats {
+    uint32_t working = 0;    // ワーカーで実行中・待機中の作業
+    uint32_t finalizing = 0; // 描画スレッドの仕上げ待ち
+    uint64_t completedWork = 0;
+    uint64_t completedFinalize = 0;
+  };
+  Stats GetStats() const;
+
+private:
+  AssetLoadQueue() = default;
+  AssetLoadQueue(const AssetLoadQueue &) = delete;
+  AssetLoadQueue &operator=(const AssetLoadQueue &) = delete;
+
+  void WaitUntil_(const std::function<bool()> &done);
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_; // 作業の完了・仕上げの追加で起こす
+  std::vector<std::function<bool()>> finalizers_;
+  uint32_t working_ = 0;
+  uint64_t completedWork_ = 0;
+  uint64_t completedFinalize_ = 0;
+  bool pumping_ = false;
+};
@@ -0,0 +1,327 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetFuture.h"
+
+// パス → アセットのスレッドセーフな登録簿（読み込み中も把握する）
+// - 最初の要求者だけが読み込みを担当し（Acquire が created = true を返す）、
+//   同じパスの後続の要求者は同じ future を受け取って完了を待つ
+// - キーのハッシュで kStripeCount 本に分けてロックするので、別パスの要求は
+//   ほとんど競合しない
+// - Strong: 完了後も shared_ptr で保持する（Clear か予算超過の追い出しまで残る）
+//   Weak  : 完了後は weak_ptr だけ持つ（誰も使わなくなれば消える）
+// - Complete で渡したバイト数（後から UpdateBytes で変えられる）を合計し、予算（SetBudget）を超えたら
+//   未参照（キャッシュしか持っていない）かつ未固定のものを最後に使われた順が古いものから追い出す
+template <class T> class ConcurrentAssetCache {
+public:
+  enum class Ownership { Strong, Weak };
+
+  static constexpr uint32_t kStripeCount = 16;
+
+  struct Acquired {
+    AssetFuture<T> future;
+    bool created = false; // true なら呼び出し元が読み込んで Complete すること
+  };
+
+  struct Stats {
+    uint64_t hits = 0;         // 完了済みの結果を返した
+    uint64_t inFlightHits = 0; // 読み込み中の future に相乗りした
+    uint64_t misses = 0;       // 新しく読み込みを始めた
+    uint64_t failures = 0;     // 読み込みが失敗した
+    uint64_t evictions = 0;    // 予算超過で追い出した
+    uint32_t inFlight = 0;     // 読み込み中のエントリ
+    uint32_t entries = 0;      // 登録中のエントリ（読み込み中を含む）
+    uint32_t pinned = 0;       // 追い出し対象外のエントリ
+    uint64_t bytes = 0;        // 登録中のエントリの合計サイズ
+    uint64_t budget = 0;       // 0 は無制限
+  };
+
+  explicit ConcurrentAssetCache(Ownership ownership) : ownership_(ownership) {}
+
+  ConcurrentAssetCache(const ConcurrentAssetCache &) = delete;
+  ConcurrentAssetCache &operator=(const ConcurrentAssetCache &) = delete;
+
+  // 登録済みならその結果（読み込み中ならその future）、無ければ読み込み中として登録する
+  // placeholder は新しく登録する場合だけ使う
+  Acquired Acquire(const std::string &key,
+                   std::shared_ptr<T> placeholder = nullptr) {
+    Stripe &stripe = StripeOf_(key);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+
+    auto it = stripe.entries.find(key);
+    if (it != stripe.entries.end()) {
+      Entry &e = it->second;
+      if (e.pending) {
+        inFlightHits_.fetch_add(1, std::memory_order_relaxed);
+        return {e.future, false};
+      }
+      if (std::shared_ptr<T> alive = e.strong ? e.strong : e.weak.lock()) {
+        e.lastUse = clock_.fetch_add(1, std::memory_order_relaxed) + 1;
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return {AssetFuture<T>::MakeReady(std::move(alive)), false};
+      }
+      // 解放済み（Weak）は読み込み直す
+      bytes_.fetch_sub(e.bytes, std::memory_order_relaxed);
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    Entry &e = stripe.entries[key];
+    const bool pinned = e.pinned; // 読み込み前に Pin されていれば引き継ぐ
+    e = Entry{};
+    e.pinned = pinned;
+    e.pending = true;
+    e.future = AssetFuture<T>::MakePending(std::move(placeholder));
+    return {e.future, true};
+  }
+
+  // Acquire で created = true を受け取った側が呼ぶ。value が nullptr なら失敗として
+  // 登録を消す（次の要求でもう一度読み込む）。bytes は予算の計上に使う大きさ
+  void Complete(const std::string &key, const AssetFuture<T> &future,
+                std::shared_ptr<T> value, uint64_t bytes = 0) {
+    bool overBudget = false;
+    {
+      Stripe &stripe = StripeOf_(key);
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      auto it = stripe.entries.find(key);
+      // Clear 等で別のエントリに置き換わっていたら登録は触らない
+      const bool owned = it != stripe.entries.end() && it->second.pending &&
+                         it->second.future.IsSameState(future);
+      if (owned) {
+        if (!value) {
+          stripe.entries.erase(it);
+        } else {
+          Entry &e = it->second;
+          e.pending = false;
+          e.bytes = bytes;
+          e.lastUse = clock_.fetch_add(1, std::memory_order_relaxed) + 1;
+          const uint64_t total =
+              bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+          const uint64_t budget = budget_.load(std::memory_order_relaxed);
+          overBudget = budget != 0 && total > budget;
+          // Weak では future が結果を握り続けないよう手放す
+          e.future = AssetFuture<T>{};
+          if (ownership_ == Ownership::Strong) {
+            e.strong = value;
+          } else {
+            e.weak = value;
+          }
+        }
+      }
+    }
+    if (!value) {
+      failures_.fetch_add(1, std::memory_order_relaxed);
+    }
+    // 待っている側はロックの外で起こす
+    future.Resolve(std::move(value));
+    if (overBudget) {
+      Trim();
+    }
+  }
+
+  // 完了済みのエントリの大きさを変える（ストリーミングで VRAM 上の大きさが変わった時など）
+  // value が登録中のものと違う（Clear 後に読み込み直された等）なら何もしない
+  // 増えて予算を超えたら Trim で追い出す
+  void UpdateBytes(const std::string &key, const T *value, uint64_t bytes) {
+    bool overBudget = false;
+    {
+      Stripe &stripe = StripeOf_(key);
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      auto it = stripe.entries.find(key);
+      if (it == stripe.entries.end() || it->second.pending) {
+        return;
+      }
+      Entry &e = it->second;
+      const T *current = e.strong ? e.strong.get() : e.weak.lock().get();
+      if (!value || current != value) {
+        return;
+      }
+      uint64_t total;
+      if (bytes >= e.bytes) {
+        total = bytes_.fetch_add(bytes - e.bytes, std::memory_order_relaxed) +
+                (bytes - e.bytes);
+      } else {
+        total = bytes_.fetch_sub(e.bytes - bytes, std::memory_order_relaxed) -
+                (e.bytes - bytes);
+      }
+      e.bytes = bytes;
+      const uint64_t budget = budget_.load(std::memory_order_relaxed);
+      overBudget = budget != 0 && total > budget;
+    }
+    if (overBudget) {
+      Trim();
+    }
+  }
+
+  // 合計の上限（0 で無制限）。下げた場合は Trim で追い出す
+  void SetBudget(uint64_t bytes) {
+    budget_.store(bytes, std::memory_order_relaxed);
+    Trim();
+  }
+  uint64_t GetBudget() const { return budget_.load(std::memory_order_relaxed); }
+
+  // 固定したものは予算を超えても追い出さない。未登録のキーにも効く
+  void Pin(const std::string &key, bool pinned) {
+    Stripe &stripe = StripeOf_(key);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    if (pinned) {
+      stripe.entries[key].pinned = true;
+      return;
+    }
+    auto it = stripe.entries.find(key);
+    if (it == stripe.entries.end()) {
+      return;
+    }
+    it->second.pinned = false;
+    // Pin のためだけに作った空の登録は消す
+    if (!it->second.pending && !it->second.strong &&
+        it->second.weak.expired() && it->second.bytes == 0) {
+      stripe.entries.erase(it);
+    }
+  }
+
+  // 予算に収まるまで、追い出せるものを古い順に追い出す
+  // 参照中のものは残るので、全て使用中なら予算を超えたままになる
+  void Trim() {
+    const uint64_t budget = budget_.load(std::memory_order_relaxed);
+    if (budget == 0 || bytes_.load(std::memory_order_relaxed) <= budget) {
+      return;
+    }
+
+    struct Candidate {
+      uint64_t lastUse;
+      uint32_t stripe;
+      std::string key;
+    };
+    std::vector<Candidate> candidates;
+    for (uint32_t i = 0; i < kStripeCount; ++i) {
+      std::lock_guard<std::mutex> lock(stripes_[i].mutex);
+      for (const auto &[key, e] : stripes_[i].entries) {
+        if (IsEvictable_(e)) {
+          candidates.push_back({e.lastUse, i, key});
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate &a, const Candidate &b) {
+                return a.lastUse < b.lastUse;
+              });
+
+    // 解放（デストラクタ）はロックの外で行う
+    std::vector<std::shared_ptr<T>> evicted;
+    for (const Candidate &c : candidates) {
+      if (bytes_.load(std::memory_order_relaxed) <= budget) {
+        break;
+      }
+      Stripe &stripe = stripes_[c.stripe];
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      auto it = stripe.entries.find(c.key);
+      // 集めてから今までの間に使われたものは残す
+      if (it == stripe.entries.end() || !IsEvictable_(it->second) ||
+          it->second.lastUse != c.lastUse) {
+        continue;
+      }
+      bytes_.fetch_sub(it->second.bytes, std::memory_order_relaxed);
+      evicted.push_back(std::move(it->second.strong));
+      stripe.entries.erase(it);
+      evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  // 読み込み中のものは残す（担当者の Complete が future を解決する）
+  void Clear() {
+    for (Stripe &stripe : stripes_) {
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      std::erase_if(stripe.entries, [this](const auto &kv) {
+        if (kv.second.pending) {
+          return false;
+        }
+        bytes_.fetch_sub(kv.second.bytes, std::memory_order_relaxed);
+        return true;
+      });
+    }
+  }
+
+  // 予算に関係なく、追い出せるもの（未参照・未固定）を全て消す
+  void ClearUnused() {
+    std::vector<std::shared_ptr<T>> evicted;
+    for (Stripe &stripe : stripes_) {
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      std::erase_if(stripe.entries, [this, &evicted](auto &kv) {
+        if (!IsEvictable_(kv.second)) {
+          return false;
+        }
+        bytes_.fetch_sub(kv.second.bytes, std::memory_order_relaxed);
+        evicted.push_back(std::move(kv.second.strong));
+        return true;
+      });
+    }
+  }
+
+  Stats GetStats() const {
+    Stats s{};
+    s.hits = hits_.load(std::memory_order_relaxed);
+    s.inFlightHits = inFlightHits_.load(std::memory_order_relaxed);
+    s.misses = misses_.load(std::memory_order_relaxed);
+    s.failures = failures_.load(std::memory_order_relaxed);
+    s.evictions = evictions_.load(std::memory_order_relaxed);
+    s.bytes = bytes_.load(std::memory_order_relaxed);
+    s.budget = budget_.load(std::memory_order_relaxed);
+    for (const Stripe &stripe : stripes_) {
+      std::lock_guard<std::mutex> lock(stripe.mutex);
+      s.entries += static_cast<uint32_t>(stripe.entries.size());
+      for (const auto &kv : stripe.entries) {
+        s.inFlight += kv.second.pending ? 1u : 0u;
+        s.pinned += kv.second.pinned ? 1u : 0u;
+      }
+    }
+    return s;
+  }
+
+private:
+  struct Entry {
+    bool pending = false;
+    AssetFuture<T> future; // 読み込み中のみ
+    std::shared_ptr<T> strong;
+    std::weak_ptr<T> weak;
+    uint64_t bytes = 0;
+    uint64_t lastUse = 0; // clock_ の値（大きいほど最近）
+    bool pinned = false;
+  };
+
+  // 予算超過時に追い出してよいか（キャッシュ以外から参照されていない）
+  static bool IsEvictable_(const Entry &e) {
+    if (e.pending || e.pinned) {
+      return false;
+    }
+    return e.strong ? e.strong.use_count() == 1 : e.weak.expired();
+  }
+
+  struct Stripe {
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+  };
+
+  Stripe &StripeOf_(const std::string &key) {
+    return stripes_[std::hash<std::string>{}(key) % kStripeCount];
+  }
+
+  Ownership ownership_;
+  std::array<Stripe, kStripeCount> stripes_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> inFlightHits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> failures_{0};
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> clock_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint64_t> budget_{0};
+};
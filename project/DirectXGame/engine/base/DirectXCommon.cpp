@@ -1,5 +1,6 @@
 #include "DirectXCommon.h"
 #include "DirectXResourceUtils.h"
+#include <algorithm>
 #include <cassert>
 #include <dxcapi.h>
 
@@ -22,9 +23,42 @@ D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandle(
 #include <dxgidebug.h>
 #endif
 
+// コマンドキューに紐づいたフェンス
+class DirectXCommon::QueueFence : public IFrameFence {
+public:
+  QueueFence(ID3D12CommandQueue *queue, ID3D12Fence *fence, HANDLE event)
+      : queue_(queue), fence_(fence), event_(event) {}
+
+  uint64_t GetCompletedValue() const override { return fence_->GetCompletedValue(); }
+
+  void Signal(uint64_t value) override {
+    HRESULT hr = queue_->Signal(fence_, value);
+    assert(SUCCEEDED(hr));
+  }
+
+  void WaitForValue(uint64_t value) override {
+    if (fence_->GetCompletedValue() >= value) {
+      return;
+    }
+    HRESULT hr = fence_->SetEventOnCompletion(value, event_);
+    assert(SUCCEEDED(hr));
+    WaitForSingleObject(event_, INFINITE);
+  }
+
+private:
+  ID3D12CommandQueue *queue_ = nullptr;
+  ID3D12Fence *fence_ = nullptr;
+  HANDLE event_ = nullptr;
+};
+
 DirectXCommon::DirectXCommon() {}
 
 DirectXCommon::~DirectXCommon() {
+  // 先行投入中のフレームが参照しているリソースを解放する前に待つ
+  uploadQueue_.Finalize();
+  if (queueFence_) {
+    framePacer_.Finalize();
+  }
   if (fenceEvent_) {
     CloseHandle(fenceEvent_);
     fenceEvent_ = nullptr;
@@ -36,6 +70,8 @@ void DirectXCommon::Initialize(const InitParams &params) {
   hwnd_ = params.hwnd;
   clientWidth_ = params.clientWidth;
   clientHeight_ = params.clientHeight;
+  framesInFlight_ = std::clamp(params.framesInFlight, FramePacer::kMinFramesInFlight,
+                               FramePacer::kMaxFramesInFlight);
 
 #ifdef _DEBUG
   Microsoft::WRL::ComPtr<ID3D12Debug1> debugController;
@@ -53,6 +89,8 @@ void DirectXCommon::Initialize(const InitParams &params) {
   CreateRTVs_();
   CreateDepthStencil_();
   CreateFenceAndEvent_();
+  framePacer_.Initialize(queueFence_.get(), framesInFlight_);
+  uploadQueue_.Initialize(device_.Get());
   SetupViewportAndScissor_();
   InitDXC_();
 
@@ -63,6 +101,7 @@ void DirectXCommon::Initialize(const InitParams &params) {
 
 void DirectXCommon::BeginFrame() {
   UINT backBufferIndex = swapChain_->GetCurrentBackBufferIndex();
+  frameBackBufferIndex_ = backBufferIndex;
   D3D12_RESOURCE_BARRIER barrier{};
   barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
   barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
@@ -91,23 +130,42 @@ void DirectXCommon::EndFrame() {
   HRESULT hr = commandList_->Close();
   assert(SUCCEEDED(hr));
 
+  FlushUploads_();
   ID3D12CommandList *lists[]{commandList_.Get()};
   commandQueue_->ExecuteCommandLists(1, lists);
   swapChain_->Present(1, 0);
 
-  fenceValue_++;
-  commandQueue_->Signal(fence_.Get(), fenceValue_);
-  if (fence_->GetCompletedValue() < fenceValue_) {
-    fence_->SetEventOnCompletion(fenceValue_, fenceEvent_);
-    WaitForSingleObject(fenceEvent_, INFINITE);
-  }
+  // フェンスを打って次のスロットへ。そのスロットを GPU が読み終えていなければここで待つ
+  framePacer_.Advance();
 
-  hr = commandAllocator_->Reset();
+  // 次フレームのアロケータは GPU 完了済みなので Reset してよい
+  hr = commandAllocators_[framePacer_.GetFrameIndex()]->Reset();
   assert(SUCCEEDED(hr));
-  hr = commandList_->Reset(commandAllocator_.Get(), nullptr);
+  ResetMainCommandList_();
+}
+
+void DirectXCommon::WaitForGpuIdle() {
+  // 記録途中のメインのリストは提出しない（未提出分は GPU から参照されない）
+  framePacer_.WaitIdle();
+}
+
+void DirectXCommon::DeferRelease(ComPtr<ID3D12Resource> resource) {
+  if (!resource) {
+    return;
+  }
+  framePacer_.DeferRelease([resource]() mutable { resource.Reset(); });
+}
+
+void DirectXCommon::ResetMainCommandList_() {
+  HRESULT hr = commandList_->Reset(commandAllocators_[framePacer_.GetFrameIndex()].Get(), nullptr);
   assert(SUCCEEDED(hr));
 }
 
+void DirectXCommon::FlushUploads_() {
+  // このフレームに読み込んだ静的バッファのコピーを 1 回で投入する
+  uploadQueue_.Flush(commandQueue_.Get());
+}
+
 void DirectXCommon::PreDraw() {
   BeginFrame();
 
@@ -128,6 +186,55 @@ void DirectXCommon::PostDraw() {
   EndFrame();
 }
 
+ID3D12GraphicsCommandList *DirectXCommon::BeginWorkerCommandList(uint32_t index) {
+  assert(index < kMaxWorkerCommandLists);
+
+  // 今のスロットは EndFrame で GPU 完了を確認済みなので、前回分はここで破棄してよい
+  ID3D12CommandAllocator *allocator = workerAllocators_[framePacer_.GetFrameIndex()][index].Get();
+  HRESULT hr = allocator->Reset();
+  assert(SUCCEEDED(hr));
+  ID3D12GraphicsCommandList *list = workerCommandLists_[index].Get();
+  hr = list->Reset(allocator, nullptr);
+  assert(SUCCEEDED(hr));
+
+  BindBackBuffer_(list);
+  return list;
+}
+
+void DirectXCommon::EndWorkerCommandList(uint32_t index) {
+  assert(index < kMaxWorkerCommandLists);
+  HRESULT hr = workerCommandLists_[index]->Close();
+  assert(SUCCEEDED(hr));
+}
+
+void DirectXCommon::SubmitWorkerCommandLists(uint32_t count) {
+  assert(count <= kMaxWorkerCommandLists);
+
+  HRESULT hr = commandList_->Close();
+  assert(SUCCEEDED(hr));
+
+  ID3D12CommandList *lists[1 + kMaxWorkerCommandLists]{};
+  lists[0] = commandList_.Get();
+  for (uint32_t i = 0; i < count; ++i) {
+    lists[1 + i] = workerCommandLists_[i].Get();
+  }
+  // 1 回の ExecuteCommandLists 内では配列の順に実行される
+  FlushUploads_();
+  commandQueue_->ExecuteCommandLists(1 + count, lists);
+
+  // 提出済みのリストはすぐ Reset してよい（アロケータはスロットが一巡するまで Reset しない）
+  ResetMainCommandList_();
+  BindBackBuffer_(commandList_.Get());
+}
+
+void DirectXCommon::BindBackBuffer_(ID3D12GraphicsCommandList *list) const {
+  D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle =
+      GetCPUDescriptorHandle(dsvDescriptorHeap_.Get(), descriptorSizeDSV_, 0);
+  list->OMSetRenderTargets(1, &rtvHandles_[frameBackBufferIndex_], FALSE, &dsvHandle);
+  list->RSSetViewports(1, &viewport_);
+  list->RSSetScissorRects(1, &scissorRect_);
+}
+
 void DirectXCommon::CreateDeviceAndFactory_() {
   HRESULT hr = CreateDXGIFactory(IID_PPV_ARGS(&dxgiFactory_));
   assert(SUCCEEDED(hr));
@@ -185,12 +292,30 @@ void DirectXCommon::CreateCommandObjects_() {
   hr = device_->CreateCommandQueue(&cqDesc, IID_PPV_ARGS(&commandQueue_));
   assert(SUCCEEDED(hr));
 
-  hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator_));
-  assert(SUCCEEDED(hr));
+  for (uint32_t f = 0; f < framesInFlight_; ++f) {
+    hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                         IID_PPV_ARGS(&commandAllocators_[f]));
+    assert(SUCCEEDED(hr));
+    for (uint32_t i = 0; i < kMaxWorkerCommandLists; ++i) {
+      hr = device_->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                           IID_PPV_ARGS(&workerAllocators_[f][i]));
+      assert(SUCCEEDED(hr));
+    }
+  }
 
-  hr = device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator_.Get(), nullptr,
-                                  IID_PPV_ARGS(&commandList_));
+  // スロット 0 から記録を始める
+  hr = device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocators_[0].Get(),
+                                  nullptr, IID_PPV_ARGS(&commandList_));
   assert(SUCCEEDED(hr));
+
+  // ワーカー用（Close 状態で待機させ、BeginWorkerCommandList で Reset する）
+  for (uint32_t i = 0; i < kMaxWorkerCommandLists; ++i) {
+    hr = device_->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, workerAllocators_[0][i].Get(),
+                                    nullptr, IID_PPV_ARGS(&workerCommandLists_[i]));
+    assert(SUCCEEDED(hr));
+    hr = workerCommandLists_[i]->Close();
+    assert(SUCCEEDED(hr));
+  }
 }
 
 void DirectXCommon::CreateSwapChain_() {
@@ -200,7 +325,7 @@ void DirectXCommon::CreateSwapChain_() {
   swapChainDesc_.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
   swapChainDesc_.SampleDesc.Count = 1;
   swapChainDesc_.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-  swapChainDesc_.BufferCount = 2;
+  swapChainDesc_.BufferCount = framesInFlight_;
   swapChainDesc_.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 
   HRESULT hr = dxgiFactory_->CreateSwapChainForHwnd(
@@ -208,14 +333,14 @@ void DirectXCommon::CreateSwapChain_() {
       reinterpret_cast<IDXGISwapChain1 **>(swapChain_.GetAddressOf()));
   assert(SUCCEEDED(hr));
 
-  hr = swapChain_->GetBuffer(0, IID_PPV_ARGS(&swapChainResources_[0]));
-  assert(SUCCEEDED(hr));
-  hr = swapChain_->GetBuffer(1, IID_PPV_ARGS(&swapChainResources_[1]));
-  assert(SUCCEEDED(hr));
+  for (uint32_t i = 0; i < framesInFlight_; ++i) {
+    hr = swapChain_->GetBuffer(i, IID_PPV_ARGS(&swapChainResources_[i]));
+    assert(SUCCEEDED(hr));
+  }
 }
 
 void DirectXCommon::CreateDescriptorHeaps_() {
-  rtvDescriptorHeap_ = CreateDescriptorHeap(device_.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 2, false);
+  rtvDescriptorHeap_ = CreateDescriptorHeap(device_.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, framesInFlight_, false);
   srvDescriptorHeap_ = CreateDescriptorHeap(device_.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 128, true);
   dsvDescriptorHeap_ = CreateDescriptorHeap(device_.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, 1, false);
 
@@ -232,11 +357,10 @@ void DirectXCommon::CreateRTVs_() {
   D3D12_CPU_DESCRIPTOR_HANDLE rtvStart =
       GetCPUDescriptorHandle(rtvDescriptorHeap_.Get(), descriptorSizeRTV_, 0);
 
-  rtvHandles_[0] = rtvStart;
-  device_->CreateRenderTargetView(swapChainResources_[0].Get(), &rtvDesc_, rtvHandles_[0]);
-
-  rtvHandles_[1].ptr = rtvHandles_[0].ptr + descriptorSizeRTV_;
-  device_->CreateRenderTargetView(swapChainResources_[1].Get(), &rtvDesc_, rtvHandles_[1]);
+  for (uint32_t i = 0; i < framesInFlight_; ++i) {
+    rtvHandles_[i].ptr = rtvStart.ptr + static_cast<SIZE_T>(descriptorSizeRTV_) * i;
+    device_->CreateRenderTargetView(swapChainResources_[i].Get(), &rtvDesc_, rtvHandles_[i]);
+  }
 }
 
 void DirectXCommon::CreateDepthStencil_() {
@@ -252,10 +376,11 @@ void DirectXCommon::CreateDepthStencil_() {
 }
 
 void DirectXCommon::CreateFenceAndEvent_() {
-  HRESULT hr = device_->CreateFence(fenceValue_, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+  HRESULT hr = device_->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
   assert(SUCCEEDED(hr));
   fenceEvent_ = CreateEvent(NULL, FALSE, FALSE, NULL);
   assert(fenceEvent_ != nullptr);
+  queueFence_ = std::make_unique<QueueFence>(commandQueue_.Get(), fence_.Get(), fenceEvent_);
 }
 
 void DirectXCommon::SetupViewportAndScissor_() {
@@ -2,8 +2,11 @@
 #include "externals/DirectXTex/d3dx12.h"
 #include "SrvAllocator.h"
 #include "DirectXResourceUtils.h"
+#include "FramePacer.h"
+#include "GpuUploadQueue.h"
 #include <Windows.h>
 #include <dxgi1_6.h>
+#include <memory>
 #include <wrl.h>
 
 struct IDxcUtils;
@@ -21,6 +24,8 @@ public:
 		HWND hwnd;
 		int32_t clientWidth;
 		int32_t clientHeight;
+		// GPU に先行投入するフレーム数（2〜3）。バックバッファ数も合わせる
+		uint32_t framesInFlight = 2;
 	};
 
 public:
@@ -36,15 +41,42 @@ public:
 
 	// 描画前後の処理
 	void PreDraw();
+	// 提出後は「次に使うスロットの前回分」だけを待つ（毎フレームの全待ちはしない）
 	void PostDraw();
 
+	// ワーカースレッド用コマンドリストの上限
+	static constexpr uint32_t kMaxWorkerCommandLists = 4;
+
+	// ワーカー用コマンドリストを記録可能にする（RT/DSV/ビューポート/シザー設定済み）
+	// - index ごとに独立しているので、異なる index なら別スレッドから同時に呼べる
+	ID3D12GraphicsCommandList* BeginWorkerCommandList(uint32_t index);
+	void EndWorkerCommandList(uint32_t index);
+
+	// メインのリスト → ワーカーのリスト[0, count) の順で提出し、
+	// メインのリストを同じアロケータで記録再開する（ImGui 等の後続用）
+	void SubmitWorkerCommandLists(uint32_t count);
+
+	// 提出済みの全フレームの完了を待つ（シーン破棄・終了前など）
+	void WaitForGpuIdle();
+
+	// GPU が今フレームを使い終わるまで解放を遅らせる
+	void DeferRelease(ComPtr<ID3D12Resource> resource);
+
+	// 今 CPU が記録しているフレームのスロット番号（フレームごとの領域の選択に使う）
+	uint32_t GetFrameIndex() const { return framePacer_.GetFrameIndex(); }
+	uint32_t GetFramesInFlight() const { return framePacer_.GetFramesInFlight(); }
+	FramePacer& GetFramePacer() { return framePacer_; }
+	// 静的バッファの転送用コピーキュー（積んだ分は次の提出前にまとめて投入）
+	GpuUploadQueue& GetUploadQueue() { return uploadQueue_; }
+
 	// 参照用のゲッタ
 	ID3D12Device* GetDevice() const { return device_.Get(); }
+	IDXGIAdapter4* GetAdapter() const { return useAdapter_.Get(); }
 	ID3D12GraphicsCommandList* GetCommandList() const {
 		return commandList_.Get();
 	}
 	ID3D12CommandAllocator* GetCommandAllocator() const {
-		return commandAllocator_.Get();
+		return commandAllocators_[framePacer_.GetFrameIndex()].Get();
 	}
 	ID3D12CommandQueue* GetCommandQueue() const { return commandQueue_.Get(); }
 	IDXGISwapChain4* GetSwapChain() const { return swapChain_.Get(); }
@@ -83,6 +115,12 @@ private:
 	void CreateFenceAndEvent_();
 	void SetupViewportAndScissor_();
 	void InitDXC_();
+	// 今フレームのスロットのアロケータでメインのリストを記録再開する
+	void ResetMainCommandList_();
+	// 積まれたコピーを投入し、直接キューにその完了を待たせる（提出の直前に呼ぶ）
+	void FlushUploads_();
+	// RT/DSV・ビューポート・シザーを設定（リストをまたいで状態は引き継がれないため）
+	void BindBackBuffer_(ID3D12GraphicsCommandList* list) const;
 	void TransitionBackBufferToRenderTarget_();
 	void TransitionBackBufferToPresent_();
 
@@ -98,13 +136,20 @@ private:
 	ComPtr<IDXGIAdapter4> useAdapter_;
 	ComPtr<ID3D12Device> device_;
 	ComPtr<ID3D12CommandQueue> commandQueue_;
-	ComPtr<ID3D12CommandAllocator> commandAllocator_;
+	// アロケータは GPU が読み終わるまで Reset できないのでフレームスロットごとに持つ
+	ComPtr<ID3D12CommandAllocator> commandAllocators_[FramePacer::kMaxFramesInFlight];
 	ComPtr<ID3D12GraphicsCommandList> commandList_;
+	ComPtr<ID3D12CommandAllocator> workerAllocators_[FramePacer::kMaxFramesInFlight]
+	                                                [kMaxWorkerCommandLists];
+	ComPtr<ID3D12GraphicsCommandList> workerCommandLists_[kMaxWorkerCommandLists];
 	ComPtr<IDXGISwapChain4> swapChain_;
 
 	// バックバッファ
-	ComPtr<ID3D12Resource> swapChainResources_[2];
-	D3D12_CPU_DESCRIPTOR_HANDLE rtvHandles_[2]{};
+	ComPtr<ID3D12Resource> swapChainResources_[FramePacer::kMaxFramesInFlight];
+	D3D12_CPU_DESCRIPTOR_HANDLE rtvHandles_[FramePacer::kMaxFramesInFlight]{};
+	uint32_t framesInFlight_ = FramePacer::kMinFramesInFlight;
+	// BeginFrame 時点のバックバッファ（ワーカーから参照するためキャッシュ）
+	UINT frameBackBufferIndex_ = 0;
 
 	// ヒープ
 	ComPtr<ID3D12DescriptorHeap> rtvDescriptorHeap_;
@@ -122,8 +167,14 @@ private:
 
 	// フェンス
 	ComPtr<ID3D12Fence> fence_;
-	uint64_t fenceValue_ = 0;
 	HANDLE fenceEvent_ = nullptr;
+	// ID3D12Fence を IFrameFence として見せるアダプタ（DirectXCommon.cpp で定義）
+	class QueueFence;
+	std::unique_ptr<QueueFence> queueFence_;
+	FramePacer framePacer_;
+
+	// 静的データ転送
+	GpuUploadQueue uploadQueue_;
 
 	// ビューポート/シザー
 	D3D12_VIEWPORT viewport_{};
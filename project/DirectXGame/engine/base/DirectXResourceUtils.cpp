@@ -1,4 +1,5 @@
 #include "DirectXResourceUtils.h"
+#include "GpuMemoryAllocator.h"
 #include <cassert>
 
 ComPtr<ID3D12DescriptorHeap>
@@ -30,6 +31,8 @@ CreateDepthStencilTextureResource(const ComPtr<ID3D12Device> &device,
   resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
   resourceDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
 
+  // 深度バッファは RT/DS 用ヒープが別扱いになるため Committed のまま
+
   D3D12_HEAP_PROPERTIES heapProperties{};
   heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
 
@@ -66,6 +69,13 @@ GetGPUDescriptorHandle(const ComPtr<ID3D12DescriptorHeap> &descriptorHeap,
 // 追加実装
 ComPtr<ID3D12Resource> CreateBufferResource(const ComPtr<ID3D12Device> &device,
                                             size_t sizeInBytes) {
+  // アロケータ初期化後は共有ヒープへの配置リソースにする
+  auto *allocator = GpuMemoryAllocator::GetInstance();
+  if (allocator->IsInitialized()) {
+    return allocator->CreateBuffer(D3D12_HEAP_TYPE_UPLOAD, sizeInBytes,
+                                   D3D12_RESOURCE_STATE_GENERIC_READ);
+  }
+
   D3D12_HEAP_PROPERTIES uploadHeapProperties{};
   uploadHeapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
 
@@ -84,4 +94,33 @@ ComPtr<ID3D12Resource> CreateBufferResource(const ComPtr<ID3D12Device> &device,
       D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&res));
   assert(SUCCEEDED(hr));
   return res;
+}
+
+ComPtr<ID3D12Resource>
+CreateDefaultBufferResource(const ComPtr<ID3D12Device> &device,
+                            size_t sizeInBytes) {
+  auto *allocator = GpuMemoryAllocator::GetInstance();
+  if (allocator->IsInitialized()) {
+    return allocator->CreateBuffer(D3D12_HEAP_TYPE_DEFAULT, sizeInBytes,
+                                   D3D12_RESOURCE_STATE_COMMON);
+  }
+
+  D3D12_HEAP_PROPERTIES defaultHeapProperties{};
+  defaultHeapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+
+  D3D12_RESOURCE_DESC desc{};
+  desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+  desc.Width = sizeInBytes;
+  desc.Height = 1;
+  desc.DepthOrArraySize = 1;
+  desc.MipLevels = 1;
+  desc.SampleDesc.Count = 1;
+  desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+  ComPtr<ID3D12Resource> res;
+  HRESULT hr = device->CreateCommittedResource(
+      &defaultHeapProperties, D3D12_HEAP_FLAG_NONE, &desc,
+      D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&res));
+  assert(SUCCEEDED(hr));
+  return res;
 }
\ No newline at end of file
@@ -28,4 +28,9 @@ GetGPUDescriptorHandle(const ComPtr<ID3D12DescriptorHeap> &descriptorHeap,
 
 // UploadHeap バッファ作成
 ComPtr<ID3D12Resource> CreateBufferResource(const ComPtr<ID3D12Device> &device,
-                                            size_t sizeInBytes);
\ No newline at end of file
+                                            size_t sizeInBytes);
+
+// DefaultHeap バッファ作成（COMMON 状態。中身はコピーで転送する）
+ComPtr<ID3D12Resource>
+CreateDefaultBufferResource(const ComPtr<ID3D12Device> &device,
+                            size_t sizeInBytes);
\ No newline at end of file
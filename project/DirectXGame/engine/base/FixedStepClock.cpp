@@ -0,0 +1,37 @@
+#include "FixedStepClock.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+void FixedStepClock::SetStep(float step) {
+  assert(step > 0.0f);
+  step_ = step;
+  accumulator_ = std::min(accumulator_, step_);
+}
+
+uint32_t FixedStepClock::Advance(float frameDeltaTime) {
+  droppedSteps_ = 0;
+
+  // 負値や NaN は無視する
+  if (!(frameDeltaTime > 0.0f)) {
+    return 0;
+  }
+
+  accumulator_ += frameDeltaTime;
+
+  uint32_t steps = static_cast<uint32_t>(std::floor(accumulator_ / step_));
+  if (steps > maxSubSteps_) {
+    droppedSteps_ = steps - maxSubSteps_;
+    steps = maxSubSteps_;
+  }
+
+  accumulator_ -= static_cast<float>(steps) * step_;
+  if (droppedSteps_ > 0) {
+    // 打ち切った分の時間は捨て、位相（端数）だけ残す
+    accumulator_ = std::fmod(accumulator_, step_);
+  }
+  accumulator_ = std::clamp(accumulator_, 0.0f, step_);
+
+  return steps;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+// 固定ステップ用のアキュムレータ
+// - 可変フレーム時間を受け取り、固定刻み何回分シミュレーションすべきかを返す
+// - 端数は次フレームへ持ち越し、描画用の補間係数(alpha)として公開する
+// - ヒッチ時は maxSubSteps で打ち切り、超過分は捨てる（死のスパイラル防止）
+class FixedStepClock {
+public:
+  FixedStepClock() = default;
+  explicit FixedStepClock(float step, uint32_t maxSubSteps = 8)
+      : step_(step), maxSubSteps_(maxSubSteps) {}
+
+  // フレーム時間を積算し、今フレームで回すステップ数を返す
+  uint32_t Advance(float frameDeltaTime);
+
+  // 積算時間を破棄（シーン切替や一時停止明けに使う）
+  void Reset() { accumulator_ = 0.0f; }
+
+  void SetStep(float step);
+  void SetMaxSubSteps(uint32_t maxSubSteps) { maxSubSteps_ = maxSubSteps; }
+
+  float GetStep() const { return step_; }
+  uint32_t GetMaxSubSteps() const { return maxSubSteps_; }
+
+  // 前ステップ→現ステップ間の補間係数 [0,1]
+  float GetAlpha() const { return accumulator_ / step_; }
+
+  // 直近の Advance で打ち切られたステップ数（デバッグ表示用）
+  uint32_t GetDroppedSteps() const { return droppedSteps_; }
+
+private:
+  float step_ = 1.0f / 60.0f;
+  uint32_t maxSubSteps_ = 8;
+  float accumulator_ = 0.0f;
+  uint32_t droppedSteps_ = 0;
+};
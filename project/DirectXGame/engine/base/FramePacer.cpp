@@ -0,0 +1,102 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <utility>
+
+void FramePacer::Initialize(IFrameFence *fence, uint32_t framesInFlight) {
+  assert(fence);
+  fence_ = fence;
+  framesInFlight_ = std::clamp(framesInFlight, kMinFramesInFlight, kMaxFramesInFlight);
+  frameIndex_ = 0;
+  frameNumber_ = 0;
+  std::fill(std::begin(slotFenceValues_), std::end(slotFenceValues_), 0ull);
+  // フェンスの初期値より大きい値から使う
+  nextFenceValue_ = fence_->GetCompletedValue() + 1;
+  stalledLastAdvance_ = false;
+  pendingReleases_.clear();
+  frameReleases_.clear();
+}
+
+uint64_t FramePacer::Advance() {
+  assert(fence_);
+
+  const uint64_t value = nextFenceValue_++;
+  fence_->Signal(value);
+  slotFenceValues_[frameIndex_] = value;
+  for (std::function<void()> &release : frameReleases_) {
+    pendingReleases_.push_back({value, std::move(release)});
+  }
+  frameReleases_.clear();
+
+  frameIndex_ = (frameIndex_ + 1) % framesInFlight_;
+  ++frameNumber_;
+
+  // 次に使うスロットを GPU がまだ読んでいるなら待つ
+  const uint64_t wait = slotFenceValues_[frameIndex_];
+  stalledLastAdvance_ = false;
+  if (wait != 0 && fence_->GetCompletedValue() < wait) {
+    fence_->WaitForValue(wait);
+    stalledLastAdvance_ = true;
+  }
+
+  CollectGarbage();
+  return value;
+}
+
+void FramePacer::WaitIdle() {
+  if (!fence_) {
+    return;
+  }
+
+  // 前回の Advance の後に提出したリスト（SubmitWorkerCommandLists）も含めて待つため、
+  // 新しい値を打って待つ。記録中のフレームの予約は frameReleases_ に残る
+  const uint64_t value = nextFenceValue_++;
+  fence_->Signal(value);
+  if (fence_->GetCompletedValue() < value) {
+    fence_->WaitForValue(value);
+  }
+  for (uint64_t &v : slotFenceValues_) {
+    v = 0;
+  }
+
+  CollectGarbage();
+}
+
+void FramePacer::Finalize() {
+  if (!fence_) {
+    return;
+  }
+  WaitIdle();
+  std::vector<std::function<void()>> releases = std::move(frameReleases_);
+  frameReleases_.clear();
+  fence_ = nullptr;
+  for (std::function<void()> &release : releases) {
+    release();
+  }
+}
+
+void FramePacer::DeferRelease(std::function<void()> release) {
+  if (!release) {
+    return;
+  }
+  // 未初期化（または終了後）は GPU が何も参照していないので即時
+  if (!fence_) {
+    release();
+    return;
+  }
+  frameReleases_.push_back(std::move(release));
+}
+
+void FramePacer::CollectGarbage() {
+  if (!fence_) {
+    return;
+  }
+  const uint64_t completed = fence_->GetCompletedValue();
+  while (!pendingReleases_.empty() && pendingReleases_.front().fenceValue <= completed) {
+    // release 内で DeferRelease されても壊れないよう、取り出してから実行
+    std::function<void()> release = std::move(pendingReleases_.front().release);
+    pendingReleases_.pop_front();
+    release();
+  }
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// GPU フェンスの抽象（D3D12 に依存しない形でフレーム制御を書くため）
+// - Signal した値は単調増加し、GetCompletedValue がその値に追い付いたら完了
+class IFrameFence {
+public:
+  virtual ~IFrameFence() = default;
+
+  // GPU 側でここまで完了した値
+  virtual uint64_t GetCompletedValue() const = 0;
+  // 今まで提出した処理が終わったら value になるよう予約する
+  virtual void Signal(uint64_t value) = 0;
+  // value が完了するまで CPU をブロックする
+  virtual void WaitForValue(uint64_t value) = 0;
+};
+
+// 複数フレームを GPU に先行投入するためのフレーム制御
+// - フレームスロットを framesInFlight 個ぐるぐる使い回す
+// - スロット再利用時だけ、そのスロットが前回出したフェンス値を待つ
+// - 破棄の予約は、今のフレームを提出した後に Advance が打つフェンス値が完了してから実行する
+class FramePacer {
+public:
+  static constexpr uint32_t kMinFramesInFlight = 2;
+  static constexpr uint32_t kMaxFramesInFlight = 3;
+
+  FramePacer() = default;
+
+  // framesInFlight は [kMinFramesInFlight, kMaxFramesInFlight] に丸める
+  void Initialize(IFrameFence *fence, uint32_t framesInFlight);
+
+  // 今フレームの提出後に呼ぶ: フェンスを打って次のスロットへ進み、
+  // そのスロットの前回分が GPU で終わるまで待つ（終わっていれば待たない）
+  // 戻り値は今フレームに割り当てたフェンス値
+  uint64_t Advance();
+
+  // 提出済みの処理の完了を待ち、提出済みのフレームで予約した破棄を実行する
+  // 記録中のフレームで予約した破棄は、そのフレームのリストがまだ提出されていないので
+  // 残す（次の Advance で打つフェンス値の完了を待つ）。フレームの途中で呼んでよい
+  void WaitIdle();
+
+  // 終了時に呼ぶ: WaitIdle の後、記録中のフレームの予約も実行する
+  // （そのフレームは提出しないので GPU から参照されない）。以降の DeferRelease は即時
+  void Finalize();
+
+  // 破棄を予約（今のフレームが GPU で使い終わるまで参照を保持する）
+  void DeferRelease(std::function<void()> release);
+
+  // 完了済みフェンス値までの予約を実行する（Advance 内でも呼ばれる）
+  void CollectGarbage();
+
+  // Advance のたびに 1 進む通し番号（WaitIdle では進まない）
+  uint64_t GetFrameNumber() const { return frameNumber_; }
+
+  // 今 CPU が記録しているフレームのスロット番号 [0, framesInFlight)
+  uint32_t GetFrameIndex() const { return frameIndex_; }
+  uint32_t GetFramesInFlight() const { return framesInFlight_; }
+
+  // 今のフレームが Advance で打つ予定のフェンス値
+  uint64_t GetCurrentFenceValue() const { return nextFenceValue_; }
+  // 直近の Advance で待ちが発生したか（デバッグ表示用）
+  bool DidStallLastAdvance() const { return stalledLastAdvance_; }
+
+private:
+  struct PendingRelease {
+    uint64_t fenceValue = 0;
+    std::function<void()> release;
+  };
+
+  IFrameFence *fence_ = nullptr;
+  uint32_t framesInFlight_ = kMinFramesInFlight;
+  uint32_t frameIndex_ = 0;
+  // スロットごとに最後に打ったフェンス値（0 = 未使用）
+  uint64_t slotFenceValues_[kMaxFramesInFlight]{};
+  uint64_t nextFenceValue_ = 1;
+  uint64_t frameNumber_ = 0;
+  bool stalledLastAdvance_ = false;
+  // 提出済みのフレームの予約。フェンス値の昇順に並ぶ
+  std::deque<PendingRelease> pendingReleases_;
+  // 記録中のフレームの予約（Advance で打つ値が決まってから pendingReleases_ へ移す）
+  std::vector<std::function<void()>> frameReleases_;
+};
@@ -1,5 +1,6 @@
 #include "Framework.h"
 #include <Windows.h>
+#include <chrono>
 #include <objbase.h>
 #include <string>
 
@@ -56,6 +57,12 @@ void AbsoluteFrameWork::InitializeEngine_() {
 	};
 	dx_.Initialize(params);
 
+	// 以降のバッファ・テクスチャは共有ヒープから切り出す
+	GpuMemoryAllocator::GetInstance()->Initialize(dx_.GetDevice(), dx_.GetAdapter());
+
+	// 描画記録・読み込みで使うワーカースレッド
+	JobSystem::GetInstance()->Initialize(0, AssetLoadQueue::GetWorkerHooks());
+
 	TextureManager::GetInstance()->Initialize(&dx_);
 	ModelManager::GetInstance()->Initialize(&dx_);
 	ParticleManager::GetInstance()->Initialize(&dx_);
@@ -77,6 +84,10 @@ void AbsoluteFrameWork::FinalizeEngine_() {
 
 	ParticleManager::GetInstance()->Finalize();
 
+	JobSystem::GetInstance()->Finalize();
+
+	GpuMemoryAllocator::GetInstance()->Finalize();
+
 	winApp_.Finalize();
 
 	comScope_.reset(nullptr);
@@ -88,13 +99,24 @@ void AbsoluteFrameWork::Run() {
 	InitializeEngine_();
 	Initialize();
 
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point prevTime = Clock::now();
+
 	while (!endRequest_) {
 		if (!winApp_.ProcessMessage()) {
 			RequestEnd();
 			break;
 		}
 
+		const Clock::time_point now = Clock::now();
+		deltaTime_ = std::chrono::duration<float>(now - prevTime).count();
+		prevTime = now;
+
 		input_.Update();
+		// 読み終わったアセットの GPU 側を仕上げる
+		AssetLoadQueue::GetInstance()->Pump();
+		// 前フレームの描画で集めた使用量から、テクスチャのミップを足す／削る
+		TextureManager::GetInstance()->UpdateStreaming();
 		imgui_.Begin();
 
 		Update();
@@ -107,6 +129,9 @@ void AbsoluteFrameWork::Run() {
 		dx_.PostDraw();
 	}
 
+	// 先行投入中のフレームを終わらせてからリソースを破棄する
+	dx_.WaitForGpuIdle();
+
 	Finalize();
 	FinalizeEngine_();
 }
@@ -9,6 +9,9 @@
 #include "TextureManager.h"
 #include "ModelManager.h"
 #include "ParticleManager.h"
+#include "JobSystem.h"
+#include "AssetLoadQueue.h"
+#include "GpuMemoryAllocator.h"
 
 #include <memory>
 
@@ -25,6 +28,9 @@ public:
 	// 終了チェック
 	bool IsEndRequested() { return endRequest_; };
 
+	// 前フレームからの経過時間（秒）
+	float GetDeltaTime() const { return deltaTime_; }
+
 protected:
 	// 初期化
 	virtual void Initialize();
@@ -59,6 +65,9 @@ private:
 	// 終了要求フラグ
 	bool endRequest_ = false;
 
+	// 実測フレーム時間（秒）。初回は 60fps 相当
+	float deltaTime_ = 1.0f / 60.0f;
+
 	std::unique_ptr<ComScope, void(*)(ComScope*)> comScope_{ nullptr, &DeleteComScope_ };
 
 	WinApp winApp_;
@@ -0,0 +1,351 @@
+#include "GpuMemoryAllocator.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <vector>
+
+namespace {
+// リソースに追跡オブジェクトを結び付けるための private data GUID
+// {6C1E0F3A-8B52-4D7E-9A41-3F2B6C8D9E05}
+constexpr GUID kPlacementGuid = {0x6c1e0f3a, 0x8b52, 0x4d7e,
+                                 {0x9a, 0x41, 0x3f, 0x2b, 0x6c, 0x8d, 0x9e, 0x05}};
+
+uint64_t AlignUp(uint64_t v, uint64_t a) { return (v + a - 1) & ~(a - 1); }
+
+D3D12_HEAP_TYPE PoolHeapType(GpuMemoryPool pool) {
+  return pool == GpuMemoryPool::UploadBuffer ? D3D12_HEAP_TYPE_UPLOAD
+                                             : D3D12_HEAP_TYPE_DEFAULT;
+}
+
+D3D12_HEAP_FLAGS PoolHeapFlags(GpuMemoryPool pool) {
+  return pool == GpuMemoryPool::Texture
+             ? D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES
+             : D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+}
+
+D3D12_RESOURCE_DESC MakeBufferDesc(uint64_t size) {
+  D3D12_RESOURCE_DESC desc{};
+  desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+  desc.Width = size;
+  desc.Height = 1;
+  desc.DepthOrArraySize = 1;
+  desc.MipLevels = 1;
+  desc.SampleDesc.Count = 1;
+  desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+  return desc;
+}
+} // namespace
+
+struct GpuMemoryAllocator::Heap {
+  ComPtr<ID3D12Heap> heap;
+  TlsfAllocator blocks;
+};
+
+struct GpuMemoryAllocator::Pool {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<Heap>> heaps;
+  uint32_t dedicatedCount = 0;
+  uint64_t dedicatedBytes = 0;
+};
+
+// リソースの private data として保持され、リソース破棄時に最後の Release が来る
+// - 配置リソース: ヒープのブロックを返却する（ヒープ自体も shared_ptr で延命）
+// - 専用リソース: 統計の減算のみ
+class GpuMemoryAllocator::Placement final : public IUnknown {
+public:
+  Placement(std::shared_ptr<Pool> pool, std::shared_ptr<Heap> heap,
+            uint32_t handle, uint64_t size)
+      : pool_(std::move(pool)), heap_(std::move(heap)), handle_(handle),
+        size_(size) {}
+
+  HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid,
+                                           void **ppv) override {
+    if (!ppv) {
+      return E_POINTER;
+    }
+    if (riid == __uuidof(IUnknown)) {
+      *ppv = static_cast<IUnknown *>(this);
+      AddRef();
+      return S_OK;
+    }
+    *ppv = nullptr;
+    return E_NOINTERFACE;
+  }
+  ULONG STDMETHODCALLTYPE AddRef() override { return ++refCount_; }
+  ULONG STDMETHODCALLTYPE Release() override {
+    const ULONG count = --refCount_;
+    if (count == 0) {
+      Return_();
+      delete this;
+    }
+    return count;
+  }
+
+private:
+  void Return_() {
+    std::lock_guard<std::mutex> lock(pool_->mutex);
+    if (heap_) {
+      heap_->blocks.Free(handle_);
+    } else {
+      --pool_->dedicatedCount;
+      pool_->dedicatedBytes -= size_;
+    }
+  }
+
+  std::atomic<ULONG> refCount_{1};
+  std::shared_ptr<Pool> pool_;
+  std::shared_ptr<Heap> heap_;
+  uint32_t handle_;
+  uint64_t size_;
+};
+
+GpuMemoryAllocator *GpuMemoryAllocator::GetInstance() {
+  static GpuMemoryAllocator instance;
+  return &instance;
+}
+
+void GpuMemoryAllocator::Initialize(ID3D12Device *device,
+                                    IDXGIAdapter3 *adapter,
+                                    uint64_t heapSize) {
+  assert(device);
+  device_ = device;
+  adapter_ = adapter;
+  heapSize_ = AlignUp(heapSize, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+  for (auto &pool : pools_) {
+    pool = std::make_shared<Pool>();
+  }
+}
+
+void GpuMemoryAllocator::Finalize() {
+  // 生存中のリソースの追跡オブジェクトがプールとヒープを保持しているので、
+  // ここでは参照を手放すだけでよい
+  for (auto &pool : pools_) {
+    pool.reset();
+  }
+  adapter_.Reset();
+  device_.Reset();
+}
+
+GpuMemoryAllocator::ComPtr<ID3D12Resource>
+GpuMemoryAllocator::CreateBuffer(D3D12_HEAP_TYPE heapType, uint64_t size,
+                                 D3D12_RESOURCE_STATES initialState) {
+  const D3D12_RESOURCE_DESC desc = MakeBufferDesc(size);
+  if (heapType == D3D12_HEAP_TYPE_UPLOAD) {
+    return CreateResource_(GpuMemoryPool::UploadBuffer, desc, initialState,
+                           nullptr);
+  }
+  if (heapType == D3D12_HEAP_TYPE_DEFAULT) {
+    return CreateResource_(GpuMemoryPool::DefaultBuffer, desc, initialState,
+                           nullptr);
+  }
+  // READBACK 等はプールを持たない
+  return CreateCommitted_(heapType, desc, initialState, nullptr);
+}
+
+GpuMemoryAllocator::ComPtr<ID3D12Resource>
+GpuMemoryAllocator::CreateTexture(const D3D12_RESOURCE_DESC &desc,
+                                  D3D12_RESOURCE_STATES initialState,
+                                  const D3D12_CLEAR_VALUE *clearValue) {
+  const D3D12_RESOURCE_FLAGS rtds = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET |
+                                    D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+  if ((desc.Flags & rtds) != 0) {
+    // RT/DS は Tier1 で別ヒープが必要なうえ数も少ないので専用で作る
+    return CreateCommitted_(D3D12_HEAP_TYPE_DEFAULT, desc, initialState,
+                            clearValue);
+  }
+  return CreateResource_(GpuMemoryPool::Texture, desc, initialState,
+                         clearValue);
+}
+
+GpuMemoryAllocator::ComPtr<ID3D12Resource>
+GpuMemoryAllocator::CreateResource_(GpuMemoryPool poolKind,
+                                    const D3D12_RESOURCE_DESC &srcDesc,
+                                    D3D12_RESOURCE_STATES initialState,
+                                    const D3D12_CLEAR_VALUE *clearValue) {
+  assert(IsInitialized());
+  const D3D12_HEAP_TYPE heapType = PoolHeapType(poolKind);
+
+  // テクスチャは小さいものなら 4KB アラインで置ける（不可なら 64KB に戻す）
+  D3D12_RESOURCE_DESC desc = srcDesc;
+  D3D12_RESOURCE_ALLOCATION_INFO info{};
+  if (poolKind == GpuMemoryPool::Texture && desc.Alignment == 0) {
+    desc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+    info = device_->GetResourceAllocationInfo(0, 1, &desc);
+    if (info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT) {
+      desc.Alignment = 0;
+      info = device_->GetResourceAllocationInfo(0, 1, &desc);
+    }
+  } else {
+    info = device_->GetResourceAllocationInfo(0, 1, &desc);
+  }
+  if (info.SizeInBytes == UINT64_MAX) {
+    return CreateCommitted_(heapType, srcDesc, initialState, clearValue);
+  }
+
+  const std::shared_ptr<Pool> &pool = pools_[static_cast<size_t>(poolKind)];
+
+  // ヒープの半分を超えるものは詰めても効率が悪いので専用にする
+  if (info.SizeInBytes > heapSize_ / 2) {
+    ComPtr<ID3D12Resource> res =
+        CreateCommitted_(heapType, srcDesc, initialState, clearValue);
+    if (res) {
+      {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        ++pool->dedicatedCount;
+        pool->dedicatedBytes += info.SizeInBytes;
+      }
+      auto *tracker = new Placement(pool, nullptr, 0, info.SizeInBytes);
+      res->SetPrivateDataInterface(kPlacementGuid, tracker);
+      tracker->Release();
+    }
+    return res;
+  }
+
+  std::shared_ptr<Heap> heap;
+  TlsfAllocator::Allocation block{};
+  {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    for (auto &h : pool->heaps) {
+      block = h->blocks.Allocate(info.SizeInBytes, info.Alignment);
+      if (block.IsValid()) {
+        heap = h;
+        break;
+      }
+    }
+
+    if (!heap) {
+      // 既存ヒープに入らなければ 1 枚追加
+      D3D12_HEAP_DESC heapDesc{};
+      heapDesc.SizeInBytes = heapSize_;
+      heapDesc.Properties.Type = heapType;
+      heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+      heapDesc.Flags = PoolHeapFlags(poolKind);
+
+      auto newHeap = std::make_shared<Heap>();
+      HRESULT hr =
+          device_->CreateHeap(&heapDesc, IID_PPV_ARGS(&newHeap->heap));
+      if (FAILED(hr)) {
+        return CreateCommitted_(heapType, srcDesc, initialState, clearValue);
+      }
+      newHeap->blocks.Initialize(heapSize_);
+      block = newHeap->blocks.Allocate(info.SizeInBytes, info.Alignment);
+      assert(block.IsValid());
+      pool->heaps.push_back(newHeap);
+      heap = std::move(newHeap);
+    }
+  }
+
+  ComPtr<ID3D12Resource> res;
+  HRESULT hr = device_->CreatePlacedResource(heap->heap.Get(), block.offset,
+                                             &desc, initialState, clearValue,
+                                             IID_PPV_ARGS(&res));
+  if (FAILED(hr)) {
+    {
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      heap->blocks.Free(block.handle);
+    }
+    return CreateCommitted_(heapType, srcDesc, initialState, clearValue);
+  }
+
+  auto *tracker =
+      new Placement(pool, std::move(heap), block.handle, block.size);
+  res->SetPrivateDataInterface(kPlacementGuid, tracker);
+  tracker->Release();
+  return res;
+}
+
+GpuMemoryAllocator::ComPtr<ID3D12Resource>
+GpuMemoryAllocator::CreateCommitted_(D3D12_HEAP_TYPE heapType,
+                                     const D3D12_RESOURCE_DESC &desc,
+                                     D3D12_RESOURCE_STATES initialState,
+                                     const D3D12_CLEAR_VALUE *clearValue) {
+  assert(IsInitialized());
+  D3D12_HEAP_PROPERTIES heapProps{};
+  heapProps.Type = heapType;
+
+  ComPtr<ID3D12Resource> res;
+  HRESULT hr = device_->CreateCommittedResource(
+      &heapProps, D3D12_HEAP_FLAG_NONE, &desc, initialState, clearValue,
+      IID_PPV_ARGS(&res));
+  assert(SUCCEEDED(hr));
+  return res;
+}
+
+void GpuMemoryAllocator::TrimEmptyHeaps() {
+  for (auto &pool : pools_) {
+    if (!pool) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    auto &heaps = pool->heaps;
+    if (heaps.size() <= 1) {
+      continue;
+    }
+    heaps.erase(std::remove_if(heaps.begin() + 1, heaps.end(),
+                               [](const std::shared_ptr<Heap> &h) {
+                                 return h->blocks.IsEmpty();
+                               }),
+                heaps.end());
+  }
+}
+
+GpuMemoryAllocator::PoolStats
+GpuMemoryAllocator::GetPoolStats(GpuMemoryPool poolKind) const {
+  PoolStats stats{};
+  const std::shared_ptr<Pool> &pool = pools_[static_cast<size_t>(poolKind)];
+  if (!pool) {
+    return stats;
+  }
+  std::lock_guard<std::mutex> lock(pool->mutex);
+  for (const auto &h : pool->heaps) {
+    const TlsfAllocator::Stats s = h->blocks.GetStats();
+    ++stats.heapCount;
+    stats.heapBytes += s.totalSize;
+    stats.usedBytes += s.usedBytes;
+    stats.freeBytes += s.freeBytes;
+    stats.largestFreeBlock = (std::max)(stats.largestFreeBlock, s.largestFreeBlock);
+    stats.allocationCount += s.allocationCount;
+    stats.freeBlockCount += s.freeBlockCount;
+  }
+  stats.dedicatedCount = pool->dedicatedCount;
+  stats.dedicatedBytes = pool->dedicatedBytes;
+  return stats;
+}
+
+GpuMemoryAllocator::BudgetReport GpuMemoryAllocator::GetBudgetReport() const {
+  BudgetReport report{};
+  if (adapter_) {
+    DXGI_QUERY_VIDEO_MEMORY_INFO info{};
+    if (SUCCEEDED(adapter_->QueryVideoMemoryInfo(
+            0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info))) {
+      report.localBudget = info.Budget;
+      report.localUsage = info.CurrentUsage;
+    }
+    if (SUCCEEDED(adapter_->QueryVideoMemoryInfo(
+            0, DXGI_MEMORY_SEGMENT_GROUP_NON_LOCAL, &info))) {
+      report.nonLocalBudget = info.Budget;
+      report.nonLocalUsage = info.CurrentUsage;
+    }
+  }
+  for (uint32_t i = 0; i < static_cast<uint32_t>(GpuMemoryPool::Count); ++i) {
+    const PoolStats s = GetPoolStats(static_cast<GpuMemoryPool>(i));
+    report.heapBytes += s.heapBytes;
+    report.usedBytes += s.usedBytes;
+    report.dedicatedBytes += s.dedicatedBytes;
+  }
+  return report;
+}
+
+const char *GpuMemoryAllocator::GetPoolName(GpuMemoryPool pool) {
+  switch (pool) {
+  case GpuMemoryPool::UploadBuffer:
+    return "UploadBuffer";
+  case GpuMemoryPool::DefaultBuffer:
+    return "DefaultBuffer";
+  case GpuMemoryPool::Texture:
+    return "Texture";
+  default:
+    return "Unknown";
+  }
+}
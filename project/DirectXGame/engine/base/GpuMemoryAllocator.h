@@ -0,0 +1,107 @@
+#pragma once
+#include "TlsfAllocator.h"
+#include <cstdint>
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include <memory>
+#include <wrl.h>
+
+// 大きなヒープ単位で確保し、配置リソース (CreatePlacedResource) として切り出す区分
+// - リソースヒープ Tier1 でも混在できないよう、バッファとテクスチャでヒープを分ける
+enum class GpuMemoryPool : uint32_t {
+  UploadBuffer,  // UPLOAD ヒープのバッファ（VB/IB/CB/中間バッファ）
+  DefaultBuffer, // DEFAULT ヒープのバッファ
+  Texture,       // DEFAULT ヒープの RT/DS 以外のテクスチャ
+  Count,
+};
+
+// GPU メモリの部分確保
+// - ヒープごとの空き管理は TlsfAllocator
+// - 返すのは普通の ComPtr<ID3D12Resource>。リソースが解放されると、
+//   リソースに持たせた追跡オブジェクト経由で自動的にブロックが返却される
+// - ヒープに収まらない大きさと RT/DS テクスチャは従来通り Committed（専用）で作る
+class GpuMemoryAllocator {
+public:
+  template <class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+  static constexpr uint64_t kDefaultHeapSize = 64ull << 20;
+
+  struct PoolStats {
+    uint32_t heapCount = 0;
+    uint64_t heapBytes = 0;
+    uint64_t usedBytes = 0;
+    uint64_t freeBytes = 0;
+    uint64_t largestFreeBlock = 0;
+    uint32_t allocationCount = 0;
+    uint32_t freeBlockCount = 0;
+    // ヒープを使わず Committed で作ったもの
+    uint32_t dedicatedCount = 0;
+    uint64_t dedicatedBytes = 0;
+
+    // 外部断片化率（全ヒープの空きのうち、最大の空きブロックに入らない割合）
+    float Fragmentation() const {
+      return freeBytes == 0 ? 0.0f
+                            : 1.0f - static_cast<float>(largestFreeBlock) /
+                                         static_cast<float>(freeBytes);
+    }
+  };
+
+  // OS から見た予算と、このアロケータが抱えている量
+  struct BudgetReport {
+    uint64_t localBudget = 0;
+    uint64_t localUsage = 0;
+    uint64_t nonLocalBudget = 0;
+    uint64_t nonLocalUsage = 0;
+    uint64_t heapBytes = 0;
+    uint64_t usedBytes = 0;
+    uint64_t dedicatedBytes = 0;
+  };
+
+  static GpuMemoryAllocator *GetInstance();
+
+  // adapter は予算の取得にだけ使う（nullptr 可）
+  void Initialize(ID3D12Device *device, IDXGIAdapter3 *adapter,
+                  uint64_t heapSize = kDefaultHeapSize);
+  // 生存中のリソースはヒープを保持したまま。以降は IsInitialized() == false
+  void Finalize();
+  bool IsInitialized() const { return device_ != nullptr; }
+
+  // 未初期化では呼ばない（呼び出し側で IsInitialized を見て Committed に戻す）
+  ComPtr<ID3D12Resource> CreateBuffer(D3D12_HEAP_TYPE heapType, uint64_t size,
+                                      D3D12_RESOURCE_STATES initialState);
+  ComPtr<ID3D12Resource>
+  CreateTexture(const D3D12_RESOURCE_DESC &desc,
+                D3D12_RESOURCE_STATES initialState,
+                const D3D12_CLEAR_VALUE *clearValue = nullptr);
+
+  // 中身の無くなったヒープを解放（各プールの先頭 1 枚は残す）
+  void TrimEmptyHeaps();
+
+  PoolStats GetPoolStats(GpuMemoryPool pool) const;
+  BudgetReport GetBudgetReport() const;
+  static const char *GetPoolName(GpuMemoryPool pool);
+
+private:
+  GpuMemoryAllocator() = default;
+  ~GpuMemoryAllocator() = default;
+  GpuMemoryAllocator(const GpuMemoryAllocator &) = delete;
+  GpuMemoryAllocator &operator=(const GpuMemoryAllocator &) = delete;
+
+  struct Heap;
+  struct Pool;
+  class Placement;
+
+  ComPtr<ID3D12Resource> CreateResource_(GpuMemoryPool pool,
+                                         const D3D12_RESOURCE_DESC &desc,
+                                         D3D12_RESOURCE_STATES initialState,
+                                         const D3D12_CLEAR_VALUE *clearValue);
+  ComPtr<ID3D12Resource> CreateCommitted_(D3D12_HEAP_TYPE heapType,
+                                          const D3D12_RESOURCE_DESC &desc,
+                                          D3D12_RESOURCE_STATES initialState,
+                                          const D3D12_CLEAR_VALUE *clearValue);
+
+  ComPtr<ID3D12Device> device_;
+  ComPtr<IDXGIAdapter3> adapter_;
+  uint64_t heapSize_ = kDefaultHeapSize;
+  std::shared_ptr<Pool> pools_[static_cast<size_t>(GpuMemoryPool::Count)];
+};
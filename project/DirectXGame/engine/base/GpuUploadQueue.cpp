@@ -0,0 +1,226 @@
+#include "GpuUploadQueue.h"
+#include "DirectXResourceUtils.h"
+#include <Windows.h>
+#include <cassert>
+#include <cstring>
+
+namespace {
+uint64_t AlignUp(uint64_t v, uint64_t a) { return (v + a - 1) & ~(a - 1); }
+} // namespace
+
+GpuUploadQueue::~GpuUploadQueue() { Finalize(); }
+
+void GpuUploadQueue::Initialize(ID3D12Device *device, uint64_t stagingSize) {
+  assert(device);
+  device_ = device;
+
+  D3D12_COMMAND_QUEUE_DESC queueDesc{};
+  queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+  HRESULT hr = device_->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&queue_));
+  assert(SUCCEEDED(hr));
+
+  hr = device_->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence_));
+  assert(SUCCEEDED(hr));
+  fenceEvent_ = CreateEvent(NULL, FALSE, FALSE, NULL);
+  assert(fenceEvent_ != nullptr);
+
+  stagingSize_ = AlignUp(stagingSize, kStagingAlignment);
+  stagingRing_.Initialize(stagingSize_);
+  staging_ = CreateBufferResource(device_, static_cast<size_t>(stagingSize_));
+  D3D12_RANGE readRange{0, 0};
+  hr = staging_->Map(0, &readRange, reinterpret_cast<void **>(&stagingMapped_));
+  assert(SUCCEEDED(hr));
+}
+
+void GpuUploadQueue::Finalize() {
+  if (!device_) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 記録途中のコピーは投入してから待つ（作ったバッファの中身を保証する）
+    Submit_();
+  }
+  WaitIdle();
+
+  if (fenceEvent_) {
+    CloseHandle(fenceEvent_);
+    fenceEvent_ = nullptr;
+  }
+  if (staging_) {
+    staging_->Unmap(0, nullptr);
+  }
+  stagingMapped_ = nullptr;
+  staging_.Reset();
+  allocators_.clear();
+  currentAllocator_ = {};
+  commandList_.Reset();
+  fence_.Reset();
+  queue_.Reset();
+  device_.Reset();
+}
+
+GpuUploadQueue::ComPtr<ID3D12Resource>
+GpuUploadQueue::CreateStaticBuffer(const void *data, size_t size) {
+  assert(device_);
+  if (!data || size == 0) {
+    return nullptr;
+  }
+
+  ComPtr<ID3D12Resource> dst = CreateDefaultBufferResource(device_, size);
+  if (!dst) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  ID3D12Resource *src = nullptr;
+  uint64_t srcOffset = 0;
+  if (size > stagingSize_ / 2) {
+    // リングを占有するほど大きいものは専用のステージングで送る
+    ComPtr<ID3D12Resource> temp = CreateBufferResource(device_, size);
+    void *mapped = nullptr;
+    HRESULT hr = temp->Map(0, nullptr, &mapped);
+    assert(SUCCEEDED(hr));
+    std::memcpy(mapped, data, size);
+    temp->Unmap(0, nullptr);
+    src = temp.Get();
+    pendingKeepAlive_.push_back(std::move(temp));
+  } else {
+    srcOffset = AllocateStaging_(size);
+    std::memcpy(stagingMapped_ + srcOffset, data, size);
+    src = staging_.Get();
+  }
+
+  BeginRecording_();
+  commandList_->CopyBufferRegion(dst.Get(), 0, src, srcOffset, size);
+
+  stats_.uploadedBytes += size;
+  ++stats_.copies;
+  return dst;
+}
+
+void GpuUploadQueue::Flush(ID3D12CommandQueue *consumer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!device_) {
+    return;
+  }
+  Submit_();
+  if (consumer && waitedValue_ < submittedValue_) {
+    HRESULT hr = consumer->Wait(fence_.Get(), submittedValue_);
+    assert(SUCCEEDED(hr));
+    waitedValue_ = submittedValue_;
+  }
+  Retire_();
+}
+
+void GpuUploadQueue::WaitIdle() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!fence_) {
+    return;
+  }
+  WaitForFence_(submittedValue_);
+  Retire_();
+}
+
+GpuUploadQueue::Stats GpuUploadQueue::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+uint64_t GpuUploadQueue::AllocateStaging_(uint64_t size) {
+  for (;;) {
+    Retire_();
+    const uint64_t usedBefore = stagingRing_.GetUsed();
+    const uint64_t offset = stagingRing_.Allocate(size, kStagingAlignment);
+    if (offset != RingAllocator::kInvalidOffset) {
+      pendingBytes_ += stagingRing_.GetUsed() - usedBefore;
+      return offset;
+    }
+    // 今のバッチがリングを埋めているなら先に投入し、古い投入から順に完了を待つ
+    Submit_();
+    assert(!submissions_.empty());
+    ++stats_.stagingStalls;
+    WaitForFence_(submissions_.front().fenceValue);
+  }
+}
+
+void GpuUploadQueue::BeginRecording_() {
+  if (recording_) {
+    return;
+  }
+
+  // GPU が使い終わったアロケータを再利用し、無ければ作る
+  const uint64_t completed = fence_->GetCompletedValue();
+  if (!allocators_.empty() && allocators_.front().fenceValue <= completed) {
+    currentAllocator_ = std::move(allocators_.front());
+    allocators_.pop_front();
+    HRESULT hr = currentAllocator_.allocator->Reset();
+    assert(SUCCEEDED(hr));
+  } else {
+    currentAllocator_ = {};
+    HRESULT hr = device_->CreateCommandAllocator(
+        D3D12_COMMAND_LIST_TYPE_COPY,
+        IID_PPV_ARGS(&currentAllocator_.allocator));
+    assert(SUCCEEDED(hr));
+  }
+
+  if (!commandList_) {
+    HRESULT hr = device_->CreateCommandList(
+        0, D3D12_COMMAND_LIST_TYPE_COPY, currentAllocator_.allocator.Get(),
+        nullptr, IID_PPV_ARGS(&commandList_));
+    assert(SUCCEEDED(hr));
+  } else {
+    HRESULT hr =
+        commandList_->Reset(currentAllocator_.allocator.Get(), nullptr);
+    assert(SUCCEEDED(hr));
+  }
+  recording_ = true;
+}
+
+void GpuUploadQueue::Submit_() {
+  if (!recording_) {
+    return;
+  }
+
+  HRESULT hr = commandList_->Close();
+  assert(SUCCEEDED(hr));
+  ID3D12CommandList *lists[]{commandList_.Get()};
+  queue_->ExecuteCommandLists(1, lists);
+  ++submittedValue_;
+  hr = queue_->Signal(fence_.Get(), submittedValue_);
+  assert(SUCCEEDED(hr));
+
+  currentAllocator_.fenceValue = submittedValue_;
+  allocators_.push_back(std::move(currentAllocator_));
+  currentAllocator_ = {};
+
+  Submission submission{};
+  submission.fenceValue = submittedValue_;
+  submission.stagingBytes = pendingBytes_;
+  submission.keepAlive = std::move(pendingKeepAlive_);
+  submissions_.push_back(std::move(submission));
+  pendingBytes_ = 0;
+  pendingKeepAlive_.clear();
+
+  recording_ = false;
+  ++stats_.submissions;
+}
+
+void GpuUploadQueue::Retire_() {
+  const uint64_t completed = fence_->GetCompletedValue();
+  while (!submissions_.empty() &&
+         submissions_.front().fenceValue <= completed) {
+    stagingRing_.Release(submissions_.front().stagingBytes);
+    submissions_.pop_front();
+  }
+}
+
+void GpuUploadQueue::WaitForFence_(uint64_t value) {
+  if (fence_->GetCompletedValue() >= value) {
+    return;
+  }
+  HRESULT hr = fence_->SetEventOnCompletion(value, fenceEvent_);
+  assert(SUCCEEDED(hr));
+  WaitForSingleObject(fenceEvent_, INFINITE);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <d3d12.h>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <wrl.h>
+
+#include "RingAllocator.h"
+
+// 静的データを DEFAULT ヒープへ 1 回だけ転送するためのコピーキュー
+// - 転送元はリングで使い回すステージングバッファ（フェンス完了後に再利用）
+// - 積んだコピーは Flush で 1 回の ExecuteCommandLists にまとめて投入する
+// - バッファは COMMON で作り、コピーキュー上で暗黙に COPY_DEST へ昇格、
+//   実行完了で COMMON へ戻る。描画側キューでも読み取り状態へ暗黙昇格するので
+//   遷移バリアは不要
+// - 複数スレッドから呼んでよい
+class GpuUploadQueue {
+public:
+  template <class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+  static constexpr uint64_t kDefaultStagingSize = 16ull << 20;
+  // ステージング内の配置単位（テクスチャのコピー元にも使える値）
+  static constexpr uint64_t kStagingAlignment =
+      D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+
+  struct Stats {
+    uint64_t uploadedBytes = 0;
+    uint32_t copies = 0;
+    uint32_t submissions = 0;
+    // ステージングが空くまで CPU が待った回数
+    uint32_t stagingStalls = 0;
+  };
+
+  GpuUploadQueue() = default;
+  ~GpuUploadQueue();
+
+  GpuUploadQueue(const GpuUploadQueue &) = delete;
+  GpuUploadQueue &operator=(const GpuUploadQueue &) = delete;
+
+  void Initialize(ID3D12Device *device,
+                  uint64_t stagingSize = kDefaultStagingSize);
+  void Finalize();
+
+  // DEFAULT ヒープのバッファを作り、data のコピーを今のバッチに積む
+  // 返したバッファは Flush で待ちを入れたキューの、それ以降のコマンドから使える
+  ComPtr<ID3D12Resource> CreateStaticBuffer(const void *data, size_t size);
+
+  // 積んだコピーを投入し、consumer に完了待ち (GPU 側の Wait) を入れる
+  // 何も積まれておらず待ちも済んでいれば何もしない
+  void Flush(ID3D12CommandQueue *consumer);
+
+  // 投入済みのコピーの完了を CPU で待つ
+  void WaitIdle();
+
+  Stats GetStats() const;
+
+private:
+  struct Submission {
+    uint64_t fenceValue = 0;
+    uint64_t stagingBytes = 0;
+    // リングに入らない大きさ用の一時ステージング
+    std::vector<ComPtr<ID3D12Resource>> keepAlive;
+  };
+  struct AllocatorEntry {
+    ComPtr<ID3D12CommandAllocator> allocator;
+    uint64_t fenceValue = 0;
+  };
+
+  // ステージングに size バイト確保してオフセットを返す（空くまで待つこともある）
+  uint64_t AllocateStaging_(uint64_t size);
+  void BeginRecording_();
+  void Submit_();
+  void Retire_();
+  void WaitForFence_(uint64_t value);
+
+  mutable std::mutex mutex_;
+
+  ComPtr<ID3D12Device> device_;
+  ComPtr<ID3D12CommandQueue> queue_;
+  ComPtr<ID3D12GraphicsCommandList> commandList_;
+  std::deque<AllocatorEntry> allocators_;
+  AllocatorEntry currentAllocator_{};
+  bool recording_ = false;
+
+  ComPtr<ID3D12Fence> fence_;
+  HANDLE fenceEvent_ = nullptr;
+  uint64_t submittedValue_ = 0;
+  // consumer に Wait を入れ済みのフェンス値
+  uint64_t waitedValue_ = 0;
+
+  // ステージングリング（投入が完了した順に Release する）
+  ComPtr<ID3D12Resource> staging_;
+  uint8_t *stagingMapped_ = nullptr;
+  uint64_t stagingSize_ = 0;
+  RingAllocator stagingRing_;
+  // 今記録中のバッチが使ったバイト数（パディング込み）
+  uint64_t pendingBytes_ = 0;
+  std::vector<ComPtr<ID3D12Resource>> pendingKeepAlive_;
+  std::deque<Submission> submissions_;
+
+  Stats stats_{};
+};
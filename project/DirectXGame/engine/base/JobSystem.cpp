@@ -0,0 +1,161 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <memory>
+
+JobSystem *JobSystem::GetInstance() {
+  static JobSystem instance;
+  return &instance;
+}
+
+JobSystem::~JobSystem() { Finalize(); }
+
+void JobSystem::Initialize(uint32_t workerCount, WorkerHooks hooks) {
+  Finalize();
+
+  if (workerCount == 0) {
+    const uint32_t hw = std::thread::hardware_concurrency();
+    workerCount = hw > 1 ? hw - 1 : 0;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = false;
+  }
+  workers_.reserve(workerCount);
+  for (uint32_t i = 0; i < workerCount; ++i) {
+    workers_.emplace_back([this, hooks]() { WorkerLoop_(hooks); });
+  }
+}
+
+void JobSystem::Finalize() {
+  WaitIdle();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wakeCv_.notify_all();
+  for (auto &t : workers_) {
+    if (t.joinable()) {
+      t.join();
+    }
+  }
+  workers_.clear();
+}
+
+void JobSystem::Dispatch(uint32_t jobCount,
+                         const std::function<void(uint32_t)> &job) {
+  if (jobCount == 0) {
+    return;
+  }
+  if (jobCount == 1 || workers_.empty()) {
+    for (uint32_t i = 0; i < jobCount; ++i) {
+      job(i);
+    }
+    return;
+  }
+
+  // Dispatch ごとの状態
+  // - ヘルパーが Dispatch から戻った後に動き出しても安全なよう共有所有にする
+  // - 呼び出し元だけで全件消化できるので、キューが詰まっていても待ち続けない
+  struct State {
+    std::function<void(uint32_t)> job;
+    uint32_t jobCount = 0;
+    std::atomic<uint32_t> next{0};
+    std::atomic<uint32_t> remaining{0};
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+  };
+  auto state = std::make_shared<State>();
+  state->job = job;
+  state->jobCount = jobCount;
+  state->remaining = jobCount;
+
+  auto worker = [state]() {
+    for (;;) {
+      const uint32_t i = state->next.fetch_add(1);
+      if (i >= state->jobCount) {
+        break;
+      }
+      state->job(i);
+      if (state->remaining.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(state->doneMutex);
+        state->doneCv.notify_all();
+      }
+    }
+  };
+
+  const uint32_t helpers =
+      std::min(jobCount - 1, static_cast<uint32_t>(workers_.size()));
+  for (uint32_t h = 0; h < helpers; ++h) {
+    Submit(worker);
+  }
+
+  // 呼び出し元も消化に参加する
+  worker();
+
+  std::unique_lock<std::mutex> lock(state->doneMutex);
+  state->doneCv.wait(lock, [&]() { return state->remaining.load() == 0; });
+}
+
+void JobSystem::Submit(std::function<void()> job) {
+  if (workers_.empty()) {
+    job();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(job));
+    ++pending_;
+  }
+  wakeCv_.notify_one();
+}
+
+void JobSystem::WaitIdle() {
+  // 待つ間も呼び出し元でキューを消化する
+  while (RunOne_()) {
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  idleCv_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+bool JobSystem::RunOne_() {
+  std::function<void()> job;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) {
+      return false;
+    }
+    job = std::move(queue_.front());
+    queue_.pop_front();
+  }
+
+  job();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--pending_ == 0) {
+      idleCv_.notify_all();
+    }
+  }
+  return true;
+}
+
+void JobSystem::WorkerLoop_(const WorkerHooks &hooks) {
+  if (hooks.onStart) {
+    hooks.onStart();
+  }
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wakeCv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+      if (stop_ && queue_.empty()) {
+        break;
+      }
+    }
+    RunOne_();
+  }
+  if (hooks.onExit) {
+    hooks.onExit();
+  }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定数のワーカースレッドで動くジョブシステム
+// - Dispatch: 並列 for（呼び出し元も手伝い、全ジョブ完了まで戻らない）
+// - Submit : 投げっぱなしのバックグラウンドジョブ
+// - ワーカー 0 本でも動く（全て呼び出し元スレッドで実行）
+class JobSystem {
+public:
+  static JobSystem *GetInstance();
+
+  // 各ワーカースレッドの開始直後・終了直前にそのスレッドで呼ぶ処理（COM の初期化など）
+  struct WorkerHooks {
+    std::function<void()> onStart;
+    std::function<void()> onExit;
+  };
+
+  // workerCount == 0 のときは (論理コア数 - 1) を使う
+  void Initialize(uint32_t workerCount = 0, WorkerHooks hooks = {});
+  // 残っているジョブを実行し切ってからスレッドを止める
+  void Finalize();
+
+  // job(index) を index = 0..jobCount-1 で並列に実行し、全て終わるまで待つ
+  void Dispatch(uint32_t jobCount, const std::function<void(uint32_t)> &job);
+
+  // 完了を待たないジョブを積む
+  void Submit(std::function<void()> job);
+
+  // 積まれたジョブが全て終わるまで待つ
+  void WaitIdle();
+
+  uint32_t GetWorkerCount() const {
+    return static_cast<uint32_t>(workers_.size());
+  }
+
+private:
+  JobSystem() = default;
+  ~JobSystem();
+  JobSystem(const JobSystem &) = delete;
+  JobSystem &operator=(const JobSystem &) = delete;
+
+  void WorkerLoop_(const WorkerHooks &hooks);
+  // キューから 1 つ取り出して実行（無ければ false）
+  bool RunOne_();
+
+  std::vector<std::thread> workers_;
+  std::deque<std::function<void()>> queue_;
+  std::mutex mutex_;
+  std::condition_variable wakeCv_;
+  std::condition_variable idleCv_;
+  uint32_t pending_ = 0; // 積まれて未完了のジョブ数（mutex_ で保護）
+  bool stop_ = false;
+};
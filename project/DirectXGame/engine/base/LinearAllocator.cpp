@@ -0,0 +1,33 @@
+#include "LinearAllocator.h"
+#include <cassert>
+
+void LinearAllocator::Initialize(uint64_t begin, uint64_t capacity) {
+  begin_ = begin;
+  capacity_ = capacity;
+  head_ = begin;
+  peak_ = 0;
+  allocationCount_ = 0;
+}
+
+uint64_t LinearAllocator::Allocate(uint64_t size, uint64_t alignment) {
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+  const uint64_t offset = (head_ + alignment - 1) & ~(alignment - 1);
+  const uint64_t end = begin_ + capacity_;
+  // offset + size のオーバーフローも弾く
+  if (offset < head_ || offset > end || size > end - offset) {
+    return kInvalidOffset;
+  }
+
+  head_ = offset + size;
+  ++allocationCount_;
+  if (GetUsed() > peak_) {
+    peak_ = GetUsed();
+  }
+  return offset;
+}
+
+void LinearAllocator::Reset() {
+  head_ = begin_;
+  allocationCount_ = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+// 範囲 [begin, begin + capacity) を先頭から詰めて確保し、Reset で一括解放する
+// - 実メモリは持たずオフセットだけを管理する（GPU バッファの部分確保に使う）
+// - 個別の解放はできない。フレーム単位など寿命が揃ったデータ向け
+// - スレッドセーフではない
+class LinearAllocator {
+public:
+  static constexpr uint64_t kInvalidOffset = ~0ull;
+
+  LinearAllocator() = default;
+  LinearAllocator(uint64_t begin, uint64_t capacity) { Initialize(begin, capacity); }
+
+  void Initialize(uint64_t begin, uint64_t capacity);
+
+  // alignment は 2 の冪（絶対オフセットで揃える）。入り切らなければ kInvalidOffset
+  uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+  // 確保済みを全て捨てる（ピークは保持）
+  void Reset();
+
+  uint64_t GetBegin() const { return begin_; }
+  uint64_t GetCapacity() const { return capacity_; }
+  // アライメントの詰め物も含めた使用量
+  uint64_t GetUsed() const { return head_ - begin_; }
+  // Initialize 以降の最大使用量
+  uint64_t GetPeak() const { return peak_; }
+  uint32_t GetAllocationCount() const { return allocationCount_; }
+
+private:
+  uint64_t begin_ = 0;
+  uint64_t capacity_ = 0;
+  uint64_t head_ = 0;
+  uint64_t peak_ = 0;
+  uint32_t allocationCount_ = 0;
+};
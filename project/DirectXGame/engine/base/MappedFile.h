@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ファイルを読み取り専用でメモリにマップする（Windows / POSIX）
+// - 中身はページ単位で必要になった時に読まれるので、大きなファイルでも Open は軽い
+// - ムーブのみ可。破棄時にアンマップする
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile() { Close(); }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  // 失敗（存在しない・空・マップ不可）なら false
+  bool Open(const std::string &path);
+  void Close();
+
+  bool IsOpen() const { return data_ != nullptr; }
+  const uint8_t *GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+
+private:
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+#ifdef _WIN32
+  void *file_ = nullptr;    // HANDLE
+  void *mapping_ = nullptr; // HANDLE
+#endif
+};
@@ -0,0 +1,38 @@
+#include "RingAllocator.h"
+#include <cassert>
+
+void RingAllocator::Initialize(uint64_t capacity) {
+  capacity_ = capacity;
+  head_ = 0;
+  used_ = 0;
+}
+
+uint64_t RingAllocator::Allocate(uint64_t size, uint64_t alignment) {
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  if (size > capacity_) {
+    return kInvalidOffset;
+  }
+
+  uint64_t begin = (head_ + alignment - 1) & ~(alignment - 1);
+  if (begin < head_ || begin > capacity_ || size > capacity_ - begin) {
+    // 末尾に入らなければ先頭へ折り返す（末尾の余りは詰め物として消費）
+    begin = 0;
+  }
+  const uint64_t padding = begin >= head_ ? begin - head_ : capacity_ - head_;
+  const uint64_t need = padding + size;
+  if (need > capacity_ - used_) {
+    return kInvalidOffset;
+  }
+
+  head_ = begin + size;
+  if (head_ == capacity_) {
+    head_ = 0;
+  }
+  used_ += need;
+  return begin;
+}
+
+void RingAllocator::Release(uint64_t bytes) {
+  assert(bytes <= used_);
+  used_ -= bytes;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+
+// 範囲 [0, capacity) を環状に確保し、古い順に解放するアロケータ
+// - 実メモリは持たずオフセットだけを管理する（ステージングバッファの使い回しに使う）
+// - 末尾に入らない確保は先頭へ折り返し、末尾の余りは詰め物として使用量に含める
+// - 解放は確保した順に、確保で増えた使用量ぶんずつ Release する
+// - スレッドセーフではない
+class RingAllocator {
+public:
+  static constexpr uint64_t kInvalidOffset = ~0ull;
+
+  RingAllocator() = default;
+  explicit RingAllocator(uint64_t capacity) { Initialize(capacity); }
+
+  void Initialize(uint64_t capacity);
+
+  // alignment は 2 の冪。空きが足りなければ kInvalidOffset
+  uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+  // 一番古い確保から bytes（詰め物込みの使用量）を返す
+  void Release(uint64_t bytes);
+
+  uint64_t GetCapacity() const { return capacity_; }
+  // 詰め物も含めた使用量
+  uint64_t GetUsed() const { return used_; }
+
+private:
+  uint64_t capacity_ = 0;
+  uint64_t head_ = 0;
+  uint64_t used_ = 0;
+};
@@ -0,0 +1,266 @@
+#include "TlsfAllocator.h"
+#include <bit>
+#include <cassert>
+
+namespace {
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint32_t HighestBit(uint64_t value) {
+  return static_cast<uint32_t>(63 - std::countl_zero(value));
+}
+} // namespace
+
+void TlsfAllocator::Initialize(uint64_t size) {
+  blocks_.clear();
+  unusedBlocks_.clear();
+  firstLevelBitmap_ = 0;
+  for (uint32_t fl = 0; fl < kFirstLevelCount; ++fl) {
+    secondLevelBitmap_[fl] = 0;
+    for (uint32_t sl = 0; sl < kSecondLevelCount; ++sl) {
+      freeHeads_[fl][sl] = kNull;
+    }
+  }
+
+  totalSize_ = size & ~(kMinBlockSize - 1);
+  usedBytes_ = 0;
+  allocationCount_ = 0;
+
+  if (totalSize_ == 0) {
+    return;
+  }
+  const uint32_t index = NewBlock_();
+  blocks_[index].offset = 0;
+  blocks_[index].size = totalSize_;
+  InsertFree_(index);
+}
+
+TlsfAllocator::Allocation TlsfAllocator::Allocate(uint64_t size,
+                                                  uint64_t alignment) {
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+  Allocation result{};
+  if (size == 0 || size > totalSize_) {
+    return result;
+  }
+  if (alignment < kMinBlockSize) {
+    alignment = kMinBlockSize;
+  }
+  size = AlignUp(size, kMinBlockSize);
+
+  // 先頭を揃えるための詰め物ぶんも含めて入るブロックを探す
+  const uint64_t searchSize = size + (alignment - kMinBlockSize);
+  const uint32_t index = FindFree_(searchSize);
+  if (index == kNull) {
+    return result;
+  }
+  RemoveFree_(index);
+
+  // 先頭の詰め物は独立した空きブロックとして戻す
+  const uint64_t alignedOffset = AlignUp(blocks_[index].offset, alignment);
+  const uint64_t padding = alignedOffset - blocks_[index].offset;
+  uint32_t target = index;
+  if (padding > 0) {
+    SplitTail_(index, padding);
+    target = blocks_[index].nextPhysical;
+    RemoveFree_(target);
+    InsertFree_(index);
+  }
+
+  if (blocks_[target].size - size >= kMinBlockSize) {
+    SplitTail_(target, size);
+  }
+
+  Block &b = blocks_[target];
+  b.free = false;
+  usedBytes_ += b.size;
+  ++allocationCount_;
+
+  result.offset = b.offset;
+  result.size = b.size;
+  result.handle = target;
+  return result;
+}
+
+void TlsfAllocator::Free(uint32_t handle) {
+  assert(handle < blocks_.size());
+  assert(blocks_[handle].alive && !blocks_[handle].free);
+
+  usedBytes_ -= blocks_[handle].size;
+  --allocationCount_;
+  blocks_[handle].free = true;
+
+  uint32_t index = handle;
+  // 後ろ → 前の順に結合（前と結合すると index が前のブロックに移る）
+  const uint32_t next = blocks_[index].nextPhysical;
+  if (next != kNull && blocks_[next].free) {
+    RemoveFree_(next);
+    MergeWithNext_(index);
+  }
+  const uint32_t prev = blocks_[index].prevPhysical;
+  if (prev != kNull && blocks_[prev].free) {
+    RemoveFree_(prev);
+    MergeWithNext_(prev);
+    index = prev;
+  }
+  InsertFree_(index);
+}
+
+TlsfAllocator::Stats TlsfAllocator::GetStats() const {
+  Stats stats{};
+  stats.totalSize = totalSize_;
+  stats.usedBytes = usedBytes_;
+  stats.freeBytes = totalSize_ - usedBytes_;
+  stats.allocationCount = allocationCount_;
+
+  for (uint32_t fl = 0; fl < kFirstLevelCount; ++fl) {
+    for (uint32_t sl = 0; sl < kSecondLevelCount; ++sl) {
+      for (uint32_t i = freeHeads_[fl][sl]; i != kNull; i = blocks_[i].nextFree) {
+        ++stats.freeBlockCount;
+        if (blocks_[i].size > stats.largestFreeBlock) {
+          stats.largestFreeBlock = blocks_[i].size;
+        }
+      }
+    }
+  }
+  return stats;
+}
+
+void TlsfAllocator::MappingInsert_(uint64_t size, uint32_t &fl, uint32_t &sl) {
+  // size >= kMinBlockSize (2^8) なので fl >= kSecondLevelLog2 が保証される
+  fl = HighestBit(size);
+  sl = static_cast<uint32_t>(size >> (fl - kSecondLevelLog2)) ^ kSecondLevelCount;
+}
+
+bool TlsfAllocator::MappingSearch_(uint64_t size, uint32_t &fl, uint32_t &sl) {
+  // クラスの上端まで切り上げ、見つかったリストのどのブロックでも入るようにする
+  const uint64_t round = (1ull << (HighestBit(size) - kSecondLevelLog2)) - 1;
+  if (size > ~0ull - round) {
+    return false;
+  }
+  MappingInsert_(size + round, fl, sl);
+  return true;
+}
+
+uint32_t TlsfAllocator::NewBlock_() {
+  uint32_t index;
+  if (!unusedBlocks_.empty()) {
+    index = unusedBlocks_.back();
+    unusedBlocks_.pop_back();
+    blocks_[index] = Block{};
+  } else {
+    index = static_cast<uint32_t>(blocks_.size());
+    blocks_.push_back(Block{});
+  }
+  blocks_[index].alive = true;
+  return index;
+}
+
+void TlsfAllocator::DeleteBlock_(uint32_t index) {
+  blocks_[index].alive = false;
+  unusedBlocks_.push_back(index);
+}
+
+void TlsfAllocator::InsertFree_(uint32_t index) {
+  Block &b = blocks_[index];
+  b.free = true;
+  uint32_t fl, sl;
+  MappingInsert_(b.size, fl, sl);
+
+  b.prevFree = kNull;
+  b.nextFree = freeHeads_[fl][sl];
+  if (b.nextFree != kNull) {
+    blocks_[b.nextFree].prevFree = index;
+  }
+  freeHeads_[fl][sl] = index;
+  firstLevelBitmap_ |= 1ull << fl;
+  secondLevelBitmap_[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::RemoveFree_(uint32_t index) {
+  Block &b = blocks_[index];
+  uint32_t fl, sl;
+  MappingInsert_(b.size, fl, sl);
+
+  if (b.prevFree != kNull) {
+    blocks_[b.prevFree].nextFree = b.nextFree;
+  } else {
+    freeHeads_[fl][sl] = b.nextFree;
+  }
+  if (b.nextFree != kNull) {
+    blocks_[b.nextFree].prevFree = b.prevFree;
+  }
+  b.prevFree = kNull;
+  b.nextFree = kNull;
+
+  if (freeHeads_[fl][sl] == kNull) {
+    secondLevelBitmap_[fl] &= ~(1u << sl);
+    if (secondLevelBitmap_[fl] == 0) {
+      firstLevelBitmap_ &= ~(1ull << fl);
+    }
+  }
+}
+
+uint32_t TlsfAllocator::FindFree_(uint64_t size) {
+  uint32_t fl, sl;
+  if (MappingSearch_(size, fl, sl) && fl < kFirstLevelCount) {
+    uint32_t slMap = secondLevelBitmap_[fl] & (~0u << sl);
+    if (slMap == 0) {
+      const uint64_t flMap = (fl + 1 < kFirstLevelCount)
+                                 ? (firstLevelBitmap_ & (~0ull << (fl + 1)))
+                                 : 0;
+      if (flMap != 0) {
+        fl = static_cast<uint32_t>(std::countr_zero(flMap));
+        slMap = secondLevelBitmap_[fl];
+      }
+    }
+    if (slMap != 0) {
+      sl = static_cast<uint32_t>(std::countr_zero(slMap));
+      return freeHeads_[fl][sl];
+    }
+  }
+
+  // 切り上げたクラスより上に無ければ、同じクラスのリストを線形に探す
+  // （ヒープ全体に近いサイズを空のヒープから取る場合など）
+  MappingInsert_(size, fl, sl);
+  for (uint32_t i = freeHeads_[fl][sl]; i != kNull; i = blocks_[i].nextFree) {
+    if (blocks_[i].size >= size) {
+      return i;
+    }
+  }
+  return kNull;
+}
+
+void TlsfAllocator::SplitTail_(uint32_t index, uint64_t size) {
+  assert(blocks_[index].size > size);
+  const uint32_t tail = NewBlock_();
+  // NewBlock_ で blocks_ が再確保されうるので参照は取り直す
+  Block &b = blocks_[index];
+  Block &t = blocks_[tail];
+
+  t.offset = b.offset + size;
+  t.size = b.size - size;
+  t.prevPhysical = index;
+  t.nextPhysical = b.nextPhysical;
+  if (t.nextPhysical != kNull) {
+    blocks_[t.nextPhysical].prevPhysical = tail;
+  }
+  b.size = size;
+  b.nextPhysical = tail;
+  InsertFree_(tail);
+}
+
+void TlsfAllocator::MergeWithNext_(uint32_t index) {
+  Block &b = blocks_[index];
+  const uint32_t next = b.nextPhysical;
+  assert(next != kNull);
+  Block &n = blocks_[next];
+
+  b.size += n.size;
+  b.nextPhysical = n.nextPhysical;
+  if (b.nextPhysical != kNull) {
+    blocks_[b.nextPhysical].prevPhysical = index;
+  }
+  DeleteBlock_(next);
+}
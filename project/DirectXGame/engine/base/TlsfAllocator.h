@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// TLSF (Two-Level Segregated Fit) による範囲アロケータ
+// - 実メモリは持たずオフセットだけを管理する（GPU ヒープの部分確保に使う）
+// - 空きブロックをサイズの 2 段階のクラスで分類し、O(1) で探索・解放する
+// - 解放時は物理的に隣接する空きブロックと結合する
+// - スレッドセーフではない（呼び出し側で排他する）
+class TlsfAllocator {
+public:
+  // 確保の最小単位（サイズ・オフセットはこの倍数に揃う）
+  static constexpr uint64_t kMinBlockSize = 256;
+  static constexpr uint32_t kInvalidHandle = ~0u;
+
+  struct Allocation {
+    uint64_t offset = 0;
+    uint64_t size = 0; // 実際に予約したサイズ（kMinBlockSize 単位に切り上げ）
+    uint32_t handle = kInvalidHandle;
+
+    bool IsValid() const { return handle != kInvalidHandle; }
+  };
+
+  struct Stats {
+    uint64_t totalSize = 0;
+    uint64_t usedBytes = 0;
+    uint64_t freeBytes = 0;
+    uint64_t largestFreeBlock = 0;
+    uint32_t allocationCount = 0;
+    uint32_t freeBlockCount = 0;
+
+    // 外部断片化率: 0 = 空きが 1 ブロックにまとまっている / 1 に近いほど細切れ
+    float Fragmentation() const {
+      return freeBytes == 0 ? 0.0f
+                            : 1.0f - static_cast<float>(largestFreeBlock) /
+                                         static_cast<float>(freeBytes);
+    }
+  };
+
+  TlsfAllocator() = default;
+  explicit TlsfAllocator(uint64_t size) { Initialize(size); }
+
+  // [0, size) を管理する（size は kMinBlockSize 単位に切り捨て）
+  void Initialize(uint64_t size);
+
+  // alignment は 2 の冪。確保できなければ IsValid() == false
+  Allocation Allocate(uint64_t size, uint64_t alignment = kMinBlockSize);
+  void Free(uint32_t handle);
+
+  bool IsEmpty() const { return allocationCount_ == 0; }
+  uint64_t GetSize() const { return totalSize_; }
+  Stats GetStats() const;
+
+private:
+  // 第 2 段の分割数 = 2^kSecondLevelLog2
+  static constexpr uint32_t kSecondLevelLog2 = 4;
+  static constexpr uint32_t kSecondLevelCount = 1u << kSecondLevelLog2;
+  static constexpr uint32_t kFirstLevelCount = 64;
+  static constexpr uint32_t kNull = ~0u;
+
+  struct Block {
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    uint32_t prevPhysical = kNull;
+    uint32_t nextPhysical = kNull;
+    uint32_t prevFree = kNull;
+    uint32_t nextFree = kNull;
+    bool free = false;
+    bool alive = false;
+  };
+
+  static void MappingInsert_(uint64_t size, uint32_t &fl, uint32_t &sl);
+  static bool MappingSearch_(uint64_t size, uint32_t &fl, uint32_t &sl);
+
+  uint32_t NewBlock_();
+  void DeleteBlock_(uint32_t index);
+  void InsertFree_(uint32_t index);
+  void RemoveFree_(uint32_t index);
+  uint32_t FindFree_(uint64_t size);
+  // index の先頭 size バイトを残し、残りを新しい空きブロックにする
+  void SplitTail_(uint32_t index, uint64_t size);
+  void MergeWithNext_(uint32_t index);
+
+  std::vector<Block> blocks_;
+  std::vector<uint32_t> unusedBlocks_;
+
+  uint64_t firstLevelBitmap_ = 0;
+  uint32_t secondLevelBitmap_[kFirstLevelCount]{};
+  uint32_t freeHeads_[kFirstLevelCount][kSecondLevelCount]{};
+
+  uint64_t totalSize_ = 0;
+  uint64_t usedBytes_ = 0;
+  uint32_t allocationCount_ = 0;
+};
@@ -1,45 +1,38 @@
 #include "Sprite.h"
+#include "DirectXCommon.h"
 #include "Renderer.h"
 #include "SpriteManager.h"
 #include "SpriteResource.h"
+#include "TextureManager.h"
 #include <cassert>
-#include <d3d12.h>
-#include <wrl/client.h>
-
-namespace {
-static constexpr UINT Align256_(UINT n) { return (n + 255u) & ~255u; }
-} // namespace
 
 // DirectX依存のメンバを隠蔽する構造体
+// - 定数バッファは持たない（描画ごとに Renderer がフレーム用アップロード領域から確保）
 struct Sprite::Impl {
-  Microsoft::WRL::ComPtr<ID3D12Resource> materialBuffer;
-  Microsoft::WRL::ComPtr<ID3D12Resource> transformBuffer;
-  MaterialCB *materialMapped = nullptr;
-  TransformCB *transformMapped = nullptr;
   std::shared_ptr<SpriteResource> resource;
 };
 
 Sprite::Sprite() : pImpl_(std::make_unique<Impl>()) {}
-Sprite::~Sprite() = default;
+Sprite::~Sprite() {
+  // 先行フレームが VB / IB を参照しているかもしれないので、Impl ごと解放を遅らせる
+  DirectXCommon *dx = Renderer::GetInstance()->GetDX();
+  if (dx && pImpl_) {
+    std::shared_ptr<Impl> impl(std::move(pImpl_));
+    dx->GetFramePacer().DeferRelease([impl]() mutable { impl.reset(); });
+  }
+}
 
 bool Sprite::Initialize(const CreateInfo &info) {
-  auto *renderer = Renderer::GetInstance();
-
   // 1. SpriteManager経由でリソースを取得
   pImpl_->resource = SpriteManager::GetInstance()->Load(info.texturePath);
   if (!pImpl_->resource)
     return false;
 
-  // 2. 定数バッファ作成 (Rendererに依頼)
-  pImpl_->materialBuffer =
-      renderer->CreateUploadBuffer(Align256_(sizeof(MaterialCB)));
-  pImpl_->materialBuffer->Map(
-      0, nullptr, reinterpret_cast<void **>(&pImpl_->materialMapped));
-
-  pImpl_->transformBuffer =
-      renderer->CreateUploadBuffer(Align256_(sizeof(TransformCB)));
-  pImpl_->transformBuffer->Map(
-      0, nullptr, reinterpret_cast<void **>(&pImpl_->transformMapped));
+  TextureAtlas::Region region;
+  atlasUvMatrix_ =
+      TextureManager::GetInstance()->FindAtlasRegion(info.texturePath, region)
+          ? TextureAtlas::MakeUVMatrix(region.uvRect)
+          : MakeIdentity4x4();
 
   // 初期値
   color_ = info.color;
@@ -49,31 +42,15 @@ bool Sprite::Initialize(const CreateInfo &info) {
 }
 
 void Sprite::Draw() {
-  if (!pImpl_->materialMapped || !pImpl_->transformMapped)
+  if (!pImpl_->resource)
     return;
 
-  // 行列の更新
+  // 行列の更新（定数バッファへの書き込みとWVPの合成はRendererで行う）
   worldMatrix_ = MakeAffineMatrix(scale_, rotation_, position_);
-
-  // 定数バッファの書き換え (Worldのみ。WVPはRendererで合成)
-  pImpl_->materialMapped->color = color_;
-  pImpl_->materialMapped->uvTransform = uvMatrix_;
-  pImpl_->transformMapped->World = worldMatrix_;
+  drawUvMatrix_ = Multiply(uvMatrix_, atlasUvMatrix_);
 
   // Rendererに自分自身の描画を依頼
   Renderer::GetInstance()->DrawSprite(this);
 }
 
-unsigned long long Sprite::GetMaterialCBAddress() const {
-  return pImpl_->materialBuffer->GetGPUVirtualAddress();
-}
-
-unsigned long long Sprite::GetTransformCBAddress() const {
-  return pImpl_->transformBuffer->GetGPUVirtualAddress();
-}
-
 SpriteResource *Sprite::GetResource() const { return pImpl_->resource.get(); }
-
-Sprite::TransformCB *Sprite::GetTransformMapped() {
-  return pImpl_->transformMapped;
-}
\ No newline at end of file
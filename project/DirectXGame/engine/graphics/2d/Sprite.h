@@ -17,7 +17,7 @@ public:
     Vector4 color = {1.0f, 1.0f, 1.0f, 1.0f};
   };
 
-  // インスタンス固有の定数バッファ構造体
+  // 定数バッファ構造体（Renderer が描画ごとにフレーム用アップロード領域へ書く）
   struct MaterialCB {
     Vector4 color;
     Matrix4x4 uvTransform;
@@ -36,6 +36,7 @@ public:
   void SetPosition(const Vector3 &pos) { position_ = pos; }
   void SetScale(const Vector3 &scale) { scale_ = scale; }
   void SetRotation(const Vector3 &rot) { rotation_ = rot; }
+  // アトラスに載っている画像では、画像全体を 0..1 とした UV（範囲の外は繰り返さない）
   void SetUVTransform(const Matrix4x4 &uv) { uvMatrix_ = uv; }
   void SetColor(const Vector4 &color) { color_ = color; }
   void SetBlendMode(BlendMode mode) { blendMode_ = mode; }
@@ -43,14 +44,12 @@ public:
   void Draw();
 
   // Renderer用アクセサ
-  unsigned long long GetMaterialCBAddress() const;
-  unsigned long long GetTransformCBAddress() const;
   SpriteResource *GetResource() const;
   BlendMode GetBlendMode() const { return blendMode_; }
   const Matrix4x4 &GetWorldMatrix() const { return worldMatrix_; }
-
-  // RendererがWVPを計算・転送するための内部アクセサ
-  TransformCB *GetTransformMapped();
+  const Vector4 &GetColor() const { return color_; }
+  // アトラスの範囲への変換を含む（Draw で更新）
+  const Matrix4x4 &GetUVTransform() const { return drawUvMatrix_; }
 
 private:
   struct Impl;
@@ -62,6 +61,8 @@ private:
   Vector3 rotation_ = {0, 0, 0};
   Vector4 color_ = {1, 1, 1, 1};
   Matrix4x4 uvMatrix_ = MakeIdentity4x4();
+  Matrix4x4 atlasUvMatrix_ = MakeIdentity4x4(); // 画像全体 → アトラスのページ内の範囲
+  Matrix4x4 drawUvMatrix_ = MakeIdentity4x4();
   Matrix4x4 worldMatrix_ = MakeIdentity4x4();
   BlendMode blendMode_ = BlendMode::Alpha;
 };
\ No newline at end of file
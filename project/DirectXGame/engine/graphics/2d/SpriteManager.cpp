@@ -1,17 +1,28 @@
 #include "SpriteManager.h"
 #include "SpriteResource.h"
+#include "TextureManager.h"
 
 std::shared_ptr<SpriteResource> SpriteManager::Load(const std::string &path) {
-  if (auto it = cache_.find(path); it != cache_.end()) {
-    if (auto alive = it->second.lock())
+  // アトラスに載っている画像はページごとに 1 つを共有する（VB とテクスチャが同じになり、
+  // 続けて描くスプライトの bind が省ける）
+  TextureAtlas::Region region;
+  const bool inAtlas =
+      TextureManager::GetInstance()->FindAtlasRegion(path, region);
+  const std::string key = inAtlas ? region.pageKey : path;
+
+  if (auto it = cache_.find(key); it != cache_.end()) {
+    // アトラスを作り直すと同じ pageKey が別のページを指すので、ページが同じ時だけ使う
+    auto alive = it->second.lock();
+    if (alive && (!inAtlas || alive->GetTexture() == region.page))
       return alive;
   }
 
   auto res = std::make_shared<SpriteResource>();
-  if (!res->Initialize(path))
+  if (inAtlas ? !res->Initialize(std::move(region.page))
+              : !res->Initialize(path))
     return nullptr;
 
-  cache_[path] = res;
+  cache_[key] = res;
   return res;
 }
 
@@ -12,6 +12,10 @@ public:
     return &inst;
   }
 
+  // TextureManager に登録したアトラスに載っている画像は、ページのリソースを返す
+  // （UV の範囲は Sprite が TextureManager::FindAtlasRegion で引く）
+  // 同じページのスプライトはテクスチャと VB が同じになり、RenderQueue が続く bind を省く
+  // （インスタンシングではないので、描画はスプライトごとに 1 回）
   std::shared_ptr<SpriteResource> Load(const std::string &path);
   void ClearUnused();
 
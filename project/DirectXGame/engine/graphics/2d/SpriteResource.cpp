@@ -16,9 +16,13 @@ SpriteResource::SpriteResource() : pImpl_(std::make_unique<Impl>()) {}
 SpriteResource::~SpriteResource() = default;
 
 bool SpriteResource::Initialize(const std::string &texturePath) {
+  return Initialize(TextureManager::GetInstance()->Load(texturePath));
+}
+
+bool SpriteResource::Initialize(std::shared_ptr<TextureResource> texture) {
   auto *renderer = Renderer::GetInstance();
 
-  pImpl_->texture = TextureManager::GetInstance()->Load(texturePath);
+  pImpl_->texture = std::move(texture);
   if (!pImpl_->texture)
     return false;
 
@@ -30,17 +34,10 @@ bool SpriteResource::Initialize(const std::string &texturePath) {
   };
   uint16_t indices[6] = {0, 1, 2, 2, 1, 3};
 
-  pImpl_->vertexBuffer = renderer->CreateUploadBuffer(sizeof(vertices));
-  void *vbData = nullptr;
-  pImpl_->vertexBuffer->Map(0, nullptr, &vbData);
-  std::memcpy(vbData, vertices, sizeof(vertices));
-  pImpl_->vertexBuffer->Unmap(0, nullptr);
-
-  pImpl_->indexBuffer = renderer->CreateUploadBuffer(sizeof(indices));
-  void *ibData = nullptr;
-  pImpl_->indexBuffer->Map(0, nullptr, &ibData);
-  std::memcpy(ibData, indices, sizeof(indices));
-  pImpl_->indexBuffer->Unmap(0, nullptr);
+  pImpl_->vertexBuffer = renderer->CreateStaticBuffer(vertices, sizeof(vertices));
+  pImpl_->indexBuffer = renderer->CreateStaticBuffer(indices, sizeof(indices));
+  if (!pImpl_->vertexBuffer || !pImpl_->indexBuffer)
+    return false;
 
   return true;
 }
@@ -17,6 +17,8 @@ public:
   ~SpriteResource(); // 実装は .cpp へ
 
   bool Initialize(const std::string &texturePath);
+  // 読み込み済みのテクスチャ（アトラスのページ等）を使う
+  bool Initialize(std::shared_ptr<TextureResource> texture);
 
   unsigned long long GetVBAddress() const;
   unsigned int GetVBSize() const;
@@ -1,7 +1,22 @@
 #include "AssetLoader.h"
+#include "GltfImporter.h"
+#include "MeshCache.h"
+#include "MeshMerger.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "ObjImporter.h"
+#include <Windows.h>
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <filesystem>
+#include <unordered_map>
+
+// これより少ない三角形のメッシュはメッシュレットに分けない（数個の塊にもならない）
+static constexpr size_t kMeshletMinTriangles_ = 512;
+// CookKey::options の bit（1, 2 は UV の反転）
+static constexpr uint32_t kCookOptionNativeImport_ = 4u;
 
 static std::string ToLower_(std::string s) {
   std::transform(s.begin(), s.end(), s.begin(),
@@ -16,25 +31,219 @@ static std::string GetExtLower_(const std::string &filename) {
   return ToLower_(filename.substr(pos + 1));
 }
 
+// 取り込んだ 1 メッシュを描画向けに整える（並べ替え・LOD・メッシュレット）
+// 戻り値は新しい頂点 → 元の頂点の対応（頂点ごとの追加データを同じ順にする用）
+static std::vector<uint32_t> OptimizeMesh_(std::vector<VertexData> vertices,
+                                           std::vector<uint32_t> indices,
+                                           MeshData &out) {
+  // 頂点キャッシュ → オーバードロー → 頂点フェッチの順に並べ替え、
+  // 三角形から参照されない頂点（点・線の面など）もここで落とす
+  MeshOptimizer::OptimizeVertexCache(indices, vertices.size());
+  if (!vertices.empty()) {
+    MeshOptimizer::OptimizeOverdraw(indices, &vertices[0].position.x,
+                                    sizeof(VertexData), vertices.size());
+  }
+  std::vector<uint32_t> remap =
+      MeshOptimizer::OptimizeVertexFetch(indices, vertices.size());
+  out.vertices = MeshOptimizer::RemapVertices(vertices, remap);
+  out.indices = std::move(indices);
+  // 遠景用の LOD（頂点は共有し、インデックスだけ段ごとに持つ）
+  out.lods = MeshSimplifier::BuildLodChain(out.indices, out.vertices);
+  // 大きなメッシュは塊に分け、見えない塊を描画前に落とせるようにする
+  // （LOD0 のインデックスは塊の順に並び替わる）
+  if (out.indices.size() / 3 >= kMeshletMinTriangles_) {
+    out.meshlets = MeshletBuilder::Build(out.indices, out.vertices);
+  }
+  return remap;
+}
+
+// ノード → ジョイント番号（同じノードのボーンは複数メッシュで共有する）
+using JointMap_ = std::unordered_map<uint32_t, uint16_t>;
+
+static uint16_t AddJoint_(uint32_t node, const Matrix4x4 &inverseBindMatrix,
+                          ModelData &out, JointMap_ &jointOfNode) {
+  auto it = jointOfNode.find(node);
+  if (it != jointOfNode.end()) {
+    return it->second;
+  }
+  assert(out.joints.size() < 0xFFFF);
+  const uint16_t joint = static_cast<uint16_t>(out.joints.size());
+  SkinJoint j{};
+  j.node = node;
+  j.inverseBindMatrix = inverseBindMatrix;
+  out.joints.push_back(j);
+  jointOfNode.emplace(node, joint);
+  return joint;
+}
+
+// 頂点ごとに重い順の 4 本を残し、合計 255 に正規化する
+static std::vector<VertexInfluence> ReadInfluences_(const aiMesh *mesh,
+                                                    ModelData &out,
+                                                    JointMap_ &jointOfNode) {
+  struct Candidates {
+    float weights[4] = {};
+    uint16_t joints[4] = {};
+  };
+  std::vector<Candidates> candidates(mesh->mNumVertices);
+  uint16_t fallbackJoint = 0;
+
+  for (uint32_t b = 0; b < mesh->mNumBones; ++b) {
+    const aiBone *bone = mesh->mBones[b];
+    const uint32_t node = out.nodes.FindNode(bone->mName.C_Str());
+    if (node == NodeHierarchy::kNone) {
+      continue;
+    }
+    // Assimp は列ベクトル規約なので転置する
+    const uint16_t joint = AddJoint_(
+        node, ConvertAssimpMatrixTransposed(bone->mOffsetMatrix), out,
+        jointOfNode);
+    if (b == 0) {
+      fallbackJoint = joint;
+    }
+
+    for (uint32_t w = 0; w < bone->mNumWeights; ++w) {
+      const aiVertexWeight &vw = bone->mWeights[w];
+      if (vw.mVertexId >= mesh->mNumVertices) {
+        continue;
+      }
+      Candidates &c = candidates[vw.mVertexId];
+      int lightest = 0;
+      for (int k = 1; k < 4; ++k) {
+        if (c.weights[k] < c.weights[lightest]) {
+          lightest = k;
+        }
+      }
+      if (vw.mWeight > c.weights[lightest]) {
+        c.weights[lightest] = vw.mWeight;
+        c.joints[lightest] = joint;
+      }
+    }
+  }
+
+  std::vector<VertexInfluence> influences(mesh->mNumVertices);
+  for (size_t v = 0; v < candidates.size(); ++v) {
+    const Candidates &c = candidates[v];
+    VertexInfluence &inf = influences[v];
+    const float sum = c.weights[0] + c.weights[1] + c.weights[2] + c.weights[3];
+    if (sum <= 0.0f) {
+      // 重みの無い頂点は最初のボーンに付ける
+      inf = {{fallbackJoint, 0, 0, 0}, {255, 0, 0, 0}};
+      continue;
+    }
+    int total = 0;
+    int heaviest = 0;
+    for (int k = 0; k < 4; ++k) {
+      inf.joints[k] = c.joints[k];
+      inf.weights[k] =
+          static_cast<uint8_t>(std::lround(c.weights[k] / sum * 255.0f));
+      total += inf.weights[k];
+      if (c.weights[k] > c.weights[heaviest]) {
+        heaviest = k;
+      }
+    }
+    // 丸めの余りは一番重いジョイントで吸収する
+    inf.weights[heaviest] =
+        static_cast<uint8_t>(inf.weights[heaviest] + (255 - total));
+  }
+  return influences;
+}
+
+static void ReadAnimations_(const aiScene *scene, ModelData &out) {
+  for (uint32_t a = 0; a < scene->mNumAnimations; ++a) {
+    const aiAnimation *anim = scene->mAnimations[a];
+    const double ticksPerSecond =
+        (anim->mTicksPerSecond > 0.0) ? anim->mTicksPerSecond : 25.0;
+
+    std::vector<RawAnimationTrack> tracks;
+    tracks.reserve(anim->mNumChannels);
+    for (uint32_t c = 0; c < anim->mNumChannels; ++c) {
+      const aiNodeAnim *channel = anim->mChannels[c];
+      const uint32_t node = out.nodes.FindNode(channel->mNodeName.C_Str());
+      if (node == NodeHierarchy::kNone) {
+        continue;
+      }
+
+      RawAnimationTrack track;
+      track.node = node;
+      for (uint32_t k = 0; k < channel->mNumPositionKeys; ++k) {
+        const aiVectorKey &key = channel->mPositionKeys[k];
+        track.translationTimes.push_back(
+            static_cast<float>(key.mTime / ticksPerSecond));
+        track.translations.push_back(
+            {key.mValue.x, key.mValue.y, key.mValue.z});
+      }
+      // aiQuaternion は w,x,y,z の順
+      for (uint32_t k = 0; k < channel->mNumRotationKeys; ++k) {
+        const aiQuatKey &key = channel->mRotationKeys[k];
+        track.rotationTimes.push_back(
+            static_cast<float>(key.mTime / ticksPerSecond));
+        track.rotations.push_back(
+            {key.mValue.x, key.mValue.y, key.mValue.z, key.mValue.w});
+      }
+      for (uint32_t k = 0; k < channel->mNumScalingKeys; ++k) {
+        const aiVectorKey &key = channel->mScalingKeys[k];
+        track.scaleTimes.push_back(
+            static_cast<float>(key.mTime / ticksPerSecond));
+        track.scales.push_back({key.mValue.x, key.mValue.y, key.mValue.z});
+      }
+      tracks.push_back(std::move(track));
+    }
+
+    out.animations.push_back(Animation::BuildAnimationClip(
+        anim->mName.C_Str(),
+        static_cast<float>(anim->mDuration / ticksPerSecond), tracks));
+  }
+}
+
 std::shared_ptr<const ModelData>
 AssetLoader::LoadModel(const std::string &directoryPath,
                        const std::string &filename) {
   const std::string key = MakeKey_(directoryPath, filename);
-  if (auto it = cache_.find(key); it != cache_.end()) {
-    return it->second;
+  auto acquired = cache_.Acquire(key);
+  if (!acquired.created) {
+    acquired.future.Wait();
+    return acquired.future.Get();
   }
 
-  Assimp::Importer importer;
+  auto modelData = std::make_shared<ModelData>();
+  bool saved = false;
+  if (!LoadOrCook_(directoryPath, filename, *modelData, false, saved)) {
+    cache_.Complete(key, acquired.future, nullptr);
+    return nullptr;
+  }
+
+  cache_.Complete(key, acquired.future, modelData,
+                  EstimateModelDataBytes(*modelData));
+  return modelData;
+}
+
+std::shared_ptr<const ModelData>
+AssetLoader::LoadModel(const std::string &path) {
+  std::filesystem::path p(path);
+  const std::string dir = p.parent_path().string();
+  const std::string file = p.filename().string();
+  return LoadModel(dir, file);
+}
+
+bool AssetLoader::CookModel(const std::string &path) {
+  std::filesystem::path p(path);
+  ModelData modelData;
+  bool saved = false;
+  return LoadOrCook_(p.parent_path().string(), p.filename().string(),
+                     modelData, true, saved) &&
+         saved;
+}
+
+bool AssetLoader::LoadOrCook_(const std::string &directoryPath,
+                              const std::string &filename, ModelData &out,
+                              bool forceCook, bool &saved) {
+  saved = false;
   const std::string filePath = directoryPath + "/" + filename;
 
   const unsigned flags = aiProcess_Triangulate | aiProcess_ConvertToLeftHanded |
                          aiProcess_GenSmoothNormals |
                          aiProcess_JoinIdenticalVertices;
 
-  const aiScene *scene = importer.ReadFile(filePath.c_str(), flags);
-  assert(scene);
-  assert(scene->mRootNode);
-
   const std::string ext = GetExtLower_(filename);
 
   UVFixupOptions uvOpt{};
@@ -49,10 +258,61 @@ AssetLoader::LoadModel(const std::string &directoryPath,
     uvOpt.flipU = false;
   }
 
-  auto modelData = std::make_shared<ModelData>();
+  // 元ファイル・依存ファイル（.mtl / 外部 .bin）と取り込み設定が同じならキャッシュから読む
+  MeshCache::CookKey cookKey{};
+  cookKey.importFlags = flags;
+  cookKey.options = (uvOpt.flipU ? 1u : 0u) | (uvOpt.flipV ? 2u : 0u);
+  // OBJ / glTF は専用の取り込みを使う（結果は Assimp と同じ形だが、念のため別のキャッシュにする）
+  const bool native = (ext == "obj" || ext == "gltf" || ext == "glb");
+  if (native) {
+    cookKey.options |= kCookOptionNativeImport_;
+  }
+  const std::string cachePath = MeshCache::MakeCachePath(filePath);
+  // 大きさ・更新時刻が保存時のままなら中身を読まずに使う
+  if (!forceCook && MeshCache::Load(cachePath, filePath, cookKey, out)) {
+    saved = true;
+    return true;
+  }
+  const bool hashed = MeshCache::HashSources(filePath, cookKey.sourceHash);
+  if (hashed && !forceCook &&
+      MeshCache::Load(cachePath, filePath, cookKey, out)) {
+    // 中身は同じで時刻だけ変わった（チェックアウトし直した等）。時刻を書き直しておく
+    saved = MeshCache::Save(cachePath, filePath, cookKey, out);
+    return true;
+  }
+
+  // 専用の取り込みで読めない書き方のファイルは Assimp に任せる
+  if (!native || !ImportNative_(ext, directoryPath, filePath, uvOpt, out)) {
+    if (!ImportWithAssimp_(directoryPath, filePath, flags, uvOpt, out)) {
+      return false;
+    }
+  }
+  // 同じマテリアルのメッシュは描画時に連結しなくて済むよう、ここでまとめて保存する
+  MeshMerger::MergeByMaterial(out);
+
+  // 書けなくても（読み取り専用の配置など）読み込み自体は成功させる
+  saved = hashed && MeshCache::Save(cachePath, filePath, cookKey, out);
+  return true;
+}
+
+bool AssetLoader::ImportWithAssimp_(const std::string &directoryPath,
+                                    const std::string &filePath,
+                                    unsigned flags,
+                                    const UVFixupOptions &uvOpt,
+                                    ModelData &out) {
+  Assimp::Importer importer;
+  const aiScene *scene = importer.ReadFile(filePath.c_str(), flags);
+  if (!scene || !scene->mRootNode) {
+    OutputDebugStringA(("[AssetLoader] import failed: " + filePath + ": " +
+                        importer.GetErrorString() + "\n")
+                           .c_str());
+    return false;
+  }
+
+  out = ModelData{};
 
   // Materials
-  modelData->materials.resize(scene->mNumMaterials);
+  out.materials.resize(scene->mNumMaterials);
   for (uint32_t i = 0; i < scene->mNumMaterials; ++i) {
     aiMaterial *mat = scene->mMaterials[i];
     MaterialData md{};
@@ -62,11 +322,15 @@ AssetLoader::LoadModel(const std::string &directoryPath,
       mat->GetTexture(aiTextureType_DIFFUSE, 0, &tex);
       md.textureFilePath = directoryPath + "/" + tex.C_Str();
     }
-    modelData->materials[i] = std::move(md);
+    out.materials[i] = std::move(md);
   }
 
+  // ボーン・アニメーションがノード名で引くので先に読む
+  ReadNodes_(scene->mRootNode, out.nodes);
+  JointMap_ jointOfNode;
+
   // Meshes
-  modelData->meshes.resize(scene->mNumMeshes);
+  out.meshes.resize(scene->mNumMeshes);
   for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex) {
     const aiMesh *mesh = scene->mMeshes[meshIndex];
     assert(mesh);
@@ -76,69 +340,133 @@ AssetLoader::LoadModel(const std::string &directoryPath,
                                  ? static_cast<int>(mesh->mMaterialIndex)
                                  : -1;
 
+    // JoinIdenticalVertices 済みの頂点をそのまま使い、面はインデックスで持つ
+    std::vector<VertexData> vertices(mesh->mNumVertices);
+    for (uint32_t vi = 0; vi < mesh->mNumVertices; ++vi) {
+      const aiVector3D &p = mesh->mVertices[vi];
+      const aiVector3D &n =
+          mesh->HasNormals() ? mesh->mNormals[vi] : aiVector3D(0, 1, 0);
+      const aiVector3D &uv = (mesh->HasTextureCoords(0))
+                                 ? mesh->mTextureCoords[0][vi]
+                                 : aiVector3D(0, 0, 0);
+
+      VertexData v{};
+      v.position = {p.x, p.y, p.z, 1.0f};
+      v.normal = {n.x, n.y, n.z};
+      v.texcoord = {uv.x, uv.y};
+
+      vertices[vi] = FixupVertex_AssimpToEngine(v, uvOpt);
+    }
+
+    std::vector<uint32_t> indices;
+    indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
     for (uint32_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex) {
       const aiFace &face = mesh->mFaces[faceIndex];
       if (face.mNumIndices != 3) {
         continue;
       }
+      indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+    }
 
-      VertexData tri[3]{};
-
-      for (uint32_t e = 0; e < 3; ++e) {
-        const uint32_t vi = face.mIndices[e];
-
-        const aiVector3D &p = mesh->mVertices[vi];
-        const aiVector3D &n =
-            mesh->HasNormals() ? mesh->mNormals[vi] : aiVector3D(0, 1, 0);
-        const aiVector3D &uv = (mesh->HasTextureCoords(0))
-                                   ? mesh->mTextureCoords[0][vi]
-                                   : aiVector3D(0, 0, 0);
+    const std::vector<uint32_t> remap =
+        OptimizeMesh_(std::move(vertices), std::move(indices), meshData);
+    if (mesh->HasBones()) {
+      meshData.influences = MeshOptimizer::RemapVertices(
+          ReadInfluences_(mesh, out, jointOfNode), remap);
+    }
 
-        VertexData v{};
-        v.position = {p.x, p.y, p.z, 1.0f};
-        v.normal = {n.x, n.y, n.z};
-        v.texcoord = {uv.x, uv.y};
+    out.meshes[meshIndex] = std::move(meshData);
+  }
 
-        tri[e] = FixupVertex_AssimpToEngine(v, uvOpt);
+  // スキンのあるモデルでは、ボーンの無いメッシュも置かれたノードに全重みで付ける
+  // （バインド時の GlobalMatrix の逆行列を掛けるので、バインドポーズでは元の位置）
+  if (!out.joints.empty()) {
+    for (uint32_t meshIndex = 0; meshIndex < out.meshes.size(); ++meshIndex) {
+      MeshData &mesh = out.meshes[meshIndex];
+      if (!mesh.influences.empty() || mesh.vertices.empty()) {
+        continue;
       }
-
-      meshData.vertices.push_back(tri[0]);
-      meshData.vertices.push_back(tri[1]);
-      meshData.vertices.push_back(tri[2]);
+      uint32_t owner = 0;
+      for (uint32_t n = 0; n < out.nodes.GetCount(); ++n) {
+        const auto meshes = out.nodes.GetMeshIndices(n);
+        if (std::find(meshes.begin(), meshes.end(), meshIndex) !=
+            meshes.end()) {
+          owner = n;
+          break;
+        }
+      }
+      const uint16_t joint =
+          AddJoint_(owner, Inverse(out.nodes.GetGlobalMatrix(owner)), out,
+                    jointOfNode);
+      mesh.influences.assign(mesh.vertices.size(),
+                             VertexInfluence{{joint, 0, 0, 0}, {255, 0, 0, 0}});
     }
-
-    modelData->meshes[meshIndex] = std::move(meshData);
   }
 
-  modelData->rootNode = ReadNode_(scene->mRootNode);
-
-  cache_[key] = modelData;
-  return modelData;
+  ReadAnimations_(scene, out);
+  out.bounds = MeshCache::ComputeBounds(out);
+  return true;
 }
 
-std::shared_ptr<const ModelData>
-AssetLoader::LoadModel(const std::string &path) {
-  std::filesystem::path p(path);
-  const std::string dir = p.parent_path().string();
-  const std::string file = p.filename().string();
-  return LoadModel(dir, file);
+bool AssetLoader::ImportNative_(const std::string &ext,
+                                const std::string &directoryPath,
+                                const std::string &filePath,
+                                const UVFixupOptions &uvOpt, ModelData &out) {
+  bool imported = false;
+  if (ext == "obj") {
+    imported = ObjImporter::Import(directoryPath, filePath, out);
+    if (imported) {
+      for (MeshData &mesh : out.meshes) {
+        for (VertexData &v : mesh.vertices) {
+          v = FixupVertex_AssimpToEngine(v, uvOpt);
+        }
+      }
+    }
+  } else if (ext == "gltf" || ext == "glb") {
+    // UV の反転は属性を読む時にまとめて行う
+    imported = GltfImporter::Import(directoryPath, filePath, uvOpt.flipU,
+                                    uvOpt.flipV, out);
+  }
+  if (!imported) {
+    return false;
+  }
+
+  for (MeshData &mesh : out.meshes) {
+    MeshData optimized;
+    optimized.materialIndex = mesh.materialIndex;
+    OptimizeMesh_(std::move(mesh.vertices), std::move(mesh.indices), optimized);
+    mesh = std::move(optimized);
+  }
+  out.bounds = MeshCache::ComputeBounds(out);
+  return true;
 }
 
-Node AssetLoader::ReadNode_(const aiNode *node) {
-  Node result{};
+void AssetLoader::ReadNodes_(const aiNode *root, NodeHierarchy &out) {
+  out.Clear();
+  if (!root) {
+    return;
+  }
 
-  result.localMatrix = ConvertAssimpMatrix(node->mTransformation);
-  result.name = node->mName.C_Str();
+  // 深い階層でもスタックを使い切らないように、再帰ではなく明示的なスタックでたどる
+  struct Pending {
+    const aiNode *node;
+    uint32_t parent;
+  };
+  std::vector<Pending> stack{{root, NodeHierarchy::kNone}};
+  while (!stack.empty()) {
+    const Pending p = stack.back();
+    stack.pop_back();
 
-  result.meshIndices.reserve(node->mNumMeshes);
-  for (uint32_t i = 0; i < node->mNumMeshes; ++i) {
-    result.meshIndices.push_back(node->mMeshes[i]);
-  }
+    // Assimp は列ベクトル規約なので、転置してエンジンの行ベクトル規約にする
+    const uint32_t index = out.AddNode(
+        p.parent, p.node->mName.C_Str(),
+        ConvertAssimpMatrixTransposed(p.node->mTransformation),
+        std::span<const uint32_t>(p.node->mMeshes, p.node->mNumMeshes));
 
-  result.children.reserve(node->mNumChildren);
-  for (uint32_t i = 0; i < node->mNumChildren; ++i) {
-    result.children.push_back(ReadNode_(node->mChildren[i]));
+    // 子は逆順に積み、元の並び順で取り出す
+    for (uint32_t i = p.node->mNumChildren; i > 0; --i) {
+      stack.push_back({p.node->mChildren[i - 1], index});
+    }
   }
-
-  return result;
+  out.UpdateGlobalMatrices();
 }
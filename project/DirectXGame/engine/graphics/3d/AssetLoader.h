@@ -1,8 +1,8 @@
 #pragma once
 #include <memory>
 #include <string>
-#include <unordered_map>
 
+#include "ConcurrentAssetCache.h"
 #include "ModelUtils.h"
 
 class AssetLoader {
@@ -12,22 +12,55 @@ public:
     return &inst;
   }
 
+  // スレッドセーフ。同じモデルを同時に要求しても取り込みは 1 回だけで、
+  // 後から来た側は先の取り込みの完了を待って同じ結果を受け取る
+  // 読めない・解釈できないファイルなら nullptr（次の要求でもう一度試す）
   std::shared_ptr<const ModelData> LoadModel(const std::string &directoryPath,
                                              const std::string &filename);
 
   // フルパス1本版
   std::shared_ptr<const ModelData> LoadModel(const std::string &path);
 
-  void Clear() { cache_.clear(); }
+  // 元ファイルから取り込み直してキャッシュ（MeshCache）を書き出す（事前の一括変換用）
+  // LoadModel も初回やキャッシュが古い時は同じ処理で書き出す
+  bool CookModel(const std::string &path);
+
+  void Clear() { cache_.Clear(); }
+
+  // 取り込み結果（CPU 側の頂点コピー）を持っておく上限。GPU へ転送済みのモデルは
+  // ここから消えても描画に影響しない（再取得時は MeshCache から読み直す）
+  void SetCacheBudget(uint64_t bytes) { cache_.SetBudget(bytes); }
+  static constexpr uint64_t kDefaultCacheBudget = 64ull << 20;
+
+  ConcurrentAssetCache<ModelData>::Stats GetCacheStats() const {
+    return cache_.GetStats();
+  }
 
 private:
-  AssetLoader() = default;
+  AssetLoader() { cache_.SetBudget(kDefaultCacheBudget); }
 
   std::string MakeKey_(const std::string &dir, const std::string &file) const {
     return dir + "/" + file;
   }
 
-  Node ReadNode_(const aiNode *node);
+  // キャッシュが使えればそれを読み、無ければ取り込んで書き出す
+  // 取り込めなければ false。saved はキャッシュが最新になっているか
+  // （書き出しに失敗しても戻り値が true なら out は有効）
+  bool LoadOrCook_(const std::string &directoryPath,
+                   const std::string &filename, ModelData &out, bool forceCook,
+                   bool &saved);
+  // Assimp が読めなければ false（out は未定義）
+  bool ImportWithAssimp_(const std::string &directoryPath,
+                         const std::string &filePath, unsigned flags,
+                         const UVFixupOptions &uvOpt, ModelData &out);
+  // ObjImporter / GltfImporter で読み、Assimp 経由と同じ後処理をする
+  // 対象外の拡張子・専用の取り込みで扱えないファイルなら false
+  bool ImportNative_(const std::string &ext, const std::string &directoryPath,
+                     const std::string &filePath, const UVFixupOptions &uvOpt,
+                     ModelData &out);
+  // aiNode の木を行きがけ順に NodeHierarchy へ詰める
+  void ReadNodes_(const aiNode *root, NodeHierarchy &out);
 
-  std::unordered_map<std::string, std::shared_ptr<ModelData>> cache_;
+  ConcurrentAssetCache<ModelData> cache_{
+      ConcurrentAssetCache<ModelData>::Ownership::Strong};
 };
@@ -0,0 +1,182 @@
+#include "AnimationClip.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+float Distance(const Vector3 &a, const Vector3 &b) {
+  const float dx = a.x - b.x;
+  const float dy = a.y - b.y;
+  const float dz = a.z - b.z;
+  return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+Vector3 Lerp(const Vector3 &a, const Vector3 &b, float t) {
+  return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+          a.z + (b.z - a.z) * t};
+}
+
+// 2 つの回転の間の角度
+float AngleBetween(const Vector4 &a, const Vector4 &b) {
+  const float d =
+      std::fabs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+  return 2.0f * std::acos(std::min(d, 1.0f));
+}
+
+int16_t ToSnorm16(float v) {
+  const float c = std::clamp(v, -1.0f, 1.0f);
+  return static_cast<int16_t>(std::lround(c * 32767.0f));
+}
+
+// 前後のキーから補間して許容誤差に収まるキーを落とす（先頭と末尾は残す）
+// 区間を先頭から伸ばしていき、間のキーのどれかが収まらなくなったら 1 つ手前で切る
+template <class T, class LerpFn, class ErrorFn>
+std::vector<size_t> ReduceKeys(const std::vector<float> &times,
+                               const std::vector<T> &values, float tolerance,
+                               LerpFn lerp, ErrorFn error) {
+  const size_t n = std::min(times.size(), values.size());
+  std::vector<size_t> kept;
+  if (n == 0) {
+    return kept;
+  }
+
+  // 全キーが先頭と同じなら定数にする
+  bool constant = true;
+  for (size_t i = 1; i < n && constant; ++i) {
+    constant = error(values[0], values[i]) <= tolerance;
+  }
+  kept.push_back(0);
+  if (constant) {
+    return kept;
+  }
+
+  auto fits = [&](size_t start, size_t end) {
+    const float span = times[end] - times[start];
+    for (size_t k = start + 1; k < end; ++k) {
+      const float t = (span > 0.0f) ? (times[k] - times[start]) / span : 0.0f;
+      if (error(lerp(values[start], values[end], t), values[k]) > tolerance) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  size_t start = 0;
+  for (size_t end = 2; end < n; ++end) {
+    if (!fits(start, end)) {
+      start = end - 1;
+      kept.push_back(start);
+    }
+  }
+  kept.push_back(n - 1);
+  return kept;
+}
+
+void AppendVectorChannel(const std::vector<float> &times,
+                         const std::vector<Vector3> &values, float tolerance,
+                         std::vector<float> &outTimes,
+                         std::vector<Vector3> &outKeys,
+                         AnimationKeyRange &range) {
+  const std::vector<size_t> kept = ReduceKeys(times, values, tolerance, Lerp,
+                                              Distance);
+  range.first = static_cast<uint32_t>(outKeys.size());
+  range.count = static_cast<uint32_t>(kept.size());
+  for (size_t i : kept) {
+    outTimes.push_back(times[i]);
+    outKeys.push_back(values[i]);
+  }
+}
+
+} // namespace
+
+namespace Animation {
+
+Vector4 NormalizeQuaternion(const Vector4 &q) {
+  const float len = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+  const float inv = (len > 0.0f) ? 1.0f / len : 0.0f;
+  return {q.x * inv, q.y * inv, q.z * inv, q.w * inv};
+}
+
+PackedQuaternion PackQuaternion(const Vector4 &q) {
+  // w >= 0 にそろえる（q と -q は同じ回転）
+  const float s = (q.w < 0.0f) ? -1.0f : 1.0f;
+  return {ToSnorm16(q.x * s), ToSnorm16(q.y * s), ToSnorm16(q.z * s),
+          ToSnorm16(q.w * s)};
+}
+
+Vector4 UnpackQuaternion(const PackedQuaternion &q) {
+  constexpr float kScale = 1.0f / 32767.0f;
+  return NormalizeQuaternion(
+      {q.x * kScale, q.y * kScale, q.z * kScale, q.w * kScale});
+}
+
+Vector4 Nlerp(const Vector4 &a, const Vector4 &b, float t) {
+  const float d = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+  const float tb = (d < 0.0f) ? -t : t;
+  const float ta = 1.0f - t;
+  return NormalizeQuaternion({a.x * ta + b.x * tb, a.y * ta + b.y * tb,
+                              a.z * ta + b.z * tb, a.w * ta + b.w * tb});
+}
+
+AnimationClip BuildAnimationClip(std::string name, float duration,
+                                 const std::vector<RawAnimationTrack> &tracks,
+                                 const AnimationCompressionSettings &settings) {
+  AnimationClip clip;
+  clip.name = std::move(name);
+  clip.duration = duration;
+  clip.tracks.reserve(tracks.size());
+
+  for (const RawAnimationTrack &raw : tracks) {
+    AnimationTrack track{};
+    track.node = raw.node;
+
+    AppendVectorChannel(raw.translationTimes, raw.translations,
+                        settings.translationTolerance, clip.translationTimes,
+                        clip.translationKeys, track.translation);
+    AppendVectorChannel(raw.scaleTimes, raw.scales, settings.scaleTolerance,
+                        clip.scaleTimes, clip.scaleKeys, track.scale);
+
+    // 回転は間引きを量子化前の値で判定し、残ったキーだけ量子化する
+    std::vector<Vector4> rotations(raw.rotations.size());
+    for (size_t i = 0; i < rotations.size(); ++i) {
+      rotations[i] = NormalizeQuaternion(raw.rotations[i]);
+    }
+    const std::vector<size_t> kept = ReduceKeys(
+        raw.rotationTimes, rotations, settings.rotationTolerance, Nlerp,
+        AngleBetween);
+    track.rotation.first = static_cast<uint32_t>(clip.rotationKeys.size());
+    track.rotation.count = static_cast<uint32_t>(kept.size());
+    for (size_t i : kept) {
+      clip.rotationTimes.push_back(raw.rotationTimes[i]);
+      clip.rotationKeys.push_back(PackQuaternion(rotations[i]));
+    }
+
+    if (track.translation.count + track.rotation.count + track.scale.count >
+        0) {
+      clip.tracks.push_back(track);
+    }
+  }
+
+  // キーの数は取り込み時にしか変わらないので余りを返しておく
+  clip.tracks.shrink_to_fit();
+  clip.translationTimes.shrink_to_fit();
+  clip.translationKeys.shrink_to_fit();
+  clip.rotationTimes.shrink_to_fit();
+  clip.rotationKeys.shrink_to_fit();
+  clip.scaleTimes.shrink_to_fit();
+  clip.scaleKeys.shrink_to_fit();
+  return clip;
+}
+
+size_t EstimateClipBytes(const AnimationClip &clip) {
+  return clip.name.capacity() +
+         clip.tracks.capacity() * sizeof(AnimationTrack) +
+         (clip.translationTimes.capacity() + clip.rotationTimes.capacity() +
+          clip.scaleTimes.capacity()) *
+             sizeof(float) +
+         (clip.translationKeys.capacity() + clip.scaleKeys.capacity()) *
+             sizeof(Vector3) +
+         clip.rotationKeys.capacity() * sizeof(PackedQuaternion);
+}
+
+} // namespace Animation
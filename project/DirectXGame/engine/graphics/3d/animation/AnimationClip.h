@@ -0,0 +1,83 @@
+#pragma once
+#include "Vector.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 回転キー（クォータニオン x,y,z,w を SNORM16 で持つ。16 → 8 バイト）
+struct PackedQuaternion {
+  int16_t x;
+  int16_t y;
+  int16_t z;
+  int16_t w;
+};
+static_assert(sizeof(PackedQuaternion) == 8);
+
+// 下の配列の中の 1 チャンネルぶんの範囲（count == 1 なら定数）
+struct AnimationKeyRange {
+  uint32_t first = 0;
+  uint32_t count = 0;
+};
+
+// 1 ノードぶんのトラック（キーが無いチャンネルは count == 0 でバインドポーズのまま）
+struct AnimationTrack {
+  uint32_t node = 0; // NodeHierarchy の番号
+  AnimationKeyRange translation;
+  AnimationKeyRange rotation;
+  AnimationKeyRange scale;
+};
+
+// キーフレームアニメーション 1 本
+// - キーはチャンネル種別ごとに全トラックぶんを 1 本の配列に詰める（時刻と値は別配列）
+// - 補間で復元できるキーは BuildAnimationClip で間引き済み
+// - 時刻は秒。各範囲の中で昇順
+struct AnimationClip {
+  std::string name;
+  float duration = 0.0f; // 秒
+  std::vector<AnimationTrack> tracks;
+
+  std::vector<float> translationTimes;
+  std::vector<Vector3> translationKeys;
+  std::vector<float> rotationTimes;
+  std::vector<PackedQuaternion> rotationKeys;
+  std::vector<float> scaleTimes;
+  std::vector<Vector3> scaleKeys;
+};
+
+// 間引き前のトラック（取り込み時に使う。回転は x,y,z,w のクォータニオン）
+struct RawAnimationTrack {
+  uint32_t node = 0;
+  std::vector<float> translationTimes;
+  std::vector<Vector3> translations;
+  std::vector<float> rotationTimes;
+  std::vector<Vector4> rotations;
+  std::vector<float> scaleTimes;
+  std::vector<Vector3> scales;
+};
+
+// キーの間引きで許す誤差（前後のキーから補間した値と元の値の差）
+struct AnimationCompressionSettings {
+  float translationTolerance = 1.0e-4f; // 距離
+  float rotationTolerance = 1.0e-3f;    // ラジアン
+  float scaleTolerance = 1.0e-4f;
+};
+
+namespace Animation {
+
+PackedQuaternion PackQuaternion(const Vector4 &q);
+Vector4 UnpackQuaternion(const PackedQuaternion &q);
+
+Vector4 NormalizeQuaternion(const Vector4 &q);
+// 正規化した線形補間（w の符号をそろえて短い側を通る）
+Vector4 Nlerp(const Vector4 &a, const Vector4 &b, float t);
+
+// tracks のキーを間引き・量子化して 1 本のクリップにまとめる
+AnimationClip BuildAnimationClip(std::string name, float duration,
+                                 const std::vector<RawAnimationTrack> &tracks,
+                                 const AnimationCompressionSettings &settings =
+                                     {});
+
+// キー配列のおおよそのバイト数
+size_t EstimateClipBytes(const AnimationClip &clip);
+
+} // namespace Animation
@@ -0,0 +1,232 @@
+#include "AnimationSampler.h"
+#include "Method.h"
+#include "ModelData.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+Vector3 Lerp(const Vector3 &a, const Vector3 &b, float t) {
+  return {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+          a.z + (b.z - a.z) * t};
+}
+
+// times[k] <= t < times[k + 1] となる k（範囲外は端の区間）。count >= 2
+uint32_t FindSegment(const float *times, uint32_t count, float t,
+                     uint32_t *hint) {
+  if (hint) {
+    const uint32_t k = *hint;
+    if (k + 1 < count && times[k] <= t) {
+      if (t < times[k + 1]) {
+        return k;
+      }
+      if (k + 2 < count && t < times[k + 2]) {
+        *hint = k + 1;
+        return k + 1;
+      }
+    }
+  }
+  // 先頭と末尾を除いた中から t を超える最初のキーを探す
+  const float *it = std::upper_bound(times + 1, times + count - 1, t);
+  const uint32_t k = static_cast<uint32_t>(it - times) - 1;
+  if (hint) {
+    *hint = k;
+  }
+  return k;
+}
+
+float SegmentFraction(const float *times, uint32_t k, float t) {
+  const float span = times[k + 1] - times[k];
+  if (span <= 0.0f) {
+    return 0.0f;
+  }
+  return std::clamp((t - times[k]) / span, 0.0f, 1.0f);
+}
+
+Vector3 SampleVector(const std::vector<float> &times,
+                     const std::vector<Vector3> &keys,
+                     const AnimationKeyRange &range, float t, uint32_t *hint) {
+  const Vector3 *k = keys.data() + range.first;
+  if (range.count == 1) {
+    return k[0];
+  }
+  const float *tk = times.data() + range.first;
+  const uint32_t s = FindSegment(tk, range.count, t, hint);
+  return Lerp(k[s], k[s + 1], SegmentFraction(tk, s, t));
+}
+
+Vector4 SampleRotation(const AnimationClip &clip,
+                       const AnimationKeyRange &range, float t,
+                       uint32_t *hint) {
+  const PackedQuaternion *k = clip.rotationKeys.data() + range.first;
+  if (range.count == 1) {
+    return Animation::UnpackQuaternion(k[0]);
+  }
+  const float *tk = clip.rotationTimes.data() + range.first;
+  const uint32_t s = FindSegment(tk, range.count, t, hint);
+  return Animation::Nlerp(Animation::UnpackQuaternion(k[s]),
+                          Animation::UnpackQuaternion(k[s + 1]),
+                          SegmentFraction(tk, s, t));
+}
+
+// 行ベクトル規約の回転行列（正規直交）→ クォータニオン
+Vector4 QuaternionFromRotation(const float r[3][3]) {
+  const float trace = r[0][0] + r[1][1] + r[2][2];
+  Vector4 q{};
+  if (trace > 0.0f) {
+    const float s = std::sqrt(trace + 1.0f) * 2.0f;
+    q.w = 0.25f * s;
+    q.x = (r[1][2] - r[2][1]) / s;
+    q.y = (r[2][0] - r[0][2]) / s;
+    q.z = (r[0][1] - r[1][0]) / s;
+  } else if (r[0][0] > r[1][1] && r[0][0] > r[2][2]) {
+    const float s = std::sqrt(1.0f + r[0][0] - r[1][1] - r[2][2]) * 2.0f;
+    q.w = (r[1][2] - r[2][1]) / s;
+    q.x = 0.25f * s;
+    q.y = (r[0][1] + r[1][0]) / s;
+    q.z = (r[0][2] + r[2][0]) / s;
+  } else if (r[1][1] > r[2][2]) {
+    const float s = std::sqrt(1.0f + r[1][1] - r[0][0] - r[2][2]) * 2.0f;
+    q.w = (r[2][0] - r[0][2]) / s;
+    q.x = (r[0][1] + r[1][0]) / s;
+    q.y = 0.25f * s;
+    q.z = (r[1][2] + r[2][1]) / s;
+  } else {
+    const float s = std::sqrt(1.0f + r[2][2] - r[0][0] - r[1][1]) * 2.0f;
+    q.w = (r[0][1] - r[1][0]) / s;
+    q.x = (r[0][2] + r[2][0]) / s;
+    q.y = (r[1][2] + r[2][1]) / s;
+    q.z = 0.25f * s;
+  }
+  return Animation::NormalizeQuaternion(q);
+}
+
+} // namespace
+
+namespace Animation {
+
+void MakeBindPose(const NodeHierarchy &nodes, AnimationPose &out) {
+  const uint32_t count = nodes.GetCount();
+  out.translations.resize(count);
+  out.rotations.resize(count);
+  out.scales.resize(count);
+
+  for (uint32_t i = 0; i < count; ++i) {
+    const Matrix4x4 &m = nodes.GetLocalMatrix(i);
+    out.translations[i] = {m.m[3][0], m.m[3][1], m.m[3][2]};
+
+    float scale[3];
+    float r[3][3];
+    for (int row = 0; row < 3; ++row) {
+      scale[row] = std::sqrt(m.m[row][0] * m.m[row][0] +
+                             m.m[row][1] * m.m[row][1] +
+                             m.m[row][2] * m.m[row][2]);
+      const float inv = (scale[row] > 0.0f) ? 1.0f / scale[row] : 0.0f;
+      for (int col = 0; col < 3; ++col) {
+        r[row][col] = m.m[row][col] * inv;
+      }
+    }
+    // 鏡像（行列式が負）は X の拡縮を負にして回転を正規直交に戻す
+    const float det = r[0][0] * (r[1][1] * r[2][2] - r[1][2] * r[2][1]) -
+                      r[0][1] * (r[1][0] * r[2][2] - r[1][2] * r[2][0]) +
+                      r[0][2] * (r[1][0] * r[2][1] - r[1][1] * r[2][0]);
+    if (det < 0.0f) {
+      scale[0] = -scale[0];
+      for (int col = 0; col < 3; ++col) {
+        r[0][col] = -r[0][col];
+      }
+    }
+    out.scales[i] = {scale[0], scale[1], scale[2]};
+    out.rotations[i] = QuaternionFromRotation(r);
+  }
+}
+
+void SampleClip(const AnimationClip &clip, float time, AnimationPose &pose,
+                AnimationCursor *cursor) {
+  if (cursor && cursor->keys.size() != clip.tracks.size() * 3) {
+    cursor->keys.assign(clip.tracks.size() * 3, 0);
+  }
+
+  for (size_t i = 0; i < clip.tracks.size(); ++i) {
+    const AnimationTrack &track = clip.tracks[i];
+    assert(track.node < pose.translations.size());
+    uint32_t *hints = cursor ? &cursor->keys[i * 3] : nullptr;
+
+    if (track.translation.count > 0) {
+      pose.translations[track.node] =
+          SampleVector(clip.translationTimes, clip.translationKeys,
+                       track.translation, time, hints ? hints + 0 : nullptr);
+    }
+    if (track.rotation.count > 0) {
+      pose.rotations[track.node] = SampleRotation(
+          clip, track.rotation, time, hints ? hints + 1 : nullptr);
+    }
+    if (track.scale.count > 0) {
+      pose.scales[track.node] =
+          SampleVector(clip.scaleTimes, clip.scaleKeys, track.scale, time,
+                       hints ? hints + 2 : nullptr);
+    }
+  }
+}
+
+void BlendPoses(const AnimationPose &a, const AnimationPose &b, float weight,
+                AnimationPose &out) {
+  const size_t count = a.translations.size();
+  assert(b.translations.size() == count);
+  out.translations.resize(count);
+  out.rotations.resize(count);
+  out.scales.resize(count);
+
+  for (size_t i = 0; i < count; ++i) {
+    out.translations[i] = Lerp(a.translations[i], b.translations[i], weight);
+    out.rotations[i] = Nlerp(a.rotations[i], b.rotations[i], weight);
+    out.scales[i] = Lerp(a.scales[i], b.scales[i], weight);
+  }
+}
+
+Matrix4x4 MakeTransformMatrix(const Vector3 &scale, const Vector4 &rotation,
+                              const Vector3 &translation) {
+  const float x = rotation.x;
+  const float y = rotation.y;
+  const float z = rotation.z;
+  const float w = rotation.w;
+
+  Matrix4x4 m{};
+  m.m[0][0] = (1.0f - 2.0f * (y * y + z * z)) * scale.x;
+  m.m[0][1] = 2.0f * (x * y + w * z) * scale.x;
+  m.m[0][2] = 2.0f * (x * z - w * y) * scale.x;
+  m.m[1][0] = 2.0f * (x * y - w * z) * scale.y;
+  m.m[1][1] = (1.0f - 2.0f * (x * x + z * z)) * scale.y;
+  m.m[1][2] = 2.0f * (y * z + w * x) * scale.y;
+  m.m[2][0] = 2.0f * (x * z + w * y) * scale.z;
+  m.m[2][1] = 2.0f * (y * z - w * x) * scale.z;
+  m.m[2][2] = (1.0f - 2.0f * (x * x + y * y)) * scale.z;
+  m.m[3][0] = translation.x;
+  m.m[3][1] = translation.y;
+  m.m[3][2] = translation.z;
+  m.m[3][3] = 1.0f;
+  return m;
+}
+
+void ApplyPose(const AnimationPose &pose, NodeHierarchy &nodes) {
+  const uint32_t count = nodes.GetCount();
+  assert(pose.translations.size() == count);
+  for (uint32_t i = 0; i < count; ++i) {
+    nodes.SetLocalMatrix(i, MakeTransformMatrix(pose.scales[i],
+                                                pose.rotations[i],
+                                                pose.translations[i]));
+  }
+}
+
+void ComputeSkinMatrices(const NodeHierarchy &nodes,
+                         const std::vector<SkinJoint> &joints,
+                         std::vector<Matrix4x4> &out) {
+  out.resize(joints.size());
+  for (size_t j = 0; j < joints.size(); ++j) {
+    out[j] = Multiply(joints[j].inverseBindMatrix,
+                      nodes.GetGlobalMatrix(joints[j].node));
+  }
+}
+
+} // namespace Animation
@@ -0,0 +1,49 @@
+#pragma once
+#include "AnimationClip.h"
+#include "Matrix.h"
+#include "NodeHierarchy.h"
+#include <cstdint>
+#include <vector>
+
+struct SkinJoint;
+
+// ノードごとのローカル姿勢（NodeHierarchy と同じ番号・同じ数）
+struct AnimationPose {
+  std::vector<Vector3> translations;
+  std::vector<Vector4> rotations; // クォータニオン x,y,z,w
+  std::vector<Vector3> scales;
+};
+
+// 前回使ったキーの位置（トラック × 3 チャンネル）
+// 再生は時刻が少しずつ進むので、次のキーは前回の位置かその次にあることが多い
+struct AnimationCursor {
+  std::vector<uint32_t> keys;
+};
+
+namespace Animation {
+
+// ローカル行列を移動・回転・拡縮に分解する（せん断は無い前提）
+void MakeBindPose(const NodeHierarchy &nodes, AnimationPose &out);
+
+// pose のうち clip がキーを持つチャンネルだけを time（秒）の値で上書きする
+// cursor を渡すとキーの探索を前回の位置から始める（無ければ二分探索）
+void SampleClip(const AnimationClip &clip, float time, AnimationPose &pose,
+                AnimationCursor *cursor = nullptr);
+
+// out = a と b を weight（0 = a, 1 = b）で混ぜた姿勢。out は a / b と同じでもよい
+void BlendPoses(const AnimationPose &a, const AnimationPose &b, float weight,
+                AnimationPose &out);
+
+// 行ベクトル規約の S * R * T
+Matrix4x4 MakeTransformMatrix(const Vector3 &scale, const Vector4 &rotation,
+                              const Vector3 &translation);
+
+// 姿勢をローカル行列に書き込む（GlobalMatrix は UpdateGlobalMatrices で更新）
+void ApplyPose(const AnimationPose &pose, NodeHierarchy &nodes);
+
+// ジョイントごとの InverseBind * Global（スキニング行列）
+void ComputeSkinMatrices(const NodeHierarchy &nodes,
+                         const std::vector<SkinJoint> &joints,
+                         std::vector<Matrix4x4> &out);
+
+} // namespace Animation
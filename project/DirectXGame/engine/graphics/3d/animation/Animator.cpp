@@ -0,0 +1,132 @@
+#include "Animator.h"
+#include "ModelData.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+void Animator::Initialize(std::shared_ptr<const ModelData> model) {
+  assert(model);
+  model_ = std::move(model);
+  nodes_ = model_->nodes;
+  Animation::MakeBindPose(nodes_, bindPose_);
+  pose_ = bindPose_;
+  current_ = Layer{};
+  previous_ = Layer{};
+  fadeFromSnapshot_ = false;
+  fadeTime_ = 0.0f;
+  fadeDuration_ = 0.0f;
+
+  nodes_.UpdateGlobalMatrices();
+  Animation::ComputeSkinMatrices(nodes_, model_->joints, skinMatrices_);
+}
+
+uint32_t Animator::GetClipCount() const {
+  return model_ ? static_cast<uint32_t>(model_->animations.size()) : 0;
+}
+
+uint32_t Animator::FindClip(std::string_view name) const {
+  for (uint32_t i = 0; i < GetClipCount(); ++i) {
+    if (model_->animations[i].name == name) {
+      return i;
+    }
+  }
+  return kNoClip;
+}
+
+void Animator::Play(uint32_t clip, bool loop) {
+  assert(clip == kNoClip || clip < GetClipCount());
+  current_ = Layer{};
+  current_.clip = clip;
+  current_.loop = loop;
+  previous_ = Layer{};
+  fadeFromSnapshot_ = false;
+  fadeDuration_ = 0.0f;
+}
+
+void Animator::CrossFade(uint32_t clip, float fadeSeconds, bool loop) {
+  if (fadeSeconds <= 0.0f || current_.clip == kNoClip) {
+    Play(clip, loop);
+    return;
+  }
+  assert(clip == kNoClip || clip < GetClipCount());
+  if (fadeDuration_ > 0.0f) {
+    // 切り替え元を今のクリップに差し替えると姿勢が飛ぶので、
+    // 前回の Update で混ぜた姿勢をそのまま切り替え元にする
+    fadePose_ = pose_;
+    previous_ = Layer{};
+    fadeFromSnapshot_ = true;
+  } else {
+    previous_ = std::move(current_);
+    fadeFromSnapshot_ = false;
+  }
+  current_ = Layer{};
+  current_.clip = clip;
+  current_.loop = loop;
+  fadeTime_ = 0.0f;
+  fadeDuration_ = fadeSeconds;
+}
+
+bool Animator::IsFinished() const {
+  if (current_.clip == kNoClip || current_.loop) {
+    return false;
+  }
+  return current_.time >= model_->animations[current_.clip].duration;
+}
+
+void Animator::Advance_(Layer &layer, float deltaSeconds) const {
+  if (layer.clip == kNoClip) {
+    return;
+  }
+  const float duration = model_->animations[layer.clip].duration;
+  layer.time += deltaSeconds * speed_;
+  if (layer.loop && duration > 0.0f) {
+    // 巻き戻ったときはカーソルが外れるので、次の探索は二分探索になる
+    layer.time = std::fmod(layer.time, duration);
+    if (layer.time < 0.0f) {
+      layer.time += duration;
+    }
+  } else {
+    layer.time = std::clamp(layer.time, 0.0f, duration);
+  }
+}
+
+void Animator::Sample_(Layer &layer, AnimationPose &pose) const {
+  // キーの無いチャンネルはバインドポーズのまま
+  pose.translations.assign(bindPose_.translations.begin(),
+                           bindPose_.translations.end());
+  pose.rotations.assign(bindPose_.rotations.begin(),
+                        bindPose_.rotations.end());
+  pose.scales.assign(bindPose_.scales.begin(), bindPose_.scales.end());
+  if (layer.clip != kNoClip) {
+    Animation::SampleClip(model_->animations[layer.clip], layer.time, pose,
+                          &layer.cursor);
+  }
+}
+
+void Animator::Update(float deltaSeconds) {
+  if (!model_) {
+    return;
+  }
+
+  Advance_(current_, deltaSeconds);
+  Sample_(current_, pose_);
+
+  if (fadeDuration_ > 0.0f) {
+    if (!fadeFromSnapshot_) {
+      Advance_(previous_, deltaSeconds);
+      Sample_(previous_, fadePose_);
+    }
+    fadeTime_ += deltaSeconds;
+    const float weight = std::min(fadeTime_ / fadeDuration_, 1.0f);
+    Animation::BlendPoses(fadePose_, pose_, weight, pose_);
+    if (weight >= 1.0f) {
+      previous_ = Layer{};
+      fadeFromSnapshot_ = false;
+      fadeDuration_ = 0.0f;
+    }
+  }
+
+  Animation::ApplyPose(pose_, nodes_);
+  nodes_.UpdateGlobalMatrices();
+  Animation::ComputeSkinMatrices(nodes_, model_->joints, skinMatrices_);
+}
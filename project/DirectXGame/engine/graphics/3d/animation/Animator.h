@@ -0,0 +1,69 @@
+#pragma once
+#include "AnimationSampler.h"
+#include <memory>
+#include <string_view>
+#include <vector>
+
+struct ModelData;
+
+// 1 体ぶんのアニメーション再生（クリップの再生・切り替え → スキニング行列）
+// 使い方:
+//   animator.Initialize(AssetLoader::GetInstance()->LoadModel(path));
+//   animator.Play(animator.FindClip("Walk"));
+//   毎フレーム animator.Update(dt); instance->SetSkinMatrices(animator.GetSkinMatrices());
+class Animator {
+public:
+  static constexpr uint32_t kNoClip = 0xFFFFFFFFu;
+
+  void Initialize(std::shared_ptr<const ModelData> model);
+
+  uint32_t GetClipCount() const;
+  // 見つからなければ kNoClip
+  uint32_t FindClip(std::string_view name) const;
+
+  // すぐに切り替える
+  void Play(uint32_t clip, bool loop = true);
+  // 今の姿勢から fadeSeconds かけて clip へ混ぜながら切り替える
+  // 切り替え中に呼んだ場合は、その時点の混ざった姿勢を止めて切り替え元にする
+  void CrossFade(uint32_t clip, float fadeSeconds, bool loop = true);
+
+  void SetSpeed(float speed) { speed_ = speed; }
+  float GetTime() const { return current_.time; }
+  // ループしないクリップが最後まで進んだか
+  bool IsFinished() const;
+
+  // 時刻を進めて姿勢・GlobalMatrix・スキニング行列を更新する
+  void Update(float deltaSeconds);
+
+  const NodeHierarchy &GetNodes() const { return nodes_; }
+  // ModelData::joints と同じ並び
+  const std::vector<Matrix4x4> &GetSkinMatrices() const {
+    return skinMatrices_;
+  }
+
+private:
+  struct Layer {
+    uint32_t clip = kNoClip;
+    float time = 0.0f;
+    bool loop = true;
+    AnimationCursor cursor;
+  };
+
+  void Advance_(Layer &layer, float deltaSeconds) const;
+  void Sample_(Layer &layer, AnimationPose &pose) const;
+
+  std::shared_ptr<const ModelData> model_;
+  NodeHierarchy nodes_; // 再生中の姿勢を書き込むモデルの階層のコピー
+  AnimationPose bindPose_;
+  AnimationPose pose_;
+  AnimationPose fadePose_; // 切り替え元の姿勢
+  std::vector<Matrix4x4> skinMatrices_;
+
+  Layer current_;
+  Layer previous_; // CrossFade の切り替え元
+  // true なら切り替え元は fadePose_ に止めた姿勢（previous_ は進めない）
+  bool fadeFromSnapshot_ = false;
+  float fadeTime_ = 0.0f;
+  float fadeDuration_ = 0.0f;
+  float speed_ = 1.0f;
+};
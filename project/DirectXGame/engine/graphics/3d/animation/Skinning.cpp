@@ -0,0 +1,124 @@
+#include "Skinning.h"
+#include "ModelData.h"
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define SKINNING_USE_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr float kWeightScale = 1.0f / 255.0f;
+
+void SkinVertexScalar(const VertexData &s, const VertexInfluence &inf,
+                      const Matrix4x4 *palette, VertexData &d) {
+  float r[4][4] = {};
+  for (int k = 0; k < 4; ++k) {
+    if (inf.weights[k] == 0) {
+      continue;
+    }
+    const Matrix4x4 &m = palette[inf.joints[k]];
+    const float w = inf.weights[k] * kWeightScale;
+    for (int row = 0; row < 4; ++row) {
+      for (int col = 0; col < 4; ++col) {
+        r[row][col] += w * m.m[row][col];
+      }
+    }
+  }
+
+  const Vector4 p = s.position;
+  const Vector3 n = s.normal;
+  float outP[4];
+  float outN[3];
+  for (int col = 0; col < 4; ++col) {
+    outP[col] = p.x * r[0][col] + p.y * r[1][col] + p.z * r[2][col] +
+                p.w * r[3][col];
+  }
+  for (int col = 0; col < 3; ++col) {
+    outN[col] = n.x * r[0][col] + n.y * r[1][col] + n.z * r[2][col];
+  }
+  const float lengthSq = outN[0] * outN[0] + outN[1] * outN[1] + outN[2] * outN[2];
+  const float inv = lengthSq > 0.0f ? 1.0f / std::sqrt(lengthSq) : 0.0f;
+
+  d.texcoord = s.texcoord;
+  d.position = {outP[0], outP[1], outP[2], outP[3]};
+  d.normal = {outN[0] * inv, outN[1] * inv, outN[2] * inv};
+}
+
+#if defined(SKINNING_USE_SSE)
+
+void SkinVertexSse(const VertexData &s, const VertexInfluence &inf,
+                   const Matrix4x4 *palette, VertexData &d) {
+  // 影響するジョイントの行列を重み付きで足し合わせる（行ごとに 4 要素）
+  __m128 r0 = _mm_setzero_ps();
+  __m128 r1 = _mm_setzero_ps();
+  __m128 r2 = _mm_setzero_ps();
+  __m128 r3 = _mm_setzero_ps();
+  for (int k = 0; k < 4; ++k) {
+    if (inf.weights[k] == 0) {
+      continue;
+    }
+    const float *m = &palette[inf.joints[k]].m[0][0];
+    const __m128 w = _mm_set1_ps(inf.weights[k] * kWeightScale);
+    r0 = _mm_add_ps(r0, _mm_mul_ps(w, _mm_loadu_ps(m + 0)));
+    r1 = _mm_add_ps(r1, _mm_mul_ps(w, _mm_loadu_ps(m + 4)));
+    r2 = _mm_add_ps(r2, _mm_mul_ps(w, _mm_loadu_ps(m + 8)));
+    r3 = _mm_add_ps(r3, _mm_mul_ps(w, _mm_loadu_ps(m + 12)));
+  }
+
+  // 行ベクトル × 行列 = 各行を成分で重み付けして足す
+  const __m128 p = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(s.position.x), r0),
+                 _mm_mul_ps(_mm_set1_ps(s.position.y), r1)),
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(s.position.z), r2),
+                 _mm_mul_ps(_mm_set1_ps(s.position.w), r3)));
+  const __m128 n = _mm_add_ps(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(s.normal.x), r0),
+                 _mm_mul_ps(_mm_set1_ps(s.normal.y), r1)),
+      _mm_mul_ps(_mm_set1_ps(s.normal.z), r2));
+
+  // 長さの 2 乗（x + y + z）
+  const __m128 sq = _mm_mul_ps(n, n);
+  const __m128 len2 = _mm_add_ss(
+      _mm_add_ss(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(1, 1, 1, 1))),
+      _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2, 2, 2, 2)));
+  const float lengthSq = _mm_cvtss_f32(len2);
+  const __m128 inv = _mm_set1_ps(
+      lengthSq > 0.0f ? 1.0f / _mm_cvtss_f32(_mm_sqrt_ss(len2)) : 0.0f);
+
+  // normal は構造体の末尾なので 4 要素で書くと次の頂点にはみ出す
+  alignas(16) float normal[4];
+  _mm_store_ps(normal, _mm_mul_ps(n, inv));
+
+  d.texcoord = s.texcoord;
+  _mm_storeu_ps(&d.position.x, p);
+  d.normal = {normal[0], normal[1], normal[2]};
+}
+
+#endif
+
+} // namespace
+
+namespace Skinning {
+
+void SkinVertices(const VertexData *src, const VertexInfluence *influences,
+                  size_t count, const Matrix4x4 *palette, VertexData *dst) {
+  for (size_t i = 0; i < count; ++i) {
+#if defined(SKINNING_USE_SSE)
+    SkinVertexSse(src[i], influences[i], palette, dst[i]);
+#else
+    SkinVertexScalar(src[i], influences[i], palette, dst[i]);
+#endif
+  }
+}
+
+void SkinVerticesScalar(const VertexData *src,
+                        const VertexInfluence *influences, size_t count,
+                        const Matrix4x4 *palette, VertexData *dst) {
+  for (size_t i = 0; i < count; ++i) {
+    SkinVertexScalar(src[i], influences[i], palette, dst[i]);
+  }
+}
+
+} // namespace Skinning
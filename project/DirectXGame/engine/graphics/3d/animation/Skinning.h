@@ -0,0 +1,22 @@
+#pragma once
+#include "Matrix.h"
+#include <cstddef>
+
+struct VertexData;
+struct VertexInfluence;
+
+// CPU スキニング（Object3d.VS.hlsl の SKINNED と同じ計算）
+// - 位置: p' = p * Σ w_i M_i / 法線: n' = normalize(n * Σ w_i M_i)（3x3 部分）
+// - x86/x64 では SSE で 1 頂点の行列ブレンドと変換を 4 要素ずつ計算する
+namespace Skinning {
+
+// src / dst は count 個。dst は src と同じでもよい。texcoord はそのまま写す
+void SkinVertices(const VertexData *src, const VertexInfluence *influences,
+                  size_t count, const Matrix4x4 *palette, VertexData *dst);
+
+// SSE を使わない版（SSE の無い環境での SkinVertices。結果の比較・速度の比較用）
+void SkinVerticesScalar(const VertexData *src,
+                        const VertexInfluence *influences, size_t count,
+                        const Matrix4x4 *palette, VertexData *dst);
+
+} // namespace Skinning
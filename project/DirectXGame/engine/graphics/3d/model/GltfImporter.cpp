@@ -0,0 +1,902 @@
+#include "GltfImporter.h"
+#include "AnimationSampler.h"
+#include "MappedFile.h"
+#include "Method.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define GLTF_USE_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr uint32_t kGlbMagic = 0x46546C67;     // "glTF"
+constexpr uint32_t kGlbChunkJson = 0x4E4F534A; // "JSON"
+constexpr uint32_t kGlbChunkBin = 0x004E4942;  // "BIN\0"
+constexpr uint32_t kComponentByte = 5120;
+constexpr uint32_t kComponentUnsignedByte = 5121;
+constexpr uint32_t kComponentShort = 5122;
+constexpr uint32_t kComponentUnsignedShort = 5123;
+constexpr uint32_t kComponentUnsignedInt = 5125;
+constexpr uint32_t kComponentFloat = 5126;
+constexpr int kModeTriangles = 4;
+constexpr int kMaxJsonDepth = 64;
+
+// ===== JSON（glTF の記述部分は小さいので DOM にしてから引く） =====
+
+enum class JsonType : uint8_t { Null, Bool, Number, String, Array, Object };
+
+struct JsonValue {
+  JsonType type = JsonType::Null;
+  bool boolean = false;
+  double number = 0.0;
+  std::string_view text;              // 文字列（エスケープはそのまま）
+  std::vector<JsonValue> items;       // 配列の要素・オブジェクトの値
+  std::vector<std::string_view> keys; // オブジェクトのキー（items と同じ並び）
+
+  const JsonValue *Find(std::string_view key) const {
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (keys[i] == key) {
+        return &items[i];
+      }
+    }
+    return nullptr;
+  }
+  size_t Size() const { return type == JsonType::Array ? items.size() : 0; }
+};
+
+class JsonParser {
+public:
+  JsonParser(const char *p, const char *end) : p_(p), end_(end) {}
+
+  bool Parse(JsonValue &out) {
+    if (!ParseValue_(out, 0)) {
+      return false;
+    }
+    SkipSpace_();
+    return p_ == end_;
+  }
+
+private:
+  void SkipSpace_() {
+    while (p_ < end_ &&
+           (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+      ++p_;
+    }
+  }
+
+  // p_ は開きの '"' を指している
+  bool ParseString_(std::string_view &out) {
+    const char *start = ++p_;
+    while (p_ < end_ && *p_ != '"') {
+      p_ += (*p_ == '\\') ? 2 : 1;
+    }
+    if (p_ >= end_) {
+      return false;
+    }
+    out = {start, static_cast<size_t>(p_ - start)};
+    ++p_;
+    return true;
+  }
+
+  bool ParseLiteral_(std::string_view word) {
+    if (static_cast<size_t>(end_ - p_) < word.size() ||
+        std::memcmp(p_, word.data(), word.size()) != 0) {
+      return false;
+    }
+    p_ += word.size();
+    return true;
+  }
+
+  bool ParseValue_(JsonValue &out, int depth) {
+    if (depth > kMaxJsonDepth) {
+      return false;
+    }
+    SkipSpace_();
+    if (p_ >= end_) {
+      return false;
+    }
+    switch (*p_) {
+    case '{':
+    case '[': {
+      const bool object = (*p_ == '{');
+      const char close = object ? '}' : ']';
+      out.type = object ? JsonType::Object : JsonType::Array;
+      ++p_;
+      SkipSpace_();
+      if (p_ < end_ && *p_ == close) {
+        ++p_;
+        return true;
+      }
+      while (true) {
+        if (object) {
+          SkipSpace_();
+          std::string_view key;
+          if (p_ >= end_ || *p_ != '"' || !ParseString_(key)) {
+            return false;
+          }
+          SkipSpace_();
+          if (p_ >= end_ || *p_ != ':') {
+            return false;
+          }
+          ++p_;
+          out.keys.push_back(key);
+        }
+        out.items.emplace_back();
+        if (!ParseValue_(out.items.back(), depth + 1)) {
+          return false;
+        }
+        SkipSpace_();
+        if (p_ < end_ && *p_ == ',') {
+          ++p_;
+          continue;
+        }
+        if (p_ < end_ && *p_ == close) {
+          ++p_;
+          return true;
+        }
+        return false;
+      }
+    }
+    case '"':
+      out.type = JsonType::String;
+      return ParseString_(out.text);
+    case 't':
+      out.type = JsonType::Bool;
+      out.boolean = true;
+      return ParseLiteral_("true");
+    case 'f':
+      out.type = JsonType::Bool;
+      return ParseLiteral_("false");
+    case 'n':
+      return ParseLiteral_("null");
+    default: {
+      out.type = JsonType::Number;
+      const std::from_chars_result result =
+          std::from_chars(p_, end_, out.number);
+      if (result.ec != std::errc{}) {
+        return false;
+      }
+      p_ = result.ptr;
+      return true;
+    }
+    }
+  }
+
+  const char *p_;
+  const char *end_;
+};
+
+// 0 以上の整数として読む。無い・数でない・負・整数でない・size_t に収まらないなら fallback
+// （NaN・無限大・範囲外の値を size_t へ変換するのは未定義動作）
+size_t GetIndex(const JsonValue *value, size_t fallback) {
+  if (!value || value->type != JsonType::Number) {
+    return fallback;
+  }
+  const double number = value->number;
+  // double(SIZE_MAX) は 2^64 に丸められるので、それ未満なら変換できる
+  if (!std::isfinite(number) || number < 0.0 ||
+      number >= static_cast<double>(SIZE_MAX) || std::floor(number) != number) {
+    return fallback;
+  }
+  return static_cast<size_t>(number);
+}
+
+// root[key][index]。無ければ nullptr
+const JsonValue *GetItem(const JsonValue &root, std::string_view key,
+                         size_t index) {
+  const JsonValue *array = root.Find(key);
+  if (!array || index >= array->Size()) {
+    return nullptr;
+  }
+  return &array->items[index];
+}
+
+void AppendUtf8(uint32_t code, std::string &out) {
+  if (code < 0x80) {
+    out += static_cast<char>(code);
+  } else if (code < 0x800) {
+    out += static_cast<char>(0xC0 | (code >> 6));
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  } else {
+    out += static_cast<char>(0xE0 | (code >> 12));
+    out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code & 0x3F));
+  }
+}
+
+// JSON 文字列のエスケープを戻す（\u はサロゲートペアを扱わない）
+std::string Unescape(std::string_view text) {
+  std::string out;
+  out.reserve(text.size());
+  for (size_t i = 0; i < text.size(); ++i) {
+    if (text[i] != '\\' || i + 1 >= text.size()) {
+      out += text[i];
+      continue;
+    }
+    const char c = text[++i];
+    switch (c) {
+    case 'b': out += '\b'; break;
+    case 'f': out += '\f'; break;
+    case 'n': out += '\n'; break;
+    case 'r': out += '\r'; break;
+    case 't': out += '\t'; break;
+    case 'u': {
+      uint32_t code = 0;
+      if (i + 4 < text.size() &&
+          std::from_chars(text.data() + i + 1, text.data() + i + 5, code, 16)
+                  .ptr == text.data() + i + 5) {
+        AppendUtf8(code, out);
+        i += 4;
+      }
+      break;
+    }
+    default: out += c; break;
+    }
+  }
+  return out;
+}
+
+// URI の %XX を戻す（"my%20texture.png" など）
+std::string DecodeUri(std::string_view uri) {
+  std::string out;
+  out.reserve(uri.size());
+  for (size_t i = 0; i < uri.size(); ++i) {
+    uint32_t code = 0;
+    if (uri[i] == '%' && i + 2 < uri.size() &&
+        std::from_chars(uri.data() + i + 1, uri.data() + i + 3, code, 16)
+                .ptr == uri.data() + i + 3) {
+      out += static_cast<char>(code);
+      i += 2;
+    } else {
+      out += uri[i];
+    }
+  }
+  return out;
+}
+
+bool DecodeBase64(std::string_view text, std::vector<uint8_t> &out) {
+  const auto value = [](char c) -> int {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+  };
+  out.clear();
+  out.reserve(text.size() / 4 * 3);
+  uint32_t bits = 0;
+  int bitCount = 0;
+  for (char c : text) {
+    if (c == '=') {
+      break;
+    }
+    const int v = value(c);
+    if (v < 0) {
+      return false;
+    }
+    bits = (bits << 6) | static_cast<uint32_t>(v);
+    bitCount += 6;
+    if (bitCount >= 8) {
+      bitCount -= 8;
+      out.push_back(static_cast<uint8_t>(bits >> bitCount));
+    }
+  }
+  return true;
+}
+
+uint32_t ReadU32(const uint8_t *p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// ===== バッファとアクセサ =====
+
+struct Buffer {
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+};
+
+struct Document {
+  JsonValue root;
+  std::vector<Buffer> buffers;
+  std::vector<std::unique_ptr<MappedFile>> files; // 外部 .bin（マップしたまま読む）
+  std::vector<std::vector<uint8_t>> decoded;      // data: URI を展開したもの
+};
+
+bool LoadBuffers(const std::string &directoryPath, const Buffer &glbBin,
+                 Document &doc) {
+  const JsonValue *buffers = doc.root.Find("buffers");
+  const size_t count = buffers ? buffers->Size() : 0;
+  doc.buffers.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    const JsonValue &json = buffers->items[i];
+    const size_t byteLength = GetIndex(json.Find("byteLength"), 0);
+    const JsonValue *uri = json.Find("uri");
+    Buffer &buffer = doc.buffers[i];
+
+    if (!uri || uri->type != JsonType::String) {
+      // URI の無い最初のバッファは GLB の BIN チャンク
+      if (i != 0 || !glbBin.data) {
+        return false;
+      }
+      buffer = glbBin;
+    } else if (uri->text.substr(0, 5) == "data:") {
+      const size_t comma = uri->text.find(";base64,");
+      std::vector<uint8_t> bytes;
+      if (comma == std::string_view::npos ||
+          !DecodeBase64(uri->text.substr(comma + 8), bytes)) {
+        return false;
+      }
+      doc.decoded.push_back(std::move(bytes));
+      buffer = {doc.decoded.back().data(), doc.decoded.back().size()};
+    } else {
+      auto file = std::make_unique<MappedFile>();
+      if (!file->Open(directoryPath + "/" + DecodeUri(Unescape(uri->text)))) {
+        return false;
+      }
+      buffer = {file->GetData(), file->GetSize()};
+      doc.files.push_back(std::move(file));
+    }
+
+    if (buffer.size < byteLength) {
+      return false;
+    }
+    buffer.size = byteLength;
+  }
+  return true;
+}
+
+// バッファの中を直接指す（要素 i は data + i * stride）
+struct Accessor {
+  const uint8_t *data = nullptr;
+  size_t count = 0;
+  size_t stride = 0;
+  uint32_t componentType = 0;
+  uint32_t components = 0;
+};
+
+size_t ComponentSize(uint32_t componentType) {
+  switch (componentType) {
+  case kComponentByte:
+  case kComponentUnsignedByte:
+    return 1;
+  case kComponentShort:
+  case kComponentUnsignedShort:
+    return 2;
+  case kComponentUnsignedInt:
+  case kComponentFloat:
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+uint32_t ComponentCount(std::string_view type) {
+  if (type == "SCALAR") return 1;
+  if (type == "VEC2") return 2;
+  if (type == "VEC3") return 3;
+  if (type == "VEC4") return 4;
+  if (type == "MAT2") return 4;
+  if (type == "MAT3") return 9;
+  if (type == "MAT4") return 16;
+  return 0;
+}
+
+// 範囲がバッファに収まっているかまで確かめる。疎なアクセサ・bufferView 無しは扱わない
+bool GetAccessor(const Document &doc, size_t index, Accessor &out) {
+  const JsonValue *accessor = GetItem(doc.root, "accessors", index);
+  if (!accessor || accessor->Find("sparse")) {
+    return false;
+  }
+  const JsonValue *view =
+      GetItem(doc.root, "bufferViews",
+              GetIndex(accessor->Find("bufferView"), SIZE_MAX));
+  const JsonValue *type = accessor->Find("type");
+  if (!view || !type || type->type != JsonType::String) {
+    return false;
+  }
+  const size_t bufferIndex = GetIndex(view->Find("buffer"), SIZE_MAX);
+  if (bufferIndex >= doc.buffers.size()) {
+    return false;
+  }
+  const Buffer &buffer = doc.buffers[bufferIndex];
+
+  out.count = GetIndex(accessor->Find("count"), 0);
+  out.componentType =
+      static_cast<uint32_t>(GetIndex(accessor->Find("componentType"), 0));
+  out.components = ComponentCount(type->text);
+  const size_t elementSize = ComponentSize(out.componentType) * out.components;
+  if (elementSize == 0) {
+    return false;
+  }
+  out.stride = GetIndex(view->Find("byteStride"), 0);
+  if (out.stride == 0) {
+    out.stride = elementSize;
+  }
+
+  const size_t viewOffset = GetIndex(view->Find("byteOffset"), 0);
+  const size_t viewLength = GetIndex(view->Find("byteLength"), 0);
+  const size_t offset = GetIndex(accessor->Find("byteOffset"), 0);
+  if (out.stride < elementSize || viewOffset > buffer.size ||
+      viewLength > buffer.size - viewOffset || offset > viewLength) {
+    return false;
+  }
+  if (out.count > 0 &&
+      (out.count - 1 > (viewLength - offset) / out.stride ||
+       (out.count - 1) * out.stride + elementSize > viewLength - offset)) {
+    return false;
+  }
+  out.data = buffer.data + viewOffset + offset;
+  return true;
+}
+
+bool IsFloatVector(const Accessor &a, uint32_t components, size_t count) {
+  return a.componentType == kComponentFloat && a.components == components &&
+         a.count == count;
+}
+
+// ===== 属性の書き込み（右手系 → 左手系、UV の反転をまとめて行う） =====
+
+// z を反転し w = 1
+void WritePositions(const Accessor &a, VertexData *dst) {
+  size_t i = 0;
+#if defined(GLTF_USE_SSE)
+  const __m128 flipZ = _mm_castsi128_ps(
+      _mm_set_epi32(0, static_cast<int>(0x80000000u), 0, 0));
+  const __m128 xyz = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+  const __m128 w = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+  // 16 バイト読むので最後の 1 つはスカラーで（それ以外は次の要素の範囲内）
+  for (; i + 1 < a.count; ++i) {
+    const __m128 p =
+        _mm_loadu_ps(reinterpret_cast<const float *>(a.data + i * a.stride));
+    _mm_storeu_ps(&dst[i].position.x,
+                  _mm_or_ps(_mm_and_ps(_mm_xor_ps(p, flipZ), xyz), w));
+  }
+#endif
+  for (; i < a.count; ++i) {
+    float p[3];
+    std::memcpy(p, a.data + i * a.stride, sizeof(p));
+    dst[i].position = {p[0], p[1], -p[2], 1.0f};
+  }
+}
+
+// z を反転
+void WriteNormals(const Accessor &a, VertexData *dst) {
+  size_t i = 0;
+#if defined(GLTF_USE_SSE)
+  const __m128 flipZ = _mm_castsi128_ps(
+      _mm_set_epi32(0, static_cast<int>(0x80000000u), 0, 0));
+  for (; i + 1 < a.count; ++i) {
+    const __m128 n = _mm_xor_ps(
+        _mm_loadu_ps(reinterpret_cast<const float *>(a.data + i * a.stride)),
+        flipZ);
+    // normal の後ろは次の頂点なので 8 + 4 バイトに分けて書く
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(&dst[i].normal.x),
+                     _mm_castps_si128(n));
+    _mm_store_ss(&dst[i].normal.z, _mm_movehl_ps(n, n));
+  }
+#endif
+  for (; i < a.count; ++i) {
+    float n[3];
+    std::memcpy(n, a.data + i * a.stride, sizeof(n));
+    dst[i].normal = {n[0], n[1], -n[2]};
+  }
+}
+
+// 反転する軸は t * -1 + 1（1 - t と同じ値になる）
+void WriteTexcoords(const Accessor &a, bool flipU, bool flipV,
+                    VertexData *dst) {
+  const float scaleU = flipU ? -1.0f : 1.0f;
+  const float scaleV = flipV ? -1.0f : 1.0f;
+  const float offsetU = flipU ? 1.0f : 0.0f;
+  const float offsetV = flipV ? 1.0f : 0.0f;
+  size_t i = 0;
+#if defined(GLTF_USE_SSE)
+  const __m128 scale = _mm_setr_ps(scaleU, scaleV, 0.0f, 0.0f);
+  const __m128 offset = _mm_setr_ps(offsetU, offsetV, 0.0f, 0.0f);
+  for (; i < a.count; ++i) {
+    // 8 バイトの読み書き（loadl / storel_epi64 は境界合わせ不要）
+    const __m128 t = _mm_castsi128_ps(_mm_loadl_epi64(
+        reinterpret_cast<const __m128i *>(a.data + i * a.stride)));
+    _mm_storel_epi64(
+        reinterpret_cast<__m128i *>(&dst[i].texcoord.x),
+        _mm_castps_si128(_mm_add_ps(_mm_mul_ps(t, scale), offset)));
+  }
+#endif
+  for (; i < a.count; ++i) {
+    float t[2];
+    std::memcpy(t, a.data + i * a.stride, sizeof(t));
+    dst[i].texcoord = {t[0] * scaleU + offsetU, t[1] * scaleV + offsetV};
+  }
+}
+
+uint32_t ReadIndex(const Accessor &a, size_t i) {
+  const uint8_t *p = a.data + i * a.stride;
+  switch (a.componentType) {
+  case kComponentUnsignedByte:
+    return *p;
+  case kComponentUnsignedShort: {
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+  }
+  default:
+    return ReadU32(p);
+  }
+}
+
+// 巻き順を逆にして（時計回りが表）読む
+bool ReadIndices(const Accessor &a, size_t vertexCount,
+                 std::vector<uint32_t> &out) {
+  if (a.components != 1 || a.count % 3 != 0 ||
+      (a.componentType != kComponentUnsignedByte &&
+       a.componentType != kComponentUnsignedShort &&
+       a.componentType != kComponentUnsignedInt)) {
+    return false;
+  }
+  out.resize(a.count);
+  for (size_t i = 0; i < a.count; i += 3) {
+    for (size_t k = 0; k < 3; ++k) {
+      const uint32_t index = ReadIndex(a, i + k);
+      if (index >= vertexCount) {
+        return false;
+      }
+      out[i + 2 - k] = index;
+    }
+  }
+  return true;
+}
+
+// GenSmoothNormals と同じく、同じ位置の頂点で面の法線を平均する
+void GenerateNormals(MeshData &mesh) {
+  struct PositionKey {
+    float x, y, z;
+    bool operator==(const PositionKey &o) const {
+      return x == o.x && y == o.y && z == o.z;
+    }
+  };
+  struct PositionHash {
+    size_t operator()(const PositionKey &k) const {
+      uint32_t bits[3];
+      std::memcpy(bits, &k, sizeof(bits));
+      return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^
+             (bits[2] * 83492791u);
+    }
+  };
+  std::unordered_map<PositionKey, uint32_t, PositionHash> groups;
+  std::vector<uint32_t> groupOf(mesh.vertices.size());
+  for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+    const Vector4 &p = mesh.vertices[i].position;
+    // -0 と +0 を同じにする
+    const PositionKey key{p.x + 0.0f, p.y + 0.0f, p.z + 0.0f};
+    groupOf[i] = groups.emplace(key, static_cast<uint32_t>(groups.size()))
+                     .first->second;
+  }
+
+  std::vector<Vector3> sum(groups.size(), Vector3{0, 0, 0});
+  const auto position = [&](uint32_t i) {
+    const Vector4 &p = mesh.vertices[i].position;
+    return Vector3{p.x, p.y, p.z};
+  };
+  for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+    const Vector3 a = position(mesh.indices[i + 0]);
+    const Vector3 b = position(mesh.indices[i + 1]);
+    const Vector3 c = position(mesh.indices[i + 2]);
+    // 時計回りが表なので (b - a) x (c - a) が外向き
+    const Vector3 n = Cross({b.x - a.x, b.y - a.y, b.z - a.z},
+                            {c.x - a.x, c.y - a.y, c.z - a.z});
+    const float length = std::sqrt(Dot(n, n));
+    if (length <= 0.0f) {
+      continue;
+    }
+    for (size_t k = 0; k < 3; ++k) {
+      uint32_t &g = groupOf[mesh.indices[i + k]];
+      sum[g] = Add(sum[g], {n.x / length, n.y / length, n.z / length});
+    }
+  }
+  for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+    const Vector3 &total = sum[groupOf[i]];
+    const float length = std::sqrt(Dot(total, total));
+    mesh.vertices[i].normal =
+        length > 0.0f
+            ? Vector3{total.x / length, total.y / length, total.z / length}
+            : Vector3{0.0f, 1.0f, 0.0f};
+  }
+}
+
+bool ReadPrimitive(const Document &doc, const JsonValue &primitive,
+                   int defaultMaterial, bool flipU, bool flipV,
+                   MeshData &mesh) {
+  if (GetIndex(primitive.Find("mode"), kModeTriangles) != kModeTriangles) {
+    return false;
+  }
+  const JsonValue *attributes = primitive.Find("attributes");
+  if (!attributes) {
+    return false;
+  }
+
+  Accessor positions{};
+  if (!GetAccessor(doc, GetIndex(attributes->Find("POSITION"), SIZE_MAX),
+                   positions) ||
+      !IsFloatVector(positions, 3, positions.count)) {
+    return false;
+  }
+  const size_t vertexCount = positions.count;
+  mesh.vertices.resize(vertexCount);
+  WritePositions(positions, mesh.vertices.data());
+
+  const JsonValue *normalIndex = attributes->Find("NORMAL");
+  Accessor normals{};
+  if (normalIndex) {
+    if (!GetAccessor(doc, GetIndex(normalIndex, SIZE_MAX), normals) ||
+        !IsFloatVector(normals, 3, vertexCount)) {
+      return false;
+    }
+    WriteNormals(normals, mesh.vertices.data());
+  }
+
+  const JsonValue *texcoordIndex = attributes->Find("TEXCOORD_0");
+  if (texcoordIndex) {
+    Accessor texcoords{};
+    // 正規化整数の UV は Assimp に任せる
+    if (!GetAccessor(doc, GetIndex(texcoordIndex, SIZE_MAX), texcoords) ||
+        !IsFloatVector(texcoords, 2, vertexCount)) {
+      return false;
+    }
+    WriteTexcoords(texcoords, flipU, flipV, mesh.vertices.data());
+  } else {
+    // Assimp 経由と同じく (0, 0) に反転だけ掛けた値
+    for (VertexData &v : mesh.vertices) {
+      v.texcoord = {flipU ? 1.0f : 0.0f, flipV ? 1.0f : 0.0f};
+    }
+  }
+
+  const JsonValue *indexAccessor = primitive.Find("indices");
+  if (indexAccessor) {
+    Accessor indices{};
+    if (!GetAccessor(doc, GetIndex(indexAccessor, SIZE_MAX), indices) ||
+        !ReadIndices(indices, vertexCount, mesh.indices)) {
+      return false;
+    }
+  } else {
+    // インデックス無しは頂点を順に 3 つずつ
+    if (vertexCount % 3 != 0) {
+      return false;
+    }
+    mesh.indices.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; i += 3) {
+      mesh.indices[i + 0] = static_cast<uint32_t>(i + 2);
+      mesh.indices[i + 1] = static_cast<uint32_t>(i + 1);
+      mesh.indices[i + 2] = static_cast<uint32_t>(i + 0);
+    }
+  }
+
+  if (!normalIndex) {
+    GenerateNormals(mesh);
+  }
+
+  const size_t material =
+      GetIndex(primitive.Find("material"), static_cast<size_t>(defaultMaterial));
+  mesh.materialIndex = material < static_cast<size_t>(defaultMaterial)
+                           ? static_cast<int>(material)
+                           : defaultMaterial;
+  return true;
+}
+
+// ノードのローカル行列（行ベクトル規約、左手系へ鏡映済み）
+Matrix4x4 ReadNodeMatrix(const JsonValue &node) {
+  Matrix4x4 m = MakeIdentity4x4();
+  const JsonValue *matrix = node.Find("matrix");
+  if (matrix && matrix->Size() == 16) {
+    // 列優先・列ベクトル規約なので、並び順のまま行ベクトル規約の行になる
+    for (int i = 0; i < 16; ++i) {
+      m.m[i / 4][i % 4] = static_cast<float>(matrix->items[i].number);
+    }
+  } else {
+    const auto read = [&](const char *key, float *dst, size_t count) {
+      const JsonValue *v = node.Find(key);
+      if (v && v->Size() == count) {
+        for (size_t i = 0; i < count; ++i) {
+          dst[i] = static_cast<float>(v->items[i].number);
+        }
+      }
+    };
+    Vector3 scale{1.0f, 1.0f, 1.0f};
+    Vector4 rotation{0.0f, 0.0f, 0.0f, 1.0f};
+    Vector3 translation{0.0f, 0.0f, 0.0f};
+    read("scale", &scale.x, 3);
+    read("rotation", &rotation.x, 4);
+    read("translation", &translation.x, 3);
+    m = Animation::MakeTransformMatrix(scale, rotation, translation);
+  }
+
+  // MakeLeftHanded と同じく z で挟む（Mirror * M * Mirror）
+  m.m[0][2] = -m.m[0][2];
+  m.m[1][2] = -m.m[1][2];
+  m.m[2][0] = -m.m[2][0];
+  m.m[2][1] = -m.m[2][1];
+  m.m[2][3] = -m.m[2][3];
+  m.m[3][2] = -m.m[3][2];
+  return m;
+}
+
+} // namespace
+
+namespace GltfImporter {
+
+bool Import(const std::string &directoryPath, const std::string &filePath,
+            bool flipU, bool flipV, ModelData &out) {
+  MappedFile file;
+  if (!file.Open(filePath)) {
+    return false;
+  }
+  const uint8_t *bytes = file.GetData();
+  const size_t size = file.GetSize();
+
+  // GLB ならチャンクに分け、そうでなければ全体が JSON
+  const char *json = reinterpret_cast<const char *>(bytes);
+  size_t jsonSize = size;
+  Buffer glbBin{};
+  if (size >= 12 && ReadU32(bytes) == kGlbMagic) {
+    const size_t length = ReadU32(bytes + 8);
+    if (ReadU32(bytes + 4) != 2 || length > size) {
+      return false;
+    }
+    json = nullptr;
+    for (size_t offset = 12; offset + 8 <= length;) {
+      const size_t chunkLength = ReadU32(bytes + offset);
+      const uint32_t chunkType = ReadU32(bytes + offset + 4);
+      offset += 8;
+      if (chunkLength > length - offset) {
+        return false;
+      }
+      if (chunkType == kGlbChunkJson && !json) {
+        json = reinterpret_cast<const char *>(bytes + offset);
+        jsonSize = chunkLength;
+      } else if (chunkType == kGlbChunkBin && !glbBin.data) {
+        glbBin = {bytes + offset, chunkLength};
+      }
+      offset += chunkLength;
+    }
+    if (!json) {
+      return false;
+    }
+  }
+
+  Document doc;
+  if (!JsonParser(json, json + jsonSize).Parse(doc.root) ||
+      doc.root.type != JsonType::Object) {
+    return false;
+  }
+  const JsonValue &root = doc.root;
+  const JsonValue *required = root.Find("extensionsRequired");
+  if ((root.Find("skins") && root.Find("skins")->Size() > 0) ||
+      (root.Find("animations") && root.Find("animations")->Size() > 0) ||
+      (required && required->Size() > 0)) {
+    return false;
+  }
+  if (!LoadBuffers(directoryPath, glbBin, doc)) {
+    return false;
+  }
+
+  out = ModelData{};
+
+  // マテリアル（Assimp と同じく最後に既定マテリアル）
+  const JsonValue *materials = root.Find("materials");
+  const size_t materialCount = materials ? materials->Size() : 0;
+  out.materials.resize(materialCount + 1);
+  for (size_t i = 0; i < materialCount; ++i) {
+    const JsonValue *pbr = materials->items[i].Find("pbrMetallicRoughness");
+    const JsonValue *baseColor = pbr ? pbr->Find("baseColorTexture") : nullptr;
+    if (!baseColor) {
+      continue;
+    }
+    const JsonValue *texture =
+        GetItem(root, "textures", GetIndex(baseColor->Find("index"), SIZE_MAX));
+    const JsonValue *image =
+        texture ? GetItem(root, "images",
+                          GetIndex(texture->Find("source"), SIZE_MAX))
+                : nullptr;
+    const JsonValue *uri = image ? image->Find("uri") : nullptr;
+    // 埋め込み画像（bufferView・data: URI）は扱わない
+    if (uri && uri->type == JsonType::String &&
+        uri->text.substr(0, 5) != "data:") {
+      out.materials[i].textureFilePath =
+          directoryPath + "/" + DecodeUri(Unescape(uri->text));
+    }
+  }
+
+  // メッシュ（プリミティブ 1 つが MeshData 1 つ）
+  const JsonValue *meshes = root.Find("meshes");
+  const size_t meshCount = meshes ? meshes->Size() : 0;
+  std::vector<uint32_t> meshOffsets(meshCount + 1, 0);
+  for (size_t m = 0; m < meshCount; ++m) {
+    meshOffsets[m] = static_cast<uint32_t>(out.meshes.size());
+    const JsonValue *primitives = meshes->items[m].Find("primitives");
+    const size_t primitiveCount = primitives ? primitives->Size() : 0;
+    for (size_t p = 0; p < primitiveCount; ++p) {
+      MeshData mesh;
+      if (!ReadPrimitive(doc, primitives->items[p],
+                         static_cast<int>(materialCount), flipU, flipV,
+                         mesh)) {
+        return false;
+      }
+      out.meshes.push_back(std::move(mesh));
+    }
+  }
+  meshOffsets[meshCount] = static_cast<uint32_t>(out.meshes.size());
+  if (out.meshes.empty()) {
+    return false;
+  }
+
+  // ノード（ルートが 1 つならそれを、複数なら "ROOT" の下に並べる）
+  const JsonValue *scene =
+      GetItem(root, "scenes", GetIndex(root.Find("scene"), 0));
+  const JsonValue *rootNodes = scene ? scene->Find("nodes") : nullptr;
+  const JsonValue *nodes = root.Find("nodes");
+  const size_t nodeCount = nodes ? nodes->Size() : 0;
+  if (!rootNodes || rootNodes->Size() == 0) {
+    return false;
+  }
+
+  struct Pending {
+    size_t node;
+    uint32_t parent;
+  };
+  std::vector<Pending> stack;
+  uint32_t topParent = NodeHierarchy::kNone;
+  if (rootNodes->Size() > 1) {
+    topParent = out.nodes.AddNode(NodeHierarchy::kNone, "ROOT",
+                                  MakeIdentity4x4());
+  }
+  for (size_t i = rootNodes->Size(); i > 0; --i) {
+    stack.push_back({GetIndex(&rootNodes->items[i - 1], SIZE_MAX), topParent});
+  }
+
+  std::vector<uint8_t> visited(nodeCount, 0);
+  std::vector<uint32_t> meshIndices;
+  while (!stack.empty()) {
+    const Pending p = stack.back();
+    stack.pop_back();
+    // 範囲外・循環・複数の親は不正なファイル
+    if (p.node >= nodeCount || visited[p.node]) {
+      return false;
+    }
+    visited[p.node] = 1;
+    const JsonValue &node = nodes->items[p.node];
+
+    meshIndices.clear();
+    const size_t mesh = GetIndex(node.Find("mesh"), SIZE_MAX);
+    if (mesh < meshCount) {
+      for (uint32_t i = meshOffsets[mesh]; i < meshOffsets[mesh + 1]; ++i) {
+        meshIndices.push_back(i);
+      }
+    }
+    const JsonValue *name = node.Find("name");
+    const std::string nodeName =
+        name && name->type == JsonType::String
+            ? Unescape(name->text)
+            : "node_" + std::to_string(p.node);
+    const uint32_t index = out.nodes.AddNode(
+        p.parent, nodeName, ReadNodeMatrix(node), meshIndices);
+
+    // 子は逆順に積み、元の並び順で取り出す
+    const JsonValue *children = node.Find("children");
+    for (size_t i = children ? children->Size() : 0; i > 0; --i) {
+      stack.push_back({GetIndex(&children->items[i - 1], SIZE_MAX), index});
+    }
+  }
+  out.nodes.UpdateGlobalMatrices();
+  return true;
+}
+
+} // namespace GltfImporter
@@ -0,0 +1,22 @@
+#pragma once
+#include <string>
+
+#include "ModelData.h"
+
+// glTF 2.0（.gltf + .bin / .glb）を Assimp を通さずに直接 ModelData にする
+// - バイナリ（GLB の BIN チャンク・外部 .bin）はメモリマップし、アクセサの範囲を
+//   コピーせずにそのまま読む。data: URI だけは展開する
+// - 左手系への変換（z の反転）と UV の反転は属性ごとにまとめて（SSE で）行う
+// - 結果は Assimp の Triangulate | ConvertToLeftHanded | GenSmoothNormals と同じ形
+//   （時計回り・ノード行列も鏡映、マテリアルの最後に既定マテリアルを足す）
+// - スキン・アニメーション・必須の拡張（圧縮など）・三角形以外のプリミティブは扱わない
+//   （false を返すので Assimp に任せる）
+// - 頂点の並べ替え等の最適化は呼び出し側（AssetLoader）で行う
+namespace GltfImporter {
+
+// flipU / flipV は Assimp 経由の時の UVFixupOptions と同じ（u = 1 - u, v = 1 - v）
+// 読めない・扱わない内容なら false（out は未定義）
+bool Import(const std::string &directoryPath, const std::string &filePath,
+            bool flipU, bool flipV, ModelData &out);
+
+} // namespace GltfImporter
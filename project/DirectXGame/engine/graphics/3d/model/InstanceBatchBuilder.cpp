@@ -0,0 +1,83 @@
+#include "InstanceBatchBuilder.h"
+#include "Method.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+// StructuredBuffer は 16 バイト境界でなくてもよいが、HLSL 側の並びと揃えるため確認しておく
+static_assert(sizeof(InstanceDataGPU) % 16 == 0);
+
+void InstanceBatchBuilder::Clear() {
+  entries_.clear();
+  sorted_.clear();
+  instances_.clear();
+  batches_.clear();
+}
+
+void InstanceBatchBuilder::Add(const void *key, uint32_t lod, bool wireframe,
+                               const Matrix4x4 &world,
+                               const Matrix4x4 &worldInverseTranspose,
+                               const InstanceMaterial &material) {
+  Entry e{};
+  e.key = key;
+  e.lod = lod;
+  e.wireframe = wireframe;
+  e.order = static_cast<uint32_t>(entries_.size());
+  e.world = world;
+  e.worldInverseTranspose = worldInverseTranspose;
+  e.material = material;
+  entries_.push_back(e);
+}
+
+void InstanceBatchBuilder::Build(const Matrix4x4 &viewProj) {
+  instances_.clear();
+  batches_.clear();
+
+  // 本体を動かさずインデックスだけ並べ替える（Entry は行列を4つ持つので重い）
+  sorted_.resize(entries_.size());
+  std::iota(sorted_.begin(), sorted_.end(), 0u);
+  std::sort(sorted_.begin(), sorted_.end(), [this](uint32_t a, uint32_t b) {
+    const Entry &ea = entries_[a];
+    const Entry &eb = entries_[b];
+    if (ea.wireframe != eb.wireframe) {
+      return !ea.wireframe;
+    }
+    if (ea.key != eb.key) {
+      return std::less<const void *>{}(ea.key, eb.key);
+    }
+    if (ea.lod != eb.lod) {
+      return ea.lod < eb.lod;
+    }
+    return ea.order < eb.order;
+  });
+
+  instances_.reserve(entries_.size());
+  for (uint32_t idx : sorted_) {
+    const Entry &e = entries_[idx];
+
+    if (batches_.empty() || batches_.back().key != e.key ||
+        batches_.back().lod != e.lod ||
+        batches_.back().wireframe != e.wireframe) {
+      Batch b{};
+      b.key = e.key;
+      b.lod = e.lod;
+      b.wireframe = e.wireframe;
+      b.firstInstance = static_cast<uint32_t>(instances_.size());
+      batches_.push_back(b);
+    }
+
+    InstanceDataGPU d{};
+    d.WVP = Multiply(e.world, viewProj);
+    d.World = e.world;
+    d.WorldInverseTranspose = e.worldInverseTranspose;
+    d.uvTransform = e.material.uvTransform;
+    d.color = e.material.color;
+    d.specularColor = e.material.specularColor;
+    d.shininess = e.material.shininess;
+    d.enableLighting = e.material.enableLighting;
+    instances_.push_back(d);
+    ++batches_.back().instanceCount;
+  }
+
+  entries_.clear();
+}
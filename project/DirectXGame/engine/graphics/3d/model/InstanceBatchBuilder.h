@@ -0,0 +1,75 @@
+#pragma once
+#include "Matrix.h"
+#include "Vector.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// インスタンシング描画用の1インスタンス分のデータ
+// - Object3dInstanced.VS.hlsl の InstanceData と並びを一致させる
+struct InstanceDataGPU {
+  Matrix4x4 WVP;
+  Matrix4x4 World;
+  Matrix4x4 WorldInverseTranspose;
+  Matrix4x4 uvTransform;
+  Vector4 color;
+  Vector3 specularColor;
+  float shininess;
+  int32_t enableLighting;
+  float pad[3];
+};
+
+// インスタンスごとのマテリアル（ModelInstance::MaterialCB の CPU 側コピーから詰める）
+struct InstanceMaterial {
+  Vector4 color{1, 1, 1, 1};
+  int32_t enableLighting = 1;
+  Vector3 specularColor{1.0f, 1.0f, 1.0f};
+  float shininess = 32.0f;
+  Matrix4x4 uvTransform{};
+};
+
+// 同じメッシュを共有するインスタンスをまとめるビルダー
+// - GPU に依存しない（キーは ModelResource* 等を不透明ポインタとして受け取る）
+// - Build 後、同じキー・同じ LOD・同じワイヤーフレーム設定のインスタンスが連続して並ぶ
+class InstanceBatchBuilder {
+public:
+  struct Batch {
+    const void *key = nullptr;
+    uint32_t lod = 0;
+    bool wireframe = false;
+    uint32_t firstInstance = 0;
+    uint32_t instanceCount = 0;
+  };
+
+  // 登録済みインスタンスを破棄（確保済み容量は残す）
+  void Clear();
+
+  void Add(const void *key, uint32_t lod, bool wireframe,
+           const Matrix4x4 &world, const Matrix4x4 &worldInverseTranspose,
+           const InstanceMaterial &material);
+
+  // キー順に並べ替え、WVP を計算して連続したインスタンス配列とバッチ列を作る
+  void Build(const Matrix4x4 &viewProj);
+
+  size_t GetPendingCount() const { return entries_.size(); }
+  const std::vector<InstanceDataGPU> &GetInstances() const {
+    return instances_;
+  }
+  const std::vector<Batch> &GetBatches() const { return batches_; }
+
+private:
+  struct Entry {
+    const void *key;
+    uint32_t lod;
+    bool wireframe;
+    uint32_t order; // 同じキー内では登録順を保つ
+    Matrix4x4 world;
+    Matrix4x4 worldInverseTranspose;
+    InstanceMaterial material;
+  };
+
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> sorted_;
+  std::vector<InstanceDataGPU> instances_;
+  std::vector<Batch> batches_;
+};
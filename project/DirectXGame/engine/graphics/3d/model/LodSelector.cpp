@@ -0,0 +1,57 @@
+#include "LodSelector.h"
+#include <algorithm>
+#include <limits>
+
+namespace LodSelector {
+
+float ProjectedRadius(const Vector3 &center, float radius,
+                      const Matrix4x4 &view, const Matrix4x4 &proj,
+                      float screenHeight) {
+  // ビュー空間の奥行き（球の手前側）
+  const float viewZ = center.x * view.m[0][2] + center.y * view.m[1][2] +
+                      center.z * view.m[2][2] + view.m[3][2];
+  const float nearZ = viewZ - radius;
+  if (nearZ <= 0.0f) {
+    return std::numeric_limits<float>::max();
+  }
+  // proj.m[1][1] = 1 / tan(fovY / 2)。画面の高さの半分が NDC の 1
+  return radius * proj.m[1][1] * 0.5f * screenHeight / nearZ;
+}
+
+uint32_t Select(const float *relativeErrors, uint32_t lodCount,
+                float projectedRadius, uint32_t currentLod,
+                const Settings &settings) {
+  if (lodCount <= 1) {
+    return 0;
+  }
+  currentLod = std::min(currentLod, lodCount - 1);
+  const float margin = 1.0f + settings.hysteresis;
+
+  // 余裕込みで許容内に収まる一番粗い LOD
+  uint32_t coarse = 0;
+  for (uint32_t i = 1; i < lodCount; ++i) {
+    if (relativeErrors[i] * projectedRadius * margin > settings.pixelError) {
+      break;
+    }
+    coarse = i;
+  }
+  if (coarse >= currentLod) {
+    return coarse;
+  }
+
+  // 細かい側へは、今の LOD が余裕を超えてずれる時だけ戻す
+  if (relativeErrors[currentLod] * projectedRadius <=
+      settings.pixelError * margin) {
+    return currentLod;
+  }
+  uint32_t fine = 0;
+  for (uint32_t i = 1; i < currentLod; ++i) {
+    if (relativeErrors[i] * projectedRadius > settings.pixelError) {
+      break;
+    }
+    fine = i;
+  }
+  return fine;
+}
+
+} // namespace LodSelector
@@ -0,0 +1,28 @@
+#pragma once
+#include "Matrix.h"
+#include "Vector.h"
+#include <cstdint>
+
+// 画面上の大きさから描画する LOD を選ぶ（GPU に依存しない）
+// - 投影した境界球の半径（ピクセル）× LOD の相対誤差 = 画面上のずれ（ピクセル）
+// - ずれが pixelError 以下の中で一番粗い LOD を選ぶ
+// - 切り替え付近でちらつかないよう、今の LOD から離れる時だけ hysteresis 分の余裕を要求する
+namespace LodSelector {
+
+struct Settings {
+  float pixelError = 1.0f; // 許容する画面上のずれ
+  float hysteresis = 0.25f; // 切り替えに要求する余裕（比）
+};
+
+// 境界球を投影した半径（ピクセル）。球の中にカメラがあれば非常に大きい値
+// center はワールド座標、view / proj は行ベクトル規約、screenHeight はピクセル
+float ProjectedRadius(const Vector3 &center, float radius,
+                      const Matrix4x4 &view, const Matrix4x4 &proj,
+                      float screenHeight);
+
+// relativeErrors[i] は LOD i の誤差 / 境界球の半径（LOD0 は 0、昇順）
+uint32_t Select(const float *relativeErrors, uint32_t lodCount,
+                float projectedRadius, uint32_t currentLod,
+                const Settings &settings);
+
+} // namespace LodSelector
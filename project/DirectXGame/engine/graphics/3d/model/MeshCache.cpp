@@ -0,0 +1,946 @@
+#include "MeshCache.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+// 配列をそのまま書き出すので、実行環境と形式のエンディアン・並びが一致している前提
+static_assert(std::endian::native == std::endian::little);
+static_assert(sizeof(VertexData) == 36);
+static_assert(std::is_trivially_copyable_v<VertexData>);
+static_assert(sizeof(Matrix4x4) == sizeof(float) * 16);
+static_assert(std::is_trivially_copyable_v<VertexInfluence>);
+static_assert(sizeof(AnimationTrack) == 28);
+static_assert(std::is_trivially_copyable_v<AnimationTrack>);
+
+namespace {
+
+constexpr uint32_t kMagic = 0x4D534843; // ファイル先頭が "CHSM"
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t importFlags;
+  uint32_t options;
+  uint64_t sourceHash;
+  uint64_t sourceStamp; // 元ファイル・依存ファイルの大きさと更新時刻（0 = 無し）
+  uint64_t fileSize;
+  uint32_t meshCount;
+  uint32_t materialCount;
+  uint32_t nodeCount; // NodeHierarchy の並び（親が先）
+  uint32_t nodeMeshIndexCount;
+  uint32_t stringBytes;
+  uint32_t jointCount;
+  float boundsMin[3];
+  float boundsMax[3];
+  // アニメーション（キーは全クリップぶんを連結）
+  uint32_t clipCount;
+  uint32_t trackCount;
+  uint32_t translationKeyCount;
+  uint32_t rotationKeyCount;
+  uint32_t scaleKeyCount;
+  uint32_t lodCount;     // 全メッシュの LOD の合計
+  uint32_t meshletCount; // 全メッシュのメッシュレットの合計
+  // 依存ファイルの一覧（文字列領域の中、'\n' 区切り）
+  uint32_t dependencyOffset;
+  uint32_t dependencyLength;
+  uint32_t reserved;
+};
+static_assert(sizeof(FileHeader) == 128);
+
+struct MeshRecord {
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  int32_t materialIndex;
+  uint32_t influenceCount; // 0 か vertexCount
+  uint32_t lodCount;       // LodRecord の数（LOD1 以降）
+  uint32_t meshletCount;
+};
+
+struct LodRecord {
+  uint32_t indexCount;
+  float error;
+};
+
+// Meshlet はそのまま書く
+static_assert(sizeof(Meshlet) == 52);
+static_assert(std::is_trivially_copyable_v<Meshlet>);
+
+struct JointRecord {
+  uint32_t node;
+  uint32_t reserved;
+  Matrix4x4 inverseBindMatrix;
+};
+static_assert(sizeof(JointRecord) == 72);
+
+// tracks / キーの範囲はこのクリップの先頭からの位置（AnimationClip と同じ）
+struct ClipRecord {
+  uint32_t nameOffset;
+  uint32_t nameLength;
+  float duration;
+  uint32_t trackFirst;
+  uint32_t trackCount;
+  uint32_t translationKeyFirst;
+  uint32_t translationKeyCount;
+  uint32_t rotationKeyFirst;
+  uint32_t rotationKeyCount;
+  uint32_t scaleKeyFirst;
+  uint32_t scaleKeyCount;
+  uint32_t reserved;
+};
+static_assert(sizeof(ClipRecord) == 48);
+
+struct MaterialRecord {
+  uint32_t pathOffset;
+  uint32_t pathLength;
+};
+
+struct NodeRecord {
+  Matrix4x4 localMatrix;
+  uint32_t nameOffset;
+  uint32_t nameLength;
+  uint32_t meshIndexFirst;
+  uint32_t meshIndexCount;
+  uint32_t parentIndex; // NodeHierarchy::kNone = ルート
+  uint32_t reserved;
+};
+static_assert(sizeof(NodeRecord) == 88);
+
+// ===== 書き出し =====
+
+struct Writer {
+  std::vector<MeshRecord> meshes;
+  std::vector<LodRecord> lods;
+  std::vector<MaterialRecord> materials;
+  std::vector<NodeRecord> nodes;
+  std::vector<uint32_t> nodeMeshIndices;
+  std::vector<JointRecord> joints;
+  std::vector<ClipRecord> clips;
+  std::vector<AnimationTrack> tracks;
+  std::vector<float> translationTimes;
+  std::vector<Vector3> translationKeys;
+  std::vector<float> rotationTimes;
+  std::vector<PackedQuaternion> rotationKeys;
+  std::vector<float> scaleTimes;
+  std::vector<Vector3> scaleKeys;
+  std::string strings;
+
+  uint32_t AddString(const std::string &s, uint32_t &outLength) {
+    const uint32_t offset = static_cast<uint32_t>(strings.size());
+    strings += s;
+    outLength = static_cast<uint32_t>(s.size());
+    return offset;
+  }
+
+  void AddNodes(const NodeHierarchy &hierarchy) {
+    nodes.reserve(hierarchy.GetCount());
+    for (uint32_t i = 0; i < hierarchy.GetCount(); ++i) {
+      const std::span<const uint32_t> meshIndices = hierarchy.GetMeshIndices(i);
+      NodeRecord r{};
+      r.localMatrix = hierarchy.GetLocalMatrix(i);
+      r.nameOffset = AddString(hierarchy.GetName(i), r.nameLength);
+      r.meshIndexFirst = static_cast<uint32_t>(nodeMeshIndices.size());
+      r.meshIndexCount = static_cast<uint32_t>(meshIndices.size());
+      r.parentIndex = hierarchy.GetParent(i);
+      nodeMeshIndices.insert(nodeMeshIndices.end(), meshIndices.begin(),
+                             meshIndices.end());
+      nodes.push_back(r);
+    }
+  }
+
+  void AddClips(const std::vector<AnimationClip> &animations) {
+    for (const AnimationClip &clip : animations) {
+      ClipRecord r{};
+      r.nameOffset = AddString(clip.name, r.nameLength);
+      r.duration = clip.duration;
+      r.trackFirst = static_cast<uint32_t>(tracks.size());
+      r.trackCount = static_cast<uint32_t>(clip.tracks.size());
+      r.translationKeyFirst = static_cast<uint32_t>(translationKeys.size());
+      r.translationKeyCount = static_cast<uint32_t>(clip.translationKeys.size());
+      r.rotationKeyFirst = static_cast<uint32_t>(rotationKeys.size());
+      r.rotationKeyCount = static_cast<uint32_t>(clip.rotationKeys.size());
+      r.scaleKeyFirst = static_cast<uint32_t>(scaleKeys.size());
+      r.scaleKeyCount = static_cast<uint32_t>(clip.scaleKeys.size());
+      clips.push_back(r);
+
+      tracks.insert(tracks.end(), clip.tracks.begin(), clip.tracks.end());
+      translationTimes.insert(translationTimes.end(),
+                              clip.translationTimes.begin(),
+                              clip.translationTimes.end());
+      translationKeys.insert(translationKeys.end(),
+                             clip.translationKeys.begin(),
+                             clip.translationKeys.end());
+      rotationTimes.insert(rotationTimes.end(), clip.rotationTimes.begin(),
+                           clip.rotationTimes.end());
+      rotationKeys.insert(rotationKeys.end(), clip.rotationKeys.begin(),
+                          clip.rotationKeys.end());
+      scaleTimes.insert(scaleTimes.end(), clip.scaleTimes.begin(),
+                        clip.scaleTimes.end());
+      scaleKeys.insert(scaleKeys.end(), clip.scaleKeys.begin(),
+                       clip.scaleKeys.end());
+    }
+  }
+};
+
+template <class T>
+void WriteArray(std::ofstream &ofs, const T *data, size_t count) {
+  if (count > 0) {
+    ofs.write(reinterpret_cast<const char *>(data),
+              static_cast<std::streamsize>(sizeof(T) * count));
+  }
+}
+
+// ===== 読み込み =====
+
+// マップした領域を先頭から読む（範囲外は失敗にする）
+class Reader {
+public:
+  Reader(const uint8_t *data, size_t size) : data_(data), size_(size) {}
+
+  // 4 バイト境界の保証がないので memcpy で写す
+  template <class T> bool ReadArray(T *out, size_t count) {
+    if (count > (size_ - offset_) / sizeof(T)) {
+      return false;
+    }
+    if (count > 0) {
+      std::memcpy(out, data_ + offset_, sizeof(T) * count);
+    }
+    offset_ += sizeof(T) * count;
+    return true;
+  }
+
+  template <class T> bool ReadVector(std::vector<T> &out, size_t count) {
+    if (count > (size_ - offset_) / sizeof(T)) {
+      return false;
+    }
+    out.resize(count);
+    return ReadArray(out.data(), count);
+  }
+
+  const uint8_t *Current() const { return data_ + offset_; }
+  size_t Remaining() const { return size_ - offset_; }
+
+private:
+  const uint8_t *data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+bool BuildNodes(const std::vector<NodeRecord> &records,
+                const std::vector<uint32_t> &meshIndices, const char *strings,
+                size_t stringBytes, size_t meshCount, NodeHierarchy &out) {
+  out.Clear();
+  out.Reserve(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    const NodeRecord &r = records[i];
+    // 親は自分より前（NodeHierarchy の前提）
+    if (r.nameOffset > stringBytes || r.nameLength > stringBytes - r.nameOffset ||
+        r.meshIndexFirst > meshIndices.size() ||
+        r.meshIndexCount > meshIndices.size() - r.meshIndexFirst ||
+        (r.parentIndex != NodeHierarchy::kNone && r.parentIndex >= i)) {
+      return false;
+    }
+    const auto first = meshIndices.begin() + r.meshIndexFirst;
+    const auto last = first + r.meshIndexCount;
+    if (std::any_of(first, last, [&](uint32_t m) { return m >= meshCount; })) {
+      return false;
+    }
+    out.AddNode(r.parentIndex,
+                std::string_view(strings + r.nameOffset, r.nameLength),
+                r.localMatrix,
+                std::span<const uint32_t>(meshIndices)
+                    .subspan(r.meshIndexFirst, r.meshIndexCount));
+  }
+  out.UpdateGlobalMatrices();
+  return true;
+}
+
+// times が range 内で減っていないか
+bool IsSortedRange(const std::vector<float> &times,
+                   const AnimationKeyRange &range, size_t keyCount) {
+  if (range.first > keyCount || range.count > keyCount - range.first) {
+    return false;
+  }
+  return std::is_sorted(times.begin() + range.first,
+                        times.begin() + range.first + range.count);
+}
+
+// 連結されたトラック・キーをクリップごとに切り分ける
+bool BuildClips(const std::vector<ClipRecord> &records,
+                const std::vector<AnimationTrack> &tracks,
+                const std::vector<float> &translationTimes,
+                const std::vector<Vector3> &translationKeys,
+                const std::vector<float> &rotationTimes,
+                const std::vector<PackedQuaternion> &rotationKeys,
+                const std::vector<float> &scaleTimes,
+                const std::vector<Vector3> &scaleKeys, const char *strings,
+                uint32_t stringBytes, uint32_t nodeCount,
+                std::vector<AnimationClip> &out) {
+  // 範囲 [first, first + count) が size に収まるか
+  const auto inside = [](uint32_t first, uint32_t count, size_t size) {
+    return first <= size && count <= size - first;
+  };
+
+  out.resize(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    const ClipRecord &r = records[i];
+    if (!inside(r.nameOffset, r.nameLength, stringBytes) ||
+        !inside(r.trackFirst, r.trackCount, tracks.size()) ||
+        !inside(r.translationKeyFirst, r.translationKeyCount,
+                translationKeys.size()) ||
+        !inside(r.rotationKeyFirst, r.rotationKeyCount, rotationKeys.size()) ||
+        !inside(r.scaleKeyFirst, r.scaleKeyCount, scaleKeys.size()) ||
+        !(r.duration >= 0.0f)) {
+      return false;
+    }
+
+    AnimationClip &clip = out[i];
+    clip.name.assign(strings + r.nameOffset, r.nameLength);
+    clip.duration = r.duration;
+    clip.tracks.assign(tracks.begin() + r.trackFirst,
+                       tracks.begin() + r.trackFirst + r.trackCount);
+
+    const auto slice = [](const auto &src, uint32_t first, uint32_t count,
+                          auto &dst) {
+      dst.assign(src.begin() + first, src.begin() + first + count);
+    };
+    slice(translationTimes, r.translationKeyFirst, r.translationKeyCount,
+          clip.translationTimes);
+    slice(translationKeys, r.translationKeyFirst, r.translationKeyCount,
+          clip.translationKeys);
+    slice(rotationTimes, r.rotationKeyFirst, r.rotationKeyCount,
+          clip.rotationTimes);
+    slice(rotationKeys, r.rotationKeyFirst, r.rotationKeyCount,
+          clip.rotationKeys);
+    slice(scaleTimes, r.scaleKeyFirst, r.scaleKeyCount, clip.scaleTimes);
+    slice(scaleKeys, r.scaleKeyFirst, r.scaleKeyCount, clip.scaleKeys);
+
+    for (const AnimationTrack &track : clip.tracks) {
+      if (track.node >= nodeCount ||
+          !IsSortedRange(clip.translationTimes, track.translation,
+                         clip.translationKeys.size()) ||
+          !IsSortedRange(clip.rotationTimes, track.rotation,
+                         clip.rotationKeys.size()) ||
+          !IsSortedRange(clip.scaleTimes, track.scale,
+                         clip.scaleKeys.size())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// ===== 依存ファイル =====
+
+std::string_view TrimView(std::string_view s) {
+  const size_t first = s.find_first_not_of(" \t\r");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const size_t last = s.find_last_not_of(" \t\r");
+  return s.substr(first, last - first + 1);
+}
+
+// OBJ: 行頭の mtllib の残り全体（ObjImporter と同じ読み方）
+void ScanObjDependencies(std::string_view text, std::vector<std::string> &out) {
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t lineEnd = text.find('\n', pos);
+    if (lineEnd == std::string_view::npos) {
+      lineEnd = text.size();
+    }
+    const std::string_view line = TrimView(text.substr(pos, lineEnd - pos));
+    if (line.size() > 6 && line.substr(0, 6) == "mtllib" &&
+        (line[6] == ' ' || line[6] == '\t')) {
+      const std::string_view name = TrimView(line.substr(6));
+      if (!name.empty()) {
+        out.emplace_back(name);
+      }
+    }
+    pos = lineEnd + 1;
+  }
+}
+
+// JSON の文字列（p は '"' の位置）。エスケープは \uXXXX 以外だけ戻す
+bool ReadJsonString(std::string_view text, size_t &p, std::string &out) {
+  out.clear();
+  for (++p; p < text.size(); ++p) {
+    const char c = text[p];
+    if (c == '"') {
+      ++p;
+      return true;
+    }
+    if (c == '\\' && p + 1 < text.size()) {
+      const char e = text[++p];
+      out += e == 'n' ? '\n' : e == 't' ? '\t' : e;
+    } else {
+      out += c;
+    }
+  }
+  return false;
+}
+
+size_t SkipJsonSpace(std::string_view text, size_t p) {
+  while (p < text.size() &&
+         (text[p] == ' ' || text[p] == '\t' || text[p] == '\r' ||
+          text[p] == '\n')) {
+    ++p;
+  }
+  return p;
+}
+
+// URI の %XX を戻す
+std::string DecodeUri(const std::string &uri) {
+  std::string out;
+  for (size_t i = 0; i < uri.size(); ++i) {
+    if (uri[i] == '%' && i + 2 < uri.size() &&
+        std::isxdigit(static_cast<unsigned char>(uri[i + 1])) &&
+        std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+      out += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+      i += 2;
+    } else {
+      out += uri[i];
+    }
+  }
+  return out;
+}
+
+// glTF: buffers 配列の中の外部 uri（data: の埋め込みは除く。画像は取り込み結果に効かない）
+void ScanGltfDependencies(std::string_view json, std::vector<std::string> &out) {
+  int depth = 0;
+  int buffersDepth = -1; // buffers 配列の中の深さ（-1 = 外）
+  std::string token;
+  std::string value;
+  for (size_t p = 0; p < json.size();) {
+    const char c = json[p];
+    if (c == '"') {
+      if (!ReadJsonString(json, p, token)) {
+        return;
+      }
+      const size_t colon = SkipJsonSpace(json, p);
+      if (colon >= json.size() || json[colon] != ':') {
+        continue; // 値の文字列
+      }
+      const size_t next = SkipJsonSpace(json, colon + 1);
+      if (buffersDepth < 0 && depth == 1 && token == "buffers" &&
+          next < json.size() && json[next] == '[') {
+        buffersDepth = depth + 1;
+      } else if (buffersDepth >= 0 && depth == buffersDepth + 1 &&
+                 token == "uri" && next < json.size() && json[next] == '"') {
+        p = next;
+        if (!ReadJsonString(json, p, value)) {
+          return;
+        }
+        if (value.compare(0, 5, "data:") != 0) {
+          out.push_back(DecodeUri(value));
+        }
+        continue;
+      }
+      p = colon + 1;
+      continue;
+    }
+    if (c == '{' || c == '[') {
+      ++depth;
+    } else if (c == '}' || c == ']') {
+      --depth;
+      if (depth < buffersDepth) {
+        return; // buffers 配列を抜けた
+      }
+    }
+    ++p;
+  }
+}
+
+std::string ToLowerExtension(const std::filesystem::path &path) {
+  std::string ext = path.extension().string();
+  for (char &ch : ext) {
+    ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+  }
+  return ext;
+}
+
+std::vector<std::string> ScanDependencies(const std::string &sourcePath,
+                                          const MappedFile &file) {
+  std::vector<std::string> deps;
+  const std::string ext = ToLowerExtension(sourcePath);
+  const std::string_view text(reinterpret_cast<const char *>(file.GetData()),
+                              file.GetSize());
+  if (ext == ".obj") {
+    ScanObjDependencies(text, deps);
+  } else if (ext == ".gltf") {
+    ScanGltfDependencies(text, deps);
+  } else if (ext == ".glb" && text.size() >= 20 &&
+             text.substr(0, 4) == "glTF") {
+    // 最初のチャンクが JSON
+    uint32_t jsonLength = 0;
+    std::memcpy(&jsonLength, text.data() + 12, sizeof(jsonLength));
+    ScanGltfDependencies(text.substr(20, jsonLength), deps);
+  }
+  return deps;
+}
+
+std::filesystem::path ResolveDependency(const std::string &sourcePath,
+                                        const std::string &dependency) {
+  return std::filesystem::path(sourcePath).parent_path() /
+         std::filesystem::path(dependency);
+}
+
+// 元ファイルと依存ファイルの大きさ・更新時刻をまとめた値。元ファイルが無ければ 0
+uint64_t ComputeStamp(const std::string &sourcePath,
+                      const std::vector<std::string> &dependencies) {
+  std::vector<int64_t> values;
+  values.reserve(2 + dependencies.size() * 2);
+  const auto add = [&values](const std::filesystem::path &path) {
+    std::error_code ec;
+    const uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec) {
+      values.push_back(-1);
+      values.push_back(0);
+      return false;
+    }
+    const auto time = std::filesystem::last_write_time(path, ec);
+    values.push_back(static_cast<int64_t>(size));
+    values.push_back(ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count()));
+    return true;
+  };
+  if (!add(sourcePath)) {
+    return 0;
+  }
+  for (const std::string &dep : dependencies) {
+    add(ResolveDependency(sourcePath, dep));
+  }
+  const uint64_t stamp =
+      MeshCache::HashBytes(values.data(), values.size() * sizeof(int64_t));
+  return stamp != 0 ? stamp : 1;
+}
+
+std::string JoinDependencies(const std::vector<std::string> &dependencies) {
+  std::string joined;
+  for (const std::string &dep : dependencies) {
+    if (!joined.empty()) {
+      joined += '\n';
+    }
+    joined += dep;
+  }
+  return joined;
+}
+
+std::vector<std::string> SplitDependencies(std::string_view joined) {
+  std::vector<std::string> deps;
+  size_t pos = 0;
+  while (pos < joined.size()) {
+    size_t end = joined.find('\n', pos);
+    if (end == std::string_view::npos) {
+      end = joined.size();
+    }
+    deps.emplace_back(joined.substr(pos, end - pos));
+    pos = end + 1;
+  }
+  return deps;
+}
+
+} // namespace
+
+namespace MeshCache {
+
+uint64_t HashBytes(const void *data, size_t size) {
+  // FNV-1a を 8 バイト単位・4 系列に広げたもの（元ファイルは数十 MB になるので
+  // 1 バイトずつだとキャッシュ読み込みより遅くなる）
+  constexpr uint64_t kPrime = 0x100000001B3ull;
+  const auto *p = static_cast<const uint8_t *>(data);
+  uint64_t lanes[4] = {0xCBF29CE484222325ull, 0x84222325CBF29CE4ull,
+                       0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full};
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    for (int l = 0; l < 4; ++l) {
+      uint64_t word;
+      std::memcpy(&word, p + i + l * 8, sizeof(word));
+      lanes[l] = (lanes[l] ^ word) * kPrime;
+      lanes[l] ^= lanes[l] >> 29;
+    }
+  }
+  uint64_t hash = lanes[0];
+  for (int l = 1; l < 4; ++l) {
+    hash = (hash ^ lanes[l]) * kPrime;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ p[i]) * kPrime;
+  }
+  return (hash ^ static_cast<uint64_t>(size)) * kPrime;
+}
+
+bool HashFile(const std::string &path, uint64_t &outHash) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    return false;
+  }
+  outHash = HashBytes(file.GetData(), file.GetSize());
+  return true;
+}
+
+std::vector<std::string> ListDependencies(const std::string &sourcePath) {
+  MappedFile file;
+  if (!file.Open(sourcePath)) {
+    return {};
+  }
+  return ScanDependencies(sourcePath, file);
+}
+
+bool HashSources(const std::string &sourcePath, uint64_t &outHash) {
+  MappedFile file;
+  if (!file.Open(sourcePath)) {
+    return false;
+  }
+  std::vector<uint64_t> hashes;
+  hashes.push_back(HashBytes(file.GetData(), file.GetSize()));
+  for (const std::string &dep : ScanDependencies(sourcePath, file)) {
+    // 名前も入れる（参照先の差し替え・無いファイルも区別する）
+    hashes.push_back(HashBytes(dep.data(), dep.size()));
+    MappedFile depFile;
+    hashes.push_back(
+        depFile.Open(ResolveDependency(sourcePath, dep).string())
+            ? HashBytes(depFile.GetData(), depFile.GetSize())
+            : 0);
+  }
+  // 依存ファイルが無い時は元ファイルのハッシュそのもの（HashFile と同じ値）
+  outHash = hashes.size() == 1
+                ? hashes[0]
+                : HashBytes(hashes.data(), hashes.size() * sizeof(uint64_t));
+  return true;
+}
+
+std::string MakeCachePath(const std::string &sourcePath) {
+  return sourcePath + ".meshcache";
+}
+
+AABB ComputeBounds(const ModelData &model) {
+  constexpr float kMax = std::numeric_limits<float>::max();
+  AABB b{{kMax, kMax, kMax}, {-kMax, -kMax, -kMax}};
+  bool any = false;
+  for (const MeshData &mesh : model.meshes) {
+    for (const VertexData &v : mesh.vertices) {
+      b.min.x = std::min(b.min.x, v.position.x);
+      b.min.y = std::min(b.min.y, v.position.y);
+      b.min.z = std::min(b.min.z, v.position.z);
+      b.max.x = std::max(b.max.x, v.position.x);
+      b.max.y = std::max(b.max.y, v.position.y);
+      b.max.z = std::max(b.max.z, v.position.z);
+      any = true;
+    }
+  }
+  return any ? b : AABB{};
+}
+
+bool Save(const std::string &cachePath, const std::string &sourcePath,
+          const CookKey &key, const ModelData &model) {
+  Writer w;
+  w.meshes.reserve(model.meshes.size());
+  for (const MeshData &mesh : model.meshes) {
+    MeshRecord r{};
+    r.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+    r.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    r.materialIndex = mesh.materialIndex;
+    r.influenceCount = static_cast<uint32_t>(mesh.influences.size());
+    r.lodCount = static_cast<uint32_t>(mesh.lods.size());
+    r.meshletCount = static_cast<uint32_t>(mesh.meshlets.size());
+    w.meshes.push_back(r);
+    for (const MeshLod &lod : mesh.lods) {
+      w.lods.push_back({static_cast<uint32_t>(lod.indices.size()), lod.error});
+    }
+  }
+  w.materials.reserve(model.materials.size());
+  for (const MaterialData &mat : model.materials) {
+    MaterialRecord r{};
+    r.pathOffset = w.AddString(mat.textureFilePath, r.pathLength);
+    w.materials.push_back(r);
+  }
+  w.AddNodes(model.nodes);
+  w.joints.reserve(model.joints.size());
+  for (const SkinJoint &joint : model.joints) {
+    JointRecord r{};
+    r.node = joint.node;
+    r.inverseBindMatrix = joint.inverseBindMatrix;
+    w.joints.push_back(r);
+  }
+  w.AddClips(model.animations);
+  const std::vector<std::string> dependencies = ListDependencies(sourcePath);
+  uint32_t dependencyLength = 0;
+  const uint32_t dependencyOffset =
+      w.AddString(JoinDependencies(dependencies), dependencyLength);
+
+  FileHeader h{};
+  h.magic = kMagic;
+  h.version = kVersion;
+  h.importFlags = key.importFlags;
+  h.options = key.options;
+  h.sourceHash = key.sourceHash;
+  h.sourceStamp = ComputeStamp(sourcePath, dependencies);
+  h.dependencyOffset = dependencyOffset;
+  h.dependencyLength = dependencyLength;
+  h.meshCount = static_cast<uint32_t>(w.meshes.size());
+  h.materialCount = static_cast<uint32_t>(w.materials.size());
+  h.nodeCount = static_cast<uint32_t>(w.nodes.size());
+  h.nodeMeshIndexCount = static_cast<uint32_t>(w.nodeMeshIndices.size());
+  h.stringBytes = static_cast<uint32_t>(w.strings.size());
+  h.jointCount = static_cast<uint32_t>(w.joints.size());
+  h.clipCount = static_cast<uint32_t>(w.clips.size());
+  h.trackCount = static_cast<uint32_t>(w.tracks.size());
+  h.translationKeyCount = static_cast<uint32_t>(w.translationKeys.size());
+  h.rotationKeyCount = static_cast<uint32_t>(w.rotationKeys.size());
+  h.scaleKeyCount = static_cast<uint32_t>(w.scaleKeys.size());
+  h.lodCount = static_cast<uint32_t>(w.lods.size());
+  h.boundsMin[0] = model.bounds.min.x;
+  h.boundsMin[1] = model.bounds.min.y;
+  h.boundsMin[2] = model.bounds.min.z;
+  h.boundsMax[0] = model.bounds.max.x;
+  h.boundsMax[1] = model.bounds.max.y;
+  h.boundsMax[2] = model.bounds.max.z;
+
+  uint64_t fileSize = sizeof(FileHeader) +
+                      sizeof(MeshRecord) * w.meshes.size() +
+                      sizeof(LodRecord) * w.lods.size() +
+                      sizeof(MaterialRecord) * w.materials.size() +
+                      sizeof(NodeRecord) * w.nodes.size() +
+                      sizeof(uint32_t) * w.nodeMeshIndices.size() +
+                      sizeof(JointRecord) * w.joints.size() +
+                      sizeof(ClipRecord) * w.clips.size() +
+                      sizeof(AnimationTrack) * w.tracks.size() +
+                      (sizeof(float) + sizeof(Vector3)) *
+                          w.translationKeys.size() +
+                      (sizeof(float) + sizeof(PackedQuaternion)) *
+                          w.rotationKeys.size() +
+                      (sizeof(float) + sizeof(Vector3)) * w.scaleKeys.size() +
+                      w.strings.size();
+  for (const MeshData &mesh : model.meshes) {
+    fileSize += sizeof(VertexData) * mesh.vertices.size() +
+                sizeof(uint32_t) * mesh.indices.size() +
+                sizeof(VertexInfluence) * mesh.influences.size();
+    for (const MeshLod &lod : mesh.lods) {
+      fileSize += sizeof(uint32_t) * lod.indices.size();
+    }
+    fileSize += sizeof(Meshlet) * mesh.meshlets.size();
+    h.meshletCount += static_cast<uint32_t>(mesh.meshlets.size());
+  }
+  h.fileSize = fileSize;
+
+  const std::string tempPath = cachePath + ".tmp";
+  {
+    std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+      return false;
+    }
+    WriteArray(ofs, &h, 1);
+    WriteArray(ofs, w.meshes.data(), w.meshes.size());
+    WriteArray(ofs, w.lods.data(), w.lods.size());
+    WriteArray(ofs, w.materials.data(), w.materials.size());
+    WriteArray(ofs, w.nodes.data(), w.nodes.size());
+    WriteArray(ofs, w.nodeMeshIndices.data(), w.nodeMeshIndices.size());
+    WriteArray(ofs, w.joints.data(), w.joints.size());
+    WriteArray(ofs, w.clips.data(), w.clips.size());
+    WriteArray(ofs, w.tracks.data(), w.tracks.size());
+    WriteArray(ofs, w.translationTimes.data(), w.translationTimes.size());
+    WriteArray(ofs, w.translationKeys.data(), w.translationKeys.size());
+    WriteArray(ofs, w.rotationTimes.data(), w.rotationTimes.size());
+    WriteArray(ofs, w.rotationKeys.data(), w.rotationKeys.size());
+    WriteArray(ofs, w.scaleTimes.data(), w.scaleTimes.size());
+    WriteArray(ofs, w.scaleKeys.data(), w.scaleKeys.size());
+    for (const MeshData &mesh : model.meshes) {
+      WriteArray(ofs, mesh.vertices.data(), mesh.vertices.size());
+      WriteArray(ofs, mesh.indices.data(), mesh.indices.size());
+      WriteArray(ofs, mesh.influences.data(), mesh.influences.size());
+      for (const MeshLod &lod : mesh.lods) {
+        WriteArray(ofs, lod.indices.data(), lod.indices.size());
+      }
+      WriteArray(ofs, mesh.meshlets.data(), mesh.meshlets.size());
+    }
+    WriteArray(ofs, w.strings.data(), w.strings.size());
+    if (!ofs) {
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tempPath, cachePath, ec);
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+  return true;
+}
+
+bool Load(const std::string &cachePath, const std::string &sourcePath,
+          const CookKey &key, ModelData &out) {
+  MappedFile file;
+  if (!file.Open(cachePath)) {
+    return false;
+  }
+  Reader r(file.GetData(), file.GetSize());
+
+  FileHeader h{};
+  if (!r.ReadArray(&h, 1) || h.magic != kMagic || h.version != kVersion ||
+      h.fileSize != file.GetSize() || h.importFlags != key.importFlags ||
+      h.options != key.options || h.nodeCount == 0 ||
+      h.stringBytes > file.GetSize() - sizeof(FileHeader) ||
+      h.dependencyOffset > h.stringBytes ||
+      h.dependencyLength > h.stringBytes - h.dependencyOffset) {
+    return false;
+  }
+  if (key.sourceHash != 0) {
+    if (h.sourceHash != key.sourceHash) {
+      return false;
+    }
+  } else {
+    // 文字列領域はファイルの末尾。依存ファイルの一覧だけ先に見る
+    const char *dependencyText = reinterpret_cast<const char *>(
+        file.GetData() + file.GetSize() - h.stringBytes + h.dependencyOffset);
+    const std::vector<std::string> dependencies = SplitDependencies(
+        std::string_view(dependencyText, h.dependencyLength));
+    if (h.sourceStamp == 0 ||
+        h.sourceStamp != ComputeStamp(sourcePath, dependencies)) {
+      return false;
+    }
+  }
+
+  std::vector<MeshRecord> meshes;
+  std::vector<LodRecord> lods;
+  std::vector<MaterialRecord> materials;
+  std::vector<NodeRecord> nodes;
+  std::vector<uint32_t> nodeMeshIndices;
+  std::vector<JointRecord> joints;
+  std::vector<ClipRecord> clips;
+  std::vector<AnimationTrack> tracks;
+  std::vector<float> translationTimes;
+  std::vector<Vector3> translationKeys;
+  std::vector<float> rotationTimes;
+  std::vector<PackedQuaternion> rotationKeys;
+  std::vector<float> scaleTimes;
+  std::vector<Vector3> scaleKeys;
+  if (!r.ReadVector(meshes, h.meshCount) ||
+      !r.ReadVector(lods, h.lodCount) ||
+      !r.ReadVector(materials, h.materialCount) ||
+      !r.ReadVector(nodes, h.nodeCount) ||
+      !r.ReadVector(nodeMeshIndices, h.nodeMeshIndexCount) ||
+      !r.ReadVector(joints, h.jointCount) ||
+      !r.ReadVector(clips, h.clipCount) ||
+      !r.ReadVector(tracks, h.trackCount) ||
+      !r.ReadVector(translationTimes, h.translationKeyCount) ||
+      !r.ReadVector(translationKeys, h.translationKeyCount) ||
+      !r.ReadVector(rotationTimes, h.rotationKeyCount) ||
+      !r.ReadVector(rotationKeys, h.rotationKeyCount) ||
+      !r.ReadVector(scaleTimes, h.scaleKeyCount) ||
+      !r.ReadVector(scaleKeys, h.scaleKeyCount)) {
+    return false;
+  }
+
+  out.joints.resize(joints.size());
+  for (size_t i = 0; i < joints.size(); ++i) {
+    if (joints[i].node >= h.nodeCount) {
+      return false;
+    }
+    out.joints[i].node = joints[i].node;
+    out.joints[i].inverseBindMatrix = joints[i].inverseBindMatrix;
+  }
+
+  out.meshes.resize(meshes.size());
+  size_t lodFirst = 0;
+  uint64_t meshletTotal = 0;
+  for (size_t i = 0; i < meshes.size(); ++i) {
+    MeshData &mesh = out.meshes[i];
+    mesh.materialIndex = meshes[i].materialIndex;
+    if (mesh.materialIndex >= static_cast<int32_t>(h.materialCount) ||
+        !r.ReadVector(mesh.vertices, meshes[i].vertexCount) ||
+        !r.ReadVector(mesh.indices, meshes[i].indexCount)) {
+      return false;
+    }
+    for (uint32_t index : mesh.indices) {
+      if (index >= meshes[i].vertexCount) {
+        return false;
+      }
+    }
+    // スキンありのモデルは全頂点にジョイントの割り当てが要る
+    const uint32_t influenceCount =
+        joints.empty() ? 0 : meshes[i].vertexCount;
+    if (meshes[i].influenceCount != influenceCount ||
+        !r.ReadVector(mesh.influences, influenceCount)) {
+      return false;
+    }
+    for (const VertexInfluence &inf : mesh.influences) {
+      for (uint16_t joint : inf.joints) {
+        if (joint >= h.jointCount) {
+          return false;
+        }
+      }
+    }
+
+    if (meshes[i].lodCount > lods.size() - lodFirst) {
+      return false;
+    }
+    mesh.lods.resize(meshes[i].lodCount);
+    for (MeshLod &lod : mesh.lods) {
+      const LodRecord &lr = lods[lodFirst++];
+      lod.error = lr.error;
+      if (lr.indexCount % 3 != 0 ||
+          !r.ReadVector(lod.indices, lr.indexCount)) {
+        return false;
+      }
+      for (uint32_t index : lod.indices) {
+        if (index >= meshes[i].vertexCount) {
+          return false;
+        }
+      }
+    }
+
+    if (!r.ReadVector(mesh.meshlets, meshes[i].meshletCount)) {
+      return false;
+    }
+    for (const Meshlet &meshlet : mesh.meshlets) {
+      if (meshlet.indexStart % 3 != 0 || meshlet.indexCount % 3 != 0 ||
+          static_cast<uint64_t>(meshlet.indexStart) + meshlet.indexCount >
+              meshes[i].indexCount) {
+        return false;
+      }
+    }
+    meshletTotal += meshes[i].meshletCount;
+  }
+  if (lodFirst != lods.size() || meshletTotal != h.meshletCount) {
+    return false;
+  }
+
+  if (r.Remaining() != h.stringBytes) {
+    return false;
+  }
+  const char *strings = reinterpret_cast<const char *>(r.Current());
+
+  out.materials.resize(materials.size());
+  for (size_t i = 0; i < materials.size(); ++i) {
+    const MaterialRecord &m = materials[i];
+    if (m.pathOffset > h.stringBytes ||
+        m.pathLength > h.stringBytes - m.pathOffset) {
+      return false;
+    }
+    out.materials[i].textureFilePath.assign(strings + m.pathOffset,
+                                            m.pathLength);
+  }
+
+  if (!BuildNodes(nodes, nodeMeshIndices, strings, h.stringBytes,
+                  meshes.size(), out.nodes)) {
+    return false;
+  }
+  if (!BuildClips(clips, tracks, translationTimes, translationKeys,
+                  rotationTimes, rotationKeys, scaleTimes, scaleKeys, strings,
+                  h.stringBytes, h.nodeCount, out.animations)) {
+    return false;
+  }
+
+  out.bounds.min = {h.boundsMin[0], h.boundsMin[1], h.boundsMin[2]};
+  out.bounds.max = {h.boundsMax[0], h.boundsMax[1], h.boundsMax[2]};
+  return true;
+}
+
+} // namespace MeshCache
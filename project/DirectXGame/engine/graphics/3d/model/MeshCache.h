@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ModelData.h"
+
+// 取り込み済み ModelData のバイナリキャッシュ（Assimp を通さずに読み込むため）
+// - リトルエンディアン・4 バイト境界。頂点/インデックス配列はそのまま memcpy できる並び
+// - 読み込みはファイルをメモリマップして配列を写すだけ（文字列の解析はしない）
+// - ヘッダの CookKey（元ファイルと依存ファイルの中身のハッシュ + 取り込みフラグ）と
+//   kVersion が一致しなければ無効として扱い、呼び出し側で作り直す
+// - 保存時の元ファイル・依存ファイルの大きさと更新時刻も持ち、変わっていなければ
+//   中身をハッシュせずに読める
+namespace MeshCache {
+
+// 形式や取り込み処理（MeshOptimizer 等）を変えたら上げる
+constexpr uint32_t kVersion = 8;
+
+struct CookKey {
+  uint64_t sourceHash = 0;  // HashSources。0 なら大きさ・更新時刻で比べる
+  uint32_t importFlags = 0; // aiPostProcessSteps
+  uint32_t options = 0;     // エンジン側の変換（UV 反転など）
+};
+
+uint64_t HashBytes(const void *data, size_t size);
+
+// 元ファイルの中身をハッシュする。読めなければ false
+bool HashFile(const std::string &path, uint64_t &outHash);
+
+// 取り込み結果に効く、元ファイルが参照するファイル（OBJ の mtllib・glTF の外部バッファ）
+// 元ファイルのフォルダからの相対パスで、書かれている順
+std::vector<std::string> ListDependencies(const std::string &sourcePath);
+
+// 元ファイルと依存ファイルの中身をまとめてハッシュする
+// 元ファイルが読めなければ false（依存ファイルは無くてもよい。無いことも値に入る）
+bool HashSources(const std::string &sourcePath, uint64_t &outHash);
+
+// 元ファイルの隣に置くキャッシュのパス
+std::string MakeCachePath(const std::string &sourcePath);
+
+// 一時ファイルに書いてから置き換えるので、途中で落ちても壊れたキャッシュは残らない
+// sourcePath の依存ファイルの一覧と、今の大きさ・更新時刻も一緒に書く
+bool Save(const std::string &cachePath, const std::string &sourcePath,
+          const CookKey &key, const ModelData &model);
+
+// キャッシュが無い・古い・壊れている場合は false（out は未定義）
+// key.sourceHash が 0 なら、元ファイル・依存ファイルの大きさと更新時刻が保存時と
+// 同じ時だけ読む（チェックアウトし直して時刻だけ変わった等はハッシュを渡して読み直す）
+bool Load(const std::string &cachePath, const std::string &sourcePath,
+          const CookKey &key, ModelData &out);
+
+// 全メッシュの頂点から bounds を求める
+AABB ComputeBounds(const ModelData &model);
+
+} // namespace MeshCache
@@ -0,0 +1,135 @@
+#include "MeshMerger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+#include "MeshletBuilder.h"
+
+namespace MeshMerger {
+
+namespace {
+
+bool HasAnyMeshlets(const ModelData &model) {
+  for (const MeshData &m : model.meshes) {
+    if (!m.meshlets.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// lod 段目（1 始まり）のインデックス。段が無ければ一番粗い段（LOD 無しなら LOD0）
+const MeshLod *FindLod(const MeshData &m, size_t lod) {
+  return m.lods.empty() ? nullptr : &m.lods[std::min(lod, m.lods.size()) - 1];
+}
+
+} // namespace
+
+void MergeByMaterial(ModelData &model) {
+  std::vector<uint32_t> order(model.meshes.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return model.meshes[a].materialIndex < model.meshes[b].materialIndex;
+  });
+
+  const bool meshlets = HasAnyMeshlets(model);
+  const bool skinned = !model.joints.empty();
+  // 元のメッシュ番号 → まとめた後の番号（消したものは kNone）
+  std::vector<uint32_t> remap(model.meshes.size(), NodeHierarchy::kNone);
+  std::vector<MeshData> merged;
+
+  for (size_t begin = 0; begin < order.size();) {
+    const int material = model.meshes[order[begin]].materialIndex;
+    size_t end = begin;
+    size_t lodCount = 0;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    while (end < order.size() &&
+           model.meshes[order[end]].materialIndex == material) {
+      const MeshData &m = model.meshes[order[end]];
+      if (!m.indices.empty()) {
+        lodCount = std::max(lodCount, m.lods.size());
+        vertexCount += m.vertices.size();
+        indexCount += m.indices.size();
+      }
+      ++end;
+    }
+    if (indexCount == 0) {
+      begin = end;
+      continue;
+    }
+
+    MeshData out;
+    out.materialIndex = material;
+    out.vertices.reserve(vertexCount);
+    out.indices.reserve(indexCount);
+    out.lods.resize(lodCount);
+    if (skinned) {
+      out.influences.reserve(vertexCount);
+    }
+    for (size_t i = begin; i < end; ++i) {
+      MeshData &m = model.meshes[order[i]];
+      if (m.indices.empty()) {
+        continue;
+      }
+      remap[order[i]] = static_cast<uint32_t>(merged.size());
+      const uint32_t base = static_cast<uint32_t>(out.vertices.size());
+      const uint32_t indexBase = static_cast<uint32_t>(out.indices.size());
+
+      if (meshlets && m.meshlets.empty()) {
+        m.meshlets.push_back(MeshletBuilder::ComputeBounds(
+            m.indices, 0, static_cast<uint32_t>(m.indices.size()), m.vertices));
+      }
+      for (Meshlet meshlet : m.meshlets) {
+        meshlet.indexStart += indexBase;
+        out.meshlets.push_back(meshlet);
+      }
+      for (uint32_t index : m.indices) {
+        out.indices.push_back(base + index);
+      }
+      for (size_t lod = 1; lod <= lodCount; ++lod) {
+        const MeshLod *src = FindLod(m, lod);
+        MeshLod &dst = out.lods[lod - 1];
+        for (uint32_t index : src ? src->indices : m.indices) {
+          dst.indices.push_back(base + index);
+        }
+        if (src) {
+          dst.error = std::max(dst.error, src->error);
+        }
+      }
+      out.vertices.insert(out.vertices.end(), m.vertices.begin(),
+                          m.vertices.end());
+      if (skinned) {
+        assert(m.influences.size() == m.vertices.size());
+        out.influences.insert(out.influences.end(), m.influences.begin(),
+                              m.influences.end());
+      }
+    }
+    merged.push_back(std::move(out));
+    begin = end;
+  }
+  model.meshes = std::move(merged);
+
+  // ノードのメッシュ番号を書き換える（同じメッシュにまとまった分は 1 つに）
+  const NodeHierarchy source = model.nodes;
+  model.nodes.Clear();
+  model.nodes.Reserve(source.GetCount());
+  std::vector<uint32_t> meshIndices;
+  for (uint32_t node = 0; node < source.GetCount(); ++node) {
+    meshIndices.clear();
+    for (uint32_t mesh : source.GetMeshIndices(node)) {
+      const uint32_t to = remap[mesh];
+      if (to != NodeHierarchy::kNone &&
+          std::find(meshIndices.begin(), meshIndices.end(), to) ==
+              meshIndices.end()) {
+        meshIndices.push_back(to);
+      }
+    }
+    model.nodes.AddNode(source.GetParent(node), source.GetName(node),
+                        source.GetLocalMatrix(node), meshIndices);
+  }
+  model.nodes.UpdateGlobalMatrices();
+}
+
+} // namespace MeshMerger
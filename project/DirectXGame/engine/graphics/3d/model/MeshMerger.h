@@ -0,0 +1,15 @@
+#pragma once
+
+#include "ModelData.h"
+
+// 取り込み後（キャッシュへ書き出す前）に同じマテリアルのメッシュを 1 つにまとめる
+// - マテリアルの番号順に並べ、同じマテリアル内は元の順で頂点・インデックスを連結する
+// - LOD は段ごとに連結する（段の足りないメッシュは一番粗い段。誤差は段ごとの最大）
+// - どれかのメッシュがメッシュレットを持つなら、持たないメッシュは全体を 1 つの塊にする
+// - インデックスの無いメッシュは消し、ノードのメッシュ番号も書き換える
+// 頂点はメッシュ空間のまま（ノードの変換は掛けない。描画側も掛けていない）
+namespace MeshMerger {
+
+void MergeByMaterial(ModelData &model);
+
+} // namespace MeshMerger
@@ -0,0 +1,342 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// ===== Forsyth のスコア関数 =====
+// LRU キャッシュを模した大きさ（実 GPU より大きめにして先読み的に振る舞わせる）
+constexpr int kForsythCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+float VertexScore(int cachePosition, uint32_t remainingTriangles) {
+  if (remainingTriangles == 0) {
+    return -1.0f;
+  }
+  float score = 0.0f;
+  if (cachePosition >= 0) {
+    if (cachePosition < 3) {
+      // 直前の三角形の頂点は、続けて使うとストリップ的になり過ぎるので固定値
+      score = kLastTriScore;
+    } else {
+      const float scaler = 1.0f / static_cast<float>(kForsythCacheSize - 3);
+      score = 1.0f - static_cast<float>(cachePosition - 3) * scaler;
+      score = std::pow(score, kCacheDecayPower);
+    }
+  }
+  // 残り三角形の少ない頂点を優先して早く使い切る
+  score += kValenceBoostScale *
+           std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+  return score;
+}
+
+// FIFO キャッシュのシミュレーション（タイムスタンプ方式）
+class FifoCache {
+public:
+  FifoCache(size_t vertexCount, uint32_t cacheSize)
+      : stamps_(vertexCount, 0), cacheSize_(cacheSize) {}
+
+  void Reset() { time_ += cacheSize_ + 1; }
+
+  // ミスなら true
+  bool Touch(uint32_t v) {
+    if (time_ - stamps_[v] > cacheSize_) {
+      stamps_[v] = time_++;
+      return true;
+    }
+    return false;
+  }
+
+  uint32_t TouchTriangle(const uint32_t *tri) {
+    return uint32_t(Touch(tri[0])) + uint32_t(Touch(tri[1])) +
+           uint32_t(Touch(tri[2]));
+  }
+
+private:
+  std::vector<uint64_t> stamps_;
+  uint64_t time_ = ~0u; // stamps_ の初期値 0 が必ずミスになるよう大きく始める
+  uint64_t cacheSize_;
+};
+
+} // namespace
+
+namespace MeshOptimizer {
+
+float ComputeACMR(const std::vector<uint32_t> &indices, size_t vertexCount,
+                  uint32_t cacheSize) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0) {
+    return 0.0f;
+  }
+  FifoCache cache(vertexCount, cacheSize);
+  uint64_t misses = 0;
+  for (size_t t = 0; t < triangleCount; ++t) {
+    misses += cache.TouchTriangle(&indices[t * 3]);
+  }
+  return static_cast<float>(misses) / static_cast<float>(triangleCount);
+}
+
+void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0) {
+    return;
+  }
+
+  // 頂点 → 三角形の隣接表（CSR）
+  std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+  for (uint32_t v : indices) {
+    assert(v < vertexCount);
+    ++adjacencyOffset[v + 1];
+  }
+  for (size_t v = 0; v < vertexCount; ++v) {
+    adjacencyOffset[v + 1] += adjacencyOffset[v];
+  }
+  std::vector<uint32_t> adjacency(indices.size());
+  {
+    std::vector<uint32_t> cursor(adjacencyOffset.begin(),
+                                 adjacencyOffset.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+      for (size_t e = 0; e < 3; ++e) {
+        adjacency[cursor[indices[t * 3 + e]]++] = static_cast<uint32_t>(t);
+      }
+    }
+  }
+
+  // 頂点の状態
+  std::vector<uint32_t> remaining(vertexCount);
+  std::vector<int> cachePosition(vertexCount, -1);
+  std::vector<float> vertexScore(vertexCount);
+  for (size_t v = 0; v < vertexCount; ++v) {
+    remaining[v] = adjacencyOffset[v + 1] - adjacencyOffset[v];
+    vertexScore[v] = VertexScore(-1, remaining[v]);
+  }
+
+  std::vector<uint8_t> emitted(triangleCount, 0);
+
+  std::vector<uint32_t> result;
+  result.reserve(indices.size());
+
+  // キャッシュは新しい順。追加した 3 頂点ぶんはみ出せるよう余裕を持たせる
+  std::vector<uint32_t> cache;
+  std::vector<uint32_t> nextCache;
+  cache.reserve(kForsythCacheSize + 3);
+  nextCache.reserve(kForsythCacheSize + 3);
+
+  size_t scanCursor = 0;
+  uint32_t best = ~0u;
+
+  for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+    if (best == ~0u) {
+      // キャッシュ内に候補が無ければ未出力の三角形から拾う
+      while (emitted[scanCursor]) {
+        ++scanCursor;
+      }
+      best = static_cast<uint32_t>(scanCursor);
+    }
+
+    const uint32_t *tri = &indices[best * 3];
+    result.insert(result.end(), tri, tri + 3);
+    emitted[best] = 1;
+
+    // 出力した三角形を各頂点の隣接から外す
+    for (size_t e = 0; e < 3; ++e) {
+      const uint32_t v = tri[e];
+      uint32_t *begin = &adjacency[adjacencyOffset[v]];
+      uint32_t *end = begin + remaining[v];
+      uint32_t *it = std::find(begin, end, best);
+      assert(it != end);
+      *it = *(end - 1);
+      --remaining[v];
+    }
+
+    // キャッシュを更新（今の 3 頂点を先頭へ）
+    nextCache.assign(tri, tri + 3);
+    for (uint32_t v : cache) {
+      if (v != tri[0] && v != tri[1] && v != tri[2]) {
+        nextCache.push_back(v);
+      }
+    }
+    std::swap(cache, nextCache);
+
+    // キャッシュ内（と今回追い出された）頂点のスコアを更新
+    for (size_t i = 0; i < cache.size(); ++i) {
+      const uint32_t v = cache[i];
+      cachePosition[v] =
+          i < static_cast<size_t>(kForsythCacheSize) ? static_cast<int>(i) : -1;
+      vertexScore[v] = VertexScore(cachePosition[v], remaining[v]);
+    }
+
+    // キャッシュ内の頂点を使う未出力の三角形から次の最良を探す
+    best = ~0u;
+    float bestScore = -1.0f;
+    for (size_t i = 0; i < cache.size(); ++i) {
+      const uint32_t v = cache[i];
+      const uint32_t *adj = &adjacency[adjacencyOffset[v]];
+      for (uint32_t k = 0; k < remaining[v]; ++k) {
+        const uint32_t t = adj[k];
+        const float score = vertexScore[indices[t * 3]] +
+                            vertexScore[indices[t * 3 + 1]] +
+                            vertexScore[indices[t * 3 + 2]];
+        if (score > bestScore) {
+          bestScore = score;
+          best = t;
+        }
+      }
+    }
+
+    if (cache.size() > static_cast<size_t>(kForsythCacheSize)) {
+      cache.resize(kForsythCacheSize);
+    }
+  }
+
+  indices.swap(result);
+}
+
+void OptimizeOverdraw(std::vector<uint32_t> &indices, const float *positions,
+                      size_t positionStride, size_t vertexCount,
+                      float threshold) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount < 2 || !positions) {
+    return;
+  }
+
+  auto position = [&](uint32_t v) {
+    return reinterpret_cast<const float *>(
+        reinterpret_cast<const uint8_t *>(positions) + v * positionStride);
+  };
+
+  // 1) 3 頂点すべてミス = キャッシュの流れが途切れた所を大きな境界にする
+  FifoCache cache(vertexCount, kFifoCacheSize);
+  std::vector<uint32_t> hardBoundaries;
+  for (size_t t = 0; t < triangleCount; ++t) {
+    if (cache.TouchTriangle(&indices[t * 3]) == 3 || t == 0) {
+      hardBoundaries.push_back(static_cast<uint32_t>(t));
+    }
+  }
+  hardBoundaries.push_back(static_cast<uint32_t>(triangleCount));
+
+  // 2) 各区間をさらに、途中から始め直しても ACMR が threshold 倍以内に収まる所で切る
+  std::vector<uint32_t> clusters;
+  for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h) {
+    const uint32_t begin = hardBoundaries[h];
+    const uint32_t end = hardBoundaries[h + 1];
+
+    cache.Reset();
+    uint32_t clusterMisses = 0;
+    for (uint32_t t = begin; t < end; ++t) {
+      clusterMisses += cache.TouchTriangle(&indices[t * 3]);
+    }
+    const float limit = threshold * static_cast<float>(clusterMisses) /
+                        static_cast<float>(end - begin);
+
+    cache.Reset();
+    clusters.push_back(begin);
+    uint32_t runningMisses = 0;
+    uint32_t runningTriangles = 0;
+    for (uint32_t t = begin; t < end; ++t) {
+      runningMisses += cache.TouchTriangle(&indices[t * 3]);
+      ++runningTriangles;
+      if (t + 1 < end && static_cast<float>(runningMisses) <=
+                             limit * static_cast<float>(runningTriangles)) {
+        clusters.push_back(t + 1);
+        cache.Reset();
+        runningMisses = 0;
+        runningTriangles = 0;
+      }
+    }
+  }
+  const size_t clusterCount = clusters.size();
+  clusters.push_back(static_cast<uint32_t>(triangleCount));
+  if (clusterCount < 2) {
+    return;
+  }
+
+  // 3) メッシュ中心から見て外向きのクラスタほど先に描く
+  float meshCenter[3] = {0, 0, 0};
+  {
+    double sum[3] = {0, 0, 0};
+    for (uint32_t v : indices) {
+      const float *p = position(v);
+      sum[0] += p[0];
+      sum[1] += p[1];
+      sum[2] += p[2];
+    }
+    for (int k = 0; k < 3; ++k) {
+      meshCenter[k] = static_cast<float>(sum[k] / double(indices.size()));
+    }
+  }
+
+  std::vector<float> sortKey(clusterCount);
+  for (size_t c = 0; c < clusterCount; ++c) {
+    float center[3] = {0, 0, 0};
+    float normal[3] = {0, 0, 0};
+    float area = 0.0f;
+    for (uint32_t t = clusters[c]; t < clusters[c + 1]; ++t) {
+      const float *p0 = position(indices[t * 3]);
+      const float *p1 = position(indices[t * 3 + 1]);
+      const float *p2 = position(indices[t * 3 + 2]);
+      const float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+      const float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+      // 面積で重み付けした法線（外積の長さ = 面積 × 2）
+      const float n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                          e1[2] * e2[0] - e1[0] * e2[2],
+                          e1[0] * e2[1] - e1[1] * e2[0]};
+      const float a = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      for (int k = 0; k < 3; ++k) {
+        center[k] += (p0[k] + p1[k] + p2[k]) * (a / 3.0f);
+        normal[k] += n[k];
+      }
+      area += a;
+    }
+    if (area > 0.0f) {
+      for (int k = 0; k < 3; ++k) {
+        center[k] /= area;
+      }
+    }
+    const float len = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] +
+                                normal[2] * normal[2]);
+    float dot = 0.0f;
+    if (len > 0.0f) {
+      for (int k = 0; k < 3; ++k) {
+        dot += (center[k] - meshCenter[k]) * (normal[k] / len);
+      }
+    }
+    sortKey[c] = dot;
+  }
+
+  std::vector<uint32_t> order(clusterCount);
+  for (size_t c = 0; c < clusterCount; ++c) {
+    order[c] = static_cast<uint32_t>(c);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return sortKey[a] > sortKey[b];
+  });
+
+  std::vector<uint32_t> result;
+  result.reserve(indices.size());
+  for (uint32_t c : order) {
+    result.insert(result.end(), indices.begin() + clusters[c] * 3,
+                  indices.begin() + clusters[c + 1] * 3);
+  }
+  indices.swap(result);
+}
+
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t> &indices,
+                                          size_t vertexCount) {
+  std::vector<uint32_t> remap(vertexCount, ~0u);
+  uint32_t next = 0;
+  for (uint32_t &v : indices) {
+    assert(v < vertexCount);
+    if (remap[v] == ~0u) {
+      remap[v] = next++;
+    }
+    v = remap[v];
+  }
+  return remap;
+}
+
+} // namespace MeshOptimizer
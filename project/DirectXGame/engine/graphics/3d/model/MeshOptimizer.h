@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// インデックス付き三角形リストの並べ替え（GPU に依存しない）
+// - OptimizeVertexCache: Forsyth の線形時間アルゴリズムで頂点キャッシュのヒット率を上げる
+// - OptimizeOverdraw: キャッシュ順を崩しすぎない範囲でクラスタに切り、
+//   外側を向いたクラスタから描くよう並べ替える（Sander らの Tipsify 系）
+// - OptimizeVertexFetch: 頂点をインデックスの初出順に詰め、頂点フェッチを連続にする
+// 推奨順序は Cache → Overdraw → Fetch
+namespace MeshOptimizer {
+
+// ACMR の計測に使う FIFO キャッシュの大きさ（一般的な GPU の後変換キャッシュ相当）
+constexpr uint32_t kFifoCacheSize = 16;
+
+// 三角形あたりの平均キャッシュミス数（0.5〜3.0。小さいほど良い）
+float ComputeACMR(const std::vector<uint32_t> &indices, size_t vertexCount,
+                  uint32_t cacheSize = kFifoCacheSize);
+
+void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+
+// positions は頂点ごとに先頭 3 float が位置、positionStride バイト間隔
+// threshold はクラスタ分割で許容する ACMR の悪化率
+void OptimizeOverdraw(std::vector<uint32_t> &indices, const float *positions,
+                      size_t positionStride, size_t vertexCount,
+                      float threshold = 1.05f);
+
+// indices を新しい頂点番号に書き換え、旧番号 → 新番号の表を返す
+// 参照されない頂点は ~0u。戻り値の新番号の最大 + 1 が詰めた後の頂点数
+std::vector<uint32_t> OptimizeVertexFetch(std::vector<uint32_t> &indices,
+                                          size_t vertexCount);
+
+// remap に従って頂点配列を詰め直す
+template <class Vertex>
+std::vector<Vertex> RemapVertices(const std::vector<Vertex> &vertices,
+                                  const std::vector<uint32_t> &remap) {
+  size_t count = 0;
+  for (uint32_t r : remap) {
+    if (r != ~0u && r + 1 > count) {
+      count = r + 1;
+    }
+  }
+  std::vector<Vertex> out(count);
+  for (size_t i = 0; i < remap.size(); ++i) {
+    if (remap[i] != ~0u) {
+      out[remap[i]] = vertices[i];
+    }
+  }
+  return out;
+}
+
+} // namespace MeshOptimizer
@@ -0,0 +1,476 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+namespace {
+
+// 平面 ax + by + cz + d = 0 までの二乗距離の和（対称 4x4 の上三角 10 要素）
+struct Quadric {
+  double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0,
+         cd = 0, d2 = 0;
+
+  void AddPlane(double a, double b, double c, double d) {
+    a2 += a * a;
+    ab += a * b;
+    ac += a * c;
+    ad += a * d;
+    b2 += b * b;
+    bc += b * c;
+    bd += b * d;
+    c2 += c * c;
+    cd += c * d;
+    d2 += d * d;
+  }
+  void Add(const Quadric &q) {
+    a2 += q.a2;
+    ab += q.ab;
+    ac += q.ac;
+    ad += q.ad;
+    b2 += q.b2;
+    bc += q.bc;
+    bd += q.bd;
+    c2 += q.c2;
+    cd += q.cd;
+    d2 += q.d2;
+  }
+  double Evaluate(double x, double y, double z) const {
+    const double e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z +
+                     2 * ad * x + b2 * y * y + 2 * bc * y * z + 2 * bd * y +
+                     c2 * z * z + 2 * cd * z + d2;
+    return std::max(e, 0.0);
+  }
+};
+
+struct Vec3d {
+  double x, y, z;
+};
+
+Vec3d Sub(const Vec3d &a, const Vec3d &b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+Vec3d Cross(const Vec3d &a, const Vec3d &b) {
+  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z,
+          a.x * b.y - a.y * b.x};
+}
+double Dot(const Vec3d &a, const Vec3d &b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// 縮約の候補（from の位置を to へ寄せる）
+struct Collapse {
+  double cost;
+  uint32_t from;
+  uint32_t to;
+  uint32_t fromVersion;
+  uint32_t toVersion;
+  bool operator>(const Collapse &o) const { return cost > o.cost; }
+};
+
+// 同じ位置の頂点（法線違いなど）の代表を 1 つ決めて縮約する
+// 以下「点」は代表頂点の番号、「頂点」は元の頂点の番号
+class Simplifier {
+public:
+  Simplifier(const std::vector<uint32_t> &indices,
+             const std::vector<VertexData> &vertices)
+      : vertices_(vertices) {
+    const size_t vertexCount = vertices.size();
+    point_.resize(vertexCount);
+    WeldPositions_();
+
+    triangles_.reserve(indices.size() / 3);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+      const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+      // 位置がつぶれている三角形は面積 0 なので最初から落とす
+      if (point_[a] == point_[b] || point_[b] == point_[c] ||
+          point_[c] == point_[a]) {
+        continue;
+      }
+      triangles_.push_back({a, b, c});
+    }
+    alive_.assign(triangles_.size(), 1);
+    liveCount_ = triangles_.size();
+
+    adjacency_.resize(vertexCount);
+    quadrics_.resize(vertexCount);
+    locked_.assign(vertexCount, 0);
+    removed_.assign(vertexCount, 0);
+    version_.assign(vertexCount, 0);
+
+    for (uint32_t t = 0; t < triangles_.size(); ++t) {
+      const Vec3d p0 = Position_(point_[triangles_[t][0]]);
+      const Vec3d p1 = Position_(point_[triangles_[t][1]]);
+      const Vec3d p2 = Position_(point_[triangles_[t][2]]);
+      Vec3d n = Cross(Sub(p1, p0), Sub(p2, p0));
+      const double len = std::sqrt(Dot(n, n));
+      for (uint32_t v : triangles_[t]) {
+        adjacency_[point_[v]].push_back(t);
+      }
+      if (len <= 0.0) {
+        continue;
+      }
+      n = {n.x / len, n.y / len, n.z / len};
+      for (uint32_t v : triangles_[t]) {
+        quadrics_[point_[v]].AddPlane(n.x, n.y, n.z, -Dot(n, p0));
+      }
+    }
+
+    LockBordersAndSeams_();
+
+    // 初期候補: 全ての辺の両向き
+    for (const auto &[key, count] : edgeCounts_) {
+      (void)count;
+      const uint32_t a = static_cast<uint32_t>(key >> 32);
+      const uint32_t b = static_cast<uint32_t>(key);
+      PushCandidate_(a, b);
+      PushCandidate_(b, a);
+    }
+  }
+
+  // 続けて呼ぶと前回の結果からさらに間引く（誤差は元の形に対する値のまま）
+  // outCost はこれまでに縮約した中で最大の誤差（二乗）
+  std::vector<uint32_t> Run(size_t targetIndexCount, double maxCost,
+                            double &outCost) {
+    while (liveCount_ * 3 > targetIndexCount && !heap_.empty()) {
+      const Collapse c = heap_.top();
+      heap_.pop();
+      if (removed_[c.from] || removed_[c.to] ||
+          version_[c.from] != c.fromVersion || version_[c.to] != c.toVersion) {
+        continue;
+      }
+      if (c.cost > maxCost) {
+        heap_.push(c);
+        break;
+      }
+      if (!CanCollapse_(c.from, c.to)) {
+        continue;
+      }
+      Apply_(c.from, c.to);
+      maxCost_ = std::max(maxCost_, c.cost);
+
+      // to の周りの辺は誤差が変わったので積み直す
+      CollectNeighbors_(c.to, neighbors_);
+      for (uint32_t n : neighbors_) {
+        PushCandidate_(c.to, n);
+        PushCandidate_(n, c.to);
+      }
+    }
+
+    outCost = maxCost_;
+    std::vector<uint32_t> result;
+    result.reserve(liveCount_ * 3);
+    for (size_t t = 0; t < triangles_.size(); ++t) {
+      if (alive_[t]) {
+        result.insert(result.end(), triangles_[t].begin(),
+                      triangles_[t].end());
+      }
+    }
+    return result;
+  }
+
+private:
+  using Triangle = std::array<uint32_t, 3>;
+
+  Vec3d Position_(uint32_t v) const {
+    const Vector4 &p = vertices_[v].position;
+    return {p.x, p.y, p.z};
+  }
+
+  void WeldPositions_() {
+    // 位置のビット列が一致するものを同じ点にする
+    struct Key {
+      uint32_t x, y, z;
+      bool operator==(const Key &o) const {
+        return x == o.x && y == o.y && z == o.z;
+      }
+    };
+    struct KeyHash {
+      size_t operator()(const Key &k) const {
+        return (k.x * 73856093u) ^ (k.y * 19349663u) ^ (k.z * 83492791u);
+      }
+    };
+    std::unordered_map<Key, uint32_t, KeyHash> map;
+    map.reserve(vertices_.size());
+    wedges_.resize(vertices_.size());
+    for (uint32_t v = 0; v < vertices_.size(); ++v) {
+      Key k{};
+      std::memcpy(&k.x, &vertices_[v].position.x, sizeof(float));
+      std::memcpy(&k.y, &vertices_[v].position.y, sizeof(float));
+      std::memcpy(&k.z, &vertices_[v].position.z, sizeof(float));
+      const auto [it, inserted] = map.try_emplace(k, v);
+      point_[v] = it->second;
+      wedges_[it->second].push_back(v);
+    }
+  }
+
+  static uint64_t EdgeKey_(uint32_t a, uint32_t b) {
+    if (a > b) {
+      std::swap(a, b);
+    }
+    return (static_cast<uint64_t>(a) << 32) | b;
+  }
+
+  void LockBordersAndSeams_() {
+    for (const Triangle &tri : triangles_) {
+      for (int e = 0; e < 3; ++e) {
+        ++edgeCounts_[EdgeKey_(point_[tri[e]], point_[tri[(e + 1) % 3]])];
+      }
+    }
+    // 1 枚しか使わない辺 = 開いた縁、3 枚以上 = 非多様体
+    for (const auto &[key, count] : edgeCounts_) {
+      if (count != 2) {
+        locked_[static_cast<uint32_t>(key >> 32)] = 1;
+        locked_[static_cast<uint32_t>(key)] = 1;
+      }
+    }
+    // UV の継ぎ目（同じ位置に UV の違う頂点がある）
+    constexpr float kUvEpsilon = 1.0e-5f;
+    for (uint32_t p = 0; p < wedges_.size(); ++p) {
+      const std::vector<uint32_t> &w = wedges_[p];
+      for (size_t i = 1; i < w.size(); ++i) {
+        const Vector2 &a = vertices_[w[0]].texcoord;
+        const Vector2 &b = vertices_[w[i]].texcoord;
+        if (std::fabs(a.x - b.x) > kUvEpsilon ||
+            std::fabs(a.y - b.y) > kUvEpsilon) {
+          locked_[p] = 1;
+          break;
+        }
+      }
+    }
+  }
+
+  void PushCandidate_(uint32_t from, uint32_t to) {
+    if (locked_[from]) {
+      return;
+    }
+    Quadric q = quadrics_[from];
+    q.Add(quadrics_[to]);
+    const Vec3d p = Position_(to);
+    heap_.push({q.Evaluate(p.x, p.y, p.z), from, to, version_[from],
+                version_[to]});
+  }
+
+  bool Contains_(uint32_t t, uint32_t point) const {
+    const Triangle &tri = triangles_[t];
+    return point_[tri[0]] == point || point_[tri[1]] == point ||
+           point_[tri[2]] == point;
+  }
+
+  void CollectNeighbors_(uint32_t point, std::vector<uint32_t> &out) const {
+    out.clear();
+    for (uint32_t t : adjacency_[point]) {
+      if (!alive_[t]) {
+        continue;
+      }
+      for (uint32_t v : triangles_[t]) {
+        if (point_[v] != point) {
+          out.push_back(point_[v]);
+        }
+      }
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+  }
+
+  bool CanCollapse_(uint32_t from, uint32_t to) {
+    // 共有する三角形の数 = 両端の共通の隣接点の数 でなければ、縮約で面が重なる
+    uint32_t shared = 0;
+    for (uint32_t t : adjacency_[from]) {
+      if (alive_[t] && Contains_(t, to)) {
+        ++shared;
+      }
+    }
+    if (shared == 0) {
+      return false;
+    }
+    CollectNeighbors_(from, neighbors_);
+    CollectNeighbors_(to, otherNeighbors_);
+    size_t common = 0;
+    for (size_t i = 0, j = 0;
+         i < neighbors_.size() && j < otherNeighbors_.size();) {
+      if (neighbors_[i] < otherNeighbors_[j]) {
+        ++i;
+      } else if (otherNeighbors_[j] < neighbors_[i]) {
+        ++j;
+      } else {
+        ++common;
+        ++i;
+        ++j;
+      }
+    }
+    if (common != shared) {
+      return false;
+    }
+
+    // 残る三角形が裏返ったり潰れたりしないか
+    const Vec3d target = Position_(to);
+    for (uint32_t t : adjacency_[from]) {
+      if (!alive_[t] || Contains_(t, to)) {
+        continue;
+      }
+      Vec3d p[3];
+      Vec3d q[3];
+      for (int c = 0; c < 3; ++c) {
+        const uint32_t point = point_[triangles_[t][c]];
+        p[c] = Position_(point);
+        q[c] = (point == from) ? target : p[c];
+      }
+      const Vec3d before = Cross(Sub(p[1], p[0]), Sub(p[2], p[0]));
+      const Vec3d after = Cross(Sub(q[1], q[0]), Sub(q[2], q[0]));
+      const double lenBefore = std::sqrt(Dot(before, before));
+      const double lenAfter = std::sqrt(Dot(after, after));
+      if (lenAfter <= 1.0e-12 * (lenBefore + 1.0) ||
+          Dot(before, after) < 0.2 * lenBefore * lenAfter) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // to の頂点のうち、UV と法線が vertex に一番近いもの
+  uint32_t NearestWedge_(uint32_t vertex, uint32_t to) const {
+    const VertexData &s = vertices_[vertex];
+    uint32_t best = to;
+    float bestScore = std::numeric_limits<float>::max();
+    for (uint32_t w : wedges_[to]) {
+      const VertexData &d = vertices_[w];
+      const float du = s.texcoord.x - d.texcoord.x;
+      const float dv = s.texcoord.y - d.texcoord.y;
+      const float dn = s.normal.x * d.normal.x + s.normal.y * d.normal.y +
+                       s.normal.z * d.normal.z;
+      const float score = (du * du + dv * dv) * 1.0e4f + (1.0f - dn);
+      if (score < bestScore) {
+        bestScore = score;
+        best = w;
+      }
+    }
+    return best;
+  }
+
+  void Apply_(uint32_t from, uint32_t to) {
+    for (uint32_t t : adjacency_[from]) {
+      if (!alive_[t]) {
+        continue;
+      }
+      if (Contains_(t, to)) {
+        alive_[t] = 0;
+        --liveCount_;
+        continue;
+      }
+      for (uint32_t &v : triangles_[t]) {
+        if (point_[v] == from) {
+          v = NearestWedge_(v, to);
+        }
+      }
+      adjacency_[to].push_back(t);
+    }
+    adjacency_[from].clear();
+    std::vector<uint32_t> &list = adjacency_[to];
+    list.erase(std::remove_if(list.begin(), list.end(),
+                              [this](uint32_t t) { return !alive_[t]; }),
+               list.end());
+
+    quadrics_[to].Add(quadrics_[from]);
+    removed_[from] = 1;
+    ++version_[to];
+  }
+
+  const std::vector<VertexData> &vertices_;
+  std::vector<uint32_t> point_;                // 頂点 → 代表点
+  std::vector<std::vector<uint32_t>> wedges_;  // 代表点 → 同じ位置の頂点
+  std::vector<Triangle> triangles_;            // 元の頂点番号
+  std::vector<uint8_t> alive_;
+  size_t liveCount_ = 0;
+  std::vector<std::vector<uint32_t>> adjacency_; // 代表点 → 三角形
+  std::vector<Quadric> quadrics_;
+  std::vector<uint8_t> locked_;
+  std::vector<uint8_t> removed_;
+  std::vector<uint32_t> version_; // 縮約で誤差が変わるたびに上げる
+  double maxCost_ = 0.0;
+  std::unordered_map<uint64_t, uint32_t> edgeCounts_;
+  std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>>
+      heap_;
+  std::vector<uint32_t> neighbors_;
+  std::vector<uint32_t> otherNeighbors_;
+};
+
+} // namespace
+
+namespace MeshSimplifier {
+
+std::vector<uint32_t> Simplify(const std::vector<uint32_t> &indices,
+                               const std::vector<VertexData> &vertices,
+                               size_t targetIndexCount, float maxError,
+                               float *outError) {
+  Simplifier simplifier(indices, vertices);
+  double cost = 0.0;
+  const double maxCost = static_cast<double>(maxError) * maxError;
+  std::vector<uint32_t> result =
+      simplifier.Run(targetIndexCount, maxCost, cost);
+  if (outError) {
+    *outError = static_cast<float>(std::sqrt(cost));
+  }
+  return result;
+}
+
+std::vector<MeshLod> BuildLodChain(const std::vector<uint32_t> &indices,
+                                   const std::vector<VertexData> &vertices,
+                                   const LodChainSettings &settings) {
+  std::vector<MeshLod> lods;
+  if (vertices.empty() || indices.size() < 3) {
+    return lods;
+  }
+
+  Vector3 mn{vertices[0].position.x, vertices[0].position.y,
+             vertices[0].position.z};
+  Vector3 mx = mn;
+  for (const VertexData &v : vertices) {
+    mn = {std::min(mn.x, v.position.x), std::min(mn.y, v.position.y),
+          std::min(mn.z, v.position.z)};
+    mx = {std::max(mx.x, v.position.x), std::max(mx.y, v.position.y),
+          std::max(mx.z, v.position.z)};
+  }
+  const float dx = mx.x - mn.x, dy = mx.y - mn.y, dz = mx.z - mn.z;
+  const float maxError =
+      settings.maxRelativeError * std::sqrt(dx * dx + dy * dy + dz * dz);
+
+  // 1 つの Simplifier で段ごとに目標を下げていく（縮約の候補を作り直さずに済む）
+  Simplifier simplifier(indices, vertices);
+  const double maxCost = static_cast<double>(maxError) * maxError;
+  const size_t minIndices = static_cast<size_t>(settings.minTriangles) * 3;
+  size_t previous = indices.size();
+  float previousError = 0.0f;
+  for (uint32_t level = 0; level < settings.maxLods; ++level) {
+    size_t target = static_cast<size_t>(static_cast<float>(previous / 3) *
+                                        settings.reduction) *
+                    3;
+    target = std::max(target, minIndices);
+    if (target >= previous) {
+      break;
+    }
+
+    MeshLod lod;
+    double cost = 0.0;
+    lod.indices = simplifier.Run(target, maxCost, cost);
+    const float error = static_cast<float>(std::sqrt(cost));
+    if (lod.indices.empty() ||
+        lod.indices.size() * 5 > previous * 4) { // 2 割も減らなければ打ち切り
+      break;
+    }
+    MeshOptimizer::OptimizeVertexCache(lod.indices, vertices.size());
+    lod.error = std::max(error, previousError);
+
+    previous = lod.indices.size();
+    previousError = lod.error;
+    lods.push_back(std::move(lod));
+  }
+  return lods;
+}
+
+} // namespace MeshSimplifier
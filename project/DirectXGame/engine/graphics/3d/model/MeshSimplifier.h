@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ModelData.h"
+
+// 二次誤差（QEM, Garland & Heckbert）で辺を縮約してメッシュを間引く
+// - 縮約先は元の頂点のどれか（新しい頂点を作らないので、LOD 間で頂点バッファを共有できる）
+// - 位置が同じで法線だけ違う頂点は 1 点として縮約し、面には法線の近い方をつなぐ
+// - 開いた縁と UV の継ぎ目の上の頂点は動かさない（輪郭の欠けとテクスチャのずれを防ぐ）
+namespace MeshSimplifier {
+
+// 三角形が targetIndexCount / 3 個以下になるか、次の縮約の誤差が maxError を
+// 超えるまで縮約する。outError には縮約した中で最大の誤差（モデル空間の距離）
+std::vector<uint32_t> Simplify(const std::vector<uint32_t> &indices,
+                               const std::vector<VertexData> &vertices,
+                               size_t targetIndexCount, float maxError,
+                               float *outError = nullptr);
+
+struct LodChainSettings {
+  uint32_t maxLods = 4;          // LOD0 を除いた段数の上限
+  float reduction = 0.5f;        // 1 段ごとの三角形数の比
+  uint32_t minTriangles = 16;    // これより少なくはしない
+  float maxRelativeError = 0.1f; // 誤差の上限（モデルの大きさ = AABB の対角線に対する比）
+};
+
+// LOD1 以降を作る。前の段より 2 割以上減らなくなったら打ち切る
+std::vector<MeshLod> BuildLodChain(const std::vector<uint32_t> &indices,
+                                   const std::vector<VertexData> &vertices,
+                                   const LodChainSettings &settings = {});
+
+} // namespace MeshSimplifier
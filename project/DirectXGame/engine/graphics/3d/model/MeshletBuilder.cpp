@@ -0,0 +1,254 @@
+#include "MeshletBuilder.h"
+#include "Method.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr uint32_t kNone = 0xFFFFFFFFu;
+// 面の向きがこれ以上ばらつく塊は円錐で判定しない（ほぼ半球以上）
+constexpr float kMinConeDot = 0.1f;
+
+Vector3 Position_(const VertexData &v) {
+  return {v.position.x, v.position.y, v.position.z};
+}
+
+Vector3 Sub_(const Vector3 &a, const Vector3 &b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+float DistanceSq_(const Vector3 &a, const Vector3 &b) {
+  const Vector3 d = Sub_(a, b);
+  return Dot(d, d);
+}
+
+} // namespace
+
+namespace MeshletBuilder {
+
+std::vector<Meshlet> Build(std::vector<uint32_t> &indices,
+                           const std::vector<VertexData> &vertices,
+                           uint32_t maxVertices, uint32_t maxTriangles) {
+  assert(indices.size() % 3 == 0);
+  assert(maxVertices >= 3 && maxTriangles >= 1);
+  const size_t triangleCount = indices.size() / 3;
+  std::vector<Meshlet> meshlets;
+  if (triangleCount == 0) {
+    return meshlets;
+  }
+
+  // 頂点 → その頂点を使う三角形（頂点ごとに連続して並べる）
+  std::vector<uint32_t> offsets(vertices.size() + 1, 0);
+  for (uint32_t index : indices) {
+    ++offsets[index + 1];
+  }
+  for (size_t i = 1; i < offsets.size(); ++i) {
+    offsets[i] += offsets[i - 1];
+  }
+  std::vector<uint32_t> adjacency(indices.size());
+  {
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t) {
+      for (size_t k = 0; k < 3; ++k) {
+        adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+      }
+    }
+  }
+
+  std::vector<Vector3> centroids(triangleCount);
+  for (size_t t = 0; t < triangleCount; ++t) {
+    const Vector3 a = Position_(vertices[indices[t * 3 + 0]]);
+    const Vector3 b = Position_(vertices[indices[t * 3 + 1]]);
+    const Vector3 c = Position_(vertices[indices[t * 3 + 2]]);
+    centroids[t] = {(a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f,
+                    (a.z + b.z + c.z) / 3.0f};
+  }
+
+  std::vector<uint8_t> emitted(triangleCount, 0);
+  // 今の塊に入っている頂点には塊の番号を書く
+  std::vector<uint32_t> vertexMeshlet(vertices.size(), kNone);
+  std::vector<uint32_t> candidates;
+  std::vector<uint32_t> result;
+  result.reserve(indices.size());
+
+  const auto newVertexCount = [&](uint32_t t, uint32_t meshlet) {
+    uint32_t count = 0;
+    for (size_t k = 0; k < 3; ++k) {
+      count += vertexMeshlet[indices[t * 3 + k]] != meshlet ? 1u : 0u;
+    }
+    return count;
+  };
+
+  size_t scan = 0; // 未使用の三角形を探し始める位置
+  while (true) {
+    while (scan < triangleCount && emitted[scan]) {
+      ++scan;
+    }
+    if (scan == triangleCount) {
+      break;
+    }
+
+    const uint32_t id = static_cast<uint32_t>(meshlets.size());
+    Meshlet meshlet{};
+    meshlet.indexStart = static_cast<uint32_t>(result.size());
+    uint32_t vertexCount = 0;
+    uint32_t count = 0;
+    Vector3 centroidSum{};
+    candidates.clear();
+
+    uint32_t next = static_cast<uint32_t>(scan);
+    while (next != kNone) {
+      emitted[next] = 1;
+      for (size_t k = 0; k < 3; ++k) {
+        const uint32_t v = indices[next * 3 + k];
+        if (vertexMeshlet[v] != id) {
+          vertexMeshlet[v] = id;
+          ++vertexCount;
+          for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+            if (!emitted[adjacency[i]]) {
+              candidates.push_back(adjacency[i]);
+            }
+          }
+        }
+        result.push_back(v);
+      }
+      centroidSum = Add(centroidSum, centroids[next]);
+      if (++count == maxTriangles) {
+        break;
+      }
+
+      // 足す頂点が少ない三角形、同じなら塊の中心に近いもの
+      const float inv = 1.0f / static_cast<float>(count);
+      const Vector3 center = {centroidSum.x * inv, centroidSum.y * inv,
+                              centroidSum.z * inv};
+      next = kNone;
+      uint32_t bestNew = 4;
+      float bestDistance = std::numeric_limits<float>::max();
+      size_t kept = 0;
+      for (uint32_t t : candidates) {
+        if (emitted[t]) {
+          continue;
+        }
+        candidates[kept++] = t;
+        const uint32_t added = newVertexCount(t, id);
+        if (vertexCount + added > maxVertices) {
+          continue;
+        }
+        const float distance = DistanceSq_(centroids[t], center);
+        if (added < bestNew || (added == bestNew && distance < bestDistance)) {
+          next = t;
+          bestNew = added;
+          bestDistance = distance;
+        }
+      }
+      candidates.resize(kept);
+
+      // つながった三角形が無ければ（離れた部品）、並び順で次の三角形を足す
+      if (next == kNone && candidates.empty() &&
+          vertexCount + 3 <= maxVertices) {
+        while (scan < triangleCount && emitted[scan]) {
+          ++scan;
+        }
+        if (scan < triangleCount) {
+          next = static_cast<uint32_t>(scan);
+        }
+      }
+    }
+
+    meshlet.indexCount = static_cast<uint32_t>(result.size()) -
+                         meshlet.indexStart;
+    meshlets.push_back(meshlet);
+  }
+
+  indices = std::move(result);
+  for (Meshlet &meshlet : meshlets) {
+    meshlet = ComputeBounds(indices, meshlet.indexStart, meshlet.indexCount,
+                            vertices);
+  }
+  return meshlets;
+}
+
+Meshlet ComputeBounds(const std::vector<uint32_t> &indices,
+                      uint32_t indexStart, uint32_t indexCount,
+                      const std::vector<VertexData> &vertices) {
+  assert(indexCount % 3 == 0);
+  assert(static_cast<size_t>(indexStart) + indexCount <= indices.size());
+  Meshlet meshlet{};
+  meshlet.indexStart = indexStart;
+  meshlet.indexCount = indexCount;
+  if (indexCount == 0) {
+    return meshlet;
+  }
+  const uint32_t *first = indices.data() + indexStart;
+
+  // 境界球（AABB の中心から一番遠い頂点まで）
+  Vector3 minP = Position_(vertices[first[0]]);
+  Vector3 maxP = minP;
+  for (uint32_t i = 0; i < indexCount; ++i) {
+    const Vector3 p = Position_(vertices[first[i]]);
+    minP = {std::min(minP.x, p.x), std::min(minP.y, p.y),
+            std::min(minP.z, p.z)};
+    maxP = {std::max(maxP.x, p.x), std::max(maxP.y, p.y),
+            std::max(maxP.z, p.z)};
+  }
+  meshlet.center = {(minP.x + maxP.x) * 0.5f, (minP.y + maxP.y) * 0.5f,
+                    (minP.z + maxP.z) * 0.5f};
+  float radiusSq = 0.0f;
+  for (uint32_t i = 0; i < indexCount; ++i) {
+    radiusSq = std::max(
+        radiusSq, DistanceSq_(Position_(vertices[first[i]]), meshlet.center));
+  }
+  meshlet.radius = std::sqrt(radiusSq);
+
+  // 法線の円錐
+  // 時計回りが表（左手系）なので、表の面の法線 (b - a) x (c - a) はカメラ側を向く
+  Vector3 axisSum{};
+  for (uint32_t i = 0; i < indexCount; i += 3) {
+    const Vector3 a = Position_(vertices[first[i + 0]]);
+    const Vector3 n = Cross(Sub_(Position_(vertices[first[i + 1]]), a),
+                            Sub_(Position_(vertices[first[i + 2]]), a));
+    const float length = std::sqrt(Dot(n, n));
+    if (length > 0.0f) {
+      axisSum = Add(axisSum, {n.x / length, n.y / length, n.z / length});
+    }
+  }
+  if (Dot(axisSum, axisSum) <= 0.0f) {
+    return meshlet;
+  }
+  const Vector3 axis = Normalize(axisSum);
+
+  float minDot = 1.0f;
+  float apexDistance = -std::numeric_limits<float>::max();
+  for (uint32_t i = 0; i < indexCount; i += 3) {
+    const Vector3 a = Position_(vertices[first[i + 0]]);
+    const Vector3 n = Cross(Sub_(Position_(vertices[first[i + 1]]), a),
+                            Sub_(Position_(vertices[first[i + 2]]), a));
+    const float length = std::sqrt(Dot(n, n));
+    if (length <= 0.0f) {
+      continue;
+    }
+    const Vector3 unit = {n.x / length, n.y / length, n.z / length};
+    const float d = Dot(unit, axis);
+    minDot = std::min(minDot, d);
+    if (d > 0.0f) {
+      // apex を全ての面の裏側に置く: dot(a - apex, n) >= 0
+      apexDistance =
+          std::max(apexDistance, Dot(Sub_(meshlet.center, a), unit) / d);
+    }
+  }
+  if (minDot <= kMinConeDot) {
+    return meshlet;
+  }
+
+  // カメラから apex への向きが axis と 90° - 円錐の半角以内なら全ての面が裏向き
+  meshlet.coneAxis = axis;
+  meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+  meshlet.coneApex = {meshlet.center.x - axis.x * apexDistance,
+                      meshlet.center.y - axis.y * apexDistance,
+                      meshlet.center.z - axis.z * apexDistance};
+  return meshlet;
+}
+
+} // namespace MeshletBuilder
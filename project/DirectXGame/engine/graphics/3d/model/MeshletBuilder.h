@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ModelData.h"
+
+// 三角形リストを小さな塊（メッシュレット）に分け、塊ごとにカリング用の境界を付ける
+// - 辺でつながった三角形を、足す頂点が少ない順・中心に近い順に貪欲に集める
+// - indices は塊の順に並べ替える（塊ごとに連続した範囲になる。頂点番号は変えない）
+namespace MeshletBuilder {
+
+constexpr uint32_t kMaxVertices = 64;
+constexpr uint32_t kMaxTriangles = 124;
+
+std::vector<Meshlet> Build(std::vector<uint32_t> &indices,
+                           const std::vector<VertexData> &vertices,
+                           uint32_t maxVertices = kMaxVertices,
+                           uint32_t maxTriangles = kMaxTriangles);
+
+// indices[indexStart, indexStart + indexCount) の境界球と法線の円錐
+Meshlet ComputeBounds(const std::vector<uint32_t> &indices,
+                      uint32_t indexStart, uint32_t indexCount,
+                      const std::vector<VertexData> &vertices);
+
+} // namespace MeshletBuilder
@@ -0,0 +1,91 @@
+#include "MeshletCulling.h"
+#include <cmath>
+
+namespace MeshletCulling {
+
+Frustum MakeFrustum(const Matrix4x4 &worldViewProj) {
+  // clip = v * M なので、各平面は M の列の組み合わせ
+  const Matrix4x4 &m = worldViewProj;
+  const auto column = [&](int c) {
+    return Vector4{m.m[0][c], m.m[1][c], m.m[2][c], m.m[3][c]};
+  };
+  const Vector4 x = column(0);
+  const Vector4 y = column(1);
+  const Vector4 z = column(2);
+  const Vector4 w = column(3);
+
+  Frustum f{};
+  f.planes[0] = {w.x + x.x, w.y + x.y, w.z + x.z, w.w + x.w}; // 左
+  f.planes[1] = {w.x - x.x, w.y - x.y, w.z - x.z, w.w - x.w}; // 右
+  f.planes[2] = {w.x + y.x, w.y + y.y, w.z + y.z, w.w + y.w}; // 下
+  f.planes[3] = {w.x - y.x, w.y - y.y, w.z - y.z, w.w - y.w}; // 上
+  f.planes[4] = z;                                            // 手前
+  f.planes[5] = {w.x - z.x, w.y - z.y, w.z - z.z, w.w - z.w}; // 奥
+  for (Vector4 &p : f.planes) {
+    const float length = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+    if (length > 0.0f) {
+      const float inv = 1.0f / length;
+      p = {p.x * inv, p.y * inv, p.z * inv, p.w * inv};
+    }
+  }
+  return f;
+}
+
+bool IsSphereVisible(const Frustum &frustum, const Vector3 &center,
+                     float radius) {
+  for (const Vector4 &p : frustum.planes) {
+    if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsBackFacing(const Meshlet &meshlet, const Vector3 &cameraPosition) {
+  if (meshlet.coneCutoff > 1.0f) {
+    return false;
+  }
+  const Vector3 d = {meshlet.coneApex.x - cameraPosition.x,
+                     meshlet.coneApex.y - cameraPosition.y,
+                     meshlet.coneApex.z - cameraPosition.z};
+  const float length = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+  const float dot = d.x * meshlet.coneAxis.x + d.y * meshlet.coneAxis.y +
+                    d.z * meshlet.coneAxis.z;
+  return length > 0.0f && dot >= meshlet.coneCutoff * length;
+}
+
+uint32_t Cull(const Meshlet *meshlets, size_t count, const Frustum &frustum,
+              const Vector3 &cameraPosition, bool cullBackFaces,
+              std::vector<IndexRange> &out, Stats *stats) {
+  const size_t first = out.size();
+  Stats local{};
+  for (size_t i = 0; i < count; ++i) {
+    const Meshlet &meshlet = meshlets[i];
+    ++local.tested;
+    if (!IsSphereVisible(frustum, meshlet.center, meshlet.radius)) {
+      ++local.frustumCulled;
+      continue;
+    }
+    if (cullBackFaces && IsBackFacing(meshlet, cameraPosition)) {
+      ++local.backfaceCulled;
+      continue;
+    }
+
+    // 直前の範囲の続きなら伸ばす（描画回数を減らす）
+    if (out.size() > first &&
+        out.back().indexStart + out.back().indexCount == meshlet.indexStart) {
+      out.back().indexCount += meshlet.indexCount;
+    } else {
+      out.push_back({meshlet.indexStart, meshlet.indexCount});
+    }
+  }
+
+  if (stats) {
+    stats->tested += local.tested;
+    stats->frustumCulled += local.frustumCulled;
+    stats->backfaceCulled += local.backfaceCulled;
+  }
+  return static_cast<uint32_t>(out.size() - first);
+}
+
+} // namespace MeshletCulling
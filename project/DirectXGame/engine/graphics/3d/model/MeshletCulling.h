@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Matrix.h"
+#include "ModelData.h"
+#include "Vector.h"
+
+// メッシュレットの視錐台・裏面カリング（GPU に依存しない）
+// - 判定はモデル空間で行う（World * View * Proj から平面を取り出し、カメラ位置を World の逆で戻す）
+// - 見える塊のインデックス範囲を返す。隣り合う塊は 1 つの範囲にまとめる
+namespace MeshletCulling {
+
+// ax + by + cz + d >= 0 が内側（(a, b, c) は正規化済み）
+struct Frustum {
+  Vector4 planes[6];
+};
+
+// 行ベクトル規約の World * View * Proj から（D3D の深度 0～1）
+Frustum MakeFrustum(const Matrix4x4 &worldViewProj);
+
+bool IsSphereVisible(const Frustum &frustum, const Vector3 &center,
+                     float radius);
+// 全ての面がカメラから裏を向いている
+bool IsBackFacing(const Meshlet &meshlet, const Vector3 &cameraPosition);
+
+struct IndexRange {
+  uint32_t indexStart = 0;
+  uint32_t indexCount = 0;
+};
+
+struct Stats {
+  uint32_t tested = 0;
+  uint32_t frustumCulled = 0;
+  uint32_t backfaceCulled = 0;
+};
+
+// 見える塊の範囲を out の後ろに足し、足した範囲の数を返す
+// cullBackFaces は裏面を描かないパイプライン（かつ World の行列式が正）の時だけ true にする
+uint32_t Cull(const Meshlet *meshlets, size_t count, const Frustum &frustum,
+              const Vector3 &cameraPosition, bool cullBackFaces,
+              std::vector<IndexRange> &out, Stats *stats = nullptr);
+
+} // namespace MeshletCulling
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AABB.h"
+#include "AnimationClip.h"
+#include "Matrix.h"
+#include "NodeHierarchy.h"
+#include "Vector.h"
+
+// ===== CPU側のモデルデータ（OBJ/MTL読み込み結果） =====
+// Assimp に依存しない（MeshCache でそのまま保存・復元する）
+
+struct VertexData {
+  Vector4 position{};
+  Vector2 texcoord{};
+  Vector3 normal{};
+};
+
+// 1 頂点に効くジョイント（ModelData::joints の番号）と重み
+// 重みは合計 255 の UNORM8（4 本より多い分は重い順に 4 本へ詰める）
+struct VertexInfluence {
+  uint16_t joints[4];
+  uint8_t weights[4];
+};
+static_assert(sizeof(VertexInfluence) == 12);
+
+// スキニングのジョイント（頂点をバインド時のジョイント空間へ移す行列とノード）
+struct SkinJoint {
+  uint32_t node = 0; // NodeHierarchy の番号
+  Matrix4x4 inverseBindMatrix{};
+};
+
+struct MaterialData {
+  std::string textureFilePath;
+};
+
+// 間引いた三角形リスト 1 段ぶん（頂点は元のメッシュの vertices を共有する）
+struct MeshLod {
+  std::vector<uint32_t> indices;
+  float error = 0.0f; // 元の形とのずれの目安（モデル空間の距離）
+};
+
+// 連続した三角形の塊とカリング用の境界（MeshletBuilder が作る）
+struct Meshlet {
+  uint32_t indexStart = 0; // MeshData::indices の中の範囲
+  uint32_t indexCount = 0;
+  Vector3 center{}; // 境界球
+  float radius = 0.0f;
+  // 法線の円錐: dot(normalize(apex - カメラ), axis) >= cutoff なら全ての面が裏向き
+  Vector3 coneApex{};
+  Vector3 coneAxis{};
+  float coneCutoff = 2.0f; // 1 より大きければ判定しない
+};
+
+// 重複を除いた頂点 + 三角形リストのインデックス（頂点キャッシュ向けに並べ替え済み）
+struct MeshData {
+  std::vector<VertexData> vertices;
+  std::vector<uint32_t> indices;
+  // LOD1 以降（粗くなる順、error は昇順）。空なら LOD0 だけ
+  std::vector<MeshLod> lods;
+  // 大きなメッシュだけ。あれば indices はメッシュレットの順に並んでいる
+  std::vector<Meshlet> meshlets;
+  // 空ならスキン無し。あれば vertices と同じ数
+  std::vector<VertexInfluence> influences;
+  int materialIndex = -1;
+};
+
+struct ModelData {
+  std::vector<MeshData> meshes;
+  std::vector<MaterialData> materials;
+  // ノード階層（GlobalMatrix は読み込み時に計算済み）
+  NodeHierarchy nodes;
+  // 全メッシュの頂点を囲む範囲（ノードの変換は含まない）
+  AABB bounds{};
+  // 空でなければ全メッシュが influences を持つ
+  std::vector<SkinJoint> joints;
+  std::vector<AnimationClip> animations;
+};
@@ -3,6 +3,7 @@
 #include "Method.h"
 #include <memory>
 #include <string>
+#include <vector>
 
 // 前方宣言
 class ModelResource;
@@ -17,7 +18,7 @@ public:
     float shininess = 32.0f;
   };
 
-  // HLSL 定数バッファ構造体 (Renderer が書き込むために公開)
+  // HLSL 定数バッファ構造体（Renderer が描画ごとにフレーム用アップロード領域へ書く）
   struct MaterialCB {
     Vector4 color{1, 1, 1, 1};
     int32_t enableLighting = 1;
@@ -51,20 +52,40 @@ public:
   void SetWireframe(bool wireframe) { isWireframe_ = wireframe; }
   bool IsWireframe() const { return isWireframe_; }
 
+  // スキンメッシュの行列（Animator::GetSkinMatrices）。未設定ならバインドポーズ
+  void SetSkinMatrices(const std::vector<Matrix4x4> &matrices) {
+    skinMatrices_.assign(matrices.begin(), matrices.end());
+  }
+  const std::vector<Matrix4x4> &GetSkinMatrices() const {
+    return skinMatrices_;
+  }
+
+  // 直近の描画で使った LOD（Renderer が画面上の大きさから選び直す）
+  // 次のフレームの選択はここから切り替えるので、切り替え付近でちらつかない
+  uint32_t GetLod() const { return lod_; }
+  void SetLod(uint32_t lod) { lod_ = lod; }
+
   void Draw();
 
+  // インスタンシング描画に登録（Renderer::FlushInstancedModels で一括描画）
+  // - 同じ ModelResource を共有するインスタンスが 1 回の DrawInstanced にまとまる
+  void DrawInstanced();
+
   // Renderer 用アクセサ
-  unsigned long long GetMaterialCBAddress() const;
-  unsigned long long GetTransformCBAddress() const;
   ModelResource *GetResource() const;
-
-  // Renderer が WVP を最終合成・転送するためのポインタ取得
-  TransformCB *GetTransformMapped();
+  const MaterialCB &GetMaterial() const { return material_; }
+  const Matrix4x4 &GetWorldInverseTranspose() const {
+    return worldInverseTranspose_;
+  }
 
 private:
   struct Impl;
   std::unique_ptr<Impl> pImpl_;
 
   Matrix4x4 world_ = MakeIdentity4x4();
+  Matrix4x4 worldInverseTranspose_ = MakeIdentity4x4();
+  MaterialCB material_{};
   bool isWireframe_ = false;
+  std::vector<Matrix4x4> skinMatrices_;
+  uint32_t lod_ = 0;
 };
\ No newline at end of file
@@ -2,20 +2,28 @@
 
 #include <cassert>
 
+#include "AssetLoadQueue.h"
 #include "AssetLoader.h"
 #include "ModelResource.h"
+#include "TextureManager.h"
+#include "TextureResource.h"
 
 std::shared_ptr<ModelResource> ModelManager::Load(const std::string &path) {
   assert(dx_);
 
-  if (auto it = cache_.find(path); it != cache_.end()) {
-    if (auto alive = it->second.lock()) {
-      return alive;
-    }
+  auto acquired = cache_.Acquire(path);
+  if (!acquired.created) {
+    // LoadAsync で読み込み中なら仕上げを回しながら待つ
+    // 失敗していればプレースホルダ（未設定なら nullptr）
+    AssetLoadQueue::GetInstance()->Wait(acquired.future);
+    return acquired.future.Get();
   }
 
   auto md = AssetLoader::GetInstance()->LoadModel(path);
-  assert(md);
+  if (!md) {
+    cache_.Complete(path, acquired.future, nullptr);
+    return acquired.future.Get();
+  }
 
   auto res = std::make_shared<ModelResource>();
 
@@ -26,16 +34,59 @@ std::shared_ptr<ModelResource> ModelManager::Load(const std::string &path) {
   const bool ok = res->Initialize(ci);
   assert(ok);
 
-  cache_[path] = res;
+  cache_.Complete(path, acquired.future, ok ? res : nullptr,
+                  res->GetGpuBytes());
   return res;
 }
 
-void ModelManager::ClearUnused() {
-  for (auto it = cache_.begin(); it != cache_.end();) {
-    if (it->second.expired()) {
-      it = cache_.erase(it);
-    } else {
-      ++it;
-    }
+AssetFuture<ModelResource> ModelManager::LoadAsync(const std::string &path) {
+  assert(dx_);
+
+  auto acquired = cache_.Acquire(path, placeholder_);
+  if (!acquired.created) {
+    return acquired.future;
   }
+
+  auto *queue = AssetLoadQueue::GetInstance();
+  queue->Submit([this, queue, path, future = acquired.future]() {
+    auto md = AssetLoader::GetInstance()->LoadModel(path);
+
+    // 1 回目: マテリアルのテクスチャの読み込みを始める / 2 回目以降: その完了を待つ
+    std::vector<AssetFuture<TextureResource>> textures;
+    bool texturesRequested = false;
+    queue->PostToRenderThread([this, path, future, md, textures,
+                               texturesRequested]() mutable {
+      if (!texturesRequested && md) {
+        auto *textureManager = TextureManager::GetInstance();
+        for (int i = 0; i < static_cast<int>(md->materials.size()); ++i) {
+          const std::string texPath = GetMaterialTexturePath(*md, i);
+          textures.push_back(textureManager->LoadAsync(
+              texPath.empty() ? "resources/white1x1.png" : texPath));
+        }
+      }
+      texturesRequested = true;
+      for (const auto &texture : textures) {
+        if (!texture.IsReady()) {
+          return false;
+        }
+      }
+
+      auto res = std::make_shared<ModelResource>();
+      ModelResource::CreateInfo ci{};
+      ci.dx = dx_;
+      ci.modelData = md;
+      // 失敗したテクスチャはプレースホルダ（白）になる
+      for (const auto &texture : textures) {
+        ci.materialTextures.push_back(texture.Get());
+      }
+      if (!md || !res->Initialize(ci)) {
+        res = nullptr;
+      }
+      cache_.Complete(path, future, res, res ? res->GetGpuBytes() : 0);
+      return true;
+    });
+  });
+  return acquired.future;
 }
+
+void ModelManager::ClearUnused() { cache_.ClearUnused(); }
@@ -1,7 +1,9 @@
 #pragma once
 #include <memory>
 #include <string>
-#include <unordered_map>
+
+#include "AssetFuture.h"
+#include "ConcurrentAssetCache.h"
 
 class DirectXCommon;
 class ModelResource;
@@ -16,6 +18,8 @@ public:
   void Initialize(DirectXCommon *dx) { dx_ = dx; }
 
   // 統一本命: フルパス1本
+  // LoadAsync で読み込み中のパスなら、その完了を待って同じ結果を返す
+  // 取り込めないファイルならプレースホルダ（SetPlaceholder。未設定なら nullptr）
   std::shared_ptr<ModelResource> Load(const std::string &path);
 
   // 互換ラッパ
@@ -25,12 +29,39 @@ public:
     return Load(directoryPath + "/" + filename);
   }
 
+  // モデルの取り込みとテクスチャのデコードはワーカーで、頂点バッファ等の作成は
+  // AssetLoadQueue::Pump（描画スレッド）で行う。完了まではプレースホルダを返す
+  // 描画スレッドから呼ぶこと
+  AssetFuture<ModelResource> LoadAsync(const std::string &path);
+
+  // LoadAsync の完了前・失敗時に Get が返すモデル（既定は nullptr）
+  void SetPlaceholder(std::shared_ptr<ModelResource> placeholder) {
+    placeholder_ = std::move(placeholder);
+  }
+
+  // どこからも使われていないモデルを予算に関係なく手放す
   void ClearUnused();
 
+  // 頂点・インデックスバッファの合計の上限（超えたら未使用のものを古い順に手放す）
+  void SetCacheBudget(uint64_t bytes) { cache_.SetBudget(bytes); }
+  static constexpr uint64_t kDefaultCacheBudget = 256ull << 20;
+  // 固定したモデルは使われていなくても手放さない
+  void Pin(const std::string &path, bool pinned = true) {
+    cache_.Pin(path, pinned);
+  }
+
+  ConcurrentAssetCache<ModelResource>::Stats GetCacheStats() const {
+    return cache_.GetStats();
+  }
+
 private:
-  ModelManager() = default;
+  ModelManager() { cache_.SetBudget(kDefaultCacheBudget); }
 
   DirectXCommon *dx_ = nullptr;
 
-  std::unordered_map<std::string, std::weak_ptr<ModelResource>> cache_;
+  // 読み込み中も登録する（同じパスの Load / LoadAsync は 1 回の読み込みを共有する）
+  // 使われなくなっても予算内なら残す（シーンを跨いだ再読み込みを避ける）
+  ConcurrentAssetCache<ModelResource> cache_{
+      ConcurrentAssetCache<ModelResource>::Ownership::Strong};
+  std::shared_ptr<ModelResource> placeholder_;
 };
@@ -3,7 +3,9 @@
 #include "Renderer.h"
 #include "TextureManager.h"
 #include "TextureResource.h"
+#include "VertexPacking.h"
 #include <cassert>
+#include <cmath>
 #include <d3d12.h>
 #include <wrl/client.h>
 
@@ -13,7 +15,25 @@ struct ModelResource::Impl {
   unsigned int vbSize = 0;
   unsigned int vbStride = 0;
   uint32_t vertexCount = 0;
-  std::shared_ptr<TextureResource> texture;
+  Microsoft::WRL::ComPtr<ID3D12Resource> ib;
+  D3D12_GPU_VIRTUAL_ADDRESS ibAddress = 0;
+  unsigned int ibSize = 0;
+  DXGI_FORMAT ibFormat = DXGI_FORMAT_R32_UINT;
+  uint32_t indexCount = 0;
+  bool packedVertex = false;
+  Matrix4x4 dequantize = MakeIdentity4x4();
+  Microsoft::WRL::ComPtr<ID3D12Resource> skinVb;
+  D3D12_GPU_VIRTUAL_ADDRESS skinVbAddress = 0;
+  unsigned int skinVbSize = 0;
+  uint32_t jointCount = 0;
+  std::vector<Submesh> submeshes; // LOD 順に submeshCount 個ずつ
+  uint32_t submeshCount = 0;
+  std::vector<float> lodRelativeErrors;
+  Vector3 boundingCenter{};
+  float boundingRadius = 0.0f;
+  std::vector<Meshlet> meshlets;
+  // サブメッシュが参照するテクスチャ（SRV を生かしておくため）
+  std::vector<std::shared_ptr<TextureResource>> textures;
 };
 
 ModelResource::ModelResource() : pImpl_(std::make_unique<Impl>()) {}
@@ -23,33 +43,152 @@ bool ModelResource::Initialize(const CreateInfo &ci) {
   assert(ci.modelData);
   auto *renderer = Renderer::GetInstance();
 
-  const std::vector<VertexData> vertices = FlattenVertices(*ci.modelData);
-  if (vertices.empty())
+  std::vector<VertexData> vertices;
+  std::vector<uint32_t> indices;
+  std::vector<SubmeshRange> ranges;
+  std::vector<VertexInfluence> influences;
+  const bool skinned = !ci.modelData->joints.empty();
+  FlattenMeshes(*ci.modelData, vertices, indices, ranges,
+                skinned ? &influences : nullptr);
+  if (vertices.empty() || indices.empty())
     return false;
 
   pImpl_->vertexCount = static_cast<uint32_t>(vertices.size());
-  const size_t vbBufferSize = sizeof(VertexData) * vertices.size();
 
-  pImpl_->vb = renderer->CreateUploadBuffer(vbBufferSize);
-  if (!pImpl_->vb)
-    return false;
+  // LOD1 以降のインデックスを同じ IB の後ろに足す
+  const uint32_t lodCount = ::GetLodCount(*ci.modelData);
+  for (uint32_t lod = 1; lod < lodCount; ++lod) {
+    AppendMeshLod(*ci.modelData, lod, indices, ranges);
+  }
+  assert(ranges.size() % lodCount == 0);
+  pImpl_->submeshCount = static_cast<uint32_t>(ranges.size() / lodCount);
 
-  void *mapped = nullptr;
-  if (SUCCEEDED(pImpl_->vb->Map(0, nullptr, &mapped))) {
-    std::memcpy(mapped, vertices.data(), vbBufferSize);
-    pImpl_->vb->Unmap(0, nullptr);
+  const AABB &aabb = ci.modelData->bounds;
+  pImpl_->boundingCenter = {(aabb.min.x + aabb.max.x) * 0.5f,
+                            (aabb.min.y + aabb.max.y) * 0.5f,
+                            (aabb.min.z + aabb.max.z) * 0.5f};
+  const Vector3 half = {(aabb.max.x - aabb.min.x) * 0.5f,
+                        (aabb.max.y - aabb.min.y) * 0.5f,
+                        (aabb.max.z - aabb.min.z) * 0.5f};
+  pImpl_->boundingRadius =
+      std::sqrt(half.x * half.x + half.y * half.y + half.z * half.z);
+  pImpl_->lodRelativeErrors.resize(lodCount);
+  for (uint32_t lod = 0; lod < lodCount; ++lod) {
+    pImpl_->lodRelativeErrors[lod] =
+        pImpl_->boundingRadius > 0.0f
+            ? GetLodError(*ci.modelData, lod) / pImpl_->boundingRadius
+            : 0.0f;
   }
 
+  // 静的な頂点は DEFAULT ヒープへ（コピーは他の読み込みとまとめて投入される）
+  // スキンメッシュは VS で行列を掛けるので、位置を正規化する圧縮形式は使わない
+  size_t vbBufferSize = 0;
+  if (!skinned &&
+      renderer->GetModelVertexFormat() == ModelVertexFormat::Packed) {
+    const PackedVertexBounds bounds = VertexPacking::ComputeBounds(
+        &vertices[0].position.x, sizeof(VertexData), vertices.size());
+    std::vector<PackedVertex> packed(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+      packed[i] = VertexPacking::Pack(vertices[i].position,
+                                      vertices[i].texcoord, vertices[i].normal,
+                                      bounds);
+    }
+    vbBufferSize = sizeof(PackedVertex) * packed.size();
+    pImpl_->vb = renderer->CreateStaticBuffer(packed.data(), vbBufferSize);
+    pImpl_->vbStride = sizeof(PackedVertex);
+    pImpl_->packedVertex = true;
+    pImpl_->dequantize = VertexPacking::MakeDequantizeMatrix(bounds);
+  } else {
+    vbBufferSize = sizeof(VertexData) * vertices.size();
+    pImpl_->vb = renderer->CreateStaticBuffer(vertices.data(), vbBufferSize);
+    pImpl_->vbStride = sizeof(VertexData);
+  }
+  if (!pImpl_->vb)
+    return false;
+
   pImpl_->vbAddress = pImpl_->vb->GetGPUVirtualAddress();
   pImpl_->vbSize = static_cast<unsigned int>(vbBufferSize);
-  pImpl_->vbStride = sizeof(VertexData);
 
-  if (ci.texture) {
-    pImpl_->texture = ci.texture;
+  if (skinned) {
+    pImpl_->skinVbSize =
+        static_cast<unsigned int>(sizeof(VertexInfluence) * influences.size());
+    pImpl_->skinVb =
+        renderer->CreateStaticBuffer(influences.data(), pImpl_->skinVbSize);
+    if (!pImpl_->skinVb)
+      return false;
+    pImpl_->skinVbAddress = pImpl_->skinVb->GetGPUVirtualAddress();
+    pImpl_->jointCount = static_cast<uint32_t>(ci.modelData->joints.size());
+  }
+
+  // インデックス（収まるなら 16bit にして帯域と容量を半分に）
+  pImpl_->indexCount = static_cast<uint32_t>(indices.size());
+  if (vertices.size() <= 0xFFFF) {
+    std::vector<uint16_t> indices16(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+      indices16[i] = static_cast<uint16_t>(indices[i]);
+    }
+    pImpl_->ibSize =
+        static_cast<unsigned int>(sizeof(uint16_t) * indices16.size());
+    pImpl_->ib = renderer->CreateStaticBuffer(indices16.data(), pImpl_->ibSize);
+    pImpl_->ibFormat = DXGI_FORMAT_R16_UINT;
   } else {
-    const std::string texPath = PickDiffuseTexturePath(*ci.modelData);
-    pImpl_->texture = TextureManager::GetInstance()->Load(
-        texPath.empty() ? "resources/white1x1.png" : texPath);
+    pImpl_->ibSize = static_cast<unsigned int>(sizeof(uint32_t) * indices.size());
+    pImpl_->ib = renderer->CreateStaticBuffer(indices.data(), pImpl_->ibSize);
+    pImpl_->ibFormat = DXGI_FORMAT_R32_UINT;
+  }
+  if (!pImpl_->ib)
+    return false;
+  pImpl_->ibAddress = pImpl_->ib->GetGPUVirtualAddress();
+
+  // サブメッシュごとのテクスチャ（テクスチャの無いマテリアルは白）
+  // LOD1 以降は LOD0 の同じ番号のテクスチャを使う
+  pImpl_->submeshes.clear();
+  pImpl_->textures.clear();
+  for (size_t i = pImpl_->submeshCount; i < ranges.size(); ++i) {
+    assert(ranges[i].materialIndex ==
+           ranges[i % pImpl_->submeshCount].materialIndex);
+  }
+  for (size_t i = 0; i < pImpl_->submeshCount; ++i) {
+    const SubmeshRange &range = ranges[i];
+    std::shared_ptr<TextureResource> texture = ci.texture;
+    if (!texture && range.materialIndex >= 0 &&
+        static_cast<size_t>(range.materialIndex) < ci.materialTextures.size()) {
+      texture = ci.materialTextures[static_cast<size_t>(range.materialIndex)];
+    }
+    if (!texture) {
+      const std::string texPath =
+          GetMaterialTexturePath(*ci.modelData, range.materialIndex);
+      texture = TextureManager::GetInstance()->Load(
+          texPath.empty() ? "resources/white1x1.png" : texPath);
+    }
+
+    Submesh submesh{};
+    submesh.indexStart = range.indexStart;
+    submesh.indexCount = range.indexCount;
+    submesh.texture = texture.get();
+    pImpl_->submeshes.push_back(submesh);
+    pImpl_->textures.push_back(std::move(texture));
+  }
+
+  // 視錐台・裏面カリング用のメッシュレット（LOD0 の範囲と同じ並び）
+  pImpl_->meshlets.clear();
+  if (!skinned && ::HasMeshlets(*ci.modelData)) {
+    std::vector<uint32_t> submeshFirst;
+    FlattenMeshlets(*ci.modelData, pImpl_->meshlets, submeshFirst);
+    assert(submeshFirst.size() == pImpl_->submeshCount + 1);
+    for (uint32_t i = 0; i < pImpl_->submeshCount; ++i) {
+      pImpl_->submeshes[i].meshletFirst = submeshFirst[i];
+      pImpl_->submeshes[i].meshletCount = submeshFirst[i + 1] - submeshFirst[i];
+    }
+  }
+
+  for (size_t i = pImpl_->submeshCount; i < ranges.size(); ++i) {
+    Submesh submesh = pImpl_->submeshes[i % pImpl_->submeshCount];
+    submesh.indexStart = ranges[i].indexStart;
+    submesh.indexCount = ranges[i].indexCount;
+    submesh.meshletFirst = 0;
+    submesh.meshletCount = 0;
+    pImpl_->submeshes.push_back(submesh);
   }
 
   return true;
@@ -62,6 +201,70 @@ unsigned int ModelResource::GetVBVSize() const { return pImpl_->vbSize; }
 unsigned int ModelResource::GetVBVStride() const { return pImpl_->vbStride; }
 uint32_t ModelResource::GetVertexCount() const { return pImpl_->vertexCount; }
 
+unsigned long long ModelResource::GetIBVAddress() const {
+  return pImpl_->ibAddress;
+}
+unsigned int ModelResource::GetIBVSize() const { return pImpl_->ibSize; }
+unsigned int ModelResource::GetIBVFormat() const {
+  return static_cast<unsigned int>(pImpl_->ibFormat);
+}
+uint32_t ModelResource::GetIndexCount() const { return pImpl_->indexCount; }
+
+uint64_t ModelResource::GetGpuBytes() const {
+  return static_cast<uint64_t>(pImpl_->vbSize) + pImpl_->ibSize +
+         pImpl_->skinVbSize;
+}
+
+bool ModelResource::IsPackedVertex() const { return pImpl_->packedVertex; }
+const Matrix4x4 &ModelResource::GetDequantizeMatrix() const {
+  return pImpl_->dequantize;
+}
+
+bool ModelResource::IsSkinned() const { return pImpl_->jointCount > 0; }
+uint32_t ModelResource::GetJointCount() const { return pImpl_->jointCount; }
+unsigned long long ModelResource::GetSkinVBVAddress() const {
+  return pImpl_->skinVbAddress;
+}
+unsigned int ModelResource::GetSkinVBVSize() const {
+  return pImpl_->skinVbSize;
+}
+unsigned int ModelResource::GetSkinVBVStride() const {
+  return sizeof(VertexInfluence);
+}
+
 unsigned long long ModelResource::GetTextureHandleGPUAsUInt64() const {
-  return pImpl_->texture ? pImpl_->texture->GetSrvGpu().ptr : 0;
+  if (pImpl_->submeshes.empty() || !pImpl_->submeshes[0].texture) {
+    return 0;
+  }
+  return pImpl_->submeshes[0].texture->GetSrvGpu().ptr;
+}
+
+uint32_t ModelResource::GetSubmeshCount() const {
+  return pImpl_->submeshCount;
+}
+
+const ModelResource::Submesh &ModelResource::GetSubmesh(uint32_t lod,
+                                                        uint32_t index) const {
+  assert(index < pImpl_->submeshCount);
+  const size_t i = static_cast<size_t>(lod) * pImpl_->submeshCount + index;
+  assert(i < pImpl_->submeshes.size());
+  return pImpl_->submeshes[i];
+}
+
+bool ModelResource::HasMeshlets() const { return !pImpl_->meshlets.empty(); }
+const Meshlet *ModelResource::GetMeshlets() const {
+  return pImpl_->meshlets.data();
+}
+
+uint32_t ModelResource::GetLodCount() const {
+  return static_cast<uint32_t>(pImpl_->lodRelativeErrors.size());
+}
+const float *ModelResource::GetLodRelativeErrors() const {
+  return pImpl_->lodRelativeErrors.data();
+}
+const Vector3 &ModelResource::GetBoundingCenter() const {
+  return pImpl_->boundingCenter;
+}
+float ModelResource::GetBoundingRadius() const {
+  return pImpl_->boundingRadius;
 }
\ No newline at end of file
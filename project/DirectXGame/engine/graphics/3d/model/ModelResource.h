@@ -1,9 +1,12 @@
 #pragma once
 
+#include "Matrix.h"
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 struct ModelData;
+struct Meshlet;
 class TextureResource;
 class DirectXCommon;
 
@@ -12,7 +15,22 @@ public:
   struct CreateInfo {
     DirectXCommon *dx = nullptr;
     std::shared_ptr<const ModelData> modelData;
+    // 指定すると全サブメッシュをこのテクスチャで描く
     std::shared_ptr<TextureResource> texture;
+    // マテリアル番号順のテクスチャ（読み込み済みのものを渡す場合）
+    // 足りない・nullptr の分はマテリアルのパスから TextureManager::Load する
+    std::vector<std::shared_ptr<TextureResource>> materialTextures;
+  };
+
+  // 共有の VB/IB の中の、1 マテリアルぶんの描画範囲
+  struct Submesh {
+    uint32_t indexStart = 0;
+    uint32_t indexCount = 0;
+    // SRV はストリーミングで作り直されることがあるので、描画のたびに取り直す
+    const TextureResource *texture = nullptr;
+    // この範囲を分けたメッシュレット（GetMeshlets の番号。LOD0 だけ、0 個ならカリングしない）
+    uint32_t meshletFirst = 0;
+    uint32_t meshletCount = 0;
   };
 
   ModelResource();
@@ -28,8 +46,43 @@ public:
   unsigned int GetVBVSize() const;
   unsigned int GetVBVStride() const;
   uint32_t GetVertexCount() const;
+  // インデックスは頂点数が 65535 以下なら 16bit、超えれば 32bit
+  unsigned long long GetIBVAddress() const;
+  unsigned int GetIBVSize() const;
+  unsigned int GetIBVFormat() const; // DXGI_FORMAT
+  uint32_t GetIndexCount() const;
+  // 圧縮頂点なら位置は正規化座標。World の前に GetDequantizeMatrix を掛ける
+  bool IsPackedVertex() const;
+  const Matrix4x4 &GetDequantizeMatrix() const;
+  // ジョイントのあるモデル。頂点は常に非圧縮で、スロット 1 に VertexInfluence
+  bool IsSkinned() const;
+  uint32_t GetJointCount() const;
+  unsigned long long GetSkinVBVAddress() const;
+  unsigned int GetSkinVBVSize() const;
+  unsigned int GetSkinVBVStride() const;
+  // 頂点・インデックスバッファの合計（テクスチャは TextureManager 側で計上）
+  uint64_t GetGpuBytes() const;
+  // 先頭サブメッシュのテクスチャ
   unsigned long long GetTextureHandleGPUAsUInt64() const;
 
+  // マテリアルごとに 1 つ（同じマテリアルのメッシュはまとめてある）
+  // 数はどの LOD でも同じ。LOD ごとに同じ IB の別の範囲を指す
+  uint32_t GetSubmeshCount() const;
+  const Submesh &GetSubmesh(uint32_t index) const { return GetSubmesh(0, index); }
+  const Submesh &GetSubmesh(uint32_t lod, uint32_t index) const;
+
+  // LOD の段数（LOD0 を含む）と、各段の誤差 / 境界球の半径（LodSelector 用）
+  uint32_t GetLodCount() const;
+  const float *GetLodRelativeErrors() const;
+  // 大きなメッシュを含むモデルだけ（スキンメッシュは形が変わるので持たない）
+  // 範囲はインデックスバッファ全体での位置
+  bool HasMeshlets() const;
+  const Meshlet *GetMeshlets() const;
+
+  // モデル空間の境界球
+  const Vector3 &GetBoundingCenter() const;
+  float GetBoundingRadius() const;
+
 private:
   struct Impl;
   std::unique_ptr<Impl> pImpl_;
@@ -1,4 +1,8 @@
 #include "ModelUtils.h"
+#include "MeshletBuilder.h"
+#include <algorithm>
+#include <cassert>
+#include <numeric>
 #include <utility>
 
 Matrix4x4 ConvertAssimpMatrix(const aiMatrix4x4 &a) {
@@ -45,25 +49,181 @@ void FlipTriangleWinding(VertexData &a, VertexData &b, VertexData &c) {
   std::swap(b, c);
 }
 
-std::vector<VertexData> FlattenVertices(const ModelData &model) {
-  std::vector<VertexData> out;
-  size_t total = 0;
+// マテリアル順に並べる（同じマテリアル内は元の順。描画回数 = 使うマテリアルの数）
+static std::vector<uint32_t> SortMeshesByMaterial_(const ModelData &model) {
+  std::vector<uint32_t> order(model.meshes.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return model.meshes[a].materialIndex < model.meshes[b].materialIndex;
+  });
+  return order;
+}
+
+void FlattenMeshes(const ModelData &model, std::vector<VertexData> &vertices,
+                   std::vector<uint32_t> &indices,
+                   std::vector<SubmeshRange> &submeshes,
+                   std::vector<VertexInfluence> *influences) {
+  size_t totalVertices = 0;
+  size_t totalIndices = 0;
   for (const auto &m : model.meshes) {
-    total += m.vertices.size();
+    totalVertices += m.vertices.size();
+    totalIndices += m.indices.size();
+  }
+  vertices.clear();
+  indices.clear();
+  submeshes.clear();
+  vertices.reserve(totalVertices);
+  indices.reserve(totalIndices);
+  const bool skinned = influences && !model.joints.empty();
+  if (influences) {
+    influences->clear();
+    if (skinned) {
+      influences->reserve(totalVertices);
+    }
   }
-  out.reserve(total);
 
-  for (const auto &m : model.meshes) {
-    out.insert(out.end(), m.vertices.begin(), m.vertices.end());
+  for (uint32_t meshIndex : SortMeshesByMaterial_(model)) {
+    const MeshData &m = model.meshes[meshIndex];
+    if (m.indices.empty()) {
+      continue;
+    }
+    if (submeshes.empty() || submeshes.back().materialIndex != m.materialIndex) {
+      SubmeshRange range{};
+      range.indexStart = static_cast<uint32_t>(indices.size());
+      range.materialIndex = m.materialIndex;
+      submeshes.push_back(range);
+    }
+
+    const uint32_t base = static_cast<uint32_t>(vertices.size());
+    vertices.insert(vertices.end(), m.vertices.begin(), m.vertices.end());
+    if (skinned) {
+      assert(m.influences.size() == m.vertices.size());
+      influences->insert(influences->end(), m.influences.begin(),
+                         m.influences.end());
+    }
+    for (uint32_t i : m.indices) {
+      indices.push_back(base + i);
+    }
+    submeshes.back().indexCount += static_cast<uint32_t>(m.indices.size());
   }
-  return out;
 }
 
-std::string PickDiffuseTexturePath(const ModelData &model) {
-  for (const auto &mat : model.materials) {
-    if (!mat.textureFilePath.empty()) {
-      return mat.textureFilePath;
+uint32_t GetLodCount(const ModelData &model) {
+  size_t count = 0;
+  for (const MeshData &m : model.meshes) {
+    count = std::max(count, m.lods.size());
+  }
+  return static_cast<uint32_t>(count) + 1;
+}
+
+float GetLodError(const ModelData &model, uint32_t lod) {
+  float error = 0.0f;
+  for (const MeshData &m : model.meshes) {
+    if (lod > 0 && !m.lods.empty()) {
+      const size_t level = std::min<size_t>(lod, m.lods.size());
+      error = std::max(error, m.lods[level - 1].error);
+    }
+  }
+  return error;
+}
+
+void AppendMeshLod(const ModelData &model, uint32_t lod,
+                   std::vector<uint32_t> &indices,
+                   std::vector<SubmeshRange> &submeshes) {
+  const size_t firstSubmesh = submeshes.size();
+  uint32_t base = 0;
+  for (uint32_t meshIndex : SortMeshesByMaterial_(model)) {
+    const MeshData &m = model.meshes[meshIndex];
+    if (m.indices.empty()) {
+      continue;
+    }
+    // 範囲の切り方は FlattenMeshes と同じ（LOD0 が空でないメッシュで数える）
+    if (submeshes.size() == firstSubmesh ||
+        submeshes.back().materialIndex != m.materialIndex) {
+      SubmeshRange range{};
+      range.indexStart = static_cast<uint32_t>(indices.size());
+      range.materialIndex = m.materialIndex;
+      submeshes.push_back(range);
     }
+
+    const std::vector<uint32_t> &src =
+        (lod == 0 || m.lods.empty())
+            ? m.indices
+            : m.lods[std::min<size_t>(lod, m.lods.size()) - 1].indices;
+    for (uint32_t i : src) {
+      indices.push_back(base + i);
+    }
+    submeshes.back().indexCount += static_cast<uint32_t>(src.size());
+    base += static_cast<uint32_t>(m.vertices.size());
+  }
+}
+
+bool HasMeshlets(const ModelData &model) {
+  for (const MeshData &m : model.meshes) {
+    if (!m.meshlets.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void FlattenMeshlets(const ModelData &model, std::vector<Meshlet> &meshlets,
+                     std::vector<uint32_t> &submeshFirst) {
+  meshlets.clear();
+  submeshFirst.clear();
+  uint32_t indexBase = 0;
+  int material = 0;
+  for (uint32_t meshIndex : SortMeshesByMaterial_(model)) {
+    const MeshData &m = model.meshes[meshIndex];
+    if (m.indices.empty()) {
+      continue;
+    }
+    // 範囲の切り方は FlattenMeshes と同じ
+    if (submeshFirst.empty() || material != m.materialIndex) {
+      submeshFirst.push_back(static_cast<uint32_t>(meshlets.size()));
+      material = m.materialIndex;
+    }
+
+    const size_t first = meshlets.size();
+    if (m.meshlets.empty()) {
+      meshlets.push_back(MeshletBuilder::ComputeBounds(
+          m.indices, 0, static_cast<uint32_t>(m.indices.size()), m.vertices));
+    } else {
+      meshlets.insert(meshlets.end(), m.meshlets.begin(), m.meshlets.end());
+    }
+    for (size_t i = first; i < meshlets.size(); ++i) {
+      meshlets[i].indexStart += indexBase;
+    }
+    indexBase += static_cast<uint32_t>(m.indices.size());
+  }
+  submeshFirst.push_back(static_cast<uint32_t>(meshlets.size()));
+}
+
+std::string GetMaterialTexturePath(const ModelData &model, int materialIndex) {
+  if (materialIndex < 0 ||
+      static_cast<size_t>(materialIndex) >= model.materials.size()) {
+    return {};
+  }
+  return model.materials[static_cast<size_t>(materialIndex)].textureFilePath;
+}
+
+size_t EstimateModelDataBytes(const ModelData &model) {
+  size_t bytes = sizeof(ModelData);
+  for (const MeshData &mesh : model.meshes) {
+    bytes += sizeof(MeshData) + mesh.vertices.capacity() * sizeof(VertexData) +
+             mesh.indices.capacity() * sizeof(uint32_t) +
+             mesh.influences.capacity() * sizeof(VertexInfluence);
+    for (const MeshLod &lod : mesh.lods) {
+      bytes += sizeof(MeshLod) + lod.indices.capacity() * sizeof(uint32_t);
+    }
+    bytes += mesh.meshlets.capacity() * sizeof(Meshlet);
+  }
+  for (const MaterialData &mat : model.materials) {
+    bytes += sizeof(MaterialData) + mat.textureFilePath.capacity();
+  }
+  bytes += model.joints.capacity() * sizeof(SkinJoint);
+  for (const AnimationClip &clip : model.animations) {
+    bytes += sizeof(AnimationClip) + Animation::EstimateClipBytes(clip);
   }
-  return {};
+  return bytes + model.nodes.EstimateBytes();
 }
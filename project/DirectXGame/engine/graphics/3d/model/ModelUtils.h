@@ -9,38 +9,9 @@
 
 #include "Matrix.h"
 #include "Method.h"
+#include "ModelData.h"
 #include "Vector.h"
 
-// ===== CPU側のモデルデータ（OBJ/MTL読み込み結果） =====
-
-struct VertexData {
-  Vector4 position{};
-  Vector2 texcoord{};
-  Vector3 normal{};
-};
-
-struct MaterialData {
-  std::string textureFilePath;
-};
-
-struct MeshData {
-  std::vector<VertexData> vertices;
-  int materialIndex = -1;
-};
-
-struct Node {
-  Matrix4x4 localMatrix{};
-  std::string name;
-  std::vector<uint32_t> meshIndices;
-  std::vector<Node> children;
-};
-
-struct ModelData {
-  std::vector<MeshData> meshes;
-  std::vector<MaterialData> materials;
-  Node rootNode;
-};
-
 Matrix4x4 ConvertAssimpMatrix(const aiMatrix4x4 &a);
 Matrix4x4 ConvertAssimpMatrixTransposed(const aiMatrix4x4 &a);
 
@@ -54,5 +25,39 @@ VertexData FixupVertex_AssimpToEngine(const VertexData &v,
 
 void FlipTriangleWinding(VertexData &a, VertexData &b, VertexData &c);
 
-std::vector<VertexData> FlattenVertices(const ModelData &model);
-std::string PickDiffuseTexturePath(const ModelData &model);
+// 1 本の頂点/インデックス列の中の、同じマテリアルで描く範囲
+struct SubmeshRange {
+  uint32_t indexStart = 0;
+  uint32_t indexCount = 0;
+  int materialIndex = -1;
+};
+
+// 全メッシュを 1 本の頂点/インデックス列にまとめる（インデックスは連結後の番号）
+// 同じマテリアルのメッシュは隣り合わせに並べ、マテリアルごとに 1 つの範囲にする
+// AssetLoader 経由のモデルは取り込み時に MeshMerger でまとめ済み（ここでは写すだけ）
+// influences を渡すと頂点と同じ並びで詰める（スキン無しのモデルなら空）
+void FlattenMeshes(const ModelData &model, std::vector<VertexData> &vertices,
+                   std::vector<uint32_t> &indices,
+                   std::vector<SubmeshRange> &submeshes,
+                   std::vector<VertexInfluence> *influences = nullptr);
+// LOD の段数（LOD0 を含む。メッシュごとの段数の最大）
+uint32_t GetLodCount(const ModelData &model);
+// lod 段目の誤差（全メッシュの最大。LOD0 は 0）
+float GetLodError(const ModelData &model, uint32_t lod);
+// FlattenMeshes と同じ並び・頂点番号で、lod 段目のインデックスを indices の後ろに足す
+// submeshes には FlattenMeshes と同じ数の範囲を足す（段の足りないメッシュは一番粗い段）
+void AppendMeshLod(const ModelData &model, uint32_t lod,
+                   std::vector<uint32_t> &indices,
+                   std::vector<SubmeshRange> &submeshes);
+// どれかのメッシュがメッシュレットを持つか
+bool HasMeshlets(const ModelData &model);
+// FlattenMeshes と同じ並びで全メッシュのメッシュレットを連結する（範囲は連結後の番号）
+// メッシュレットの無いメッシュはメッシュ全体を 1 つの塊として足す
+// submeshFirst には FlattenMeshes の範囲ごとの先頭の塊の番号を入れる（末尾に総数）
+void FlattenMeshlets(const ModelData &model, std::vector<Meshlet> &meshlets,
+                     std::vector<uint32_t> &submeshFirst);
+// マテリアルのテクスチャ。無ければ空文字
+std::string GetMaterialTexturePath(const ModelData &model, int materialIndex);
+
+// CPU 側で持っているおおよそのバイト数（キャッシュの予算計上用）
+size_t EstimateModelDataBytes(const ModelData &model);
@@ -0,0 +1,136 @@
+#include "NodeHierarchy.h"
+#include "Method.h"
+#include <algorithm>
+#include <cassert>
+
+uint32_t NodeHierarchy::HashName(std::string_view name) {
+  uint32_t hash = 0x811C9DC5u;
+  for (char c : name) {
+    hash = (hash ^ static_cast<uint8_t>(c)) * 0x01000193u;
+  }
+  return hash;
+}
+
+void NodeHierarchy::Clear() {
+  parents_.clear();
+  localMatrices_.clear();
+  globalMatrices_.clear();
+  dirty_.clear();
+  nameIds_.clear();
+  names_.clear();
+  meshIndexFirst_.clear();
+  meshIndexCount_.clear();
+  meshIndices_.clear();
+  nameLookup_.clear();
+  firstDirty_ = 0;
+}
+
+void NodeHierarchy::Reserve(size_t nodeCount) {
+  parents_.reserve(nodeCount);
+  localMatrices_.reserve(nodeCount);
+  globalMatrices_.reserve(nodeCount);
+  dirty_.reserve(nodeCount);
+  nameIds_.reserve(nodeCount);
+  names_.reserve(nodeCount);
+  meshIndexFirst_.reserve(nodeCount);
+  meshIndexCount_.reserve(nodeCount);
+  nameLookup_.reserve(nodeCount);
+}
+
+uint32_t NodeHierarchy::AddNode(uint32_t parent, std::string_view name,
+                                const Matrix4x4 &localMatrix,
+                                std::span<const uint32_t> meshIndices) {
+  const uint32_t node = GetCount();
+  assert(parent == kNone || parent < node);
+
+  const uint32_t nameId = HashName(name);
+  parents_.push_back(parent);
+  localMatrices_.push_back(localMatrix);
+  globalMatrices_.push_back(localMatrix);
+  dirty_.push_back(1);
+  nameIds_.push_back(nameId);
+  names_.emplace_back(name);
+  meshIndexFirst_.push_back(static_cast<uint32_t>(meshIndices_.size()));
+  meshIndexCount_.push_back(static_cast<uint32_t>(meshIndices.size()));
+  meshIndices_.insert(meshIndices_.end(), meshIndices.begin(),
+                      meshIndices.end());
+  nameLookup_.try_emplace(nameId, node);
+
+  firstDirty_ = std::min(firstDirty_, node);
+  return node;
+}
+
+std::span<const uint32_t> NodeHierarchy::GetMeshIndices(uint32_t node) const {
+  return std::span<const uint32_t>(meshIndices_)
+      .subspan(meshIndexFirst_[node], meshIndexCount_[node]);
+}
+
+uint32_t NodeHierarchy::FindNode(std::string_view name) const {
+  const uint32_t nameId = HashName(name);
+  auto it = nameLookup_.find(nameId);
+  if (it == nameLookup_.end()) {
+    return kNone;
+  }
+  if (names_[it->second] == name) {
+    return it->second;
+  }
+  // 別の名前と ID が衝突している（まず起きないので線形に探す）
+  for (uint32_t i = it->second + 1; i < GetCount(); ++i) {
+    if (nameIds_[i] == nameId && names_[i] == name) {
+      return i;
+    }
+  }
+  return kNone;
+}
+
+void NodeHierarchy::SetLocalMatrix(uint32_t node,
+                                   const Matrix4x4 &localMatrix) {
+  localMatrices_[node] = localMatrix;
+  dirty_[node] = 1;
+  firstDirty_ = std::min(firstDirty_, node);
+}
+
+uint32_t NodeHierarchy::UpdateGlobalMatrices() {
+  const uint32_t count = GetCount();
+  uint32_t updated = 0;
+
+  // 親が先に並んでいるので、親の dirty を子へ流しながら 1 回なめれば足りる
+  for (uint32_t i = firstDirty_; i < count; ++i) {
+    const uint32_t parent = parents_[i];
+    if (parent != kNone && dirty_[parent]) {
+      dirty_[i] = 1;
+    }
+    if (!dirty_[i]) {
+      continue;
+    }
+    globalMatrices_[i] =
+        (parent == kNone)
+            ? localMatrices_[i]
+            : Multiply(localMatrices_[i], globalMatrices_[parent]);
+    ++updated;
+  }
+
+  if (firstDirty_ < count) {
+    std::fill(dirty_.begin() + firstDirty_, dirty_.end(), uint8_t{0});
+  }
+  firstDirty_ = count;
+  return updated;
+}
+
+size_t NodeHierarchy::EstimateBytes() const {
+  size_t bytes = parents_.capacity() * sizeof(uint32_t);
+  bytes += (localMatrices_.capacity() + globalMatrices_.capacity()) *
+           sizeof(Matrix4x4);
+  bytes += dirty_.capacity();
+  bytes += nameIds_.capacity() * sizeof(uint32_t);
+  bytes += names_.capacity() * sizeof(std::string);
+  for (const std::string &name : names_) {
+    bytes += name.capacity();
+  }
+  bytes += (meshIndexFirst_.capacity() + meshIndexCount_.capacity() +
+            meshIndices_.capacity()) *
+           sizeof(uint32_t);
+  // unordered_map はノード 1 つにつき要素 + 次ポインタ + バケット程度
+  bytes += nameLookup_.size() * (sizeof(uint32_t) * 2 + sizeof(void *) * 2);
+  return bytes;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "Matrix.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// モデルのノード階層（ノードごとの値を番号で引く配列の集まり）
+// - 親は必ず子より前に並ぶ（行きがけ順）。グローバル行列は先頭から 1 回なめれば求まる
+// - SetLocalMatrix したノードの部分木だけを次の UpdateGlobalMatrices で計算し直す
+// - 行列は行ベクトル規約（global = local * parentGlobal）
+// - 名前は HashName の ID で引く（文字列の比較は ID が一致した時だけ）
+class NodeHierarchy {
+public:
+  static constexpr uint32_t kNone = 0xFFFFFFFFu; // 親なし / 見つからない
+
+  // FNV-1a（32bit）
+  static uint32_t HashName(std::string_view name);
+
+  // 確保済み容量は残す
+  void Clear();
+  void Reserve(size_t nodeCount);
+
+  // parent は追加済みのノード（ルートは kNone）。追加したノードの番号を返す
+  uint32_t AddNode(uint32_t parent, std::string_view name,
+                   const Matrix4x4 &localMatrix,
+                   std::span<const uint32_t> meshIndices = {});
+
+  uint32_t GetCount() const { return static_cast<uint32_t>(parents_.size()); }
+  uint32_t GetParent(uint32_t node) const { return parents_[node]; }
+  const std::string &GetName(uint32_t node) const { return names_[node]; }
+  uint32_t GetNameId(uint32_t node) const { return nameIds_[node]; }
+  std::span<const uint32_t> GetMeshIndices(uint32_t node) const;
+
+  // 同じ名前が複数あれば先に追加した方。無ければ kNone
+  uint32_t FindNode(std::string_view name) const;
+
+  const Matrix4x4 &GetLocalMatrix(uint32_t node) const {
+    return localMatrices_[node];
+  }
+  void SetLocalMatrix(uint32_t node, const Matrix4x4 &localMatrix);
+
+  // 変更のあった部分木のグローバル行列を計算し直す。計算したノード数を返す
+  uint32_t UpdateGlobalMatrices();
+  // 最後の UpdateGlobalMatrices 時点の値
+  const Matrix4x4 &GetGlobalMatrix(uint32_t node) const {
+    return globalMatrices_[node];
+  }
+
+  // 配列が確保しているおおよそのバイト数（sizeof(NodeHierarchy) は含まない）
+  size_t EstimateBytes() const;
+
+private:
+  std::vector<uint32_t> parents_;
+  std::vector<Matrix4x4> localMatrices_;
+  std::vector<Matrix4x4> globalMatrices_;
+  std::vector<uint8_t> dirty_;
+  std::vector<uint32_t> nameIds_;
+  std::vector<std::string> names_;
+  std::vector<uint32_t> meshIndexFirst_;
+  std::vector<uint32_t> meshIndexCount_;
+  std::vector<uint32_t> meshIndices_;
+
+  // 名前 ID → その ID を持つ最初のノード
+  std::unordered_map<uint32_t, uint32_t> nameLookup_;
+  // これより前のノードは変更なし（GetCount() なら全て計算済み）
+  uint32_t firstDirty_ = 0;
+};
@@ -0,0 +1,555 @@
+#include "ObjImporter.h"
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "Method.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+constexpr uint32_t kNone = 0xFFFFFFFFu;
+// 1 ジョブで読む最小のバイト数（これより小さいファイルは分けない）
+constexpr size_t kMinChunkBytes = 1u << 20;
+// Assimp の OBJ 取り込みと同じく、マテリアル 0 は既定（usemtl が無い面・見つからない名前）
+constexpr const char *kDefaultMaterialName = "DefaultMaterial";
+
+// 面の 1 頂点（三角形に分割済み）
+// 番号は正なら 1 始まりの通し番号、relative のビットが立っていればチャンク内の 0 始まり
+// （負の相対番号をチャンクの先頭からの位置にしたもの。前のチャンクを指すと負になる）。0 = 無し
+struct Corner {
+  int32_t index[3]; // v, vt, vn
+  uint8_t relative;
+};
+
+enum class CommandType : uint8_t { Object, Group, UseMtl, MtlLib };
+
+// 面以外で順序が意味を持つ行（corner は直前までに読んだ三角形の頂点数）
+struct Command {
+  CommandType type;
+  std::string_view name; // マップしたファイルの中を指す
+  size_t corner;
+};
+
+struct Chunk {
+  std::vector<Vector3> positions;
+  std::vector<Vector2> texcoords;
+  std::vector<Vector3> normals;
+  std::vector<Corner> corners;
+  std::vector<Command> commands;
+  std::vector<Corner> polygon; // 1 面ぶんの作業用
+  bool ok = true;
+};
+
+bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+const char *SkipSpace(const char *p, const char *end) {
+  while (p < end && IsSpace(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+std::string_view Trim(const char *p, const char *end) {
+  p = SkipSpace(p, end);
+  while (end > p && IsSpace(end[-1])) {
+    --end;
+  }
+  return {p, static_cast<size_t>(end - p)};
+}
+
+// 行頭のキーワードが word と一致し、後ろが空白か行末か
+bool IsKeyword(const char *p, const char *end, std::string_view word) {
+  const size_t length = word.size();
+  return static_cast<size_t>(end - p) >= length &&
+         std::memcmp(p, word.data(), length) == 0 &&
+         (static_cast<size_t>(end - p) == length || IsSpace(p[length]));
+}
+
+bool ParseFloat(const char *&p, const char *end, float &out) {
+  p = SkipSpace(p, end);
+  // from_chars は先頭の + を受け付けない
+  if (p < end && *p == '+') {
+    ++p;
+  }
+  const std::from_chars_result result = std::from_chars(p, end, out);
+  if (result.ec != std::errc{}) {
+    return false;
+  }
+  p = result.ptr;
+  return true;
+}
+
+bool ParseInt(const char *&p, const char *end, int32_t &out) {
+  if (p < end && *p == '+') {
+    ++p;
+  }
+  const std::from_chars_result result = std::from_chars(p, end, out);
+  if (result.ec != std::errc{} || out == 0) {
+    return false;
+  }
+  p = result.ptr;
+  return true;
+}
+
+// "v" / "v/vt" / "v//vn" / "v/vt/vn"
+bool ParseCorner(const char *&p, const char *end, const Chunk &chunk,
+                 Corner &out) {
+  const size_t counts[3] = {chunk.positions.size(), chunk.texcoords.size(),
+                            chunk.normals.size()};
+  out = Corner{};
+  for (int k = 0; k < 3; ++k) {
+    if (k > 0) {
+      if (p >= end || *p != '/') {
+        break;
+      }
+      ++p;
+      // "v//vn" の vt は無し
+      if (k == 1 && p < end && *p == '/') {
+        continue;
+      }
+    }
+    int32_t value = 0;
+    if (!ParseInt(p, end, value)) {
+      return false;
+    }
+    if (value < 0) {
+      out.index[k] = static_cast<int32_t>(static_cast<int64_t>(counts[k]) + value);
+      out.relative |= static_cast<uint8_t>(1u << k);
+    } else {
+      out.index[k] = value;
+    }
+  }
+  return true;
+}
+
+void ParseLine(const char *p, const char *end, Chunk &chunk) {
+  p = SkipSpace(p, end);
+  if (p >= end || *p == '#') {
+    return;
+  }
+
+  if (p[0] == 'v') {
+    if (IsKeyword(p, end, "v")) {
+      Vector3 v{};
+      p += 1;
+      chunk.ok &= ParseFloat(p, end, v.x) && ParseFloat(p, end, v.y) &&
+                  ParseFloat(p, end, v.z);
+      chunk.positions.push_back(v);
+    } else if (IsKeyword(p, end, "vt")) {
+      // 2 つ目（と 3 つ目）は省略できる
+      Vector2 t{};
+      p += 2;
+      chunk.ok &= ParseFloat(p, end, t.x);
+      ParseFloat(p, end, t.y);
+      chunk.texcoords.push_back(t);
+    } else if (IsKeyword(p, end, "vn")) {
+      Vector3 n{};
+      p += 2;
+      chunk.ok &= ParseFloat(p, end, n.x) && ParseFloat(p, end, n.y) &&
+                  ParseFloat(p, end, n.z);
+      chunk.normals.push_back(n);
+    }
+    return;
+  }
+
+  if (IsKeyword(p, end, "f")) {
+    p += 1;
+    chunk.polygon.clear();
+    while (true) {
+      p = SkipSpace(p, end);
+      if (p >= end) {
+        break;
+      }
+      Corner c{};
+      if (!ParseCorner(p, end, chunk, c)) {
+        chunk.ok = false;
+        return;
+      }
+      chunk.polygon.push_back(c);
+    }
+    // 多角形は先頭の頂点から扇状に分ける（凸多角形を前提にする）
+    for (size_t i = 1; i + 1 < chunk.polygon.size(); ++i) {
+      chunk.corners.push_back(chunk.polygon[0]);
+      chunk.corners.push_back(chunk.polygon[i]);
+      chunk.corners.push_back(chunk.polygon[i + 1]);
+    }
+    return;
+  }
+
+  CommandType type{};
+  size_t keywordLength = 0;
+  if (IsKeyword(p, end, "o")) {
+    type = CommandType::Object;
+    keywordLength = 1;
+  } else if (IsKeyword(p, end, "g")) {
+    // 複数の名前（"g a b"）は Assimp と同じく先頭だけを使う
+    std::string_view name = Trim(p + 1, end);
+    const size_t space = name.find_first_of(" \t");
+    chunk.commands.push_back({CommandType::Group, name.substr(0, space),
+                              chunk.corners.size()});
+    return;
+  } else if (IsKeyword(p, end, "usemtl")) {
+    type = CommandType::UseMtl;
+    keywordLength = 6;
+  } else if (IsKeyword(p, end, "mtllib")) {
+    type = CommandType::MtlLib;
+    keywordLength = 6;
+  } else {
+    return; // s / l / p などは使わない
+  }
+  chunk.commands.push_back(
+      {type, Trim(p + keywordLength, end), chunk.corners.size()});
+}
+
+void ParseChunk(const char *p, const char *end, Chunk &chunk) {
+  while (p < end && chunk.ok) {
+    const void *newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    const char *lineEnd =
+        newline ? static_cast<const char *>(newline) : end;
+    ParseLine(p, lineEnd, chunk);
+    p = lineEnd < end ? lineEnd + 1 : end;
+  }
+}
+
+// newmtl の順に materials へ足す（名前 → 番号は names へ）
+void ParseMtl(const std::string &directoryPath, const std::string &path,
+              std::vector<MaterialData> &materials,
+              std::unordered_map<std::string, int> &names) {
+  MappedFile file;
+  if (!file.Open(path)) {
+    return;
+  }
+  const char *p = reinterpret_cast<const char *>(file.GetData());
+  const char *end = p + file.GetSize();
+  int current = -1;
+  while (p < end) {
+    const void *newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    const char *lineEnd =
+        newline ? static_cast<const char *>(newline) : end;
+    const char *q = SkipSpace(p, lineEnd);
+    if (IsKeyword(q, lineEnd, "newmtl")) {
+      const std::string name(Trim(q + 6, lineEnd));
+      current = static_cast<int>(materials.size());
+      materials.emplace_back();
+      names.emplace(name, current);
+    } else if (IsKeyword(q, lineEnd, "map_Kd") && current >= 0) {
+      // "-s 1 1 1 file.png" のようなオプションがあれば最後の語をファイル名とみなす
+      std::string_view texture = Trim(q + 6, lineEnd);
+      if (!texture.empty() && texture[0] == '-') {
+        const size_t space = texture.find_last_of(" \t");
+        texture = texture.substr(space == std::string_view::npos ? 0 : space + 1);
+      }
+      if (!texture.empty()) {
+        materials[static_cast<size_t>(current)].textureFilePath =
+            directoryPath + "/" + std::string(texture);
+      }
+    }
+    p = lineEnd < end ? lineEnd + 1 : end;
+  }
+}
+
+// 1 メッシュぶんの組み立て（(v, vt, vn) の組で頂点を溶接する）
+class MeshBuilder {
+public:
+  MeshBuilder(const std::vector<Vector3> &positions,
+              const std::vector<Vector2> &texcoords,
+              const std::vector<Vector3> &normals)
+      : positions_(positions), texcoords_(texcoords), normals_(normals),
+        head_(positions.size(), kNone) {}
+
+  bool IsEmpty() const { return mesh_.indices.empty(); }
+  int GetMaterial() const { return mesh_.materialIndex; }
+  void SetMaterial(int material) { mesh_.materialIndex = material; }
+
+  void AddTriangle(const uint32_t (&corner)[3][3]) {
+    uint32_t welded[3];
+    for (int k = 0; k < 3; ++k) {
+      welded[k] = Weld_(corner[k][0], corner[k][1], corner[k][2]);
+    }
+    // 左手系にしたので巻き順を逆にする（時計回りが表）
+    mesh_.indices.push_back(welded[2]);
+    mesh_.indices.push_back(welded[1]);
+    mesh_.indices.push_back(welded[0]);
+  }
+
+  // 組み立て中のメッシュを渡し、次のメッシュ用に空にする
+  MeshData Finish() {
+    if (missingNormals_) {
+      GenerateNormals_();
+    }
+    for (uint32_t v : touched_) {
+      head_[v] = kNone;
+    }
+    touched_.clear();
+    entries_.clear();
+    missingNormals_ = false;
+    MeshData mesh = std::move(mesh_);
+    mesh_ = MeshData{};
+    mesh_.materialIndex = mesh.materialIndex;
+    return mesh;
+  }
+
+private:
+  struct Entry {
+    uint32_t texcoord;
+    uint32_t normal;
+    uint32_t next; // 同じ位置の次の頂点
+  };
+
+  uint32_t Weld_(uint32_t v, uint32_t vt, uint32_t vn) {
+    for (uint32_t i = head_[v]; i != kNone; i = entries_[i].next) {
+      if (entries_[i].texcoord == vt && entries_[i].normal == vn) {
+        return i;
+      }
+    }
+
+    const uint32_t index = static_cast<uint32_t>(mesh_.vertices.size());
+    if (head_[v] == kNone) {
+      touched_.push_back(v);
+    }
+    entries_.push_back({vt, vn, head_[v]});
+    head_[v] = index;
+
+    // ConvertToLeftHanded: z を反転し、V を上下反転する
+    const Vector3 &p = positions_[v];
+    VertexData vertex{};
+    vertex.position = {p.x, p.y, -p.z, 1.0f};
+    if (vt != kNone) {
+      vertex.texcoord = {texcoords_[vt].x, 1.0f - texcoords_[vt].y};
+    }
+    if (vn != kNone) {
+      const Vector3 &n = normals_[vn];
+      vertex.normal = {n.x, n.y, -n.z};
+    } else {
+      missingNormals_ = true;
+    }
+    mesh_.vertices.push_back(vertex);
+    return index;
+  }
+
+  // GenSmoothNormals と同じく、同じ位置の頂点で面の法線を平均する
+  void GenerateNormals_() {
+    std::vector<Vector3> sum(mesh_.vertices.size(), Vector3{0, 0, 0});
+    const auto position = [&](uint32_t i) {
+      const Vector4 &p = mesh_.vertices[i].position;
+      return Vector3{p.x, p.y, p.z};
+    };
+    for (size_t i = 0; i < mesh_.indices.size(); i += 3) {
+      const Vector3 a = position(mesh_.indices[i + 0]);
+      const Vector3 b = position(mesh_.indices[i + 1]);
+      const Vector3 c = position(mesh_.indices[i + 2]);
+      // 時計回りが表なので (b - a) x (c - a) が外向き
+      const Vector3 n = Cross({b.x - a.x, b.y - a.y, b.z - a.z},
+                              {c.x - a.x, c.y - a.y, c.z - a.z});
+      const float length = std::sqrt(Dot(n, n));
+      if (length <= 0.0f) {
+        continue;
+      }
+      for (size_t k = 0; k < 3; ++k) {
+        sum[mesh_.indices[i + k]] = Add(
+            sum[mesh_.indices[i + k]], {n.x / length, n.y / length, n.z / length});
+      }
+    }
+    for (uint32_t v : touched_) {
+      Vector3 total{0, 0, 0};
+      for (uint32_t i = head_[v]; i != kNone; i = entries_[i].next) {
+        total = Add(total, sum[i]);
+      }
+      const float length = std::sqrt(Dot(total, total));
+      const Vector3 normal =
+          length > 0.0f
+              ? Vector3{total.x / length, total.y / length, total.z / length}
+              : Vector3{0.0f, 1.0f, 0.0f};
+      for (uint32_t i = head_[v]; i != kNone; i = entries_[i].next) {
+        if (entries_[i].normal == kNone) {
+          mesh_.vertices[i].normal = normal;
+        }
+      }
+    }
+  }
+
+  const std::vector<Vector3> &positions_;
+  const std::vector<Vector2> &texcoords_;
+  const std::vector<Vector3> &normals_;
+  std::vector<uint32_t> head_; // OBJ の位置の番号 → その位置の最後の頂点
+  std::vector<uint32_t> touched_;
+  std::vector<Entry> entries_; // 頂点と同じ並び
+  bool missingNormals_ = false;
+  MeshData mesh_;
+};
+
+} // namespace
+
+namespace ObjImporter {
+
+bool Import(const std::string &directoryPath, const std::string &filePath,
+            ModelData &out) {
+  MappedFile file;
+  if (!file.Open(filePath)) {
+    return false;
+  }
+  const char *data = reinterpret_cast<const char *>(file.GetData());
+  const size_t size = file.GetSize();
+
+  // 行の境目で区切って並列に読む
+  JobSystem *jobs = JobSystem::GetInstance();
+  const size_t chunkCount = std::clamp<size_t>(
+      size / kMinChunkBytes, 1, static_cast<size_t>(jobs->GetWorkerCount()) + 1);
+  std::vector<size_t> bounds(chunkCount + 1, size);
+  bounds[0] = 0;
+  for (size_t i = 1; i < chunkCount; ++i) {
+    size_t b = std::max(size * i / chunkCount, bounds[i - 1]);
+    const void *newline = std::memchr(data + b, '\n', size - b);
+    bounds[i] = newline ? static_cast<size_t>(
+                              static_cast<const char *>(newline) - data) + 1
+                        : size;
+  }
+  std::vector<Chunk> chunks(chunkCount);
+  jobs->Dispatch(static_cast<uint32_t>(chunkCount), [&](uint32_t i) {
+    ParseChunk(data + bounds[i], data + bounds[i + 1], chunks[i]);
+  });
+
+  // 属性を連結し、チャンクごとの先頭の番号を求める
+  std::vector<Vector3> positions;
+  std::vector<Vector2> texcoords;
+  std::vector<Vector3> normals;
+  std::vector<size_t> base[3];
+  for (Chunk &chunk : chunks) {
+    if (!chunk.ok) {
+      return false;
+    }
+    base[0].push_back(positions.size());
+    base[1].push_back(texcoords.size());
+    base[2].push_back(normals.size());
+    positions.insert(positions.end(), chunk.positions.begin(),
+                     chunk.positions.end());
+    texcoords.insert(texcoords.end(), chunk.texcoords.begin(),
+                     chunk.texcoords.end());
+    normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+    chunk.positions = {};
+    chunk.texcoords = {};
+    chunk.normals = {};
+  }
+  const size_t counts[3] = {positions.size(), texcoords.size(),
+                            normals.size()};
+
+  // マテリアル（usemtl より前に全ての mtllib を読んでおく）
+  out = ModelData{};
+  std::unordered_map<std::string, int> materialNames;
+  out.materials.emplace_back();
+  materialNames.emplace(kDefaultMaterialName, 0);
+  for (const Chunk &chunk : chunks) {
+    for (const Command &command : chunk.commands) {
+      if (command.type == CommandType::MtlLib) {
+        ParseMtl(directoryPath,
+                 directoryPath + "/" + std::string(command.name),
+                 out.materials, materialNames);
+      }
+    }
+  }
+
+  // o・g と usemtl の切り替えでメッシュを分ける（Assimp の OBJ 取り込みと同じ）
+  // g はグループ名が変わった時だけオブジェクトとして分ける（o を挟んでも名前は引き継ぐ）
+  struct ObjectNode {
+    std::string name;
+    std::vector<uint32_t> meshes;
+  };
+  std::vector<ObjectNode> objects;
+  std::string objectName = "defaultobject";
+  std::string_view groupName;
+  bool objectOpen = false;
+  MeshBuilder builder(positions, texcoords, normals);
+  builder.SetMaterial(0);
+  const auto finishMesh = [&]() {
+    if (builder.IsEmpty()) {
+      return;
+    }
+    if (!objectOpen) {
+      objects.push_back({objectName, {}});
+      objectOpen = true;
+    }
+    objects.back().meshes.push_back(static_cast<uint32_t>(out.meshes.size()));
+    out.meshes.push_back(builder.Finish());
+  };
+
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    const Chunk &chunk = chunks[c];
+    size_t corner = 0;
+    size_t commandIndex = 0;
+    while (corner < chunk.corners.size() ||
+           commandIndex < chunk.commands.size()) {
+      // この位置より前に来る指示を先に処理する
+      if (commandIndex < chunk.commands.size() &&
+          chunk.commands[commandIndex].corner <= corner) {
+        const Command &command = chunk.commands[commandIndex++];
+        if (command.type == CommandType::Object) {
+          finishMesh();
+          objectName = std::string(command.name);
+          objectOpen = false;
+        } else if (command.type == CommandType::Group) {
+          if (command.name != groupName) {
+            finishMesh();
+            groupName = command.name;
+            objectName = std::string(command.name);
+            objectOpen = false;
+          }
+        } else if (command.type == CommandType::UseMtl) {
+          const auto it = materialNames.find(std::string(command.name));
+          const int material = it != materialNames.end() ? it->second : 0;
+          if (material != builder.GetMaterial()) {
+            finishMesh();
+            builder.SetMaterial(material);
+          }
+        }
+        continue;
+      }
+
+      uint32_t resolved[3][3];
+      for (size_t k = 0; k < 3; ++k) {
+        const Corner &src = chunk.corners[corner + k];
+        for (int a = 0; a < 3; ++a) {
+          int64_t index = src.index[a];
+          if (src.relative & (1u << a)) {
+            index += static_cast<int64_t>(base[a][c]);
+          } else if (index == 0) {
+            if (a == 0) {
+              return false;
+            }
+            resolved[k][a] = kNone;
+            continue;
+          } else {
+            index -= 1;
+          }
+          if (index < 0 || static_cast<size_t>(index) >= counts[a]) {
+            return false;
+          }
+          resolved[k][a] = static_cast<uint32_t>(index);
+        }
+      }
+      builder.AddTriangle(resolved);
+      corner += 3;
+    }
+  }
+  finishMesh();
+  if (out.meshes.empty()) {
+    return false;
+  }
+
+  // ルートの下にオブジェクトごとのノード
+  const Matrix4x4 identity = MakeIdentity4x4();
+  const uint32_t root = out.nodes.AddNode(
+      NodeHierarchy::kNone,
+      std::filesystem::path(filePath).filename().string(), identity);
+  for (const ObjectNode &object : objects) {
+    out.nodes.AddNode(root, object.name, identity, object.meshes);
+  }
+  out.nodes.UpdateGlobalMatrices();
+  return true;
+}
+
+} // namespace ObjImporter
@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+
+#include "ModelData.h"
+
+// OBJ / MTL を Assimp を通さずに直接 ModelData にする
+// - ファイルはメモリマップし、行の切り出し・数値の変換（from_chars）はその上で直接行う
+// - 大きなファイルは行の境目で区切り、JobSystem で並列に読む
+// - 頂点は (v, vt, vn) の番号の組で溶接する（値の比較はしない）
+// - o・g（名前が変わった時）でノードを、usemtl でメッシュを分ける
+// - 結果は Assimp の Triangulate | ConvertToLeftHanded | GenSmoothNormals |
+//   JoinIdenticalVertices と同じ形（左手系・時計回り・V 反転、マテリアル 0 は既定）
+// - 頂点の並べ替え等の最適化は呼び出し側（AssetLoader）で行う
+namespace ObjImporter {
+
+// 読めない・OBJ として解釈できない（範囲外の番号など）なら false（out は未定義）
+bool Import(const std::string &directoryPath, const std::string &filePath,
+            ModelData &out);
+
+} // namespace ObjImporter
@@ -0,0 +1,191 @@
+#include "VertexPacking.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+int16_t ToSnorm16(float v) {
+  v = std::clamp(v, -1.0f, 1.0f);
+  return static_cast<int16_t>(std::lround(v * 32767.0f));
+}
+
+float FromSnorm16(int16_t v) {
+  // -32768 も -1.0 に丸める（D3D の SNORM 変換規則）
+  return std::max(static_cast<float>(v) / 32767.0f, -1.0f);
+}
+
+uint16_t ToUnorm16(float v) {
+  v = std::clamp(v, 0.0f, 1.0f);
+  return static_cast<uint16_t>(std::lround(v * 65535.0f));
+}
+
+float FromUnorm16(uint16_t v) { return static_cast<float>(v) / 65535.0f; }
+
+float SignNotZero(float v) { return v >= 0.0f ? 1.0f : -1.0f; }
+
+} // namespace
+
+namespace VertexPacking {
+
+uint16_t FloatToHalf(float value) {
+  uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  const uint32_t sign = (bits >> 16) & 0x8000u;
+  const uint32_t absBits = bits & 0x7FFFFFFFu;
+
+  if (absBits >= 0x7F800000u) {
+    // Inf / NaN
+    const uint32_t nan = absBits > 0x7F800000u ? 0x0200u : 0u;
+    return static_cast<uint16_t>(sign | 0x7C00u | nan);
+  }
+  if (absBits >= 0x477FF000u) {
+    // half の最大値 65504 を超えたら Inf
+    return static_cast<uint16_t>(sign | 0x7C00u);
+  }
+  if (absBits < 0x38800000u) {
+    // 非正規化数（2^-14 未満）。最近接偶数丸め
+    if (absBits < 0x33000000u) {
+      return static_cast<uint16_t>(sign);
+    }
+    const uint32_t exponent = absBits >> 23;
+    const uint32_t mantissa = (absBits & 0x007FFFFFu) | 0x00800000u;
+    const uint32_t shift = 126u - exponent; // 14..24
+    uint32_t half = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+    const uint32_t halfway = 1u << (shift - 1u);
+    if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+      ++half;
+    }
+    return static_cast<uint16_t>(sign | half);
+  }
+
+  // 正規化数。指数を付け替えて仮数の下位 13 ビットを最近接偶数で丸める
+  uint32_t half = ((absBits - 0x38000000u) >> 13);
+  const uint32_t remainder = absBits & 0x1FFFu;
+  if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+    ++half; // 仮数の桁上がりはそのまま指数に繰り上がる
+  }
+  return static_cast<uint16_t>(sign | half);
+}
+
+float HalfToFloat(uint16_t half) {
+  const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+  uint32_t exponent = (half >> 10) & 0x1Fu;
+  uint32_t mantissa = half & 0x3FFu;
+
+  uint32_t bits = 0;
+  if (exponent == 0x1Fu) {
+    bits = sign | 0x7F800000u | (mantissa << 13);
+  } else if (exponent == 0) {
+    if (mantissa == 0) {
+      bits = sign;
+    } else {
+      // 非正規化数を正規化する
+      exponent = 113; // 127 - 15 + 1
+      while ((mantissa & 0x400u) == 0) {
+        mantissa <<= 1;
+        --exponent;
+      }
+      mantissa &= 0x3FFu;
+      bits = sign | (exponent << 23) | (mantissa << 13);
+    }
+  } else {
+    bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+  }
+
+  float value = 0.0f;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void EncodeOctahedral(const Vector3 &n, int16_t out[2]) {
+  const float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+  float x = 0.0f;
+  float y = 0.0f;
+  if (l1 > 0.0f) {
+    x = n.x / l1;
+    y = n.y / l1;
+    if (n.z < 0.0f) {
+      // 下半球は対角線で折り返す
+      const float fx = (1.0f - std::abs(y)) * SignNotZero(x);
+      const float fy = (1.0f - std::abs(x)) * SignNotZero(y);
+      x = fx;
+      y = fy;
+    }
+  }
+  out[0] = ToSnorm16(x);
+  out[1] = ToSnorm16(y);
+}
+
+Vector3 DecodeOctahedral(const int16_t in[2]) {
+  Vector3 n{FromSnorm16(in[0]), FromSnorm16(in[1]), 0.0f};
+  n.z = 1.0f - std::abs(n.x) - std::abs(n.y);
+  const float t = std::max(-n.z, 0.0f);
+  n.x += n.x >= 0.0f ? -t : t;
+  n.y += n.y >= 0.0f ? -t : t;
+  const float len = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+  return {n.x / len, n.y / len, n.z / len};
+}
+
+PackedVertexBounds ComputeBounds(const float *positions, size_t stride,
+                                 size_t count) {
+  PackedVertexBounds b{};
+  if (!positions || count == 0) {
+    return b;
+  }
+  float mn[3] = {positions[0], positions[1], positions[2]};
+  float mx[3] = {mn[0], mn[1], mn[2]};
+  for (size_t i = 1; i < count; ++i) {
+    const float *p = reinterpret_cast<const float *>(
+        reinterpret_cast<const uint8_t *>(positions) + i * stride);
+    for (int k = 0; k < 3; ++k) {
+      mn[k] = std::min(mn[k], p[k]);
+      mx[k] = std::max(mx[k], p[k]);
+    }
+  }
+  b.min = {mn[0], mn[1], mn[2]};
+  // 平たいメッシュの軸は 0 除算を避けて 1 にする（量子化値は常に 0）
+  b.extent = {mx[0] > mn[0] ? mx[0] - mn[0] : 1.0f,
+              mx[1] > mn[1] ? mx[1] - mn[1] : 1.0f,
+              mx[2] > mn[2] ? mx[2] - mn[2] : 1.0f};
+  return b;
+}
+
+PackedVertex Pack(const Vector4 &position, const Vector2 &texcoord,
+                  const Vector3 &normal, const PackedVertexBounds &bounds) {
+  PackedVertex v{};
+  v.position[0] = ToUnorm16((position.x - bounds.min.x) / bounds.extent.x);
+  v.position[1] = ToUnorm16((position.y - bounds.min.y) / bounds.extent.y);
+  v.position[2] = ToUnorm16((position.z - bounds.min.z) / bounds.extent.z);
+  v.position[3] = 0xFFFFu; // w = 1.0
+  v.texcoord[0] = FloatToHalf(texcoord.x);
+  v.texcoord[1] = FloatToHalf(texcoord.y);
+  EncodeOctahedral(normal, v.normal);
+  return v;
+}
+
+void Unpack(const PackedVertex &v, const PackedVertexBounds &bounds,
+            Vector4 &position, Vector2 &texcoord, Vector3 &normal) {
+  position = {bounds.min.x + FromUnorm16(v.position[0]) * bounds.extent.x,
+              bounds.min.y + FromUnorm16(v.position[1]) * bounds.extent.y,
+              bounds.min.z + FromUnorm16(v.position[2]) * bounds.extent.z,
+              FromUnorm16(v.position[3])};
+  texcoord = {HalfToFloat(v.texcoord[0]), HalfToFloat(v.texcoord[1])};
+  normal = DecodeOctahedral(v.normal);
+}
+
+Matrix4x4 MakeDequantizeMatrix(const PackedVertexBounds &bounds) {
+  Matrix4x4 m{};
+  m.m[0][0] = bounds.extent.x;
+  m.m[1][1] = bounds.extent.y;
+  m.m[2][2] = bounds.extent.z;
+  m.m[3][0] = bounds.min.x;
+  m.m[3][1] = bounds.min.y;
+  m.m[3][2] = bounds.min.z;
+  m.m[3][3] = 1.0f;
+  return m;
+}
+
+} // namespace VertexPacking
@@ -0,0 +1,52 @@
+#pragma once
+#include "Matrix.h"
+#include "Vector.h"
+#include <cstddef>
+#include <cstdint>
+
+// ModelResource の頂点形式
+enum class ModelVertexFormat : uint32_t {
+  Full,   // VertexData そのまま（36 バイト）
+  Packed, // PackedVertex（16 バイト）
+};
+
+// 圧縮頂点（UnifiedPipeline::MakeObject3DDesc(packed) の入力レイアウトと一致させる）
+// - position: メッシュの範囲で正規化した UNORM16 ×3 + w(=1.0)
+//   逆量子化は MakeDequantizeMatrix で World/WVP に畳み込むのでシェーダ側は不要
+// - texcoord: half ×2
+// - normal  : 八面体エンコードの SNORM16 ×2（ModelVertex.hlsli で復元）
+struct PackedVertex {
+  uint16_t position[4];
+  uint16_t texcoord[2];
+  int16_t normal[2];
+};
+static_assert(sizeof(PackedVertex) == 16);
+
+// 量子化の基準範囲
+struct PackedVertexBounds {
+  Vector3 min{0.0f, 0.0f, 0.0f};
+  Vector3 extent{1.0f, 1.0f, 1.0f}; // 0 の軸は 1 に置き換え済み
+};
+
+namespace VertexPacking {
+
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t half);
+
+// n は正規化済みであること
+void EncodeOctahedral(const Vector3 &n, int16_t out[2]);
+Vector3 DecodeOctahedral(const int16_t in[2]);
+
+// positions は stride バイト間隔の先頭 3 float
+PackedVertexBounds ComputeBounds(const float *positions, size_t stride,
+                                 size_t count);
+
+PackedVertex Pack(const Vector4 &position, const Vector2 &texcoord,
+                  const Vector3 &normal, const PackedVertexBounds &bounds);
+void Unpack(const PackedVertex &v, const PackedVertexBounds &bounds,
+            Vector4 &position, Vector2 &texcoord, Vector3 &normal);
+
+// 正規化座標 → モデル座標（行ベクトル規約: p' = p * M）
+Matrix4x4 MakeDequantizeMatrix(const PackedVertexBounds &bounds);
+
+} // namespace VertexPacking
@@ -0,0 +1,104 @@
+#include "FrameUploadAllocator.h"
+#include "DirectXCommon.h"
+#include "DirectXResourceUtils.h"
+#include <cassert>
+#include <d3d12.h>
+
+FrameUploadAllocator::~FrameUploadAllocator() { Finalize(); }
+
+void FrameUploadAllocator::Initialize(DirectXCommon *dx,
+                                      uint64_t bytesPerFrame) {
+  assert(dx);
+  dx_ = dx;
+  frameCount_ = dx_->GetFramesInFlight();
+  growCount_ = 0;
+  CreateBuffer_(bytesPerFrame);
+}
+
+void FrameUploadAllocator::Finalize() {
+  if (buffer_ && mapped_) {
+    buffer_->Unmap(0, nullptr);
+  }
+  mapped_ = nullptr;
+  buffer_.Reset();
+  dx_ = nullptr;
+}
+
+FrameUploadAllocator::Allocation
+FrameUploadAllocator::Allocate(uint64_t size, uint64_t alignment) {
+  assert(mapped_);
+  BeginFrameIfNeeded_();
+
+  const uint32_t slot = dx_->GetFrameIndex();
+  uint64_t offset = slots_[slot].Allocate(size, alignment);
+  if (offset == LinearAllocator::kInvalidOffset) {
+    // 倍々で広げる。今フレームの既存の確保は旧バッファ上でそのまま有効
+    uint64_t newSize = bytesPerFrame_ * 2;
+    while (newSize < size + alignment) {
+      newSize *= 2;
+    }
+    CreateBuffer_(newSize);
+    ++growCount_;
+    currentFrameNumber_ = dx_->GetFramePacer().GetFrameNumber();
+    offset = slots_[slot].Allocate(size, alignment);
+    assert(offset != LinearAllocator::kInvalidOffset);
+  }
+
+  Allocation a{};
+  a.cpu = mapped_ + offset;
+  a.gpu = gpuBase_ + offset;
+  a.size = size;
+  return a;
+}
+
+uint64_t FrameUploadAllocator::GetUsedThisFrame() const {
+  if (!dx_) {
+    return 0;
+  }
+  return slots_[dx_->GetFrameIndex()].GetUsed();
+}
+
+uint32_t FrameUploadAllocator::GetAllocationsThisFrame() const {
+  if (!dx_) {
+    return 0;
+  }
+  return slots_[dx_->GetFrameIndex()].GetAllocationCount();
+}
+
+void FrameUploadAllocator::BeginFrameIfNeeded_() {
+  const uint64_t frameNumber = dx_->GetFramePacer().GetFrameNumber();
+  if (frameNumber == currentFrameNumber_) {
+    return;
+  }
+  // このスロットを前回使ったフレームは Advance の時点で GPU 完了済み
+  slots_[dx_->GetFrameIndex()].Reset();
+  currentFrameNumber_ = frameNumber;
+}
+
+void FrameUploadAllocator::CreateBuffer_(uint64_t bytesPerFrame) {
+  // スロットの境界も定数バッファのアライメントに揃える
+  bytesPerFrame = (bytesPerFrame + kConstantBufferAlignment - 1) &
+                  ~(kConstantBufferAlignment - 1);
+
+  if (buffer_) {
+    if (mapped_) {
+      buffer_->Unmap(0, nullptr);
+    }
+    // 先行フレームと今フレームの既存の確保がまだ参照している
+    dx_->DeferRelease(std::move(buffer_));
+  }
+  mapped_ = nullptr;
+
+  buffer_ = CreateBufferResource(dx_->GetDevice(),
+                                 static_cast<size_t>(bytesPerFrame * frameCount_));
+  assert(buffer_);
+  // アップロードヒープは Map したままでよい（CPU は書き込みのみ）
+  D3D12_RANGE readRange{0, 0};
+  buffer_->Map(0, &readRange, reinterpret_cast<void **>(&mapped_));
+  gpuBase_ = buffer_->GetGPUVirtualAddress();
+
+  bytesPerFrame_ = bytesPerFrame;
+  for (uint32_t i = 0; i < frameCount_; ++i) {
+    slots_[i].Initialize(bytesPerFrame * i, bytesPerFrame);
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "FramePacer.h"
+#include "LinearAllocator.h"
+#include <cstdint>
+#include <cstring>
+#include <wrl.h>
+
+class DirectXCommon;
+struct ID3D12Resource;
+
+// フレームごとの一時アップロード領域
+// - 永続 Map した 1 本のアップロードバッファをフレームスロット数に等分し、
+//   スロットごとに LinearAllocator で先頭から詰めて確保する
+// - スロットの領域は、そのスロットを再利用する最初の確保時に巻き戻す
+//   （FramePacer がスロット再利用前に GPU 完了を待っているので安全）
+// - 足りなくなったら倍のサイズで作り直し、旧バッファは今フレームの完了後に解放
+class FrameUploadAllocator {
+public:
+  template <class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+  // 定数バッファのアドレスは 256 バイト境界
+  static constexpr uint64_t kConstantBufferAlignment = 256;
+
+  struct Allocation {
+    void *cpu = nullptr;
+    uint64_t gpu = 0; // D3D12_GPU_VIRTUAL_ADDRESS
+    uint64_t size = 0;
+  };
+
+  FrameUploadAllocator() = default;
+  ~FrameUploadAllocator();
+  FrameUploadAllocator(const FrameUploadAllocator &) = delete;
+  FrameUploadAllocator &operator=(const FrameUploadAllocator &) = delete;
+
+  void Initialize(DirectXCommon *dx, uint64_t bytesPerFrame);
+  void Finalize();
+
+  // 今フレームだけ有効な領域を確保（次にこのスロットが回ってきたら無効）
+  Allocation Allocate(uint64_t size,
+                      uint64_t alignment = kConstantBufferAlignment);
+
+  // 定数バッファとして書き込み、GPU アドレスを返す
+  template <class T> uint64_t PushConstants(const T &data) {
+    Allocation a = Allocate(sizeof(T));
+    std::memcpy(a.cpu, &data, sizeof(T));
+    return a.gpu;
+  }
+
+  uint64_t GetBytesPerFrame() const { return bytesPerFrame_; }
+  // 今フレームの使用量 / 確保回数
+  uint64_t GetUsedThisFrame() const;
+  uint32_t GetAllocationsThisFrame() const;
+  // 作り直しの回数（デバッグ表示用）
+  uint32_t GetGrowCount() const { return growCount_; }
+
+private:
+  void BeginFrameIfNeeded_();
+  void CreateBuffer_(uint64_t bytesPerFrame);
+
+  DirectXCommon *dx_ = nullptr;
+  ComPtr<ID3D12Resource> buffer_;
+  uint8_t *mapped_ = nullptr;
+  uint64_t gpuBase_ = 0;
+
+  uint64_t bytesPerFrame_ = 0;
+  uint32_t frameCount_ = 0;
+  LinearAllocator slots_[FramePacer::kMaxFramesInFlight];
+  // 最後に確保したフレームの通し番号（変わったらスロットを巻き戻す）
+  uint64_t currentFrameNumber_ = ~0ull;
+  uint32_t growCount_ = 0;
+};
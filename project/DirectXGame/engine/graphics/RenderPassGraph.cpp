@@ -0,0 +1,121 @@
+#include "RenderPassGraph.h"
+#include <algorithm>
+#include <cassert>
+
+void RenderPassGraph::Clear() {
+  nodes_.clear();
+  order_.clear();
+}
+
+void RenderPassGraph::AddPass(uint32_t id, const std::string &name) {
+  if (Find_(id) >= 0) {
+    return;
+  }
+  Node n{};
+  n.id = id;
+  n.name = name;
+  nodes_.push_back(std::move(n));
+}
+
+void RenderPassGraph::AddDependency(uint32_t before, uint32_t after) {
+  const int32_t b = Find_(before);
+  const int32_t a = Find_(after);
+  assert(b >= 0 && a >= 0 && "AddPass してから依存を追加すること");
+  if (b < 0 || a < 0) {
+    return;
+  }
+  auto &succ = nodes_[b].successors;
+  if (std::find(succ.begin(), succ.end(), static_cast<uint32_t>(a)) ==
+      succ.end()) {
+    succ.push_back(static_cast<uint32_t>(a));
+  }
+}
+
+bool RenderPassGraph::Compile() {
+  order_.clear();
+
+  const size_t n = nodes_.size();
+  std::vector<uint32_t> inDegree(n, 0);
+  for (const Node &node : nodes_) {
+    for (uint32_t s : node.successors) {
+      ++inDegree[s];
+    }
+  }
+
+  // Kahn 法。準備のできたノードのうち id が最小のものから出す（結果を決定的にする）
+  std::vector<uint32_t> ready;
+  for (uint32_t i = 0; i < n; ++i) {
+    if (inDegree[i] == 0) {
+      ready.push_back(i);
+    }
+  }
+
+  while (!ready.empty()) {
+    auto it = std::min_element(ready.begin(), ready.end(),
+                               [this](uint32_t a, uint32_t b) {
+                                 return nodes_[a].id < nodes_[b].id;
+                               });
+    const uint32_t cur = *it;
+    ready.erase(it);
+    order_.push_back(nodes_[cur].id);
+
+    for (uint32_t s : nodes_[cur].successors) {
+      if (--inDegree[s] == 0) {
+        ready.push_back(s);
+      }
+    }
+  }
+
+  if (order_.size() != n) {
+    order_.clear(); // 循環あり
+    return false;
+  }
+  return true;
+}
+
+const std::string &RenderPassGraph::GetName(uint32_t id) const {
+  static const std::string kUnknown = "Unknown";
+  const int32_t i = Find_(id);
+  return i >= 0 ? nodes_[i].name : kUnknown;
+}
+
+std::vector<RenderPass> RenderPassGraph::GetQueuePassOrder() const {
+  std::vector<RenderPass> out;
+  for (uint32_t id : order_) {
+    if (id < static_cast<uint32_t>(RenderPass::Count)) {
+      out.push_back(static_cast<RenderPass>(id));
+    }
+  }
+  return out;
+}
+
+RenderPassGraph RenderPassGraph::MakeDefault() {
+  RenderPassGraph g;
+  g.AddPass(static_cast<uint32_t>(RenderPass::Opaque), "Opaque");
+  g.AddPass(static_cast<uint32_t>(RenderPass::Skybox), "Skybox");
+  g.AddPass(static_cast<uint32_t>(RenderPass::Transparent), "Transparent");
+  g.AddPass(static_cast<uint32_t>(RenderPass::Particles), "Particles");
+  g.AddPass(static_cast<uint32_t>(RenderPass::Sprites), "Sprites");
+  g.AddPass(kImGuiPass, "ImGui");
+
+  // 深度を書いた後に背景、その上に半透明・パーティクル、最後に 2D と UI
+  g.AddDependency(static_cast<uint32_t>(RenderPass::Opaque),
+                  static_cast<uint32_t>(RenderPass::Skybox));
+  g.AddDependency(static_cast<uint32_t>(RenderPass::Skybox),
+                  static_cast<uint32_t>(RenderPass::Transparent));
+  g.AddDependency(static_cast<uint32_t>(RenderPass::Transparent),
+                  static_cast<uint32_t>(RenderPass::Particles));
+  g.AddDependency(static_cast<uint32_t>(RenderPass::Particles),
+                  static_cast<uint32_t>(RenderPass::Sprites));
+  g.AddDependency(static_cast<uint32_t>(RenderPass::Sprites), kImGuiPass);
+  return g;
+}
+
+int32_t RenderPassGraph::Find_(uint32_t id) const {
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    if (nodes_[i].id == id) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "RenderSortKey.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 描画パス間の依存関係
+// - ノードは RenderPass の値（+ ImGui 等 RenderQueue 外のパス）
+// - Compile でトポロジカル順を求め、RenderQueue の再生順・コマンドリストの提出順に使う
+class RenderPassGraph {
+public:
+  // RenderQueue に載らない、フレームの最後に記録されるパス
+  static constexpr uint32_t kImGuiPass = static_cast<uint32_t>(RenderPass::Count);
+
+  void Clear();
+
+  void AddPass(uint32_t id, const std::string &name);
+  // before の後に after を描く
+  void AddDependency(uint32_t before, uint32_t after);
+
+  // 依存を満たす順序を求める（同順位は id の小さい順）。循環していれば false
+  bool Compile();
+
+  const std::vector<uint32_t> &GetOrder() const { return order_; }
+  const std::string &GetName(uint32_t id) const;
+
+  // Compile 済みの順序から RenderQueue に載るパスだけを取り出す
+  std::vector<RenderPass> GetQueuePassOrder() const;
+
+  // 既定: Opaque → Skybox → Transparent → Particles → Sprites → ImGui
+  static RenderPassGraph MakeDefault();
+
+private:
+  struct Node {
+    uint32_t id = 0;
+    std::string name;
+    std::vector<uint32_t> successors; // nodes_ のインデックス
+  };
+
+  int32_t Find_(uint32_t id) const;
+
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> order_;
+};
@@ -0,0 +1,170 @@
+#include "RenderQueue.h"
+#include <algorithm>
+
+void RenderQueue::Submit(const RenderCommand &cmd) {
+  commands_.push_back(cmd);
+  sorted_ = false;
+}
+
+void RenderQueue::SetPassOrder(const std::vector<RenderPass> &order) {
+  // 指定されなかったパスは末尾に回す
+  uint8_t rank = 0;
+  bool assigned[static_cast<size_t>(RenderPass::Count)] = {};
+  for (RenderPass p : order) {
+    const size_t i = static_cast<size_t>(p);
+    if (i < static_cast<size_t>(RenderPass::Count) && !assigned[i]) {
+      passRank_[i] = rank++;
+      assigned[i] = true;
+    }
+  }
+  for (size_t i = 0; i < static_cast<size_t>(RenderPass::Count); ++i) {
+    if (!assigned[i]) {
+      passRank_[i] = rank++;
+    }
+  }
+
+  customPassOrder_ = false;
+  for (size_t i = 0; i < static_cast<size_t>(RenderPass::Count); ++i) {
+    if (passRank_[i] != i) {
+      customPassOrder_ = true;
+    }
+  }
+  sorted_ = commands_.empty();
+}
+
+void RenderQueue::Sort() {
+  if (sorted_) {
+    return;
+  }
+  keys_.resize(commands_.size());
+  for (size_t i = 0; i < commands_.size(); ++i) {
+    uint64_t key = commands_[i].sortKey;
+    if (customPassOrder_) {
+      // 上位 4bit の pass を再生順位に置き換えてからソートする
+      const size_t pass = static_cast<size_t>(RenderSortKey::GetPass(key));
+      const uint64_t rank =
+          pass < static_cast<size_t>(RenderPass::Count) ? passRank_[pass] : pass;
+      key = (key & ~(0xFull << 60)) | (rank << 60);
+    }
+    keys_[i] = key;
+  }
+  order_.clear(); // RadixSortKeys が 0..n-1 で初期化する
+  RadixSortKeys(keys_, order_);
+  sorted_ = true;
+}
+
+void RenderQueue::Execute(IRenderBackend &backend) {
+  Sort();
+
+  RenderQueueStats stats{};
+  ExecuteRange(backend, 0, order_.size(), stats);
+  FinishFrame(stats);
+}
+
+void RenderQueue::FinishFrame(const RenderQueueStats &stats) {
+  stats_ = stats;
+  stats_.submitted = static_cast<uint32_t>(commands_.size());
+  Clear();
+}
+
+void RenderQueue::Accumulate(RenderQueueStats &dst,
+                             const RenderQueueStats &src) {
+  dst.submitted += src.submitted;
+  dst.drawn += src.drawn;
+  dst.pipelineBinds += src.pipelineBinds;
+  dst.pipelineBindsSaved += src.pipelineBindsSaved;
+  dst.heapBinds += src.heapBinds;
+  dst.heapBindsSaved += src.heapBindsSaved;
+  dst.frameConstantBinds += src.frameConstantBinds;
+  dst.frameConstantBindsSaved += src.frameConstantBindsSaved;
+  dst.textureBinds += src.textureBinds;
+  dst.textureBindsSaved += src.textureBindsSaved;
+  dst.geometryBinds += src.geometryBinds;
+  dst.geometryBindsSaved += src.geometryBindsSaved;
+}
+
+void RenderQueue::ExecuteRange(IRenderBackend &backend, size_t begin,
+                               size_t end, RenderQueueStats &stats) const {
+  end = std::min(end, order_.size());
+
+  // 直前にバインドした状態（パイプラインが変わるとルートのバインドは無効になる）
+  bool heapsBound = false;
+  bool hasPipeline = false;
+  uint32_t pipeline = 0;
+  bool frameConstantsBound = false;
+  uint64_t texture = 0;
+  uint64_t geometry = 0;
+
+  for (size_t pos = begin; pos < end; ++pos) {
+    const RenderCommand &cmd = commands_[order_[pos]];
+
+    if (!heapsBound) {
+      backend.BindDescriptorHeaps();
+      heapsBound = true;
+      ++stats.heapBinds;
+    } else {
+      ++stats.heapBindsSaved;
+    }
+
+    if (!hasPipeline || pipeline != cmd.pipeline) {
+      backend.BindPipeline(cmd.pipeline);
+      hasPipeline = true;
+      pipeline = cmd.pipeline;
+      frameConstantsBound = false;
+      texture = 0;
+      geometry = 0;
+      ++stats.pipelineBinds;
+    } else {
+      ++stats.pipelineBindsSaved;
+    }
+
+    if (cmd.usesFrameConstants) {
+      if (!frameConstantsBound) {
+        backend.BindFrameConstants(cmd.pipeline);
+        frameConstantsBound = true;
+        ++stats.frameConstantBinds;
+      } else {
+        ++stats.frameConstantBindsSaved;
+      }
+    }
+
+    if (cmd.texture != 0) {
+      if (texture != cmd.texture) {
+        backend.BindTexture(cmd);
+        texture = cmd.texture;
+        ++stats.textureBinds;
+      } else {
+        ++stats.textureBindsSaved;
+      }
+    }
+
+    if (cmd.geometry != 0) {
+      if (geometry != cmd.geometry) {
+        backend.BindGeometry(cmd);
+        geometry = cmd.geometry;
+        ++stats.geometryBinds;
+      } else {
+        ++stats.geometryBindsSaved;
+      }
+    }
+
+    backend.Draw(cmd);
+    ++stats.drawn;
+
+    if (cmd.invalidatesState) {
+      // パイプライン・ヒープも独自に設定されるので、次のコマンドで必ず設定し直す
+      heapsBound = false;
+      hasPipeline = false;
+      frameConstantsBound = false;
+      texture = 0;
+      geometry = 0;
+    }
+  }
+}
+
+void RenderQueue::Clear() {
+  commands_.clear();
+  keys_.clear();
+  order_.clear();
+  sorted_ = true;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "RenderSortKey.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 遅延描画コマンド（グラフィックス API に依存しない）
+// - ID/ハンドルの解釈はバックエンドに任せる
+struct RenderCommand {
+  uint64_t sortKey = 0;
+  uint32_t kind = 0;      // 描画種別（バックエンド定義）
+  void *object = nullptr; // 描画対象（ModelInstance* 等）
+  uint32_t pipeline = 0;  // パイプラインID（バックエンド定義）
+  uint64_t texture = 0;   // テクスチャ(SRV)。0 = 使わない
+  uint64_t geometry = 0;  // 頂点/インデックスバッファ。0 = 使わない
+  uint32_t subset = 0;    // 描画範囲の番号（モデルのサブメッシュ等）
+  // subset の中で実際に描く範囲のリスト（バックエンド定義）。0 個 = subset 全体
+  uint32_t rangeFirst = 0;
+  uint32_t rangeCount = 0;
+  // 描画ごとの定数（積んだ時点で書き込み済みのアドレス）。0 = 使わない
+  uint64_t materialConstants = 0;
+  uint64_t transformConstants = 0;
+  uint64_t skinPalette = 0; // スキニング行列（ルート SRV）。0 = 使わない
+  bool usesFrameConstants = false; // ライト・カメラ CB を使う
+  // Draw 内で独自にバインドする（Particle 等）。次のコマンドは全てバインドし直す
+  bool invalidatesState = false;
+};
+
+// RenderQueue が呼ぶ描画バックエンド
+// - 呼び出しは冗長なものが取り除かれた後の最小限になる
+class IRenderBackend {
+public:
+  virtual ~IRenderBackend() = default;
+
+  virtual void BindDescriptorHeaps() = 0;
+  virtual void BindPipeline(uint32_t pipeline) = 0;
+  virtual void BindFrameConstants(uint32_t pipeline) = 0;
+  virtual void BindTexture(const RenderCommand &cmd) = 0;
+  virtual void BindGeometry(const RenderCommand &cmd) = 0;
+  virtual void Draw(const RenderCommand &cmd) = 0;
+};
+
+// 1 回の Execute で発行/省略したバインド数
+struct RenderQueueStats {
+  uint32_t submitted = 0;
+  uint32_t drawn = 0;
+
+  uint32_t pipelineBinds = 0;
+  uint32_t pipelineBindsSaved = 0;
+  uint32_t heapBinds = 0;
+  uint32_t heapBindsSaved = 0;
+  uint32_t frameConstantBinds = 0;
+  uint32_t frameConstantBindsSaved = 0;
+  uint32_t textureBinds = 0;
+  uint32_t textureBindsSaved = 0;
+  uint32_t geometryBinds = 0;
+  uint32_t geometryBindsSaved = 0;
+
+  uint32_t TotalBinds() const {
+    return pipelineBinds + heapBinds + frameConstantBinds + textureBinds +
+           geometryBinds;
+  }
+  uint32_t TotalSaved() const {
+    return pipelineBindsSaved + heapBindsSaved + frameConstantBindsSaved +
+           textureBindsSaved + geometryBindsSaved;
+  }
+};
+
+// ソートキー付きの描画キュー
+// - Submit で積み、Execute でキー順に並べ替えて冗長なステート変更を省きつつ再生する
+class RenderQueue {
+public:
+  void Submit(const RenderCommand &cmd);
+
+  // パスの再生順（RenderPassGraph::GetQueuePassOrder）。未設定なら RenderPass の値順
+  void SetPassOrder(const std::vector<RenderPass> &order);
+
+  // キー順に並べ替える（Execute からも呼ばれる。済みなら何もしない）
+  void Sort();
+
+  // 並べ替え済みの全コマンドを再生してキューを空にする
+  void Execute(IRenderBackend &backend);
+
+  // 並べ替え済みの [begin, end) だけを再生する（キューは空にしない）
+  // - 別スレッド・別コマンドリストで範囲ごとに呼べる（互いに重ならないこと）
+  // - 各範囲は何もバインドされていない状態から始める
+  void ExecuteRange(IRenderBackend &backend, size_t begin, size_t end,
+                    RenderQueueStats &stats) const;
+
+  // ExecuteRange で再生し終えた後に、統計を記録してキューを空にする
+  void FinishFrame(const RenderQueueStats &stats);
+
+  void Clear();
+
+  size_t Size() const { return commands_.size(); }
+  // 直近の Execute / FinishFrame の統計
+  const RenderQueueStats &GetStats() const { return stats_; }
+
+  // 統計の合算（範囲ごとの結果をまとめる）
+  static void Accumulate(RenderQueueStats &dst, const RenderQueueStats &src);
+
+private:
+  std::vector<RenderCommand> commands_;
+  std::vector<uint64_t> keys_;
+  std::vector<uint32_t> order_;
+  bool sorted_ = true;
+
+  // RenderPass → 再生順位
+  uint8_t passRank_[static_cast<size_t>(RenderPass::Count)] = {0, 1, 2, 3, 4};
+  bool customPassOrder_ = false;
+
+  RenderQueueStats stats_{};
+};
@@ -0,0 +1,102 @@
+#include "RenderSortKey.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace RenderSortKey {
+
+namespace {
+constexpr uint32_t kMask24 = 0xFFFFFFu;
+} // namespace
+
+bool IsOrderedPass(RenderPass pass) {
+  return pass == RenderPass::Transparent || pass == RenderPass::Particles ||
+         pass == RenderPass::Sprites;
+}
+
+uint64_t Make(const Fields &f) {
+  const uint64_t pass = static_cast<uint64_t>(f.pass) & 0xF;
+  const uint64_t blend = static_cast<uint64_t>(f.blend) & 0xF;
+  const uint64_t pipeline = static_cast<uint64_t>(f.pipeline) & 0xFF;
+  const uint64_t material = static_cast<uint64_t>(f.material) & kMask24;
+  const uint64_t depth = static_cast<uint64_t>(f.depth) & kMask24;
+
+  if (IsOrderedPass(f.pass)) {
+    return (pass << 60) | (depth << 36) | (blend << 32) | (pipeline << 24) |
+           material;
+  }
+  return (pass << 60) | (blend << 56) | (pipeline << 48) | (material << 24) |
+         depth;
+}
+
+RenderPass GetPass(uint64_t key) {
+  return static_cast<RenderPass>((key >> 60) & 0xF);
+}
+
+uint32_t DepthFrontToBack(float viewDepth) {
+  // 正の float はビット列の大小と値の大小が一致するので上位 24bit をそのまま使う
+  const float d = std::max(viewDepth, 0.0f);
+  uint32_t bits = 0;
+  std::memcpy(&bits, &d, sizeof(bits));
+  return bits >> 8;
+}
+
+uint32_t DepthBackToFront(float viewDepth) {
+  return kMask24 - DepthFrontToBack(viewDepth);
+}
+
+uint32_t Fold24(uint64_t value) {
+  return static_cast<uint32_t>((value ^ (value >> 24) ^ (value >> 48)) &
+                               kMask24);
+}
+
+} // namespace RenderSortKey
+
+void RadixSortKeys(std::vector<uint64_t> &keys,
+                   std::vector<uint32_t> &indices) {
+  const size_t n = keys.size();
+  if (indices.size() != n) {
+    indices.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      indices[i] = static_cast<uint32_t>(i);
+    }
+  }
+  if (n < 2) {
+    return;
+  }
+
+  // 全桁のヒストグラムを 1 回の走査で作る
+  std::array<std::array<uint32_t, 256>, 8> histograms{};
+  for (uint64_t k : keys) {
+    for (int b = 0; b < 8; ++b) {
+      ++histograms[b][(k >> (b * 8)) & 0xFF];
+    }
+  }
+
+  std::vector<uint64_t> tmpKeys(n);
+  std::vector<uint32_t> tmpIdx(n);
+
+  for (int b = 0; b < 8; ++b) {
+    auto &hist = histograms[b];
+    const uint32_t first = static_cast<uint32_t>((keys[0] >> (b * 8)) & 0xFF);
+    if (hist[first] == n) {
+      continue; // この桁は全要素同じ
+    }
+
+    std::array<uint32_t, 256> offset{};
+    uint32_t sum = 0;
+    for (int i = 0; i < 256; ++i) {
+      offset[i] = sum;
+      sum += hist[i];
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+      const uint32_t digit = static_cast<uint32_t>((keys[i] >> (b * 8)) & 0xFF);
+      const uint32_t dst = offset[digit]++;
+      tmpKeys[dst] = keys[i];
+      tmpIdx[dst] = indices[i];
+    }
+    keys.swap(tmpKeys);
+    indices.swap(tmpIdx);
+  }
+}
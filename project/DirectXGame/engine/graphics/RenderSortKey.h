@@ -0,0 +1,50 @@
+#pragma once
+#include "BlendMode.h"
+#include <cstdint>
+#include <vector>
+
+// 描画パス（値の小さい順に描画される）
+enum class RenderPass : uint8_t {
+  Opaque = 0,      // 不透明（手前→奥）
+  Skybox = 1,      // 不透明の後に深度テスト付きで背景を埋める
+  Transparent = 2, // 半透明（奥→手前）
+  Particles = 3,
+  Sprites = 4,     // 2D（登録順）
+  Count
+};
+
+// 64bit ソートキー
+// - 不透明系:  [63..60 pass][59..56 blend][55..48 pipeline][47..24 material][23..0 depth]
+// - 順序依存系: [63..60 pass][59..36 depth][35..32 blend][31..24 pipeline][23..0 material]
+//   （Transparent / Particles / Sprites は描画順が見た目に影響するので depth を優先）
+namespace RenderSortKey {
+
+struct Fields {
+  RenderPass pass = RenderPass::Opaque;
+  BlendMode blend = BlendMode::Opaque;
+  uint32_t pipeline = 0; // 下位 8bit を使用
+  uint32_t material = 0; // 下位 24bit を使用（テクスチャ等のグループ化用）
+  uint32_t depth = 0;    // 下位 24bit を使用（DepthFrontToBack 等で作る）
+};
+
+// 描画順が重要なパスか（depth を上位に置く）
+bool IsOrderedPass(RenderPass pass);
+
+uint64_t Make(const Fields &f);
+
+RenderPass GetPass(uint64_t key);
+
+// ビュー空間の深度(>=0)を 24bit に量子化（手前ほど小さい）
+uint32_t DepthFrontToBack(float viewDepth);
+// 奥ほど小さい（半透明用）
+uint32_t DepthBackToFront(float viewDepth);
+
+// 64bit 値を 24bit に畳み込む（テクスチャハンドル等のグループ化用）
+uint32_t Fold24(uint64_t value);
+
+} // namespace RenderSortKey
+
+// LSD 基数ソート（8bit × 8 パス、安定）
+// - keys と同じ長さの indices を並べ替える（keys 自体も並べ替え後の順になる）
+// - 全要素で同じ値になっている桁はスキップする
+void RadixSortKeys(std::vector<uint64_t> &keys, std::vector<uint32_t> &indices);
@@ -2,6 +2,7 @@
 #include "Renderer.h"
 #include "Camera.h"
 #include "DirectXCommon.h"
+#include "JobSystem.h"
 #include "ModelInstance.h"
 #include "ModelResource.h"
 #include "ParticleManager.h"
@@ -9,9 +10,12 @@
 #include "Skybox.h"
 #include "Sprite.h"
 #include "SpriteResource.h"
+#include "SrvAllocator.h"
+#include "TextureManager.h"
 #include "TextureResource.h"
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
 #include <d3d12.h> // 必須：ComPtr の Release を呼ぶために実体が必要
 #include <stdexcept>
@@ -32,9 +36,12 @@ Renderer *Renderer::GetInstance() {
 Renderer::Renderer() = default;
 Renderer::~Renderer() = default;
 
-void Renderer::Initialize(DirectXCommon *dx) {
+void Renderer::Initialize(DirectXCommon *dx,
+                          ModelVertexFormat modelVertexFormat) {
   assert(dx);
   dx_ = dx;
+  modelVertexFormat_ = modelVertexFormat;
+  const bool packedVertex = (modelVertexFormat_ == ModelVertexFormat::Packed);
 
   auto *device = dx_->GetDevice();
   auto *utils = dx_->GetDXCUtils();
@@ -43,7 +50,7 @@ void Renderer::Initialize(DirectXCommon *dx) {
 
   // 3D Pipelines
   {
-    PipelineDesc desc = UnifiedPipeline::MakeObject3DDesc();
+    PipelineDesc desc = UnifiedPipeline::MakeObject3DDesc(packedVertex);
     objPipelineOpaque_ = std::make_unique<UnifiedPipeline>();
     CHECK_INIT(objPipelineOpaque_->Initialize(device, utils, compiler,
                                               includeHandler, desc));
@@ -53,6 +60,40 @@ void Renderer::Initialize(DirectXCommon *dx) {
                                                  includeHandler, desc));
   }
 
+  // 3D Instanced Pipelines
+  {
+    PipelineDesc desc =
+        UnifiedPipeline::MakeObject3DInstancedDesc(packedVertex);
+    objInstancedPipeline_ = std::make_unique<UnifiedPipeline>();
+    CHECK_INIT(objInstancedPipeline_->Initialize(device, utils, compiler,
+                                                 includeHandler, desc));
+    desc.fillMode = D3D12_FILL_MODE_WIREFRAME;
+    objInstancedPipelineWireframe_ = std::make_unique<UnifiedPipeline>();
+    CHECK_INIT(objInstancedPipelineWireframe_->Initialize(
+        device, utils, compiler, includeHandler, desc));
+  }
+
+  // 3D Skinned Pipelines（スキンメッシュは頂点形式の設定に関係なく非圧縮）
+  {
+    PipelineDesc desc = UnifiedPipeline::MakeObject3DSkinnedDesc();
+    objSkinnedPipeline_ = std::make_unique<UnifiedPipeline>();
+    CHECK_INIT(objSkinnedPipeline_->Initialize(device, utils, compiler,
+                                               includeHandler, desc));
+    desc.fillMode = D3D12_FILL_MODE_WIREFRAME;
+    objSkinnedPipelineWireframe_ = std::make_unique<UnifiedPipeline>();
+    CHECK_INIT(objSkinnedPipelineWireframe_->Initialize(
+        device, utils, compiler, includeHandler, desc));
+  }
+
+  // パスの依存関係 → RenderQueue の再生順
+  {
+    passGraph_ = RenderPassGraph::MakeDefault();
+    CHECK_INIT(passGraph_.Compile());
+    // ImGui は Flush 後にメインのリストへ記録されるので最後でなければならない
+    CHECK_INIT(passGraph_.GetOrder().back() == RenderPassGraph::kImGuiPass);
+    queue_.SetPassOrder(passGraph_.GetQueuePassOrder());
+  }
+
   // Skybox Pipeline
   {
     PipelineDesc desc = UnifiedPipeline::MakeSkyboxDesc();
@@ -111,43 +152,56 @@ void Renderer::Initialize(DirectXCommon *dx) {
                                                    includeHandler, desc));
   }
 
-  auto align256 = [](size_t size) -> size_t { return (size + 255) & ~255; };
+  uploadAllocator_.Initialize(dx_, kUploadBytesPerFrame);
+
+  for (uint32_t i = 0; i < dx_->GetFramesInFlight(); ++i) {
+    // インスタンスバッファの SRV はスロットごとに 1 つを使い回す
+    // （拡張時は同じ場所に作り直す。そのスロットは GPU 完了済み）
+    FrameResources &frame = frames_[i];
+    frame.instanceSrvIndex = dx_->GetSrvAllocator().Allocate();
+    EnsureInstanceCapacity_(frame, 256);
+  }
+}
 
-  cameraCB_ = CreateUploadBuffer(align256(sizeof(CameraForGPU)));
-  cameraCB_->Map(0, nullptr, reinterpret_cast<void **>(&cameraMapped_));
-  directionalLightCB_ =
-      CreateUploadBuffer(align256(sizeof(DirectionalLightGroupCB)));
-  directionalLightCB_->Map(0, nullptr,
-                           reinterpret_cast<void **>(&directionalLightMapped_));
-  pointLightCB_ = CreateUploadBuffer(align256(sizeof(PointLightGroupCB)));
-  pointLightCB_->Map(0, nullptr, reinterpret_cast<void **>(&pointLightMapped_));
-  spotLightCB_ = CreateUploadBuffer(align256(sizeof(SpotLightGroupCB)));
-  spotLightCB_->Map(0, nullptr, reinterpret_cast<void **>(&spotLightMapped_));
+Renderer::FrameResources &Renderer::CurrentFrame_() {
+  return frames_[dx_->GetFrameIndex()];
+}
+
+const Renderer::FrameResources &Renderer::CurrentFrame_() const {
+  return frames_[dx_->GetFrameIndex()];
+}
+
+void Renderer::UploadFrameConstants_() {
+  const uint64_t frameNumber = dx_->GetFramePacer().GetFrameNumber();
+  if (frameConstantsFrame_ == frameNumber)
+    return;
+  frameConstantsFrame_ = frameNumber;
+
+  frameConstants_.camera = uploadAllocator_.PushConstants(camera_);
+  frameConstants_.directionalLight =
+      uploadAllocator_.PushConstants(directionalLights_);
+  frameConstants_.pointLight = uploadAllocator_.PushConstants(pointLights_);
+  frameConstants_.spotLight = uploadAllocator_.PushConstants(spotLights_);
 }
 
 void Renderer::SetCamera(const Camera &camera) {
   view_ = camera.GetViewMatrix();
   proj_ = camera.GetProjectionMatrix();
-  if (cameraMapped_) {
-    Matrix4x4 invView = Inverse(view_);
-    cameraMapped_->worldPosition = {invView.m[3][0], invView.m[3][1],
-                                    invView.m[3][2]};
-    cameraMapped_->pad = 0.0f;
-  }
+  Matrix4x4 invView = Inverse(view_);
+  camera_.worldPosition = {invView.m[3][0], invView.m[3][1], invView.m[3][2]};
+  camera_.pad = 0.0f;
 }
 
 void Renderer::SetDirectionalLights(const std::vector<DirLight> &lights,
                                     bool groupEnabled) {
-  if (!directionalLightMapped_)
-    return;
-  std::memset(directionalLightMapped_, 0, sizeof(DirectionalLightGroupCB));
+  directionalLights_ = {};
   int count = static_cast<int>(
       std::min(lights.size(), static_cast<size_t>(kMaxDirLights)));
-  directionalLightMapped_->count = count;
-  directionalLightMapped_->enabled = groupEnabled ? 1 : 0;
+  directionalLights_.count = count;
+  directionalLights_.enabled = groupEnabled ? 1 : 0;
   for (int i = 0; i < count; ++i) {
     const auto &src = lights[i];
-    auto &dst = directionalLightMapped_->lights[i];
+    auto &dst = directionalLights_.lights[i];
     dst.color[0] = src.color.x;
     dst.color[1] = src.color.y;
     dst.color[2] = src.color.z;
@@ -162,16 +216,14 @@ void Renderer::SetDirectionalLights(const std::vector<DirLight> &lights,
 
 void Renderer::SetPointLights(const std::vector<PointLight> &lights,
                               bool groupEnabled) {
-  if (!pointLightMapped_)
-    return;
-  std::memset(pointLightMapped_, 0, sizeof(PointLightGroupCB));
+  pointLights_ = {};
   int count = static_cast<int>(
       std::min(lights.size(), static_cast<size_t>(kMaxPointLights)));
-  pointLightMapped_->count = count;
-  pointLightMapped_->enabled = groupEnabled ? 1 : 0;
+  pointLights_.count = count;
+  pointLights_.enabled = groupEnabled ? 1 : 0;
   for (int i = 0; i < count; ++i) {
     const auto &src = lights[i];
-    auto &dst = pointLightMapped_->lights[i];
+    auto &dst = pointLights_.lights[i];
     dst.color[0] = src.color.x;
     dst.color[1] = src.color.y;
     dst.color[2] = src.color.z;
@@ -188,17 +240,15 @@ void Renderer::SetPointLights(const std::vector<PointLight> &lights,
 
 void Renderer::SetSpotLights(const std::vector<SpotLight> &lights,
                              bool groupEnabled) {
-  if (!spotLightMapped_)
-    return;
-  std::memset(spotLightMapped_, 0, sizeof(SpotLightGroupCB));
+  spotLights_ = {};
   int count = static_cast<int>(
       std::min(lights.size(), static_cast<size_t>(kMaxSpotLights)));
-  spotLightMapped_->count = count;
-  spotLightMapped_->enabled = groupEnabled ? 1 : 0;
+  spotLights_.count = count;
+  spotLights_.enabled = groupEnabled ? 1 : 0;
   static constexpr float kPi = 3.14159265f;
   for (int i = 0; i < count; ++i) {
     const auto &src = lights[i];
-    auto &dst = spotLightMapped_->lights[i];
+    auto &dst = spotLights_.lights[i];
     dst.color[0] = src.color.x;
     dst.color[1] = src.color.y;
     dst.color[2] = src.color.z;
@@ -227,140 +277,612 @@ float Renderer::GetAspectRatio() const {
 void Renderer::DrawModel(ModelInstance *instance) {
   if (!instance || !instance->GetResource())
     return;
-  auto *cmdList = dx_->GetCommandList();
   auto *resource = instance->GetResource();
 
-  // 描画直前に WVP 行列を最終計算して GPU に送る
-  auto *cbTrans = instance->GetTransformMapped();
-  if (cbTrans) {
-    // WVP = (World * View) * Projection
-    Matrix4x4 worldView = Multiply(instance->GetWorld(), view_);
-    cbTrans->WVP = Multiply(worldView, proj_);
-  }
-
-  // 1. パイプライン設定
-  UnifiedPipeline *pipeline = instance->IsWireframe()
-                                  ? objPipelineWireframe_.get()
-                                  : objPipelineOpaque_.get();
-  pipeline->SetPipelineState(cmdList);
-
-  // 2. 頂点バッファ設定
-  D3D12_VERTEX_BUFFER_VIEW vbv{};
-  vbv.BufferLocation = resource->GetVBVAddress();
-  vbv.SizeInBytes = resource->GetVBVSize();
-  vbv.StrideInBytes = resource->GetVBVStride();
-  cmdList->IASetVertexBuffers(0, 1, &vbv);
-
-  // 3. 定数バッファ (Material / Transform)
-  cmdList->SetGraphicsRootConstantBufferView(0,
-                                             instance->GetMaterialCBAddress());
-  cmdList->SetGraphicsRootConstantBufferView(1,
-                                             instance->GetTransformCBAddress());
-
-  // 4. テクスチャ設定
+  // 定数を今フレームの一時領域へ書き込む（記録は Flush 時）
+  ModelInstance::TransformCB transform{};
+  // 圧縮頂点は正規化座標なので、逆量子化を World 側に畳み込む
+  // （法線は量子化していないので WorldInverseTranspose はそのまま）
+  const Matrix4x4 world =
+      resource->IsPackedVertex()
+          ? Multiply(resource->GetDequantizeMatrix(), instance->GetWorld())
+          : instance->GetWorld();
+  // WVP = (World * View) * Projection
+  Matrix4x4 worldView = Multiply(world, view_);
+  transform.WVP = Multiply(worldView, proj_);
+  transform.World = world;
+  transform.WorldInverseTranspose = instance->GetWorldInverseTranspose();
+
+  // ビュー空間の深度（ワールド原点の位置で代表させる）
+  const Matrix4x4 &w = instance->GetWorld();
+  const float viewZ = w.m[3][0] * view_.m[0][2] + w.m[3][1] * view_.m[1][2] +
+                      w.m[3][2] * view_.m[2][2] + view_.m[3][2];
+
+  RenderCommand cmd{};
+  cmd.kind = static_cast<uint32_t>(DrawKind::Model);
+  cmd.object = instance;
+  cmd.pipeline =
+      instance->IsWireframe() ? kPipelineObjWireframe : kPipelineObjOpaque;
+  cmd.geometry = resource->GetVBVAddress();
+  cmd.materialConstants =
+      uploadAllocator_.PushConstants(instance->GetMaterial());
+  cmd.transformConstants = uploadAllocator_.PushConstants(transform);
+  cmd.usesFrameConstants = true;
+
+  if (resource->IsSkinned()) {
+    cmd.pipeline = instance->IsWireframe() ? kPipelineObjSkinnedWireframe
+                                           : kPipelineObjSkinned;
+    // 行列が未設定（数が合わない）ならバインドポーズ = 単位行列で描く
+    const uint32_t jointCount = resource->GetJointCount();
+    const std::vector<Matrix4x4> &skin = instance->GetSkinMatrices();
+    FrameUploadAllocator::Allocation palette =
+        uploadAllocator_.Allocate(sizeof(Matrix4x4) * jointCount, 16);
+    auto *dst = static_cast<Matrix4x4 *>(palette.cpu);
+    if (skin.size() == jointCount) {
+      std::memcpy(dst, skin.data(), sizeof(Matrix4x4) * jointCount);
+    } else {
+      std::fill(dst, dst + jointCount, MakeIdentity4x4());
+    }
+    cmd.skinPalette = palette.gpu;
+  }
+
+  RenderSortKey::Fields key{};
+  key.pass = RenderPass::Opaque;
+  key.blend = BlendMode::Opaque;
+  key.pipeline = cmd.pipeline;
+  key.depth = RenderSortKey::DepthFrontToBack(viewZ);
+
+  // サブメッシュ（マテリアル）ごとに 1 コマンド。定数は共有する
+  // subset は LOD 込みの通し番号（lod * サブメッシュ数 + i）
+  const float projected = ProjectedRadius_(instance);
+  const uint32_t lod = SelectLod_(instance, projected);
+  const uint32_t submeshCount = resource->GetSubmeshCount();
+  ReportTextureUsage_(resource, projected);
+
+  // メッシュレットを持つ LOD0 は、視錐台の外・裏向きの塊を落とした範囲だけ描く
+  // 判定はモデル空間（平面は WVP から、カメラ位置は World の逆で戻す）
+  const bool cullMeshlets =
+      meshletCulling_ && lod == 0 && resource->HasMeshlets();
+  MeshletCulling::Frustum frustum{};
+  Vector3 cameraInModel{};
+  bool cullBackFaces = false;
+  if (cullMeshlets) {
+    frustum = MeshletCulling::MakeFrustum(Multiply(Multiply(w, view_), proj_));
+    const Matrix4x4 invWorld = Inverse(w);
+    const Vector3 offset = TransformNormal(camera_.worldPosition, invWorld);
+    cameraInModel = {offset.x + invWorld.m[3][0], offset.y + invWorld.m[3][1],
+                     offset.z + invWorld.m[3][2]};
+    // 裏返す World（行列式が負）では表裏が入れ替わるので裏面では落とさない
+    const Vector3 axisX = {w.m[0][0], w.m[0][1], w.m[0][2]};
+    const Vector3 axisY = {w.m[1][0], w.m[1][1], w.m[1][2]};
+    const Vector3 axisZ = {w.m[2][0], w.m[2][1], w.m[2][2]};
+    cullBackFaces = Dot(axisX, Cross(axisY, axisZ)) > 0.0f;
+  }
+
+  for (uint32_t i = 0; i < submeshCount; ++i) {
+    const auto &submesh = resource->GetSubmesh(lod, i);
+    if (submesh.indexCount == 0) {
+      continue;
+    }
+    cmd.rangeFirst = 0;
+    cmd.rangeCount = 0;
+    if (cullMeshlets && submesh.meshletCount > 0) {
+      cmd.rangeFirst = static_cast<uint32_t>(meshletRanges_.size());
+      cmd.rangeCount = MeshletCulling::Cull(
+          resource->GetMeshlets() + submesh.meshletFirst, submesh.meshletCount,
+          frustum, cameraInModel, cullBackFaces, meshletRanges_,
+          &meshletStats_);
+      if (cmd.rangeCount == 0) {
+        continue;
+      }
+    }
+    cmd.texture = submesh.texture ? submesh.texture->GetSrvGpu().ptr : 0;
+    cmd.subset = lod * submeshCount + i;
+    key.material = RenderSortKey::Fold24(cmd.texture);
+    cmd.sortKey = RenderSortKey::Make(key);
+    queue_.Submit(cmd);
+  }
+}
+
+float Renderer::ProjectedRadius_(const ModelInstance *instance) const {
+  const ModelResource *resource = instance->GetResource();
+  // 境界球をワールドへ（半径は一番大きい軸の拡大率で広げる）
+  const Matrix4x4 &w = instance->GetWorld();
+  const Vector3 offset = TransformNormal(resource->GetBoundingCenter(), w);
+  const Vector3 center = {offset.x + w.m[3][0], offset.y + w.m[3][1],
+                          offset.z + w.m[3][2]};
+  float maxScaleSq = 0.0f;
+  for (int row = 0; row < 3; ++row) {
+    maxScaleSq = std::max(maxScaleSq, w.m[row][0] * w.m[row][0] +
+                                          w.m[row][1] * w.m[row][1] +
+                                          w.m[row][2] * w.m[row][2]);
+  }
+  const float radius = resource->GetBoundingRadius() * std::sqrt(maxScaleSq);
+
+  return LodSelector::ProjectedRadius(center, radius, view_, proj_,
+                                     GetScreenHeight());
+}
+
+uint32_t Renderer::SelectLod_(ModelInstance *instance,
+                              float projectedRadius) const {
+  const ModelResource *resource = instance->GetResource();
+  if (resource->GetLodCount() <= 1) {
+    return 0;
+  }
+  const uint32_t lod =
+      LodSelector::Select(resource->GetLodRelativeErrors(),
+                          resource->GetLodCount(), projectedRadius,
+                          instance->GetLod(), lodSettings_);
+  instance->SetLod(lod);
+  return lod;
+}
+
+void Renderer::ReportTextureUsage_(const ModelResource *resource,
+                                   float projectedRadius) const {
+  auto *textures = TextureManager::GetInstance();
+  for (uint32_t i = 0; i < resource->GetSubmeshCount(); ++i) {
+    textures->ReportUsage(resource->GetSubmesh(i).texture,
+                          projectedRadius * 2.0f);
+  }
+}
+
+void Renderer::DrawModelInstanced(ModelInstance *instance) {
+  if (!instance || !instance->GetResource())
+    return;
+  // スキニング行列はインスタンスごとに違うのでまとめられない
+  if (instance->GetResource()->IsSkinned()) {
+    DrawModel(instance);
+    return;
+  }
+
+  const ModelInstance::MaterialCB &src = instance->GetMaterial();
+  InstanceMaterial mat{};
+  mat.color = src.color;
+  mat.enableLighting = src.enableLighting;
+  mat.specularColor = src.specularColor;
+  mat.shininess = src.shininess;
+  mat.uvTransform = src.uvTransform;
+
+  const auto *resource = instance->GetResource();
+  const Matrix4x4 world =
+      resource->IsPackedVertex()
+          ? Multiply(resource->GetDequantizeMatrix(), instance->GetWorld())
+          : instance->GetWorld();
+  const float projected = ProjectedRadius_(instance);
+  ReportTextureUsage_(resource, projected);
+  instanceBatch_.Add(resource, SelectLod_(instance, projected),
+                     instance->IsWireframe(),
+                     world, instance->GetWorldInverseTranspose(), mat);
+}
+
+void Renderer::FlushInstancedModels() {
+  if (instanceBatch_.GetPendingCount() == 0)
+    return;
+
+  instanceBatch_.Build(Multiply(view_, proj_));
+  const auto &instances = instanceBatch_.GetInstances();
+  FrameResources &frame = CurrentFrame_();
+  EnsureInstanceCapacity_(frame, static_cast<uint32_t>(instances.size()));
+  std::memcpy(frame.instanceMapped, instances.data(),
+              sizeof(InstanceDataGPU) * instances.size());
+  UploadFrameConstants_();
+
+  auto *cmdList = dx_->GetCommandList();
+  const SrvAllocator &srvAlloc = dx_->GetSrvAllocator();
+
   ID3D12DescriptorHeap *heaps[] = {dx_->GetSRVHeap()};
   cmdList->SetDescriptorHeaps(1, heaps);
-  D3D12_GPU_DESCRIPTOR_HANDLE texHandle{};
-  texHandle.ptr = resource->GetTextureHandleGPUAsUInt64();
-  cmdList->SetGraphicsRootDescriptorTable(2, texHandle);
-
-  // 5. ライト・カメラ設定
-  cmdList->SetGraphicsRootConstantBufferView(
-      3, directionalLightCB_->GetGPUVirtualAddress());
-  cmdList->SetGraphicsRootConstantBufferView(4,
-                                             cameraCB_->GetGPUVirtualAddress());
-  cmdList->SetGraphicsRootConstantBufferView(
-      5, pointLightCB_->GetGPUVirtualAddress());
-  cmdList->SetGraphicsRootConstantBufferView(
-      6, spotLightCB_->GetGPUVirtualAddress());
-
-  // 6. 描画
   cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-  cmdList->DrawInstanced(resource->GetVertexCount(), 1, 0, 0);
+
+  // RootParameter の並びは UnifiedPipeline::MakeObject3DInstancedDesc に対応
+  UnifiedPipeline *current = nullptr;
+  for (const auto &batch : instanceBatch_.GetBatches()) {
+    UnifiedPipeline *pipeline = batch.wireframe
+                                    ? objInstancedPipelineWireframe_.get()
+                                    : objInstancedPipeline_.get();
+    if (pipeline != current) {
+      // ルートシグネチャを切り替えるとバインドが無効になるので共通分を再設定
+      pipeline->SetPipelineState(cmdList);
+      cmdList->SetGraphicsRootDescriptorTable(
+          1, srvAlloc.Gpu(frame.instanceSrvIndex));
+      cmdList->SetGraphicsRootConstantBufferView(
+          3, frameConstants_.directionalLight);
+      cmdList->SetGraphicsRootConstantBufferView(4, frameConstants_.camera);
+      cmdList->SetGraphicsRootConstantBufferView(5,
+                                                 frameConstants_.pointLight);
+      cmdList->SetGraphicsRootConstantBufferView(6, frameConstants_.spotLight);
+      current = pipeline;
+    }
+
+    const auto *resource = static_cast<const ModelResource *>(batch.key);
+
+    D3D12_VERTEX_BUFFER_VIEW vbv{};
+    vbv.BufferLocation = resource->GetVBVAddress();
+    vbv.SizeInBytes = resource->GetVBVSize();
+    vbv.StrideInBytes = resource->GetVBVStride();
+    cmdList->IASetVertexBuffers(0, 1, &vbv);
+
+    D3D12_INDEX_BUFFER_VIEW ibv{};
+    ibv.BufferLocation = resource->GetIBVAddress();
+    ibv.SizeInBytes = resource->GetIBVSize();
+    ibv.Format = static_cast<DXGI_FORMAT>(resource->GetIBVFormat());
+    cmdList->IASetIndexBuffer(&ibv);
+
+    cmdList->SetGraphicsRoot32BitConstant(2, batch.firstInstance, 0);
+
+    for (uint32_t i = 0; i < resource->GetSubmeshCount(); ++i) {
+      const auto &submesh = resource->GetSubmesh(batch.lod, i);
+      if (submesh.indexCount == 0) {
+        continue;
+      }
+      D3D12_GPU_DESCRIPTOR_HANDLE texHandle{};
+      texHandle.ptr = submesh.texture ? submesh.texture->GetSrvGpu().ptr : 0;
+      cmdList->SetGraphicsRootDescriptorTable(0, texHandle);
+      cmdList->DrawIndexedInstanced(submesh.indexCount, batch.instanceCount,
+                                    submesh.indexStart, 0, 0);
+    }
+  }
+}
+
+void Renderer::EnsureInstanceCapacity_(FrameResources &frame,
+                                       uint32_t count) {
+  if (count <= frame.instanceCapacity)
+    return;
+
+  uint32_t capacity = std::max(frame.instanceCapacity, 256u);
+  while (capacity < count) {
+    capacity *= 2;
+  }
+
+  // 旧バッファの解放は他のリソースと同じくフェンス完了後に回す
+  if (frame.instanceBuffer && frame.instanceMapped) {
+    frame.instanceBuffer->Unmap(0, nullptr);
+  }
+  frame.instanceMapped = nullptr;
+  dx_->DeferRelease(std::move(frame.instanceBuffer));
+  frame.instanceBuffer = CreateUploadBuffer(sizeof(InstanceDataGPU) * capacity);
+  frame.instanceBuffer->Map(0, nullptr,
+                            reinterpret_cast<void **>(&frame.instanceMapped));
+  frame.instanceCapacity = capacity;
+
+  D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+  srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+  srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+  srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+  srvDesc.Buffer.FirstElement = 0;
+  srvDesc.Buffer.NumElements = capacity;
+  srvDesc.Buffer.StructureByteStride = sizeof(InstanceDataGPU);
+  srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
+  dx_->GetDevice()->CreateShaderResourceView(
+      frame.instanceBuffer.Get(), &srvDesc,
+      dx_->GetSrvAllocator().Cpu(frame.instanceSrvIndex));
 }
 
 void Renderer::DrawSprite(Sprite *sprite) {
   if (!sprite || !sprite->GetResource())
     return;
-  auto *cmdList = dx_->GetCommandList();
   auto *res = sprite->GetResource();
 
   // WVP行列の合成 (Spriteは通常、カメラのViewを無視してProjectionのみ掛ける)
-  auto *cbTrans = sprite->GetTransformMapped();
-  if (cbTrans) {
-    cbTrans->WVP = Multiply(sprite->GetWorldMatrix(), proj_);
+  Sprite::TransformCB transform{};
+  transform.WVP = Multiply(sprite->GetWorldMatrix(), proj_);
+  transform.World = sprite->GetWorldMatrix();
+  Sprite::MaterialCB material{};
+  material.color = sprite->GetColor();
+  material.uvTransform = sprite->GetUVTransform();
+
+  RenderCommand cmd{};
+  cmd.kind = static_cast<uint32_t>(DrawKind::Sprite);
+  cmd.object = sprite;
+  cmd.pipeline =
+      kPipelineSpriteBase + static_cast<uint32_t>(sprite->GetBlendMode());
+  cmd.texture = res->GetTexture()->GetSrvGpu().ptr;
+  cmd.geometry = res->GetVBAddress();
+  // 板の大きさ（ピクセル）を UV の拡大率で割った分がテクスチャ全体の画面上の大きさ
+  {
+    const Matrix4x4 &w = sprite->GetWorldMatrix();
+    const Matrix4x4 &uv = sprite->GetUVTransform();
+    const float pixels = std::max(std::hypot(w.m[0][0], w.m[0][1]),
+                                  std::hypot(w.m[1][0], w.m[1][1]));
+    const float uvScale = std::max(std::hypot(uv.m[0][0], uv.m[0][1]),
+                                   std::hypot(uv.m[1][0], uv.m[1][1]));
+    TextureManager::GetInstance()->ReportUsage(
+        res->GetTexture().get(), uvScale > 0.0f ? pixels / uvScale : pixels);
   }
+  cmd.materialConstants = uploadAllocator_.PushConstants(material);
+  cmd.transformConstants = uploadAllocator_.PushConstants(transform);
+
+  // 2D は登録順に重ねる
+  RenderSortKey::Fields key{};
+  key.pass = RenderPass::Sprites;
+  key.blend = sprite->GetBlendMode();
+  key.pipeline = cmd.pipeline;
+  key.material = RenderSortKey::Fold24(cmd.texture);
+  key.depth = orderedSequence_++;
+  cmd.sortKey = RenderSortKey::Make(key);
+  queue_.Submit(cmd);
+}
 
-  UnifiedPipeline *pipeline = GetSpritePipeline_(sprite->GetBlendMode());
-  pipeline->SetPipelineState(cmdList);
+void Renderer::DrawSkybox(Skybox *skybox) {
+  if (!skybox)
+    return;
 
-  // 頂点・インデックスバッファ
-  D3D12_VERTEX_BUFFER_VIEW vbv{};
-  vbv.BufferLocation = res->GetVBAddress();
-  vbv.SizeInBytes = res->GetVBSize();
-  vbv.StrideInBytes = res->GetVBStride();
-  cmdList->IASetVertexBuffers(0, 1, &vbv);
+  RenderCommand cmd{};
+  cmd.kind = static_cast<uint32_t>(DrawKind::Skybox);
+  cmd.object = skybox;
+  cmd.pipeline = kPipelineSkybox;
+  cmd.texture = skybox->GetTexture()->GetSrvGpu().ptr;
+  cmd.geometry = skybox->GetVBAddress();
+  cmd.materialConstants = uploadAllocator_.PushConstants(skybox->GetMaterial());
+  cmd.transformConstants =
+      uploadAllocator_.PushConstants(skybox->GetTransform());
+
+  RenderSortKey::Fields key{};
+  key.pass = RenderPass::Skybox;
+  key.pipeline = cmd.pipeline;
+  key.material = RenderSortKey::Fold24(cmd.texture);
+  cmd.sortKey = RenderSortKey::Make(key);
+  queue_.Submit(cmd);
+}
 
-  D3D12_INDEX_BUFFER_VIEW ibv{};
-  ibv.BufferLocation = res->GetIBAddress();
-  ibv.SizeInBytes = res->GetIBSize();
-  ibv.Format = DXGI_FORMAT_R16_UINT;
-  cmdList->IASetIndexBuffer(&ibv);
+void Renderer::DrawParticles(ParticleManager *pm, BlendMode blendMode) {
+  if (!pm)
+    return;
 
-  // 定数バッファ
-  cmdList->SetGraphicsRootConstantBufferView(0, sprite->GetMaterialCBAddress());
-  cmdList->SetGraphicsRootConstantBufferView(1,
-                                             sprite->GetTransformCBAddress());
+  RenderCommand cmd{};
+  cmd.kind = static_cast<uint32_t>(DrawKind::Particles);
+  cmd.object = pm;
+  cmd.pipeline = kPipelineParticleBase + static_cast<uint32_t>(blendMode);
+  // VB/IB/テクスチャは ParticleManager::DrawInternal がグループごとに設定する
+  cmd.invalidatesState = true;
+
+  RenderSortKey::Fields key{};
+  key.pass = RenderPass::Particles;
+  key.blend = blendMode;
+  key.pipeline = cmd.pipeline;
+  key.depth = orderedSequence_++;
+  cmd.sortKey = RenderSortKey::Make(key);
+  queue_.Submit(cmd);
+}
 
-  // テクスチャ
-  ID3D12DescriptorHeap *heaps[] = {dx_->GetSRVHeap()};
-  cmdList->SetDescriptorHeaps(1, heaps);
-  cmdList->SetGraphicsRootDescriptorTable(2, res->GetTexture()->GetSrvGpu());
+// 1 本のコマンドリストへ記録するバックエンド
+// - ワーカースレッドごとに別インスタンスを作る（Renderer の状態は読むだけ）
+class Renderer::ListBackend : public IRenderBackend {
+public:
+  ListBackend(Renderer *renderer, ID3D12GraphicsCommandList *list)
+      : r_(renderer), list_(list) {}
+
+  void BindDescriptorHeaps() override;
+  void BindPipeline(uint32_t pipeline) override;
+  void BindFrameConstants(uint32_t pipeline) override;
+  void BindTexture(const RenderCommand &cmd) override;
+  void BindGeometry(const RenderCommand &cmd) override;
+  void Draw(const RenderCommand &cmd) override;
+
+private:
+  Renderer *r_;
+  ID3D12GraphicsCommandList *list_;
+};
+
+void Renderer::Flush() {
+  // カメラ・ライトは今フレームの一時領域へ（前フレームの分は GPU が読んでいる途中かもしれない）
+  UploadFrameConstants_();
+
+  // インスタンシング分は不透明なので先に（メインのリストへ）描く
+  FlushInstancedModels();
+
+  queue_.Sort();
+  const size_t total = queue_.Size();
+
+  // 分割数: ワーカー数・リスト上限・最小コマンド数で決める
+  uint32_t listCount = 0;
+  JobSystem *jobs = JobSystem::GetInstance();
+  if (parallelRecording_ && jobs->GetWorkerCount() > 0) {
+    const size_t bySize = total / kMinCommandsPerWorkerList;
+    listCount = static_cast<uint32_t>(
+        std::min<size_t>({bySize, DirectXCommon::kMaxWorkerCommandLists,
+                          static_cast<size_t>(jobs->GetWorkerCount()) + 1}));
+  }
 
-  cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-  cmdList->DrawIndexedInstanced(res->GetIndexCount(), 1, 0, 0, 0);
+  if (listCount < 2) {
+    // 少ないときはメインのリストにそのまま記録
+    ListBackend backend(this, dx_->GetCommandList());
+    queue_.Execute(backend);
+    lastWorkerListCount_ = 0;
+    EndFrame_();
+    return;
+  }
+
+  // 並べ替え済みの列を連続した範囲に分け、範囲ごとに別リストへ並列記録
+  std::vector<RenderQueueStats> sliceStats(listCount);
+  jobs->Dispatch(listCount, [&](uint32_t i) {
+    const size_t begin = total * i / listCount;
+    const size_t end = total * (i + 1) / listCount;
+    ID3D12GraphicsCommandList *list = dx_->BeginWorkerCommandList(i);
+    ListBackend backend(this, list);
+    queue_.ExecuteRange(backend, begin, end, sliceStats[i]);
+    dx_->EndWorkerCommandList(i);
+  });
+
+  // メイン（バリア・クリア・インスタンシング）→ ワーカー順に提出。
+  // この後のメインのリストには ImGui パスが記録される
+  dx_->SubmitWorkerCommandLists(listCount);
+
+  RenderQueueStats stats{};
+  for (const auto &st : sliceStats) {
+    RenderQueue::Accumulate(stats, st);
+  }
+  queue_.FinishFrame(stats);
+  lastWorkerListCount_ = listCount;
+  EndFrame_();
 }
 
-void Renderer::DrawSkybox(Skybox *skybox) {
-  if (!skybox)
-    return;
-  auto *cmdList = dx_->GetCommandList();
-  skyboxPipeline_->SetPipelineState(cmdList);
+void Renderer::EndFrame_() {
+  orderedSequence_ = 0;
+  meshletRanges_.clear();
+  lastMeshletStats_ = meshletStats_;
+  meshletStats_ = {};
+}
 
-  D3D12_VERTEX_BUFFER_VIEW vbv{};
-  vbv.BufferLocation = skybox->GetVBAddress();
-  vbv.SizeInBytes = skybox->GetVBSize();
-  vbv.StrideInBytes = skybox->GetVBStride();
-  cmdList->IASetVertexBuffers(0, 1, &vbv);
+void Renderer::ListBackend::BindDescriptorHeaps() {
+  ID3D12DescriptorHeap *heaps[] = {r_->dx_->GetSRVHeap()};
+  list_->SetDescriptorHeaps(1, heaps);
+}
 
-  D3D12_INDEX_BUFFER_VIEW ibv{};
-  ibv.BufferLocation = skybox->GetIBAddress();
-  ibv.SizeInBytes = skybox->GetIBSize();
-  ibv.Format = DXGI_FORMAT_R32_UINT;
-  cmdList->IASetIndexBuffer(&ibv);
+void Renderer::ListBackend::BindPipeline(uint32_t pipeline) {
+  auto *cmdList = list_;
+  r_->GetPipelineById_(pipeline)->SetPipelineState(cmdList);
+  cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
 
-  cmdList->SetGraphicsRootConstantBufferView(0, skybox->GetMaterialCBAddress());
-  cmdList->SetGraphicsRootConstantBufferView(1,
-                                             skybox->GetTransformCBAddress());
+void Renderer::ListBackend::BindFrameConstants(uint32_t /*pipeline*/) {
+  // Object3D 系のルート配置: 3=DirLight / 4=Camera / 5=PointLight / 6=SpotLight
+  auto *cmdList = list_;
+  const FrameConstantAddresses &fc = r_->frameConstants_;
+  cmdList->SetGraphicsRootConstantBufferView(3, fc.directionalLight);
+  cmdList->SetGraphicsRootConstantBufferView(4, fc.camera);
+  cmdList->SetGraphicsRootConstantBufferView(5, fc.pointLight);
+  cmdList->SetGraphicsRootConstantBufferView(6, fc.spotLight);
+}
 
-  ID3D12DescriptorHeap *heaps[] = {dx_->GetSRVHeap()};
-  cmdList->SetDescriptorHeaps(1, heaps);
-  cmdList->SetGraphicsRootDescriptorTable(2, skybox->GetTexture()->GetSrvGpu());
+void Renderer::ListBackend::BindTexture(const RenderCommand &cmd) {
+  // Model / Sprite / Skybox はいずれも 2 = PS t0
+  D3D12_GPU_DESCRIPTOR_HANDLE texHandle{};
+  texHandle.ptr = cmd.texture;
+  list_->SetGraphicsRootDescriptorTable(2, texHandle);
+}
 
-  cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-  cmdList->DrawIndexedInstanced(skybox->GetIndexCount(), 1, 0, 0, 0);
+void Renderer::ListBackend::BindGeometry(const RenderCommand &cmd) {
+  auto *cmdList = list_;
+
+  switch (static_cast<DrawKind>(cmd.kind)) {
+  case DrawKind::Model: {
+    auto *resource = static_cast<ModelInstance *>(cmd.object)->GetResource();
+    D3D12_VERTEX_BUFFER_VIEW vbv{};
+    vbv.BufferLocation = resource->GetVBVAddress();
+    vbv.SizeInBytes = resource->GetVBVSize();
+    vbv.StrideInBytes = resource->GetVBVStride();
+    cmdList->IASetVertexBuffers(0, 1, &vbv);
+
+    D3D12_INDEX_BUFFER_VIEW ibv{};
+    ibv.BufferLocation = resource->GetIBVAddress();
+    ibv.SizeInBytes = resource->GetIBVSize();
+    ibv.Format = static_cast<DXGI_FORMAT>(resource->GetIBVFormat());
+    cmdList->IASetIndexBuffer(&ibv);
+
+    if (resource->IsSkinned()) {
+      D3D12_VERTEX_BUFFER_VIEW skinVbv{};
+      skinVbv.BufferLocation = resource->GetSkinVBVAddress();
+      skinVbv.SizeInBytes = resource->GetSkinVBVSize();
+      skinVbv.StrideInBytes = resource->GetSkinVBVStride();
+      cmdList->IASetVertexBuffers(1, 1, &skinVbv);
+    }
+    break;
+  }
+  case DrawKind::Sprite: {
+    auto *res = static_cast<Sprite *>(cmd.object)->GetResource();
+    D3D12_VERTEX_BUFFER_VIEW vbv{};
+    vbv.BufferLocation = res->GetVBAddress();
+    vbv.SizeInBytes = res->GetVBSize();
+    vbv.StrideInBytes = res->GetVBStride();
+    cmdList->IASetVertexBuffers(0, 1, &vbv);
+
+    D3D12_INDEX_BUFFER_VIEW ibv{};
+    ibv.BufferLocation = res->GetIBAddress();
+    ibv.SizeInBytes = res->GetIBSize();
+    ibv.Format = DXGI_FORMAT_R16_UINT;
+    cmdList->IASetIndexBuffer(&ibv);
+    break;
+  }
+  case DrawKind::Skybox: {
+    auto *skybox = static_cast<Skybox *>(cmd.object);
+    D3D12_VERTEX_BUFFER_VIEW vbv{};
+    vbv.BufferLocation = skybox->GetVBAddress();
+    vbv.SizeInBytes = skybox->GetVBSize();
+    vbv.StrideInBytes = skybox->GetVBStride();
+    cmdList->IASetVertexBuffers(0, 1, &vbv);
+
+    D3D12_INDEX_BUFFER_VIEW ibv{};
+    ibv.BufferLocation = skybox->GetIBAddress();
+    ibv.SizeInBytes = skybox->GetIBSize();
+    ibv.Format = DXGI_FORMAT_R32_UINT;
+    cmdList->IASetIndexBuffer(&ibv);
+    break;
+  }
+  default:
+    break;
+  }
 }
 
-void Renderer::DrawParticles(ParticleManager *pm, BlendMode blendMode) {
-  if (!pm)
-    return;
-  auto *cmdList = dx_->GetCommandList();
-  UnifiedPipeline *pipeline = GetParticlePipeline_(blendMode);
-  pipeline->SetPipelineState(cmdList);
-  pm->DrawInternal(cmdList);
+void Renderer::ListBackend::Draw(const RenderCommand &cmd) {
+  auto *cmdList = list_;
+
+  switch (static_cast<DrawKind>(cmd.kind)) {
+  case DrawKind::Model: {
+    auto *instance = static_cast<ModelInstance *>(cmd.object);
+    cmdList->SetGraphicsRootConstantBufferView(0, cmd.materialConstants);
+    cmdList->SetGraphicsRootConstantBufferView(1, cmd.transformConstants);
+    if (cmd.skinPalette != 0) {
+      // MakeObject3DSkinnedDesc の 7 = VS t1
+      cmdList->SetGraphicsRootShaderResourceView(7, cmd.skinPalette);
+    }
+    if (cmd.rangeCount > 0) {
+      // メッシュレットのカリングで残った範囲だけ
+      const MeshletCulling::IndexRange *ranges =
+          r_->meshletRanges_.data() + cmd.rangeFirst;
+      for (uint32_t i = 0; i < cmd.rangeCount; ++i) {
+        cmdList->DrawIndexedInstanced(ranges[i].indexCount, 1,
+                                      ranges[i].indexStart, 0, 0);
+      }
+      break;
+    }
+    const auto *resource = instance->GetResource();
+    const uint32_t submeshCount = resource->GetSubmeshCount();
+    const auto &submesh = resource->GetSubmesh(cmd.subset / submeshCount,
+                                               cmd.subset % submeshCount);
+    cmdList->DrawIndexedInstanced(submesh.indexCount, 1, submesh.indexStart,
+                                  0, 0);
+    break;
+  }
+  case DrawKind::Sprite: {
+    auto *sprite = static_cast<Sprite *>(cmd.object);
+    cmdList->SetGraphicsRootConstantBufferView(0, cmd.materialConstants);
+    cmdList->SetGraphicsRootConstantBufferView(1, cmd.transformConstants);
+    cmdList->DrawIndexedInstanced(sprite->GetResource()->GetIndexCount(), 1, 0,
+                                  0, 0);
+    break;
+  }
+  case DrawKind::Skybox: {
+    auto *skybox = static_cast<Skybox *>(cmd.object);
+    cmdList->SetGraphicsRootConstantBufferView(0, cmd.materialConstants);
+    cmdList->SetGraphicsRootConstantBufferView(1, cmd.transformConstants);
+    cmdList->DrawIndexedInstanced(skybox->GetIndexCount(), 1, 0, 0, 0);
+    break;
+  }
+  case DrawKind::Particles:
+    static_cast<ParticleManager *>(cmd.object)->DrawInternal(cmdList);
+    break;
+  }
+}
+
+UnifiedPipeline *Renderer::GetPipelineById_(uint32_t id) const {
+  if (id == kPipelineObjWireframe)
+    return objPipelineWireframe_.get();
+  if (id == kPipelineObjSkinned)
+    return objSkinnedPipeline_.get();
+  if (id == kPipelineObjSkinnedWireframe)
+    return objSkinnedPipelineWireframe_.get();
+  if (id == kPipelineSkybox)
+    return skyboxPipeline_.get();
+  if (id >= kPipelineParticleBase && id < kPipelineCount)
+    return GetParticlePipeline_(
+        static_cast<BlendMode>(id - kPipelineParticleBase));
+  if (id >= kPipelineSpriteBase && id < kPipelineParticleBase)
+    return GetSpritePipeline_(static_cast<BlendMode>(id - kPipelineSpriteBase));
+  return objPipelineOpaque_.get();
 }
 
-UnifiedPipeline *Renderer::GetSpritePipeline_(BlendMode mode) {
+UnifiedPipeline *Renderer::GetSpritePipeline_(BlendMode mode) const {
   switch (mode) {
   case BlendMode::Add:
     return spritePipelineAdd_.get();
@@ -375,7 +897,7 @@ UnifiedPipeline *Renderer::GetSpritePipeline_(BlendMode mode) {
   }
 }
 
-UnifiedPipeline *Renderer::GetParticlePipeline_(BlendMode mode) {
+UnifiedPipeline *Renderer::GetParticlePipeline_(BlendMode mode) const {
   switch (mode) {
   case BlendMode::Add:
     return particlePipelineAdd_.get();
@@ -392,22 +914,12 @@ UnifiedPipeline *Renderer::GetParticlePipeline_(BlendMode mode) {
 
 Microsoft::WRL::ComPtr<ID3D12Resource>
 Renderer::CreateUploadBuffer(size_t size) {
-  auto device = dx_->GetDevice();
-  Microsoft::WRL::ComPtr<ID3D12Resource> res;
-  D3D12_HEAP_PROPERTIES heapProps{};
-  heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-  D3D12_RESOURCE_DESC desc{};
-  desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-  desc.Width = size;
-  desc.Height = 1;
-  desc.DepthOrArraySize = 1;
-  desc.MipLevels = 1;
-  desc.SampleDesc.Count = 1;
-  desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-  device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &desc,
-                                  D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-                                  IID_PPV_ARGS(&res));
-  return res;
+  return CreateBufferResource(dx_->GetDevice(), size);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource>
+Renderer::CreateStaticBuffer(const void *data, size_t size) {
+  return dx_->GetUploadQueue().CreateStaticBuffer(data, size);
 }
 
 Microsoft::WRL::ComPtr<ID3D12Resource> Renderer::CreateBuffer(size_t size) {
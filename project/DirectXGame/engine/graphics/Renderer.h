@@ -4,10 +4,18 @@
 #include <vector>
 #include <wrl.h>
 
+#include "FramePacer.h"
+#include "FrameUploadAllocator.h"
+#include "InstanceBatchBuilder.h"
 #include "LightTypes.h"
+#include "LodSelector.h"
+#include "MeshletCulling.h"
 #include "Matrix.h"
 #include "Method.h"
+#include "RenderPassGraph.h"
+#include "RenderQueue.h"
 #include "UnifiedPipeline.h"
+#include "VertexPacking.h"
 
 class DirectXCommon;
 class ModelInstance;
@@ -80,6 +88,7 @@ struct alignas(16) SpotLightGroupCB {
   float padEnabled[3];
 };
 
+// Draw* はキューに積むだけで、実際のコマンド記録は Flush でまとめて行う
 class Renderer {
 public:
   template <class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
@@ -87,7 +96,10 @@ public:
   // シングルトンの取得（実体は.cpp）
   static Renderer *GetInstance();
 
-  void Initialize(DirectXCommon *dx);
+  // modelVertexFormat: 以後作られる ModelResource の頂点形式（パイプラインも合わせる）
+  void Initialize(DirectXCommon *dx,
+                  ModelVertexFormat modelVertexFormat = ModelVertexFormat::Full);
+  ModelVertexFormat GetModelVertexFormat() const { return modelVertexFormat_; }
 
   // シーン層向け API
   void SetCamera(const Camera &camera);
@@ -106,38 +118,154 @@ public:
 
   ComPtr<ID3D12Resource> CreateBuffer(size_t size);
   ComPtr<ID3D12Resource> CreateUploadBuffer(size_t size);
+  // 書き換えない頂点/インデックス用。DEFAULT ヒープへコピーキューで 1 回だけ転送する
+  ComPtr<ID3D12Resource> CreateStaticBuffer(const void *data, size_t size);
 
-  // 描画メソッド群
+  // 描画メソッド群（RenderQueue に積む）
   void DrawModel(ModelInstance *model);
+  // インスタンシング描画キューに積む（描画は FlushInstancedModels）
+  void DrawModelInstanced(ModelInstance *model);
+  // 積まれたインスタンスを ModelResource ごとに 1 回の DrawInstanced で描画
+  // - インスタンスバッファを先頭から使い直すため 1 フレームに 1 回だけ呼ぶ
+  //   （Flush からも呼ばれる。積まれていなければ何もしない）
+  void FlushInstancedModels();
   void DrawSprite(Sprite *sprite);
   void DrawSkybox(Skybox *skybox);
   void DrawParticles(ParticleManager *pm,
                      BlendMode blendMode = BlendMode::Alpha);
 
+  // 積まれた描画をソートしてコマンドリストに記録する（フレームの最後に 1 回）
+  void Flush();
+
+  // 直近の Flush の統計（描画数・省略したバインド数）
+  const RenderQueueStats &GetQueueStats() const { return queue_.GetStats(); }
+
+  // Flush の記録をワーカースレッドに分割するか（コマンドが少ないときは分割しない）
+  void SetParallelRecording(bool enable) { parallelRecording_ = enable; }
+  bool IsParallelRecording() const { return parallelRecording_; }
+  // 直近の Flush で使ったワーカー用コマンドリスト数（0 = メインのリストのみ）
+  uint32_t GetLastWorkerListCount() const { return lastWorkerListCount_; }
+
+  // モデルの LOD の選び方（許容する画面上のずれ・切り替えの余裕）
+  void SetLodSettings(const LodSelector::Settings &settings) {
+    lodSettings_ = settings;
+  }
+  const LodSelector::Settings &GetLodSettings() const { return lodSettings_; }
+
+  // LOD0 で描く大きなメッシュを、メッシュレット単位で視錐台・裏面カリングするか
+  void SetMeshletCulling(bool enable) { meshletCulling_ = enable; }
+  bool IsMeshletCulling() const { return meshletCulling_; }
+  // 直近の Flush までのフレームで判定・カリングしたメッシュレット数
+  const MeshletCulling::Stats &GetLastMeshletStats() const {
+    return lastMeshletStats_;
+  }
+
+  // フレームごとの一時定数領域（描画ごとの CB・カメラ・ライトはここから確保）
+  FrameUploadAllocator &GetFrameUploadAllocator() { return uploadAllocator_; }
+
   ~Renderer();
 
 private:
   Renderer();
 
+  // RenderCommand::kind
+  enum class DrawKind : uint32_t { Model, Sprite, Skybox, Particles };
+
+  // RenderCommand::pipeline（ブレンド別のものは Base + BlendMode）
+  enum PipelineId : uint32_t {
+    kPipelineObjOpaque = 0,
+    kPipelineObjWireframe,
+    kPipelineObjSkinned,
+    kPipelineObjSkinnedWireframe,
+    kPipelineSkybox,
+    kPipelineSpriteBase,
+    kPipelineParticleBase = kPipelineSpriteBase + 6,
+    kPipelineCount = kPipelineParticleBase + 6,
+  };
+
+  // 1 本のコマンドリストに記録する IRenderBackend（実装は .cpp）
+  class ListBackend;
+
+  UnifiedPipeline *GetPipelineById_(uint32_t id) const;
+
+  // 境界球を投影した半径（ピクセル）
+  float ProjectedRadius_(const ModelInstance *instance) const;
+  // 境界球の画面上の大きさから instance の LOD を選び、instance に記録して返す
+  uint32_t SelectLod_(ModelInstance *instance, float projectedRadius) const;
+  // モデルのテクスチャが画面上でどれだけの大きさに映るかを TextureManager に伝える
+  // （ミップのストリーミング用。UV がモデル全体に 1 回貼られている前提の目安）
+  void ReportTextureUsage_(const ModelResource *resource,
+                           float projectedRadius) const;
+  // Flush の最後に、フレーム単位で積んだ状態を戻す
+  void EndFrame_();
+
+  RenderQueue queue_;
+  // パスの依存関係（RenderQueue の再生順・リストの提出順を決める）
+  RenderPassGraph passGraph_;
+
+  // 1 本のワーカーリストに割り当てる最小コマンド数（少なければ分割しない）
+  static constexpr size_t kMinCommandsPerWorkerList = 64;
+  bool parallelRecording_ = true;
+  uint32_t lastWorkerListCount_ = 0;
+  // Sprite / Particle の登録順（順序依存パスの depth に使う）
+  uint32_t orderedSequence_ = 0;
+
   DirectXCommon *dx_ = nullptr;
+  ModelVertexFormat modelVertexFormat_ = ModelVertexFormat::Full;
 
   Matrix4x4 view_ = MakeIdentity4x4();
   Matrix4x4 proj_ = MakeIdentity4x4();
+  LodSelector::Settings lodSettings_{};
 
-  ComPtr<ID3D12Resource> cameraCB_;
-  CameraForGPU *cameraMapped_ = nullptr;
+  // RenderCommand::rangeFirst / rangeCount が指す、カリング後のインデックス範囲
+  // DrawModel で積み、Flush の記録が終わったら空にする
+  bool meshletCulling_ = true;
+  std::vector<MeshletCulling::IndexRange> meshletRanges_;
+  MeshletCulling::Stats meshletStats_{};
+  MeshletCulling::Stats lastMeshletStats_{};
 
-  ComPtr<ID3D12Resource> directionalLightCB_;
-  DirectionalLightGroupCB *directionalLightMapped_ = nullptr;
+  // CPU 側の値（Set* で更新し、Flush で今フレームのスロットへ書き出す）
+  CameraForGPU camera_{};
+  DirectionalLightGroupCB directionalLights_{};
+  PointLightGroupCB pointLights_{};
+  SpotLightGroupCB spotLights_{};
 
-  ComPtr<ID3D12Resource> pointLightCB_;
-  PointLightGroupCB *pointLightMapped_ = nullptr;
+  // 1 フレームぶんの一時定数領域の初期サイズ（足りなければ倍々で広がる）
+  static constexpr uint64_t kUploadBytesPerFrame = 1ull << 20;
+  FrameUploadAllocator uploadAllocator_;
 
-  ComPtr<ID3D12Resource> spotLightCB_;
-  SpotLightGroupCB *spotLightMapped_ = nullptr;
+  // 今フレームのカメラ・ライト CB の GPU アドレス（UploadFrameConstants_ で確保）
+  struct FrameConstantAddresses {
+    uint64_t camera = 0;
+    uint64_t directionalLight = 0;
+    uint64_t pointLight = 0;
+    uint64_t spotLight = 0;
+  };
+  FrameConstantAddresses frameConstants_{};
+  // frameConstants_ を確保したフレームの通し番号
+  uint64_t frameConstantsFrame_ = ~0ull;
+
+  // 先行フレームを GPU が読んでいる間に上書きしないよう、フレームスロットごとに持つ
+  struct FrameResources {
+    // インスタンシング用 StructuredBuffer（t1）
+    ComPtr<ID3D12Resource> instanceBuffer;
+    InstanceDataGPU *instanceMapped = nullptr;
+    uint32_t instanceCapacity = 0;
+    uint32_t instanceSrvIndex = 0;
+  };
+  FrameResources frames_[FramePacer::kMaxFramesInFlight];
+
+  FrameResources &CurrentFrame_();
+  const FrameResources &CurrentFrame_() const;
+  // CPU 側のカメラ・ライトを今フレームの一時定数領域へコピー（フレームに 1 回）
+  void UploadFrameConstants_();
 
   std::unique_ptr<UnifiedPipeline> objPipelineOpaque_;
   std::unique_ptr<UnifiedPipeline> objPipelineWireframe_;
+  std::unique_ptr<UnifiedPipeline> objInstancedPipeline_;
+  std::unique_ptr<UnifiedPipeline> objInstancedPipelineWireframe_;
+  std::unique_ptr<UnifiedPipeline> objSkinnedPipeline_;
+  std::unique_ptr<UnifiedPipeline> objSkinnedPipelineWireframe_;
   std::unique_ptr<UnifiedPipeline> skyboxPipeline_;
 
   std::unique_ptr<UnifiedPipeline> spritePipelineAlpha_;
@@ -152,6 +280,10 @@ private:
   std::unique_ptr<UnifiedPipeline> particlePipelineMul_;
   std::unique_ptr<UnifiedPipeline> particlePipelineScreen_;
 
-  UnifiedPipeline *GetSpritePipeline_(BlendMode mode);
-  UnifiedPipeline *GetParticlePipeline_(BlendMode mode);
+  InstanceBatchBuilder instanceBatch_;
+
+  void EnsureInstanceCapacity_(FrameResources &frame, uint32_t count);
+
+  UnifiedPipeline *GetSpritePipeline_(BlendMode mode) const;
+  UnifiedPipeline *GetParticlePipeline_(BlendMode mode) const;
 };
\ No newline at end of file
@@ -5,10 +5,6 @@
 #include <d3d12.h>
 #include <cassert>
 
-namespace {
-static constexpr UINT Align256_(UINT n) { return (n + 255u) & ~255u; }
-} // namespace
-
 bool Skybox::Initialize(const std::string &texturePath) {
   auto *renderer = Renderer::GetInstance();
 
@@ -19,28 +15,15 @@ bool Skybox::Initialize(const std::string &texturePath) {
 
   // 1. 頂点バッファ
   const size_t vbSize = sizeof(Vertex) * vertices.size();
-  vb_ = renderer->CreateUploadBuffer(vbSize);
-  void *vbData = nullptr;
-  vb_->Map(0, nullptr, &vbData);
-  std::memcpy(vbData, vertices.data(), vbSize);
-  vb_->Unmap(0, nullptr);
+  vb_ = renderer->CreateStaticBuffer(vertices.data(), vbSize);
 
   // 2. インデックスバッファ
   const size_t ibSize = sizeof(uint32_t) * indices.size();
-  ib_ = renderer->CreateUploadBuffer(ibSize);
-  void *ibData = nullptr;
-  ib_->Map(0, nullptr, &ibData);
-  std::memcpy(ibData, indices.data(), ibSize);
-  ib_->Unmap(0, nullptr);
-
-  // 3. 定数バッファ
-  materialCB_ = renderer->CreateUploadBuffer(Align256_(sizeof(MaterialCB)));
-  materialCB_->Map(0, nullptr, reinterpret_cast<void **>(&materialMapped_));
-  *materialMapped_ = MaterialCB{};
+  ib_ = renderer->CreateStaticBuffer(indices.data(), ibSize);
 
-  transformCB_ = renderer->CreateUploadBuffer(Align256_(sizeof(TransformCB)));
-  transformCB_->Map(0, nullptr, reinterpret_cast<void **>(&transformMapped_));
-  *transformMapped_ = TransformCB{};
+  // 3. 定数（GPU へは描画時に Renderer が転送）
+  material_ = MaterialCB{};
+  transform_ = TransformCB{};
 
   // 4. テクスチャ
   texture_ = TextureManager::GetInstance()->Load(texturePath);
@@ -50,12 +33,10 @@ bool Skybox::Initialize(const std::string &texturePath) {
 
 void Skybox::Update(const Matrix4x4 &view, const Matrix4x4 &proj,
                     const Vector3 &camPos, const Vector3 &scale) {
-  if (!transformMapped_)
-    return;
   Matrix4x4 world = MakeAffineMatrix(scale, {0, 0, 0}, camPos);
-  transformMapped_->World = world;
-  transformMapped_->WVP = Multiply(world, Multiply(view, proj));
-  transformMapped_->WorldInverseTranspose = Transpose(Inverse(world));
+  transform_.World = world;
+  transform_.WVP = Multiply(world, Multiply(view, proj));
+  transform_.WorldInverseTranspose = Transpose(Inverse(world));
 }
 
 void Skybox::Draw() { Renderer::GetInstance()->DrawSkybox(this); }
@@ -75,16 +56,9 @@ unsigned int Skybox::GetIBSize() const {
   return (unsigned int)ib_->GetDesc().Width;
 }
 unsigned int Skybox::GetIndexCount() const { return indexCount_; }
-unsigned long long Skybox::GetMaterialCBAddress() const {
-  return materialCB_->GetGPUVirtualAddress();
-}
-unsigned long long Skybox::GetTransformCBAddress() const {
-  return transformCB_->GetGPUVirtualAddress();
-}
 
 void Skybox::SetColor(const Vector4 &color) {
-  if (materialMapped_)
-    materialMapped_->color = color;
+  material_.color = color;
 }
 
 void Skybox::CreateVertices_(std::vector<Vertex> &vertices,
@@ -39,8 +39,9 @@ public:
   unsigned long long GetIBAddress() const;
   unsigned int GetIBSize() const;
   unsigned int GetIndexCount() const;
-  unsigned long long GetMaterialCBAddress() const;
-  unsigned long long GetTransformCBAddress() const;
+  // 定数バッファの中身（Renderer が描画ごとにフレーム用アップロード領域へ書く）
+  const MaterialCB &GetMaterial() const { return material_; }
+  const TransformCB &GetTransform() const { return transform_; }
   std::shared_ptr<TextureResource> GetTexture() const { return texture_; }
 
   void SetColor(const Vector4 &color);
@@ -55,11 +56,9 @@ private:
 
   ComPtr<ID3D12Resource> vb_;
   ComPtr<ID3D12Resource> ib_;
-  ComPtr<ID3D12Resource> materialCB_;
-  ComPtr<ID3D12Resource> transformCB_;
   std::shared_ptr<TextureResource> texture_;
 
   unsigned int indexCount_ = 0;
-  MaterialCB *materialMapped_ = nullptr;
-  TransformCB *transformMapped_ = nullptr;
+  MaterialCB material_{};
+  TransformCB transform_{};
 };
\ No newline at end of file
@@ -10,11 +10,6 @@
 #include <random>
 
 namespace {
-    std::mt19937& GetRNG() {
-        static std::mt19937 rng{ std::random_device{}() };
-        return rng;
-    }
-
     float Clamp01(float v) {
         return std::clamp(v, 0.0f, 1.0f);
     }
@@ -60,6 +55,7 @@ void ParticleEmitter::Initialize(ParticleManager* manager, const Params& params)
     manager_ = manager;
     params_ = params;
     emitAccum_ = 0.0f;
+    rng_.seed(params_.randomSeed != 0 ? params_.randomSeed : std::random_device{}());
     assert(manager_);
 }
 
@@ -80,8 +76,10 @@ void ParticleEmitter::Update(float deltaTime, const Vector3& parentTranslate) {
         const Vector3 vel = SampleVelocity_();
         const float life = RandRange_(params_.lifeMin, params_.lifeMax);
         const Vector4 col = SampleColor_();
+        const float rot = RandRange_(params_.rotationMin, params_.rotationMax);
+        const float angVel = RandRange_(params_.angularVelocityMin, params_.angularVelocityMax);
 
-        manager_->Emit(params_.groupName, pos, vel, params_.particleScale, life, col);
+        manager_->Emit(params_.groupName, pos, vel, params_.particleScale, life, col, rot, angVel);
     }
 }
 
@@ -95,8 +93,10 @@ void ParticleEmitter::Burst(uint32_t count, const Vector3& parentTranslate) {
         const Vector3 vel = SampleVelocity_();
         const float life = RandRange_(params_.lifeMin, params_.lifeMax);
         const Vector4 col = SampleColor_();
+        const float rot = RandRange_(params_.rotationMin, params_.rotationMax);
+        const float angVel = RandRange_(params_.angularVelocityMin, params_.angularVelocityMax);
 
-        manager_->Emit(params_.groupName, pos, vel, params_.particleScale, life, col);
+        manager_->Emit(params_.groupName, pos, vel, params_.particleScale, life, col, rot, angVel);
     }
 }
 
@@ -201,8 +201,9 @@ Vector4 ParticleEmitter::SampleColor_() const {
 }
 
 float ParticleEmitter::Rand01_() const {
-    static std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-    return dist(GetRNG());
+    // 分布オブジェクトは内部状態を持ち得るので共有せず毎回作る（再現性のため）
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    return dist(rng_);
 }
 
 float ParticleEmitter::RandRange_(float minV, float maxV) const {
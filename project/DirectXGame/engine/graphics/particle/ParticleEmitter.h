@@ -3,6 +3,7 @@
 #include "Vector.h"
 
 #include <cstdint>
+#include <random>
 #include <string>
 
 class ParticleManager;
@@ -46,6 +47,12 @@ public:
 
         Vector3 particleScale{ 0.5f, 0.5f, 0.5f };
 
+        // 初期回転（ラジアン）と角速度（ラジアン/秒）の範囲
+        float rotationMin = 0.0f;
+        float rotationMax = 0.0f;
+        float angularVelocityMin = 0.0f;
+        float angularVelocityMax = 0.0f;
+
         float emitRate = 10.0f; // 1秒あたり
 
         ParticleColorMode colorMode = ParticleColorMode::RandomRGB;
@@ -60,6 +67,9 @@ public:
         // h: 0..1, s:0..1, v:0..1
         Vector3 baseHSV{ 0.0f, 1.0f, 1.0f };
         Vector3 hsvRange{ 0.0f, 0.0f, 0.0f };
+
+        // 乱数シード（0: 毎回ランダム / それ以外: 同じ入力列なら同じ発生結果になる）
+        uint32_t randomSeed = 0;
     };
 
     ParticleEmitter() = default;
@@ -68,6 +78,7 @@ public:
     void Initialize(ParticleManager* manager, const Params& params);
 
     // 親Transformに追従したい場合は parentTranslate を渡す
+    // - フレームレート非依存にしたい場合は固定刻みで呼ぶ（ParticleManager::Simulate と同じ刻み）
     void Update(float deltaTime, const Vector3& parentTranslate = { 0,0,0 });
 
     // その場で即時発生（発生頻度とは別）
@@ -88,4 +99,7 @@ private:
     ParticleManager* manager_ = nullptr;
     Params params_{};
     float emitAccum_ = 0.0f;
+
+    // エミッタごとの乱数列（シード固定でリプレイ可能）
+    mutable std::mt19937 rng_{};
 };
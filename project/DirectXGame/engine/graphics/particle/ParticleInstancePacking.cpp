@@ -0,0 +1,110 @@
+#define NOMINMAX
+
+#include "ParticleInstancePacking.h"
+#include "Method.h"
+
+#include <algorithm>
+#include <cmath>
+
+BillboardBasis MakeBillboardBasis(const Matrix4x4& viewMatrix) {
+    const Matrix4x4 camWorld = Inverse(viewMatrix);
+
+    BillboardBasis b{};
+    b.right = { camWorld.m[0][0], camWorld.m[0][1], camWorld.m[0][2] };
+    b.up = { camWorld.m[1][0], camWorld.m[1][1], camWorld.m[1][2] };
+    b.forward = { -camWorld.m[2][0], -camWorld.m[2][1], -camWorld.m[2][2] };
+    return b;
+}
+
+uint32_t ComputeFlipbookFrame(const ParticleFlipbook& flipbook, float age, float lifetime) {
+    const uint32_t cells = std::max(flipbook.columns, 1u) * std::max(flipbook.rows, 1u);
+    const uint32_t frameCount = std::clamp(flipbook.frameCount, 1u, cells);
+    if (frameCount == 1) {
+        return flipbook.startFrame % cells;
+    }
+
+    // 開始コマを足してから折り返す／止める（1 回再生は最後のコマで止まる）
+    const uint32_t start = flipbook.startFrame % frameCount;
+    const float count = static_cast<float>(frameCount);
+    const float safeAge = age > 0.0f ? age : 0.0f; // 負値・NaN は 0
+    if (flipbook.framesPerSecond > 0.0f) {
+        float framePos = safeAge * flipbook.framesPerSecond;
+        // 整数に直す前に範囲を抑える（長寿命の粒で uint32_t を溢れさせない）
+        framePos = flipbook.loop ? std::fmod(framePos, count) : std::min(framePos, count);
+        if (!(framePos >= 0.0f)) {
+            framePos = 0.0f; // age が無限大だと fmod が NaN になる
+        }
+        const uint32_t frame = static_cast<uint32_t>(framePos) + start;
+        return flipbook.loop ? frame % frameCount : std::min(frame, frameCount - 1);
+    }
+
+    // 寿命全体で start..最後のコマを 1 回
+    if (!(lifetime > 0.0f)) {
+        return start;
+    }
+    const float t = std::min(safeAge / lifetime, 1.0f);
+    const uint32_t frame = start + static_cast<uint32_t>(t * static_cast<float>(frameCount - start));
+    return std::min(frame, frameCount - 1);
+}
+
+Vector4 MakeFlipbookUVRect(const ParticleFlipbook& flipbook, uint32_t frame) {
+    const uint32_t columns = std::max(flipbook.columns, 1u);
+    const uint32_t rows = std::max(flipbook.rows, 1u);
+    frame %= columns * rows;
+
+    const float scaleU = 1.0f / static_cast<float>(columns);
+    const float scaleV = 1.0f / static_cast<float>(rows);
+    const float col = static_cast<float>(frame % columns);
+    const float row = static_cast<float>(frame / columns);
+    return { col * scaleU, row * scaleV, scaleU, scaleV };
+}
+
+Matrix4x4 MakeBillboardMatrix(const BillboardBasis& basis, const Vector3& scale,
+    float rotation, const Vector3& translate) {
+    // ビュー方向軸まわりに right/up を回す
+    const float c = std::cos(rotation);
+    const float s = std::sin(rotation);
+    const Vector3 right{
+        basis.right.x * c + basis.up.x * s,
+        basis.right.y * c + basis.up.y * s,
+        basis.right.z * c + basis.up.z * s,
+    };
+    const Vector3 up{
+        basis.up.x * c - basis.right.x * s,
+        basis.up.y * c - basis.right.y * s,
+        basis.up.z * c - basis.right.z * s,
+    };
+
+    Matrix4x4 m{};
+    m.m[0][0] = scale.x * right.x;
+    m.m[0][1] = scale.x * right.y;
+    m.m[0][2] = scale.x * right.z;
+    m.m[0][3] = 0;
+
+    m.m[1][0] = scale.y * up.x;
+    m.m[1][1] = scale.y * up.y;
+    m.m[1][2] = scale.y * up.z;
+    m.m[1][3] = 0;
+
+    m.m[2][0] = scale.z * basis.forward.x;
+    m.m[2][1] = scale.z * basis.forward.y;
+    m.m[2][2] = scale.z * basis.forward.z;
+    m.m[2][3] = 0;
+
+    m.m[3][0] = translate.x;
+    m.m[3][1] = translate.y;
+    m.m[3][2] = translate.z;
+    m.m[3][3] = 1;
+    return m;
+}
+
+ParticleForGPU PackParticleInstance(const BillboardBasis& basis, const Matrix4x4& viewProj,
+    const Vector3& scale, float rotation, const Vector3& translate, const Vector4& color,
+    const Vector4& uvRect) {
+    ParticleForGPU out{};
+    out.World = MakeBillboardMatrix(basis, scale, rotation, translate);
+    out.WVP = Multiply(out.World, viewProj);
+    out.color = color;
+    out.uvRect = uvRect;
+    return out;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Matrix.h"
+#include "Vector.h"
+
+#include <cstdint>
+
+// GPUへ送るインスタンシングデータ（Particle.VS.hlsl の ParticleForGPU と一致させる）
+struct ParticleForGPU {
+    Matrix4x4 WVP;
+    Matrix4x4 World;
+    Vector4 color;
+    // フリップブックのコマ矩形（xy: UVオフセット / zw: UVスケール）
+    Vector4 uvRect;
+};
+
+// スプライトシート（フリップブック）設定
+// - テクスチャを columns x rows に等分し、左上から行優先でコマ番号を振る
+// - framesPerSecond == 0 のときは寿命全体で startFrame から最後のコマまでを1回再生する
+// - loop == false（framesPerSecond > 0）は startFrame から進め、最後のコマで止める
+struct ParticleFlipbook {
+    uint32_t columns = 1;
+    uint32_t rows = 1;
+    uint32_t frameCount = 1;
+    float framesPerSecond = 0.0f;
+    bool loop = true;
+    // グループ共通の開始コマ（frameCount 以上なら折り返す）
+    // frameCount == 1 のときは、シートのどのセルを表示するか
+    uint32_t startFrame = 0;
+};
+
+// ビルボードの基底（カメラのワールド行列から取り出す）
+struct BillboardBasis {
+    Vector3 right;
+    Vector3 up;
+    Vector3 forward;
+};
+
+// View 行列からビルボード基底を作る（フレームに1回）
+BillboardBasis MakeBillboardBasis(const Matrix4x4& viewMatrix);
+
+// age / lifetime から表示するコマ番号を求める
+uint32_t ComputeFlipbookFrame(const ParticleFlipbook& flipbook, float age, float lifetime);
+
+// コマ番号から UV 矩形を求める
+Vector4 MakeFlipbookUVRect(const ParticleFlipbook& flipbook, uint32_t frame);
+
+// 画面内回転（ビュー方向軸まわり）付きのビルボード行列
+Matrix4x4 MakeBillboardMatrix(const BillboardBasis& basis, const Vector3& scale,
+    float rotation, const Vector3& translate);
+
+// 1粒子分のインスタンスデータを詰める
+ParticleForGPU PackParticleInstance(const BillboardBasis& basis, const Matrix4x4& viewProj,
+    const Vector3& scale, float rotation, const Vector3& translate, const Vector4& color,
+    const Vector4& uvRect);
@@ -67,60 +67,52 @@ bool ParticleManager::CreateParticleGroup(const std::string& name, const std::st
     g.instanceLimit = maxInstances;
     g.activeInstanceCount = 0;
 
-    // Texture SRV (t0)
-    g.texture = TextureManager::GetInstance()->Load(texturePath);
+    // Texture SRV (t0)。アトラスに載っていればそのページを使い、
+    // UV（フリップブックのコマを選んだ後）をページ内の範囲に写す
+    TextureAtlas::Region region;
+    const bool inAtlas = TextureManager::GetInstance()->FindAtlasRegion(texturePath, region);
+    g.texture = inAtlas ? std::move(region.page) : TextureManager::GetInstance()->Load(texturePath);
     assert(g.texture);
-    g.textureSrvGpu = g.texture->GetSrvGpu();
 
-    // StructuredBuffer (t1)
-    g.instanceBuffer = CreateBufferResource(device_, sizeof(ParticleForGPU) * maxInstances);
+    // StructuredBuffer (t1)。フレームスロット数ぶんを 1 本にまとめて確保
+    g.frameCount = dx_->GetFramesInFlight();
+    const uint32_t totalInstances = maxInstances * g.frameCount;
+    g.instanceBuffer = CreateBufferResource(device_, sizeof(ParticleForGPU) * totalInstances);
     g.instanceBuffer->Map(0, nullptr, reinterpret_cast<void**>(&g.instanceMapped));
-    for (uint32_t i = 0; i < maxInstances; ++i) {
+    for (uint32_t i = 0; i < totalInstances; ++i) {
         g.instanceMapped[i].WVP = MakeIdentity4x4();
         g.instanceMapped[i].World = MakeIdentity4x4();
         g.instanceMapped[i].color = { 1,1,1,1 };
+        g.instanceMapped[i].uvRect = { 0,0,1,1 };
     }
 
     D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
     srvDesc.Format = DXGI_FORMAT_UNKNOWN;
     srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
     srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    srvDesc.Buffer.FirstElement = 0;
     srvDesc.Buffer.NumElements = maxInstances;
     srvDesc.Buffer.StructureByteStride = sizeof(ParticleForGPU);
     srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_NONE;
 
+    // スロットごとに先頭をずらした SRV を作る（シェーダー側は常に 0 始まりで読む）
     SrvAllocator* alloc = &dx_->GetSrvAllocator();
-    uint32_t index = alloc->Allocate();
-    g.instanceSrv = SrvHandle(alloc, index);
-    device_->CreateShaderResourceView(g.instanceBuffer.Get(), &srvDesc, alloc->Cpu(index));
-    g.instanceSrvGpu = alloc->Gpu(index);
+    for (uint32_t slot = 0; slot < g.frameCount; ++slot) {
+        srvDesc.Buffer.FirstElement = static_cast<UINT64>(slot) * maxInstances;
+        uint32_t index = alloc->Allocate();
+        g.instanceSrv[slot] = SrvHandle(alloc, index);
+        device_->CreateShaderResourceView(g.instanceBuffer.Get(), &srvDesc, alloc->Cpu(index));
+        g.instanceSrvGpu[slot] = alloc->Gpu(index);
+    }
 
     // Material CB (b0)
     {
-        D3D12_HEAP_PROPERTIES heapProps{};
-        heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-
-        D3D12_RESOURCE_DESC resDesc{};
-        resDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        resDesc.Width = sizeof(ParticleMaterialData);
-        resDesc.Height = 1;
-        resDesc.DepthOrArraySize = 1;
-        resDesc.MipLevels = 1;
-        resDesc.SampleDesc.Count = 1;
-        resDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-        HRESULT hr = device_->CreateCommittedResource(
-            &heapProps, D3D12_HEAP_FLAG_NONE, &resDesc,
-            D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-            IID_PPV_ARGS(&g.materialCB));
-        assert(SUCCEEDED(hr));
+        g.materialCB = CreateBufferResource(device_, sizeof(ParticleMaterialData));
 
         g.materialCB->Map(0, nullptr, reinterpret_cast<void**>(&g.materialMapped));
         g.materialMapped->color = { 1,1,1,1 };
         g.materialMapped->enableLighting = 0;
         g.materialMapped->pad[0] = g.materialMapped->pad[1] = g.materialMapped->pad[2] = 0.0f;
-        g.materialMapped->uvTransform = MakeIdentity4x4();
+        g.materialMapped->uvTransform = inAtlas ? TextureAtlas::MakeUVMatrix(region.uvRect) : MakeIdentity4x4();
     }
 
     groups_.emplace(name, std::move(g));
@@ -136,6 +128,14 @@ void ParticleManager::SetGroupInstanceLimit(const std::string& name, uint32_t li
     g.instanceLimit = std::min(limit, g.maxInstances);
 }
 
+void ParticleManager::SetGroupFlipbook(const std::string& name, const ParticleFlipbook& flipbook) {
+    auto it = groups_.find(name);
+    if (it == groups_.end()) {
+        return;
+    }
+    it->second.flipbook = flipbook;
+}
+
 void ParticleManager::ClearParticleGroup(const std::string& name) {
     auto it = groups_.find(name);
     if (it == groups_.end()) {
@@ -148,7 +148,8 @@ void ParticleManager::ClearParticleGroup(const std::string& name) {
 }
 
 void ParticleManager::Emit(const std::string& name, const Vector3& position, const Vector3& velocity,
-    const Vector3& scale, float lifetime, const Vector4& color) {
+    const Vector3& scale, float lifetime, const Vector4& color,
+    float rotation, float angularVelocity) {
     auto it = groups_.find(name);
     assert(it != groups_.end());
     if (it == groups_.end()) {
@@ -156,20 +157,32 @@ void ParticleManager::Emit(const std::string& name, const Vector3& position, con
     }
     ParticleGroup& g = it->second;
 
-    Particle p{};
-    p.transform.translate = position;
-    p.transform.scale = scale;
-    p.transform.rotate = { 0,0,0 };
-    p.velocity = velocity;
-    p.lifetime = lifetime;
-    p.age = 0.0f;
-    p.color = color;
-    g.particles.push_back(p);
+    g.particles.push_back(MakeParticle(position, velocity, scale, lifetime, color,
+        rotation, angularVelocity));
 }
 
-void ParticleManager::Update(float deltaTime) {
+void ParticleManager::Simulate(float fixedDeltaTime) {
+    lastStep_ = fixedDeltaTime;
+
+    const AccelerationField* field = enableAccelerationField_ ? &accelerationField_ : nullptr;
+    for (auto& kv : groups_) {
+        SimulateParticles(kv.second.particles, fixedDeltaTime, field);
+    }
+}
+
+void ParticleManager::UpdateInstances(float alpha) {
     const Matrix4x4& view = Renderer::GetInstance()->GetViewMatrix();
     const Matrix4x4& proj = Renderer::GetInstance()->GetProjectionMatrix();
+    const Matrix4x4 viewProj = Multiply(view, proj);
+    // カメラ基底はフレームで共通なので1回だけ求める
+    const BillboardBasis basis = MakeBillboardBasis(view);
+
+    alpha = std::clamp(alpha, 0.0f, 1.0f);
+    // 補間位置に合わせて age も巻き戻す（フェードが刻み単位で段付かないように）
+    const float ageRewind = (1.0f - alpha) * lastStep_;
+
+    // 書き込み先は今 CPU が記録しているフレームのスロット
+    const uint32_t slot = dx_ ? dx_->GetFrameIndex() : 0;
 
     for (auto& kv : groups_) {
         ParticleGroup& g = kv.second;
@@ -177,48 +190,41 @@ void ParticleManager::Update(float deltaTime) {
             continue;
         }
 
-        uint32_t capacity = g.instanceLimit;
+        assert(slot < g.frameCount);
+        ParticleForGPU* dst = g.instanceMapped + static_cast<size_t>(slot) * g.maxInstances;
+        const uint32_t capacity = g.instanceLimit;
+        const bool animated = g.flipbook.frameCount > 1;
+        const Vector4 staticUV = MakeFlipbookUVRect(g.flipbook, g.flipbook.startFrame);
         uint32_t gpuIndex = 0;
 
-        for (auto it = g.particles.begin(); it != g.particles.end();) {
-            Particle& p = *it;
-            p.age += deltaTime;
-            if (p.age >= p.lifetime) {
-                it = g.particles.erase(it);
-                continue;
-            }
-
-            if (enableAccelerationField_) {
-                if (IsCollision_(accelerationField_.area, p.transform.translate)) {
-                    p.velocity.x += accelerationField_.acceleration.x * deltaTime;
-                    p.velocity.y += accelerationField_.acceleration.y * deltaTime;
-                    p.velocity.z += accelerationField_.acceleration.z * deltaTime;
-                }
+        for (const Particle& p : g.particles) {
+            if (gpuIndex >= capacity) {
+                break;
             }
 
-            p.transform.translate.x += p.velocity.x * deltaTime;
-            p.transform.translate.y += p.velocity.y * deltaTime;
-            p.transform.translate.z += p.velocity.z * deltaTime;
+            const ParticleSample s = InterpolateParticle(p, alpha, ageRewind);
+            const float t = s.age / p.lifetime;
+            const float fade = std::clamp(1.0f - t, 0.0f, 1.0f);
 
-            float t = p.age / p.lifetime;
-            float alpha = std::clamp(1.0f - t, 0.0f, 1.0f);
+            const Vector4 uvRect = animated
+                ? MakeFlipbookUVRect(g.flipbook, ComputeFlipbookFrame(g.flipbook, s.age, p.lifetime))
+                : staticUV;
 
-            if (gpuIndex < capacity) {
-                Matrix4x4 world = MakeBillboardMatrix_(p.transform.scale, p.transform.translate, view);
-                Matrix4x4 wvp = Multiply(world, Multiply(view, proj));
-                g.instanceMapped[gpuIndex].World = world;
-                g.instanceMapped[gpuIndex].WVP = wvp;
-                g.instanceMapped[gpuIndex].color = { p.color.x, p.color.y, p.color.z, alpha };
-                ++gpuIndex;
-            }
-
-            ++it;
+            dst[gpuIndex] = PackParticleInstance(basis, viewProj, p.transform.scale,
+                s.rotation, s.translate, { p.color.x, p.color.y, p.color.z, fade }, uvRect);
+            ++gpuIndex;
         }
 
         g.activeInstanceCount = gpuIndex;
+        g.writtenSlot = slot;
     }
 }
 
+void ParticleManager::Update(float deltaTime) {
+    Simulate(deltaTime);
+    UpdateInstances(1.0f);
+}
+
 void ParticleManager::Draw(BlendMode blendMode) {
     Renderer::GetInstance()->DrawParticles(this, blendMode);
 }
@@ -235,18 +241,32 @@ void ParticleManager::DrawInternal(ID3D12GraphicsCommandList* cmdList) {
     ID3D12DescriptorHeap* heaps[] = { dx_->GetSRVHeap() };
     cmdList->SetDescriptorHeaps(1, heaps);
 
-    const UINT indexCount = 6;
+    // 同じテクスチャ（アトラスのページ）のグループを続けて描き、t0 の設定を省く
+    // （グループ間の描画順は元々決まっていない）
+    drawOrder_.clear();
     for (auto& kv : groups_) {
-        ParticleGroup& g = kv.second;
-        if (g.activeInstanceCount == 0) {
-            continue;
+        if (kv.second.activeInstanceCount > 0) {
+            drawOrder_.push_back(&kv.second);
         }
+    }
+    std::sort(drawOrder_.begin(), drawOrder_.end(), [](const ParticleGroup* a, const ParticleGroup* b) {
+        return a->texture.get() < b->texture.get();
+    });
+
+    const UINT indexCount = 6;
+    D3D12_GPU_DESCRIPTOR_HANDLE boundTexture{};
+    for (ParticleGroup* group : drawOrder_) {
+        ParticleGroup& g = *group;
 
         // RootParameter の並びは UnifiedPipeline::MakeParticleDesc に対応
         // 0: CBV(b0) / 1: Texture(t0) / 2: Instancing(t1)
         cmdList->SetGraphicsRootConstantBufferView(0, g.materialCB->GetGPUVirtualAddress());
-        cmdList->SetGraphicsRootDescriptorTable(1, g.textureSrvGpu);
-        cmdList->SetGraphicsRootDescriptorTable(2, g.instanceSrvGpu);
+        const D3D12_GPU_DESCRIPTOR_HANDLE texture = g.texture->GetSrvGpu();
+        if (texture.ptr != boundTexture.ptr) {
+            cmdList->SetGraphicsRootDescriptorTable(1, texture);
+            boundTexture = texture;
+        }
+        cmdList->SetGraphicsRootDescriptorTable(2, g.instanceSrvGpu[g.writtenSlot]);
 
         cmdList->DrawIndexedInstanced(indexCount, g.activeInstanceCount, 0, 0, 0);
     }
@@ -270,26 +290,7 @@ void ParticleManager::EnsureQuadGeometry_() {
     // VB
     {
         const UINT vbSize = static_cast<UINT>(sizeof(quad));
-        D3D12_HEAP_PROPERTIES heap{ D3D12_HEAP_TYPE_UPLOAD };
-        D3D12_RESOURCE_DESC desc{};
-        desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        desc.Width = vbSize;
-        desc.Height = 1;
-        desc.DepthOrArraySize = 1;
-        desc.MipLevels = 1;
-        desc.SampleDesc.Count = 1;
-        desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-        HRESULT hr = device_->CreateCommittedResource(
-            &heap, D3D12_HEAP_FLAG_NONE, &desc,
-            D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-            IID_PPV_ARGS(&vb_));
-        assert(SUCCEEDED(hr));
-
-        void* mapped = nullptr;
-        vb_->Map(0, nullptr, &mapped);
-        std::memcpy(mapped, quad, vbSize);
-        vb_->Unmap(0, nullptr);
+        vb_ = dx_->GetUploadQueue().CreateStaticBuffer(quad, vbSize);
 
         vbView_.BufferLocation = vb_->GetGPUVirtualAddress();
         vbView_.StrideInBytes = sizeof(Vtx);
@@ -299,26 +300,7 @@ void ParticleManager::EnsureQuadGeometry_() {
     // IB
     {
         const UINT ibSize = static_cast<UINT>(sizeof(idx));
-        D3D12_HEAP_PROPERTIES heap{ D3D12_HEAP_TYPE_UPLOAD };
-        D3D12_RESOURCE_DESC desc{};
-        desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        desc.Width = ibSize;
-        desc.Height = 1;
-        desc.DepthOrArraySize = 1;
-        desc.MipLevels = 1;
-        desc.SampleDesc.Count = 1;
-        desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-        HRESULT hr = device_->CreateCommittedResource(
-            &heap, D3D12_HEAP_FLAG_NONE, &desc,
-            D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-            IID_PPV_ARGS(&ib_));
-        assert(SUCCEEDED(hr));
-
-        void* mapped = nullptr;
-        ib_->Map(0, nullptr, &mapped);
-        std::memcpy(mapped, idx, ibSize);
-        ib_->Unmap(0, nullptr);
+        ib_ = dx_->GetUploadQueue().CreateStaticBuffer(idx, ibSize);
 
         ibView_.BufferLocation = ib_->GetGPUVirtualAddress();
         ibView_.Format = DXGI_FORMAT_R16_UINT;
@@ -327,40 +309,3 @@ void ParticleManager::EnsureQuadGeometry_() {
 
     quadReady_ = true;
 }
-
-Matrix4x4 ParticleManager::MakeBillboardMatrix_(const Vector3& scale, const Vector3& translate, const Matrix4x4& viewMatrix) const {
-    Matrix4x4 camWorld = Inverse(viewMatrix);
-    Vector3 right{ camWorld.m[0][0], camWorld.m[0][1], camWorld.m[0][2] };
-    Vector3 up{ camWorld.m[1][0], camWorld.m[1][1], camWorld.m[1][2] };
-    Vector3 forward{ camWorld.m[2][0], camWorld.m[2][1], camWorld.m[2][2] };
-    forward = { -forward.x, -forward.y, -forward.z };
-
-    Matrix4x4 m{};
-    m.m[0][0] = scale.x * right.x;
-    m.m[0][1] = scale.x * right.y;
-    m.m[0][2] = scale.x * right.z;
-    m.m[0][3] = 0;
-
-    m.m[1][0] = scale.y * up.x;
-    m.m[1][1] = scale.y * up.y;
-    m.m[1][2] = scale.y * up.z;
-    m.m[1][3] = 0;
-
-    m.m[2][0] = scale.z * forward.x;
-    m.m[2][1] = scale.z * forward.y;
-    m.m[2][2] = scale.z * forward.z;
-    m.m[2][3] = 0;
-
-    m.m[3][0] = translate.x;
-    m.m[3][1] = translate.y;
-    m.m[3][2] = translate.z;
-    m.m[3][3] = 1;
-    return m;
-}
-
-bool ParticleManager::IsCollision_(const AABB& aabb, const Vector3& point) const {
-    if (point.x < aabb.min.x || point.x > aabb.max.x) return false;
-    if (point.y < aabb.min.y || point.y > aabb.max.y) return false;
-    if (point.z < aabb.min.z || point.z > aabb.max.z) return false;
-    return true;
-}
@@ -1,9 +1,10 @@
 #pragma once
 
-#include "AABB.h"
 #include "Matrix.h"
+#include "FramePacer.h"
+#include "ParticleInstancePacking.h"
+#include "ParticleSimulation.h"
 #include "SrvHandle.h"
-#include "Transform.h"
 #include "Vector.h"
 
 #include <d3d12.h>
@@ -14,33 +15,12 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class DirectXCommon;
 class TextureResource;
 #include "UnifiedPipeline.h"
 
-// 加速度フィールド（範囲内の粒子に加速度を与える）
-struct AccelerationField {
-    Vector3 acceleration;
-    AABB area;
-};
-
-// パーティクル（CPU側）
-struct Particle {
-    Transform transform;
-    Vector3 velocity;
-    float lifetime = 1.0f;
-    float age = 0.0f;
-    Vector4 color{ 1,1,1,1 };
-};
-
-// GPUへ送るインスタンシングデータ
-struct ParticleForGPU {
-    Matrix4x4 WVP;
-    Matrix4x4 World;
-    Vector4 color;
-};
-
 // PS側 Material(b0)
 struct ParticleMaterialData {
     Vector4 color;
@@ -64,15 +44,23 @@ public:
 
     // テクスチャ単位のグループを作成
     // - name: グループ名（ユーザーが付けるキー）
-    // - texturePath: TextureManagerで読むファイルパス
+    // - texturePath: TextureManagerで読むファイルパス（登録済みのアトラスに載っていればそのページ）
     // - maxInstances: StructuredBuffer の最大要素数
     bool CreateParticleGroup(const std::string& name, const std::string& texturePath, uint32_t maxInstances);
 
     // パーティクルをグループに発生させる（Emitterから呼ぶ想定）
     void Emit(const std::string& name, const Vector3& position, const Vector3& velocity,
-        const Vector3& scale, float lifetime, const Vector4& color);
+        const Vector3& scale, float lifetime, const Vector4& color,
+        float rotation = 0.0f, float angularVelocity = 0.0f);
+
+    // Simulate: 固定ステップ1回分の粒子更新（SimulateParticles をグループごとに呼ぶ）
+    // - 可変 dt を直接渡さず、FixedStepClock の刻みで呼ぶこと
+    void Simulate(float fixedDeltaTime);
 
-    // Update: 粒子更新 + インスタンスデータ書き込み
+    // UpdateInstances: 前ステップと現ステップを alpha(0..1) で補間してインスタンスデータ書き込み
+    void UpdateInstances(float alpha);
+
+    // Update: Simulate(deltaTime) + UpdateInstances(1.0f)（補間なしの互換API）
     void Update(float deltaTime);
 
     // Draw: グループごとに DrawIndexedInstanced
@@ -88,6 +76,9 @@ public:
     // グループの最大インスタンス（UIで減らす等に使う）
     void SetGroupInstanceLimit(const std::string& name, uint32_t limit);
 
+    // グループのフリップブック設定（columns x rows のスプライトシート）
+    void SetGroupFlipbook(const std::string& name, const ParticleFlipbook& flipbook);
+
 	// グループ内の全粒子をクリア
     void ClearParticleGroup(const std::string& name);
 
@@ -96,9 +87,6 @@ private:
     ParticleManager(const ParticleManager&) = delete;
     ParticleManager& operator=(const ParticleManager&) = delete;
 
-    Matrix4x4 MakeBillboardMatrix_(const Vector3& scale, const Vector3& translate, const Matrix4x4& viewMatrix) const;
-    bool IsCollision_(const AABB& aabb, const Vector3& point) const;
-
     void EnsureQuadGeometry_();
 
 private:
@@ -112,7 +100,9 @@ private:
                 materialCB->Unmap(0, nullptr);
                 materialMapped = nullptr;
             }
-            instanceSrv.Reset();
+            for (SrvHandle& srv : instanceSrv) {
+                srv.Reset();
+            }
         }
 
         ParticleGroup() = default;
@@ -121,23 +111,28 @@ private:
 
         ParticleGroup(ParticleGroup&& other) noexcept
             : texture(std::move(other.texture)),
-              textureSrvGpu(other.textureSrvGpu),
+              flipbook(other.flipbook),
               particles(std::move(other.particles)),
               maxInstances(other.maxInstances),
               instanceLimit(other.instanceLimit),
               activeInstanceCount(other.activeInstanceCount),
+              frameCount(other.frameCount),
+              writtenSlot(other.writtenSlot),
               instanceBuffer(std::move(other.instanceBuffer)),
               instanceMapped(other.instanceMapped),
-              instanceSrv(std::move(other.instanceSrv)),
-              instanceSrvGpu(other.instanceSrvGpu),
               materialCB(std::move(other.materialCB)),
               materialMapped(other.materialMapped) {
-            other.textureSrvGpu = {};
+            for (uint32_t i = 0; i < FramePacer::kMaxFramesInFlight; ++i) {
+                instanceSrv[i] = std::move(other.instanceSrv[i]);
+                instanceSrvGpu[i] = other.instanceSrvGpu[i];
+                other.instanceSrvGpu[i] = {};
+            }
             other.maxInstances = 0;
             other.instanceLimit = 0;
             other.activeInstanceCount = 0;
+            other.frameCount = 0;
+            other.writtenSlot = 0;
             other.instanceMapped = nullptr;
-            other.instanceSrvGpu = {};
             other.materialMapped = nullptr;
         }
 
@@ -149,8 +144,11 @@ private:
             return *this;
         }
 
+        // SRV はストリーミングで作り直されることがあるので、描画のたびに取り直す
+        // （粒は小さく映るので使用量は伝えず、小さいミップのまま使う）
         std::shared_ptr<TextureResource> texture;
-        D3D12_GPU_DESCRIPTOR_HANDLE textureSrvGpu{};
+
+        ParticleFlipbook flipbook{};
 
         std::list<Particle> particles;
 
@@ -158,11 +156,17 @@ private:
         uint32_t instanceLimit = 0;
         uint32_t activeInstanceCount = 0;
 
-        // StructuredBuffer (t1)
+        // 先行フレームが読んでいる領域を上書きしないよう、
+        // フレームスロットごとに maxInstances 個ずつの領域を持つ
+        uint32_t frameCount = 0;
+        // 直近の UpdateInstances が書いたスロット（Draw はここを読む）
+        uint32_t writtenSlot = 0;
+
+        // StructuredBuffer (t1)。instanceMapped はスロット 0 の先頭
         ComPtr<ID3D12Resource> instanceBuffer;
         ParticleForGPU* instanceMapped = nullptr;
-        SrvHandle instanceSrv;
-        D3D12_GPU_DESCRIPTOR_HANDLE instanceSrvGpu{};
+        SrvHandle instanceSrv[FramePacer::kMaxFramesInFlight];
+        D3D12_GPU_DESCRIPTOR_HANDLE instanceSrvGpu[FramePacer::kMaxFramesInFlight]{};
 
         // Material (b0)
         ComPtr<ID3D12Resource> materialCB;
@@ -173,6 +177,8 @@ private:
     ComPtr<ID3D12Device> device_;
 
     std::unordered_map<std::string, ParticleGroup> groups_;
+    // DrawInternal で描くグループ（テクスチャ順。毎回作り直す）
+    std::vector<ParticleGroup*> drawOrder_;
 
     // 共通の板ポリ
     D3D12_VERTEX_BUFFER_VIEW vbView_{};
@@ -183,4 +189,7 @@ private:
 
     AccelerationField accelerationField_{};
     bool enableAccelerationField_ = false;
+
+    // 直近の Simulate の刻み（補間時の age 巻き戻しに使う）
+    float lastStep_ = 0.0f;
 };
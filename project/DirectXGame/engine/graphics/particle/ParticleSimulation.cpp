@@ -0,0 +1,75 @@
+#define NOMINMAX
+
+#include "ParticleSimulation.h"
+
+#include <algorithm>
+
+namespace {
+
+bool Contains(const AABB& aabb, const Vector3& point) {
+    if (point.x < aabb.min.x || point.x > aabb.max.x) return false;
+    if (point.y < aabb.min.y || point.y > aabb.max.y) return false;
+    if (point.z < aabb.min.z || point.z > aabb.max.z) return false;
+    return true;
+}
+
+} // namespace
+
+Particle MakeParticle(const Vector3& position, const Vector3& velocity,
+    const Vector3& scale, float lifetime, const Vector4& color,
+    float rotation, float angularVelocity) {
+    Particle p{};
+    p.transform.translate = position;
+    p.transform.scale = scale;
+    p.transform.rotate = { 0,0,0 };
+    p.velocity = velocity;
+    p.lifetime = lifetime;
+    p.age = 0.0f;
+    p.color = color;
+    p.rotation = rotation;
+    p.angularVelocity = angularVelocity;
+    p.prevTranslate = position;
+    p.prevRotation = rotation;
+    return p;
+}
+
+void SimulateParticles(std::list<Particle>& particles, float fixedDeltaTime,
+    const AccelerationField* field) {
+    for (auto it = particles.begin(); it != particles.end();) {
+        Particle& p = *it;
+        p.prevTranslate = p.transform.translate;
+        p.prevRotation = p.rotation;
+
+        p.age += fixedDeltaTime;
+        if (p.age >= p.lifetime) {
+            it = particles.erase(it);
+            continue;
+        }
+
+        // semi-implicit Euler: v(t+dt) = v(t) + a*dt, x(t+dt) = x(t) + v(t+dt)*dt
+        if (field && Contains(field->area, p.transform.translate)) {
+            p.velocity.x += field->acceleration.x * fixedDeltaTime;
+            p.velocity.y += field->acceleration.y * fixedDeltaTime;
+            p.velocity.z += field->acceleration.z * fixedDeltaTime;
+        }
+
+        p.transform.translate.x += p.velocity.x * fixedDeltaTime;
+        p.transform.translate.y += p.velocity.y * fixedDeltaTime;
+        p.transform.translate.z += p.velocity.z * fixedDeltaTime;
+        p.rotation += p.angularVelocity * fixedDeltaTime;
+
+        ++it;
+    }
+}
+
+ParticleSample InterpolateParticle(const Particle& p, float alpha, float ageRewind) {
+    ParticleSample s{};
+    s.translate = {
+        p.prevTranslate.x + (p.transform.translate.x - p.prevTranslate.x) * alpha,
+        p.prevTranslate.y + (p.transform.translate.y - p.prevTranslate.y) * alpha,
+        p.prevTranslate.z + (p.transform.translate.z - p.prevTranslate.z) * alpha,
+    };
+    s.rotation = p.prevRotation + (p.rotation - p.prevRotation) * alpha;
+    s.age = std::max(p.age - ageRewind, 0.0f);
+    return s;
+}
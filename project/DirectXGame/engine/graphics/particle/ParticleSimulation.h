@@ -0,0 +1,52 @@
+#pragma once
+
+#include "AABB.h"
+#include "Transform.h"
+#include "Vector.h"
+
+#include <list>
+
+// 加速度フィールド（範囲内の粒子に加速度を与える）
+struct AccelerationField {
+    Vector3 acceleration;
+    AABB area;
+};
+
+// パーティクル（CPU側）
+struct Particle {
+    Transform transform;
+    Vector3 velocity;
+    float lifetime = 1.0f;
+    float age = 0.0f;
+    Vector4 color{ 1,1,1,1 };
+
+    // 画面内回転（ラジアン）と角速度（ラジアン/秒）
+    float rotation = 0.0f;
+    float angularVelocity = 0.0f;
+
+    // 直前の固定ステップ時点の位置・回転（描画補間用）
+    Vector3 prevTranslate{ 0,0,0 };
+    float prevRotation = 0.0f;
+};
+
+// 描画用に補間した粒子の状態
+struct ParticleSample {
+    Vector3 translate;
+    float rotation;
+    float age;
+};
+
+// 発生直後の粒子（前ステップの位置・回転は発生位置にそろえる）
+Particle MakeParticle(const Vector3& position, const Vector3& velocity,
+    const Vector3& scale, float lifetime, const Vector4& color,
+    float rotation, float angularVelocity);
+
+// 固定ステップ1回分の粒子更新（semi-implicit Euler）。寿命が尽きた粒子は取り除く
+// - 速度を先に更新し、更新後の速度で位置を進める
+// - field が nullptr なら加速度なし
+void SimulateParticles(std::list<Particle>& particles, float fixedDeltaTime,
+    const AccelerationField* field);
+
+// 前ステップと現ステップを alpha(0..1) で補間する
+// - ageRewind: 補間位置に合わせて巻き戻す age（(1 - alpha) * 直前の刻み）
+ParticleSample InterpolateParticle(const Particle& particle, float alpha, float ageRewind);
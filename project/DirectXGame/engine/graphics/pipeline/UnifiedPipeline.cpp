@@ -120,7 +120,7 @@ bool UnifiedPipeline::Initialize(ID3D12Device *device, IDxcUtils *dxcUtils,
       D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
 
   // --- Root Parameters（フラグに応じて詰める） ---
-  D3D12_ROOT_PARAMETER params[8]{};
+  D3D12_ROOT_PARAMETER params[10]{};
   UINT numParams = 0;
 
   if (desc.usePSMaterial_b0) {
@@ -149,6 +149,14 @@ bool UnifiedPipeline::Initialize(ID3D12Device *device, IDxcUtils *dxcUtils,
     p.DescriptorTable.pDescriptorRanges = &srvRangeInst;
     p.DescriptorTable.NumDescriptorRanges = 1;
   }
+  if (desc.useVSInstanceBase_b1) {
+    // SV_InstanceID は StartInstanceLocation を含まないため定数で渡す
+    auto &p = params[numParams++];
+    p.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    p.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    p.Constants.ShaderRegister = 1; // b1
+    p.Constants.Num32BitValues = 1;
+  }
   if (desc.usePSDirectionalLight_b1) {
     auto &p = params[numParams++];
     p.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
@@ -173,6 +181,13 @@ bool UnifiedPipeline::Initialize(ID3D12Device *device, IDxcUtils *dxcUtils,
     p.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
     p.Descriptor.ShaderRegister = 4; // b4
   }
+  if (desc.useVSSkinPalette_t1) {
+    // 毎フレーム書き換える行列なのでディスクリプタを作らずアドレスで渡す
+    auto &p = params[numParams++];
+    p.ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    p.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+    p.Descriptor.ShaderRegister = 1; // t1
+  }
 
   D3D12_STATIC_SAMPLER_DESC samp{};
   samp.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
@@ -224,7 +239,8 @@ bool UnifiedPipeline::Initialize(ID3D12Device *device, IDxcUtils *dxcUtils,
 
   {
     IDxcBlob *vsRaw = CompileShader(desc.vsPath, desc.vsProfile, dxcUtils,
-                                    dxcCompiler, includeHandler);
+                                    dxcCompiler, includeHandler,
+                                    desc.shaderDefines);
     if (!vsRaw) {
       LogUnifiedPipelineError_(
           std::format(L"VS compile failed: {}", desc.vsPath));
@@ -235,7 +251,8 @@ bool UnifiedPipeline::Initialize(ID3D12Device *device, IDxcUtils *dxcUtils,
 
   {
     IDxcBlob *psRaw = CompileShader(desc.psPath, desc.psProfile, dxcUtils,
-                                    dxcCompiler, includeHandler);
+                                    dxcCompiler, includeHandler,
+                                    desc.shaderDefines);
     if (!psRaw) {
       LogUnifiedPipelineError_(
           std::format(L"PS compile failed: {}", desc.psPath));
@@ -286,19 +303,35 @@ bool UnifiedPipeline::Initialize(ID3D12Device *device, IDxcUtils *dxcUtils,
 }
 
 // ===== プリセット =====
-PipelineDesc UnifiedPipeline::MakeObject3DDesc() {
+PipelineDesc UnifiedPipeline::MakeObject3DDesc(bool packedVertex) {
   PipelineDesc d{};
-  d.inputElements = {
-      D3D12_INPUT_ELEMENT_DESC{"POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0,
-                               D3D12_APPEND_ALIGNED_ELEMENT,
-                               D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-      D3D12_INPUT_ELEMENT_DESC{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0,
-                               D3D12_APPEND_ALIGNED_ELEMENT,
-                               D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-      D3D12_INPUT_ELEMENT_DESC{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,
-                               D3D12_APPEND_ALIGNED_ELEMENT,
-                               D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-  };
+  if (packedVertex) {
+    // 16 バイト: 位置 UNORM16x4 / UV half x2 / 法線 八面体 SNORM16x2
+    d.inputElements = {
+        D3D12_INPUT_ELEMENT_DESC{"POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM,
+                                 0, D3D12_APPEND_ALIGNED_ELEMENT,
+                                 D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+        D3D12_INPUT_ELEMENT_DESC{"TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0,
+                                 D3D12_APPEND_ALIGNED_ELEMENT,
+                                 D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+        D3D12_INPUT_ELEMENT_DESC{"NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0,
+                                 D3D12_APPEND_ALIGNED_ELEMENT,
+                                 D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+    };
+    d.shaderDefines.push_back(L"PACKED_VERTEX=1");
+  } else {
+    d.inputElements = {
+        D3D12_INPUT_ELEMENT_DESC{"POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT,
+                                 0, D3D12_APPEND_ALIGNED_ELEMENT,
+                                 D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+        D3D12_INPUT_ELEMENT_DESC{"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0,
+                                 D3D12_APPEND_ALIGNED_ELEMENT,
+                                 D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+        D3D12_INPUT_ELEMENT_DESC{"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0,
+                                 D3D12_APPEND_ALIGNED_ELEMENT,
+                                 D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+    };
+  }
   d.vsPath = L"resources/shaders/Object3D.VS.hlsl";
   d.psPath = L"resources/shaders/Object3D.PS.hlsl";
   d.usePSMaterial_b0 = true;
@@ -317,6 +350,37 @@ PipelineDesc UnifiedPipeline::MakeObject3DDesc() {
   return d;
 }
 
+// 同一メッシュのインスタンシング描画用
+// RootParameter: [0]=PS t0, [1]=VS t1, [2]=VS b1(定数), [3]=PS b1, [4]=PS b2,
+//                [5]=PS b3, [6]=PS b4
+PipelineDesc UnifiedPipeline::MakeObject3DInstancedDesc(bool packedVertex) {
+  PipelineDesc d = MakeObject3DDesc(packedVertex);
+  d.vsPath = L"resources/shaders/Object3dInstanced.VS.hlsl";
+  d.psPath = L"resources/shaders/Object3dInstanced.PS.hlsl";
+  d.usePSMaterial_b0 = false;   // マテリアルはインスタンスデータから
+  d.useVSTransform_b0 = false;  // 行列もインスタンスデータから
+  d.useVSInstancingTable_t1 = true;
+  d.useVSInstanceBase_b1 = true;
+  return d;
+}
+
+// スキンメッシュ用（頂点は常に非圧縮。スロット 1 にジョイント番号と重み）
+// RootParameter: MakeObject3DDesc と同じ [0]～[6] + [7]=VS t1（スキニング行列）
+PipelineDesc UnifiedPipeline::MakeObject3DSkinnedDesc() {
+  PipelineDesc d = MakeObject3DDesc();
+  d.inputElements.push_back(D3D12_INPUT_ELEMENT_DESC{
+      "BLENDINDICES", 0, DXGI_FORMAT_R16G16B16A16_UINT, 1,
+      D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
+      0});
+  d.inputElements.push_back(D3D12_INPUT_ELEMENT_DESC{
+      "BLENDWEIGHT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1,
+      D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
+      0});
+  d.shaderDefines.push_back(L"SKINNED=1");
+  d.useVSSkinPalette_t1 = true;
+  return d;
+}
+
 PipelineDesc UnifiedPipeline::MakeSpriteDesc() {
   PipelineDesc d{};
   d.inputElements = {
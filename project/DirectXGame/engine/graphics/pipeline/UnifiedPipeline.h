@@ -20,6 +20,8 @@ struct PipelineDesc {
   std::wstring psPath;
   const wchar_t *vsProfile = L"vs_6_0";
   const wchar_t *psProfile = L"ps_6_0";
+  // VS/PS 共通のプリプロセッサ定義（"NAME" / "NAME=VALUE"）
+  std::vector<std::wstring> shaderDefines;
 
   // ルートパラメータの有無
   bool usePSMaterial_b0 = true;          // PS: b0
@@ -28,6 +30,8 @@ struct PipelineDesc {
   bool usePSDirectionalLight_b1 = false; // PS: b1（Spriteは通常不要）
   bool useVSInstancingTable_t1 =
       false; // VS: t1 (SRVテーブル、インスタンシング用)
+  bool useVSInstanceBase_b1 =
+      false; // VS: b1 (ルート定数1個、インスタンス配列の先頭位置)
   bool depthWrite = true; 
 
   // カメラCB b2
@@ -36,6 +40,8 @@ struct PipelineDesc {
   bool usePSPointLight_b3 = false;
   // スポットライトCB b4
   bool usePSSpotLight_b4 = false;
+  // スキニング行列 t1（ルート SRV。他の有無に関係なく最後のパラメータになる）
+  bool useVSSkinPalette_t1 = false;
 
   // ラスタ/ブレンド/深度
   bool enableDepth = true;
@@ -80,7 +86,10 @@ public:
   }
 
   // お手軽プリセット
-  static PipelineDesc MakeObject3DDesc();
+  // packedVertex: 圧縮頂点（VertexPacking.h の PackedVertex）を入力にする
+  static PipelineDesc MakeObject3DDesc(bool packedVertex = false);
+  static PipelineDesc MakeObject3DInstancedDesc(bool packedVertex = false);
+  static PipelineDesc MakeObject3DSkinnedDesc();
   static PipelineDesc MakeSpriteDesc();
   static PipelineDesc MakeEmitterWireDesc();
   static PipelineDesc MakeEmitterAlphaDesc();
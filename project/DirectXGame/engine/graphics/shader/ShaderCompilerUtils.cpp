@@ -21,7 +21,8 @@ static void LogHr_(const wchar_t *what, HRESULT hr) {
 
 IDxcBlob *CompileShader(const std::wstring &filePath, const wchar_t *profile,
                         IDxcUtils *dxcUtils, IDxcCompiler3 *dxcCompiler,
-                        IDxcIncludeHandler *includeHandler) {
+                        IDxcIncludeHandler *includeHandler,
+                        const std::vector<std::wstring> &defines) {
   using Microsoft::WRL::ComPtr;
 
   if (!dxcUtils || !dxcCompiler || !includeHandler) {
@@ -45,13 +46,18 @@ IDxcBlob *CompileShader(const std::wstring &filePath, const wchar_t *profile,
   shaderSourceBuffer.Size = shaderSource->GetBufferSize();
   shaderSourceBuffer.Encoding = DXC_CP_UTF8;
 
-  LPCWSTR arguments[] = {
+  std::vector<LPCWSTR> arguments = {
       filePath.c_str(), L"-E",  L"main", L"-T", profile, L"-Zi",
       L"-Qembed_debug", L"-Od", L"-Zpr",
   };
+  for (const std::wstring &define : defines) {
+    arguments.push_back(L"-D");
+    arguments.push_back(define.c_str());
+  }
 
   ComPtr<IDxcResult> shaderResult;
-  hr = dxcCompiler->Compile(&shaderSourceBuffer, arguments, _countof(arguments),
+  hr = dxcCompiler->Compile(&shaderSourceBuffer, arguments.data(),
+                            static_cast<UINT32>(arguments.size()),
                             includeHandler,
                             IID_PPV_ARGS(shaderResult.GetAddressOf()));
   if (FAILED(hr) || !shaderResult) {
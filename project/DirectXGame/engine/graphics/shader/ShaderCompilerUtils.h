@@ -4,9 +4,12 @@
 #include <dxcapi.h>
 
 #include <string>
+#include <vector>
 
 // CompileShader は生ポインタを返す（呼び出し側が Release する想定）
 // 呼び出し側が ComPtr で受ける場合は Attach する。
+// defines は "NAME" または "NAME=VALUE"（-D に渡す）
 IDxcBlob *CompileShader(const std::wstring &filePath, const wchar_t *profile,
                         IDxcUtils *dxcUtils, IDxcCompiler3 *dxcCompiler,
-                        IDxcIncludeHandler *includeHandler);
\ No newline at end of file
+                        IDxcIncludeHandler *includeHandler,
+                        const std::vector<std::wstring> &defines = {});
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+struct Rect {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+};
+
+bool Contains(const Rect &outer, const Rect &inner) {
+  return inner.x >= outer.x && inner.y >= outer.y &&
+         inner.x + inner.width <= outer.x + outer.width &&
+         inner.y + inner.height <= outer.y + outer.height;
+}
+
+bool Overlaps(const Rect &a, const Rect &b) {
+  return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height &&
+         b.y < a.y + a.height;
+}
+
+uint32_t AlignUp(uint32_t value, uint32_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// 1 ページぶんの空き領域（重なりを許す極大の空き矩形の集合）
+class MaxRectsBin {
+public:
+  MaxRectsBin(uint32_t width, uint32_t height) {
+    free_.push_back({0, 0, width, height});
+  }
+
+  // 入れられれば位置を返す。ページは使った範囲の大きさで作るので、まず範囲の
+  // 広がり（面積）が小さい位置を選び、同点なら Best Short Side Fit
+  bool Insert(uint32_t width, uint32_t height, uint32_t &outX,
+              uint32_t &outY) {
+    size_t best = free_.size();
+    uint64_t bestArea = std::numeric_limits<uint64_t>::max();
+    uint32_t bestShort = std::numeric_limits<uint32_t>::max();
+    for (size_t i = 0; i < free_.size(); ++i) {
+      const Rect &f = free_[i];
+      if (f.width < width || f.height < height) {
+        continue;
+      }
+      const uint64_t area =
+          uint64_t((std::max)(extentX_, f.x + width)) *
+          (std::max)(extentY_, f.y + height);
+      const uint32_t shortSide = (std::min)(f.width - width, f.height - height);
+      if (area < bestArea || (area == bestArea && shortSide < bestShort)) {
+        best = i;
+        bestArea = area;
+        bestShort = shortSide;
+      }
+    }
+    if (best == free_.size()) {
+      return false;
+    }
+
+    const Rect used{free_[best].x, free_[best].y, width, height};
+    Place_(used);
+    outX = used.x;
+    outY = used.y;
+    extentX_ = (std::max)(extentX_, used.x + used.width);
+    extentY_ = (std::max)(extentY_, used.y + used.height);
+    return true;
+  }
+
+  uint32_t GetExtentX() const { return extentX_; }
+  uint32_t GetExtentY() const { return extentY_; }
+
+private:
+  // used と重なる空き矩形を、used の外側の最大 4 つに割る
+  void Place_(const Rect &used) {
+    const size_t count = free_.size();
+    for (size_t i = 0; i < count; ++i) {
+      const Rect f = free_[i];
+      if (!Overlaps(f, used)) {
+        continue;
+      }
+      if (used.x > f.x) {
+        split_.push_back({f.x, f.y, used.x - f.x, f.height});
+      }
+      if (used.x + used.width < f.x + f.width) {
+        const uint32_t x = used.x + used.width;
+        split_.push_back({x, f.y, f.x + f.width - x, f.height});
+      }
+      if (used.y > f.y) {
+        split_.push_back({f.x, f.y, f.width, used.y - f.y});
+      }
+      if (used.y + used.height < f.y + f.height) {
+        const uint32_t y = used.y + used.height;
+        split_.push_back({f.x, y, f.width, f.y + f.height - y});
+      }
+      free_[i].width = 0; // 削除の印
+    }
+    free_.erase(std::remove_if(free_.begin(), free_.end(),
+                               [](const Rect &r) { return r.width == 0; }),
+                free_.end());
+
+    // 新しい矩形のうち、他に含まれるものは捨てる（古い矩形同士は既に極大）
+    for (size_t i = 0; i < split_.size(); ++i) {
+      bool contained = false;
+      for (const Rect &f : free_) {
+        if (Contains(f, split_[i])) {
+          contained = true;
+          break;
+        }
+      }
+      for (size_t j = 0; j < split_.size() && !contained; ++j) {
+        if (i != j && split_[j].width != 0 && Contains(split_[j], split_[i]) &&
+            (!Contains(split_[i], split_[j]) || j < i)) {
+          contained = true;
+        }
+      }
+      if (contained) {
+        split_[i].width = 0;
+      }
+    }
+    for (const Rect &r : split_) {
+      if (r.width == 0) {
+        continue;
+      }
+      // 新しい矩形に含まれる古い矩形も捨てる
+      free_.erase(std::remove_if(free_.begin(), free_.end(),
+                                 [&r](const Rect &f) { return Contains(r, f); }),
+                  free_.end());
+      free_.push_back(r);
+    }
+    split_.clear();
+  }
+
+  std::vector<Rect> free_;
+  std::vector<Rect> split_;
+  uint32_t extentX_ = 0;
+  uint32_t extentY_ = 0;
+};
+
+} // namespace
+
+namespace AtlasPacker {
+
+void Pack(std::span<const Size> sizes, const Settings &settings,
+          Result &out) {
+  assert(settings.alignment > 0);
+  assert(settings.pageWidth % settings.alignment == 0 &&
+         settings.pageHeight % settings.alignment == 0);
+  out.placements.assign(sizes.size(), Placement{});
+  out.pages.clear();
+  out.contentPixels = 0;
+
+  // 長い辺 → 面積の大きい順に入れる（小さいものが後から隙間を埋める）
+  std::vector<uint32_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    const uint32_t la = (std::max)(sizes[a].width, sizes[a].height);
+    const uint32_t lb = (std::max)(sizes[b].width, sizes[b].height);
+    if (la != lb) {
+      return la > lb;
+    }
+    return uint64_t(sizes[a].width) * sizes[a].height >
+           uint64_t(sizes[b].width) * sizes[b].height;
+  });
+
+  const uint32_t frame = settings.padding * 2;
+  std::vector<MaxRectsBin> bins;
+  for (uint32_t index : order) {
+    const Size &size = sizes[index];
+    if (size.width == 0 || size.height == 0) {
+      continue;
+    }
+    const uint32_t slotW = AlignUp(size.width + frame, settings.alignment);
+    const uint32_t slotH = AlignUp(size.height + frame, settings.alignment);
+    if (slotW > settings.pageWidth || slotH > settings.pageHeight) {
+      continue;
+    }
+
+    Placement &p = out.placements[index];
+    for (uint32_t page = 0; page <= bins.size() && !p.packed; ++page) {
+      if (page == bins.size()) {
+        bins.emplace_back(settings.pageWidth, settings.pageHeight);
+      }
+      uint32_t x = 0;
+      uint32_t y = 0;
+      if (bins[page].Insert(slotW, slotH, x, y)) {
+        p.page = page;
+        p.x = x + settings.padding;
+        p.y = y + settings.padding;
+        p.packed = true;
+      }
+    }
+    out.contentPixels += uint64_t(size.width) * size.height;
+  }
+
+  out.pages.reserve(bins.size());
+  for (const MaxRectsBin &bin : bins) {
+    out.pages.push_back({bin.GetExtentX(), bin.GetExtentY()});
+  }
+}
+
+double ComputeEfficiency(const Result &result) {
+  uint64_t pagePixels = 0;
+  for (const Size &page : result.pages) {
+    pagePixels += uint64_t(page.width) * page.height;
+  }
+  return pagePixels > 0 ? double(result.contentPixels) / double(pagePixels)
+                        : 0.0;
+}
+
+uint32_t GetSafeMipLevels(const Settings &settings) {
+  uint32_t unit = (std::min)(settings.padding, settings.alignment);
+  uint32_t levels = 1;
+  while (unit >= 2) {
+    unit /= 2;
+    ++levels;
+  }
+  return levels;
+}
+
+void BlitWithBorder(uint8_t *dst, size_t dstRowPitch, const uint8_t *src,
+                    size_t srcRowPitch, uint32_t width, uint32_t height,
+                    uint32_t x, uint32_t y, uint32_t border) {
+  assert(x >= border && y >= border);
+  const uint32_t rows = height + border * 2;
+  for (uint32_t row = 0; row < rows; ++row) {
+    // 上下の枠は一番上・下の行を繰り返す
+    const uint32_t srcRow = (std::min)(
+        row > border ? row - border : 0u, height - 1);
+    const uint8_t *s = src + size_t(srcRow) * srcRowPitch;
+    uint8_t *d = dst + size_t(y - border + row) * dstRowPitch +
+                 size_t(x - border) * 4;
+    // 左右の枠は端の画素を繰り返す
+    for (uint32_t i = 0; i < border; ++i) {
+      std::memcpy(d + size_t(i) * 4, s, 4);
+    }
+    std::memcpy(d + size_t(border) * 4, s, size_t(width) * 4);
+    for (uint32_t i = 0; i < border; ++i) {
+      std::memcpy(d + size_t(border + width + i) * 4,
+                  s + size_t(width - 1) * 4, 4);
+    }
+  }
+}
+
+} // namespace AtlasPacker
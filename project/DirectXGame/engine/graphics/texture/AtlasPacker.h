@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 小さい画像をアトラスのページに詰める（GPU / DirectXTex に依存しない）
+// - MaxRects。使った範囲の広がりが小さい位置（同点なら Best Short Side Fit）を選び、
+//   大きい画像から順に、開いているページの先頭から入れる
+// - 各画像は周りに padding の枠を付け、alignment の倍数の枠（スロット）に切り上げて置く。
+//   ページの大きさも alignment の倍数なので、スロットの端は常に alignment の倍数になり、
+//   ミップ k（2^k <= alignment）のテクセルが隣の画像と混ざらない
+// - 枠は画像の端の画素を伸ばして埋める（BlitWithBorder）。線形補間や小さいミップで
+//   端の外を読んでも背景や隣の画像が滲まない
+namespace AtlasPacker {
+
+struct Settings {
+  uint32_t pageWidth = 2048;  // ページの最大の大きさ（alignment の倍数）
+  uint32_t pageHeight = 2048;
+  uint32_t padding = 4;   // 画像の周りに伸ばす枠の幅
+  uint32_t alignment = 4; // スロットの位置と大きさの単位（BC のブロックにも合う 4 以上）
+};
+
+struct Size {
+  uint32_t width = 0;
+  uint32_t height = 0;
+};
+
+// 画像本体（枠を除く）の左上
+struct Placement {
+  uint32_t page = 0;
+  uint32_t x = 0;
+  uint32_t y = 0;
+  bool packed = false; // ページに入らない大きさなら false
+};
+
+struct Result {
+  std::vector<Placement> placements; // sizes と同じ順
+  // ページごとに実際に使った範囲（alignment に切り上げ）。ページはこの大きさで作ればよい
+  std::vector<Size> pages;
+  uint64_t contentPixels = 0; // 詰めた画像本体の面積の合計
+};
+
+void Pack(std::span<const Size> sizes, const Settings &settings,
+          Result &out);
+
+// ページの使用範囲に対する画像本体の面積の割合
+double ComputeEfficiency(const Result &result);
+
+// 枠と位置揃えで隣と混ざらないミップの段数（ミップ 0 を含む）
+uint32_t GetSafeMipLevels(const Settings &settings);
+
+// RGBA8 の画像を dst の (x, y) に写し、周り border 画素を端の画素で埋める
+// 範囲は呼び出し側が Pack の結果として保証する
+void BlitWithBorder(uint8_t *dst, size_t dstRowPitch, const uint8_t *src,
+                    size_t srcRowPitch, uint32_t width, uint32_t height,
+                    uint32_t x, uint32_t y, uint32_t border);
+
+} // namespace AtlasPacker
@@ -0,0 +1,507 @@
+#include "BcEncoder.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+// 1 ジョブで変換するブロックの行数
+constexpr uint32_t kBlockRowsPerJob = 8;
+// 端点を最小二乗で詰め直す回数
+constexpr int kRefineIterations = 2;
+// BC7 の 4 ビット index の重み（端点 1 側、/64）
+constexpr int kBc7Weights[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                                 34, 38, 43, 47, 51, 55, 60, 64};
+
+using Block = float[16][4];
+
+float DistanceSq(const float *a, const float *b, int channels) {
+  float d = 0.0f;
+  for (int c = 0; c < channels; ++c) {
+    d += (a[c] - b[c]) * (a[c] - b[c]);
+  }
+  return d;
+}
+
+// 主成分の軸（べき乗法）。全画素が同じなら false
+bool PrincipalAxis(const Block &px, int channels, float (&mean)[4],
+                   float (&axis)[4]) {
+  for (int c = 0; c < 4; ++c) {
+    mean[c] = 0.0f;
+    axis[c] = 0.0f;
+  }
+  for (int i = 0; i < 16; ++i) {
+    for (int c = 0; c < channels; ++c) {
+      mean[c] += px[i][c] / 16.0f;
+    }
+  }
+  float cov[4][4] = {};
+  for (int i = 0; i < 16; ++i) {
+    for (int a = 0; a < channels; ++a) {
+      for (int b = 0; b < channels; ++b) {
+        cov[a][b] += (px[i][a] - mean[a]) * (px[i][b] - mean[b]);
+      }
+    }
+  }
+
+  // 一番広がっている成分から始める
+  int widest = 0;
+  for (int c = 1; c < channels; ++c) {
+    if (cov[c][c] > cov[widest][widest]) {
+      widest = c;
+    }
+  }
+  if (cov[widest][widest] <= 0.0f) {
+    return false;
+  }
+  float v[4] = {};
+  v[widest] = 1.0f;
+  for (int iteration = 0; iteration < 8; ++iteration) {
+    float w[4] = {};
+    float scale = 0.0f;
+    for (int a = 0; a < channels; ++a) {
+      for (int b = 0; b < channels; ++b) {
+        w[a] += cov[a][b] * v[b];
+      }
+      scale = std::max(scale, std::fabs(w[a]));
+    }
+    if (scale <= 0.0f) {
+      break;
+    }
+    for (int c = 0; c < channels; ++c) {
+      v[c] = w[c] / scale;
+    }
+  }
+  const float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2] +
+                                 v[3] * v[3]);
+  for (int c = 0; c < channels; ++c) {
+    axis[c] = v[c] / length;
+  }
+  return true;
+}
+
+// 軸に沿った両端（全画素が同じなら両方とも平均）
+void AxisEndpoints(const Block &px, int channels, float (&e0)[4],
+                   float (&e1)[4]) {
+  float mean[4];
+  float axis[4];
+  const bool spread = PrincipalAxis(px, channels, mean, axis);
+  float tMin = 0.0f;
+  float tMax = 0.0f;
+  if (spread) {
+    tMin = tMax = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+      float t = 0.0f;
+      for (int c = 0; c < channels; ++c) {
+        t += (px[i][c] - mean[c]) * axis[c];
+      }
+      tMin = std::min(tMin, t);
+      tMax = std::max(tMax, t);
+    }
+  }
+  for (int c = 0; c < 4; ++c) {
+    e0[c] = mean[c] + axis[c] * tMax;
+    e1[c] = mean[c] + axis[c] * tMin;
+  }
+}
+
+// 画素ごとの端点 0 側の重みから、誤差が最小の端点を求め直す
+bool SolveEndpoints(const Block &px, const float (&weight0)[16], int channels,
+                    float (&e0)[4], float (&e1)[4]) {
+  float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+  float ax[4] = {}, bx[4] = {};
+  for (int i = 0; i < 16; ++i) {
+    const float a = weight0[i];
+    const float b = 1.0f - a;
+    aa += a * a;
+    ab += a * b;
+    bb += b * b;
+    for (int c = 0; c < channels; ++c) {
+      ax[c] += a * px[i][c];
+      bx[c] += b * px[i][c];
+    }
+  }
+  const float det = aa * bb - ab * ab;
+  if (std::fabs(det) < 1e-6f) {
+    return false;
+  }
+  for (int c = 0; c < channels; ++c) {
+    e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.0f, 255.0f);
+    e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.0f, 255.0f);
+  }
+  return true;
+}
+
+// ===== BC1 の色（BC3 の色も同じ） =====
+
+uint16_t Quantize565(const float (&c)[4]) {
+  const auto q = [](float v, int max) {
+    return static_cast<int>(
+        std::lround(std::clamp(v, 0.0f, 255.0f) * max / 255.0f));
+  };
+  return static_cast<uint16_t>((q(c[0], 31) << 11) | (q(c[1], 63) << 5) |
+                               q(c[2], 31));
+}
+
+void Expand565(uint16_t v, float (&out)[4]) {
+  const int r = v >> 11;
+  const int g = (v >> 5) & 63;
+  const int b = v & 31;
+  out[0] = static_cast<float>((r << 3) | (r >> 2));
+  out[1] = static_cast<float>((g << 2) | (g >> 4));
+  out[2] = static_cast<float>((b << 3) | (b >> 2));
+  out[3] = 255.0f;
+}
+
+struct ColorFit {
+  uint16_t color0 = 0;
+  uint16_t color1 = 0;
+  uint32_t indices = 0;
+  float error = 0.0f;
+};
+
+// 4 色モード（color0 > color1）で index を選ぶ。同じ色に潰れたら全て index 0
+ColorFit FitColor(const Block &px, const float (&e0)[4], const float (&e1)[4]) {
+  ColorFit fit;
+  fit.color0 = Quantize565(e0);
+  fit.color1 = Quantize565(e1);
+  if (fit.color0 < fit.color1) {
+    std::swap(fit.color0, fit.color1);
+  }
+
+  float palette[4][4];
+  Expand565(fit.color0, palette[0]);
+  Expand565(fit.color1, palette[1]);
+  for (int c = 0; c < 3; ++c) {
+    const int a = static_cast<int>(palette[0][c]);
+    const int b = static_cast<int>(palette[1][c]);
+    palette[2][c] = static_cast<float>((2 * a + b) / 3);
+    palette[3][c] = static_cast<float>((a + 2 * b) / 3);
+  }
+  const int entries = (fit.color0 == fit.color1) ? 1 : 4;
+
+  for (int i = 0; i < 16; ++i) {
+    int best = 0;
+    float bestError = DistanceSq(px[i], palette[0], 3);
+    for (int e = 1; e < entries; ++e) {
+      const float error = DistanceSq(px[i], palette[e], 3);
+      if (error < bestError) {
+        best = e;
+        bestError = error;
+      }
+    }
+    fit.indices |= static_cast<uint32_t>(best) << (i * 2);
+    fit.error += bestError;
+  }
+  return fit;
+}
+
+void EncodeColor(const Block &px, uint8_t *out) {
+  float e0[4], e1[4];
+  AxisEndpoints(px, 3, e0, e1);
+  ColorFit best = FitColor(px, e0, e1);
+
+  static constexpr float kWeight0[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+  for (int iteration = 0; iteration < kRefineIterations && best.error > 0.0f;
+       ++iteration) {
+    float weight0[16];
+    for (int i = 0; i < 16; ++i) {
+      weight0[i] = kWeight0[(best.indices >> (i * 2)) & 3];
+    }
+    if (!SolveEndpoints(px, weight0, 3, e0, e1)) {
+      break;
+    }
+    const ColorFit fit = FitColor(px, e0, e1);
+    if (fit.error >= best.error) {
+      break;
+    }
+    best = fit;
+  }
+
+  std::memcpy(out + 0, &best.color0, 2);
+  std::memcpy(out + 2, &best.color1, 2);
+  std::memcpy(out + 4, &best.indices, 4);
+}
+
+// ===== BC4 の 1 成分（BC3 のアルファ・BC5 も同じ） =====
+
+// a0 > a1 なら 8 段階、そうでなければ 6 段階 + 0 / 255
+void BuildAlphaPalette(int a0, int a1, int (&palette)[8]) {
+  palette[0] = a0;
+  palette[1] = a1;
+  if (a0 > a1) {
+    for (int i = 2; i < 8; ++i) {
+      palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+    }
+  } else {
+    for (int i = 2; i < 6; ++i) {
+      palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+}
+
+int FitAlpha(const uint8_t (&values)[16], int a0, int a1, uint64_t &indices) {
+  int palette[8];
+  BuildAlphaPalette(a0, a1, palette);
+  indices = 0;
+  int error = 0;
+  for (int i = 0; i < 16; ++i) {
+    int best = 0;
+    int bestError = std::abs(values[i] - palette[0]);
+    for (int e = 1; e < 8; ++e) {
+      const int d = std::abs(values[i] - palette[e]);
+      if (d < bestError) {
+        best = e;
+        bestError = d;
+      }
+    }
+    indices |= static_cast<uint64_t>(best) << (i * 3);
+    error += bestError * bestError;
+  }
+  return error;
+}
+
+void EncodeAlpha(const uint8_t (&values)[16], uint8_t *out) {
+  int lo = 255, hi = 0;
+  // 0 / 255 を除いた範囲（6 段階のモードは両端を別に持つ）
+  int innerLo = 255, innerHi = 0;
+  for (uint8_t v : values) {
+    lo = std::min<int>(lo, v);
+    hi = std::max<int>(hi, v);
+    if (v != 0 && v != 255) {
+      innerLo = std::min<int>(innerLo, v);
+      innerHi = std::max<int>(innerHi, v);
+    }
+  }
+  if (innerLo > innerHi) {
+    innerLo = 0;
+    innerHi = 255;
+  }
+
+  uint64_t indices = 0;
+  int a0 = hi, a1 = lo;
+  int error = FitAlpha(values, a0, a1, indices);
+  uint64_t innerIndices = 0;
+  if (error > 0 &&
+      FitAlpha(values, innerLo, innerHi, innerIndices) < error) {
+    a0 = innerLo;
+    a1 = innerHi;
+    indices = innerIndices;
+  }
+
+  out[0] = static_cast<uint8_t>(a0);
+  out[1] = static_cast<uint8_t>(a1);
+  for (int b = 0; b < 6; ++b) {
+    out[2 + b] = static_cast<uint8_t>(indices >> (b * 8));
+  }
+}
+
+void EncodeChannel(const Block &px, int channel, uint8_t *out) {
+  uint8_t values[16];
+  for (int i = 0; i < 16; ++i) {
+    values[i] = static_cast<uint8_t>(px[i][channel]);
+  }
+  EncodeAlpha(values, out);
+}
+
+// ===== BC7 モード 6 =====
+
+struct Bc7Fit {
+  int endpoint[2][4] = {}; // 7 ビット
+  int pbit[2] = {};
+  uint8_t indices[16] = {};
+  float error = 0.0f;
+};
+
+// 7 ビット + p ビット（4 成分で共通）。誤差の小さい p を選ぶ
+void QuantizeBc7(const float (&e)[4], int (&q)[4], int &p) {
+  float bestError = -1.0f;
+  for (int candidate = 0; candidate < 2; ++candidate) {
+    int trial[4];
+    float error = 0.0f;
+    for (int c = 0; c < 4; ++c) {
+      trial[c] = std::clamp(
+          static_cast<int>(std::lround((e[c] - candidate) * 0.5f)), 0, 127);
+      const float d = static_cast<float>(trial[c] * 2 + candidate) - e[c];
+      error += d * d;
+    }
+    if (bestError < 0.0f || error < bestError) {
+      bestError = error;
+      p = candidate;
+      std::memcpy(q, trial, sizeof(trial));
+    }
+  }
+}
+
+Bc7Fit FitBc7(const Block &px, const float (&e0)[4], const float (&e1)[4]) {
+  Bc7Fit fit;
+  QuantizeBc7(e0, fit.endpoint[0], fit.pbit[0]);
+  QuantizeBc7(e1, fit.endpoint[1], fit.pbit[1]);
+
+  float palette[16][4];
+  for (int c = 0; c < 4; ++c) {
+    const int a = fit.endpoint[0][c] * 2 + fit.pbit[0];
+    const int b = fit.endpoint[1][c] * 2 + fit.pbit[1];
+    for (int i = 0; i < 16; ++i) {
+      palette[i][c] = static_cast<float>(
+          ((64 - kBc7Weights[i]) * a + kBc7Weights[i] * b + 32) >> 6);
+    }
+  }
+  for (int i = 0; i < 16; ++i) {
+    int best = 0;
+    float bestError = DistanceSq(px[i], palette[0], 4);
+    for (int e = 1; e < 16; ++e) {
+      const float error = DistanceSq(px[i], palette[e], 4);
+      if (error < bestError) {
+        best = e;
+        bestError = error;
+      }
+    }
+    fit.indices[i] = static_cast<uint8_t>(best);
+    fit.error += bestError;
+  }
+  return fit;
+}
+
+class BitWriter {
+public:
+  explicit BitWriter(uint8_t *out) : out_(out) {}
+  void Write(uint32_t value, uint32_t bits) {
+    for (uint32_t b = 0; b < bits; ++b, ++position_) {
+      if ((value >> b) & 1u) {
+        out_[position_ >> 3] |= static_cast<uint8_t>(1u << (position_ & 7));
+      }
+    }
+  }
+
+private:
+  uint8_t *out_;
+  uint32_t position_ = 0;
+};
+
+void EncodeBc7(const Block &px, uint8_t *out) {
+  float e0[4], e1[4];
+  AxisEndpoints(px, 4, e0, e1);
+  Bc7Fit best = FitBc7(px, e0, e1);
+
+  for (int iteration = 0; iteration < kRefineIterations && best.error > 0.0f;
+       ++iteration) {
+    float weight0[16];
+    for (int i = 0; i < 16; ++i) {
+      weight0[i] = (64 - kBc7Weights[best.indices[i]]) / 64.0f;
+    }
+    if (!SolveEndpoints(px, weight0, 4, e0, e1)) {
+      break;
+    }
+    const Bc7Fit fit = FitBc7(px, e0, e1);
+    if (fit.error >= best.error) {
+      break;
+    }
+    best = fit;
+  }
+
+  // 先頭の画素の index は最上位ビットを 0 として 3 ビットで持つので、
+  // 8 以上なら端点を入れ替えて index を反転する（重みの表は 64 - w で対称）
+  if (best.indices[0] >= 8) {
+    for (int c = 0; c < 4; ++c) {
+      std::swap(best.endpoint[0][c], best.endpoint[1][c]);
+    }
+    std::swap(best.pbit[0], best.pbit[1]);
+    for (uint8_t &index : best.indices) {
+      index = static_cast<uint8_t>(15 - index);
+    }
+  }
+
+  std::memset(out, 0, 16);
+  BitWriter writer(out);
+  writer.Write(1u << 6, 7); // モード 6
+  for (int c = 0; c < 4; ++c) {
+    writer.Write(static_cast<uint32_t>(best.endpoint[0][c]), 7);
+    writer.Write(static_cast<uint32_t>(best.endpoint[1][c]), 7);
+  }
+  writer.Write(static_cast<uint32_t>(best.pbit[0]), 1);
+  writer.Write(static_cast<uint32_t>(best.pbit[1]), 1);
+  writer.Write(best.indices[0], 3);
+  for (int i = 1; i < 16; ++i) {
+    writer.Write(best.indices[i], 4);
+  }
+}
+
+} // namespace
+
+namespace BcEncoder {
+
+size_t GetBlockBytes(Format format) {
+  return (format == Format::BC1 || format == Format::BC4) ? 8 : 16;
+}
+
+size_t GetCompressedSize(Format format, uint32_t width, uint32_t height) {
+  return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) *
+         GetBlockBytes(format);
+}
+
+void EncodeBlock(Format format, const uint8_t *rgba, uint8_t *out) {
+  Block px;
+  for (int i = 0; i < 16; ++i) {
+    for (int c = 0; c < 4; ++c) {
+      px[i][c] = rgba[i * 4 + c];
+    }
+  }
+
+  switch (format) {
+  case Format::BC1:
+    EncodeColor(px, out);
+    break;
+  case Format::BC3:
+    EncodeChannel(px, 3, out);
+    EncodeColor(px, out + 8);
+    break;
+  case Format::BC4:
+    EncodeChannel(px, 0, out);
+    break;
+  case Format::BC5:
+    EncodeChannel(px, 0, out);
+    EncodeChannel(px, 1, out + 8);
+    break;
+  case Format::BC7:
+    EncodeBc7(px, out);
+    break;
+  }
+}
+
+void Encode(Format format, const uint8_t *rgba, uint32_t width,
+            uint32_t height, size_t rowPitch, uint8_t *out) {
+  if (width == 0 || height == 0) {
+    return;
+  }
+  const uint32_t blocksX = (width + 3) / 4;
+  const uint32_t blocksY = (height + 3) / 4;
+  const size_t blockBytes = GetBlockBytes(format);
+  const uint32_t jobCount = (blocksY + kBlockRowsPerJob - 1) / kBlockRowsPerJob;
+
+  JobSystem::GetInstance()->Dispatch(jobCount, [&](uint32_t job) {
+    const uint32_t firstRow = job * kBlockRowsPerJob;
+    const uint32_t lastRow = std::min(blocksY, firstRow + kBlockRowsPerJob);
+    uint8_t block[64];
+    for (uint32_t by = firstRow; by < lastRow; ++by) {
+      for (uint32_t bx = 0; bx < blocksX; ++bx) {
+        for (uint32_t y = 0; y < 4; ++y) {
+          const uint32_t sy = std::min(by * 4 + y, height - 1);
+          for (uint32_t x = 0; x < 4; ++x) {
+            const uint32_t sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(block + (y * 4 + x) * 4,
+                        rgba + sy * rowPitch + sx * 4, 4);
+          }
+        }
+        EncodeBlock(format, block,
+                    out + (static_cast<size_t>(by) * blocksX + bx) *
+                              blockBytes);
+      }
+    }
+  });
+}
+
+} // namespace BcEncoder
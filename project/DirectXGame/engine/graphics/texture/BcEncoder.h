@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// RGBA8 → BCn のブロック圧縮（CPU、D3D / DirectXTex に依存しない）
+// - BC1 / BC3 の色は主成分の両端から始めて最小二乗で 2 回詰め直す
+// - BC4 / BC5 / BC3 のアルファは 8 段階と 6 段階（0 / 255 を含む）の良い方
+// - BC7 はモード 6（1 サブセット・RGBA 7 + p ビット・4 ビット index）だけを使う
+//   （全モードを探す符号化器より品質は落ちるが、数十倍速く、BC1 / BC3 より十分きれい）
+// - sRGB は符号化した値のまま扱う（_SRGB 形式でもビット列は同じ）
+namespace BcEncoder {
+
+enum class Format : uint8_t {
+  BC1, // RGB（アルファ無し）
+  BC3, // RGB + A
+  BC4, // R
+  BC5, // RG（法線マップ）
+  BC7, // RGBA
+};
+
+// 4x4 ブロック 1 つのバイト数（BC1 / BC4 は 8、他は 16）
+size_t GetBlockBytes(Format format);
+// 端の半端なブロックも 1 ブロックと数える
+size_t GetCompressedSize(Format format, uint32_t width, uint32_t height);
+
+// rgba は 4x4 画素（行優先・64 バイト）
+void EncodeBlock(Format format, const uint8_t *rgba, uint8_t *out);
+
+// rowPitch バイトごとに並んだ RGBA8 の画像全体。端の半端なブロックは端の画素を繰り返す
+// ブロックの行をまとめて JobSystem で並列に変換する
+void Encode(Format format, const uint8_t *rgba, uint32_t width,
+            uint32_t height, size_t rowPitch, uint8_t *out);
+
+} // namespace BcEncoder
@@ -0,0 +1,193 @@
+#include "MipResidency.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+MipResidency::Id MipResidency::Register(std::span<const uint64_t> mipBytes,
+                                        uint32_t tailMip) {
+  assert(!mipBytes.empty());
+  Id id;
+  if (!freeIds_.empty()) {
+    id = freeIds_.back();
+    freeIds_.pop_back();
+  } else {
+    id = static_cast<Id>(entries_.size());
+    entries_.emplace_back();
+  }
+  Entry &e = entries_[id];
+  e.mipBytes.assign(mipBytes.begin(), mipBytes.end());
+  e.tailMip = (std::min)(tailMip, static_cast<uint32_t>(mipBytes.size()) - 1);
+  e.residentMip = e.tailMip;
+  e.targetMip = e.tailMip;
+  e.requestedMip = ~0u;
+  e.lastUsedFrame = 0;
+  e.alive = true;
+  ++stats_.textures;
+  stats_.residentBytes += GetResidentBytes(id);
+  return id;
+}
+
+void MipResidency::Unregister(Id id) {
+  Entry &e = entries_[id];
+  assert(e.alive);
+  stats_.residentBytes -= GetResidentBytes(id);
+  --stats_.textures;
+  e = Entry{};
+  freeIds_.push_back(id);
+}
+
+void MipResidency::Request(Id id, uint32_t desiredMip, uint64_t frame) {
+  Entry &e = entries_[id];
+  e.requestedMip = (std::min)(e.requestedMip, desiredMip);
+  e.lastUsedFrame = frame;
+}
+
+uint64_t MipResidency::GetResidentBytes(Id id) const {
+  const Entry &e = entries_[id];
+  uint64_t bytes = 0;
+  for (size_t i = e.residentMip; i < e.mipBytes.size(); ++i) {
+    bytes += e.mipBytes[i];
+  }
+  return bytes;
+}
+
+void MipResidency::SetResident_(Id id, uint32_t mip,
+                                std::vector<Change> &out) {
+  Entry &e = entries_[id];
+  const uint64_t before = GetResidentBytes(id);
+  e.residentMip = mip;
+  const uint64_t after = GetResidentBytes(id);
+  stats_.residentBytes = stats_.residentBytes - before + after;
+  if (after > before) {
+    stats_.loadedBytes += after - before;
+    ++stats_.loads;
+  } else {
+    stats_.evictedBytes += before - after;
+    ++stats_.evictions;
+  }
+  out.push_back({id, mip});
+}
+
+uint64_t MipResidency::Evict_(uint64_t needBytes, Id keep, bool force,
+                              std::vector<Change> &out) {
+  // 粗くできるもの: 必要以上に細かい（force なら tailMip より細かい）もの
+  std::vector<Id> victims;
+  for (Id id = 0; id < entries_.size(); ++id) {
+    const Entry &e = entries_[id];
+    if (!e.alive || id == keep) {
+      continue;
+    }
+    const uint32_t floor = force ? e.tailMip : e.targetMip;
+    if (e.residentMip < floor) {
+      victims.push_back(id);
+    }
+  }
+  // 使われていない期間が長いもの → 余分な段数が多いものから
+  std::sort(victims.begin(), victims.end(), [&](Id a, Id b) {
+    const Entry &ea = entries_[a];
+    const Entry &eb = entries_[b];
+    if (ea.lastUsedFrame != eb.lastUsedFrame) {
+      return ea.lastUsedFrame < eb.lastUsedFrame;
+    }
+    return ea.targetMip - ea.residentMip > eb.targetMip - eb.residentMip;
+  });
+
+  uint64_t freed = 0;
+  for (Id id : victims) {
+    if (freed >= needBytes) {
+      break;
+    }
+    const Entry &e = entries_[id];
+    const uint64_t before = GetResidentBytes(id);
+    // 要らない分は一度に、必要な分（force）は 1 段ずつ削る
+    uint32_t mip = e.targetMip;
+    if (force && e.residentMip >= e.targetMip) {
+      mip = e.residentMip + 1;
+    }
+    mip = (std::min)((std::max)(mip, e.residentMip + 1), e.tailMip);
+    SetResident_(id, mip, out);
+    freed += before - GetResidentBytes(id);
+  }
+  return freed;
+}
+
+void MipResidency::Update(uint64_t frame, std::vector<Change> &out) {
+  // 要求を目標に反映（途絶えて idleFrames 経ったものは tailMip まで戻してよい）
+  for (Entry &e : entries_) {
+    if (!e.alive) {
+      continue;
+    }
+    if (e.requestedMip != ~0u) {
+      e.targetMip = (std::min)(e.requestedMip, e.tailMip);
+      e.requestedMip = ~0u;
+    } else if (frame >= e.lastUsedFrame + settings_.idleFrames) {
+      e.targetMip = e.tailMip;
+    }
+  }
+
+  // 予算を下げた時などは、まず要らない分、それでも足りなければ必要な分も削る
+  const uint64_t budget = settings_.budgetBytes;
+  if (stats_.residentBytes > budget) {
+    Evict_(stats_.residentBytes - budget, kInvalidId, false, out);
+  }
+  while (stats_.residentBytes > budget &&
+         Evict_(stats_.residentBytes - budget, kInvalidId, true, out) >
+             0) {
+  }
+
+  // 細かくするもの: 差が大きい → 最近使われたものから
+  std::vector<Id> wanted;
+  for (Id id = 0; id < entries_.size(); ++id) {
+    const Entry &e = entries_[id];
+    if (e.alive && e.residentMip > e.targetMip) {
+      wanted.push_back(id);
+    }
+  }
+  std::sort(wanted.begin(), wanted.end(), [&](Id a, Id b) {
+    const Entry &ea = entries_[a];
+    const Entry &eb = entries_[b];
+    const uint32_t gapA = ea.residentMip - ea.targetMip;
+    const uint32_t gapB = eb.residentMip - eb.targetMip;
+    if (gapA != gapB) {
+      return gapA > gapB;
+    }
+    return ea.lastUsedFrame > eb.lastUsedFrame;
+  });
+
+  stats_.starved = 0;
+  uint32_t loads = 0;
+  for (Id id : wanted) {
+    const Entry &e = entries_[id];
+    const uint64_t cost = e.mipBytes[e.residentMip - 1];
+    if (loads >= settings_.maxLoadsPerUpdate) {
+      ++stats_.starved;
+      continue;
+    }
+    if (stats_.residentBytes + cost > budget) {
+      Evict_(stats_.residentBytes + cost - budget, id, false, out);
+    }
+    if (stats_.residentBytes + cost > budget) {
+      ++stats_.starved;
+      continue;
+    }
+    SetResident_(id, e.residentMip - 1, out);
+    ++loads;
+  }
+}
+
+uint32_t MipResidency::ComputeDesiredMip(uint32_t width, uint32_t height,
+                                         uint32_t mipCount, float screenPixels,
+                                         float bias) {
+  if (mipCount == 0) {
+    return 0;
+  }
+  const float texels = static_cast<float>((std::max)(width, height));
+  if (!(screenPixels > 0.0f)) {
+    return mipCount - 1;
+  }
+  const float lod = std::log2(texels / screenPixels) + bias;
+  if (!(lod > 0.0f)) {
+    return 0;
+  }
+  return (std::min)(static_cast<uint32_t>(lod), mipCount - 1);
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ストリーミングするテクスチャの、どのミップまで VRAM に置くかを決める（GPU に依存しない）
+// - ミップ番号は 0 が一番細かい。residentMip 以降のミップが常に揃っている
+// - tailMip 以降（小さいミップ）は登録時から最後まで置く（最初はこれだけで描く）
+// - 毎フレーム Request で「画面上の大きさから見て必要なミップ」を受け取り、
+//   Update で 1 段ずつ細かくする／予算を超えたら要らないものから粗くする
+// - 細かくする順: 必要なミップとの差が大きい → 最近使われた
+//   粗くする順  : 使われていない期間が長い → 必要以上に細かい段数が多い
+// - 予算に余裕がある間は、必要以上に細かいミップもすぐには捨てない（行き来を防ぐ）
+class MipResidency {
+public:
+  using Id = uint32_t;
+  static constexpr Id kInvalidId = ~0u;
+
+  struct Settings {
+    uint64_t budgetBytes = 256ull << 20; // 全テクスチャの常駐ミップの合計の上限
+    uint32_t maxLoadsPerUpdate = 4;      // 1 回の Update で細かくする数（転送量を均す）
+    uint32_t idleFrames = 120;           // この間要求が無ければ tailMip まで戻してよい
+  };
+
+  // residentMip を変えた 1 件（呼び出し側で確保し直す）
+  struct Change {
+    Id id = kInvalidId;
+    uint32_t residentMip = 0;
+  };
+
+  struct Stats {
+    uint64_t residentBytes = 0;
+    uint64_t loadedBytes = 0;  // 細かくして増えた累計
+    uint64_t evictedBytes = 0; // 粗くして減った累計
+    uint32_t textures = 0;
+    uint32_t loads = 0;
+    uint32_t evictions = 0;
+    uint32_t starved = 0; // 予算が足りず必要なミップを置けていないテクスチャ
+  };
+
+  MipResidency() = default;
+
+  void SetSettings(const Settings &settings) { settings_ = settings; }
+  const Settings &GetSettings() const { return settings_; }
+
+  // mipBytes[i] はミップ i のバイト数。residentMip = tailMip で登録する
+  Id Register(std::span<const uint64_t> mipBytes, uint32_t tailMip);
+  void Unregister(Id id);
+
+  // このフレームで必要な一番細かいミップ（同じフレームで複数回呼べば細かい方）
+  void Request(Id id, uint32_t desiredMip, uint64_t frame);
+
+  // 今フレームの変更を out に足す（適用済みとして数える）
+  void Update(uint64_t frame, std::vector<Change> &out);
+
+  bool IsRegistered(Id id) const {
+    return id < entries_.size() && entries_[id].alive;
+  }
+  uint32_t GetResidentMip(Id id) const { return entries_[id].residentMip; }
+  uint64_t GetResidentBytes(Id id) const;
+  Stats GetStats() const { return stats_; }
+
+  // 画面上の大きさ（ピクセル、長い辺）から必要な一番細かいミップを求める
+  // テクセルが画素より細かくなる分だけ粗いミップで足りる（bias > 0 でさらに粗く）
+  static uint32_t ComputeDesiredMip(uint32_t width, uint32_t height,
+                                    uint32_t mipCount, float screenPixels,
+                                    float bias = 0.0f);
+
+private:
+  struct Entry {
+    std::vector<uint64_t> mipBytes;
+    uint32_t tailMip = 0;
+    uint32_t residentMip = 0;
+    uint32_t targetMip = 0;    // 直近の要求（要求が途絶えたら tailMip）
+    uint32_t requestedMip = 0; // 今フレームの要求の最小（要求が無ければ ~0u）
+    uint64_t lastUsedFrame = 0;
+    bool alive = false;
+  };
+
+  // id を residentMip = mip にして差分を数える
+  void SetResident_(Id id, uint32_t mip, std::vector<Change> &out);
+  // keep 以外から needBytes 以上空ける（必要以上に細かいものだけ、force なら必要なものも）
+  uint64_t Evict_(uint64_t needBytes, Id keep, bool force,
+                  std::vector<Change> &out);
+
+  Settings settings_{};
+  std::vector<Entry> entries_;
+  std::vector<Id> freeIds_;
+  Stats stats_{};
+};
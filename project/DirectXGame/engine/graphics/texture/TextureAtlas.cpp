@@ -0,0 +1,166 @@
+#include "TextureAtlas.h"
+
+#include <Windows.h>
+#include <cstring>
+
+#include "Method.h"
+#include "TextureResource.h"
+#include "TextureUtils.h"
+
+namespace {
+
+constexpr DXGI_FORMAT kAtlasFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+
+void Report(const char *what, const std::string &path) {
+  std::string msg = std::string("TextureAtlas: ") + what + ": " + path + "\n";
+  OutputDebugStringA(msg.c_str());
+}
+
+// 元画像のミップ 0 を RGBA8（sRGB）で読む
+bool DecodeRgba(const std::string &filePath, DirectX::ScratchImage &out) {
+  const std::filesystem::path source = ResolveTexturePath(filePath);
+  if (source.empty()) {
+    Report("file NOT found", filePath);
+    return false;
+  }
+
+  DirectX::ScratchImage image{};
+  HRESULT hr = E_FAIL;
+  if (source.extension() == L".dds" || source.extension() == L".DDS") {
+    hr = DirectX::LoadFromDDSFile(source.c_str(), DirectX::DDS_FLAGS_NONE,
+                                  nullptr, image);
+    if (SUCCEEDED(hr) && DirectX::IsCompressed(image.GetMetadata().format)) {
+      DirectX::ScratchImage decompressed{};
+      hr = DirectX::Decompress(*image.GetImage(0, 0, 0), kAtlasFormat,
+                               decompressed);
+      image = std::move(decompressed);
+    }
+  } else {
+    hr = DirectX::LoadFromWICFile(source.c_str(),
+                                  DirectX::WIC_FLAGS_FORCE_SRGB, nullptr,
+                                  image);
+  }
+  if (FAILED(hr)) {
+    Report("load failed", filePath);
+    return false;
+  }
+
+  if (image.GetMetadata().format != kAtlasFormat) {
+    hr = DirectX::Convert(*image.GetImage(0, 0, 0), kAtlasFormat,
+                          DirectX::TEX_FILTER_SRGB,
+                          DirectX::TEX_THRESHOLD_DEFAULT, out);
+    if (FAILED(hr)) {
+      Report("Convert failed", filePath);
+      return false;
+    }
+    return true;
+  }
+  out = std::move(image);
+  return true;
+}
+
+} // namespace
+
+bool TextureAtlas::Build(DirectXCommon *dx, const std::string &name,
+                         const std::vector<std::string> &paths,
+                         const AtlasPacker::Settings &settings) {
+  name_ = name;
+  pages_.clear();
+  regions_.clear();
+  efficiency_ = 0.0;
+
+  // 読めなかった画像は大きさ 0（Pack が飛ばす）
+  std::vector<DirectX::ScratchImage> images(paths.size());
+  std::vector<AtlasPacker::Size> sizes(paths.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (DecodeRgba(paths[i], images[i])) {
+      const DirectX::TexMetadata &meta = images[i].GetMetadata();
+      sizes[i] = {uint32_t(meta.width), uint32_t(meta.height)};
+    }
+  }
+
+  AtlasPacker::Result packed;
+  AtlasPacker::Pack(sizes, settings, packed);
+  efficiency_ = AtlasPacker::ComputeEfficiency(packed);
+
+  // ミップはスロットの位置揃えで隣と混ざらない段数まで（box で 2x2 を平均）
+  const uint32_t mipLevels = AtlasPacker::GetSafeMipLevels(settings);
+  for (uint32_t page = 0; page < packed.pages.size(); ++page) {
+    const AtlasPacker::Size &extent = packed.pages[page];
+    DirectX::ScratchImage canvas{};
+    if (FAILED(canvas.Initialize2D(kAtlasFormat, extent.width, extent.height,
+                                   1, 1))) {
+      Report("Initialize2D failed", name);
+      return false;
+    }
+    const DirectX::Image *dst = canvas.GetImage(0, 0, 0);
+    std::memset(dst->pixels, 0, dst->slicePitch);
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+      const AtlasPacker::Placement &p = packed.placements[i];
+      if (!p.packed || p.page != page) {
+        continue;
+      }
+      const DirectX::Image *src = images[i].GetImage(0, 0, 0);
+      AtlasPacker::BlitWithBorder(dst->pixels, dst->rowPitch, src->pixels,
+                                  src->rowPitch, sizes[i].width,
+                                  sizes[i].height, p.x, p.y,
+                                  settings.padding);
+    }
+
+    DirectX::ScratchImage mips{};
+    if (mipLevels > 1) {
+      if (FAILED(DirectX::GenerateMipMaps(
+              *dst, DirectX::TEX_FILTER_BOX | DirectX::TEX_FILTER_SRGB,
+              mipLevels, mips))) {
+        Report("GenerateMipMaps failed", name);
+        return false;
+      }
+    } else {
+      mips = std::move(canvas);
+    }
+
+    auto texture = std::make_shared<TextureResource>();
+    if (!texture->CreateFromMetadata(dx, mips, mips.GetMetadata())) {
+      Report("CreateFromMetadata failed", name);
+      return false;
+    }
+    pages_.push_back(std::move(texture));
+  }
+
+  for (size_t i = 0; i < paths.size(); ++i) {
+    const AtlasPacker::Placement &p = packed.placements[i];
+    if (!p.packed) {
+      if (sizes[i].width > 0) {
+        Report("does not fit in a page", paths[i]);
+      }
+      continue;
+    }
+    const AtlasPacker::Size &extent = packed.pages[p.page];
+    Region region;
+    region.page = pages_[p.page];
+    region.pageKey = name + "#" + std::to_string(p.page);
+    region.uvRect = {float(p.x) / float(extent.width),
+                     float(p.y) / float(extent.height),
+                     float(sizes[i].width) / float(extent.width),
+                     float(sizes[i].height) / float(extent.height)};
+    region.width = sizes[i].width;
+    region.height = sizes[i].height;
+    regions_[paths[i]] = std::move(region);
+  }
+  return true;
+}
+
+const TextureAtlas::Region *TextureAtlas::Find(const std::string &path) const {
+  auto it = regions_.find(path);
+  return it != regions_.end() ? &it->second : nullptr;
+}
+
+Matrix4x4 TextureAtlas::MakeUVMatrix(const Vector4 &uvRect) {
+  Matrix4x4 m = MakeIdentity4x4();
+  m.m[0][0] = uvRect.z;
+  m.m[1][1] = uvRect.w;
+  m.m[3][0] = uvRect.x;
+  m.m[3][1] = uvRect.y;
+  return m;
+}
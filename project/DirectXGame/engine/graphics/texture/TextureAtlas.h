@@ -0,0 +1,53 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AtlasPacker.h"
+#include "Matrix.h"
+#include "Vector.h"
+
+class DirectXCommon;
+class TextureResource;
+
+// 小さい画像（スプライト・パーティクル）を数枚のページにまとめたテクスチャ
+// - Build で画像を読み、AtlasPacker で詰めたページ（RGBA8 sRGB、隣と混ざらない段数までのミップ）を作る
+// - 元のパスからページと UV の範囲を引ける。TextureManager::RegisterAtlas で登録すると、
+//   Sprite / ParticleManager は同じページを共有し、続く描画でテクスチャの bind が省ける
+//   （省けるのは bind だけで、描画の回数は変わらない。スプライトは 1 枚ごとに 1 回描く）
+// - ページは BC にしない（ミップ 1 以降で BC のブロックが隣の画像に跨るため）
+// - 範囲の外は隣の画像なので、UV を繰り返す（タイリングする）画像は載せないこと
+class TextureAtlas {
+public:
+  struct Region {
+    std::shared_ptr<TextureResource> page;
+    std::string pageKey;            // 「アトラス名#ページ番号」（ページごとのキャッシュのキー）
+    Vector4 uvRect = {0, 0, 1, 1};  // xy: 左上、zw: 大きさ（ページ全体を 1 とした UV）
+    uint32_t width = 0;             // 元画像の大きさ（ピクセル）
+    uint32_t height = 0;
+  };
+
+  // 描画スレッドから、メインのコマンドリストが記録中の時に呼ぶ
+  // 読めない画像・ページに入らない大きさの画像は載せない（それぞれのテクスチャのまま使われる）
+  bool Build(DirectXCommon *dx, const std::string &name,
+             const std::vector<std::string> &paths,
+             const AtlasPacker::Settings &settings = {});
+
+  // 載っていなければ nullptr
+  const Region *Find(const std::string &path) const;
+
+  const std::string &GetName() const { return name_; }
+  size_t GetPageCount() const { return pages_.size(); }
+  // ページの使用範囲に対する画像本体の面積の割合
+  double GetEfficiency() const { return efficiency_; }
+
+  // uv' = uv * rect.zw + rect.xy の UV 行列（元の uvTransform の後ろに掛ける）
+  static Matrix4x4 MakeUVMatrix(const Vector4 &uvRect);
+
+private:
+  std::string name_;
+  std::vector<std::shared_ptr<TextureResource>> pages_;
+  std::unordered_map<std::string, Region> regions_;
+  double efficiency_ = 0.0;
+};
@@ -0,0 +1,276 @@
+#include "TextureCache.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// ヘッダをそのまま書き出すので、実行環境と形式のエンディアンが一致している前提
+static_assert(std::endian::native == std::endian::little);
+
+namespace {
+
+constexpr uint32_t kDdsMagic = 0x20534444; // "DDS "
+constexpr uint32_t kTag = 0x58544B43;      // dwReserved1[0] が "CKTX"
+
+// DDS_HEADER / DDS_HEADER_DXT10 と同じ並び（DDS.h は Windows の型に依存するので写す）
+struct DdsPixelFormat {
+  uint32_t size;
+  uint32_t flags;
+  uint32_t fourCC;
+  uint32_t rgbBitCount;
+  uint32_t rBitMask;
+  uint32_t gBitMask;
+  uint32_t bBitMask;
+  uint32_t aBitMask;
+};
+
+// dwReserved1 の中身（11 個のうち 8 個を使う）
+struct CookRecord {
+  uint32_t tag;
+  uint32_t version;
+  uint32_t sourceHashLo;
+  uint32_t sourceHashHi;
+  uint32_t usage;
+  uint32_t reserved;
+  uint32_t fileSizeLo;
+  uint32_t fileSizeHi;
+  uint32_t unused[3];
+};
+static_assert(sizeof(CookRecord) == sizeof(uint32_t) * 11);
+
+struct DdsHeader {
+  uint32_t size;
+  uint32_t flags;
+  uint32_t height;
+  uint32_t width;
+  uint32_t pitchOrLinearSize;
+  uint32_t depth;
+  uint32_t mipMapCount;
+  CookRecord cook; // dwReserved1[11]
+  DdsPixelFormat pixelFormat;
+  uint32_t caps;
+  uint32_t caps2;
+  uint32_t caps3;
+  uint32_t caps4;
+  uint32_t reserved2;
+};
+static_assert(sizeof(DdsHeader) == 124);
+
+struct DdsHeaderDx10 {
+  uint32_t dxgiFormat;
+  uint32_t resourceDimension;
+  uint32_t miscFlag;
+  uint32_t arraySize;
+  uint32_t miscFlags2;
+};
+static_assert(sizeof(DdsHeaderDx10) == 20);
+
+struct FileHeader {
+  uint32_t magic;
+  DdsHeader dds;
+  DdsHeaderDx10 dx10;
+};
+static_assert(sizeof(FileHeader) == 148);
+
+constexpr uint32_t kHeaderCaps = 0x1;          // DDSD_CAPS
+constexpr uint32_t kHeaderHeight = 0x2;        // DDSD_HEIGHT
+constexpr uint32_t kHeaderWidth = 0x4;         // DDSD_WIDTH
+constexpr uint32_t kHeaderPixelFormat = 0x1000; // DDSD_PIXELFORMAT
+constexpr uint32_t kHeaderMipMapCount = 0x20000; // DDSD_MIPMAPCOUNT
+constexpr uint32_t kHeaderLinearSize = 0x80000;  // DDSD_LINEARSIZE
+constexpr uint32_t kPixelFormatFourCC = 0x4;     // DDPF_FOURCC
+constexpr uint32_t kFourCCDx10 = 0x30315844;     // "DX10"
+constexpr uint32_t kCapsComplex = 0x8;           // DDSCAPS_COMPLEX
+constexpr uint32_t kCapsTexture = 0x1000;        // DDSCAPS_TEXTURE
+constexpr uint32_t kCapsMipMap = 0x400000;       // DDSCAPS_MIPMAP
+constexpr uint32_t kDimensionTexture2D = 3;      // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+
+// BC のブロックのバイト数。BC でなければ 0
+size_t GetBlockBytes(uint32_t dxgiFormat) {
+  switch (dxgiFormat) {
+  case 70: // BC1_TYPELESS
+  case 71: // BC1_UNORM
+  case 72: // BC1_UNORM_SRGB
+  case 79: // BC4_TYPELESS
+  case 80: // BC4_UNORM
+  case 81: // BC4_SNORM
+    return 8;
+  case 76: // BC3_TYPELESS
+  case 77: // BC3_UNORM
+  case 78: // BC3_UNORM_SRGB
+  case 82: // BC5_TYPELESS
+  case 83: // BC5_UNORM
+  case 84: // BC5_SNORM
+  case 97: // BC7_TYPELESS
+  case 98: // BC7_UNORM
+  case 99: // BC7_UNORM_SRGB
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+// BC 以外で使う（キャッシュに置くのは変換できなかった RGBA8 だけ）
+size_t GetBytesPerPixel(uint32_t dxgiFormat) {
+  switch (dxgiFormat) {
+  case 28: // R8G8B8A8_UNORM
+  case 29: // R8G8B8A8_UNORM_SRGB
+  case 87: // B8G8R8A8_UNORM
+  case 91: // B8G8R8A8_UNORM_SRGB
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+uint64_t ComputeFileSize(uint32_t dxgiFormat, uint32_t width, uint32_t height,
+                         uint32_t mipCount) {
+  uint64_t size = sizeof(FileHeader);
+  for (uint32_t i = 0; i < mipCount; ++i) {
+    size += TextureCache::GetMipSize(dxgiFormat, (std::max)(width >> i, 1u),
+                                     (std::max)(height >> i, 1u));
+  }
+  return size;
+}
+
+} // namespace
+
+namespace TextureCache {
+
+std::string MakeCachePath(const std::string &sourcePath) {
+  return sourcePath + ".cooked.dds";
+}
+
+size_t GetMipSize(uint32_t dxgiFormat, uint32_t width, uint32_t height) {
+  if (const size_t blockBytes = GetBlockBytes(dxgiFormat); blockBytes > 0) {
+    return blockBytes * ((width + 3) / 4) * ((height + 3) / 4);
+  }
+  return GetBytesPerPixel(dxgiFormat) * width * height;
+}
+
+bool Save(const std::string &cachePath, const CookKey &key, uint32_t dxgiFormat,
+          uint32_t width, uint32_t height,
+          const std::vector<std::vector<uint8_t>> &mips) {
+  if (mips.empty() || width == 0 || height == 0 ||
+      GetMipSize(dxgiFormat, 1, 1) == 0) {
+    return false;
+  }
+  const uint32_t mipCount = static_cast<uint32_t>(mips.size());
+  for (uint32_t i = 0; i < mipCount; ++i) {
+    if (mips[i].size() != GetMipSize(dxgiFormat, (std::max)(width >> i, 1u),
+                                     (std::max)(height >> i, 1u))) {
+      return false;
+    }
+  }
+  const uint64_t fileSize = ComputeFileSize(dxgiFormat, width, height, mipCount);
+
+  FileHeader h{};
+  h.magic = kDdsMagic;
+  h.dds.size = sizeof(DdsHeader);
+  h.dds.flags = kHeaderCaps | kHeaderHeight | kHeaderWidth |
+                kHeaderPixelFormat | kHeaderMipMapCount | kHeaderLinearSize;
+  h.dds.height = height;
+  h.dds.width = width;
+  h.dds.pitchOrLinearSize = static_cast<uint32_t>(mips[0].size());
+  h.dds.mipMapCount = mipCount;
+  h.dds.cook.tag = kTag;
+  h.dds.cook.version = kVersion;
+  h.dds.cook.sourceHashLo = static_cast<uint32_t>(key.sourceHash);
+  h.dds.cook.sourceHashHi = static_cast<uint32_t>(key.sourceHash >> 32);
+  h.dds.cook.usage = key.usage;
+  h.dds.cook.fileSizeLo = static_cast<uint32_t>(fileSize);
+  h.dds.cook.fileSizeHi = static_cast<uint32_t>(fileSize >> 32);
+  h.dds.pixelFormat.size = sizeof(DdsPixelFormat);
+  h.dds.pixelFormat.flags = kPixelFormatFourCC;
+  h.dds.pixelFormat.fourCC = kFourCCDx10;
+  h.dds.caps = kCapsTexture | (mipCount > 1 ? kCapsMipMap | kCapsComplex : 0);
+  h.dx10.dxgiFormat = dxgiFormat;
+  h.dx10.resourceDimension = kDimensionTexture2D;
+  h.dx10.arraySize = 1;
+
+  const std::string tempPath = cachePath + ".tmp";
+  {
+    std::ofstream ofs(tempPath, std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+      return false;
+    }
+    ofs.write(reinterpret_cast<const char *>(&h), sizeof(h));
+    for (const std::vector<uint8_t> &mip : mips) {
+      ofs.write(reinterpret_cast<const char *>(mip.data()),
+                static_cast<std::streamsize>(mip.size()));
+    }
+    if (!ofs) {
+      return false;
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tempPath, cachePath, ec);
+  if (ec) {
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+  return true;
+}
+
+bool Open(const std::string &cachePath, const CookKey &key, MappedFile &out) {
+  if (!out.Open(cachePath)) {
+    return false;
+  }
+  FileHeader h{};
+  if (out.GetSize() < sizeof(h)) {
+    out.Close();
+    return false;
+  }
+  std::memcpy(&h, out.GetData(), sizeof(h));
+
+  const uint64_t sourceHash =
+      (uint64_t(h.dds.cook.sourceHashHi) << 32) | h.dds.cook.sourceHashLo;
+  const uint64_t fileSize =
+      (uint64_t(h.dds.cook.fileSizeHi) << 32) | h.dds.cook.fileSizeLo;
+  const bool valid =
+      h.magic == kDdsMagic && h.dds.size == sizeof(DdsHeader) &&
+      h.dds.pixelFormat.fourCC == kFourCCDx10 && h.dds.cook.tag == kTag &&
+      h.dds.cook.version == kVersion && sourceHash == key.sourceHash &&
+      h.dds.cook.usage == key.usage && h.dds.mipMapCount > 0 &&
+      h.dds.mipMapCount <= 32 && GetMipSize(h.dx10.dxgiFormat, 1, 1) > 0 &&
+      fileSize == out.GetSize() &&
+      fileSize == ComputeFileSize(h.dx10.dxgiFormat, h.dds.width,
+                                  h.dds.height, h.dds.mipMapCount);
+  if (!valid) {
+    out.Close();
+    return false;
+  }
+  return true;
+}
+
+Info GetInfo(const MappedFile &file) {
+  FileHeader h{};
+  assert(file.GetSize() >= sizeof(h));
+  std::memcpy(&h, file.GetData(), sizeof(h));
+  return {h.dx10.dxgiFormat, h.dds.width, h.dds.height, h.dds.mipMapCount};
+}
+
+bool GetMip(const MappedFile &file, uint32_t mip, MipView &out) {
+  const Info info = GetInfo(file);
+  if (mip >= info.mipCount) {
+    return false;
+  }
+  // ミップは先頭から隙間なく並んでいる（大きさは Open で確かめ済み）
+  size_t offset = sizeof(FileHeader);
+  for (uint32_t i = 0; i < mip; ++i) {
+    offset += GetMipSize(info.dxgiFormat, (std::max)(info.width >> i, 1u),
+                         (std::max)(info.height >> i, 1u));
+  }
+  out.width = (std::max)(info.width >> mip, 1u);
+  out.height = (std::max)(info.height >> mip, 1u);
+  out.size = GetMipSize(info.dxgiFormat, out.width, out.height);
+  out.rowPitch = GetMipSize(info.dxgiFormat, out.width, 1);
+  out.data = file.GetData() + offset;
+  return true;
+}
+
+} // namespace TextureCache
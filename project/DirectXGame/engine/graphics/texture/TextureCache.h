@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MappedFile;
+
+// 変換済みテクスチャ（BCn + ミップ）のキャッシュ。中身は普通の DDS（DX10 拡張ヘッダ）
+// - ミップは先頭から詰めて並べるので、DirectXTex の LoadFromDDSMemory がそのまま写せる
+// - CookKey（元画像の中身のハッシュ + 用途）と kVersion は DDS ヘッダの
+//   dwReserved1 に入れる。一致しなければ無効として扱い、呼び出し側で作り直す
+// - D3D / DirectXTex に依存しない（形式は DXGI_FORMAT の値で受け取る）
+namespace TextureCache {
+
+// 形式や変換処理（BcEncoder・形式の選び方）を変えたら上げる
+constexpr uint32_t kVersion = 1;
+
+struct CookKey {
+  uint64_t sourceHash = 0; // 元画像の中身の MeshCache::HashBytes
+  uint32_t usage = 0;      // TextureCooker::Usage
+};
+
+// 元画像の隣に置くキャッシュのパス
+std::string MakeCachePath(const std::string &sourcePath);
+
+// 1 ミップぶんのバイト数（BC は 4x4 ブロック単位、それ以外は 1 画素 bytesPerPixel）
+size_t GetMipSize(uint32_t dxgiFormat, uint32_t width, uint32_t height);
+
+// mips[0] が最も大きい。各要素は GetMipSize の大きさで行間の隙間なし
+// 一時ファイルに書いてから置き換えるので、途中で落ちても壊れたキャッシュは残らない
+bool Save(const std::string &cachePath, const CookKey &key, uint32_t dxgiFormat,
+          uint32_t width, uint32_t height,
+          const std::vector<std::vector<uint8_t>> &mips);
+
+// キャッシュをマップし、ヘッダの CookKey と大きさを確かめる
+// 無い・古い・壊れている場合は false（out は閉じた状態）
+bool Open(const std::string &cachePath, const CookKey &key, MappedFile &out);
+
+// Open で確かめたキャッシュの形式と大きさ
+struct Info {
+  uint32_t dxgiFormat = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t mipCount = 0;
+};
+
+// ミップ 1 枚。data はマップした領域を指す（ファイルを閉じるまで有効）
+struct MipView {
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+  size_t rowPitch = 0; // BC は 4x4 ブロック 1 行ぶん
+  uint32_t width = 0;
+  uint32_t height = 0;
+};
+
+// 以下は Open に成功したファイルにだけ使う
+Info GetInfo(const MappedFile &file);
+// mip が範囲外なら false
+bool GetMip(const MappedFile &file, uint32_t mip, MipView &out);
+
+} // namespace TextureCache
@@ -0,0 +1,227 @@
+#include "TextureCooker.h"
+#include "BcEncoder.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "TextureCache.h"
+
+#include <Windows.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+struct CookFormat {
+  DXGI_FORMAT format;
+  bool compressed;
+  BcEncoder::Format encoding;
+};
+
+CookFormat ChooseFormat(TextureCooker::Usage usage, bool opaque,
+                        bool blockAligned) {
+  using TextureCooker::Usage;
+  if (!blockAligned) {
+    return {usage == Usage::Albedo ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+                                   : DXGI_FORMAT_R8G8B8A8_UNORM,
+            false, BcEncoder::Format::BC1};
+  }
+  switch (usage) {
+  case Usage::Normal:
+    return {DXGI_FORMAT_BC5_UNORM, true, BcEncoder::Format::BC5};
+  case Usage::Mask:
+    return opaque ? CookFormat{DXGI_FORMAT_BC1_UNORM, true,
+                               BcEncoder::Format::BC1}
+                  : CookFormat{DXGI_FORMAT_BC3_UNORM, true,
+                               BcEncoder::Format::BC3};
+  case Usage::Albedo:
+  default:
+    // BC7 はモード 6 だけなので、切り抜きのような硬いアルファは BC3 の方がきれい
+    return opaque ? CookFormat{DXGI_FORMAT_BC7_UNORM_SRGB, true,
+                               BcEncoder::Format::BC7}
+                  : CookFormat{DXGI_FORMAT_BC3_UNORM_SRGB, true,
+                               BcEncoder::Format::BC3};
+  }
+}
+
+void Report(const char *what, const std::filesystem::path &path) {
+  std::string msg =
+      std::string("TextureCooker: ") + what + ": " + path.string() + "\n";
+  OutputDebugStringA(msg.c_str());
+}
+
+// 元画像を RGBA8 にしてミップを作る
+bool DecodeSource(const std::filesystem::path &sourcePath, bool srgb,
+                  DirectX::ScratchImage &outMips) {
+  DirectX::ScratchImage image{};
+  HRESULT hr = DirectX::LoadFromWICFile(
+      sourcePath.c_str(),
+      srgb ? DirectX::WIC_FLAGS_FORCE_SRGB : DirectX::WIC_FLAGS_IGNORE_SRGB,
+      nullptr, image);
+  if (FAILED(hr)) {
+    Report("LoadFromWICFile failed", sourcePath);
+    return false;
+  }
+
+  // 色空間の変換はしない（sRGB の値のまま RGBA8 に並べ替えるだけ）
+  const DirectX::TEX_FILTER_FLAGS filter =
+      srgb ? DirectX::TEX_FILTER_SRGB : DirectX::TEX_FILTER_DEFAULT;
+  const DXGI_FORMAT rgba = srgb ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB
+                                : DXGI_FORMAT_R8G8B8A8_UNORM;
+  if (image.GetMetadata().format != rgba) {
+    DirectX::ScratchImage converted{};
+    hr = DirectX::Convert(image.GetImages(), image.GetImageCount(),
+                          image.GetMetadata(), rgba, filter,
+                          DirectX::TEX_THRESHOLD_DEFAULT, converted);
+    if (FAILED(hr)) {
+      Report("Convert failed", sourcePath);
+      return false;
+    }
+    image = std::move(converted);
+  }
+
+  hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(),
+                                image.GetMetadata(), filter, 0, outMips);
+  if (FAILED(hr)) {
+    Report("GenerateMipMaps failed", sourcePath);
+    return false;
+  }
+  return true;
+}
+
+// 変換結果（キャッシュと返す画像で同じものを使う）
+struct Cooked {
+  DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<std::vector<uint8_t>> mips; // ミップごとに詰めて並べる
+};
+
+bool Cook(const std::filesystem::path &sourcePath, TextureCooker::Usage usage,
+          Cooked &out) {
+  DirectX::ScratchImage source{};
+  if (!DecodeSource(sourcePath, usage == TextureCooker::Usage::Albedo,
+                    source)) {
+    return false;
+  }
+  const DirectX::TexMetadata &meta = source.GetMetadata();
+  out.width = static_cast<uint32_t>(meta.width);
+  out.height = static_cast<uint32_t>(meta.height);
+  const CookFormat cook =
+      ChooseFormat(usage, source.IsAlphaAllOpaque(),
+                   out.width % 4 == 0 && out.height % 4 == 0);
+  out.format = cook.format;
+
+  out.mips.assign(meta.mipLevels, {});
+  for (size_t level = 0; level < meta.mipLevels; ++level) {
+    const DirectX::Image *img = source.GetImage(level, 0, 0);
+    const uint32_t w = static_cast<uint32_t>(img->width);
+    const uint32_t h = static_cast<uint32_t>(img->height);
+    std::vector<uint8_t> &mip = out.mips[level];
+    mip.resize(TextureCache::GetMipSize(cook.format, w, h));
+    if (cook.compressed) {
+      BcEncoder::Encode(cook.encoding, img->pixels, w, h, img->rowPitch,
+                        mip.data());
+    } else {
+      for (uint32_t y = 0; y < h; ++y) {
+        std::memcpy(mip.data() + size_t(y) * w * 4,
+                    img->pixels + y * img->rowPitch, size_t(w) * 4);
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+namespace TextureCooker {
+
+Usage GuessUsage(const std::string &filePath) {
+  std::string stem = std::filesystem::path(filePath).stem().string();
+  std::transform(stem.begin(), stem.end(), stem.begin(), [](char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  });
+  auto endsWith = [&stem](const char *suffix) {
+    const size_t n = std::strlen(suffix);
+    return stem.size() > n && stem.compare(stem.size() - n, n, suffix) == 0;
+  };
+  if (endsWith("_n") || endsWith("_normal") || endsWith("_nrm")) {
+    return Usage::Normal;
+  }
+  if (endsWith("_mask") || endsWith("_orm") || endsWith("_rough") ||
+      endsWith("_metal") || endsWith("_ao")) {
+    return Usage::Mask;
+  }
+  return Usage::Albedo;
+}
+
+bool OpenOrCook(const std::filesystem::path &sourcePath, Usage usage,
+                MappedFile &out) {
+  TextureCache::CookKey cookKey{};
+  cookKey.usage = static_cast<uint32_t>(usage);
+  if (!MeshCache::HashFile(sourcePath.string(), cookKey.sourceHash)) {
+    return false;
+  }
+  const std::string cachePath = TextureCache::MakeCachePath(sourcePath.string());
+  if (TextureCache::Open(cachePath, cookKey, out)) {
+    return true;
+  }
+
+  Cooked cooked;
+  if (!Cook(sourcePath, usage, cooked)) {
+    return false;
+  }
+  if (!TextureCache::Save(cachePath, cookKey, cooked.format, cooked.width,
+                          cooked.height, cooked.mips)) {
+    Report("cache save failed", sourcePath);
+    return false;
+  }
+  return TextureCache::Open(cachePath, cookKey, out);
+}
+
+DirectX::ScratchImage LoadOrCook(const std::filesystem::path &sourcePath,
+                                 Usage usage) {
+  // 元画像の中身と用途が同じならキャッシュを写すだけ
+  TextureCache::CookKey cookKey{};
+  cookKey.usage = static_cast<uint32_t>(usage);
+  const std::string cachePath = TextureCache::MakeCachePath(sourcePath.string());
+  const bool hashed =
+      MeshCache::HashFile(sourcePath.string(), cookKey.sourceHash);
+  if (hashed) {
+    MappedFile cache;
+    DirectX::ScratchImage cached{};
+    if (TextureCache::Open(cachePath, cookKey, cache) &&
+        SUCCEEDED(DirectX::LoadFromDDSMemory(cache.GetData(), cache.GetSize(),
+                                             DirectX::DDS_FLAGS_NONE, nullptr,
+                                             cached))) {
+      return cached;
+    }
+  }
+
+  Cooked cooked;
+  if (!Cook(sourcePath, usage, cooked)) {
+    return DirectX::ScratchImage{};
+  }
+
+  // 書けなくても（読み取り専用の配置など）変換した画像はそのまま使う
+  if (hashed && !TextureCache::Save(cachePath, cookKey, cooked.format,
+                                    cooked.width, cooked.height, cooked.mips)) {
+    Report("cache save failed", sourcePath);
+  }
+
+  DirectX::ScratchImage result{};
+  if (FAILED(result.Initialize2D(cooked.format, cooked.width, cooked.height, 1,
+                                 cooked.mips.size()))) {
+    Report("Initialize2D failed", sourcePath);
+    return DirectX::ScratchImage{};
+  }
+  for (size_t level = 0; level < cooked.mips.size(); ++level) {
+    const DirectX::Image *dst = result.GetImage(level, 0, 0);
+    // BC も RGBA8 も行間の隙間は無いので、ミップ 1 枚ぶんをそのまま写せる
+    std::memcpy(dst->pixels, cooked.mips[level].data(),
+                (std::min)(dst->slicePitch, cooked.mips[level].size()));
+  }
+  return result;
+}
+
+} // namespace TextureCooker
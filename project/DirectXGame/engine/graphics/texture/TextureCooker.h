@@ -0,0 +1,39 @@
+#pragma once
+#include "externals/DirectXTex/DirectXTex.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+class MappedFile;
+
+// 元画像（PNG 等）を BCn + ミップに変換し、DDS のキャッシュ（TextureCache）に置く
+// - 2 回目以降はキャッシュを写すだけ（WIC の展開・ミップ生成・圧縮をしない）
+// - 形式は用途で決める
+//   Albedo: BC7（sRGB）、アルファが抜ける画像は BC3（sRGB）
+//   Normal: BC5（xy だけ。z はシェーダで sqrt(1 - x^2 - y^2) として戻す）
+//   Mask  : BC1、アルファがあれば BC3
+// - 幅・高さが 4 の倍数でない画像は BC にできない（D3D12 の制約）ので RGBA8 のまま
+//   ミップ付きでキャッシュする
+namespace TextureCooker {
+
+enum class Usage : uint32_t {
+  Albedo,
+  Normal,
+  Mask,
+};
+
+// ファイル名の末尾で用途を決める（_n / _normal / _nrm は法線、
+// _mask / _orm / _rough / _metal / _ao はマスク、それ以外は色）
+Usage GuessUsage(const std::string &filePath);
+
+// 失敗時は空の ScratchImage
+DirectX::ScratchImage LoadOrCook(const std::filesystem::path &sourcePath,
+                                 Usage usage);
+
+// キャッシュをマップする（無い・古ければ変換して書き出してから）。画像は展開しない
+// ストリーミングで細かいミップを後からここから読む
+// 変換できない・キャッシュを書けない（読み取り専用の配置など）なら false
+bool OpenOrCook(const std::filesystem::path &sourcePath, Usage usage,
+                MappedFile &out);
+
+} // namespace TextureCooker
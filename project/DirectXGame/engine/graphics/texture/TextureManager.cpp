@@ -1,7 +1,14 @@
 #include "TextureManager.h"
+#include "AssetLoadQueue.h"
+#include "DirectXCommon.h"
+#include "MappedFile.h"
 #include "TextureResource.h"
+#include "TextureUtils.h"
+#include "externals/DirectXTex/DirectXTex.h"
 #include <Windows.h>
 
+static constexpr const char *kPlaceholderPath_ = "resources/white1x1.png";
+
 static void TexFatal_(const std::string &msg) {
   MessageBoxA(nullptr, msg.c_str(), "Texture Fatal", MB_OK | MB_ICONERROR);
   std::terminate();
@@ -12,29 +19,224 @@ std::shared_ptr<TextureResource> TextureManager::Load(const std::string &path) {
     TexFatal_("[TextureManager] dx_ is null. Call Initialize first.");
   }
 
-  if (auto it = cache_.find(path); it != cache_.end()) {
-    if (auto alive = it->second.lock()) {
-      return alive;
+  auto acquired = cache_.Acquire(path);
+  if (!acquired.created) {
+    // LoadAsync で読み込み中なら仕上げを回しながら待つ
+    AssetLoadQueue::GetInstance()->Wait(acquired.future);
+    if (auto tex = acquired.future.Get()) {
+      return tex;
     }
+    TexFatal_(std::string("[TextureManager] LoadAsync failed:\n") + path);
+  }
+
+  auto tex = CreateTexture_(path, LoadSource_(path));
+  if (!tex) {
+    cache_.Complete(path, acquired.future, nullptr);
+    TexFatal_(std::string("[TextureManager] CreateFromFile failed:\n") + path);
   }
 
+  cache_.Complete(path, acquired.future, tex, tex->GetGpuBytes());
+  return tex;
+}
+
+AssetFuture<TextureResource>
+TextureManager::LoadAsync(const std::string &path) {
+  if (!dx_) {
+    TexFatal_("[TextureManager] dx_ is null. Call Initialize first.");
+  }
+
+  auto acquired = cache_.Acquire(path, GetPlaceholder());
+  if (!acquired.created) {
+    return acquired.future;
+  }
+
+  auto *queue = AssetLoadQueue::GetInstance();
+  queue->Submit([this, queue, path, future = acquired.future]() {
+    // WIC に要る COM はワーカーの入口で初期化済み（AssetLoadQueue::GetWorkerHooks）
+    Source_ source = LoadSource_(path);
+
+    queue->PostToRenderThread([this, path, future, source]() {
+      auto tex = CreateTexture_(path, source);
+      if (!tex) {
+        OutputDebugStringA(
+            ("[TextureManager] LoadAsync failed: " + path + "\n").c_str());
+      }
+      cache_.Complete(path, future, tex, tex ? tex->GetGpuBytes() : 0);
+      return true;
+    });
+  });
+  return acquired.future;
+}
+
+std::shared_ptr<TextureResource> TextureManager::GetPlaceholder() {
+  // 登録簿を通さずに作る（仕上げの途中から呼ばれても他の読み込みを待たない）
+  if (!placeholder_) {
+    auto tex = std::make_shared<TextureResource>();
+    if (!tex->CreateFromFile(dx_, kPlaceholderPath_)) {
+      TexFatal_(std::string("[TextureManager] CreateFromFile failed:\n") +
+                kPlaceholderPath_);
+    }
+    placeholder_ = tex;
+  }
+  return placeholder_;
+}
+
+void TextureManager::ClearUnused() { cache_.ClearUnused(); }
+
+void TextureManager::RegisterAtlas(std::shared_ptr<TextureAtlas> atlas) {
+  if (!atlas) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(atlasMutex_);
+  atlases_.push_back(std::move(atlas));
+}
+
+void TextureManager::UnregisterAtlas(const std::string &name) {
+  std::lock_guard<std::mutex> lock(atlasMutex_);
+  std::erase_if(atlases_, [&name](const std::shared_ptr<TextureAtlas> &atlas) {
+    return atlas->GetName() == name;
+  });
+}
+
+bool TextureManager::FindAtlasRegion(const std::string &path,
+                                     TextureAtlas::Region &out) const {
+  std::lock_guard<std::mutex> lock(atlasMutex_);
+  for (auto it = atlases_.rbegin(); it != atlases_.rend(); ++it) {
+    if (const TextureAtlas::Region *region = (*it)->Find(path)) {
+      out = *region;
+      return true;
+    }
+  }
+  return false;
+}
+
+
+TextureManager::Source_
+TextureManager::LoadSource_(const std::string &path) const {
+  Source_ source;
+  auto cache = std::make_shared<MappedFile>();
+  if (OpenCookedTexture(path, *cache)) {
+    const TextureCache::Info info = TextureCache::GetInfo(*cache);
+    source.tailMip = TextureResource::ComputeTailMip(info, kStreamingTailSize);
+    if (streamingEnabled_ && source.tailMip > 0) {
+      // 展開しない。細かいミップは要求が来てからマップから読む
+      source.cache = std::move(cache);
+      return source;
+    }
+    source.image = std::make_shared<DirectX::ScratchImage>();
+    if (FAILED(DirectX::LoadFromDDSMemory(cache->GetData(), cache->GetSize(),
+                                          DirectX::DDS_FLAGS_NONE, nullptr,
+                                          *source.image))) {
+      source.image.reset();
+    }
+    return source;
+  }
+  // DDS・キャッシュを書けない画像は従来通り全ミップを展開する
+  source.image = std::make_shared<DirectX::ScratchImage>(LoadTexture(path));
+  return source;
+}
+
+std::shared_ptr<TextureResource>
+TextureManager::CreateTexture_(const std::string &path,
+                               const Source_ &source) {
   auto tex = std::make_shared<TextureResource>();
+  if (!source.cache) {
+    if (!source.image || source.image->GetImageCount() == 0) {
+      return nullptr;
+    }
+    return tex->CreateFromMetadata(dx_, *source.image,
+                                   source.image->GetMetadata())
+               ? tex
+               : nullptr;
+  }
 
-  const bool ok = tex->CreateFromFile(dx_, path);
-  if (!ok) {
-    TexFatal_(std::string("[TextureManager] CreateFromFile failed:\n") + path);
+  // 最初は小さいミップだけ。細かいミップは要求が来てから足す
+  if (!tex->CreateStreaming(dx_, source.cache, source.tailMip)) {
+    return nullptr;
+  }
+  const TextureCache::Info &info = tex->GetStreamingInfo();
+  std::vector<uint64_t> mipBytes(info.mipCount);
+  for (uint32_t mip = 0; mip < info.mipCount; ++mip) {
+    TextureCache::MipView view{};
+    TextureCache::GetMip(*source.cache, mip, view);
+    mipBytes[mip] = view.size;
   }
 
-  cache_[path] = tex;
+  std::lock_guard<std::mutex> lock(streamingMutex_);
+  const MipResidency::Id id = residency_.Register(mipBytes, source.tailMip);
+  if (streamed_.size() <= id) {
+    streamed_.resize(id + 1);
+  }
+  streamed_[id] = {tex, path};
+  // 破棄済みのテクスチャと同じアドレスに作られた場合は上書きになる（古い方は次の Update で外す）
+  streamingIds_[tex.get()] = id;
   return tex;
 }
 
-void TextureManager::ClearUnused() {
-  for (auto it = cache_.begin(); it != cache_.end();) {
-    if (it->second.expired()) {
-      it = cache_.erase(it);
-    } else {
-      ++it;
+void TextureManager::SetStreamingSettings(
+    const MipResidency::Settings &settings) {
+  std::lock_guard<std::mutex> lock(streamingMutex_);
+  residency_.SetSettings(settings);
+}
+
+void TextureManager::ReportUsage(const TextureResource *texture,
+                                 float screenPixels) {
+  if (!texture || !texture->IsStreaming()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(streamingMutex_);
+  auto it = streamingIds_.find(texture);
+  if (it == streamingIds_.end() || streamed_[it->second].texture.expired()) {
+    return;
+  }
+  const TextureCache::Info &info = texture->GetStreamingInfo();
+  const uint32_t mip = MipResidency::ComputeDesiredMip(
+      info.width, info.height, info.mipCount, screenPixels);
+  residency_.Request(it->second, mip, dx_->GetFramePacer().GetFrameNumber());
+}
+
+void TextureManager::UpdateStreaming() {
+  if (!dx_) {
+    return;
+  }
+  // 大きさが変わったテクスチャ（cache_ の予算に反映するまで手放さない）
+  std::vector<std::pair<std::string, std::shared_ptr<TextureResource>>> resized;
+  {
+    std::lock_guard<std::mutex> lock(streamingMutex_);
+
+    // 破棄されたテクスチャを外す
+    for (MipResidency::Id id = 0; id < streamed_.size(); ++id) {
+      if (streamed_[id].texture.expired() && residency_.IsRegistered(id)) {
+        residency_.Unregister(id);
+      }
+    }
+    for (auto it = streamingIds_.begin(); it != streamingIds_.end();) {
+      if (streamed_[it->second].texture.expired()) {
+        it = streamingIds_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    streamingChanges_.clear();
+    residency_.Update(dx_->GetFramePacer().GetFrameNumber(), streamingChanges_);
+    for (const MipResidency::Change &change : streamingChanges_) {
+      if (auto tex = streamed_[change.id].texture.lock()) {
+        if (!tex->SetResidentMip(dx_, change.residentMip)) {
+          OutputDebugStringA("[TextureManager] SetResidentMip failed\n");
+        }
+        resized.emplace_back(streamed_[change.id].path, std::move(tex));
+      }
     }
   }
+
+  // 追い出し（Trim）がテクスチャを破棄しても streamingMutex_ を持っていないように外で
+  for (const auto &[path, tex] : resized) {
+    cache_.UpdateBytes(path, tex.get(), tex->GetGpuBytes());
+  }
+}
+
+MipResidency::Stats TextureManager::GetStreamingStats() const {
+  std::lock_guard<std::mutex> lock(streamingMutex_);
+  return residency_.GetStats();
 }
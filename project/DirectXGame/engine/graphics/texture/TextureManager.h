@@ -1,11 +1,24 @@
 #pragma once
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include "AssetFuture.h"
+#include "ConcurrentAssetCache.h"
+#include "MipResidency.h"
+#include "TextureAtlas.h"
 
 class DirectXCommon;
+class MappedFile;
 class TextureResource;
 
+namespace DirectX {
+    class ScratchImage;
+} // namespace DirectX
+
 class TextureManager {
 public:
     static TextureManager* GetInstance() {
@@ -15,12 +28,94 @@ public:
 
     void Initialize(DirectXCommon* dx) { dx_ = dx; }
 
+    // LoadAsync で読み込み中のパスなら、その完了を待って同じ結果を返す
+    // （AssetLoadQueue の仕上げの中からは、読み込み中のパスに対して呼ばないこと）
     std::shared_ptr<TextureResource> Load(const std::string& path);
+
+    // 読み込み・デコード・ミップ生成はワーカーで、GPU への転送は
+    // AssetLoadQueue::Pump（描画スレッド）で行う。完了までは白 1x1 を返す
+    // 描画スレッドから呼ぶこと
+    AssetFuture<TextureResource> LoadAsync(const std::string& path);
+
+    // 読み込み中・失敗時の代わり（白 1x1）
+    std::shared_ptr<TextureResource> GetPlaceholder();
+
+    // どこからも使われていないテクスチャを予算に関係なく手放す
     void ClearUnused();
 
+    // テクスチャ（VRAM）の合計の上限（超えたら未使用のものを古い順に手放す）
+    void SetCacheBudget(uint64_t bytes) { cache_.SetBudget(bytes); }
+    static constexpr uint64_t kDefaultCacheBudget = 512ull << 20;
+    // 固定したテクスチャは使われていなくても手放さない
+    void Pin(const std::string& path, bool pinned = true) {
+        cache_.Pin(path, pinned);
+    }
+
+    ConcurrentAssetCache<TextureResource>::Stats GetCacheStats() const {
+        return cache_.GetStats();
+    }
+
+    // ---- ミップのストリーミング ----
+    // 長い辺が kStreamingTailSize を超えるテクスチャは、小さいミップだけで作って先に使えるようにし、
+    // 描画側の ReportUsage（画面上の大きさ）に応じて UpdateStreaming で細かいミップを足す。
+    // 常駐ミップの合計が予算を超えたら、使われていない・必要以上に細かいものから削る
+    // 対象は変換済みキャッシュ（TextureCache）のある画像だけ（DDS は全ミップを置く）
+    static constexpr uint32_t kStreamingTailSize = 128;
+    void SetStreamingEnabled(bool enabled) { streamingEnabled_ = enabled; }
+    void SetStreamingSettings(const MipResidency::Settings& settings);
+
+    // 描画時に呼ぶ: texture が画面上で長い辺 screenPixels ピクセルほどに映る
+    // （ストリーミングしていないテクスチャなら何もしない）
+    void ReportUsage(const TextureResource* texture, float screenPixels);
+
+    // 毎フレーム 1 回、描画コマンドを記録する前に描画スレッドから呼ぶ
+    void UpdateStreaming();
+
+    MipResidency::Stats GetStreamingStats() const;
+
+    // ---- アトラス ----
+    // 登録したアトラスに載っているパスは、Sprite / ParticleManager がアトラスのページを使う
+    // （登録より前に作ったものは元のテクスチャのまま）。Load は従来通り個別のテクスチャを返す
+    void RegisterAtlas(std::shared_ptr<TextureAtlas> atlas);
+    void UnregisterAtlas(const std::string& name);
+    // 後に登録したアトラスを優先する。載っていなければ false
+    bool FindAtlasRegion(const std::string& path, TextureAtlas::Region& out) const;
+
 private:
-    TextureManager() = default;
+    TextureManager() { cache_.SetBudget(kDefaultCacheBudget); }
+
+    // ワーカーで用意する元データ
+    // ストリーミングするならマップしたキャッシュだけ、しないなら展開した画像
+    struct Source_ {
+        std::shared_ptr<const MappedFile> cache;
+        uint32_t tailMip = 0;
+        std::shared_ptr<DirectX::ScratchImage> image;
+    };
+    Source_ LoadSource_(const std::string& path) const;
+    // 描画スレッドで GPU に作る（ストリーミングなら path で登録する）。失敗なら nullptr
+    std::shared_ptr<TextureResource> CreateTexture_(const std::string& path,
+                                                    const Source_& source);
 
     DirectXCommon* dx_ = nullptr;
-    std::unordered_map<std::string, std::weak_ptr<TextureResource>> cache_;
+    // 読み込み中も登録する（同じパスの Load / LoadAsync は 1 回の読み込みを共有する）
+    // 使われなくなっても予算内なら残す（シーンを跨いだ再読み込みを避ける）
+    ConcurrentAssetCache<TextureResource> cache_{
+        ConcurrentAssetCache<TextureResource>::Ownership::Strong};
+    std::shared_ptr<TextureResource> placeholder_;
+
+    // ストリーミング中のテクスチャ（破棄されたものは UpdateStreaming で外す）
+    mutable std::mutex streamingMutex_;
+    std::atomic<bool> streamingEnabled_ = true; // LoadSource_ はワーカーで読む
+    MipResidency residency_;
+    std::unordered_map<const TextureResource*, MipResidency::Id> streamingIds_;
+    // MipResidency::Id の順。path は cache_ のキー（常駐ミップが変わったら大きさを直す）
+    struct Streamed_ {
+        std::weak_ptr<TextureResource> texture;
+        std::string path;
+    };
+    std::vector<Streamed_> streamed_;
+    std::vector<MipResidency::Change> streamingChanges_;
+
+    mutable std::mutex atlasMutex_;
+    std::vector<std::shared_ptr<TextureAtlas>> atlases_;
 };
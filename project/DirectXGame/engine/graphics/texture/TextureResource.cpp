@@ -1,10 +1,14 @@
 #include "TextureResource.h"
 
 #include <Windows.h>
+#include <algorithm>
 #include <filesystem>
 #include <string>
+#include <vector>
 
 #include "DirectXCommon.h"
+#include "DirectXResourceUtils.h"
+#include "MappedFile.h"
 #include "SrvAllocator.h"
 #include "TextureUtils.h"
 #include "externals/DirectXTex/DirectXTex.h"
@@ -61,13 +65,17 @@ bool TextureResource::CreateFromMetadata(DirectXCommon *dx,
     TexResLog_("[TextureResource] CreateTextureResource failed");
     return false;
   }
+  const D3D12_RESOURCE_DESC textureDesc = texture_->GetDesc();
+  gpuBytes_ = device->GetResourceAllocationInfo(0, 1, &textureDesc).SizeInBytes;
 
-  intermediateResource_ =
+  // 転送元はコピーが GPU で終わったら要らない（テクスチャと同じ大きさなので持ち続けない）
+  ComPtr<ID3D12Resource> intermediate =
       UploadTextureData(texture_, mipImages, device, commandList);
-  if (!intermediateResource_) {
+  if (!intermediate) {
     TexResLog_("[TextureResource] UploadTextureData failed");
     return false;
   }
+  dx->DeferRelease(std::move(intermediate));
 
   D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
   srvDesc.Format = meta.format;
@@ -131,4 +139,145 @@ bool TextureResource::CreateSrv_(DirectXCommon *dx,
   srv_ = SrvHandle(&alloc, index);
   srvGpu_ = alloc.Gpu(index);
   return true;
-}
\ No newline at end of file
+}
+
+uint32_t TextureResource::ComputeTailMip(const TextureCache::Info &info,
+                                        uint32_t tailSize) {
+  const bool compressed =
+      DirectX::IsCompressed(static_cast<DXGI_FORMAT>(info.dxgiFormat));
+  uint32_t mip = 0;
+  while (mip + 1 < info.mipCount) {
+    const uint32_t w = info.width >> mip;
+    const uint32_t h = info.height >> mip;
+    if ((std::max)(w, h) <= tailSize) {
+      break;
+    }
+    // BC は作り直したテクスチャのミップ 0 も 4 の倍数でないと作れない
+    const uint32_t nw = info.width >> (mip + 1);
+    const uint32_t nh = info.height >> (mip + 1);
+    if (compressed && (nw % 4 != 0 || nh % 4 != 0 || nw == 0 || nh == 0)) {
+      break;
+    }
+    ++mip;
+  }
+  return mip;
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource>
+TextureResource::CreateStreamingTexture_(DirectXCommon *dx,
+                                         uint32_t residentMip) const {
+  DirectX::TexMetadata meta{};
+  meta.width = (std::max)(streamingInfo_.width >> residentMip, 1u);
+  meta.height = (std::max)(streamingInfo_.height >> residentMip, 1u);
+  meta.depth = 1;
+  meta.arraySize = 1;
+  meta.mipLevels = streamingInfo_.mipCount - residentMip;
+  meta.format = static_cast<DXGI_FORMAT>(streamingInfo_.dxgiFormat);
+  meta.dimension = DirectX::TEX_DIMENSION_TEXTURE2D;
+  return CreateTextureResource(
+      Microsoft::WRL::ComPtr<ID3D12Device>(dx->GetDevice()), meta);
+}
+
+bool TextureResource::CreateStreaming(DirectXCommon *dx,
+                                     std::shared_ptr<const MappedFile> cache,
+                                     uint32_t residentMip) {
+  // キャッシュは常に 1 枚の 2D テクスチャ
+  if (!dx || !cache || !cache->IsOpen()) {
+    TexResLog_("[TextureResource] CreateStreaming: invalid arguments");
+    return false;
+  }
+
+  streamingInfo_ = TextureCache::GetInfo(*cache);
+  cache_ = std::move(cache);
+  // 最初は何も置いていない扱いにして、SetResidentMip で全体を転送する
+  residentMip_ = streamingInfo_.mipCount;
+  return SetResidentMip(dx, (std::min)(residentMip, residentMip_ - 1));
+}
+
+bool TextureResource::SetResidentMip(DirectXCommon *dx, uint32_t residentMip) {
+  if (!dx || !cache_) {
+    return false;
+  }
+  const uint32_t mipLevels = streamingInfo_.mipCount;
+  if (residentMip >= mipLevels) {
+    return false;
+  }
+  if (residentMip == residentMip_ && texture_) {
+    return true;
+  }
+
+  ID3D12Device *device = dx->GetDevice();
+  ID3D12GraphicsCommandList *commandList = dx->GetCommandList();
+  ComPtr<ID3D12Resource> texture = CreateStreamingTexture_(dx, residentMip);
+  if (!texture) {
+    TexResLog_("[TextureResource] SetResidentMip: CreateTextureResource failed");
+    return false;
+  }
+
+  // 今あるミップは古いテクスチャから写す（GENERIC_READ はコピー元を含むので遷移は不要）
+  const uint32_t keepFirst = (std::max)(residentMip, residentMip_);
+  if (texture_) {
+    for (uint32_t mip = keepFirst; mip < mipLevels; ++mip) {
+      D3D12_TEXTURE_COPY_LOCATION dst{};
+      dst.pResource = texture.Get();
+      dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+      dst.SubresourceIndex = mip - residentMip;
+      D3D12_TEXTURE_COPY_LOCATION src{};
+      src.pResource = texture_.Get();
+      src.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+      src.SubresourceIndex = mip - residentMip_;
+      commandList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+    }
+  }
+
+  // 足りないミップ [residentMip, keepFirst) はキャッシュのマップから転送する
+  // （読まれていないページはここでファイルから読まれる）
+  if (residentMip < keepFirst) {
+    std::vector<D3D12_SUBRESOURCE_DATA> subresources;
+    subresources.reserve(keepFirst - residentMip);
+    for (uint32_t mip = residentMip; mip < keepFirst; ++mip) {
+      TextureCache::MipView view{};
+      TextureCache::GetMip(*cache_, mip, view); // mip < mipLevels なので必ず取れる
+      D3D12_SUBRESOURCE_DATA subresource{};
+      subresource.pData = view.data;
+      subresource.RowPitch = static_cast<LONG_PTR>(view.rowPitch);
+      subresource.SlicePitch = static_cast<LONG_PTR>(view.size);
+      subresources.push_back(subresource);
+    }
+    const UINT64 intermediateSize = GetRequiredIntermediateSize(
+        texture.Get(), 0, static_cast<UINT>(subresources.size()));
+    ComPtr<ID3D12Resource> intermediate = CreateBufferResource(
+        ComPtr<ID3D12Device>(device), static_cast<size_t>(intermediateSize));
+    UpdateSubresources(commandList, texture.Get(), intermediate.Get(), 0, 0,
+                       static_cast<UINT>(subresources.size()),
+                       subresources.data());
+    dx->DeferRelease(std::move(intermediate));
+  }
+
+  D3D12_RESOURCE_BARRIER barrier{};
+  barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+  barrier.Transition.pResource = texture.Get();
+  barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+  barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+  barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
+  commandList->ResourceBarrier(1, &barrier);
+
+  // 古いテクスチャと SRV は、それを使ったフレームが GPU で終わるまで残す
+  dx->DeferRelease(std::move(texture_));
+  if (srv_.IsValid()) {
+    auto oldSrv = std::make_shared<SrvHandle>(std::move(srv_));
+    dx->GetFramePacer().DeferRelease([oldSrv]() mutable { oldSrv.reset(); });
+  }
+
+  texture_ = std::move(texture);
+  residentMip_ = residentMip;
+  const D3D12_RESOURCE_DESC textureDesc = texture_->GetDesc();
+  gpuBytes_ = device->GetResourceAllocationInfo(0, 1, &textureDesc).SizeInBytes;
+
+  D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+  srvDesc.Format = static_cast<DXGI_FORMAT>(streamingInfo_.dxgiFormat);
+  srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+  srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+  srvDesc.Texture2D.MipLevels = mipLevels - residentMip;
+  return CreateSrv_(dx, srvDesc);
+}
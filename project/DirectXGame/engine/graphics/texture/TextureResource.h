@@ -3,9 +3,12 @@
 #include <d3d12.h>
 #include <wrl.h>
 
+#include <cstdint>
+#include <memory>
 #include <string>
 
 #include "SrvHandle.h"
+#include "TextureCache.h"
 
 namespace DirectX {
     class ScratchImage;
@@ -13,27 +16,60 @@ namespace DirectX {
 } // namespace DirectX
 
 class DirectXCommon;
+class MappedFile;
 
 // Texture2D + SRV を RAII で管理する
 // - ID3D12Resource は ComPtr
 // - SRV の index は SrvHandle が解放する
+// - 転送元（アップロード用の一時バッファ）はコピーを積んだフレームが GPU で
+//   終わったら解放する（DirectXCommon::DeferRelease）
+// - ストリーミング（CreateStreaming）では residentMip 以降のミップだけを VRAM に置き、
+//   SetResidentMip でテクスチャごと作り直す。SRV の番号も変わるので、
+//   GetSrvGpu は描画のたびに取り直すこと
+// - ストリーミングの元はマップした変換済みキャッシュ（TextureCache）で、CPU 側に
+//   ミップのコピーは持たない（足りないミップはその都度マップから読む）
 class TextureResource {
 public:
     bool CreateFromFile(DirectXCommon* dx, const std::string& filePath);
     bool CreateFromMetadata(DirectXCommon* dx, const DirectX::ScratchImage& mipImages,
         const DirectX::TexMetadata& meta);
 
+    // cache は TextureCache::Open に成功したもの。細かいミップを後から読むために保持する
+    bool CreateStreaming(DirectXCommon* dx,
+        std::shared_ptr<const MappedFile> cache, uint32_t residentMip);
+    // 置くミップを変える（重なるミップは GPU 上で写し、足りないミップはキャッシュから転送）
+    // 描画スレッドから、メインのコマンドリストが記録中の時に呼ぶこと
+    bool SetResidentMip(DirectXCommon* dx, uint32_t residentMip);
+
+    // BC 形式でも作れる（ミップ 0 が 4 の倍数になる）範囲で、長い辺が
+    // tailSize 以下になる一番細かいミップ。ストリーミングの最初の residentMip に使う
+    static uint32_t ComputeTailMip(const TextureCache::Info& info, uint32_t tailSize);
+
     ID3D12Resource* GetResource() const { return texture_.Get(); }
     D3D12_GPU_DESCRIPTOR_HANDLE GetSrvGpu() const { return srvGpu_; }
+    // テクスチャ本体が占める VRAM（ミップ込み）
+    uint64_t GetGpuBytes() const { return gpuBytes_; }
+
+    bool IsStreaming() const { return cache_ != nullptr; }
+    uint32_t GetResidentMip() const { return residentMip_; }
+    // ストリーミング時の全体（ミップ 0 から）の形式と大きさ
+    const TextureCache::Info& GetStreamingInfo() const { return streamingInfo_; }
 
 private:
     bool CreateSrv_(DirectXCommon* dx, const D3D12_SHADER_RESOURCE_VIEW_DESC& desc);
+    // residentMip 以降のミップを持つテクスチャを作る（COPY_DEST）
+    Microsoft::WRL::ComPtr<ID3D12Resource> CreateStreamingTexture_(
+        DirectXCommon* dx, uint32_t residentMip) const;
 
 private:
     template <class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
 
     ComPtr<ID3D12Resource> texture_;
-    ComPtr<ID3D12Resource> intermediateResource_;
     SrvHandle srv_;
     D3D12_GPU_DESCRIPTOR_HANDLE srvGpu_{};
+    uint64_t gpuBytes_ = 0;
+
+    std::shared_ptr<const MappedFile> cache_;
+    TextureCache::Info streamingInfo_{};
+    uint32_t residentMip_ = 0;
 };
@@ -1,5 +1,7 @@
 #include "TextureUtils.h"
 #include "DirectXResourceUtils.h"
+#include "GpuMemoryAllocator.h"
+#include "TextureCooker.h"
 
 #include <Windows.h>
 #include <cassert>
@@ -39,10 +41,8 @@ std::string ConvertString(const std::wstring &str) {
   return result;
 }
 
-DirectX::ScratchImage LoadTexture(const std::string &filePath) {
-  using namespace std;
+std::filesystem::path ResolveTexturePath(const std::string &filePath) {
   using namespace std::filesystem;
-  DirectX::ScratchImage mipImages{};
 
   // exe と同じフォルダからの絶対パスに直す
   wchar_t exePathW[MAX_PATH]{};
@@ -61,33 +61,42 @@ DirectX::ScratchImage LoadTexture(const std::string &filePath) {
   }
 
   if (!exists(candidate)) {
+    return path();
+  }
+  return candidate;
+}
+
+DirectX::ScratchImage LoadTexture(const std::string &filePath) {
+  using namespace std;
+  using namespace std::filesystem;
+  DirectX::ScratchImage mipImages{};
+
+  const path candidate = ResolveTexturePath(filePath);
+  if (candidate.empty()) {
     std::string msg = "LoadTexture: file NOT found: " + filePath + "\n";
     OutputDebugStringA(msg.c_str());
     // 失敗時は空の画像を返す（assertで止めたいならここでassertでもOK）
     return mipImages;
   }
 
-  DirectX::ScratchImage image{};
-  HRESULT hr;
-  // 拡張子でDDSかどうかを判断して読み込み方法を変える
-  if (candidate.extension() == L".dds" || candidate.extension() == L".DDS") {
-    hr = DirectX::LoadFromDDSFile(candidate.c_str(), DirectX::DDS_FLAGS_NONE,
-                                  nullptr, image);
-    if (FAILED(hr)) {
-      std::string msg =
-          "LoadTexture: LoadFromDDSFile failed: " + filePath + "\n";
-      OutputDebugStringA(msg.c_str());
-      return mipImages;
-    }
-  } else {
-    hr = DirectX::LoadFromWICFile(
-        candidate.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
-    if (FAILED(hr)) {
-      std::string msg =
-          "LoadTexture: LoadFromWICFile failed: " + filePath + "\n";
+  // DDS 以外は変換済みのキャッシュ（BCn + ミップ）を使う。無ければここで作る
+  if (candidate.extension() != L".dds" && candidate.extension() != L".DDS") {
+    mipImages = TextureCooker::LoadOrCook(
+        candidate, TextureCooker::GuessUsage(filePath));
+    if (mipImages.GetImageCount() == 0) {
+      std::string msg = "LoadTexture: cook failed: " + filePath + "\n";
       OutputDebugStringA(msg.c_str());
-      return mipImages;
     }
+    return mipImages;
+  }
+
+  DirectX::ScratchImage image{};
+  HRESULT hr = DirectX::LoadFromDDSFile(
+      candidate.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, image);
+  if (FAILED(hr)) {
+    std::string msg = "LoadTexture: LoadFromDDSFile failed: " + filePath + "\n";
+    OutputDebugStringA(msg.c_str());
+    return mipImages;
   }
 
   // 圧縮フォーマットかどうか調べる
@@ -108,6 +117,16 @@ DirectX::ScratchImage LoadTexture(const std::string &filePath) {
   return mipImages;
 }
 
+bool OpenCookedTexture(const std::string &filePath, MappedFile &out) {
+  const std::filesystem::path candidate = ResolveTexturePath(filePath);
+  if (candidate.empty() || candidate.extension() == L".dds" ||
+      candidate.extension() == L".DDS") {
+    return false;
+  }
+  return TextureCooker::OpenOrCook(candidate,
+                                   TextureCooker::GuessUsage(filePath), out);
+}
+
 ComPtr<ID3D12Resource>
 CreateTextureResource(const ComPtr<ID3D12Device> &device,
                       const DirectX::TexMetadata &metadata) {
@@ -120,6 +139,12 @@ CreateTextureResource(const ComPtr<ID3D12Device> &device,
   resourceDesc.SampleDesc.Count = 1;
   resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION(metadata.dimension);
 
+  auto *allocator = GpuMemoryAllocator::GetInstance();
+  if (allocator->IsInitialized()) {
+    return allocator->CreateTexture(resourceDesc,
+                                    D3D12_RESOURCE_STATE_COPY_DEST);
+  }
+
   D3D12_HEAP_PROPERTIES heapProperties{};
   heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
   heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
@@ -1,6 +1,7 @@
 #pragma once
 #include "externals/DirectXTex/DirectXTex.h"
 #include "externals/DirectXTex/d3dx12.h"
+#include <filesystem>
 #include <string>
 #include <vector>
 #include <wrl.h>
@@ -11,8 +12,16 @@ template <class T> using ComPtr = Microsoft::WRL::ComPtr<T>;
 std::wstring ConvertString(const std::string &str);
 std::string ConvertString(const std::wstring &str);
 
+// exe のフォルダ（無ければプロジェクト直下）から探した絶対パス。見つからなければ空
+std::filesystem::path ResolveTexturePath(const std::string &filePath);
+
 DirectX::ScratchImage LoadTexture(const std::string &filePath);
 
+class MappedFile;
+// DDS 以外の画像の変換済みキャッシュ（TextureCache）をマップする（無ければ作る）
+// DDS・見つからない・キャッシュを書けない時は false（LoadTexture を使うこと）
+bool OpenCookedTexture(const std::string &filePath, MappedFile &out);
+
 ComPtr<ID3D12Resource>
 CreateTextureResource(const Microsoft::WRL::ComPtr<ID3D12Device> &device,
                       const DirectX::TexMetadata &metadata);
@@ -23,6 +23,8 @@ public:
 
   void RequestChange(const std::string &nextSceneId);
   void ApplySceneChangeIfNeeded();
+  // 次の ApplySceneChangeIfNeeded でシーンが入れ替わるか
+  bool HasPendingChange() const { return hasPendingChange_; }
 
   const SceneServices &GetServices() const { return services_; }
 
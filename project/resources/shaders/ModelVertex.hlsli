@@ -0,0 +1,35 @@
+// ModelResource の頂点入力（PipelineDesc::shaderDefines の PACKED_VERTEX で切り替え）
+// VertexPacking.h の PackedVertex / ModelUtils.h の VertexData と並びを一致させる
+struct ModelVertexInput
+{
+#ifdef PACKED_VERTEX
+    // R16G16B16A16_UNORM: メッシュの範囲で正規化（w = 1）。逆量子化は World/WVP に畳み込み済み
+    float4 position : POSITION0;
+    // R16G16_FLOAT
+    float2 texcoord : TEXCOORD0;
+    // R16G16_SNORM: 八面体エンコード
+    float2 normal : NORMAL0;
+#else
+    float4 position : POSITION0;
+    float2 texcoord : TEXCOORD0;
+    float3 normal : NORMAL0;
+#endif
+#ifdef SKINNED
+    // スロット 1（ModelData.h の VertexInfluence）。重みの合計は 1
+    uint4 joints : BLENDINDICES0;
+    float4 weights : BLENDWEIGHT0;
+#endif
+};
+
+float3 DecodeModelNormal(ModelVertexInput input)
+{
+#ifdef PACKED_VERTEX
+    float3 n = float3(input.normal, 1.0f - abs(input.normal.x) - abs(input.normal.y));
+    float t = saturate(-n.z);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return normalize(n);
+#else
+    return input.normal;
+#endif
+}
@@ -1,7 +1,5 @@
 #include "object3d.hlsli"
-#define MAX_POINT_LIGHTS 16
-#define MAX_DIR_LIGHTS   4
-#define MAX_SPOT_LIGHTS  8
+#include "Object3dLighting.hlsli"
 
 struct Material
 {
@@ -13,78 +11,9 @@ struct Material
     float3 pad;
 };
 
-struct Camera
-{
-    float3 worldPosition;
-    float pad;
-};
-
-struct DirectionalLight
-{
-    float4 color; // ライトの色
-    float3 direction; // ライトの向き
-    float intensity; // 輝度
-    int enabled; // 0:OFF 1:ON
-    float3 pad0; // 16byte境界
-};
-
-struct DirectionalLightGroup
-{
-    int count;
-    float3 padCount;
-    DirectionalLight lights[MAX_DIR_LIGHTS];
-    int enabled;
-    float3 padEnabled; // 16byte境界
-};
-
-struct PointLight
-{
-    float4 color; // ライトの色
-    float3 position; // ライトの位置（コメント修正しておくと良い）
-    float intensity; // 輝度
-    float radius; // 光の届く最大距離
-    float decay; // 減衰率
-    int enabled; // 0:OFF 1:ON
-    float pad0; // 16byte境界
-};
-
-struct PointLightGroup
-{
-    int count;
-    float3 padCount; // 16byte境界
-    PointLight lights[MAX_POINT_LIGHTS];
-    int enabled; // 0:OFF 1:ON
-};
-
-struct SpotLight
-{
-    float4 color; // ライトの色
-    float3 position; // ライトの位置
-    float intensity; // 輝度
-    float3 direction; // ライトの向き
-    float distance; // 光の届く最大距離
-    float decay; // 減衰率
-    float cosAngle; // 内側の角度
-    int enabled; // 0:OFF 1:ON
-    float pad0; // 16byte境界
-};
-
-struct SpotLightGroup
-{
-    int count;
-    float3 padCount;
-    SpotLight lights[MAX_SPOT_LIGHTS];
-    int enabled;
-    float3 padEnabled; // 16byte境界
-};
-
 ConstantBuffer<Material> gMaterial : register(b0);
 Texture2D<float4> gTexture : register(t0);
 SamplerState gSampler : register(s0);
-ConstantBuffer<DirectionalLightGroup> gDirectionalLights : register(b1);
-ConstantBuffer<Camera> gCamera : register(b2);
-ConstantBuffer<PointLightGroup> gPointLights : register(b3);
-ConstantBuffer<SpotLightGroup> gSpotLights : register(b4);
 
 struct PixelShaderOutput
 {
@@ -125,134 +54,9 @@ PixelShaderOutput main(VertexShaderOutput input)
         return output;
     }
 
-    float dirGroupOn = (gDirectionalLights.enabled != 0) ? 1.0f : 0.0f;
-    float pointGroupOn = (gPointLights.enabled != 0) ? 1.0f : 0.0f;
-    float spotGroupOn = (gSpotLights.enabled != 0) ? 1.0f : 0.0f;
-
-    float3 N = normalize(input.normal);
-    float3 V = normalize(gCamera.worldPosition - input.worldPosition);
-
-    float3 diffuseSum = float3(0.0f, 0.0f, 0.0f);
-    float3 specularSum = float3(0.0f, 0.0f, 0.0f);
-
-    // ===== Directional Lights (multiple) =====
-    int dCount = min(gDirectionalLights.count, MAX_DIR_LIGHTS);
-
-    [loop]
-    for (int i = 0; i < dCount; ++i)
-    {
-        DirectionalLight dl = gDirectionalLights.lights[i];
-        if (dl.enabled == 0)
-            continue;
-
-        float3 Ld = normalize(-dl.direction); // 面→光
-        float diff = (gMaterial.enableLighting == 1)
-            ? saturate(dot(N, Ld))
-            : pow(saturate(dot(N, Ld) * 0.5f + 0.5f), 2.0f);
-
-        diffuseSum +=
-            gMaterial.color.rgb * textureColor.rgb *
-            diff *
-            dl.color.rgb * dl.intensity * dirGroupOn;
-
-        if (gMaterial.shininess > 0.0f)
-        {
-            float3 H = normalize(Ld + V);
-            float specPow = pow(saturate(dot(N, H)), gMaterial.shininess);
-
-            specularSum +=
-                dl.color.rgb * dl.intensity *
-                gMaterial.specularColor *
-                specPow * dirGroupOn;
-        }
-    }
-
-    // ===== Point Lights (multiple) =====
-    int pCount = min(gPointLights.count, MAX_POINT_LIGHTS);
-
-    [loop]
-    for (int i = 0; i < pCount; ++i)
-    {
-        PointLight pl = gPointLights.lights[i];
-        if (pl.enabled == 0)
-            continue;
-
-        float3 L = pl.position - input.worldPosition; // 面→点光源
-        float dist = length(L);
-        float3 Ldir = (dist > 0.0001f) ? (L / dist) : float3(0.0f, 1.0f, 0.0f);
-
-        float attenuation = pow(saturate(-dist / pl.radius + 1.0f), pl.decay);
-
-        float ndotl = dot(N, Ldir);
-        float diff = (gMaterial.enableLighting == 1)
-            ? saturate(ndotl)
-            : pow(saturate(ndotl * 0.5f + 0.5f), 2.0f);
-
-        diffuseSum +=
-            gMaterial.color.rgb * textureColor.rgb *
-            diff *
-            pl.color.rgb * pl.intensity *
-            attenuation * pointGroupOn;
-
-        if (gMaterial.shininess > 0.0f)
-        {
-            float3 H = normalize(Ldir + V);
-            float specPow = pow(saturate(dot(N, H)), gMaterial.shininess);
-
-            specularSum +=
-                pl.color.rgb * pl.intensity *
-                gMaterial.specularColor *
-                specPow *
-                attenuation * pointGroupOn;
-        }
-    }
-
-    // ===== Spot Lights (multiple) =====
-    int sCount = min(gSpotLights.count, MAX_SPOT_LIGHTS);
-
-    [loop]
-    for (int i = 0; i < sCount; ++i)
-    {
-        SpotLight sl = gSpotLights.lights[i];
-        if (sl.enabled == 0)
-            continue;
-
-        float3 Lvec = sl.position - input.worldPosition; // 面→ライト
-        float dist = length(Lvec);
-        float3 Ldir = (dist > 0.0001f) ? (Lvec / dist) : float3(0.0f, 1.0f, 0.0f);
-
-        float attenuation = pow(saturate(-dist / sl.distance + 1.0f), sl.decay);
-
-        float3 lightToSurfaceDir = normalize(input.worldPosition - sl.position); // ライト→面
-        float cosTheta = dot(lightToSurfaceDir, normalize(sl.direction));
-
-        float falloff = saturate((cosTheta - sl.cosAngle) / (1.0f - sl.cosAngle));
-
-        float ndotl = dot(N, Ldir);
-        float diff = (gMaterial.enableLighting == 1)
-            ? saturate(ndotl)
-            : pow(saturate(ndotl * 0.5f + 0.5f), 2.0f);
-
-        diffuseSum +=
-            gMaterial.color.rgb * textureColor.rgb *
-            diff *
-            sl.color.rgb * sl.intensity *
-            attenuation * falloff * spotGroupOn;
-
-        if (gMaterial.shininess > 0.0f)
-        {
-            float3 H = normalize(Ldir + V);
-            float specPow = pow(saturate(dot(N, H)), gMaterial.shininess);
-
-            specularSum +=
-                sl.color.rgb * sl.intensity *
-                gMaterial.specularColor *
-                specPow *
-                attenuation * falloff * spotGroupOn;
-        }
-    }
-
-    float3 finalRGB = diffuseSum + specularSum;
+    float3 finalRGB = ComputeLighting(
+        gMaterial.color.rgb * textureColor.rgb, input.normal, input.worldPosition,
+        gMaterial.enableLighting, gMaterial.specularColor, gMaterial.shininess);
     output.color = float4(finalRGB, alpha);
     return output;
 }
\ No newline at end of file
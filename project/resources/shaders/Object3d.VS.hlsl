@@ -1,4 +1,5 @@
 #include "object3d.hlsli"
+#include "ModelVertex.hlsli"
 
 struct TransformationMatrix
 {
@@ -9,23 +10,32 @@ struct TransformationMatrix
 
 ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
 
-struct VertexShaderInput
-{
-    float4 position : POSITION0;
-    float2 texcoord : TEXCOORD0;
-    float3 normal : NORMAL0;
-};
+#ifdef SKINNED
+// Animator::GetSkinMatrices（ModelData::joints の並び）。Skinning.cpp と同じ計算
+StructuredBuffer<float4x4> gSkinMatrices : register(t1);
+#endif
 
-VertexShaderOutput main(VertexShaderInput input)
+VertexShaderOutput main(ModelVertexInput input)
 {
     VertexShaderOutput output;
 
-    output.position = mul(input.position, gTransformationMatrix.WVP);
+    float4 position = input.position;
+    float3 normal = DecodeModelNormal(input);
+#ifdef SKINNED
+    float4x4 skin = gSkinMatrices[input.joints.x] * input.weights.x +
+                    gSkinMatrices[input.joints.y] * input.weights.y +
+                    gSkinMatrices[input.joints.z] * input.weights.z +
+                    gSkinMatrices[input.joints.w] * input.weights.w;
+    position = mul(position, skin);
+    normal = normalize(mul(normal, (float3x3) skin));
+#endif
+
+    output.position = mul(position, gTransformationMatrix.WVP);
     output.texcoord = input.texcoord;
     
-    output.normal = normalize(mul(input.normal, (float3x3) gTransformationMatrix.WorldInverseTranspose));
+    output.normal = normalize(mul(normal, (float3x3) gTransformationMatrix.WorldInverseTranspose));
 
-    float4 worldPos4 = mul(input.position, gTransformationMatrix.World);
+    float4 worldPos4 = mul(position, gTransformationMatrix.World);
     output.worldPosition = worldPos4.xyz;
 
     return output;
@@ -0,0 +1,36 @@
+#include "Object3dInstanced.hlsli"
+#include "Object3dLighting.hlsli"
+
+Texture2D<float4> gTexture : register(t0);
+SamplerState gSampler : register(s0);
+
+struct PixelShaderOutput
+{
+    float4 color : SV_TARGET0;
+};
+
+PixelShaderOutput main(InstancedVertexShaderOutput input)
+{
+    PixelShaderOutput output;
+
+    float4 textureColor = gTexture.Sample(gSampler, input.texcoord);
+
+    if (textureColor.a <= 0.5f)
+        discard;
+
+    float alpha = input.color.a * textureColor.a;
+    if (alpha <= 0.0f)
+        discard;
+
+    if (input.enableLighting == 0)
+    {
+        output.color = float4(input.color.rgb * textureColor.rgb, alpha);
+        return output;
+    }
+
+    float3 finalRGB = ComputeLighting(
+        input.color.rgb * textureColor.rgb, input.normal, input.worldPosition,
+        input.enableLighting, input.specular.xyz, input.specular.w);
+    output.color = float4(finalRGB, alpha);
+    return output;
+}
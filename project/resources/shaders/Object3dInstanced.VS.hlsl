@@ -0,0 +1,41 @@
+#include "Object3dInstanced.hlsli"
+#include "ModelVertex.hlsli"
+
+// InstanceBatchBuilder.h の InstanceDataGPU と並びを一致させる
+struct InstanceData
+{
+    float4x4 WVP;
+    float4x4 World;
+    float4x4 WorldInverseTranspose;
+    float4x4 uvTransform;
+    float4 color;
+    float3 specularColor;
+    float shininess;
+    int enableLighting;
+    float3 pad;
+};
+
+StructuredBuffer<InstanceData> gInstances : register(t1);
+
+// SV_InstanceID は 0 から始まるので、バッチの先頭位置を足して参照する
+cbuffer InstanceBase : register(b1)
+{
+    uint gInstanceBase;
+};
+
+InstancedVertexShaderOutput main(ModelVertexInput input, uint instanceId : SV_InstanceID)
+{
+    InstanceData inst = gInstances[gInstanceBase + instanceId];
+
+    InstancedVertexShaderOutput output;
+    output.position = mul(input.position, inst.WVP);
+    // uvTransform はアフィンなので頂点で掛けても結果は同じ
+    output.texcoord = mul(float4(input.texcoord, 0.0f, 1.0f), inst.uvTransform).xy;
+    output.normal = normalize(mul(DecodeModelNormal(input), (float3x3) inst.WorldInverseTranspose));
+    output.worldPosition = mul(input.position, inst.World).xyz;
+
+    output.color = inst.color;
+    output.specular = float4(inst.specularColor, inst.shininess);
+    output.enableLighting = inst.enableLighting;
+    return output;
+}
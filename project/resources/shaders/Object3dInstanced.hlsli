@@ -0,0 +1,11 @@
+struct InstancedVertexShaderOutput
+{
+    float4 position : SV_POSITION;
+    float2 texcoord : TEXCOORD0;
+    float3 normal : NORMAL0;
+    float3 worldPosition : POSITION0;
+    // マテリアルはインスタンス単位なので補間しない
+    nointerpolation float4 color : COLOR0;
+    nointerpolation float4 specular : COLOR1; // xyz: specularColor / w: shininess
+    nointerpolation int enableLighting : BLENDINDICES0;
+};
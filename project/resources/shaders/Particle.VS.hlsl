@@ -5,6 +5,7 @@ struct ParticleForGPU
     float4x4 WVP;
     float4x4 World;
     float4 color;
+    float4 uvRect; // xy: オフセット / zw: スケール（フリップブックのコマ）
 };
 
 StructuredBuffer<ParticleForGPU> gParticle : register(t1);
@@ -21,7 +22,8 @@ VertexShaderOutput main(VertexShaderInput input, uint instanceId : SV_InstanceID
     VertexShaderOutput output;
     float4 pos = float4(input.position, 1.0f);
     output.position = mul(pos, gParticle[instanceId].WVP);
-    output.texcoord = input.texcoord;
+    float4 uvRect = gParticle[instanceId].uvRect;
+    output.texcoord = input.texcoord * uvRect.zw + uvRect.xy;
     output.color = gParticle[instanceId].color;
     return output;
 }
\ No newline at end of file
@@ -0,0 +1,396 @@
+// アニメーション: キーの間引きの誤差、Animator の切り替え（切り替え中の CrossFade で姿勢が飛ばない）、
+// CPU スキニング、100 体 × 64 ジョイントでのサンプリングとスキニング（SSE / スカラー）の速さ
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AnimationClip.h"
+#include "AnimationSampler.h"
+#include "Animator.h"
+#include "Method.h"
+#include "ModelData.h"
+#include "Skinning.h"
+#include "TestCommon.h"
+
+namespace {
+
+constexpr uint32_t kJoints = 8;
+constexpr float kDuration = 2.0f;
+
+Vector4 AxisAngleZ(float angle) {
+  return {0.0f, 0.0f, std::sin(angle * 0.5f), std::cos(angle * 0.5f)};
+}
+
+// 30fps のキーを打った z 回転。ジョイント j の角度は f(time) + j * 0.1
+using Curve = float (*)(float);
+AnimationClip MakeClip(const char *name, Curve curve,
+                       uint32_t joints = kJoints) {
+  std::vector<RawAnimationTrack> raw;
+  for (uint32_t j = 0; j < joints; ++j) {
+    RawAnimationTrack track;
+    track.node = j + 1;
+    for (int k = 0; k <= 60; ++k) {
+      const float time = k / 30.0f;
+      track.rotationTimes.push_back(time);
+      track.rotations.push_back(AxisAngleZ(curve(time) + float(j) * 0.1f));
+      track.translationTimes.push_back(time);
+      track.translations.push_back({0.0f, 0.1f, 0.0f});
+    }
+    raw.push_back(std::move(track));
+  }
+  return Animation::BuildAnimationClip(name, kDuration, raw);
+}
+
+float Wave(float t) { return 0.3f * std::sin(3.1f * t); }
+float Still(float) { return 0.0f; }
+float Bend(float) { return 1.2f; }
+float Back(float) { return -1.0f; }
+
+// ルート + 鎖。ジョイント j はノード j + 1
+std::shared_ptr<ModelData> MakeModel(uint32_t joints = kJoints) {
+  auto model = std::make_shared<ModelData>();
+  model->nodes.AddNode(NodeHierarchy::kNone, "root", MakeIdentity4x4());
+  for (uint32_t j = 0; j < joints; ++j) {
+    Matrix4x4 local = MakeIdentity4x4();
+    local.m[3][1] = 0.1f;
+    model->nodes.AddNode(j, "joint" + std::to_string(j), local);
+  }
+  model->nodes.UpdateGlobalMatrices();
+  for (uint32_t j = 0; j < joints; ++j) {
+    SkinJoint joint{};
+    joint.node = j + 1;
+    joint.inverseBindMatrix = Inverse(model->nodes.GetGlobalMatrix(j + 1));
+    model->joints.push_back(joint);
+  }
+  model->animations.push_back(MakeClip("Wave", Wave, joints));
+  model->animations.push_back(MakeClip("Still", Still, joints));
+  model->animations.push_back(MakeClip("Bend", Bend, joints));
+  model->animations.push_back(MakeClip("Back", Back, joints));
+  return model;
+}
+
+// 鎖の高さ height に沿って、隣り合う 2 つのジョイントへ重みを振った頂点
+void MakeSkinnedVertices(uint32_t joints, float height, size_t count,
+                         uint32_t seed, std::vector<VertexData> &vertices,
+                         std::vector<VertexInfluence> &influences) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> u(0.0f, 1.0f);
+  vertices.resize(count);
+  influences.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    const float y = u(rng) * height;
+    vertices[i].position = {u(rng) - 0.5f, y, u(rng) - 0.5f, 1.0f};
+    vertices[i].normal = {1.0f, 0.0f, 0.0f};
+    vertices[i].texcoord = {u(rng), u(rng)};
+    const uint16_t b =
+        uint16_t(std::min<uint32_t>(joints - 2, uint32_t(y * 10)));
+    influences[i] = {{b, uint16_t(b + 1), 0, 0}, {160, 60, 35, 0}};
+  }
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// 先頭のジョイントのローカルの z 回転角
+float JointAngle(const Animator &animator) {
+  const Matrix4x4 &m = animator.GetNodes().GetLocalMatrix(1);
+  return std::atan2(m.m[0][1], m.m[0][0]);
+}
+
+void TestClipCompression(const ModelData &model) {
+  const AnimationClip &clip = model.animations[0];
+  AnimationPose pose;
+  Animation::MakeBindPose(model.nodes, pose);
+  float maxError = 0.0f;
+  for (int s = 0; s <= 600; ++s) {
+    const float time = s / 300.0f;
+    Animation::SampleClip(clip, time, pose);
+    for (uint32_t j = 0; j < kJoints; ++j) {
+      const Vector4 q = AxisAngleZ(Wave(time) + float(j) * 0.1f);
+      const Vector4 &p = pose.rotations[j + 1];
+      const float d = std::fabs(q.x * p.x + q.y * p.y + q.z * p.z + q.w * p.w);
+      maxError = std::max(maxError, 2.0f * std::acos(std::min(1.0f, d)));
+    }
+  }
+  // 30fps のキー間の補間誤差 + 間引きの許容量
+  CHECK(maxError < 2.0e-3f);
+
+  // 一定値の移動は両端だけ残る
+  const AnimationClip &still = model.animations[1];
+  CHECK(still.rotationKeys.size() < kJoints * 61 / 4);
+
+  // カーソル付きで時刻順に引いても二分探索と同じ値
+  AnimationPose a = pose;
+  AnimationPose b = pose;
+  AnimationCursor cursor;
+  bool same = true;
+  for (int i = 0; i < 600; ++i) {
+    const float time = std::fmod(i / 60.0f, kDuration);
+    Animation::SampleClip(clip, time, a, &cursor);
+    Animation::SampleClip(clip, time, b);
+    for (uint32_t n = 0; n < a.rotations.size(); ++n) {
+      same = same && a.rotations[n].z == b.rotations[n].z &&
+             a.rotations[n].w == b.rotations[n].w;
+    }
+  }
+  CHECK(same);
+}
+
+void TestPlayback(const std::shared_ptr<ModelData> &model) {
+  Animator animator;
+  animator.Initialize(model);
+  // バインドポーズならスキニング行列は単位行列
+  float error = 0.0f;
+  for (const Matrix4x4 &m : animator.GetSkinMatrices()) {
+    for (int r = 0; r < 4; ++r) {
+      for (int c = 0; c < 4; ++c) {
+        error = std::max(error, std::fabs(m.m[r][c] - (r == c ? 1.0f : 0.0f)));
+      }
+    }
+  }
+  CHECK(animator.GetSkinMatrices().size() == kJoints && error < 1.0e-5f);
+
+  CHECK(animator.FindClip("Bend") == 2);
+  CHECK(animator.FindClip("Missing") == Animator::kNoClip);
+
+  // ループしないクリップは最後で止まる
+  animator.Play(animator.FindClip("Wave"), false);
+  animator.Update(1.5f);
+  CHECK(!animator.IsFinished());
+  animator.Update(1.0f);
+  CHECK(animator.IsFinished() && animator.GetTime() == kDuration);
+  // ループは巻き戻る
+  animator.Play(0, true);
+  animator.Update(2.5f);
+  CHECK(!animator.IsFinished());
+  CHECK(std::fabs(animator.GetTime() - 0.5f) < 1.0e-5f);
+}
+
+void TestCrossFade(const std::shared_ptr<ModelData> &model) {
+  auto angleOf = [&](uint32_t clip) {
+    Animator a;
+    a.Initialize(model);
+    a.Play(clip);
+    a.Update(0.0f);
+    return JointAngle(a);
+  };
+  const float still = angleOf(1);
+  const float bend = angleOf(2);
+  const float back = angleOf(3);
+
+  Animator animator;
+  animator.Initialize(model);
+  animator.Play(1);
+  animator.Update(0.1f);
+  CHECK(std::fabs(JointAngle(animator) - still) < 1.0e-4f);
+
+  // Still → Bend を半分まで
+  animator.CrossFade(2, 1.0f);
+  animator.Update(0.5f);
+  const float halfway = JointAngle(animator);
+  CHECK(std::fabs(halfway - (still + bend) * 0.5f) < 1.0e-3f);
+
+  // 切り替え中に Back へ。直後の姿勢は半分混ざった姿勢から続く（Bend へ飛ばない）
+  animator.CrossFade(3, 1.0f);
+  animator.Update(1.0e-3f);
+  CHECK(std::fabs(JointAngle(animator) - halfway) < 5.0e-3f);
+  animator.Update(0.5f);
+  const float mid = JointAngle(animator);
+  CHECK(std::fabs(mid - (halfway + back) * 0.5f) < 5.0e-3f);
+  animator.Update(0.6f);
+  CHECK(std::fabs(JointAngle(animator) - back) < 1.0e-4f);
+
+  // 毎フレーム切り替え先を変えても 1 フレームの変化は小さいまま
+  animator.Play(1);
+  animator.Update(0.0f);
+  float previous = JointAngle(animator);
+  float maxStep = 0.0f;
+  for (int frame = 0; frame < 120; ++frame) {
+    if (frame % 7 == 0) {
+      animator.CrossFade(1 + uint32_t(frame / 7) % 3, 0.25f);
+    }
+    animator.Update(1.0f / 60.0f);
+    const float angle = JointAngle(animator);
+    maxStep = std::max(maxStep, std::fabs(angle - previous));
+    previous = angle;
+  }
+  // 最大の角度差（Bend と Back の 2.2 rad）を 0.25 秒で動かす時の 1 フレームぶん程度
+  CHECK(maxStep < 2.2f / 15.0f * 1.1f);
+}
+
+void TestSkinning(const std::shared_ptr<ModelData> &model) {
+  Animator animator;
+  animator.Initialize(model);
+  animator.Play(0);
+  animator.Update(0.37f);
+  const std::vector<Matrix4x4> &palette = animator.GetSkinMatrices();
+
+  constexpr size_t kCount = 257; // SSE の端数も通す
+  std::vector<VertexData> src;
+  std::vector<VertexInfluence> influences;
+  MakeSkinnedVertices(kJoints, 0.8f, kCount, 1, src, influences);
+
+  std::vector<VertexData> dst(kCount);
+  Skinning::SkinVertices(src.data(), influences.data(), kCount, palette.data(),
+                         dst.data());
+
+  // 素直に 1 頂点ずつ計算したものと比べる
+  float maxDiff = 0.0f;
+  for (size_t i = 0; i < kCount; ++i) {
+    Matrix4x4 blended{};
+    for (int k = 0; k < 4; ++k) {
+      const float w = influences[i].weights[k] / 255.0f;
+      const Matrix4x4 &m = palette[influences[i].joints[k]];
+      for (int r = 0; r < 4; ++r) {
+        for (int c = 0; c < 4; ++c) {
+          blended.m[r][c] += m.m[r][c] * w;
+        }
+      }
+    }
+    const Vector4 &p = src[i].position;
+    float expected[3];
+    for (int c = 0; c < 3; ++c) {
+      expected[c] = p.x * blended.m[0][c] + p.y * blended.m[1][c] +
+                    p.z * blended.m[2][c] + blended.m[3][c];
+    }
+    maxDiff = std::max({maxDiff, std::fabs(dst[i].position.x - expected[0]),
+                        std::fabs(dst[i].position.y - expected[1]),
+                        std::fabs(dst[i].position.z - expected[2])});
+    const Vector3 &n = dst[i].normal;
+    maxDiff = std::max(maxDiff,
+                       std::fabs(std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z) - 1.0f));
+    CHECK(dst[i].texcoord.x == src[i].texcoord.x);
+  }
+  CHECK(maxDiff < 1.0e-5f);
+
+  // dst が src と同じでもよい
+  std::vector<VertexData> inPlace = src;
+  Skinning::SkinVertices(inPlace.data(), influences.data(), kCount,
+                         palette.data(), inPlace.data());
+  bool same = true;
+  for (size_t i = 0; i < kCount; ++i) {
+    same = same && inPlace[i].position.x == dst[i].position.x &&
+           inPlace[i].normal.y == dst[i].normal.y;
+  }
+  CHECK(same);
+
+  // スカラー版も同じ結果（足す順の違いによる丸め誤差まで）
+  std::vector<VertexData> scalar(kCount);
+  Skinning::SkinVerticesScalar(src.data(), influences.data(), kCount,
+                               palette.data(), scalar.data());
+  float scalarDiff = 0.0f;
+  for (size_t i = 0; i < kCount; ++i) {
+    scalarDiff = std::max({scalarDiff,
+                           std::fabs(scalar[i].position.x - dst[i].position.x),
+                           std::fabs(scalar[i].position.y - dst[i].position.y),
+                           std::fabs(scalar[i].position.z - dst[i].position.z),
+                           std::fabs(scalar[i].normal.x - dst[i].normal.x),
+                           std::fabs(scalar[i].normal.y - dst[i].normal.y)});
+  }
+  CHECK(scalarDiff < 1.0e-6f);
+}
+
+// 100 体 × 64 ジョイント（2 秒・30fps のクリップ）を 60fps で 2 秒ぶん再生する
+// - サンプリングだけ（SampleClip）と、切り替えを含む Animator::Update 全体の 1 フレームの時間
+// - 1 体 4000 頂点の CPU スキニング（SSE / スカラー）の 1 フレームの時間
+void Benchmark() {
+  constexpr uint32_t kCharacters = 100;
+  constexpr uint32_t kBenchJoints = 64;
+  constexpr size_t kVertices = 4000;
+  constexpr int kFrames = 120;
+  constexpr float kDt = 1.0f / 60.0f;
+  const std::shared_ptr<ModelData> model = MakeModel(kBenchJoints);
+
+  // 体ごとに時刻をずらし、キーの位置がばらけるようにする
+  std::vector<AnimationPose> poses(kCharacters);
+  std::vector<AnimationCursor> cursors(kCharacters);
+  for (AnimationPose &pose : poses) {
+    Animation::MakeBindPose(model->nodes, pose);
+  }
+  const auto sampleStart = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < kFrames; ++frame) {
+    for (uint32_t c = 0; c < kCharacters; ++c) {
+      const float time = std::fmod(frame * kDt + c * 0.013f, kDuration);
+      Animation::SampleClip(model->animations[c % 4], time, poses[c],
+                            &cursors[c]);
+    }
+  }
+  const double sampleMs = ElapsedMs(sampleStart) / kFrames;
+
+  std::vector<Animator> animators(kCharacters);
+  for (uint32_t c = 0; c < kCharacters; ++c) {
+    animators[c].Initialize(model);
+    animators[c].Play(c % 4);
+    animators[c].Update(c * 0.013f);
+  }
+  const auto updateStart = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < kFrames; ++frame) {
+    for (uint32_t c = 0; c < kCharacters; ++c) {
+      // 0.5 秒ごとに体ごとにずらして切り替える
+      if ((frame + int(c)) % 30 == 0) {
+        animators[c].CrossFade((c + uint32_t(frame)) % 4, 0.25f);
+      }
+      animators[c].Update(kDt);
+    }
+  }
+  const double updateMs = ElapsedMs(updateStart) / kFrames;
+  std::printf("Animation: %u characters x %u joints  SampleClip %.3f "
+              "ms/frame  Animator::Update %.3f ms/frame\n",
+              kCharacters, kBenchJoints, sampleMs, updateMs);
+
+  std::vector<VertexData> src;
+  std::vector<VertexInfluence> influences;
+  MakeSkinnedVertices(kBenchJoints, 6.3f, kVertices, 2, src, influences);
+  std::vector<VertexData> simd(kVertices * kCharacters);
+  std::vector<VertexData> scalar(kVertices * kCharacters);
+  constexpr int kRuns = 10;
+  double simdMs = 0.0;
+  double scalarMs = 0.0;
+  for (int run = 0; run < kRuns; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t c = 0; c < kCharacters; ++c) {
+      Skinning::SkinVertices(src.data(), influences.data(), kVertices,
+                             animators[c].GetSkinMatrices().data(),
+                             simd.data() + c * kVertices);
+    }
+    simdMs += ElapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t c = 0; c < kCharacters; ++c) {
+      Skinning::SkinVerticesScalar(src.data(), influences.data(), kVertices,
+                                   animators[c].GetSkinMatrices().data(),
+                                   scalar.data() + c * kVertices);
+    }
+    scalarMs += ElapsedMs(start);
+  }
+  float maxDiff = 0.0f;
+  for (size_t i = 0; i < simd.size(); ++i) {
+    maxDiff = std::max({maxDiff,
+                        std::fabs(simd[i].position.x - scalar[i].position.x),
+                        std::fabs(simd[i].position.y - scalar[i].position.y),
+                        std::fabs(simd[i].position.z - scalar[i].position.z)});
+  }
+  CHECK(maxDiff < 1.0e-5f);
+  std::printf("Skinning: %u x %zu vertices  SkinVertices %.3f ms/frame "
+              "(scalar %.3f ms/frame)\n",
+              kCharacters, kVertices, simdMs / kRuns, scalarMs / kRuns);
+}
+
+} // namespace
+
+int main() {
+  const std::shared_ptr<ModelData> model = MakeModel();
+  TestClipCompression(*model);
+  TestPlayback(model);
+  TestCrossFade(model);
+  TestSkinning(model);
+  Benchmark();
+  return TestCommon::Finish("AnimatorTest");
+}
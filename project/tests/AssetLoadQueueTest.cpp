@@ -0,0 +1,275 @@
+// AssetLoadQueue / AssetFuture: ワーカーで読んで描画スレッドで仕上げる流れ、
+// 失敗の伝わり方、デコード側を並列に回した時と 1 本で回した時の時間
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AssetFuture.h"
+#include "AssetLoadQueue.h"
+#include "BcEncoder.h"
+#include "JobSystem.h"
+#include "ObjImporter.h"
+#include "TestCommon.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+fs::path gDir;
+std::thread::id gMainThread;
+
+// 描画スレッドで作る GPU リソースの代わり
+struct Asset {
+  std::string name;
+  size_t triangles = 0;
+  size_t compressedBytes = 0;
+  std::thread::id decodedOn;
+  std::thread::id finalizedOn;
+};
+
+// 格子の OBJ（1 MiB 未満なので ObjImporter の中では分割しない）
+void WriteGridObj(const fs::path &path, int n) {
+  FILE *file = std::fopen(path.string().c_str(), "wb");
+  CHECK(file != nullptr);
+  if (!file) {
+    return;
+  }
+  for (int y = 0; y <= n; ++y) {
+    for (int x = 0; x <= n; ++x) {
+      std::fprintf(file, "v %.5f %.5f %.5f\n", x * 0.1f,
+                   std::sin(x * 0.2f + y * 0.1f), y * 0.1f);
+    }
+  }
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const int a = y * (n + 1) + x + 1;
+      const int c = a + n + 1;
+      std::fprintf(file, "f %d %d %d\nf %d %d %d\n", a, c, a + 1, a + 1, c,
+                   c + 1);
+    }
+  }
+  std::fclose(file);
+}
+
+// ワーカー側の処理（ファイルの取り込みとテクスチャの圧縮）。読めなければ false
+bool Decode(const std::string &path, uint32_t textureSize, Asset &out) {
+  ModelData model;
+  if (!ObjImporter::Import(gDir.string(), path, model)) {
+    return false;
+  }
+  for (const MeshData &mesh : model.meshes) {
+    out.triangles += mesh.indices.size() / 3;
+  }
+  // 1 枚をブロックごとに順に圧縮する（並列化はアセット単位だけ）
+  std::vector<uint8_t> block(64);
+  std::vector<uint8_t> encoded(16);
+  for (uint32_t by = 0; by < textureSize / 4; ++by) {
+    for (uint32_t bx = 0; bx < textureSize / 4; ++bx) {
+      for (uint32_t i = 0; i < 64; ++i) {
+        block[i] = uint8_t((bx * 13 + by * 7 + i * 3) & 0xFF);
+      }
+      BcEncoder::EncodeBlock(BcEncoder::Format::BC7, block.data(),
+                             encoded.data());
+      out.compressedBytes += encoded.size();
+    }
+  }
+  out.name = path;
+  out.decodedOn = std::this_thread::get_id();
+  return true;
+}
+
+// TextureManager::LoadAsync と同じ流れ: ワーカーでデコード → 描画スレッドで作って Resolve
+AssetFuture<Asset> LoadAsync(const std::string &path, uint32_t textureSize,
+                             std::shared_ptr<Asset> placeholder = nullptr) {
+  AssetFuture<Asset> future =
+      AssetFuture<Asset>::MakePending(std::move(placeholder));
+  AssetLoadQueue *queue = AssetLoadQueue::GetInstance();
+  queue->Submit([queue, path, textureSize, future]() {
+    auto decoded = std::make_shared<Asset>();
+    const bool ok = Decode(path, textureSize, *decoded);
+    queue->PostToRenderThread([ok, decoded, future]() {
+      if (ok) {
+        decoded->finalizedOn = std::this_thread::get_id();
+      }
+      future.Resolve(ok ? decoded : nullptr);
+      return true;
+    });
+  });
+  return future;
+}
+
+void TestCompletion() {
+  WriteGridObj(gDir / "a.obj", 20);
+  AssetLoadQueue *queue = AssetLoadQueue::GetInstance();
+  auto placeholder = std::make_shared<Asset>();
+  placeholder->name = "placeholder";
+
+  // Resolve は Pump の中（描画スレッド）なので、Wait するまでは読み込み中のまま
+  const AssetFuture<Asset> future =
+      LoadAsync((gDir / "a.obj").string(), 16, placeholder);
+  CHECK(future.GetStatus() == AssetFuture<Asset>::Status::Pending);
+  CHECK(future.Get() == placeholder);
+
+  // コピーしても同じ結果を指す
+  const AssetFuture<Asset> copy = future;
+  CHECK(copy.IsSameState(future));
+
+  queue->Wait(future);
+  CHECK(future.GetStatus() == AssetFuture<Asset>::Status::Ready);
+  const std::shared_ptr<Asset> asset = copy.Get();
+  CHECK(asset && asset != placeholder);
+  if (asset) {
+    CHECK(asset->triangles == 20 * 20 * 2);
+    CHECK(asset->compressedBytes == 4 * 4 * 16);
+    // デコードはワーカー、仕上げは描画スレッド（Pump を呼んだスレッド）で動く
+    CHECK(asset->decodedOn != gMainThread);
+    CHECK(asset->finalizedOn == gMainThread);
+  }
+
+  // ワーカーの作業が終わっても、Pump するまで仕上げは動かない
+  const AssetFuture<Asset> second = LoadAsync((gDir / "a.obj").string(), 4);
+  while (queue->GetStats().working != 0) {
+    std::this_thread::yield();
+  }
+  CHECK(queue->GetStats().finalizing == 1);
+  CHECK(!second.IsReady());
+  queue->Pump();
+  CHECK(second.GetStatus() == AssetFuture<Asset>::Status::Ready);
+  CHECK(queue->GetStats().finalizing == 0);
+
+  // 完了済みの future
+  const AssetFuture<Asset> ready = AssetFuture<Asset>::MakeReady(asset);
+  CHECK(ready.IsReady() && ready.Get() == asset);
+}
+
+void TestFailure() {
+  AssetLoadQueue *queue = AssetLoadQueue::GetInstance();
+  auto placeholder = std::make_shared<Asset>();
+
+  // 読めないファイル: 失敗で終わり、Get はプレースホルダのまま
+  const AssetFuture<Asset> missing =
+      LoadAsync((gDir / "missing.obj").string(), 4, placeholder);
+  queue->Wait(missing);
+  CHECK(missing.GetStatus() == AssetFuture<Asset>::Status::Failed);
+  CHECK(missing.Get() == placeholder);
+  // 2 度目の Resolve は無視される
+  missing.Resolve(std::make_shared<Asset>());
+  CHECK(missing.GetStatus() == AssetFuture<Asset>::Status::Failed);
+
+  // 依存先の完了を待つ仕上げ（false で次の Pump へ回す）。依存先の失敗はそのまま伝わる
+  WriteGridObj(gDir / "b.obj", 8);
+  const AssetFuture<Asset> texture =
+      LoadAsync((gDir / "missing.obj").string(), 4);
+  const AssetFuture<Asset> okTexture = LoadAsync((gDir / "b.obj").string(), 4);
+  auto makeMaterial = [queue](const AssetFuture<Asset> &dependency) {
+    AssetFuture<Asset> material = AssetFuture<Asset>::MakePending(nullptr);
+    auto tries = std::make_shared<int>(0);
+    queue->PostToRenderThread([dependency, material, tries]() {
+      ++*tries;
+      if (!dependency.IsReady()) {
+        return false;
+      }
+      material.Resolve(dependency.Get()); // 失敗なら nullptr → Failed
+      return true;
+    });
+    return std::make_pair(material, tries);
+  };
+  const auto [failed, failedTries] = makeMaterial(texture);
+  const auto [loaded, loadedTries] = makeMaterial(okTexture);
+  queue->WaitAll();
+  CHECK(failed.GetStatus() == AssetFuture<Asset>::Status::Failed);
+  CHECK(loaded.GetStatus() == AssetFuture<Asset>::Status::Ready);
+  CHECK(loaded.Get() == okTexture.Get());
+  CHECK(*failedTries >= 1 && *loadedTries >= 1);
+
+  const AssetLoadQueue::Stats stats = queue->GetStats();
+  CHECK(stats.working == 0 && stats.finalizing == 0);
+}
+
+// 16 個のアセットを描画スレッドで 1 つずつ読む時と、キューに積んで並列に読む時
+void Benchmark() {
+  constexpr int kAssets = 16;
+  constexpr uint32_t kTextureSize = 128;
+  std::vector<std::string> paths;
+  for (int i = 0; i < kAssets; ++i) {
+    const fs::path path = gDir / ("asset" + std::to_string(i) + ".obj");
+    WriteGridObj(path, 100);
+    paths.push_back(path.string());
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  size_t serialTriangles = 0;
+  for (const std::string &path : paths) {
+    Asset asset;
+    CHECK(Decode(path, kTextureSize, asset));
+    serialTriangles += asset.triangles;
+  }
+  const double serialMs = std::chrono::duration<double, std::milli>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+
+  AssetLoadQueue *queue = AssetLoadQueue::GetInstance();
+  start = std::chrono::steady_clock::now();
+  std::vector<AssetFuture<Asset>> futures;
+  for (const std::string &path : paths) {
+    futures.push_back(LoadAsync(path, kTextureSize));
+  }
+  queue->WaitAll();
+  const double parallelMs = std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+  size_t parallelTriangles = 0;
+  for (const AssetFuture<Asset> &future : futures) {
+    CHECK(future.GetStatus() == AssetFuture<Asset>::Status::Ready);
+    if (auto asset = future.Get()) {
+      parallelTriangles += asset->triangles;
+    }
+  }
+  CHECK(parallelTriangles == serialTriangles);
+
+  std::printf("AssetLoadQueue: %d assets  serial %.1f ms  parallel %.1f ms "
+              "(%u workers, %u hardware threads, x%.2f)\n",
+              kAssets, serialMs, parallelMs,
+              JobSystem::GetInstance()->GetWorkerCount(),
+              std::thread::hardware_concurrency(), serialMs / parallelMs);
+}
+
+} // namespace
+
+int main() {
+  gDir = fs::temp_directory_path() / "AssetLoadQueueTest";
+  fs::remove_all(gDir);
+  fs::create_directories(gDir);
+  gMainThread = std::this_thread::get_id();
+
+  // ワーカーの入口・出口の処理はワーカーごとに 1 回ずつ
+  std::atomic<int> started{0};
+  std::atomic<int> exited{0};
+  const JobSystem::WorkerHooks hooks = AssetLoadQueue::GetWorkerHooks();
+  const uint32_t hardware = std::thread::hardware_concurrency();
+  const uint32_t workers = std::max(2u, hardware > 1 ? hardware - 1 : 0u);
+  JobSystem::GetInstance()->Initialize(
+      workers, {[&]() {
+                  hooks.onStart();
+                  ++started;
+                },
+                [&]() {
+                  hooks.onExit();
+                  ++exited;
+                }});
+
+  TestCompletion();
+  TestFailure();
+  Benchmark();
+
+  JobSystem::GetInstance()->Finalize();
+  CHECK(started == int(workers) && exited == int(workers));
+  fs::remove_all(gDir);
+  return TestCommon::Finish("AssetLoadQueueTest");
+}
@@ -0,0 +1,238 @@
+// AtlasPacker の配置（重なり・範囲・位置揃え）と枠の埋め方、詰め方の効率と速さ
+// - 比較用に高さ順の棚詰めと並べて、ページ数と効率を表示する
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "AtlasPacker.h"
+#include "TestCommon.h"
+
+namespace {
+
+using AtlasPacker::Placement;
+using AtlasPacker::Result;
+using AtlasPacker::Settings;
+using AtlasPacker::Size;
+
+uint32_t AlignUp(uint32_t v, uint32_t alignment) {
+  return (v + alignment - 1) / alignment * alignment;
+}
+
+// 高さ順に左から並べ、横に入らなければ次の段、縦に入らなければ次のページ
+Result PackShelf(const std::vector<Size> &sizes, const Settings &settings) {
+  Result result;
+  result.placements.resize(sizes.size());
+  std::vector<uint32_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return sizes[a].height > sizes[b].height;
+  });
+
+  uint32_t page = 0, x = 0, y = 0, shelfHeight = 0, usedWidth = 0;
+  for (uint32_t i : order) {
+    const uint32_t w =
+        AlignUp(sizes[i].width + 2 * settings.padding, settings.alignment);
+    const uint32_t h =
+        AlignUp(sizes[i].height + 2 * settings.padding, settings.alignment);
+    if (x + w > settings.pageWidth) {
+      x = 0;
+      y += shelfHeight;
+      shelfHeight = 0;
+    }
+    if (y + h > settings.pageHeight) {
+      result.pages.push_back({usedWidth, y});
+      ++page;
+      x = y = shelfHeight = usedWidth = 0;
+    }
+    result.placements[i] = {page, x + settings.padding, y + settings.padding,
+                            true};
+    x += w;
+    shelfHeight = std::max(shelfHeight, h);
+    usedWidth = std::max(usedWidth, x);
+    result.contentPixels += uint64_t(sizes[i].width) * sizes[i].height;
+  }
+  result.pages.push_back({usedWidth, y + shelfHeight});
+  return result;
+}
+
+// 全部がページに入り、枠込みのスロットが範囲内・位置揃え済みで、互いに重ならない
+bool Validate(const std::vector<Size> &sizes, const Settings &settings,
+              const Result &result) {
+  const uint32_t pad = settings.padding;
+  const uint32_t align = settings.alignment;
+  bool ok = result.placements.size() == sizes.size();
+  uint64_t content = 0;
+  for (size_t i = 0; ok && i < sizes.size(); ++i) {
+    const Placement &p = result.placements[i];
+    ok = p.packed && p.page < result.pages.size() && p.x >= pad &&
+         p.y >= pad && (p.x - pad) % align == 0 && (p.y - pad) % align == 0 &&
+         p.x + sizes[i].width + pad <= result.pages[p.page].width &&
+         p.y + sizes[i].height + pad <= result.pages[p.page].height;
+    content += uint64_t(sizes[i].width) * sizes[i].height;
+  }
+  for (const Size &page : result.pages) {
+    ok = ok && page.width % align == 0 && page.height % align == 0 &&
+         page.width <= settings.pageWidth && page.height <= settings.pageHeight;
+  }
+  ok = ok && content == result.contentPixels;
+
+  for (size_t i = 0; ok && i < sizes.size(); ++i) {
+    for (size_t j = i + 1; ok && j < sizes.size(); ++j) {
+      const Placement &a = result.placements[i];
+      const Placement &b = result.placements[j];
+      if (a.page != b.page) {
+        continue;
+      }
+      const bool separate = a.x + sizes[i].width + pad <= b.x - pad ||
+                            b.x + sizes[j].width + pad <= a.x - pad ||
+                            a.y + sizes[i].height + pad <= b.y - pad ||
+                            b.y + sizes[j].height + pad <= a.y - pad;
+      ok = separate;
+    }
+  }
+  return ok;
+}
+
+void TestBlitWithBorder() {
+  // 2x3 の画像を 8x8 の (2, 2) に、枠 2 で写す（R に通し番号）
+  constexpr uint32_t kW = 2, kH = 3;
+  std::vector<uint8_t> src(kW * kH * 4);
+  for (size_t i = 0; i < src.size(); ++i) {
+    src[i] = uint8_t(i + 1);
+  }
+  std::vector<uint8_t> dst(8 * 8 * 4, 0);
+  AtlasPacker::BlitWithBorder(dst.data(), 8 * 4, src.data(), kW * 4, kW, kH,
+                              2, 2, 2);
+  auto r = [&](uint32_t x, uint32_t y) { return dst[(y * 8 + x) * 4]; };
+  auto srcR = [&](uint32_t x, uint32_t y) { return src[(y * kW + x) * 4]; };
+
+  // 本体はそのまま、枠は一番近い端の画素（角は角の画素）
+  for (uint32_t y = 0; y < 7; ++y) {
+    for (uint32_t x = 0; x < 6; ++x) {
+      const uint32_t sx = std::min<uint32_t>(std::max<int>(int(x) - 2, 0), kW - 1);
+      const uint32_t sy = std::min<uint32_t>(std::max<int>(int(y) - 2, 0), kH - 1);
+      CHECK(r(x, y) == srcR(sx, sy));
+    }
+  }
+  // 4 チャンネルとも写る
+  CHECK(dst[(2 * 8 + 3) * 4 + 3] == src[1 * 4 + 3]);
+  // 枠の外は触らない
+  CHECK(r(6, 2) == 0 && r(0, 7) == 0 && r(7, 7) == 0);
+}
+
+void TestSafeMipLevels() {
+  // 枠と位置揃えの小さい方 2^k までのミップが混ざらない
+  CHECK(AtlasPacker::GetSafeMipLevels({2048, 2048, 4, 4}) == 3);
+  CHECK(AtlasPacker::GetSafeMipLevels({2048, 2048, 2, 4}) == 2);
+  CHECK(AtlasPacker::GetSafeMipLevels({2048, 2048, 8, 4}) == 3);
+  CHECK(AtlasPacker::GetSafeMipLevels({2048, 2048, 0, 4}) == 1);
+}
+
+void TestUnpacked() {
+  Settings settings;
+  // ページより大きい・枠を足すと入らない・読めなかった（大きさ 0）画像は載せない
+  const std::vector<Size> sizes = {
+      {4000, 10}, {10, 10}, {2048, 16}, {0, 0}, {2040, 2040}};
+  Result result;
+  AtlasPacker::Pack(sizes, settings, result);
+  CHECK(result.placements.size() == sizes.size());
+  CHECK(!result.placements[0].packed);
+  CHECK(result.placements[1].packed);
+  CHECK(!result.placements[2].packed);
+  CHECK(!result.placements[3].packed);
+  CHECK(result.placements[4].packed);
+  CHECK(result.contentPixels == 10 * 10 + 2040ull * 2040);
+  // 大きい方が 1 ページを占め、小さい方は次のページへ
+  CHECK(result.pages.size() == 2);
+  CHECK(result.placements[1].page != result.placements[4].page);
+
+  // 何も載らなければページも無い
+  Result empty;
+  AtlasPacker::Pack(std::vector<Size>{{0, 0}, {5000, 5000}}, settings, empty);
+  CHECK(empty.pages.empty() && empty.contentPixels == 0);
+  CHECK(AtlasPacker::ComputeEfficiency(empty) == 0.0);
+}
+
+struct Case {
+  const char *name;
+  std::vector<Size> sizes;
+};
+
+std::vector<Case> MakeCases() {
+  std::mt19937 rng(1);
+  std::vector<Case> cases;
+  {
+    Case c{"500 icons 16-128", {}};
+    for (int i = 0; i < 500; ++i) {
+      c.sizes.push_back({16 + uint32_t(rng() % 113), 16 + uint32_t(rng() % 113)});
+    }
+    cases.push_back(std::move(c));
+  }
+  {
+    // 1 割が 256 までの大きい画像
+    Case c{"2000 mixed 8-256", {}};
+    for (int i = 0; i < 2000; ++i) {
+      const uint32_t limit = (rng() % 10 == 0) ? 256 : 64;
+      c.sizes.push_back({8 + uint32_t(rng() % (limit - 7)),
+                         8 + uint32_t(rng() % (limit - 7))});
+    }
+    cases.push_back(std::move(c));
+  }
+  {
+    Case c{"256 uniform 60x60", {}};
+    c.sizes.assign(256, Size{60, 60});
+    cases.push_back(std::move(c));
+  }
+  {
+    Case c{"40 glyphs 10-40", {}};
+    for (int i = 0; i < 40; ++i) {
+      c.sizes.push_back({10 + uint32_t(rng() % 31), 20 + uint32_t(rng() % 21)});
+    }
+    cases.push_back(std::move(c));
+  }
+  return cases;
+}
+
+void TestPackAndBenchmark() {
+  const Settings settings;
+  constexpr int kRuns = 5;
+  std::printf("%-20s %6s %10s %10s | shelf %6s %10s\n", "set", "pages",
+              "efficiency", "time(ms)", "pages", "efficiency");
+  for (const Case &c : MakeCases()) {
+    Result result;
+    double ms = 0.0;
+    for (int run = 0; run < kRuns; ++run) {
+      const auto start = std::chrono::steady_clock::now();
+      AtlasPacker::Pack(c.sizes, settings, result);
+      ms += std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start)
+                .count();
+    }
+    CHECK(Validate(c.sizes, settings, result));
+
+    const Result shelf = PackShelf(c.sizes, settings);
+    CHECK(Validate(c.sizes, settings, shelf));
+
+    const double efficiency = AtlasPacker::ComputeEfficiency(result);
+    const double shelfEfficiency = AtlasPacker::ComputeEfficiency(shelf);
+    std::printf("%-20s %6zu %9.1f%% %10.3f | shelf %6zu %9.1f%%\n", c.name,
+                result.pages.size(), 100.0 * efficiency, ms / kRuns,
+                shelf.pages.size(), 100.0 * shelfEfficiency);
+    // 棚詰めよりページが増えない
+    CHECK(result.pages.size() <= shelf.pages.size());
+    CHECK(efficiency > 0.0 && efficiency <= 1.0);
+  }
+}
+
+} // namespace
+
+int main() {
+  TestBlitWithBorder();
+  TestSafeMipLevels();
+  TestUnpacked();
+  TestPackAndBenchmark();
+  return TestCommon::Finish("AtlasPackerTest");
+}
@@ -0,0 +1,412 @@
+// BcEncoder: 仕様どおりの復号器で戻した画像の PSNR（形式ごと・絵柄ごとの下限）、
+// 法線マップの角度誤差、端の半端なブロック、並列と 1 ブロックずつの結果の一致
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "BcEncoder.h"
+#include "JobSystem.h"
+#include "TestCommon.h"
+
+namespace {
+
+using BcEncoder::Format;
+
+struct Image {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  std::vector<uint8_t> rgba;
+};
+
+// ---- 確認用の復号（エンコーダとは独立に仕様から書く） ----
+
+void Expand565(uint16_t v, int (&out)[4]) {
+  const int r = v >> 11, g = (v >> 5) & 63, b = v & 31;
+  out[0] = (r << 3) | (r >> 2);
+  out[1] = (g << 2) | (g >> 4);
+  out[2] = (b << 3) | (b >> 2);
+  out[3] = 255;
+}
+
+// BC3 の色ブロックは常に 4 色
+void DecodeColor(const uint8_t *block, uint8_t (&out)[16][4], bool alwaysFour) {
+  uint16_t c0, c1;
+  uint32_t indices;
+  std::memcpy(&c0, block, 2);
+  std::memcpy(&c1, block + 2, 2);
+  std::memcpy(&indices, block + 4, 4);
+  int palette[4][4];
+  Expand565(c0, palette[0]);
+  Expand565(c1, palette[1]);
+  palette[2][3] = palette[3][3] = 255;
+  for (int c = 0; c < 3; ++c) {
+    if (c0 > c1 || alwaysFour) {
+      palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+      palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    } else {
+      palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+      palette[3][c] = 0;
+    }
+  }
+  if (!(c0 > c1 || alwaysFour)) {
+    palette[3][3] = 0;
+  }
+  for (int i = 0; i < 16; ++i) {
+    const int k = (indices >> (2 * i)) & 3;
+    for (int c = 0; c < 4; ++c) {
+      out[i][c] = uint8_t(palette[k][c]);
+    }
+  }
+}
+
+void DecodeChannel(const uint8_t *block, uint8_t (&out)[16][4], int channel) {
+  const int a0 = block[0], a1 = block[1];
+  int palette[8] = {a0, a1};
+  if (a0 > a1) {
+    for (int i = 2; i < 8; ++i) {
+      palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+    }
+  } else {
+    for (int i = 2; i < 6; ++i) {
+      palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+    }
+    palette[6] = 0;
+    palette[7] = 255;
+  }
+  uint64_t indices = 0;
+  for (int k = 0; k < 6; ++k) {
+    indices |= uint64_t(block[2 + k]) << (8 * k);
+  }
+  for (int i = 0; i < 16; ++i) {
+    out[i][channel] = uint8_t(palette[(indices >> (3 * i)) & 7]);
+  }
+}
+
+// モード 6 以外は黒（エンコーダはモード 6 しか出さない）
+bool DecodeBc7(const uint8_t *block, uint8_t (&out)[16][4]) {
+  int pos = 0;
+  auto read = [&](int bits) {
+    int v = 0;
+    for (int i = 0; i < bits; ++i, ++pos) {
+      v |= ((block[pos >> 3] >> (pos & 7)) & 1) << i;
+    }
+    return v;
+  };
+  int mode = 0;
+  while (mode < 8 && !read(1)) {
+    ++mode;
+  }
+  if (mode != 6) {
+    std::memset(out, 0, sizeof(out));
+    return false;
+  }
+  int endpoints[2][4];
+  for (int c = 0; c < 4; ++c) {
+    endpoints[0][c] = read(7);
+    endpoints[1][c] = read(7);
+  }
+  const int p0 = read(1), p1 = read(1);
+  for (int c = 0; c < 4; ++c) {
+    endpoints[0][c] = endpoints[0][c] * 2 + p0;
+    endpoints[1][c] = endpoints[1][c] * 2 + p1;
+  }
+  static const int kWeights[16] = {0,  4,  9,  13, 17, 21, 26, 30,
+                                   34, 38, 43, 47, 51, 55, 60, 64};
+  for (int i = 0; i < 16; ++i) {
+    const int w = kWeights[read(i == 0 ? 3 : 4)];
+    for (int c = 0; c < 4; ++c) {
+      out[i][c] = uint8_t(((64 - w) * endpoints[0][c] + w * endpoints[1][c] + 32) >> 6);
+    }
+  }
+  return pos == 128;
+}
+
+Image Decode(Format format, const std::vector<uint8_t> &data, uint32_t width,
+             uint32_t height) {
+  Image out{width, height, std::vector<uint8_t>(size_t(width) * height * 4, 255)};
+  const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+  const size_t blockBytes = BcEncoder::GetBlockBytes(format);
+  for (uint32_t by = 0; by < blocksY; ++by) {
+    for (uint32_t bx = 0; bx < blocksX; ++bx) {
+      const uint8_t *block = &data[(size_t(by) * blocksX + bx) * blockBytes];
+      uint8_t px[16][4];
+      for (auto &p : px) {
+        p[0] = p[1] = p[2] = 0;
+        p[3] = 255;
+      }
+      switch (format) {
+      case Format::BC1:
+        DecodeColor(block, px, false);
+        break;
+      case Format::BC3:
+        DecodeColor(block + 8, px, true);
+        DecodeChannel(block, px, 3);
+        break;
+      case Format::BC4:
+        DecodeChannel(block, px, 0);
+        break;
+      case Format::BC5:
+        DecodeChannel(block, px, 0);
+        DecodeChannel(block + 8, px, 1);
+        break;
+      case Format::BC7:
+        CHECK(DecodeBc7(block, px));
+        break;
+      }
+      for (uint32_t i = 0; i < 16; ++i) {
+        const uint32_t x = bx * 4 + i % 4, y = by * 4 + i / 4;
+        if (x < width && y < height) {
+          std::memcpy(&out.rgba[(size_t(y) * width + x) * 4], px[i], 4);
+        }
+      }
+    }
+  }
+  return out;
+}
+
+std::vector<uint8_t> Encode(Format format, const Image &image) {
+  std::vector<uint8_t> out(
+      BcEncoder::GetCompressedSize(format, image.width, image.height));
+  BcEncoder::Encode(format, image.rgba.data(), image.width, image.height,
+                    size_t(image.width) * 4, out.data());
+  return out;
+}
+
+// チャンネル [first, last) の PSNR（dB）。一致なら 99
+double Psnr(const Image &a, const Image &b, int first, int last) {
+  double sum = 0.0;
+  size_t count = 0;
+  for (size_t i = 0; i < a.rgba.size(); i += 4) {
+    for (int c = first; c < last; ++c) {
+      const double d = double(a.rgba[i + c]) - double(b.rgba[i + c]);
+      sum += d * d;
+      ++count;
+    }
+  }
+  const double mse = sum / double(count);
+  return mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+// ---- 試す絵柄（同梱の PNG に近い性質のものを作る） ----
+
+template <class F> Image MakeImage(uint32_t width, uint32_t height, F &&pixel) {
+  Image image{width, height, std::vector<uint8_t>(size_t(width) * height * 4)};
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      float c[4];
+      pixel(float(x), float(y), c);
+      for (int k = 0; k < 4; ++k) {
+        image.rgba[(size_t(y) * width + x) * 4 + k] =
+            uint8_t(std::lround(std::clamp(c[k], 0.0f, 1.0f) * 255.0f));
+      }
+    }
+  }
+  return image;
+}
+
+// なめらかなグラデーション（monsterBall のような塗り）
+Image MakeSmooth() {
+  return MakeImage(256, 256, [](float x, float y, float (&c)[4]) {
+    c[0] = 0.5f + 0.4f * std::sin(x * 0.02f);
+    c[1] = 0.5f + 0.4f * std::cos(y * 0.015f);
+    c[2] = 0.5f + 0.3f * std::sin((x + y) * 0.01f);
+    c[3] = 1.0f;
+  });
+}
+
+// 色の違うマスと細い線（uvChecker のような硬い境界）
+Image MakeChecker() {
+  return MakeImage(256, 256, [](float x, float y, float (&c)[4]) {
+    const int cx = int(x) / 32, cy = int(y) / 32;
+    const bool line = int(x) % 32 == 0 || int(y) % 32 == 0;
+    const bool dark = (cx + cy) % 2 == 0;
+    c[0] = line ? 1.0f : (dark ? 0.2f : 0.3f + cx * 0.08f);
+    c[1] = line ? 1.0f : (dark ? 0.2f : 0.9f - cy * 0.08f);
+    c[2] = line ? 1.0f : (dark ? 0.25f : 0.5f);
+    c[3] = 1.0f;
+  });
+}
+
+// 細かいノイズ（grass のような高周波）
+Image MakeNoise() {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> jitter(-0.06f, 0.06f);
+  return MakeImage(256, 256, [&](float x, float y, float (&c)[4]) {
+    const float base = 0.5f + 0.2f * std::sin(x * 0.3f) * std::cos(y * 0.2f);
+    c[0] = base * 0.4f + jitter(rng);
+    c[1] = base + jitter(rng);
+    c[2] = base * 0.3f + jitter(rng);
+    c[3] = 1.0f;
+  });
+}
+
+// 抜きのある画像（fence / circle のようなアルファ）
+Image MakeCutout() {
+  return MakeImage(256, 256, [](float x, float y, float (&c)[4]) {
+    const float dx = std::fmod(x, 64.0f) - 32.0f, dy = std::fmod(y, 64.0f) - 32.0f;
+    const float r = std::sqrt(dx * dx + dy * dy);
+    c[0] = 0.6f + 0.3f * std::sin(x * 0.05f);
+    c[1] = 0.4f;
+    c[2] = 0.3f + 0.3f * std::cos(y * 0.05f);
+    c[3] = std::clamp((24.0f - r) * 0.5f, 0.0f, 1.0f); // 縁だけ半透明
+  });
+}
+
+void TestPsnr() {
+  struct Case {
+    const char *name;
+    Image image;
+    Format format;
+    bool alpha;
+    double minPsnr;
+  };
+  // 下限は実測（括弧内、dB）から 1.5 dB ほど下げた値
+  Case cases[] = {
+      {"smooth", MakeSmooth(), Format::BC1, false, 41.5}, // (43.3)
+      {"smooth", MakeSmooth(), Format::BC7, false, 49.5}, // (51.1)
+      {"checker", MakeChecker(), Format::BC1, false, 39.5}, // (41.0)
+      {"checker", MakeChecker(), Format::BC7, false, 51.5}, // (53.4)
+      {"noise", MakeNoise(), Format::BC1, false, 29.5}, // (31.1)
+      {"noise", MakeNoise(), Format::BC7, false, 30.0}, // (31.8)
+      {"cutout", MakeCutout(), Format::BC3, true, 39.5}, // (41.1)
+      {"cutout", MakeCutout(), Format::BC7, true, 43.0}, // (44.9)
+  };
+  static const char *kNames[] = {"BC1", "BC3", "BC4", "BC5", "BC7"};
+  for (const Case &c : cases) {
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<uint8_t> encoded = Encode(c.format, c.image);
+    const double seconds = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+    const Image decoded = Decode(c.format, encoded, c.image.width, c.image.height);
+    const double psnr = Psnr(c.image, decoded, 0, c.alpha ? 4 : 3);
+    std::printf("%-8s %s %6.2f dB (>= %.1f) %6.1f MPix/s\n", c.name,
+                kNames[int(c.format)], psnr, c.minPsnr,
+                c.image.width * c.image.height / seconds / 1e6);
+    CHECK(psnr >= c.minPsnr);
+  }
+}
+
+void TestNormalMap() {
+  // 高さ場から作った法線を RG に入れ、z は復元して角度を比べる
+  constexpr uint32_t kSize = 256;
+  auto height = [](float x, float y) {
+    return std::sin(x * 0.07f) * std::cos(y * 0.05f) * 8.0f + std::sin((x + y) * 0.31f);
+  };
+  const Image normals = MakeImage(kSize, kSize, [&](float x, float y, float (&c)[4]) {
+    const float dx = height(x + 1, y) - height(x - 1, y);
+    const float dy = height(x, y + 1) - height(x, y - 1);
+    const float length = std::sqrt(dx * dx + dy * dy + 4.0f);
+    c[0] = -dx / length * 0.5f + 0.5f;
+    c[1] = -dy / length * 0.5f + 0.5f;
+    c[2] = 2.0f / length * 0.5f + 0.5f;
+    c[3] = 1.0f;
+  });
+  auto unpack = [](const uint8_t *p, float (&n)[3]) {
+    n[0] = p[0] / 127.5f - 1.0f;
+    n[1] = p[1] / 127.5f - 1.0f;
+    n[2] = std::sqrt(std::max(0.0f, 1.0f - n[0] * n[0] - n[1] * n[1]));
+  };
+  for (Format format : {Format::BC5, Format::BC1}) {
+    const Image decoded = Decode(format, Encode(format, normals), kSize, kSize);
+    double sum = 0.0, worst = 0.0;
+    for (size_t i = 0; i < size_t(kSize) * kSize; ++i) {
+      float a[3], b[3];
+      unpack(&normals.rgba[i * 4], a);
+      unpack(&decoded.rgba[i * 4], b);
+      const float dot = (a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) /
+                        std::sqrt((a[0] * a[0] + a[1] * a[1] + a[2] * a[2]) *
+                                  (b[0] * b[0] + b[1] * b[1] + b[2] * b[2]));
+      const double degrees = std::acos(std::min(1.0f, dot)) * 57.29578;
+      sum += degrees;
+      worst = std::max(worst, degrees);
+    }
+    const double mean = sum / (kSize * kSize);
+    std::printf("normal   %s mean %.2f deg max %.2f deg\n",
+                format == Format::BC5 ? "BC5" : "BC1", mean, worst);
+    if (format == Format::BC5) {
+      CHECK(mean < 1.5 && worst < 6.0);
+    } else {
+      CHECK(mean > 1.5); // BC5 を使う理由
+    }
+  }
+}
+
+void TestEdgesAndSolid() {
+  // 1 色のブロックはほぼそのまま戻る
+  const uint8_t color[4] = {10, 200, 30, 128};
+  for (Format format :
+       {Format::BC1, Format::BC3, Format::BC4, Format::BC5, Format::BC7}) {
+    Image solid{1, 1, {color[0], color[1], color[2], color[3]}};
+    const Image decoded = Decode(format, Encode(format, solid), 1, 1);
+    const int channels = format == Format::BC4 ? 1 : format == Format::BC5 ? 2 : 3;
+    for (int c = 0; c < channels; ++c) {
+      CHECK(std::abs(int(decoded.rgba[c]) - int(color[c])) <= 4);
+    }
+    if (format == Format::BC3 || format == Format::BC7) {
+      CHECK(std::abs(int(decoded.rgba[3]) - int(color[3])) <= 1);
+    }
+  }
+
+  // 半端な大きさ: 外側は端の画素を繰り返す。4 の倍数まで端を伸ばした画像と同じ結果になる
+  for (auto [w, h] : {std::pair{5u, 3u}, std::pair{13u, 7u}, std::pair{2u, 9u}}) {
+    auto gradient = [](float x, float y, float (&c)[4]) {
+      c[0] = x * 0.05f;
+      c[1] = y * 0.05f;
+      c[2] = 0.5f;
+      c[3] = 1.0f;
+    };
+    const Image image = MakeImage(w, h, gradient);
+    const Image padded =
+        MakeImage((w + 3) / 4 * 4, (h + 3) / 4 * 4, [&](float x, float y, float (&c)[4]) {
+          gradient(std::min(x, float(w - 1)), std::min(y, float(h - 1)), c);
+        });
+    CHECK(BcEncoder::GetCompressedSize(Format::BC7, w, h) ==
+          size_t((w + 3) / 4) * ((h + 3) / 4) * 16);
+    for (Format format : {Format::BC1, Format::BC7}) {
+      const std::vector<uint8_t> encoded = Encode(format, image);
+      CHECK(encoded == Encode(format, padded));
+      const Image decoded = Decode(format, encoded, w, h);
+      CHECK(Psnr(image, decoded, 0, 3) > 30.0);
+    }
+  }
+}
+
+void TestParallelMatchesSerial() {
+  const Image image = MakeNoise();
+  for (Format format :
+       {Format::BC1, Format::BC3, Format::BC4, Format::BC5, Format::BC7}) {
+    const std::vector<uint8_t> parallel = Encode(format, image);
+    std::vector<uint8_t> serial(parallel.size());
+    const size_t blockBytes = BcEncoder::GetBlockBytes(format);
+    uint8_t block[64];
+    for (uint32_t by = 0; by < image.height / 4; ++by) {
+      for (uint32_t bx = 0; bx < image.width / 4; ++bx) {
+        for (uint32_t y = 0; y < 4; ++y) {
+          std::memcpy(block + y * 16,
+                      &image.rgba[((by * 4 + y) * size_t(image.width) + bx * 4) * 4],
+                      16);
+        }
+        BcEncoder::EncodeBlock(format, block,
+                               &serial[(by * size_t(image.width / 4) + bx) * blockBytes]);
+      }
+    }
+    CHECK(parallel == serial);
+  }
+}
+
+} // namespace
+
+int main() {
+  JobSystem::GetInstance()->Initialize(4);
+  TestPsnr();
+  TestNormalMap();
+  TestEdgesAndSolid();
+  TestParallelMatchesSerial();
+  JobSystem::GetInstance()->Finalize();
+  return TestCommon::Finish("BcEncoderTest");
+}
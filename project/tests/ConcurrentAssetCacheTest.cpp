@@ -0,0 +1,269 @@
+// ConcurrentAssetCache: 同じパスの同時要求が 1 回の読み込みを共有すること、
+// 予算を超えた時に未参照のものを古い順に追い出すこと
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentAssetCache.h"
+#include "TestCommon.h"
+
+namespace {
+
+struct Asset {
+  int id = 0;
+};
+
+using Cache = ConcurrentAssetCache<Asset>;
+
+void TestConcurrentRequests(Cache::Ownership ownership) {
+  Cache cache(ownership);
+  constexpr int kKeys = 256;
+  constexpr int kThreads = 16;
+  constexpr int kRequests = 5000;
+  std::vector<std::atomic<int>> loads(kKeys);
+  std::atomic<int> wrong{0};
+  // Weak では誰かが持っていないと消えるので、読み込んだ側が持ち続ける
+  std::vector<std::shared_ptr<Asset>> keep(kKeys);
+  std::mutex keepMutex;
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      uint32_t r = uint32_t(t) * 2654435761u + 1;
+      for (int i = 0; i < kRequests; ++i) {
+        r = r * 1664525u + 1013904223u;
+        const int k = int((r >> 8) % kKeys);
+        const std::string key = "res/" + std::to_string(k);
+        Cache::Acquired acquired = cache.Acquire(key);
+        if (acquired.created) {
+          loads[k].fetch_add(1);
+          // 読み込み中に他のスレッドが相乗りできるよう少し待つ
+          std::this_thread::sleep_for(std::chrono::microseconds(50));
+          auto value = std::make_shared<Asset>(Asset{k});
+          {
+            std::lock_guard<std::mutex> lock(keepMutex);
+            keep[k] = value;
+          }
+          cache.Complete(key, acquired.future, value, 1);
+        } else {
+          acquired.future.Wait();
+        }
+        const auto value = acquired.future.Get();
+        if (!value || value->id != k) {
+          wrong.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  const double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+
+  bool once = true;
+  for (const auto &count : loads) {
+    once = once && count.load() <= 1;
+  }
+  CHECK(once);
+  CHECK(wrong.load() == 0);
+  const Cache::Stats stats = cache.GetStats();
+  CHECK(stats.hits + stats.inFlightHits + stats.misses ==
+        uint64_t(kThreads) * kRequests);
+  CHECK(stats.inFlight == 0 && stats.failures == 0);
+  CHECK(stats.bytes == stats.entries);
+  std::printf("%s: %d requests in %.1f ms (hit %llu, in-flight %llu, miss %llu)\n",
+              ownership == Cache::Ownership::Strong ? "Strong" : "Weak",
+              kThreads * kRequests, ms, (unsigned long long)stats.hits,
+              (unsigned long long)stats.inFlightHits,
+              (unsigned long long)stats.misses);
+}
+
+void TestFailureAndPlaceholder() {
+  Cache cache(Cache::Ownership::Strong);
+  auto placeholder = std::make_shared<Asset>(Asset{-1});
+
+  // 読み込み中と失敗時はプレースホルダ
+  Cache::Acquired first = cache.Acquire("x", placeholder);
+  CHECK(first.created);
+  CHECK(first.future.Get() == placeholder && !first.future.IsReady());
+  Cache::Acquired waiter = cache.Acquire("x");
+  CHECK(!waiter.created && waiter.future.IsSameState(first.future));
+  cache.Complete("x", first.future, nullptr);
+  CHECK(waiter.future.GetStatus() == AssetFuture<Asset>::Status::Failed);
+  CHECK(waiter.future.Get() == placeholder);
+  CHECK(cache.GetStats().failures == 1 && cache.GetStats().entries == 0);
+
+  // 失敗したパスは次の要求でもう一度読み込む
+  Cache::Acquired retry = cache.Acquire("x");
+  CHECK(retry.created);
+  cache.Complete("x", retry.future, std::make_shared<Asset>(Asset{7}), 10);
+  Cache::Acquired hit = cache.Acquire("x");
+  CHECK(!hit.created && hit.future.IsReady() && hit.future.Get()->id == 7);
+}
+
+void TestWeak() {
+  Cache cache(Cache::Ownership::Weak);
+  Cache::Acquired acquired = cache.Acquire("w");
+  auto value = std::make_shared<Asset>(Asset{3});
+  cache.Complete("w", acquired.future, value, 5);
+  // future も結果を握らない
+  acquired = {};
+  CHECK(!cache.Acquire("w").created);
+  value.reset();
+  // 誰も持っていなければ読み込み直し（大きさの計上も消える）
+  Cache::Acquired again = cache.Acquire("w");
+  CHECK(again.created);
+  CHECK(cache.GetStats().bytes == 0);
+  cache.Complete("w", again.future, nullptr);
+}
+
+void TestClearWhileLoading() {
+  // 読み込み中の登録は Clear で消えず、担当者の Complete で待っている側が起きる
+  Cache cache(Cache::Ownership::Strong);
+  Cache::Acquired loading = cache.Acquire("p");
+  cache.Complete("done", cache.Acquire("done").future,
+                 std::make_shared<Asset>(Asset{1}), 3);
+  cache.Clear();
+  CHECK(cache.GetStats().entries == 1 && cache.GetStats().bytes == 0);
+  std::thread waiter([&] { loading.future.Wait(); });
+  cache.Complete("p", loading.future, std::make_shared<Asset>(Asset{2}), 4);
+  waiter.join();
+  CHECK(loading.future.Get()->id == 2);
+  CHECK(cache.GetStats().bytes == 4);
+}
+
+// 読み込み済みにする。keep なら結果を返して呼び出し側が参照を持つ
+std::shared_ptr<Asset> Load(Cache &cache, const std::string &key,
+                            uint64_t bytes, bool keep = false) {
+  Cache::Acquired acquired = cache.Acquire(key);
+  if (acquired.created) {
+    cache.Complete(key, acquired.future, std::make_shared<Asset>(), bytes);
+  }
+  return keep ? acquired.future.Get() : nullptr;
+}
+
+// 残っていれば true（最後に使った時刻も更新される）。無ければ登録せずに戻す
+bool Has(Cache &cache, const std::string &key) {
+  Cache::Acquired acquired = cache.Acquire(key);
+  if (acquired.created) {
+    cache.Complete(key, acquired.future, nullptr);
+  }
+  return !acquired.created;
+}
+
+void TestEvictionOrder() {
+  Cache cache(Cache::Ownership::Strong);
+  cache.SetBudget(300);
+  Load(cache, "a", 100);
+  Load(cache, "b", 100);
+  Load(cache, "c", 100);
+  CHECK(cache.GetStats().bytes == 300 && cache.GetStats().evictions == 0);
+  CHECK(Has(cache, "a")); // b が一番古くなる
+  Load(cache, "d", 100);
+  CHECK(cache.GetStats().evictions == 1 && cache.GetStats().bytes == 300);
+  CHECK(!Has(cache, "b"));
+  CHECK(Has(cache, "a") && Has(cache, "c") && Has(cache, "d"));
+
+  // 予算を下げると古い順に収まるまで追い出す（今は a c d の順に古い）
+  cache.SetBudget(150);
+  CHECK(cache.GetStats().bytes == 100 && cache.GetStats().evictions == 3);
+  CHECK(Has(cache, "d"));
+}
+
+void TestReferencedAndPinned() {
+  Cache cache(Cache::Ownership::Strong);
+  cache.SetBudget(200);
+  std::shared_ptr<Asset> held = Load(cache, "a", 100, true);
+  Load(cache, "b", 100);
+  cache.Pin("b", true);
+  Load(cache, "c", 100);
+  // Complete の時点では読み込んだ側がまだ c を持っているので予算を超えたまま
+  CHECK(cache.GetStats().evictions == 0 && cache.GetStats().bytes == 300);
+  // a は参照中、b は固定なので c しか追い出せない
+  cache.Trim();
+  CHECK(cache.GetStats().evictions == 1 && cache.GetStats().bytes == 200);
+  CHECK(!Has(cache, "c"));
+  held.reset();
+  Load(cache, "c", 100);
+  cache.Trim();
+  // 手放した a が c より古い
+  CHECK(cache.GetStats().bytes == 200);
+  CHECK(!Has(cache, "a") && Has(cache, "b") && Has(cache, "c"));
+
+  cache.Pin("b", false);
+  cache.SetBudget(50);
+  CHECK(cache.GetStats().bytes == 0 && cache.GetStats().pinned == 0);
+
+  // 読み込み前の Pin も効く
+  Cache early(Cache::Ownership::Strong);
+  early.Pin("x", true);
+  Load(early, "x", 50);
+  early.SetBudget(10);
+  CHECK(Has(early, "x") && early.GetStats().pinned == 1);
+  early.Pin("x", false);
+  early.Trim();
+  CHECK(early.GetStats().entries == 0);
+  // Pin だけの空の登録は外した時に消える
+  early.Pin("y", true);
+  early.Pin("y", false);
+  CHECK(early.GetStats().entries == 0);
+}
+
+void TestClearUnused() {
+  Cache cache(Cache::Ownership::Strong);
+  Load(cache, "a", 10);
+  std::shared_ptr<Asset> held = Load(cache, "b", 20, true);
+  cache.ClearUnused();
+  CHECK(cache.GetStats().bytes == 20);
+  CHECK(!Has(cache, "a") && Has(cache, "b"));
+}
+
+void TestUpdateBytes() {
+  // 大きさが後から変わる（テクスチャのミップのストリーミング）
+  Cache cache(Cache::Ownership::Strong);
+  cache.SetBudget(300);
+  std::shared_ptr<Asset> a = Load(cache, "a", 100, true);
+  Load(cache, "b", 100);
+  cache.UpdateBytes("a", a.get(), 250); // 増えて予算超過 → 使われていない b を追い出す
+  CHECK(cache.GetStats().bytes == 250);
+  CHECK(cache.GetStats().evictions == 1);
+  cache.UpdateBytes("a", a.get(), 50);
+  CHECK(cache.GetStats().bytes == 50);
+
+  // 別の値・未登録のキーには効かない
+  Asset other;
+  cache.UpdateBytes("a", &other, 999);
+  cache.UpdateBytes("missing", a.get(), 999);
+  CHECK(cache.GetStats().bytes == 50);
+
+  // Clear 後に読み込み直したエントリは、古い値からの更新を受け付けない
+  cache.Clear();
+  std::shared_ptr<Asset> reloaded = Load(cache, "a", 10, true);
+  cache.UpdateBytes("a", a.get(), 999);
+  CHECK(cache.GetStats().bytes == 10);
+  cache.UpdateBytes("a", reloaded.get(), 20);
+  CHECK(cache.GetStats().bytes == 20);
+  CHECK(Has(cache, "a") && !Has(cache, "b"));
+}
+
+} // namespace
+
+int main() {
+  TestConcurrentRequests(Cache::Ownership::Strong);
+  TestConcurrentRequests(Cache::Ownership::Weak);
+  TestFailureAndPlaceholder();
+  TestWeak();
+  TestClearWhileLoading();
+  TestEvictionOrder();
+  TestReferencedAndPinned();
+  TestClearUnused();
+  TestUpdateBytes();
+  return TestCommon::Finish("ConcurrentAssetCacheTest");
+}
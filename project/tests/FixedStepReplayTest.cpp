@@ -0,0 +1,228 @@
+// FixedStepClock と ParticleEmitter の乱数列、SimulateParticles のリプレイ
+// - 表示のフレームレートが違っても、固定ステップの回数が同じなら発生結果と粒子の位置が同じになる
+#include <cstring>
+#include <list>
+#include <vector>
+
+#include "FixedStepClock.h"
+#include "ParticleEmitter.h"
+#include "ParticleManager.h"
+#include "ParticleSimulation.h"
+#include "TestCommon.h"
+
+namespace {
+
+constexpr float kStep = 1.0f / 60.0f;
+
+bool SameRecord(const ParticleManager::EmitRecord &a,
+                const ParticleManager::EmitRecord &b) {
+  // 同じ入力列ならビット単位で同じになるはず
+  return a.name == b.name &&
+         std::memcmp(&a.position, &b.position, sizeof(a.position)) == 0 &&
+         std::memcmp(&a.velocity, &b.velocity, sizeof(a.velocity)) == 0 &&
+         std::memcmp(&a.scale, &b.scale, sizeof(a.scale)) == 0 &&
+         std::memcmp(&a.lifetime, &b.lifetime, sizeof(a.lifetime)) == 0 &&
+         std::memcmp(&a.color, &b.color, sizeof(a.color)) == 0 &&
+         std::memcmp(&a.rotation, &b.rotation, sizeof(a.rotation)) == 0 &&
+         std::memcmp(&a.angularVelocity, &b.angularVelocity,
+                     sizeof(a.angularVelocity)) == 0;
+}
+
+ParticleEmitter::Params MakeParams(uint32_t seed) {
+  ParticleEmitter::Params params;
+  params.groupName = "replay";
+  params.shape = EmitterShape::Sphere;
+  params.emitRate = 37.0f; // 1 ステップあたり端数が出る値
+  params.colorMode = ParticleColorMode::RangeHSV;
+  params.hsvRange = {0.2f, 0.1f, 0.1f};
+  params.rotationMax = 3.0f;
+  params.angularVelocityMin = -1.0f;
+  params.angularVelocityMax = 1.0f;
+  params.randomSeed = seed;
+  return params;
+}
+
+// frameTimes を繰り返し与え、ちょうど totalSteps ステップぶん発生させる
+std::vector<ParticleManager::EmitRecord>
+Run(uint32_t seed, const std::vector<float> &frameTimes, uint32_t totalSteps) {
+  ParticleManager manager;
+  ParticleEmitter emitter(&manager, MakeParams(seed));
+  FixedStepClock clock(kStep);
+  uint32_t stepped = 0;
+  for (size_t frame = 0; stepped < totalSteps; ++frame) {
+    const uint32_t steps = clock.Advance(frameTimes[frame % frameTimes.size()]);
+    for (uint32_t i = 0; i < steps && stepped < totalSteps; ++i, ++stepped) {
+      emitter.Update(clock.GetStep(), {1.0f, 2.0f, 3.0f});
+    }
+    CHECK(clock.GetAlpha() >= 0.0f && clock.GetAlpha() <= 1.0f);
+  }
+  return manager.records;
+}
+
+bool SameParticle(const Particle &a, const Particle &b) {
+  return std::memcmp(&a.transform.translate, &b.transform.translate,
+                     sizeof(a.transform.translate)) == 0 &&
+         std::memcmp(&a.velocity, &b.velocity, sizeof(a.velocity)) == 0 &&
+         std::memcmp(&a.age, &b.age, sizeof(a.age)) == 0 &&
+         std::memcmp(&a.rotation, &b.rotation, sizeof(a.rotation)) == 0 &&
+         std::memcmp(&a.prevTranslate, &b.prevTranslate,
+                     sizeof(a.prevTranslate)) == 0;
+}
+
+// ParticleManager と同じ順（発生 → 固定ステップ 1 回分の更新）で totalSteps ステップ回す
+std::list<Particle> Simulate(float frameTime, uint32_t totalSteps) {
+  ParticleManager manager;
+  ParticleEmitter emitter(&manager, MakeParams(99));
+  // 範囲の一部だけにかかる加速度（出入りで速度の変わり方が変わる）
+  const AccelerationField field{{0.0f, -9.8f, 1.5f},
+                                {{-10.0f, 0.0f, -10.0f}, {10.0f, 10.0f, 10.0f}}};
+
+  std::list<Particle> particles;
+  FixedStepClock clock(kStep);
+  uint32_t stepped = 0;
+  while (stepped < totalSteps) {
+    const uint32_t steps = clock.Advance(frameTime);
+    for (uint32_t i = 0; i < steps && stepped < totalSteps; ++i, ++stepped) {
+      manager.records.clear();
+      emitter.Update(clock.GetStep(), {1.0f, 2.0f, 3.0f});
+      for (const auto &r : manager.records) {
+        particles.push_back(MakeParticle(r.position, r.velocity, r.scale,
+                                         r.lifetime, r.color, r.rotation,
+                                         r.angularVelocity));
+      }
+      SimulateParticles(particles, clock.GetStep(), &field);
+    }
+  }
+  return particles;
+}
+
+void TestClock() {
+  // 60Hz の表示なら毎フレーム 1 ステップ（誤差で 0 / 2 になることはあっても合計は合う）
+  {
+    FixedStepClock clock(kStep);
+    uint32_t total = 0;
+    for (int i = 0; i < 600; ++i) {
+      total += clock.Advance(kStep);
+    }
+    CHECK(total >= 599 && total <= 600);
+  }
+  // 144Hz: 10 秒で 600 ステップ（端数は alpha に残る）
+  {
+    FixedStepClock clock(kStep);
+    uint32_t total = 0;
+    for (int i = 0; i < 1440; ++i) {
+      total += clock.Advance(1.0f / 144.0f);
+    }
+    CHECK(total >= 599 && total <= 600);
+  }
+  // ヒッチ: maxSubSteps で打ち切り、残りは捨てる
+  {
+    FixedStepClock clock(kStep, 4);
+    CHECK(clock.Advance(1.0f) == 4);
+    CHECK(clock.GetDroppedSteps() >= 55 && clock.GetDroppedSteps() <= 56);
+    CHECK(clock.GetAlpha() >= 0.0f && clock.GetAlpha() < 1.0f);
+    CHECK(clock.Advance(kStep * 0.5f) <= 1);
+    CHECK(clock.GetDroppedSteps() == 0);
+  }
+  // 負値・NaN は無視
+  {
+    FixedStepClock clock(kStep);
+    CHECK(clock.Advance(-1.0f) == 0);
+    CHECK(clock.Advance(std::nanf("")) == 0);
+    CHECK(clock.GetAlpha() == 0.0f);
+  }
+  // 刻みを小さくしても端数は 1 刻みを超えない
+  {
+    FixedStepClock clock(kStep);
+    clock.Advance(kStep * 0.9f);
+    clock.SetStep(kStep * 0.5f);
+    CHECK(clock.GetAlpha() <= 1.0f);
+  }
+}
+
+void TestReplay() {
+  constexpr uint32_t kSteps = 600;
+  const std::vector<float> at60 = {kStep};
+  const std::vector<float> at144 = {1.0f / 144.0f};
+  // 不規則なフレーム時間とヒッチ（打ち切られない範囲）
+  const std::vector<float> jittery = {0.011f, 0.033f, 0.004f, 0.021f, 0.1f,
+                                      0.016f, 0.0f,   0.05f};
+
+  const auto reference = Run(1234, at60, kSteps);
+  // 37 / 秒 を 10 秒ぶん
+  CHECK(reference.size() >= 369 && reference.size() <= 370);
+
+  for (const auto *frames : {&at144, &jittery}) {
+    const auto replay = Run(1234, *frames, kSteps);
+    CHECK(replay.size() == reference.size());
+    bool same = replay.size() == reference.size();
+    for (size_t i = 0; same && i < replay.size(); ++i) {
+      same = SameRecord(replay[i], reference[i]);
+    }
+    CHECK(same);
+  }
+
+  // シードが違えば別の列になる
+  const auto other = Run(4321, at60, kSteps);
+  CHECK(other.size() == reference.size());
+  CHECK(!other.empty() && !SameRecord(other[0], reference[0]));
+}
+
+void TestParticleReplay() {
+  constexpr uint32_t kSteps = 600;
+  const std::list<Particle> reference = Simulate(1.0f / 60.0f, kSteps);
+  // 37 / 秒、寿命 1〜3 秒
+  CHECK(reference.size() > 30 && reference.size() < 120);
+
+  // 30 / 144 fps で表示しても、固定ステップ後の粒子はビット単位で同じ
+  for (float frameTime : {1.0f / 30.0f, 1.0f / 144.0f}) {
+    const std::list<Particle> replay = Simulate(frameTime, kSteps);
+    CHECK(replay.size() == reference.size());
+    bool same = replay.size() == reference.size();
+    for (auto a = replay.begin(), b = reference.begin();
+         same && a != replay.end(); ++a, ++b) {
+      same = SameParticle(*a, *b);
+    }
+    CHECK(same);
+  }
+
+  // 寿命が尽きた粒子は取り除かれる
+  std::list<Particle> dying;
+  dying.push_back(MakeParticle({0, 0, 0}, {1, 0, 0}, {1, 1, 1}, kStep * 1.5f,
+                               {1, 1, 1, 1}, 0.0f, 0.0f));
+  SimulateParticles(dying, kStep, nullptr);
+  CHECK(dying.size() == 1);
+  SimulateParticles(dying, kStep, nullptr);
+  CHECK(dying.empty());
+}
+
+void TestInterpolate() {
+  std::list<Particle> particles;
+  particles.push_back(MakeParticle({1, 2, 3}, {6, 0, -6}, {1, 1, 1}, 10.0f,
+                                   {1, 1, 1, 1}, 0.5f, 3.0f));
+  SimulateParticles(particles, 0.5f, nullptr);
+  const Particle &p = particles.front();
+
+  // alpha = 0 は前ステップ、1 は現ステップ、age は巻き戻した分だけ戻る
+  const ParticleSample prev = InterpolateParticle(p, 0.0f, 0.5f);
+  CHECK(prev.translate.x == 1.0f && prev.translate.z == 3.0f);
+  CHECK(prev.rotation == 0.5f && prev.age == 0.0f);
+  const ParticleSample cur = InterpolateParticle(p, 1.0f, 0.0f);
+  CHECK(cur.translate.x == 4.0f && cur.translate.z == 0.0f);
+  CHECK(cur.rotation == 2.0f && cur.age == 0.5f);
+  const ParticleSample half = InterpolateParticle(p, 0.5f, 0.25f);
+  CHECK_NEAR(half.translate.x, 2.5f, 1e-6f);
+  CHECK_NEAR(half.age, 0.25f, 1e-6f);
+  // 巻き戻しで負にならない
+  CHECK(InterpolateParticle(p, 0.0f, 2.0f).age == 0.0f);
+}
+
+} // namespace
+
+int main() {
+  TestClock();
+  TestReplay();
+  TestParticleReplay();
+  TestInterpolate();
+  return TestCommon::Finish("FixedStepReplayTest");
+}
@@ -0,0 +1,170 @@
+// FramePacer のスロット待ちと破棄の予約（GPU の代わりに手で進めるフェンス）
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include "FramePacer.h"
+#include "TestCommon.h"
+
+namespace {
+
+// Signal した値を順に積み、Retire で 1 つずつ「GPU が終わった」ことにする
+class FakeFence : public IFrameFence {
+public:
+  uint64_t GetCompletedValue() const override { return completed; }
+  void Signal(uint64_t value) override { queued.push_back(value); }
+  void WaitForValue(uint64_t value) override {
+    ++waits;
+    while (completed < value && !queued.empty()) {
+      Retire();
+    }
+  }
+
+  void Retire() {
+    if (!queued.empty()) {
+      completed = queued.front();
+      queued.pop_front();
+    }
+  }
+
+  std::deque<uint64_t> queued;
+  uint64_t completed = 0;
+  int waits = 0;
+};
+
+void TestDoubleBuffered() {
+  FakeFence fence;
+  FramePacer pacer;
+  pacer.Initialize(&fence, 2);
+  CHECK(pacer.GetFramesInFlight() == 2);
+  CHECK(pacer.GetFrameIndex() == 0);
+
+  int released = 0;
+  pacer.DeferRelease([&] { ++released; });
+
+  // 1 フレーム目: スロット 1 は未使用なので待たない
+  CHECK(pacer.Advance() == 1);
+  CHECK(pacer.GetFrameIndex() == 1);
+  CHECK(fence.waits == 0 && !pacer.DidStallLastAdvance());
+  CHECK(released == 0);
+
+  // 2 フレーム目: スロット 0 の再利用でフェンス 1 を待ち、予約した破棄が走る
+  CHECK(pacer.Advance() == 2);
+  CHECK(pacer.GetFrameIndex() == 0);
+  CHECK(fence.waits == 1 && pacer.DidStallLastAdvance());
+  CHECK(released == 1);
+
+  // GPU が先に終わっていれば待たない
+  fence.Retire();
+  pacer.Advance();
+  CHECK(fence.waits == 1 && !pacer.DidStallLastAdvance());
+  CHECK(pacer.GetFrameNumber() == 3);
+
+  // WaitIdle は提出済みを全て完了させる（通し番号は進まない）
+  // 記録中のフレームの予約は、そのフレームの Advance のフェンスまで残る
+  pacer.DeferRelease([&] { ++released; });
+  pacer.WaitIdle();
+  CHECK(released == 1);
+  CHECK(fence.queued.empty());
+  CHECK(pacer.GetFrameNumber() == 3);
+  pacer.Advance();
+  CHECK(released == 1);
+  pacer.WaitIdle();
+  CHECK(released == 2);
+}
+
+void TestReleaseOrder() {
+  // 予約はフェンス値の順に、完了した分だけ実行される
+  FakeFence fence;
+  FramePacer pacer;
+  pacer.Initialize(&fence, 3);
+  std::vector<int> order;
+  for (int frame = 0; frame < 3; ++frame) {
+    pacer.DeferRelease([&order, frame] { order.push_back(frame); });
+    pacer.Advance();
+  }
+  // 3 フレーム目の Advance でスロット 0（フェンス 1）を待った分だけ
+  CHECK(order.size() == 1 && order[0] == 0);
+  fence.Retire();
+  pacer.CollectGarbage();
+  CHECK(order.size() == 2 && order[1] == 1);
+  pacer.WaitIdle();
+  const std::vector<int> expected = {0, 1, 2};
+  CHECK(order == expected);
+}
+
+void TestWaitIdleMidFrame() {
+  // フレームの途中（リサイズ・テクスチャの差し替えなど）で WaitIdle しても、
+  // 記録中のリストが参照しているリソースは解放しない
+  FakeFence fence;
+  FramePacer pacer;
+  pacer.Initialize(&fence, 2);
+  std::vector<int> order;
+  pacer.DeferRelease([&] { order.push_back(0); });
+  pacer.Advance(); // フェンス 1 でフレーム 0 を提出
+
+  pacer.DeferRelease([&] { order.push_back(1); }); // フレーム 1 で予約
+  pacer.WaitIdle();
+  // 提出済みのフレーム 0 の分だけ。WaitIdle が打った値はフレーム 1 の提出より前
+  CHECK(order.size() == 1 && order[0] == 0);
+  const uint64_t waited = fence.completed;
+
+  // 同じフレームの中で続けて予約しても同じ扱い
+  pacer.DeferRelease([&] { order.push_back(2); });
+  pacer.WaitIdle();
+  CHECK(order.size() == 1);
+
+  // フレーム 1 の提出後のフェンスが完了して初めて実行される
+  const uint64_t submitted = pacer.Advance();
+  CHECK(submitted > waited);
+  CHECK(order.size() == 1);
+  while (fence.completed < submitted) {
+    fence.Retire();
+  }
+  pacer.CollectGarbage();
+  const std::vector<int> expected = {0, 1, 2};
+  CHECK(order == expected);
+}
+
+void TestFinalize() {
+  // 終了時は提出済みを待った後、記録中のフレームの予約も実行し、以降は即時に解放する
+  FakeFence fence;
+  FramePacer pacer;
+  pacer.Initialize(&fence, 3);
+  std::vector<int> order;
+  pacer.DeferRelease([&] { order.push_back(0); });
+  pacer.Advance();
+  pacer.DeferRelease([&] {
+    order.push_back(1);
+    // 解放の中からの予約も即時
+    pacer.DeferRelease([&] { order.push_back(2); });
+  });
+  CHECK(order.empty());
+  pacer.Finalize();
+  CHECK(fence.queued.empty());
+  const std::vector<int> expected = {0, 1, 2};
+  CHECK(order == expected);
+  pacer.DeferRelease([&] { order.push_back(3); });
+  CHECK(order.size() == 4);
+}
+
+void TestClamp() {
+  FakeFence fence;
+  FramePacer few;
+  few.Initialize(&fence, 0);
+  CHECK(few.GetFramesInFlight() == FramePacer::kMinFramesInFlight);
+  FramePacer many;
+  many.Initialize(&fence, 5);
+  CHECK(many.GetFramesInFlight() == FramePacer::kMaxFramesInFlight);
+}
+
+} // namespace
+
+int main() {
+  TestDoubleBuffered();
+  TestReleaseOrder();
+  TestWaitIdleMidFrame();
+  TestFinalize();
+  TestClamp();
+  return TestCommon::Finish("FramePacerTest");
+}
@@ -0,0 +1,368 @@
+// GltfImporter: 同じ形を書いた OBJ / glTF / GLB が同じ ModelData になること、
+// 同梱の plane の読み込み、ノード階層、壊れた・範囲外の番号を持つファイルの拒否、
+// 100 万三角形の GLB と同じ形の OBJ の読み込み時間
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "GltfImporter.h"
+#include "ObjImporter.h"
+#include "TestCommon.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+fs::path gDir;
+
+std::string ReadFile(const fs::path &path) {
+  std::ifstream ifs(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(ifs), {}};
+}
+
+void WriteFile(const fs::path &path, const void *data, size_t size) {
+  std::ofstream(path, std::ios::binary | std::ios::trunc)
+      .write(static_cast<const char *>(data), std::streamsize(size));
+}
+
+void WriteFile(const fs::path &path, const std::string &text) {
+  WriteFile(path, text.data(), text.size());
+}
+
+// JSON と BIN を 4 バイト境界に揃えて GLB にする
+void WriteGlb(const fs::path &path, std::string json, std::vector<uint8_t> bin) {
+  while (json.size() % 4) {
+    json += ' ';
+  }
+  while (bin.size() % 4) {
+    bin.push_back(0);
+  }
+  std::vector<uint8_t> out;
+  auto u32 = [&](uint32_t v) {
+    out.insert(out.end(), reinterpret_cast<uint8_t *>(&v),
+               reinterpret_cast<uint8_t *>(&v) + 4);
+  };
+  u32(0x46546C67); // "glTF"
+  u32(2);
+  u32(uint32_t(12 + 8 + json.size() + 8 + bin.size()));
+  u32(uint32_t(json.size()));
+  u32(0x4E4F534A); // "JSON"
+  out.insert(out.end(), json.begin(), json.end());
+  u32(uint32_t(bin.size()));
+  u32(0x004E4942); // "BIN\0"
+  out.insert(out.end(), bin.begin(), bin.end());
+  WriteFile(path, out.data(), out.size());
+}
+
+// 三角形の角ごとに頂点の中身が同じか（頂点の並びの違いは問わない）
+bool SameCorners(const MeshData &a, const MeshData &b) {
+  if (a.indices.size() != b.indices.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.indices.size(); ++i) {
+    if (std::memcmp(&a.vertices[a.indices[i]], &b.vertices[b.indices[i]],
+                    sizeof(VertexData)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 起伏のある n x n の格子を name.obj・name.gltf（外部 name.bin）・name.glb に同じ値で書く
+void WriteGrid(const std::string &name, int n) {
+  const int vertexCount = (n + 1) * (n + 1);
+  std::vector<float> positions, normals, texcoords;
+  std::vector<uint32_t> indices;
+  for (int y = 0; y <= n; ++y) {
+    for (int x = 0; x <= n; ++x) {
+      positions.insert(positions.end(),
+                       {x * 0.1f, std::sin(x * 0.3f) * std::cos(y * 0.2f),
+                        y * 0.1f});
+      const float nx = std::sin(float(x)) * 0.5f;
+      const float nz = std::cos(float(y)) * 0.5f;
+      const float length = std::sqrt(nx * nx + 1.0f + nz * nz);
+      normals.insert(normals.end(), {nx / length, 1.0f / length, nz / length});
+      texcoords.insert(texcoords.end(), {x / float(n), 1.0f - y / float(n)});
+    }
+  }
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const uint32_t a = uint32_t(y * (n + 1) + x);
+      const uint32_t c = a + n + 1;
+      indices.insert(indices.end(), {a, c, a + 1, a + 1, c, c + 1});
+    }
+  }
+
+  // OBJ は V が上向き（ObjImporter が反転する）、glTF は下向き
+  std::string obj;
+  char line[160];
+  for (int i = 0; i < vertexCount; ++i) {
+    std::snprintf(line, sizeof(line), "v %.9g %.9g %.9g\n", positions[i * 3],
+                  positions[i * 3 + 1], positions[i * 3 + 2]);
+    obj += line;
+  }
+  for (int i = 0; i < vertexCount; ++i) {
+    std::snprintf(line, sizeof(line), "vt %.9g %.9g\n", texcoords[i * 2],
+                  1.0f - texcoords[i * 2 + 1]);
+    obj += line;
+  }
+  for (int i = 0; i < vertexCount; ++i) {
+    std::snprintf(line, sizeof(line), "vn %.9g %.9g %.9g\n", normals[i * 3],
+                  normals[i * 3 + 1], normals[i * 3 + 2]);
+    obj += line;
+  }
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    const uint32_t a = indices[i] + 1, b = indices[i + 1] + 1,
+                   c = indices[i + 2] + 1;
+    std::snprintf(line, sizeof(line), "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a,
+                  a, b, b, b, c, c, c);
+    obj += line;
+  }
+  WriteFile(gDir / (name + ".obj"), obj);
+
+  std::vector<uint8_t> bin;
+  auto append = [&](const void *data, size_t size) {
+    bin.insert(bin.end(), static_cast<const uint8_t *>(data),
+               static_cast<const uint8_t *>(data) + size);
+  };
+  append(positions.data(), positions.size() * 4);
+  append(normals.data(), normals.size() * 4);
+  append(texcoords.data(), texcoords.size() * 4);
+  append(indices.data(), indices.size() * 4);
+  auto makeJson = [&](const char *uri) {
+    char json[2048];
+    std::snprintf(
+        json, sizeof(json),
+        R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0]}],)"
+        R"("nodes":[{"mesh":0,"name":"grid"}],)"
+        R"("meshes":[{"primitives":[{"attributes":{"POSITION":0,"NORMAL":1,"TEXCOORD_0":2},"indices":3}]}],)"
+        R"("accessors":[{"bufferView":0,"componentType":5126,"count":%d,"type":"VEC3"},)"
+        R"({"bufferView":1,"componentType":5126,"count":%d,"type":"VEC3"},)"
+        R"({"bufferView":2,"componentType":5126,"count":%d,"type":"VEC2"},)"
+        R"({"bufferView":3,"componentType":5125,"count":%zu,"type":"SCALAR"}],)"
+        R"("bufferViews":[{"buffer":0,"byteOffset":0,"byteLength":%d},)"
+        R"({"buffer":0,"byteOffset":%d,"byteLength":%d},)"
+        R"({"buffer":0,"byteOffset":%d,"byteLength":%d},)"
+        R"({"buffer":0,"byteOffset":%d,"byteLength":%zu}],)"
+        R"("buffers":[{"byteLength":%zu%s}]})",
+        vertexCount, vertexCount, vertexCount, indices.size(), vertexCount * 12,
+        vertexCount * 12, vertexCount * 12, vertexCount * 24, vertexCount * 8,
+        vertexCount * 32, indices.size() * 4, bin.size(), uri);
+    return std::string(json);
+  };
+  WriteFile(gDir / (name + ".bin"), bin.data(), bin.size());
+  WriteFile(gDir / (name + ".gltf"),
+            makeJson((R"(,"uri":")" + name + R"(.bin")").c_str()));
+  WriteGlb(gDir / (name + ".glb"), makeJson(""), bin);
+}
+
+void TestParityWithObj() {
+  WriteGrid("grid", 40);
+
+  const std::string dir = gDir.string();
+  ModelData fromObj, fromGltf, fromGlb;
+  CHECK(ObjImporter::Import(dir, dir + "/grid.obj", fromObj));
+  CHECK(GltfImporter::Import(dir, dir + "/grid.gltf", false, false, fromGltf));
+  CHECK(GltfImporter::Import(dir, dir + "/grid.glb", false, false, fromGlb));
+  CHECK(fromObj.meshes.size() == 1 && fromGltf.meshes.size() == 1 &&
+        fromGlb.meshes.size() == 1);
+  if (fromObj.meshes.size() == 1 && fromGltf.meshes.size() == 1 &&
+      fromGlb.meshes.size() == 1) {
+    CHECK(SameCorners(fromGltf.meshes[0], fromObj.meshes[0]));
+    CHECK(SameCorners(fromGlb.meshes[0], fromGltf.meshes[0]));
+  }
+
+  // UV の反転
+  ModelData flipped;
+  CHECK(GltfImporter::Import(dir, dir + "/grid.glb", true, true, flipped));
+  if (!flipped.meshes.empty() && !fromGlb.meshes.empty()) {
+    const VertexData &a = flipped.meshes[0].vertices[5];
+    const VertexData &b = fromGlb.meshes[0].vertices[5];
+    CHECK(a.texcoord.x == 1.0f - b.texcoord.x && a.texcoord.y == 1.0f - b.texcoord.y);
+    CHECK(std::memcmp(&a.position, &b.position, sizeof(a.position)) == 0);
+  }
+}
+
+void TestBundledPlane() {
+  // 同梱の plane は OBJ と glTF で書き出しの軸・分割が違うので、ワールドでの範囲と
+  // 面と法線の向きの関係・マテリアルだけを比べる
+  const std::string dir = std::string(ENGINE_TEST_RESOURCES) + "/plane";
+  ModelData gltf, obj;
+  CHECK(GltfImporter::Import(dir, dir + "/plane.gltf", true, true, gltf));
+  CHECK(ObjImporter::Import(dir, dir + "/plane.obj", obj));
+  for (const ModelData *model : {&gltf, &obj}) {
+    CHECK(model->meshes.size() == 1);
+    if (model->meshes.size() != 1) {
+      continue;
+    }
+    const MeshData &mesh = model->meshes[0];
+    CHECK(mesh.indices.size() == 6 && mesh.vertices.size() == 4);
+    const int material = mesh.materialIndex;
+    CHECK(material >= 0 && size_t(material) < model->materials.size() &&
+          model->materials[size_t(material)].textureFilePath ==
+              dir + "/uvChecker.png");
+    // 左手系・時計回りが表: 面の法線 cross(b - a, c - a) と頂点の法線が同じ向き
+    for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+      const Vector4 &a = mesh.vertices[mesh.indices[i]].position;
+      const Vector4 &b = mesh.vertices[mesh.indices[i + 1]].position;
+      const Vector4 &c = mesh.vertices[mesh.indices[i + 2]].position;
+      const Vector3 n = mesh.vertices[mesh.indices[i]].normal;
+      const float ux = b.x - a.x, uy = b.y - a.y, vx = c.x - a.x, vy = c.y - a.y;
+      CHECK((ux * vy - uy * vx) * n.z > 0.0f);
+    }
+    for (const VertexData &v : mesh.vertices) {
+      CHECK(std::fabs(std::fabs(v.position.x) - 1.0f) < 1e-5f &&
+            std::fabs(std::fabs(v.position.y) - 1.0f) < 1e-5f);
+    }
+  }
+  // glTF の既定マテリアルは最後に足す
+  CHECK(gltf.materials.size() == 2 && gltf.materials.back().textureFilePath.empty());
+  CHECK(gltf.nodes.GetCount() == 1 && gltf.nodes.GetName(0) == "Plane");
+}
+
+std::string Base64(const void *data, size_t size) {
+  static const char *kTable =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  const uint8_t *p = static_cast<const uint8_t *>(data);
+  std::string out;
+  for (size_t i = 0; i < size; i += 3) {
+    const uint32_t n = (uint32_t(p[i]) << 16) |
+                       (i + 1 < size ? uint32_t(p[i + 1]) << 8 : 0) |
+                       (i + 2 < size ? uint32_t(p[i + 2]) : 0);
+    for (int k = 3; k >= 0; --k) {
+      out += (size_t(3 - k) <= size - i) ? kTable[(n >> (k * 6)) & 63] : '=';
+    }
+  }
+  return out;
+}
+
+// インデックス・法線無しの三角形 2 枚を data: URI で。ノードは行列と TRS の両方
+std::string MakeNodesJson(const std::string &bufferView) {
+  const float v[18] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0};
+  return R"({"asset":{"version":"2.0"},"scenes":[{"nodes":[0,2]}],)"
+         R"("nodes":[{"name":"A","matrix":[1,0,0,0, 0,1,0,0, 0,0,1,0, 1,2,3,1],"children":[1]},)"
+         R"({"name":"B","translation":[1,2,3],"mesh":0},)"
+         R"({"mesh":0,"rotation":[0,0.7071068,0,0.7071068]}],)"
+         R"("meshes":[{"primitives":[{"attributes":{"POSITION":0}}]}],)"
+         R"("accessors":[{"bufferView":)" +
+         bufferView +
+         R"(,"componentType":5126,"count":6,"type":"VEC3"}],)"
+         R"("bufferViews":[{"buffer":0,"byteLength":72}],)"
+         R"("buffers":[{"byteLength":72,"uri":"data:application/octet-stream;base64,)" +
+         Base64(v, sizeof(v)) + R"("}]})";
+}
+
+void TestNodes() {
+  WriteFile(gDir / "nodes.gltf", MakeNodesJson("0"));
+  const std::string dir = gDir.string();
+  ModelData model;
+  CHECK(GltfImporter::Import(dir, dir + "/nodes.gltf", false, false, model));
+  CHECK(model.meshes.size() == 1 && model.nodes.GetCount() == 4);
+  if (model.nodes.GetCount() != 4 || model.meshes.size() != 1) {
+    return;
+  }
+  // 複数のルートは 1 つのルートの下にまとめる。z は反転
+  CHECK(model.nodes.GetParent(1) == 0 && model.nodes.GetParent(2) == 1 &&
+        model.nodes.GetParent(3) == 0);
+  CHECK(model.nodes.GetName(2) == "B");
+  const Matrix4x4 &b = model.nodes.GetGlobalMatrix(2);
+  CHECK(b.m[3][0] == 2.0f && b.m[3][1] == 4.0f && b.m[3][2] == -6.0f);
+  CHECK(model.nodes.GetMeshIndices(2).size() == 1 &&
+        model.nodes.GetMeshIndices(3).size() == 1);
+  // 法線が無ければ面から作る（左手系で -z 向き）
+  const MeshData &mesh = model.meshes[0];
+  CHECK(mesh.indices.size() == 6);
+  for (const VertexData &v : mesh.vertices) {
+    CHECK(v.normal.x == 0.0f && v.normal.y == 0.0f && v.normal.z == -1.0f);
+  }
+}
+
+void TestRejects() {
+  const std::string dir = gDir.string();
+  const std::string plane =
+      ReadFile(fs::path(ENGINE_TEST_RESOURCES) / "plane" / "plane.gltf");
+  const std::string broken[] = {
+      "{",
+      R"({"asset":{}})",
+      plane.substr(0, plane.size() / 2),
+  };
+  for (const std::string &text : broken) {
+    WriteFile(gDir / "bad.gltf", text);
+    ModelData model;
+    CHECK(!GltfImporter::Import(dir, dir + "/bad.gltf", true, true, model));
+  }
+
+  // 番号が NaN・無限大・巨大・負・小数なら読まない（size_t への変換で壊れない）
+  for (const char *index : {"1e30", "1e400", "-1e400", "18446744073709551616",
+                            "1.5", "-1", "1"}) {
+    WriteFile(gDir / "index.gltf", MakeNodesJson(index));
+    ModelData model;
+    CHECK(!GltfImporter::Import(dir, dir + "/index.gltf", false, false, model));
+  }
+
+  // アクセサがバッファの外を指す
+  std::string oob = plane;
+  const size_t at = oob.find("\"count\":6");
+  CHECK(at != std::string::npos);
+  oob.replace(at, 9, "\"count\":60");
+  fs::copy_file(fs::path(ENGINE_TEST_RESOURCES) / "plane" / "plane.bin",
+                gDir / "plane.bin", fs::copy_options::overwrite_existing);
+  WriteFile(gDir / "oob.gltf", oob);
+  ModelData model;
+  CHECK(!GltfImporter::Import(dir, dir + "/oob.gltf", true, true, model));
+}
+
+// 709 x 709 頂点の格子（1,002,528 三角形）を GLB と OBJ で読み比べる
+void Benchmark() {
+  WriteGrid("million", 708);
+  const std::string dir = gDir.string();
+  constexpr int kRuns = 3;
+  double glbMs = 0.0;
+  double objMs = 0.0;
+  ModelData fromGlb, fromObj;
+  for (int run = 0; run < kRuns; ++run) {
+    fromGlb = {};
+    auto start = std::chrono::steady_clock::now();
+    CHECK(GltfImporter::Import(dir, dir + "/million.glb", true, true, fromGlb));
+    glbMs += std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - start)
+                 .count();
+    fromObj = {};
+    start = std::chrono::steady_clock::now();
+    CHECK(ObjImporter::Import(dir, dir + "/million.obj", fromObj));
+    objMs += std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - start)
+                 .count();
+  }
+  CHECK(fromGlb.meshes.size() == 1 && fromObj.meshes.size() == 1);
+  if (fromGlb.meshes.size() == 1 && fromObj.meshes.size() == 1) {
+    CHECK(fromGlb.meshes[0].indices.size() == size_t(708) * 708 * 6);
+    CHECK(fromGlb.meshes[0].indices.size() == fromObj.meshes[0].indices.size());
+  }
+  std::printf("GltfImporter: GLB %.1f MB %.1f ms (ObjImporter: OBJ %.1f MB "
+              "%.1f ms)\n",
+              fs::file_size(gDir / "million.glb") / (1024.0 * 1024.0),
+              glbMs / kRuns,
+              fs::file_size(gDir / "million.obj") / (1024.0 * 1024.0),
+              objMs / kRuns);
+}
+
+} // namespace
+
+int main() {
+  gDir = fs::temp_directory_path() / "GltfImporterTest";
+  fs::remove_all(gDir);
+  fs::create_directories(gDir);
+  TestParityWithObj();
+  TestBundledPlane();
+  TestNodes();
+  TestRejects();
+  Benchmark();
+  fs::remove_all(gDir);
+  return TestCommon::Finish("GltfImporterTest");
+}
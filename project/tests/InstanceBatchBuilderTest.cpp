@@ -0,0 +1,124 @@
+// インスタンシングのバッチ作成（GPU 無し）
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "InstanceBatchBuilder.h"
+#include "Method.h"
+#include "TestCommon.h"
+
+namespace {
+
+// キーは不透明なポインタとして使うだけ
+const int kMeshA = 1;
+const int kMeshB = 2;
+
+InstanceMaterial MakeMaterial(float red) {
+  InstanceMaterial material;
+  material.color = {red, 0.0f, 0.0f, 1.0f};
+  material.uvTransform = MakeIdentity4x4();
+  return material;
+}
+
+void TestGrouping() {
+  InstanceBatchBuilder builder;
+  const Matrix4x4 identity = MakeIdentity4x4();
+  // 登録順: A0 B0 A1 A(lod1) A(wire) B1
+  builder.Add(&kMeshA, 0, false, MakeTranslateMatrix({1, 0, 0}), identity,
+              MakeMaterial(0.1f));
+  builder.Add(&kMeshB, 0, false, MakeTranslateMatrix({2, 0, 0}), identity,
+              MakeMaterial(0.2f));
+  builder.Add(&kMeshA, 0, false, MakeTranslateMatrix({3, 0, 0}), identity,
+              MakeMaterial(0.3f));
+  builder.Add(&kMeshA, 1, false, MakeTranslateMatrix({4, 0, 0}), identity,
+              MakeMaterial(0.4f));
+  builder.Add(&kMeshA, 0, true, MakeTranslateMatrix({5, 0, 0}), identity,
+              MakeMaterial(0.5f));
+  builder.Add(&kMeshB, 0, false, MakeTranslateMatrix({6, 0, 0}), identity,
+              MakeMaterial(0.6f));
+  CHECK(builder.GetPendingCount() == 6);
+
+  const Matrix4x4 viewProj = MakeScaleMatrix({2.0f, 2.0f, 2.0f});
+  builder.Build(viewProj);
+  CHECK(builder.GetPendingCount() == 0);
+
+  const auto &batches = builder.GetBatches();
+  const auto &instances = builder.GetInstances();
+  CHECK(instances.size() == 6);
+  // ソリッド（キー・LOD 別）が先、ワイヤーフレームが最後
+  CHECK(batches.size() == 4);
+  if (batches.size() != 4) {
+    return;
+  }
+  CHECK(batches[3].wireframe);
+  CHECK(batches[3].key == &kMeshA && batches[3].instanceCount == 1);
+  uint32_t covered = 0;
+  for (const auto &batch : batches) {
+    CHECK(batch.firstInstance == covered);
+    covered += batch.instanceCount;
+  }
+  CHECK(covered == 6);
+
+  // A・LOD 0 のバッチは登録順（A0 → A1）を保つ
+  for (const auto &batch : batches) {
+    if (batch.key == &kMeshA && batch.lod == 0 && !batch.wireframe) {
+      CHECK(batch.instanceCount == 2);
+      CHECK_NEAR(instances[batch.firstInstance].color.x, 0.1f, 1e-6f);
+      CHECK_NEAR(instances[batch.firstInstance + 1].color.x, 0.3f, 1e-6f);
+    }
+    if (batch.key == &kMeshB) {
+      CHECK(batch.instanceCount == 2);
+      CHECK_NEAR(instances[batch.firstInstance + 1].color.x, 0.6f, 1e-6f);
+    }
+  }
+
+  // WVP = World * ViewProj
+  for (const auto &instance : instances) {
+    CHECK_NEAR(instance.WVP.m[3][0], instance.World.m[3][0] * 2.0f, 1e-5f);
+    CHECK_NEAR(instance.WVP.m[0][0], 2.0f, 1e-6f);
+  }
+
+  // Clear 後は空から
+  builder.Clear();
+  builder.Build(viewProj);
+  CHECK(builder.GetInstances().empty() && builder.GetBatches().empty());
+}
+
+void Benchmark() {
+  // 64 種類のメッシュを 20000 個（岩や小物を散らした場面の想定）
+  static int keys[64];
+  std::mt19937 rng(7);
+  InstanceBatchBuilder builder;
+  const Matrix4x4 identity = MakeIdentity4x4();
+  const InstanceMaterial material = MakeMaterial(1.0f);
+  const Matrix4x4 viewProj = MakePerspectiveFovMatrix(0.8f, 16.0f / 9.0f,
+                                                      0.1f, 1000.0f);
+  constexpr int kInstances = 20000;
+  constexpr int kFrames = 20;
+  double totalMs = 0.0;
+  for (int frame = 0; frame < kFrames; ++frame) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kInstances; ++i) {
+      const float x = float(rng() % 1000);
+      builder.Add(&keys[rng() % 64], rng() % 3, false,
+                  MakeTranslateMatrix({x, 0.0f, x}), identity, material);
+    }
+    builder.Build(viewProj);
+    totalMs += std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+    CHECK(builder.GetInstances().size() == size_t(kInstances));
+    CHECK(builder.GetBatches().size() <= 64 * 3);
+  }
+  std::printf("InstanceBatchBuilder: %d instances -> %zu batches, %.3f ms / "
+              "frame\n",
+              kInstances, builder.GetBatches().size(), totalMs / kFrames);
+}
+
+} // namespace
+
+int main() {
+  TestGrouping();
+  Benchmark();
+  return TestCommon::Finish("InstanceBatchBuilderTest");
+}
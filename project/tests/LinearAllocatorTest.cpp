@@ -0,0 +1,87 @@
+// LinearAllocator（FrameUploadAllocator のスロット内の確保）の境界と確保の速さ
+#include <chrono>
+#include <cstdio>
+
+#include "LinearAllocator.h"
+#include "TestCommon.h"
+
+namespace {
+
+// 定数バッファの配置の単位（D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT）
+constexpr uint64_t kCbAlignment = 256;
+
+void TestAllocate() {
+  LinearAllocator allocator(1024, 4096);
+  CHECK(allocator.GetUsed() == 0 && allocator.GetAllocationCount() == 0);
+
+  // 絶対オフセットで揃える
+  const uint64_t a = allocator.Allocate(100, kCbAlignment);
+  CHECK(a == 1024);
+  const uint64_t b = allocator.Allocate(4, 4);
+  CHECK(b == 1124);
+  const uint64_t c = allocator.Allocate(16, kCbAlignment);
+  CHECK(c == 1280);
+  CHECK(allocator.GetUsed() == 1280 + 16 - 1024);
+  CHECK(allocator.GetAllocationCount() == 3);
+
+  // ちょうど末尾まで
+  const uint64_t rest = 1024 + 4096 - 1536;
+  CHECK(allocator.Allocate(rest, kCbAlignment) == 1536);
+  CHECK(allocator.GetUsed() == 4096);
+  // 0 バイトは末尾でも通る、1 バイトは溢れる
+  CHECK(allocator.Allocate(0, 1) == 1024 + 4096);
+  CHECK(allocator.Allocate(1, 1) == LinearAllocator::kInvalidOffset);
+  CHECK(allocator.GetPeak() == 4096);
+
+  // Reset はピークを残す
+  allocator.Reset();
+  CHECK(allocator.GetUsed() == 0 && allocator.GetAllocationCount() == 0);
+  CHECK(allocator.GetPeak() == 4096);
+  CHECK(allocator.Allocate(8, 8) == 1024);
+}
+
+void TestOverflow() {
+  // 詰め物やサイズで 64bit が回っても、範囲外を返さない
+  LinearAllocator allocator(~0ull - 1023, 512);
+  CHECK(allocator.Allocate(1, 1) == ~0ull - 1023);
+  CHECK(allocator.Allocate(1, 1ull << 63) == LinearAllocator::kInvalidOffset);
+  CHECK(allocator.Allocate(~0ull, 1) == LinearAllocator::kInvalidOffset);
+  CHECK(allocator.GetAllocationCount() == 1);
+
+  // 揃えると範囲を超える
+  LinearAllocator small(0, 300);
+  CHECK(small.Allocate(1, 1) == 0);
+  CHECK(small.Allocate(1, kCbAlignment) == 256);
+  CHECK(small.Allocate(1, kCbAlignment) == LinearAllocator::kInvalidOffset);
+}
+
+void Benchmark() {
+  // 1 フレームで 1 万回の描画ごとの定数を確保する想定
+  constexpr int kFrames = 200;
+  constexpr int kPerFrame = 10000;
+  LinearAllocator allocator(0, uint64_t(kPerFrame) * kCbAlignment * 2);
+  uint64_t sink = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < kFrames; ++frame) {
+    allocator.Reset();
+    for (int i = 0; i < kPerFrame; ++i) {
+      sink += allocator.Allocate(64 + (i & 3) * 64, kCbAlignment);
+    }
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  CHECK(allocator.GetAllocationCount() == kPerFrame);
+  CHECK(sink != LinearAllocator::kInvalidOffset);
+  std::printf("LinearAllocator: %.1f M allocations/s\n",
+              double(kFrames) * kPerFrame / seconds / 1e6);
+}
+
+} // namespace
+
+int main() {
+  TestAllocate();
+  TestOverflow();
+  Benchmark();
+  return TestCommon::Finish("LinearAllocatorTest");
+}
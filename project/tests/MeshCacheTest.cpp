@@ -0,0 +1,274 @@
+// MeshCache の保存・読み込みと、元ファイル・依存ファイルの変更の検出、
+// 初回の取り込み + 書き出しと、書き出したキャッシュからの読み込みの時間
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ObjImporter.h"
+#include "TestCommon.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+const std::string kResources = ENGINE_TEST_RESOURCES;
+
+void WriteText(const fs::path &path, const std::string &text) {
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  ofs << text;
+}
+
+std::string ReadText(const fs::path &path) {
+  std::ifstream ifs(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(ifs), {});
+}
+
+// 更新時刻をずらす（ファイルシステムの時刻の粒度に左右されないように）
+void Touch(const fs::path &path, int seconds) {
+  fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(seconds));
+}
+
+bool SameModel(const ModelData &a, const ModelData &b) {
+  if (a.meshes.size() != b.meshes.size() ||
+      a.materials.size() != b.materials.size() ||
+      a.nodes.GetCount() != b.nodes.GetCount()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.meshes.size(); ++i) {
+    const MeshData &ma = a.meshes[i];
+    const MeshData &mb = b.meshes[i];
+    if (ma.indices != mb.indices || ma.vertices.size() != mb.vertices.size() ||
+        ma.materialIndex != mb.materialIndex ||
+        std::memcmp(ma.vertices.data(), mb.vertices.data(),
+                    ma.vertices.size() * sizeof(VertexData)) != 0) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < a.materials.size(); ++i) {
+    if (a.materials[i].textureFilePath != b.materials[i].textureFilePath) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TestListDependencies() {
+  const std::vector<std::string> obj =
+      MeshCache::ListDependencies(kResources + "/cube/cube.obj");
+  CHECK(obj.size() == 1 && obj[0] == "cube.mtl");
+  const std::vector<std::string> gltf =
+      MeshCache::ListDependencies(kResources + "/plane/plane.gltf");
+  CHECK(gltf.size() == 1 && gltf[0] == "plane.bin");
+}
+
+void TestGltfScan(const fs::path &dir) {
+  // 画像・埋め込み・buffers 以外の uri は入らない。%XX は戻す
+  const fs::path gltf = dir / "scan.gltf";
+  WriteText(gltf, R"({
+  "asset": {"version": "2.0", "extras": {"buffers": [{"uri": "nested.bin"}]}},
+  "images": [{"uri": "tex.png"}],
+  "buffers": [
+    {"byteLength": 4, "uri": "data:application/octet-stream;base64,AAAAAA=="},
+    {"byteLength": 8, "uri": "geo%20main.bin", "extras": {"uri": "x.bin"}},
+    {"uri": "anim\"q.bin", "byteLength": 8}
+  ],
+  "bufferViews": [{"buffer": 1, "uri": "not-a-buffer.bin"}]
+})");
+  const std::vector<std::string> deps = MeshCache::ListDependencies(gltf.string());
+  CHECK(deps.size() == 2);
+  CHECK(deps.size() == 2 && deps[0] == "geo main.bin" && deps[1] == "anim\"q.bin");
+}
+
+void TestStampAndHash(const fs::path &dir) {
+  // 同梱の OBJ / MTL を作業フォルダに写して使う
+  const fs::path obj = dir / "cube.obj";
+  const fs::path mtl = dir / "cube.mtl";
+  fs::copy_file(kResources + "/cube/cube.obj", obj,
+                fs::copy_options::overwrite_existing);
+  fs::copy_file(kResources + "/cube/cube.mtl", mtl,
+                fs::copy_options::overwrite_existing);
+  const std::string source = obj.string();
+  const std::string cachePath = MeshCache::MakeCachePath(source);
+
+  ModelData imported;
+  CHECK(ObjImporter::Import(dir.string(), source, imported));
+  imported.bounds = MeshCache::ComputeBounds(imported);
+
+  MeshCache::CookKey key{};
+  key.importFlags = 0x1234;
+  key.options = 2;
+  CHECK(MeshCache::HashSources(source, key.sourceHash));
+  uint64_t objOnly = 0;
+  CHECK(MeshCache::HashFile(source, objOnly));
+  CHECK(key.sourceHash != objOnly); // mtl も入っている
+  CHECK(MeshCache::Save(cachePath, source, key, imported));
+
+  // ハッシュでも、大きさ・更新時刻だけでも読める
+  MeshCache::CookKey stampOnly = key;
+  stampOnly.sourceHash = 0;
+  ModelData loaded;
+  CHECK(MeshCache::Load(cachePath, source, key, loaded));
+  CHECK(SameModel(imported, loaded));
+  ModelData byStamp;
+  CHECK(MeshCache::Load(cachePath, source, stampOnly, byStamp));
+  CHECK(SameModel(imported, byStamp));
+
+  // 取り込み設定が違えば使わない
+  MeshCache::CookKey otherFlags = key;
+  otherFlags.options = 3;
+  CHECK(!MeshCache::Load(cachePath, source, otherFlags, loaded));
+
+  // MTL だけ書き換える: 時刻でもハッシュでも古いと分かる
+  const std::string originalMtl = ReadText(mtl);
+  WriteText(mtl, originalMtl + "\n# edited\n");
+  Touch(mtl, 10);
+  CHECK(!MeshCache::Load(cachePath, source, stampOnly, loaded));
+  MeshCache::CookKey edited = key;
+  CHECK(MeshCache::HashSources(source, edited.sourceHash));
+  CHECK(edited.sourceHash != key.sourceHash);
+  CHECK(!MeshCache::Load(cachePath, source, edited, loaded));
+
+  // 中身を戻して時刻だけ違う: 時刻では外れ、ハッシュでは当たる
+  WriteText(mtl, originalMtl);
+  Touch(mtl, 20);
+  CHECK(!MeshCache::Load(cachePath, source, stampOnly, loaded));
+  MeshCache::CookKey restored = key;
+  CHECK(MeshCache::HashSources(source, restored.sourceHash));
+  CHECK(restored.sourceHash == key.sourceHash);
+  CHECK(MeshCache::Load(cachePath, source, restored, loaded));
+  // 書き直すと次からは時刻で当たる（AssetLoader と同じ流れ）
+  CHECK(MeshCache::Save(cachePath, source, restored, loaded));
+  CHECK(MeshCache::Load(cachePath, source, stampOnly, byStamp));
+  CHECK(SameModel(imported, byStamp));
+
+  // MTL が無くなった: ハッシュも時刻も変わる
+  fs::remove(mtl);
+  MeshCache::CookKey missing = key;
+  CHECK(MeshCache::HashSources(source, missing.sourceHash));
+  CHECK(missing.sourceHash != key.sourceHash);
+  CHECK(!MeshCache::Load(cachePath, source, stampOnly, loaded));
+
+  // OBJ を書き換えた
+  WriteText(mtl, originalMtl);
+  CHECK(MeshCache::Save(cachePath, source, key, imported));
+  CHECK(MeshCache::Load(cachePath, source, stampOnly, loaded));
+  WriteText(obj, ReadText(obj) + "\n# edited\n");
+  CHECK(!MeshCache::Load(cachePath, source, stampOnly, loaded));
+
+  // 途中で切れたキャッシュは読まない
+  const std::string bytes = ReadText(cachePath);
+  WriteText(cachePath, bytes.substr(0, bytes.size() / 2));
+  CHECK(!MeshCache::Load(cachePath, source, key, loaded));
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// 513 x 513 頂点の格子（524,288 三角形）で、AssetLoader の初回と 2 回目以降の流れを比べる
+// - 初回: OBJ の取り込み → 並べ替え（Cache → Overdraw → Fetch）→ bounds → ハッシュ → 保存
+// - 2 回目以降: 大きさ・更新時刻で当たれば読むだけ / ハッシュを取ってから読む
+void Benchmark(const fs::path &dir) {
+  constexpr int kGrid = 512;
+  const fs::path obj = dir / "grid.obj";
+  {
+    FILE *file = std::fopen(obj.string().c_str(), "wb");
+    CHECK(file != nullptr);
+    if (!file) {
+      return;
+    }
+    for (int y = 0; y <= kGrid; ++y) {
+      for (int x = 0; x <= kGrid; ++x) {
+        std::fprintf(file, "v %.6f %.6f %.6f\nvt %.6f %.6f\n", x * 0.01f,
+                     std::sin(x * 0.05f) * std::cos(y * 0.05f), y * 0.01f,
+                     x / float(kGrid), y / float(kGrid));
+      }
+    }
+    for (int y = 0; y < kGrid; ++y) {
+      for (int x = 0; x < kGrid; ++x) {
+        const int a = y * (kGrid + 1) + x + 1;
+        const int b = a + 1;
+        const int c = a + kGrid + 1;
+        const int d = c + 1;
+        std::fprintf(file, "f %d/%d %d/%d %d/%d\nf %d/%d %d/%d %d/%d\n", a, a,
+                     c, c, b, b, b, b, c, c, d, d);
+      }
+    }
+    std::fclose(file);
+  }
+  const std::string source = obj.string();
+  const std::string cachePath = MeshCache::MakeCachePath(source);
+
+  const auto coldStart = std::chrono::steady_clock::now();
+  ModelData imported;
+  CHECK(ObjImporter::Import(dir.string(), source, imported));
+  const double importMs = ElapsedMs(coldStart);
+  for (MeshData &mesh : imported.meshes) {
+    const size_t vertexCount = mesh.vertices.size();
+    MeshOptimizer::OptimizeVertexCache(mesh.indices, vertexCount);
+    MeshOptimizer::OptimizeOverdraw(mesh.indices, &mesh.vertices[0].position.x,
+                                    sizeof(VertexData), vertexCount);
+    const std::vector<uint32_t> remap =
+        MeshOptimizer::OptimizeVertexFetch(mesh.indices, vertexCount);
+    mesh.vertices = MeshOptimizer::RemapVertices(mesh.vertices, remap);
+  }
+  imported.bounds = MeshCache::ComputeBounds(imported);
+  MeshCache::CookKey key{};
+  CHECK(MeshCache::HashSources(source, key.sourceHash));
+  CHECK(MeshCache::Save(cachePath, source, key, imported));
+  const double coldMs = ElapsedMs(coldStart);
+
+  constexpr int kRuns = 5;
+  MeshCache::CookKey stampOnly = key;
+  stampOnly.sourceHash = 0;
+  double stampMs = 0.0;
+  double hashedMs = 0.0;
+  for (int run = 0; run < kRuns; ++run) {
+    ModelData loaded;
+    auto start = std::chrono::steady_clock::now();
+    CHECK(MeshCache::Load(cachePath, source, stampOnly, loaded));
+    stampMs += ElapsedMs(start);
+    CHECK(SameModel(imported, loaded));
+
+    ModelData hashed;
+    start = std::chrono::steady_clock::now();
+    MeshCache::CookKey current{};
+    CHECK(MeshCache::HashSources(source, current.sourceHash));
+    CHECK(MeshCache::Load(cachePath, source, current, hashed));
+    hashedMs += ElapsedMs(start);
+  }
+
+  size_t triangles = 0;
+  for (const MeshData &mesh : imported.meshes) {
+    triangles += mesh.indices.size() / 3;
+  }
+  CHECK(triangles == size_t(kGrid) * kGrid * 2);
+  std::printf("MeshCache: %zu tris  import + cook %.1f ms (ObjImporter %.1f "
+              "ms)  cooked load %.2f ms (with source hash %.2f ms)\n",
+              triangles, coldMs, importMs, stampMs / kRuns, hashedMs / kRuns);
+}
+
+} // namespace
+
+int main() {
+  const fs::path dir = fs::temp_directory_path() / "MeshCacheTest";
+  std::error_code ec;
+  fs::remove_all(dir, ec);
+  fs::create_directories(dir);
+
+  TestListDependencies();
+  TestGltfScan(dir);
+  TestStampAndHash(dir);
+  Benchmark(dir);
+
+  fs::remove_all(dir, ec);
+  return TestCommon::Finish("MeshCacheTest");
+}
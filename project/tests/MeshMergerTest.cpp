@@ -0,0 +1,146 @@
+// MeshMerger: 同じマテリアルのメッシュをまとめても描く三角形・LOD・ノードの対応が変わらないこと
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+#include "MeshMerger.h"
+#include "Method.h"
+#include "ObjImporter.h"
+#include "TestCommon.h"
+
+namespace {
+
+MeshData MakeMesh(int material, uint32_t vertexCount, float tag,
+                  std::vector<uint32_t> indices) {
+  MeshData m;
+  m.materialIndex = material;
+  for (uint32_t i = 0; i < vertexCount; ++i) {
+    m.vertices.push_back({{tag, float(i), 0.0f, 1.0f}, {}, {0.0f, 0.0f, 1.0f}});
+  }
+  m.indices = std::move(indices);
+  return m;
+}
+
+// 三角形を (頂点の位置の組) で並べた列（頂点番号の振り直しに影響されない）
+using Triangle = std::array<float, 6>;
+std::vector<Triangle> Triangles(const MeshData &m,
+                                const std::vector<uint32_t> &indices) {
+  std::vector<Triangle> out;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    Triangle t{};
+    for (int k = 0; k < 3; ++k) {
+      t[k * 2] = m.vertices[indices[i + k]].position.x;
+      t[k * 2 + 1] = m.vertices[indices[i + k]].position.y;
+    }
+    out.push_back(t);
+  }
+  return out;
+}
+
+void TestSynthetic() {
+  ModelData model;
+  model.meshes.push_back(MakeMesh(1, 3, 10.0f, {0, 1, 2}));
+  model.meshes[0].lods.push_back({{0, 2, 1}, 0.5f});
+  Meshlet meshlet{};
+  meshlet.indexCount = 3;
+  meshlet.radius = 1.0f;
+  model.meshes[0].meshlets.push_back(meshlet);
+  model.meshes.push_back(MakeMesh(0, 4, 20.0f, {0, 1, 2, 2, 1, 3}));
+  model.meshes.push_back(MakeMesh(1, 3, 30.0f, {2, 1, 0}));
+  model.meshes.push_back(MakeMesh(2, 2, 40.0f, {})); // 三角形の無いメッシュ
+  model.materials.resize(3);
+
+  const uint32_t root = model.nodes.AddNode(NodeHierarchy::kNone, "root",
+                                            MakeIdentity4x4());
+  const std::array<uint32_t, 2> meshesA = {0, 2};
+  const std::array<uint32_t, 2> meshesB = {3, 1};
+  model.nodes.AddNode(root, "a", MakeIdentity4x4(), meshesA);
+  model.nodes.AddNode(root, "b", MakeTranslateMatrix({1.0f, 0.0f, 0.0f}),
+                      meshesB);
+  model.nodes.UpdateGlobalMatrices();
+
+  MeshMerger::MergeByMaterial(model);
+  CHECK(model.meshes.size() == 2);
+  if (model.meshes.size() != 2) {
+    return;
+  }
+  const MeshData &m0 = model.meshes[0];
+  const MeshData &m1 = model.meshes[1];
+  CHECK(m0.materialIndex == 0 && m1.materialIndex == 1);
+  CHECK(m0.vertices.size() == 4 && m1.vertices.size() == 6);
+
+  // 元の順（10 → 30）で連結し、後ろのメッシュの番号はずらす
+  const std::vector<uint32_t> indices1 = {0, 1, 2, 5, 4, 3};
+  CHECK(m1.indices == indices1);
+  CHECK(m1.vertices[0].position.x == 10.0f && m1.vertices[3].position.x == 30.0f);
+
+  // LOD の無いメッシュは LOD0 のまま足す
+  CHECK(m0.lods.empty());
+  CHECK(m1.lods.size() == 1);
+  if (m1.lods.size() == 1) {
+    const std::vector<uint32_t> lod1 = {0, 2, 1, 5, 4, 3};
+    CHECK(m1.lods[0].indices == lod1);
+    CHECK(m1.lods[0].error == 0.5f);
+  }
+
+  // メッシュレットの無いメッシュは全体を 1 つの塊にする（範囲は連結後の番号）
+  CHECK(m0.meshlets.size() == 1 && m0.meshlets[0].indexCount == 6);
+  CHECK(m1.meshlets.size() == 2);
+  if (m1.meshlets.size() == 2) {
+    CHECK(m1.meshlets[0].indexStart == 0 && m1.meshlets[0].radius == 1.0f);
+    CHECK(m1.meshlets[1].indexStart == 3 && m1.meshlets[1].indexCount == 3);
+  }
+
+  // ノードはまとめた後の番号を 1 つずつ持ち、行列はそのまま
+  CHECK(model.nodes.GetCount() == 3);
+  CHECK(model.nodes.GetMeshIndices(0).empty());
+  const auto a = model.nodes.GetMeshIndices(1);
+  const auto b = model.nodes.GetMeshIndices(2);
+  CHECK(a.size() == 1 && a[0] == 1);
+  CHECK(b.size() == 1 && b[0] == 0);
+  CHECK(model.nodes.FindNode("b") == 2 && model.nodes.GetParent(2) == 0);
+  CHECK(model.nodes.GetGlobalMatrix(2).m[3][0] == 1.0f);
+}
+
+void TestBundledModels() {
+  for (const char *name : {"multiMesh", "multiMaterial", "sphere"}) {
+    const std::string dir = std::string(ENGINE_TEST_RESOURCES) + "/" + name;
+    ModelData model;
+    CHECK(ObjImporter::Import(dir, dir + "/" + name + ".obj", model));
+
+    // マテリアルごとの三角形（並び順は問わない）
+    std::vector<std::vector<Triangle>> before(model.materials.size() + 1);
+    for (const MeshData &m : model.meshes) {
+      auto tris = Triangles(m, m.indices);
+      auto &dst = before[size_t(m.materialIndex + 1)];
+      dst.insert(dst.end(), tris.begin(), tris.end());
+    }
+
+    MeshMerger::MergeByMaterial(model);
+    std::vector<std::vector<Triangle>> after(before.size());
+    for (size_t i = 0; i < model.meshes.size(); ++i) {
+      const MeshData &m = model.meshes[i];
+      CHECK(i == 0 || model.meshes[i - 1].materialIndex < m.materialIndex);
+      after[size_t(m.materialIndex + 1)] = Triangles(m, m.indices);
+    }
+    for (size_t i = 0; i < before.size(); ++i) {
+      std::sort(before[i].begin(), before[i].end());
+      std::sort(after[i].begin(), after[i].end());
+      CHECK(before[i] == after[i]);
+    }
+    for (uint32_t node = 0; node < model.nodes.GetCount(); ++node) {
+      for (uint32_t mesh : model.nodes.GetMeshIndices(node)) {
+        CHECK(mesh < model.meshes.size());
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main() {
+  TestSynthetic();
+  TestBundledModels();
+  return TestCommon::Finish("MeshMergerTest");
+}
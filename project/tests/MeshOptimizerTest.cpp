@@ -0,0 +1,132 @@
+// MeshOptimizer の並べ替えを同梱のモデルで測る（ACMR の改善と三角形が変わらないこと）
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "MeshOptimizer.h"
+#include "ObjImporter.h"
+#include "TestCommon.h"
+
+namespace {
+
+using Triangle = std::array<float, 9>;
+
+// 位置で見た三角形の集合（向きを保ったまま最小の頂点を先頭に回す）
+std::vector<Triangle> TriangleSet(const std::vector<VertexData> &vertices,
+                                  const std::vector<uint32_t> &indices) {
+  std::vector<Triangle> out;
+  for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+    std::array<std::array<float, 3>, 3> corners;
+    for (int e = 0; e < 3; ++e) {
+      const Vector4 &p = vertices[indices[t + e]].position;
+      corners[e] = {p.x, p.y, p.z};
+    }
+    int first = 0;
+    for (int e = 1; e < 3; ++e) {
+      if (corners[e] < corners[first]) {
+        first = e;
+      }
+    }
+    Triangle tri;
+    for (int e = 0; e < 3; ++e) {
+      for (int c = 0; c < 3; ++c) {
+        tri[e * 3 + c] = corners[(first + e) % 3][c];
+      }
+    }
+    out.push_back(tri);
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+// AssetLoader と同じ順（Cache → Overdraw → Fetch）で並べ替える
+void OptimizeModel(const std::string &name, bool expectGain) {
+  const std::string dir = std::string(ENGINE_TEST_RESOURCES) + "/" + name;
+  ModelData model;
+  CHECK(ObjImporter::Import(dir, dir + "/" + name + ".obj", model));
+  CHECK(!model.meshes.empty());
+
+  for (const MeshData &mesh : model.meshes) {
+    const size_t vertexCount = mesh.vertices.size();
+    std::vector<uint32_t> indices = mesh.indices;
+    const float acmrImported = MeshOptimizer::ComputeACMR(indices, vertexCount);
+
+    MeshOptimizer::OptimizeVertexCache(indices, vertexCount);
+    const float acmrCache = MeshOptimizer::ComputeACMR(indices, vertexCount);
+    MeshOptimizer::OptimizeOverdraw(indices, &mesh.vertices[0].position.x,
+                                    sizeof(VertexData), vertexCount);
+    const float acmrOverdraw = MeshOptimizer::ComputeACMR(indices, vertexCount);
+    const std::vector<uint32_t> remap =
+        MeshOptimizer::OptimizeVertexFetch(indices, vertexCount);
+    const std::vector<VertexData> vertices =
+        MeshOptimizer::RemapVertices(mesh.vertices, remap);
+    const float acmrFetch = MeshOptimizer::ComputeACMR(indices, vertices.size());
+
+    std::printf("%-12s tris %6zu verts %6zu  ACMR imported %.3f cache %.3f "
+                "overdraw %.3f fetch %.3f\n",
+                name.c_str(), indices.size() / 3, vertices.size(), acmrImported,
+                acmrCache, acmrOverdraw, acmrFetch);
+
+    // 並べ替えで悪くならない。オーバードロー用の分割は閾値の範囲まで
+    CHECK(acmrCache <= acmrImported + 1e-4f);
+    CHECK(acmrOverdraw <= acmrCache * 1.05f + 1e-4f);
+    CHECK_NEAR(acmrFetch, acmrOverdraw, 1e-4f);
+    if (expectGain) {
+      // 各頂点が 1 回しかミスしない時の下限（頂点数 / 三角形数）に近い
+      const float lowerBound = float(vertexCount) / float(indices.size() / 3);
+      CHECK(acmrCache < acmrImported * 0.9f);
+      CHECK(acmrCache < lowerBound + 0.25f);
+    }
+
+    // 頂点フェッチの順: インデックスの初出順に 0, 1, 2, ...
+    uint32_t next = 0;
+    bool sequential = true;
+    for (uint32_t index : indices) {
+      if (index == next) {
+        ++next;
+      } else {
+        sequential = sequential && index < next;
+      }
+    }
+    CHECK(sequential && next == vertices.size());
+
+    // 三角形（向き込み）は並べ替え前と同じ
+    CHECK(TriangleSet(vertices, indices) ==
+          TriangleSet(mesh.vertices, mesh.indices));
+  }
+}
+
+void TestSmallInputs() {
+  std::vector<uint32_t> empty;
+  MeshOptimizer::OptimizeVertexCache(empty, 0);
+  CHECK(empty.empty());
+  CHECK(MeshOptimizer::ComputeACMR(empty, 0) == 0.0f);
+
+  // 1 枚の三角形はミス 3
+  std::vector<uint32_t> one = {0, 1, 2};
+  CHECK(MeshOptimizer::ComputeACMR(one, 3) == 3.0f);
+
+  // 使われない頂点は ~0u になり、詰めた数に入らない
+  std::vector<uint32_t> sparse = {4, 2, 7};
+  const std::vector<uint32_t> remap = MeshOptimizer::OptimizeVertexFetch(sparse, 8);
+  const std::vector<uint32_t> expected = {0, 1, 2};
+  CHECK(sparse == expected);
+  CHECK(remap[4] == 0 && remap[2] == 1 && remap[7] == 2);
+  CHECK(remap[0] == ~0u && remap[5] == ~0u);
+}
+
+} // namespace
+
+int main() {
+  TestSmallInputs();
+  // 細かく分割された 2 つは大きく改善する。小さいものは悪くならないことだけ
+  OptimizeModel("sphere", true);
+  OptimizeModel("terrain", true);
+  OptimizeModel("cube", false);
+  OptimizeModel("axis", false);
+  OptimizeModel("multiMesh", false);
+  OptimizeModel("multiMaterial", false);
+  return TestCommon::Finish("MeshOptimizerTest");
+}
@@ -0,0 +1,262 @@
+// MeshSimplifier の LOD 列（三角形数・誤差の申告と実測）と LodSelector の選択・ちらつき防止
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "LodSelector.h"
+#include "MeshSimplifier.h"
+#include "Method.h"
+#include "ObjImporter.h"
+#include "TestCommon.h"
+
+namespace {
+
+struct Point {
+  double x, y, z;
+};
+Point Sub(Point a, Point b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+double Dot(Point a, Point b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+Point ToPoint(const Vector4 &v) { return {v.x, v.y, v.z}; }
+
+// 点と三角形の距離（Ericson, Real-Time Collision Detection 5.1.5）
+double PointTriangleDistance(Point p, Point a, Point b, Point c) {
+  const Point ab = Sub(b, a);
+  const Point ac = Sub(c, a);
+  auto distance = [&](Point q) {
+    const Point d = Sub(p, q);
+    return std::sqrt(Dot(d, d));
+  };
+  const Point ap = Sub(p, a);
+  const double d1 = Dot(ab, ap);
+  const double d2 = Dot(ac, ap);
+  if (d1 <= 0 && d2 <= 0) {
+    return distance(a);
+  }
+  const Point bp = Sub(p, b);
+  const double d3 = Dot(ab, bp);
+  const double d4 = Dot(ac, bp);
+  if (d3 >= 0 && d4 <= d3) {
+    return distance(b);
+  }
+  const double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+    const double v = d1 / (d1 - d3);
+    return distance({a.x + ab.x * v, a.y + ab.y * v, a.z + ab.z * v});
+  }
+  const Point cp = Sub(p, c);
+  const double d5 = Dot(ab, cp);
+  const double d6 = Dot(ac, cp);
+  if (d6 >= 0 && d5 <= d6) {
+    return distance(c);
+  }
+  const double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+    const double w = d2 / (d2 - d6);
+    return distance({a.x + ac.x * w, a.y + ac.y * w, a.z + ac.z * w});
+  }
+  const double va = d3 * d6 - d5 * d4;
+  if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+    const double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    return distance({b.x + (c.x - b.x) * w, b.y + (c.y - b.y) * w,
+                     b.z + (c.z - b.z) * w});
+  }
+  const double denom = 1.0 / (va + vb + vc);
+  const double v = vb * denom;
+  const double w = vc * denom;
+  return distance({a.x + ab.x * v + ac.x * w, a.y + ab.y * v + ac.y * w,
+                   a.z + ab.z * v + ac.z * w});
+}
+
+// 元の頂点から LOD の面までの最大距離（片側ハウスドルフ距離）
+double MeasureError(const std::vector<VertexData> &vertices,
+                    const std::vector<uint32_t> &indices) {
+  double worst = 0.0;
+  for (const VertexData &v : vertices) {
+    double best = 1e30;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+      best = std::min(best, PointTriangleDistance(
+                                ToPoint(v.position),
+                                ToPoint(vertices[indices[t]].position),
+                                ToPoint(vertices[indices[t + 1]].position),
+                                ToPoint(vertices[indices[t + 2]].position)));
+    }
+    worst = std::max(worst, best);
+  }
+  return worst;
+}
+
+double Diagonal(const std::vector<VertexData> &vertices) {
+  Point lo{1e30, 1e30, 1e30};
+  Point hi{-1e30, -1e30, -1e30};
+  for (const VertexData &v : vertices) {
+    lo = {std::min<double>(lo.x, v.position.x), std::min<double>(lo.y, v.position.y),
+          std::min<double>(lo.z, v.position.z)};
+    hi = {std::max<double>(hi.x, v.position.x), std::max<double>(hi.y, v.position.y),
+          std::max<double>(hi.z, v.position.z)};
+  }
+  const Point d = Sub(hi, lo);
+  return std::sqrt(Dot(d, d));
+}
+
+// 波打った N x N の格子（縁は開いている）
+MeshData MakeWavyGrid(int n, float amplitude) {
+  MeshData mesh;
+  for (int y = 0; y <= n; ++y) {
+    for (int x = 0; x <= n; ++x) {
+      const float u = x / float(n);
+      const float v = y / float(n);
+      VertexData d{};
+      d.position = {u * 4.0f, std::sin(u * 6.0f) * std::cos(v * 5.0f) * amplitude,
+                    v * 4.0f, 1.0f};
+      d.texcoord = {u, v};
+      d.normal = {0.0f, 1.0f, 0.0f};
+      mesh.vertices.push_back(d);
+    }
+  }
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const uint32_t a = uint32_t(y * (n + 1) + x);
+      const uint32_t b = a + 1;
+      const uint32_t c = a + uint32_t(n) + 1;
+      const uint32_t e = c + 1;
+      mesh.indices.insert(mesh.indices.end(), {a, c, b, b, c, e});
+    }
+  }
+  return mesh;
+}
+
+// LOD 列の形を確かめ、誤差の実測値を返す
+void CheckLodChain(const char *name, const MeshData &mesh,
+                   const MeshSimplifier::LodChainSettings &settings = {}) {
+  const auto start = std::chrono::steady_clock::now();
+  const std::vector<MeshLod> lods =
+      MeshSimplifier::BuildLodChain(mesh.indices, mesh.vertices, settings);
+  const double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+  const double diagonal = Diagonal(mesh.vertices);
+  std::printf("%s: %zu tris -> %zu LODs (%.2f ms)\n", name,
+              mesh.indices.size() / 3, lods.size(), ms);
+  CHECK(!lods.empty());
+  CHECK(lods.size() <= settings.maxLods);
+
+  size_t previousCount = mesh.indices.size();
+  float previousError = 0.0f;
+  for (size_t l = 0; l < lods.size(); ++l) {
+    const MeshLod &lod = lods[l];
+    bool valid = lod.indices.size() % 3 == 0;
+    for (uint32_t i : lod.indices) {
+      valid = valid && i < mesh.vertices.size();
+    }
+    CHECK(valid);
+    // 2 割以上減っている・誤差は昇順で上限以下
+    CHECK(lod.indices.size() <= previousCount * 8 / 10);
+    CHECK(lod.indices.size() / 3 >= settings.minTriangles);
+    CHECK(lod.error >= previousError);
+    CHECK(lod.error <= settings.maxRelativeError * diagonal * 1.0001);
+
+    const double measured = MeasureError(mesh.vertices, lod.indices);
+    std::printf("  LOD%zu %5zu tris error %.4f (measured %.4f)\n", l + 1,
+                lod.indices.size() / 3, lod.error, measured);
+    // 申告の誤差は実際のずれを超えない側の見積もり（選択で画面上のずれを過小評価しない）
+    CHECK(measured <= lod.error + diagonal * 1e-4);
+    previousCount = lod.indices.size();
+    previousError = lod.error;
+  }
+}
+
+void TestGrid() {
+  CheckLodChain("wavy grid", MakeWavyGrid(48, 0.3f));
+
+  // 平らな格子は誤差ほぼ 0 のまま下限まで減らせる
+  const MeshData flat = MakeWavyGrid(32, 0.0f);
+  float error = -1.0f;
+  const std::vector<uint32_t> simplified =
+      MeshSimplifier::Simplify(flat.indices, flat.vertices, 2 * 3, 1.0f, &error);
+  CHECK(simplified.size() / 3 <= 128);
+  CHECK(error >= 0.0f && error < 1e-4f);
+  CHECK(MeasureError(flat.vertices, simplified) < 1e-4);
+  // 縁の頂点は動かさないので、四隅は残る
+  for (uint32_t corner : {0u, 32u, 33u * 32u, 33u * 33u - 1u}) {
+    CHECK(std::find(simplified.begin(), simplified.end(), corner) !=
+          simplified.end());
+  }
+
+  // 許す誤差が 0 なら曲がった面はほとんど減らない
+  const MeshData wavy = MakeWavyGrid(16, 0.3f);
+  const std::vector<uint32_t> strict =
+      MeshSimplifier::Simplify(wavy.indices, wavy.vertices, 0, 0.0f, &error);
+  CHECK(strict.size() >= wavy.indices.size() * 8 / 10);
+}
+
+void TestBundledModels() {
+  for (const char *name : {"sphere", "terrain"}) {
+    const std::string dir = std::string(ENGINE_TEST_RESOURCES) + "/" + name;
+    ModelData model;
+    CHECK(ObjImporter::Import(dir, dir + "/" + name + ".obj", model));
+    for (const MeshData &mesh : model.meshes) {
+      if (mesh.indices.size() / 3 > 64) {
+        CheckLodChain(name, mesh);
+      }
+    }
+  }
+}
+
+void TestSelector() {
+  const float errors[4] = {0.0f, 0.01f, 0.04f, 0.16f};
+  LodSelector::Settings settings{};
+
+  // 離れる → 近づく。近づく時は余裕の分だけ今の LOD に留まる（30px で LOD2 のまま）
+  const float radii[] = {1000.0f, 50.0f, 20.0f, 5.0f, 20.0f, 30.0f, 1000.0f};
+  const uint32_t expected[] = {0, 1, 2, 3, 2, 2, 0};
+  uint32_t lod = 3;
+  for (size_t i = 0; i < std::size(radii); ++i) {
+    lod = LodSelector::Select(errors, 4, radii[i], lod, settings);
+    CHECK(lod == expected[i]);
+  }
+  // LOD が 1 つなら常に 0
+  CHECK(LodSelector::Select(errors, 1, 0.5f, 0, settings) == 0);
+
+  // 切り替えの境目（100px で LOD1 の誤差がちょうど 1px）付近で揺らす
+  auto countSwitches = [&](float hysteresis) {
+    LodSelector::Settings s = settings;
+    s.hysteresis = hysteresis;
+    uint32_t current = 0;
+    int switches = 0;
+    for (int frame = 0; frame < 400; ++frame) {
+      const float radius = 100.0f + 4.0f * std::sin(frame * 0.3f);
+      const uint32_t next = LodSelector::Select(errors, 4, radius, current, s);
+      switches += next != current ? 1 : 0;
+      current = next;
+    }
+    return switches;
+  };
+  const int without = countSwitches(0.0f);
+  const int with = countSwitches(0.25f);
+  std::printf("LodSelector: %d switches without hysteresis, %d with\n", without,
+              with);
+  CHECK(without >= 20);
+  CHECK(with <= 1);
+
+  // 投影半径: 縦の画角 90 度、720px なら距離 10 の半径 1 は球の手前（距離 9）で 40px
+  const Matrix4x4 view = MakeIdentity4x4();
+  const Matrix4x4 proj = MakePerspectiveFovMatrix(3.14159265f * 0.5f, 16.0f / 9.0f,
+                                                  0.1f, 100.0f);
+  const float r = LodSelector::ProjectedRadius({0.0f, 0.0f, 10.0f}, 1.0f, view,
+                                               proj, 720.0f);
+  CHECK(std::fabs(r - 40.0f) < 0.01f);
+  CHECK(LodSelector::ProjectedRadius({0.0f, 0.0f, 0.5f}, 1.0f, view, proj,
+                                     720.0f) > 1e6f);
+}
+
+} // namespace
+
+int main() {
+  TestGrid();
+  TestBundledModels();
+  TestSelector();
+  return TestCommon::Finish("MeshSimplifierTest");
+}
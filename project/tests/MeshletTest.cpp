@@ -0,0 +1,224 @@
+// MeshletBuilder の分割（三角形を保ち、上限内で連続した範囲）と
+// MeshletCulling の視錐台・裏面カリング（見える三角形を落とさない）
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "MeshOptimizer.h"
+#include "MeshletBuilder.h"
+#include "MeshletCulling.h"
+#include "Method.h"
+#include "ObjImporter.h"
+#include "TestCommon.h"
+
+namespace {
+
+Vector3 PositionOf(const VertexData &v) {
+  return {v.position.x, v.position.y, v.position.z};
+}
+
+Vector3 Subtract(const Vector3 &a, const Vector3 &b) {
+  return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+// 起伏のある格子。上から見て時計回り（左手系・y 上で表が上）
+MeshData MakeGrid(int n) {
+  MeshData mesh;
+  for (int y = 0; y <= n; ++y) {
+    for (int x = 0; x <= n; ++x) {
+      const float u = x / float(n);
+      const float v = y / float(n);
+      VertexData d{};
+      d.position = {u * 100.0f - 50.0f,
+                    std::sin(u * 17.0f) * std::cos(v * 13.0f) * 3.0f,
+                    v * 100.0f - 50.0f, 1.0f};
+      d.normal = {0.0f, 1.0f, 0.0f};
+      mesh.vertices.push_back(d);
+    }
+  }
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      const uint32_t a = uint32_t(y * (n + 1) + x);
+      const uint32_t b = a + 1;
+      const uint32_t c = a + uint32_t(n) + 1;
+      const uint32_t e = c + 1;
+      mesh.indices.insert(mesh.indices.end(), {a, c, b, b, c, e});
+    }
+  }
+  return mesh;
+}
+
+// 回転の違いを無視した三角形の集合
+std::multiset<std::array<uint32_t, 3>>
+TriangleSet(const std::vector<uint32_t> &indices) {
+  std::multiset<std::array<uint32_t, 3>> out;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    std::array<uint32_t, 3> t = {indices[i], indices[i + 1], indices[i + 2]};
+    std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+    out.insert(t);
+  }
+  return out;
+}
+
+bool InsideClip(const Vector3 &p, const Matrix4x4 &m) {
+  const float x = p.x * m.m[0][0] + p.y * m.m[1][0] + p.z * m.m[2][0] + m.m[3][0];
+  const float y = p.x * m.m[0][1] + p.y * m.m[1][1] + p.z * m.m[2][1] + m.m[3][1];
+  const float z = p.x * m.m[0][2] + p.y * m.m[1][2] + p.z * m.m[2][2] + m.m[3][2];
+  const float w = p.x * m.m[0][3] + p.y * m.m[1][3] + p.z * m.m[2][3] + m.m[3][3];
+  return w > 0.0f && std::fabs(x) <= w && std::fabs(y) <= w && z >= 0.0f &&
+         z <= w;
+}
+
+void Check(const char *name, MeshData mesh) {
+  std::vector<uint32_t> &indices = mesh.indices;
+  const std::vector<VertexData> &vertices = mesh.vertices;
+  MeshOptimizer::OptimizeVertexCache(indices, vertices.size());
+  const auto before = TriangleSet(indices);
+
+  const auto buildStart = std::chrono::steady_clock::now();
+  const std::vector<Meshlet> meshlets = MeshletBuilder::Build(indices, vertices);
+  const double buildMs = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - buildStart)
+                             .count();
+
+  // 三角形（向き込み）は変わらず、塊は先頭から隙間なく並ぶ
+  CHECK(TriangleSet(indices) == before);
+  uint32_t position = 0;
+  size_t maxVertices = 0;
+  size_t maxTriangles = 0;
+  size_t cones = 0;
+  bool contiguous = true;
+  bool boundsContain = true;
+  for (const Meshlet &m : meshlets) {
+    contiguous = contiguous && m.indexStart == position && m.indexCount > 0 &&
+                 m.indexCount % 3 == 0;
+    position += m.indexCount;
+    const std::set<uint32_t> unique(indices.begin() + m.indexStart,
+                                    indices.begin() + m.indexStart + m.indexCount);
+    maxVertices = std::max(maxVertices, unique.size());
+    maxTriangles = std::max<size_t>(maxTriangles, m.indexCount / 3);
+    cones += m.coneCutoff <= 1.0f ? 1 : 0;
+    for (uint32_t v : unique) {
+      const Vector3 d = Subtract(PositionOf(vertices[v]), m.center);
+      boundsContain = boundsContain && Length(d) <= m.radius * 1.0001f + 1e-5f;
+    }
+  }
+  CHECK(contiguous && position == indices.size());
+  CHECK(maxVertices <= MeshletBuilder::kMaxVertices);
+  CHECK(maxTriangles <= MeshletBuilder::kMaxTriangles);
+  CHECK(boundsContain);
+  // 塊は上限に近いところまで詰まっている
+  CHECK(indices.size() / 3 <= meshlets.size() * MeshletBuilder::kMaxTriangles);
+  CHECK(indices.size() / 3 >= meshlets.size() * MeshletBuilder::kMaxTriangles / 2);
+
+  // いろいろな位置のカメラで、表向きで視錐台に頂点が入る三角形は必ず描かれる
+  float extent = 0.0f;
+  for (const VertexData &v : vertices) {
+    extent = std::max({extent, std::fabs(v.position.x), std::fabs(v.position.y),
+                       std::fabs(v.position.z)});
+  }
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+  const Matrix4x4 proj =
+      MakePerspectiveFovMatrix(0.9f, 16.0f / 9.0f, 0.1f, 1000.0f);
+  constexpr int kViews = 100;
+  size_t drawnTriangles = 0;
+  size_t wronglyCulled = 0;
+  bool rangesMerged = true;
+  MeshletCulling::Stats stats{};
+  double cullMs = 0.0;
+  for (int view = 0; view < kViews; ++view) {
+    const Vector3 eye = {u(rng) * extent * 1.5f,
+                         u(rng) * extent * 0.8f + extent * 0.5f,
+                         u(rng) * extent * 1.5f};
+    const Vector3 target = {u(rng) * extent * 0.5f, 0.0f,
+                            u(rng) * extent * 0.5f};
+    const Matrix4x4 viewProj =
+        Multiply(MakeLookAtMatrix(eye, target, {0.0f, 1.0f, 0.0f}), proj);
+    const MeshletCulling::Frustum frustum = MeshletCulling::MakeFrustum(viewProj);
+
+    std::vector<MeshletCulling::IndexRange> ranges;
+    const auto start = std::chrono::steady_clock::now();
+    MeshletCulling::Cull(meshlets.data(), meshlets.size(), frustum, eye, true,
+                         ranges, &stats);
+    cullMs += std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+
+    std::vector<uint8_t> drawn(indices.size() / 3, 0);
+    uint32_t end = 0;
+    for (size_t r = 0; r < ranges.size(); ++r) {
+      // 昇順で、隣り合う範囲は 1 つにまとまっている
+      rangesMerged = rangesMerged && (r == 0 || ranges[r].indexStart > end);
+      end = ranges[r].indexStart + ranges[r].indexCount;
+      for (uint32_t i = ranges[r].indexStart; i < end; i += 3) {
+        drawn[i / 3] = 1;
+      }
+      drawnTriangles += ranges[r].indexCount / 3;
+    }
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+      const Vector3 a = PositionOf(vertices[indices[i]]);
+      const Vector3 b = PositionOf(vertices[indices[i + 1]]);
+      const Vector3 c = PositionOf(vertices[indices[i + 2]]);
+      const Vector3 normal = Cross(Subtract(b, a), Subtract(c, a));
+      if (Dot(Subtract(a, eye), normal) >= 0.0f) {
+        continue; // 裏向き
+      }
+      if ((InsideClip(a, viewProj) || InsideClip(b, viewProj) ||
+           InsideClip(c, viewProj)) &&
+          !drawn[i / 3]) {
+        ++wronglyCulled;
+      }
+    }
+  }
+  const double submitted =
+      100.0 * double(drawnTriangles) / double(indices.size() / 3 * kViews);
+  std::printf("%s: %zu tris, %zu meshlets (%zu with cones), build %.2f ms, "
+              "%.1f%% of tris submitted, cull %.4f ms/view\n",
+              name, indices.size() / 3, meshlets.size(), cones, buildMs,
+              submitted, cullMs / kViews);
+  CHECK(wronglyCulled == 0);
+  CHECK(rangesMerged);
+  CHECK(stats.tested == meshlets.size() * kViews);
+  CHECK(stats.frustumCulled > 0 && stats.backfaceCulled > 0);
+  CHECK(submitted < 90.0);
+}
+
+void TestSphere() {
+  const std::string dir = std::string(ENGINE_TEST_RESOURCES) + "/sphere";
+  ModelData model;
+  CHECK(ObjImporter::Import(dir, dir + "/sphere.obj", model));
+  for (const MeshData &mesh : model.meshes) {
+    Check("sphere", mesh);
+  }
+}
+
+void TestSmall() {
+  // 1 つの塊に収まるメッシュ・空のメッシュ
+  MeshData quad = MakeGrid(1);
+  const std::vector<Meshlet> one = MeshletBuilder::Build(quad.indices, quad.vertices);
+  CHECK(one.size() == 1 && one[0].indexCount == 6);
+  std::vector<uint32_t> empty;
+  CHECK(MeshletBuilder::Build(empty, quad.vertices).empty());
+
+  // 平らな塊は円錐で裏面カリングでき、真上からは見える・真下からは裏
+  const Meshlet &m = one[0];
+  CHECK(m.coneCutoff <= 1.0f);
+  CHECK(!MeshletCulling::IsBackFacing(m, {0.0f, 100.0f, 0.0f}));
+  CHECK(MeshletCulling::IsBackFacing(m, {0.0f, -100.0f, 0.0f}));
+}
+
+} // namespace
+
+int main() {
+  TestSmall();
+  TestSphere();
+  Check("grid256", MakeGrid(256));
+  return TestCommon::Finish("MeshletTest");
+}
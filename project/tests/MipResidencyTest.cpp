@@ -0,0 +1,247 @@
+// MipResidency: 1 回の読み込み数の上限と優先順、予算超過時の追い出しの順、
+// 予算に余裕がある間は粗くしない（行き来しない）こと、ComputeDesiredMip の端
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "MipResidency.h"
+#include "TestCommon.h"
+
+namespace {
+
+using Change = MipResidency::Change;
+
+// size x size・1 画素 1 バイトのミップ列（1x1 まで）
+std::vector<uint64_t> MakeMips(uint32_t size) {
+  std::vector<uint64_t> mips;
+  for (uint32_t s = size; s > 0; s >>= 1) {
+    mips.push_back(uint64_t(s) * s);
+  }
+  return mips;
+}
+
+uint64_t Sum(const std::vector<uint64_t> &mips, uint32_t first) {
+  uint64_t bytes = 0;
+  for (size_t i = first; i < mips.size(); ++i) {
+    bytes += mips[i];
+  }
+  return bytes;
+}
+
+// 全員の要求が満たされるまで回す（フレーム番号を進める）
+void Settle(MipResidency &residency, uint64_t &frame,
+            const std::vector<std::pair<MipResidency::Id, uint32_t>> &requests,
+            int maxFrames = 100) {
+  std::vector<Change> changes;
+  for (int i = 0; i < maxFrames; ++i) {
+    ++frame;
+    for (auto [id, mip] : requests) {
+      residency.Request(id, mip, frame);
+    }
+    changes.clear();
+    residency.Update(frame, changes);
+    if (changes.empty()) {
+      return;
+    }
+  }
+}
+
+void TestLoadCapAndOrder() {
+  const std::vector<uint64_t> mips = MakeMips(1024); // 11 段、tail は 128（ミップ 3）
+  MipResidency residency;
+  MipResidency::Settings settings;
+  settings.budgetBytes = 1ull << 30;
+  settings.maxLoadsPerUpdate = 4;
+  residency.SetSettings(settings);
+
+  std::vector<MipResidency::Id> ids;
+  for (int i = 0; i < 6; ++i) {
+    ids.push_back(residency.Register(mips, 3));
+    CHECK(residency.GetResidentMip(ids.back()) == 3);
+  }
+  CHECK(residency.GetStats().residentBytes == 6 * Sum(mips, 3));
+
+  // 6 枚が同時に細かいミップを要求しても 1 回で細かくするのは 4 つまで、1 段ずつ
+  // 差が大きいもの → 同じなら最近使われたもの（同じフレームなら登録順は問わない）
+  uint64_t frame = 1;
+  residency.Request(ids[0], 2, frame);
+  for (int i = 1; i < 6; ++i) {
+    residency.Request(ids[i], 0, frame);
+  }
+  std::vector<Change> changes;
+  residency.Update(frame, changes);
+  CHECK(changes.size() == 4);
+  CHECK(residency.GetStats().starved == 2);
+  for (const Change &change : changes) {
+    CHECK(change.id != ids[0]); // 差が 1 段しかない
+    CHECK(change.residentMip == 2);
+  }
+
+  // 要求し続ければ全員そろう。読み込みは毎回 4 つまで
+  uint32_t updates = 1;
+  for (; updates < 20; ++updates) {
+    ++frame;
+    residency.Request(ids[0], 2, frame);
+    for (int i = 1; i < 6; ++i) {
+      residency.Request(ids[i], 0, frame);
+    }
+    changes.clear();
+    residency.Update(frame, changes);
+    CHECK(changes.size() <= 4);
+    if (changes.empty()) {
+      break;
+    }
+  }
+  CHECK(residency.GetResidentMip(ids[0]) == 2);
+  for (int i = 1; i < 6; ++i) {
+    CHECK(residency.GetResidentMip(ids[i]) == 0);
+  }
+  // 必要な読み込みは 1 + 5 * 3 = 16 回 → 4 回ずつで 4 フレーム
+  CHECK(residency.GetStats().loads == 16);
+  CHECK(updates == 4);
+  CHECK(residency.GetStats().starved == 0);
+  CHECK(residency.GetStats().residentBytes ==
+        Sum(mips, 2) + 5 * Sum(mips, 0));
+}
+
+void TestHysteresis() {
+  const std::vector<uint64_t> mips = MakeMips(1024);
+  MipResidency residency;
+  MipResidency::Settings settings;
+  settings.budgetBytes = 1ull << 30;
+  settings.idleFrames = 10;
+  residency.SetSettings(settings);
+  const MipResidency::Id id = residency.Register(mips, 3);
+
+  uint64_t frame = 0;
+  Settle(residency, frame, {{id, 0}});
+  CHECK(residency.GetResidentMip(id) == 0);
+
+  // 遠ざかって粗いミップで足りるようになっても、使われなくなっても、
+  // 予算に余裕がある間は何も捨てない（近づいた時に読み直さない）
+  const uint32_t loads = residency.GetStats().loads;
+  std::vector<Change> changes;
+  for (int i = 0; i < 50; ++i) {
+    ++frame;
+    if (i < 20) {
+      residency.Request(id, i % 2 == 0 ? 3 : 0, frame); // 近づいたり離れたり
+    }
+    residency.Update(frame, changes);
+  }
+  CHECK(changes.empty());
+  CHECK(residency.GetResidentMip(id) == 0);
+  CHECK(residency.GetStats().loads == loads);
+  CHECK(residency.GetStats().evictions == 0);
+
+  // 予算を下げると、要らなくなった分はまとめて tail まで戻す
+  settings.budgetBytes = Sum(mips, 3);
+  residency.SetSettings(settings);
+  ++frame;
+  residency.Update(frame, changes);
+  CHECK(changes.size() == 1 && residency.GetResidentMip(id) == 3);
+  CHECK(residency.GetStats().evictions == 1);
+  CHECK(residency.GetStats().residentBytes == Sum(mips, 3));
+}
+
+void TestEvictionOrder() {
+  const std::vector<uint64_t> mips = MakeMips(256); // tail 64（ミップ 2）
+  MipResidency residency;
+  MipResidency::Settings settings;
+  settings.budgetBytes = 1ull << 30;
+  settings.maxLoadsPerUpdate = 100;
+  settings.idleFrames = 3; // 要求が 3 フレーム途絶えたら要らないものとして扱う
+  residency.SetSettings(settings);
+
+  const MipResidency::Id old = residency.Register(mips, 2);
+  const MipResidency::Id recent = residency.Register(mips, 2);
+  const MipResidency::Id needed = residency.Register(mips, 2);
+  uint64_t frame = 0;
+  Settle(residency, frame, {{old, 0}, {recent, 0}, {needed, 0}});
+  // old は 5 フレーム前（idleFrames 超え）、recent は 1 フレーム前から要求が無い
+  // （その前は 1 段粗いミップを要求）。needed は使い続ける
+  std::vector<Change> changes;
+  for (int i = 0; i < 5; ++i) {
+    ++frame;
+    residency.Request(needed, 0, frame);
+    if (i < 4) {
+      residency.Request(recent, 1, frame);
+    }
+    residency.Update(frame, changes);
+  }
+  CHECK(changes.empty());
+
+  // 1 枚ぶんのミップ 0 が入らない予算: 使われていない期間が長い old から削る
+  const uint64_t full = Sum(mips, 0);
+  settings.budgetBytes = 3 * full - mips[0];
+  residency.SetSettings(settings);
+  ++frame;
+  residency.Request(needed, 0, frame);
+  residency.Update(frame, changes);
+  CHECK(changes.size() == 1 && changes[0].id == old);
+  CHECK(residency.GetResidentMip(old) == 2); // 要らない分はまとめて
+  CHECK(residency.GetResidentMip(recent) == 0);
+  CHECK(residency.GetResidentMip(needed) == 0);
+
+  // さらに下げる: 次は recent（要求が途絶えたので tail まで）。needed は最後まで残す
+  settings.budgetBytes = full + Sum(mips, 2) + Sum(mips, 1);
+  residency.SetSettings(settings);
+  changes.clear();
+  ++frame;
+  residency.Request(needed, 0, frame);
+  residency.Update(frame, changes);
+  CHECK(residency.GetResidentMip(recent) == 2);
+  CHECK(residency.GetResidentMip(needed) == 0);
+  CHECK(residency.GetStats().residentBytes <= settings.budgetBytes);
+
+  // 必要なものしか残っていなければ、必要なものも 1 段ずつ削る（足りない数は starved）
+  settings.budgetBytes = 3 * Sum(mips, 1);
+  residency.SetSettings(settings);
+  changes.clear();
+  ++frame;
+  residency.Request(needed, 0, frame);
+  residency.Update(frame, changes);
+  CHECK(residency.GetResidentMip(needed) == 1);
+  CHECK(residency.GetStats().residentBytes <= settings.budgetBytes);
+  CHECK(residency.GetStats().starved == 1);
+
+  // 外したものは予算に数えない。番号は使い回す
+  residency.Unregister(needed);
+  CHECK(!residency.IsRegistered(needed));
+  CHECK(residency.GetStats().residentBytes == 2 * Sum(mips, 2));
+  CHECK(residency.Register(mips, 2) == needed);
+}
+
+void TestComputeDesiredMip() {
+  // 画素とテクセルが 1:1 ならミップ 0、半分の大きさに映るなら 1
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, 1024.0f) == 0);
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, 512.0f) == 1);
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, 300.0f) == 1);
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, 256.0f) == 2);
+  // 長い辺で決める
+  CHECK(MipResidency::ComputeDesiredMip(1024, 64, 11, 256.0f) == 2);
+  CHECK(MipResidency::ComputeDesiredMip(64, 1024, 11, 256.0f) == 2);
+  // 拡大表示・無限大は 0
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, 4096.0f) == 0);
+  CHECK(MipResidency::ComputeDesiredMip(
+            1024, 1024, 11, std::numeric_limits<float>::infinity()) == 0);
+  // 映っていない・不正な値は一番粗いミップ
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, 0.0f) == 10);
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, -5.0f) == 10);
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, std::nanf("")) == 10);
+  // 一番粗いミップを超えない
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 4, 1.0f) == 3);
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 0, 1.0f) == 0);
+  // bias は粗い方へずらす（負なら細かい方へ）
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, 512.0f, 1.0f) == 2);
+  CHECK(MipResidency::ComputeDesiredMip(1024, 1024, 11, 512.0f, -1.0f) == 0);
+}
+
+} // namespace
+
+int main() {
+  TestLoadCapAndOrder();
+  TestHysteresis();
+  TestEvictionOrder();
+  TestComputeDesiredMip();
+  return TestCommon::Finish("MipResidencyTest");
+}
@@ -0,0 +1,280 @@
+// NodeHierarchy: 行きがけ順の配列で求めたグローバル行列が再帰で求めたものと一致すること、
+// 部分木だけの更新・名前の検索・MeshCache の往復
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MeshCache.h"
+#include "Method.h"
+#include "NodeHierarchy.h"
+#include "TestCommon.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// 比較用の素朴な木（aiNode と同じ形）
+struct TreeNode {
+  Matrix4x4 local;
+  std::string name;
+  std::vector<uint32_t> meshIndices;
+  std::vector<TreeNode> children;
+};
+
+void CollectGlobals(const TreeNode &node, const Matrix4x4 *parent,
+                    std::vector<Matrix4x4> &out) {
+  const Matrix4x4 global = parent ? Multiply(node.local, *parent) : node.local;
+  out.push_back(global);
+  for (const TreeNode &child : node.children) {
+    CollectGlobals(child, &global, out);
+  }
+}
+
+bool SameMatrix(const Matrix4x4 &a, const Matrix4x4 &b) {
+  return std::memcmp(&a, &b, sizeof(Matrix4x4)) == 0;
+}
+
+constexpr uint32_t kNodeCount = 10000;
+
+struct Fixture {
+  TreeNode root;
+  NodeHierarchy hierarchy;
+};
+
+Fixture Build() {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  auto randomMatrix = [&] {
+    Matrix4x4 m = MakeIdentity4x4();
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        m.m[i][j] += dist(rng) * 0.1f;
+      }
+    }
+    m.m[3][0] = dist(rng);
+    m.m[3][1] = dist(rng);
+    m.m[3][2] = dist(rng);
+    return m;
+  };
+
+  Fixture f;
+  f.root = {randomMatrix(), "node0", {0}, {}};
+  uint32_t made = 1;
+  std::function<void(TreeNode &, int)> grow = [&](TreeNode &node, int depth) {
+    const int children = depth > 12 ? 0 : int(rng() % 5);
+    for (int c = 0; c < children && made < kNodeCount; ++c) {
+      std::vector<uint32_t> meshes;
+      if (made % 3 == 0) {
+        meshes = {made % 7, made % 5};
+      }
+      node.children.push_back(
+          {randomMatrix(), "node" + std::to_string(made++), meshes, {}});
+    }
+    for (TreeNode &child : node.children) {
+      grow(child, depth + 1);
+    }
+  };
+  while (made < kNodeCount) {
+    grow(f.root, 0);
+  }
+
+  // AssetLoader と同じ明示スタックの行きがけ順で詰める
+  struct Pending {
+    const TreeNode *node;
+    uint32_t parent;
+  };
+  f.hierarchy.Reserve(kNodeCount);
+  std::vector<Pending> stack = {{&f.root, NodeHierarchy::kNone}};
+  while (!stack.empty()) {
+    const Pending p = stack.back();
+    stack.pop_back();
+    const uint32_t index = f.hierarchy.AddNode(p.parent, p.node->name,
+                                               p.node->local,
+                                               p.node->meshIndices);
+    for (size_t c = p.node->children.size(); c > 0; --c) {
+      stack.push_back({&p.node->children[c - 1], index});
+    }
+  }
+  f.hierarchy.UpdateGlobalMatrices();
+  return f;
+}
+
+bool IsInSubtree(const NodeHierarchy &h, uint32_t node, uint32_t root) {
+  for (uint32_t p = node; p != NodeHierarchy::kNone; p = h.GetParent(p)) {
+    if (p == root) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TestGlobals(const Fixture &f) {
+  const NodeHierarchy &h = f.hierarchy;
+  CHECK(h.GetCount() == kNodeCount);
+  std::vector<Matrix4x4> reference;
+  CollectGlobals(f.root, nullptr, reference);
+  bool same = reference.size() == h.GetCount();
+  for (uint32_t i = 0; same && i < h.GetCount(); ++i) {
+    same = SameMatrix(reference[i], h.GetGlobalMatrix(i));
+  }
+  CHECK(same);
+  bool parentsFirst = h.GetParent(0) == NodeHierarchy::kNone;
+  for (uint32_t i = 1; i < h.GetCount(); ++i) {
+    parentsFirst = parentsFirst && h.GetParent(i) < i;
+  }
+  CHECK(parentsFirst);
+}
+
+void TestPartialUpdate(Fixture &f) {
+  NodeHierarchy &h = f.hierarchy;
+  const uint32_t target = h.FindNode("node37");
+  CHECK(target != NodeHierarchy::kNone);
+  uint32_t subtree = 0;
+  for (uint32_t i = target; i < h.GetCount(); ++i) {
+    subtree += IsInSubtree(h, i, target) ? 1 : 0;
+  }
+
+  Matrix4x4 moved = h.GetLocalMatrix(target);
+  moved.m[3][1] += 2.0f;
+  h.SetLocalMatrix(target, moved);
+  CHECK(h.UpdateGlobalMatrices() == subtree);
+  CHECK(h.UpdateGlobalMatrices() == 0); // 変更が無ければ何もしない
+
+  // 全体を計算し直したものと同じ
+  NodeHierarchy full = h;
+  full.SetLocalMatrix(0, full.GetLocalMatrix(0));
+  CHECK(full.UpdateGlobalMatrices() == h.GetCount());
+  bool same = true;
+  for (uint32_t i = 0; same && i < h.GetCount(); ++i) {
+    same = SameMatrix(full.GetGlobalMatrix(i), h.GetGlobalMatrix(i));
+  }
+  CHECK(same);
+
+  // 兄弟の部分木を 2 つ同時に変えても、その 2 つだけ
+  const uint32_t a = h.FindNode("node1");
+  const uint32_t b = h.FindNode("node2");
+  uint32_t expected = 0;
+  for (uint32_t i = 0; i < h.GetCount(); ++i) {
+    expected += (IsInSubtree(h, i, a) || IsInSubtree(h, i, b)) ? 1 : 0;
+  }
+  h.SetLocalMatrix(b, h.GetLocalMatrix(b));
+  h.SetLocalMatrix(a, h.GetLocalMatrix(a));
+  CHECK(h.UpdateGlobalMatrices() == expected);
+}
+
+void TestFind(const Fixture &f) {
+  const NodeHierarchy &h = f.hierarchy;
+  bool found = true;
+  for (uint32_t i = 0; i < kNodeCount; i += 97) {
+    const std::string name = "node" + std::to_string(i);
+    const uint32_t node = h.FindNode(name);
+    found = found && node != NodeHierarchy::kNone && h.GetName(node) == name &&
+            h.GetNameId(node) == NodeHierarchy::HashName(name);
+  }
+  CHECK(found);
+  CHECK(h.FindNode("missing") == NodeHierarchy::kNone);
+  CHECK(h.FindNode("") == NodeHierarchy::kNone);
+  CHECK(h.GetMeshIndices(0).size() == 1 && h.GetMeshIndices(0)[0] == 0);
+
+  // 同じ名前は先に追加した方
+  NodeHierarchy dup;
+  const uint32_t first = dup.AddNode(NodeHierarchy::kNone, "same",
+                                     MakeIdentity4x4());
+  dup.AddNode(first, "same", MakeIdentity4x4());
+  CHECK(dup.FindNode("same") == first);
+  dup.Clear();
+  CHECK(dup.GetCount() == 0 && dup.FindNode("same") == NodeHierarchy::kNone);
+}
+
+void TestMeshCacheRoundTrip(const Fixture &f) {
+  const fs::path dir = fs::temp_directory_path() / "NodeHierarchyTest";
+  fs::create_directories(dir);
+  const std::string source = (dir / "tree.obj").string();
+  std::ofstream(source) << "# tree\n";
+  const std::string cachePath = MeshCache::MakeCachePath(source);
+
+  ModelData model;
+  // ノードが指すメッシュ番号（0〜6）は範囲内でないと読み込みで弾かれる
+  model.meshes.resize(7);
+  for (MeshData &mesh : model.meshes) {
+    mesh.vertices.resize(3);
+    mesh.indices = {0, 1, 2};
+  }
+  model.nodes = f.hierarchy;
+  MeshCache::CookKey key{};
+  CHECK(MeshCache::HashSources(source, key.sourceHash));
+  ModelData loaded;
+  CHECK(MeshCache::Save(cachePath, source, key, model));
+  CHECK(MeshCache::Load(cachePath, source, key, loaded));
+
+  const NodeHierarchy &h = f.hierarchy;
+  const NodeHierarchy &r = loaded.nodes;
+  bool same = r.GetCount() == h.GetCount();
+  for (uint32_t i = 0; same && i < h.GetCount(); ++i) {
+    const auto ma = h.GetMeshIndices(i);
+    const auto mb = r.GetMeshIndices(i);
+    same = r.GetParent(i) == h.GetParent(i) && r.GetName(i) == h.GetName(i) &&
+           SameMatrix(r.GetLocalMatrix(i), h.GetLocalMatrix(i)) &&
+           SameMatrix(r.GetGlobalMatrix(i), h.GetGlobalMatrix(i)) &&
+           std::equal(ma.begin(), ma.end(), mb.begin(), mb.end());
+  }
+  CHECK(same);
+  CHECK(r.FindNode("node1234") == h.FindNode("node1234"));
+  fs::remove_all(dir);
+}
+
+double Ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void Benchmark(Fixture &f) {
+  constexpr int kRuns = 200;
+  NodeHierarchy &h = f.hierarchy;
+  volatile float sink = 0.0f;
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRuns; ++i) {
+    std::vector<Matrix4x4> globals;
+    globals.reserve(kNodeCount);
+    CollectGlobals(f.root, nullptr, globals);
+    sink = sink + globals.back().m[3][0];
+  }
+  const double recursiveMs = Ms(start) / kRuns;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRuns; ++i) {
+    h.SetLocalMatrix(0, h.GetLocalMatrix(0));
+    h.UpdateGlobalMatrices();
+    sink = sink + h.GetGlobalMatrix(kNodeCount - 1).m[3][0];
+  }
+  const double flatMs = Ms(start) / kRuns;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRuns; ++i) {
+    sink = sink + float(h.FindNode("node" + std::to_string(i * 50)));
+  }
+  const double findUs = Ms(start) / kRuns * 1000.0;
+  std::printf("NodeHierarchy: %u nodes, globals recursive %.3f ms / flat %.3f "
+              "ms, FindNode %.3f us\n",
+              kNodeCount, recursiveMs, flatMs, findUs);
+}
+
+} // namespace
+
+int main() {
+  Fixture f = Build();
+  TestGlobals(f);
+  TestFind(f);
+  TestMeshCacheRoundTrip(f);
+  TestPartialUpdate(f);
+  Benchmark(f);
+  return TestCommon::Finish("NodeHierarchyTest");
+}
@@ -0,0 +1,315 @@
+// ObjImporter: 行末の扱い・o / g / usemtl の分け方・相対番号・不正な番号の拒否、
+// 大きなファイルを分割して並列に読んでも 1 本で読んだ結果と同じになること、
+// 100 万三角形の OBJ を素朴なパーサ（istringstream）と読み比べた時間
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "JobSystem.h"
+#include "ObjImporter.h"
+#include "TestCommon.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+fs::path gDir;
+
+bool ImportText(const std::string &name, const std::string &text,
+                ModelData &out) {
+  const fs::path path = gDir / name;
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+  return ObjImporter::Import(gDir.string(), path.string(), out);
+}
+
+size_t TriangleCount(const ModelData &model) {
+  size_t count = 0;
+  for (const MeshData &m : model.meshes) {
+    count += m.indices.size() / 3;
+  }
+  return count;
+}
+
+bool SameModel(const ModelData &a, const ModelData &b) {
+  if (a.meshes.size() != b.meshes.size() ||
+      a.nodes.GetCount() != b.nodes.GetCount()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.meshes.size(); ++i) {
+    const MeshData &x = a.meshes[i];
+    const MeshData &y = b.meshes[i];
+    if (x.materialIndex != y.materialIndex || x.indices != y.indices ||
+        x.vertices.size() != y.vertices.size() ||
+        std::memcmp(x.vertices.data(), y.vertices.data(),
+                    x.vertices.size() * sizeof(VertexData)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const char *kQuad = "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+                    "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvn 0 0 1\n";
+
+void TestLineEnds() {
+  // 最後の行に改行が無い・CRLF・行末の空白
+  ModelData noNewline;
+  CHECK(ImportText("a.obj", std::string(kQuad) + "f 1/1/1 2/2/1 3/3/1 4/4/1",
+                   noNewline));
+  CHECK(TriangleCount(noNewline) == 2);
+
+  std::string crlf = std::string(kQuad) + "f 1/1/1 2/2/1 3/3/1 4/4/1  \r\n";
+  for (size_t at = 0; (at = crlf.find('\n', at)) != std::string::npos; at += 2) {
+    if (at == 0 || crlf[at - 1] != '\r') {
+      crlf.insert(at, "\r");
+    }
+  }
+  ModelData windows;
+  CHECK(ImportText("b.obj", crlf, windows));
+  CHECK(SameModel(noNewline, windows));
+
+  // 相対番号・v//vn・v だけ
+  ModelData relative;
+  CHECK(ImportText("c.obj",
+                   std::string(kQuad) + "f -4//-1 -3//-1 -2//-1\nf 1 3 4\n",
+                   relative));
+  CHECK(TriangleCount(relative) == 2);
+
+  // 空・範囲外・0 番は読めない
+  ModelData rejected;
+  CHECK(!ImportText("d.obj", "# nothing\n", rejected));
+  CHECK(!ImportText("e.obj", std::string(kQuad) + "f 1 2 5\n", rejected));
+  CHECK(!ImportText("f.obj", std::string(kQuad) + "f 0 1 2\n", rejected));
+  CHECK(!ImportText("g.obj", std::string(kQuad) + "f -5 1 2\n", rejected));
+  CHECK(!ImportText("h.obj", "v 0 0\nf 1 1 1\n", rejected));
+}
+
+void TestGroups() {
+  // g は名前が変わるたびにオブジェクト（ノード）を分ける。同じ名前が続くなら分けない
+  const std::string text = std::string(kQuad) +
+                           "g first\nf 1 2 3\n"
+                           "g first\nf 1 3 4\n"
+                           "g second extra\nf 1 2 3\n"
+                           "o third\nf 1 2 4\n"
+                           "g second\nf 2 3 4\n" // o の後でもグループ名は second のまま
+                           "g first\nf 1 2 3\n";
+  ModelData model;
+  CHECK(ImportText("groups.obj", text, model));
+  CHECK(model.meshes.size() == 4);
+  CHECK(model.nodes.GetCount() == 5); // ルート + first second third first
+  if (model.nodes.GetCount() == 5) {
+    CHECK(model.nodes.GetName(1) == "first");
+    CHECK(model.nodes.GetName(2) == "second");
+    CHECK(model.nodes.GetName(3) == "third");
+    CHECK(model.nodes.GetName(4) == "first");
+    CHECK(model.nodes.GetMeshIndices(1).size() == 1);
+    CHECK(model.nodes.GetMeshIndices(3).size() == 1);
+  }
+  if (model.meshes.size() == 4) {
+    CHECK(model.meshes[0].indices.size() == 6);
+    CHECK(model.meshes[2].indices.size() == 6);
+  }
+
+  // usemtl はオブジェクトの中でメッシュを分ける（見つからない名前は既定のマテリアル）
+  std::ofstream(gDir / "m.mtl") << "newmtl red\nmap_Kd red.png\nnewmtl blue\n";
+  ModelData materials;
+  CHECK(ImportText("materials.obj",
+                   "mtllib m.mtl\n" + std::string(kQuad) +
+                       "usemtl red\nf 1 2 3\nusemtl blue\nf 1 3 4\n"
+                       "usemtl missing\nf 2 3 4",
+                   materials));
+  CHECK(materials.materials.size() == 3);
+  CHECK(materials.meshes.size() == 3);
+  if (materials.meshes.size() == 3) {
+    CHECK(materials.meshes[0].materialIndex == 1);
+    CHECK(materials.meshes[1].materialIndex == 2);
+    CHECK(materials.meshes[2].materialIndex == 0);
+  }
+  CHECK(materials.materials.size() == 3 &&
+        materials.materials[1].textureFilePath == gDir.string() + "/red.png");
+}
+
+void TestChunkedParse() {
+  // 数 MB の格子（相対番号・o / g / usemtl 入り）を、ワーカー有りと無しで読み比べる
+  constexpr int kN = 300;
+  std::string text = "mtllib m.mtl\n";
+  text.reserve(size_t(kN) * kN * 80);
+  for (int y = 0; y < kN; ++y) {
+    if (y % 50 == 0) {
+      text += "o row" + std::to_string(y) + "\n";
+    }
+    if (y % 70 == 0) {
+      text += "g band" + std::to_string(y / 70) + "\n";
+    }
+    if (y % 40 == 0) {
+      text += y % 80 == 0 ? "usemtl red\n" : "usemtl blue\n";
+    }
+    for (int x = 0; x < kN; ++x) {
+      text += "v " + std::to_string(x) + " " + std::to_string(y) + " " +
+              std::to_string((x * 7 + y * 3) % 5) + "\n";
+      text += "vt " + std::to_string(x / float(kN)) + " " +
+              std::to_string(y / float(kN)) + "\n";
+    }
+    text += "vn 0 0 1\n";
+    for (int x = 0; x + 1 < kN; ++x) {
+      // 今の行の頂点を相対番号で
+      const int a = -(kN - x);
+      const int b = a + 1;
+      text += "f " + std::to_string(a) + "/" + std::to_string(a) + "/-1 " +
+              std::to_string(b) + "/" + std::to_string(b) + "/-1 " +
+              std::to_string(b) + "/" + std::to_string(b) + "/-1\n";
+    }
+  }
+  CHECK(text.size() > (3u << 20));
+
+  ModelData parallel;
+  JobSystem::GetInstance()->Initialize(4);
+  CHECK(ImportText("big.obj", text, parallel));
+  JobSystem::GetInstance()->Finalize();
+  ModelData serial;
+  CHECK(ObjImporter::Import(gDir.string(), (gDir / "big.obj").string(), serial));
+  CHECK(SameModel(parallel, serial));
+  CHECK(TriangleCount(serial) == size_t(kN) * (kN - 1));
+}
+
+// 比較用: getline + istringstream で読み、ObjImporter と同じく (v, vt, vn) の組で溶接する
+// （Assimp は Linux でビルドできないので、その代わりの「よくある実装」）
+bool ImportNaive(const std::string &path, size_t &triangles,
+                 size_t &vertices) {
+  std::ifstream file(path);
+  if (!file) {
+    return false;
+  }
+  std::vector<Vector3> positions;
+  std::vector<Vector2> texcoords;
+  std::vector<Vector3> normals;
+  std::map<std::tuple<int, int, int>, uint32_t> welded;
+  std::vector<uint32_t> indices;
+  std::string line;
+  std::string keyword;
+  std::string corner;
+  while (std::getline(file, line)) {
+    std::istringstream in(line);
+    keyword.clear();
+    in >> keyword;
+    if (keyword == "v") {
+      Vector3 v{};
+      in >> v.x >> v.y >> v.z;
+      positions.push_back(v);
+    } else if (keyword == "vt") {
+      Vector2 t{};
+      in >> t.x >> t.y;
+      texcoords.push_back(t);
+    } else if (keyword == "vn") {
+      Vector3 n{};
+      in >> n.x >> n.y >> n.z;
+      normals.push_back(n);
+    } else if (keyword == "f") {
+      std::vector<uint32_t> polygon;
+      while (in >> corner) {
+        int v = 0, t = 0, n = 0;
+        std::sscanf(corner.c_str(), "%d/%d/%d", &v, &t, &n);
+        auto it = welded.try_emplace({v, t, n}, uint32_t(welded.size())).first;
+        polygon.push_back(it->second);
+      }
+      for (size_t i = 1; i + 1 < polygon.size(); ++i) {
+        indices.insert(indices.end(), {polygon[0], polygon[i], polygon[i + 1]});
+      }
+    }
+  }
+  triangles = indices.size() / 3;
+  vertices = welded.size();
+  return true;
+}
+
+void Benchmark() {
+  // 709 x 709 頂点の格子で 1,002,528 三角形（約 74 MB）
+  constexpr int kGrid = 708;
+  const fs::path path = gDir / "million.obj";
+  {
+    FILE *file = std::fopen(path.string().c_str(), "wb");
+    CHECK(file != nullptr);
+    if (!file) {
+      return;
+    }
+    for (int y = 0; y <= kGrid; ++y) {
+      for (int x = 0; x <= kGrid; ++x) {
+        std::fprintf(file, "v %.6f %.6f %.6f\n", x * 0.01f,
+                     std::sin(x * 0.05f) * std::cos(y * 0.05f), y * 0.01f);
+      }
+    }
+    for (int y = 0; y <= kGrid; ++y) {
+      for (int x = 0; x <= kGrid; ++x) {
+        std::fprintf(file, "vt %.6f %.6f\n", x / float(kGrid),
+                     y / float(kGrid));
+      }
+    }
+    std::fprintf(file, "vn 0 1 0\n");
+    for (int y = 0; y < kGrid; ++y) {
+      for (int x = 0; x < kGrid; ++x) {
+        const int a = y * (kGrid + 1) + x + 1;
+        const int b = a + 1;
+        const int c = a + kGrid + 1;
+        const int d = c + 1;
+        std::fprintf(file, "f %d/%d/1 %d/%d/1 %d/%d/1\nf %d/%d/1 %d/%d/1 %d/%d/1\n",
+                     a, a, c, c, b, b, b, b, c, c, d, d);
+      }
+    }
+    std::fclose(file);
+  }
+  const size_t expectedTriangles = size_t(kGrid) * kGrid * 2;
+  const size_t expectedVertices = size_t(kGrid + 1) * (kGrid + 1);
+
+  constexpr int kRuns = 3;
+  double fastMs = 0.0;
+  for (int run = 0; run < kRuns; ++run) {
+    ModelData model;
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = ObjImporter::Import(gDir.string(), path.string(), model);
+    fastMs += std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    CHECK(ok && model.meshes.size() == 1);
+    CHECK(TriangleCount(model) == expectedTriangles);
+    CHECK(!model.meshes.empty() &&
+          model.meshes[0].vertices.size() == expectedVertices);
+  }
+
+  size_t naiveTriangles = 0;
+  size_t naiveVertices = 0;
+  const auto start = std::chrono::steady_clock::now();
+  CHECK(ImportNaive(path.string(), naiveTriangles, naiveVertices));
+  const double naiveMs = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  CHECK(naiveTriangles == expectedTriangles);
+  CHECK(naiveVertices == expectedVertices);
+
+  std::printf("ObjImporter: %zu tris %.1f MB  %.1f ms (naive istringstream "
+              "%.1f ms)\n",
+              expectedTriangles, fs::file_size(path) / (1024.0 * 1024.0),
+              fastMs / kRuns, naiveMs);
+  fs::remove(path);
+}
+
+} // namespace
+
+int main() {
+  gDir = fs::temp_directory_path() / "ObjImporterTest";
+  fs::remove_all(gDir);
+  fs::create_directories(gDir);
+  TestLineEnds();
+  TestGroups();
+  TestChunkedParse();
+  Benchmark();
+  fs::remove_all(gDir);
+  return TestCommon::Finish("ObjImporterTest");
+}
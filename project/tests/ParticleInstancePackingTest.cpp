@@ -0,0 +1,133 @@
+// フリップブックのコマ選択とインスタンスデータの詰め方
+#include <cmath>
+
+#include "Method.h"
+#include "ParticleInstancePacking.h"
+#include "TestCommon.h"
+
+namespace {
+
+ParticleFlipbook MakeSheet(uint32_t frameCount, float fps, bool loop,
+                           uint32_t startFrame) {
+  ParticleFlipbook flipbook;
+  flipbook.columns = 4;
+  flipbook.rows = 2;
+  flipbook.frameCount = frameCount;
+  flipbook.framesPerSecond = fps;
+  flipbook.loop = loop;
+  flipbook.startFrame = startFrame;
+  return flipbook;
+}
+
+void TestLoop() {
+  // 10 fps・4 コマ・開始 2: 2,3,0,1,2,...
+  const ParticleFlipbook flipbook = MakeSheet(4, 10.0f, true, 2);
+  const uint32_t expected[] = {2, 3, 0, 1, 2, 3, 0, 1};
+  for (uint32_t i = 0; i < 8; ++i) {
+    CHECK(ComputeFlipbookFrame(flipbook, (float(i) + 0.5f) * 0.1f, 1.0f) ==
+          expected[i]);
+  }
+  // 寿命より長く再生しても回り続ける（lifetime は使わない）
+  CHECK(ComputeFlipbookFrame(flipbook, 100.05f, 1.0f) == 2);
+  // 長寿命でも溢れない・範囲内
+  CHECK(ComputeFlipbookFrame(flipbook, 1.0e9f, 1.0f) < 4);
+  CHECK(ComputeFlipbookFrame(flipbook, INFINITY, 1.0f) < 4);
+}
+
+void TestOneShot() {
+  // 1 回再生・開始 2: 2,3 と進んで 3 で止まる（0 / 1 に戻らない）
+  const ParticleFlipbook flipbook = MakeSheet(4, 10.0f, false, 2);
+  CHECK(ComputeFlipbookFrame(flipbook, 0.0f, 1.0f) == 2);
+  CHECK(ComputeFlipbookFrame(flipbook, 0.15f, 1.0f) == 3);
+  CHECK(ComputeFlipbookFrame(flipbook, 0.25f, 1.0f) == 3);
+  CHECK(ComputeFlipbookFrame(flipbook, 0.35f, 1.0f) == 3);
+  CHECK(ComputeFlipbookFrame(flipbook, 50.0f, 1.0f) == 3);
+
+  // 開始 0 なら全コマを通って最後で止まる
+  const ParticleFlipbook fromZero = MakeSheet(4, 10.0f, false, 0);
+  CHECK(ComputeFlipbookFrame(fromZero, 0.05f, 1.0f) == 0);
+  CHECK(ComputeFlipbookFrame(fromZero, 0.35f, 1.0f) == 3);
+  CHECK(ComputeFlipbookFrame(fromZero, 1.0e9f, 1.0f) == 3);
+
+  // 開始コマが frameCount 以上なら折り返す（6 % 4 = 2）
+  CHECK(ComputeFlipbookFrame(MakeSheet(4, 10.0f, false, 6), 0.0f, 1.0f) == 2);
+}
+
+void TestLifetime() {
+  // fps 0: 寿命全体で 1 回（loop は見ない）
+  const ParticleFlipbook flipbook = MakeSheet(8, 0.0f, true, 0);
+  CHECK(ComputeFlipbookFrame(flipbook, 0.0f, 2.0f) == 0);
+  CHECK(ComputeFlipbookFrame(flipbook, 0.26f, 2.0f) == 1);
+  CHECK(ComputeFlipbookFrame(flipbook, 1.0f, 2.0f) == 4);
+  CHECK(ComputeFlipbookFrame(flipbook, 1.99f, 2.0f) == 7);
+  CHECK(ComputeFlipbookFrame(flipbook, 2.0f, 2.0f) == 7);
+  CHECK(ComputeFlipbookFrame(flipbook, 5.0f, 2.0f) == 7);
+
+  // 同じ 8 コマでも fps 指定なら寿命に関係なく 1 秒 8 コマ
+  const ParticleFlipbook timed = MakeSheet(8, 8.0f, false, 0);
+  CHECK(ComputeFlipbookFrame(timed, 0.5f, 2.0f) == 4);
+  CHECK(ComputeFlipbookFrame(timed, 0.5f, 10.0f) == 4);
+  CHECK(ComputeFlipbookFrame(flipbook, 0.5f, 10.0f) == 0);
+
+  // 寿命で再生・開始 4: 残りの 4..7 を寿命全体に割り振る
+  const ParticleFlipbook offset = MakeSheet(8, 0.0f, false, 4);
+  CHECK(ComputeFlipbookFrame(offset, 0.0f, 1.0f) == 4);
+  CHECK(ComputeFlipbookFrame(offset, 0.5f, 1.0f) == 6);
+  CHECK(ComputeFlipbookFrame(offset, 1.0f, 1.0f) == 7);
+
+  // 寿命 0・負の age・NaN でも範囲内
+  CHECK(ComputeFlipbookFrame(flipbook, 1.0f, 0.0f) == 0);
+  CHECK(ComputeFlipbookFrame(flipbook, -1.0f, 1.0f) == 0);
+  CHECK(ComputeFlipbookFrame(flipbook, std::nanf(""), 1.0f) == 0);
+}
+
+void TestStaticAndUV() {
+  // frameCount 1 なら startFrame がそのままセル
+  CHECK(ComputeFlipbookFrame(MakeSheet(1, 10.0f, true, 5), 3.0f, 1.0f) == 5);
+  // frameCount はセル数に抑える
+  CHECK(ComputeFlipbookFrame(MakeSheet(100, 0.0f, false, 0), 1.0f, 1.0f) == 7);
+
+  const ParticleFlipbook flipbook = MakeSheet(8, 0.0f, false, 0);
+  const Vector4 rect = MakeFlipbookUVRect(flipbook, 6); // 2 行目の 3 列目
+  CHECK_NEAR(rect.x, 0.5f, 1e-6f);
+  CHECK_NEAR(rect.y, 0.5f, 1e-6f);
+  CHECK_NEAR(rect.z, 0.25f, 1e-6f);
+  CHECK_NEAR(rect.w, 0.5f, 1e-6f);
+  // 範囲外は折り返す
+  const Vector4 wrapped = MakeFlipbookUVRect(flipbook, 9);
+  CHECK_NEAR(wrapped.x, 0.25f, 1e-6f);
+  CHECK_NEAR(wrapped.y, 0.0f, 1e-6f);
+}
+
+void TestPacking() {
+  // 単位行列のビューならビルボードは軸そのまま
+  const BillboardBasis basis = MakeBillboardBasis(MakeIdentity4x4());
+  CHECK_NEAR(basis.right.x, 1.0f, 1e-6f);
+  CHECK_NEAR(basis.up.y, 1.0f, 1e-6f);
+
+  const float quarter = 3.14159265f * 0.5f;
+  const ParticleForGPU packed = PackParticleInstance(
+      basis, MakeIdentity4x4(), {2.0f, 3.0f, 1.0f}, quarter,
+      {4.0f, 5.0f, 6.0f}, {1, 0.5f, 0.25f, 1}, {0.25f, 0.5f, 0.25f, 0.5f});
+  // 90 度回すと right は up 方向、up は -right 方向（拡大率込み）
+  CHECK_NEAR(packed.World.m[0][0], 0.0f, 1e-5f);
+  CHECK_NEAR(packed.World.m[0][1], 2.0f, 1e-5f);
+  CHECK_NEAR(packed.World.m[1][0], -3.0f, 1e-5f);
+  CHECK_NEAR(packed.World.m[1][1], 0.0f, 1e-5f);
+  CHECK_NEAR(packed.World.m[3][0], 4.0f, 1e-6f);
+  CHECK_NEAR(packed.World.m[3][2], 6.0f, 1e-6f);
+  CHECK_NEAR(packed.WVP.m[3][1], 5.0f, 1e-6f);
+  CHECK_NEAR(packed.color.y, 0.5f, 1e-6f);
+  CHECK_NEAR(packed.uvRect.w, 0.5f, 1e-6f);
+}
+
+} // namespace
+
+int main() {
+  TestLoop();
+  TestOneShot();
+  TestLifetime();
+  TestStaticAndUV();
+  TestPacking();
+  return TestCommon::Finish("ParticleInstancePackingTest");
+}
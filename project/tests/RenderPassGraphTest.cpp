@@ -0,0 +1,177 @@
+// パスの依存関係と、並べ替え済みの列を範囲ごとに並列で記録する流れ（GPU 無し）
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+#include "JobSystem.h"
+#include "RecordingBackend.h"
+#include "RenderPassGraph.h"
+#include "RenderQueue.h"
+#include "TestCommon.h"
+
+namespace {
+
+using Call = RecordingBackend::Call;
+
+void TestDefaultOrder() {
+  RenderPassGraph graph = RenderPassGraph::MakeDefault();
+  CHECK(graph.Compile());
+  const std::vector<uint32_t> expected = {
+      uint32_t(RenderPass::Opaque),    uint32_t(RenderPass::Skybox),
+      uint32_t(RenderPass::Transparent), uint32_t(RenderPass::Particles),
+      uint32_t(RenderPass::Sprites),   RenderPassGraph::kImGuiPass};
+  CHECK(graph.GetOrder() == expected);
+  // ImGui は RenderQueue に載らない
+  const std::vector<RenderPass> queueOrder = graph.GetQueuePassOrder();
+  CHECK(queueOrder.size() == 5);
+  CHECK(queueOrder.front() == RenderPass::Opaque);
+  CHECK(queueOrder.back() == RenderPass::Sprites);
+}
+
+void TestCustomGraph() {
+  // スプライトを不透明の前に（UI を背景として描く等）
+  RenderPassGraph graph;
+  graph.AddPass(uint32_t(RenderPass::Sprites), "Sprites");
+  graph.AddPass(uint32_t(RenderPass::Opaque), "Opaque");
+  graph.AddPass(uint32_t(RenderPass::Transparent), "Transparent");
+  graph.AddPass(uint32_t(RenderPass::Opaque), "Duplicate"); // 無視される
+  graph.AddDependency(uint32_t(RenderPass::Sprites), uint32_t(RenderPass::Opaque));
+  graph.AddDependency(uint32_t(RenderPass::Opaque), uint32_t(RenderPass::Transparent));
+  graph.AddDependency(uint32_t(RenderPass::Opaque), uint32_t(RenderPass::Transparent));
+  CHECK(graph.Compile());
+  const std::vector<uint32_t> expected = {uint32_t(RenderPass::Sprites),
+                                          uint32_t(RenderPass::Opaque),
+                                          uint32_t(RenderPass::Transparent)};
+  CHECK(graph.GetOrder() == expected);
+  CHECK(graph.GetName(uint32_t(RenderPass::Opaque)) == "Opaque");
+
+  // 依存の無いノード同士は id の小さい順（決定的）
+  RenderPassGraph loose;
+  loose.AddPass(3, "c");
+  loose.AddPass(1, "a");
+  loose.AddPass(2, "b");
+  CHECK(loose.Compile());
+  const std::vector<uint32_t> sorted = {1, 2, 3};
+  CHECK(loose.GetOrder() == sorted);
+
+  // 循環は失敗
+  RenderPassGraph cycle;
+  cycle.AddPass(0, "a");
+  cycle.AddPass(1, "b");
+  cycle.AddDependency(0, 1);
+  cycle.AddDependency(1, 0);
+  CHECK(!cycle.Compile());
+}
+
+void TestJobSystem() {
+  JobSystem *jobs = JobSystem::GetInstance();
+
+  // 入口・出口の処理は各ワーカーで 1 回ずつ（AssetLoadQueue の COM 初期化に使う）
+  std::atomic<int> started{0};
+  std::atomic<int> exited{0};
+  jobs->Initialize(4, {[&started] { started.fetch_add(1); },
+                       [&exited] { exited.fetch_add(1); }});
+  jobs->Dispatch(64, [](uint32_t) {});
+  jobs->Finalize();
+  CHECK(started.load() == 4);
+  CHECK(exited.load() == 4);
+
+  jobs->Initialize(3);
+  CHECK(jobs->GetWorkerCount() == 3);
+
+  std::vector<std::atomic<int>> hits(1000);
+  jobs->Dispatch(1000, [&](uint32_t i) { hits[i].fetch_add(1); });
+  bool once = true;
+  for (auto &hit : hits) {
+    once = once && hit.load() == 1;
+  }
+  CHECK(once);
+
+  std::atomic<int> done{0};
+  for (int i = 0; i < 64; ++i) {
+    jobs->Submit([&done] { done.fetch_add(1); });
+  }
+  jobs->WaitIdle();
+  CHECK(done.load() == 64);
+}
+
+// Renderer::Draw と同じ分け方で、範囲ごとに別のバックエンドへ並列に記録する
+void TestParallelSlices() {
+  JobSystem *jobs = JobSystem::GetInstance();
+
+  for (uint32_t listCount : {1u, 2u, 3u, 4u, 7u}) {
+    RenderQueue queue;
+    RenderPassGraph graph = RenderPassGraph::MakeDefault();
+    graph.Compile();
+    queue.SetPassOrder(graph.GetQueuePassOrder());
+
+    // パス・パイプライン・テクスチャを混ぜた 500 コマンド
+    for (uint32_t i = 0; i < 500; ++i) {
+      RenderCommand cmd{};
+      cmd.subset = i;
+      cmd.pipeline = i % 3;
+      cmd.texture = 1 + i % 5;
+      cmd.geometry = 1 + i % 7;
+      RenderSortKey::Fields key{};
+      key.pass = static_cast<RenderPass>(i % 5);
+      key.pipeline = cmd.pipeline;
+      key.material = uint32_t(cmd.texture);
+      key.depth = 500 - i;
+      cmd.sortKey = RenderSortKey::Make(key);
+      queue.Submit(cmd);
+    }
+
+    // 1 本のバックエンドで再生した時の順序
+    RenderQueue serialQueue = queue;
+    RecordingBackend serial;
+    serialQueue.Execute(serial);
+
+    queue.Sort();
+    const size_t total = queue.Size();
+    std::vector<RecordingBackend> backends(listCount);
+    std::vector<RenderQueueStats> sliceStats(listCount);
+    jobs->Dispatch(listCount, [&](uint32_t i) {
+      const size_t begin = total * i / listCount;
+      const size_t end = total * (i + 1) / listCount;
+      queue.ExecuteRange(backends[i], begin, end, sliceStats[i]);
+    });
+
+    // 提出順（範囲の順）に繋げると、1 本で記録した時と同じ描画順
+    std::vector<uint64_t> drawOrder;
+    size_t pipelineBinds = 0;
+    for (const RecordingBackend &backend : backends) {
+      const auto order = backend.DrawOrder();
+      drawOrder.insert(drawOrder.end(), order.begin(), order.end());
+      pipelineBinds += backend.Count(Call::Pipeline);
+      // 各範囲は最初にヒープとパイプラインを設定している
+      if (!backend.calls.empty()) {
+        CHECK(backend.calls[0].kind == Call::Heaps);
+        CHECK(backend.calls[1].kind == Call::Pipeline);
+      }
+    }
+    CHECK(drawOrder == serial.DrawOrder());
+
+    RenderQueueStats stats{};
+    for (const auto &st : sliceStats) {
+      RenderQueue::Accumulate(stats, st);
+    }
+    queue.FinishFrame(stats);
+    CHECK(queue.GetStats().drawn == 500);
+    CHECK(queue.GetStats().pipelineBinds == pipelineBinds);
+    // 範囲の境目でやり直す分だけ増える
+    CHECK(pipelineBinds <= serialQueue.GetStats().pipelineBinds + listCount - 1);
+    CHECK(queue.GetStats().heapBinds == listCount);
+  }
+}
+
+} // namespace
+
+int main() {
+  TestDefaultOrder();
+  TestCustomGraph();
+  TestJobSystem();
+  TestParallelSlices();
+  JobSystem::GetInstance()->Finalize();
+  return TestCommon::Finish("RenderPassGraphTest");
+}
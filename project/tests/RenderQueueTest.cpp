@@ -0,0 +1,238 @@
+// RenderQueue の並べ替えと冗長なバインドの除去（記録するだけのバックエンドで確認）
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+
+#include "RecordingBackend.h"
+#include "RenderQueue.h"
+#include "RenderSortKey.h"
+#include "TestCommon.h"
+
+namespace {
+
+using Call = RecordingBackend::Call;
+
+RenderCommand MakeCommand(uint32_t id, RenderPass pass, uint32_t pipeline,
+                          uint64_t texture, uint64_t geometry, uint32_t depth) {
+  RenderCommand cmd{};
+  cmd.subset = id; // 再生順の確認用
+  cmd.pipeline = pipeline;
+  cmd.texture = texture;
+  cmd.geometry = geometry;
+  cmd.usesFrameConstants = pass == RenderPass::Opaque;
+  RenderSortKey::Fields key{};
+  key.pass = pass;
+  key.pipeline = pipeline;
+  key.material = RenderSortKey::Fold24(texture);
+  key.depth = depth;
+  cmd.sortKey = RenderSortKey::Make(key);
+  return cmd;
+}
+
+void TestSortOrder() {
+  RenderQueue queue;
+  // 積む順はばらばら
+  queue.Submit(MakeCommand(10, RenderPass::Sprites, 5, 1, 1, 0));
+  queue.Submit(MakeCommand(
+      2, RenderPass::Transparent, 2, 1, 1,
+      RenderSortKey::DepthBackToFront(50.0f))); // 奥の半透明が先
+  queue.Submit(MakeCommand(1, RenderPass::Opaque, 1, 1, 1,
+                           RenderSortKey::DepthFrontToBack(30.0f)));
+  queue.Submit(MakeCommand(0, RenderPass::Opaque, 1, 1, 1,
+                           RenderSortKey::DepthFrontToBack(5.0f)));
+  queue.Submit(MakeCommand(3, RenderPass::Transparent, 2, 1, 1,
+                           RenderSortKey::DepthBackToFront(10.0f)));
+  queue.Submit(MakeCommand(11, RenderPass::Sprites, 5, 1, 1, 1));
+  queue.Submit(MakeCommand(4, RenderPass::Skybox, 3, 2, 2, 0));
+
+  RecordingBackend backend;
+  queue.Execute(backend);
+  // Opaque(手前→奥) → 半透明(奥→手前) → Sprites(登録順)。Skybox は Opaque の後
+  const std::vector<uint64_t> expected = {0, 1, 4, 2, 3, 10, 11};
+  CHECK(backend.DrawOrder() == expected);
+  CHECK(queue.Size() == 0);
+  CHECK(queue.GetStats().submitted == 7 && queue.GetStats().drawn == 7);
+
+  // 再生順を変える: スプライトを一番先に
+  queue.SetPassOrder({RenderPass::Sprites, RenderPass::Opaque});
+  queue.Submit(MakeCommand(0, RenderPass::Opaque, 1, 1, 1, 0));
+  queue.Submit(MakeCommand(1, RenderPass::Transparent, 2, 1, 1, 0));
+  queue.Submit(MakeCommand(2, RenderPass::Sprites, 5, 1, 1, 0));
+  RecordingBackend reordered;
+  queue.Execute(reordered);
+  const std::vector<uint64_t> expectedReordered = {2, 0, 1};
+  CHECK(reordered.DrawOrder() == expectedReordered);
+}
+
+void TestRedundancyFilter() {
+  RenderQueue queue;
+  // 同じパイプライン・テクスチャで 2 つのメッシュ
+  for (uint32_t i = 0; i < 6; ++i) {
+    queue.Submit(MakeCommand(i, RenderPass::Opaque, 1, 100, 200 + i / 3, i));
+  }
+  RecordingBackend backend;
+  queue.Execute(backend);
+  CHECK(backend.Count(Call::Heaps) == 1);
+  CHECK(backend.Count(Call::Pipeline) == 1);
+  CHECK(backend.Count(Call::FrameConstants) == 1);
+  CHECK(backend.Count(Call::Texture) == 1);
+  CHECK(backend.Count(Call::Geometry) == 2);
+  CHECK(backend.Count(Call::Draw) == 6);
+
+  const RenderQueueStats &stats = queue.GetStats();
+  CHECK(stats.pipelineBinds == 1 && stats.pipelineBindsSaved == 5);
+  CHECK(stats.heapBinds == 1 && stats.heapBindsSaved == 5);
+  CHECK(stats.textureBinds == 1 && stats.textureBindsSaved == 5);
+  CHECK(stats.geometryBinds == 2 && stats.geometryBindsSaved == 4);
+  CHECK(stats.frameConstantBinds == 1 && stats.frameConstantBindsSaved == 5);
+  CHECK(stats.TotalBinds() + stats.TotalSaved() == 6 * 5);
+
+  // パイプラインが変わるとルートのバインドもやり直す
+  queue.Submit(MakeCommand(0, RenderPass::Opaque, 1, 100, 200, 0));
+  queue.Submit(MakeCommand(1, RenderPass::Opaque, 2, 100, 200, 0));
+  RecordingBackend switched;
+  queue.Execute(switched);
+  CHECK(switched.Count(Call::Pipeline) == 2);
+  CHECK(switched.Count(Call::FrameConstants) == 2);
+  CHECK(switched.Count(Call::Texture) == 2);
+  CHECK(switched.Count(Call::Geometry) == 2);
+  CHECK(switched.Count(Call::Heaps) == 1);
+}
+
+void TestInvalidatesState() {
+  // 同じブレンドモードのパーティクル描画が 2 つ並ぶと、2 つ目もパイプラインから設定し直す
+  // （1 つ目の Draw が独自にパイプライン・ヒープ・ルートを設定するため）
+  RenderQueue queue;
+  RenderCommand particlesA = MakeCommand(0, RenderPass::Particles, 7, 0, 0, 0);
+  particlesA.invalidatesState = true;
+  RenderCommand particlesB = MakeCommand(1, RenderPass::Particles, 7, 0, 0, 1);
+  particlesB.invalidatesState = true;
+  queue.Submit(particlesA);
+  queue.Submit(particlesB);
+  // その後に同じテクスチャ・頂点のスプライト 2 つ
+  queue.Submit(MakeCommand(2, RenderPass::Sprites, 5, 300, 400, 0));
+  queue.Submit(MakeCommand(3, RenderPass::Sprites, 5, 300, 400, 1));
+
+  RecordingBackend backend;
+  queue.Execute(backend);
+  const std::vector<Call> &calls = backend.calls;
+  // Heaps Pipeline(7) Draw | Heaps Pipeline(7) Draw | Heaps Pipeline(5) Tex Geo Draw | Draw
+  const std::vector<Call::Kind> expected = {
+      Call::Heaps, Call::Pipeline, Call::Draw,     Call::Heaps,
+      Call::Pipeline, Call::Draw,  Call::Heaps,    Call::Pipeline,
+      Call::Texture, Call::Geometry, Call::Draw,   Call::Draw};
+  CHECK(calls.size() == expected.size());
+  for (size_t i = 0; i < std::min(calls.size(), expected.size()); ++i) {
+    CHECK(calls[i].kind == expected[i]);
+  }
+  CHECK(backend.Count(Call::Pipeline) == 3);
+  CHECK(queue.GetStats().pipelineBinds == 3);
+  CHECK(queue.GetStats().heapBinds == 3);
+}
+
+void TestExecuteRange() {
+  // 範囲ごとの再生は、それぞれ何もバインドされていない状態から始める
+  RenderQueue queue;
+  for (uint32_t i = 0; i < 8; ++i) {
+    queue.Submit(MakeCommand(i, RenderPass::Opaque, 1, 100, 200, i));
+  }
+  queue.Sort();
+  RenderQueueStats total{};
+  std::vector<uint64_t> order;
+  for (size_t begin = 0; begin < 8; begin += 3) {
+    RecordingBackend backend;
+    RenderQueueStats stats{};
+    queue.ExecuteRange(backend, begin, begin + 3, stats);
+    CHECK(backend.Count(Call::Pipeline) == 1);
+    CHECK(backend.Count(Call::Heaps) == 1);
+    const auto drawn = backend.DrawOrder();
+    order.insert(order.end(), drawn.begin(), drawn.end());
+    RenderQueue::Accumulate(total, stats);
+  }
+  queue.FinishFrame(total);
+  std::vector<uint64_t> expected(8);
+  std::iota(expected.begin(), expected.end(), 0);
+  CHECK(order == expected);
+  CHECK(queue.GetStats().drawn == 8 && queue.GetStats().submitted == 8);
+  CHECK(queue.GetStats().pipelineBinds == 3);
+  CHECK(queue.Size() == 0);
+}
+
+void TestRadixSort() {
+  std::mt19937_64 rng(42);
+  for (size_t n : {0u, 1u, 2u, 17u, 1000u, 65536u}) {
+    std::vector<uint64_t> keys(n);
+    for (auto &key : keys) {
+      // 上位だけ・下位だけが変わる列も混ぜる（同じ桁の飛ばしを通す）
+      const uint64_t r = rng();
+      key = (n % 2 == 0) ? (r & 0xFF000000000000FFull) : (r % 97);
+    }
+    std::vector<uint64_t> reference = keys;
+    std::vector<uint32_t> referenceOrder(n);
+    std::iota(referenceOrder.begin(), referenceOrder.end(), 0u);
+    std::stable_sort(referenceOrder.begin(), referenceOrder.end(),
+                     [&](uint32_t a, uint32_t b) {
+                       return reference[a] < reference[b];
+                     });
+    std::sort(reference.begin(), reference.end());
+
+    std::vector<uint32_t> order;
+    RadixSortKeys(keys, order);
+    CHECK(keys == reference);
+    CHECK(order == referenceOrder); // 安定
+  }
+}
+
+void Benchmark() {
+  constexpr size_t kCount = 100000;
+  std::mt19937_64 rng(1);
+  std::vector<uint64_t> source(kCount);
+  for (auto &key : source) {
+    RenderSortKey::Fields f{};
+    f.pass = static_cast<RenderPass>(rng() % 5);
+    f.pipeline = uint32_t(rng() % 12);
+    f.material = uint32_t(rng());
+    f.depth = uint32_t(rng());
+    key = RenderSortKey::Make(f);
+  }
+
+  constexpr int kRuns = 10;
+  double radixMs = 0.0;
+  double stdMs = 0.0;
+  for (int run = 0; run < kRuns; ++run) {
+    std::vector<uint64_t> keys = source;
+    std::vector<uint32_t> order;
+    auto start = std::chrono::steady_clock::now();
+    RadixSortKeys(keys, order);
+    radixMs += std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
+    std::vector<uint32_t> indices(kCount);
+    std::iota(indices.begin(), indices.end(), 0u);
+    start = std::chrono::steady_clock::now();
+    std::stable_sort(indices.begin(), indices.end(), [&](uint32_t a, uint32_t b) {
+      return source[a] < source[b];
+    });
+    stdMs += std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - start)
+                 .count();
+    CHECK(order == indices);
+  }
+  std::printf("RadixSortKeys: %zu keys %.3f ms (std::stable_sort %.3f ms)\n",
+              kCount, radixMs / kRuns, stdMs / kRuns);
+}
+
+} // namespace
+
+int main() {
+  TestSortOrder();
+  TestRedundancyFilter();
+  TestInvalidatesState();
+  TestExecuteRange();
+  TestRadixSort();
+  Benchmark();
+  return TestCommon::Finish("RenderQueueTest");
+}
@@ -0,0 +1,114 @@
+// RingAllocator（GpuUploadQueue のステージングリング）の折り返しと解放
+#include <deque>
+#include <random>
+#include <utility>
+
+#include "RingAllocator.h"
+#include "TestCommon.h"
+
+namespace {
+
+// D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+constexpr uint64_t kAlignment = 512;
+
+void TestWrap() {
+  RingAllocator ring(4096);
+  CHECK(ring.Allocate(1000, kAlignment) == 0);
+  CHECK(ring.Allocate(1000, kAlignment) == 1024); // 24 バイトは詰め物
+  CHECK(ring.GetUsed() == 2024);
+  CHECK(ring.Allocate(1500, kAlignment) == 2048);
+  CHECK(ring.GetUsed() == 3548);
+
+  // 末尾の 548 バイトには入らない。先頭はまだ使用中
+  CHECK(ring.Allocate(600, kAlignment) == RingAllocator::kInvalidOffset);
+  CHECK(ring.GetUsed() == 3548);
+
+  // 古い順に 1 つ目を返すと、末尾の余りを詰め物にして先頭へ折り返す
+  ring.Release(1000);
+  CHECK(ring.Allocate(600, kAlignment) == 0);
+  CHECK(ring.GetUsed() == 2548 + 548 + 600);
+
+  // 残りを全て返すと空になる（それぞれ前の詰め物込み）
+  ring.Release(1024);
+  ring.Release(24 + 1500);
+  ring.Release(548 + 600);
+  CHECK(ring.GetUsed() == 0);
+
+  // 大きすぎる確保
+  CHECK(ring.Allocate(4097, 1) == RingAllocator::kInvalidOffset);
+  CHECK(ring.Allocate(4096 - 600, 1) == 600);
+  CHECK(ring.GetUsed() == 4096 - 600);
+}
+
+void TestExactFit() {
+  // ちょうど末尾まで使うと次は先頭から（詰め物なし）
+  RingAllocator ring(2048);
+  CHECK(ring.Allocate(2048, kAlignment) == 0);
+  CHECK(ring.Allocate(1, 1) == RingAllocator::kInvalidOffset);
+  ring.Release(2048);
+  CHECK(ring.Allocate(512, kAlignment) == 0);
+  CHECK(ring.GetUsed() == 512);
+}
+
+// 投入（確保の束）を FIFO で完了させながら回し、使用中の範囲が重ならないことを確かめる
+void Fuzz() {
+  constexpr uint64_t kCapacity = 1 << 20;
+  RingAllocator ring(kCapacity);
+  std::mt19937 rng(7);
+  // 使用中の範囲と、その確保で増えた使用量
+  struct Live {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t consumed;
+  };
+  std::deque<Live> live;
+  bool ok = true;
+  uint64_t wraps = 0;
+  for (int it = 0; it < 100000 && ok; ++it) {
+    if (live.empty() || rng() % 3 != 0) {
+      const uint64_t size = 1 + rng() % (rng() % 8 == 0 ? 200000u : 5000u);
+      const uint64_t before = ring.GetUsed();
+      const uint64_t offset = ring.Allocate(size, kAlignment);
+      if (offset == RingAllocator::kInvalidOffset) {
+        continue;
+      }
+      ok = offset % kAlignment == 0 && offset + size <= kCapacity;
+      if (!live.empty()) {
+        const Live &oldest = live.front();
+        const Live &newest = live.back();
+        wraps += offset < newest.offset ? 1 : 0;
+        // 新しい確保は、一番古い確保の先頭を越えない
+        if (offset < oldest.offset) {
+          ok = ok && offset + size <= oldest.offset;
+        } else {
+          ok = ok && offset >= newest.offset + newest.size;
+        }
+      }
+      live.push_back({offset, size, ring.GetUsed() - before});
+    } else {
+      ring.Release(live.front().consumed);
+      live.pop_front();
+    }
+    uint64_t consumed = 0;
+    for (const Live &l : live) {
+      consumed += l.consumed;
+    }
+    ok = ok && consumed == ring.GetUsed() && ring.GetUsed() <= kCapacity;
+  }
+  CHECK(ok);
+  CHECK(wraps > 10);
+  while (!live.empty()) {
+    ring.Release(live.front().consumed);
+    live.pop_front();
+  }
+  CHECK(ring.GetUsed() == 0);
+}
+
+} // namespace
+
+int main() {
+  TestWrap();
+  TestExactFit();
+  Fuzz();
+  return TestCommon::Finish("RingAllocatorTest");
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+
+// テスト用の最小限のマクロ
+// - CHECK は失敗しても続ける（最後に TestCommon::Finish が終了コードを返す）
+// - 依存を増やさないため、テストフレームワークは使わない
+namespace TestCommon {
+
+inline int &Failures() {
+  static int failures = 0;
+  return failures;
+}
+
+inline int Finish(const char *name) {
+  if (Failures() == 0) {
+    std::printf("%s: ok\n", name);
+    return 0;
+  }
+  std::printf("%s: %d failure(s)\n", name, Failures());
+  return 1;
+}
+
+} // namespace TestCommon
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);     \
+      ++TestCommon::Failures();                                                \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_NEAR(a, b, eps)                                                  \
+  do {                                                                         \
+    const double checkA_ = double(a);                                          \
+    const double checkB_ = double(b);                                          \
+    if (!(std::fabs(checkA_ - checkB_) <= double(eps))) {                      \
+      std::printf("%s:%d: CHECK_NEAR(%s, %s) failed: %g vs %g\n", __FILE__,   \
+                  __LINE__, #a, #b, checkA_, checkB_);                         \
+      ++TestCommon::Failures();                                                \
+    }                                                                          \
+  } while (0)
@@ -0,0 +1,109 @@
+// TextureCache: 書き出したキャッシュをマップして、ヘッダの確認とミップの位置・大きさ・中身
+// （ストリーミングは細かいミップを後からここから読む）
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <tuple>
+#include <vector>
+
+#include "MappedFile.h"
+#include "TestCommon.h"
+#include "TextureCache.h"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr uint32_t kBc7 = 98;   // DXGI_FORMAT_BC7_UNORM
+constexpr uint32_t kBc1 = 71;   // DXGI_FORMAT_BC1_UNORM
+constexpr uint32_t kRgba8 = 28; // DXGI_FORMAT_R8G8B8A8_UNORM
+constexpr size_t kHeaderSize = 148;
+
+fs::path gDir;
+
+// ミップ i は (i + 1) で埋める。1x1 まで
+std::vector<std::vector<uint8_t>> MakeMips(uint32_t format, uint32_t width,
+                                           uint32_t height) {
+  std::vector<std::vector<uint8_t>> mips;
+  for (uint32_t i = 0;; ++i) {
+    const uint32_t w = std::max(width >> i, 1u), h = std::max(height >> i, 1u);
+    mips.emplace_back(TextureCache::GetMipSize(format, w, h), uint8_t(i + 1));
+    if (w == 1 && h == 1) {
+      break;
+    }
+  }
+  return mips;
+}
+
+void TestRoundTrip() {
+  for (auto [format, width, height] :
+       {std::tuple{kBc7, 256u, 64u}, std::tuple{kBc1, 20u, 12u},
+        std::tuple{kRgba8, 7u, 3u}}) {
+    const auto mips = MakeMips(format, width, height);
+    const std::string path = (gDir / "round.png.cooked.dds").string();
+    const TextureCache::CookKey key{0x123456789abcdefull, 1};
+    CHECK(TextureCache::Save(path, key, format, width, height, mips));
+
+    MappedFile file;
+    CHECK(TextureCache::Open(path, key, file));
+    if (!file.IsOpen()) {
+      continue;
+    }
+    const TextureCache::Info info = TextureCache::GetInfo(file);
+    CHECK(info.dxgiFormat == format && info.width == width &&
+          info.height == height && info.mipCount == mips.size());
+
+    size_t offset = kHeaderSize;
+    for (uint32_t i = 0; i < mips.size(); ++i) {
+      TextureCache::MipView view{};
+      CHECK(TextureCache::GetMip(file, i, view));
+      CHECK(view.width == std::max(width >> i, 1u) &&
+            view.height == std::max(height >> i, 1u));
+      CHECK(view.size == mips[i].size());
+      CHECK(view.data == file.GetData() + offset);
+      CHECK(std::memcmp(view.data, mips[i].data(), view.size) == 0);
+      // 行の間隔: BC は 4x4 ブロック 1 行、RGBA8 は 1 画素の行
+      const size_t rows = format == kRgba8 ? view.height : (view.height + 3) / 4;
+      CHECK(view.rowPitch * rows == view.size);
+      offset += view.size;
+    }
+    CHECK(offset == file.GetSize());
+    TextureCache::MipView view{};
+    CHECK(!TextureCache::GetMip(file, uint32_t(mips.size()), view));
+  }
+}
+
+void TestRejects() {
+  const auto mips = MakeMips(kBc7, 64, 32);
+  const std::string path = (gDir / "reject.png.cooked.dds").string();
+  const TextureCache::CookKey key{42, 0};
+  CHECK(TextureCache::Save(path, key, kBc7, 64, 32, mips));
+
+  MappedFile file;
+  CHECK(!TextureCache::Open(path, {43, 0}, file) && !file.IsOpen());
+  CHECK(!TextureCache::Open(path, {42, 2}, file) && !file.IsOpen());
+  CHECK(!TextureCache::Open((gDir / "missing.dds").string(), key, file));
+
+  // 途中で切れたファイル
+  fs::resize_file(path, fs::file_size(path) - 1);
+  CHECK(!TextureCache::Open(path, key, file));
+
+  // ミップの大きさが合わない・形式が未対応なら書かない
+  auto broken = mips;
+  broken[1].pop_back();
+  CHECK(!TextureCache::Save(path, key, kBc7, 64, 32, broken));
+  CHECK(!TextureCache::Save(path, key, 2 /* R32G32B32A32_FLOAT */, 64, 32, mips));
+  CHECK(!fs::exists(path + ".tmp"));
+}
+
+} // namespace
+
+int main() {
+  gDir = fs::temp_directory_path() / "TextureCacheTest";
+  fs::remove_all(gDir);
+  fs::create_directories(gDir);
+  TestRoundTrip();
+  TestRejects();
+  fs::remove_all(gDir);
+  return TestCommon::Finish("TextureCacheTest");
+}
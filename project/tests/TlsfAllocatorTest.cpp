@@ -0,0 +1,172 @@
+// TlsfAllocator（GpuMemoryAllocator のヒープ内の確保）の重なり・結合・断片化
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "TlsfAllocator.h"
+#include "TestCommon.h"
+
+namespace {
+
+constexpr uint64_t kHeapSize = 64ull << 20;
+
+void TestBasics() {
+  TlsfAllocator tlsf(kHeapSize);
+  CHECK(tlsf.IsEmpty());
+
+  // ヒープ全体をそのまま取れる
+  TlsfAllocator::Allocation whole = tlsf.Allocate(kHeapSize);
+  CHECK(whole.IsValid() && whole.offset == 0 && whole.size == kHeapSize);
+  CHECK(!tlsf.Allocate(1).IsValid());
+  tlsf.Free(whole.handle);
+  TlsfAllocator::Stats stats = tlsf.GetStats();
+  CHECK(stats.freeBlockCount == 1 && stats.largestFreeBlock == kHeapSize);
+
+  // サイズは最小単位に切り上げ、0 と大きすぎる要求は失敗
+  TlsfAllocator::Allocation small = tlsf.Allocate(1);
+  CHECK(small.IsValid() && small.size == TlsfAllocator::kMinBlockSize);
+  CHECK(!tlsf.Allocate(0).IsValid());
+  CHECK(!tlsf.Allocate(kHeapSize + 1).IsValid());
+
+  // 64KB 揃え（配置リソースの既定）: 先頭の詰め物は空きとして残る
+  TlsfAllocator::Allocation aligned = tlsf.Allocate(1000, 64 * 1024);
+  CHECK(aligned.IsValid() && aligned.offset == 64 * 1024);
+  stats = tlsf.GetStats();
+  CHECK(stats.allocationCount == 2);
+  CHECK(stats.usedBytes == small.size + aligned.size);
+
+  // 詰め物の空きに小さい確保が入る
+  TlsfAllocator::Allocation filler = tlsf.Allocate(512);
+  CHECK(filler.IsValid() && filler.offset < aligned.offset);
+
+  // 全て解放すると 1 ブロックに戻る（前後の結合）
+  tlsf.Free(aligned.handle);
+  tlsf.Free(small.handle);
+  tlsf.Free(filler.handle);
+  stats = tlsf.GetStats();
+  CHECK(tlsf.IsEmpty());
+  CHECK(stats.freeBlockCount == 1 && stats.largestFreeBlock == kHeapSize);
+  CHECK(stats.Fragmentation() == 0.0f);
+}
+
+void TestCoalesce() {
+  // 真ん中を空けてから両隣を解放すると 3 つが 1 つになる
+  TlsfAllocator tlsf(4096);
+  TlsfAllocator::Allocation a = tlsf.Allocate(1024);
+  TlsfAllocator::Allocation b = tlsf.Allocate(1024);
+  TlsfAllocator::Allocation c = tlsf.Allocate(1024);
+  TlsfAllocator::Allocation d = tlsf.Allocate(1024);
+  CHECK(d.IsValid() && !tlsf.Allocate(1).IsValid());
+  tlsf.Free(b.handle);
+  tlsf.Free(d.handle);
+  TlsfAllocator::Stats stats = tlsf.GetStats();
+  CHECK(stats.freeBlockCount == 2 && stats.largestFreeBlock == 1024);
+  CHECK(stats.Fragmentation() == 0.5f);
+  // 空きが 1024 ずつしかないので 2048 は入らない
+  CHECK(!tlsf.Allocate(2048).IsValid());
+  tlsf.Free(c.handle);
+  stats = tlsf.GetStats();
+  CHECK(stats.freeBlockCount == 1 && stats.largestFreeBlock == 3072);
+  TlsfAllocator::Allocation big = tlsf.Allocate(3072);
+  CHECK(big.IsValid() && big.offset == 1024);
+  tlsf.Free(a.handle);
+  tlsf.Free(big.handle);
+  CHECK(tlsf.GetStats().freeBlockCount == 1);
+}
+
+// 大小混ざった確保と解放をランダムに繰り返し、重なりと範囲を毎回確かめる
+void Fuzz() {
+  TlsfAllocator tlsf(kHeapSize);
+  std::mt19937 rng(1);
+  std::vector<TlsfAllocator::Allocation> live;
+  std::map<uint64_t, uint64_t> ranges; // offset -> size
+  bool ok = true;
+  uint32_t failed = 0;
+  for (int it = 0; it < 200000 && ok; ++it) {
+    if (live.empty() || rng() % 3 != 0) {
+      const uint64_t size =
+          1 + rng() % (rng() % 4 == 0 ? (4u << 20) : 65536u);
+      const uint64_t alignment = 1ull << (8 + rng() % 9);
+      const TlsfAllocator::Allocation a = tlsf.Allocate(size, alignment);
+      if (!a.IsValid()) {
+        ++failed;
+        continue;
+      }
+      ok = a.offset % alignment == 0 && a.size >= size &&
+           a.offset + a.size <= kHeapSize;
+      auto next = ranges.lower_bound(a.offset);
+      if (next != ranges.end()) {
+        ok = ok && a.offset + a.size <= next->first;
+      }
+      if (next != ranges.begin()) {
+        auto prev = std::prev(next);
+        ok = ok && prev->first + prev->second <= a.offset;
+      }
+      ranges[a.offset] = a.size;
+      live.push_back(a);
+    } else {
+      const size_t i = rng() % live.size();
+      tlsf.Free(live[i].handle);
+      ranges.erase(live[i].offset);
+      live[i] = live.back();
+      live.pop_back();
+    }
+  }
+  CHECK(ok);
+
+  const TlsfAllocator::Stats stats = tlsf.GetStats();
+  uint64_t used = 0;
+  for (const auto &a : live) {
+    used += a.size;
+  }
+  CHECK(stats.usedBytes == used);
+  CHECK(stats.allocationCount == live.size());
+  std::printf("TlsfAllocator fuzz: live %zu, used %.1f%%, fragmentation %.3f, "
+              "free blocks %u, failed %u\n",
+              live.size(), 100.0 * double(stats.usedBytes) / double(kHeapSize),
+              stats.Fragmentation(), stats.freeBlockCount, failed);
+
+  for (const auto &a : live) {
+    tlsf.Free(a.handle);
+  }
+  const TlsfAllocator::Stats empty = tlsf.GetStats();
+  CHECK(empty.freeBlockCount == 1 && empty.usedBytes == 0 &&
+        empty.largestFreeBlock == kHeapSize);
+}
+
+void Benchmark() {
+  TlsfAllocator tlsf(kHeapSize);
+  std::vector<uint32_t> handles;
+  handles.reserve(1000);
+  constexpr int kRounds = 2000;
+  const auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < kRounds; ++round) {
+    for (int i = 0; i < 1000; ++i) {
+      const TlsfAllocator::Allocation a =
+          tlsf.Allocate(256 + (i * 37 % 64) * 256, 256);
+      CHECK(a.IsValid());
+      handles.push_back(a.handle);
+    }
+    for (uint32_t handle : handles) {
+      tlsf.Free(handle);
+    }
+    handles.clear();
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  std::printf("TlsfAllocator: %.1f M allocate+free/s\n",
+              kRounds * 1000.0 / seconds / 1e6);
+}
+
+} // namespace
+
+int main() {
+  TestBasics();
+  TestCoalesce();
+  Fuzz();
+  Benchmark();
+  return TestCommon::Finish("TlsfAllocatorTest");
+}
@@ -0,0 +1,153 @@
+// VertexPacking の往復（half・八面体法線・位置の量子化）
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "TestCommon.h"
+#include "VertexPacking.h"
+
+namespace {
+
+constexpr double kPi = 3.14159265358979;
+
+// 1 に近い内積は float の acos だと粗いので double で測る
+float AngleDegrees(const Vector3 &a, const Vector3 &b) {
+  const double dot = double(a.x) * b.x + double(a.y) * b.y + double(a.z) * b.z;
+  const double length =
+      std::sqrt((double(a.x) * a.x + double(a.y) * a.y + double(a.z) * a.z) *
+                (double(b.x) * b.x + double(b.y) * b.y + double(b.z) * b.z));
+  return float(std::acos(std::clamp(dot / length, -1.0, 1.0)) * 180.0 / kPi);
+}
+
+void TestHalf() {
+  // 全ての half が float を経由して同じビットに戻る（NaN は NaN のまま）
+  int mismatches = 0;
+  for (uint32_t h = 0; h < 65536; ++h) {
+    const float f = VertexPacking::HalfToFloat(uint16_t(h));
+    const uint16_t back = VertexPacking::FloatToHalf(f);
+    const bool isNan = ((h >> 10) & 31) == 31 && (h & 1023) != 0;
+    if (isNan) {
+      mismatches += (((back >> 10) & 31) == 31 && (back & 1023) != 0) ? 0 : 1;
+    } else {
+      mismatches += back == h ? 0 : 1;
+    }
+  }
+  CHECK(mismatches == 0);
+
+  // 丸めは最近接偶数、範囲外は無限大、小さすぎる値は非正規化数 → 0
+  CHECK(VertexPacking::FloatToHalf(1.0f) == 0x3C00);
+  CHECK(VertexPacking::FloatToHalf(-2.0f) == 0xC000);
+  CHECK(VertexPacking::FloatToHalf(65504.0f) == 0x7BFF);
+  CHECK(VertexPacking::FloatToHalf(1e6f) == 0x7C00);
+  CHECK(VertexPacking::FloatToHalf(-1e6f) == 0xFC00);
+  CHECK(VertexPacking::FloatToHalf(5.9604645e-8f) == 0x0001);
+  CHECK(VertexPacking::FloatToHalf(1e-9f) == 0x0000);
+  CHECK(VertexPacking::FloatToHalf(1.0f + 1.0f / 2048.0f) == 0x3C00); // 偶数側
+  CHECK(VertexPacking::FloatToHalf(1.0f + 3.0f / 2048.0f) == 0x3C02);
+
+  // UV の範囲 [0, 1] では誤差が 1/2048 以内
+  float maxError = 0.0f;
+  for (int i = 0; i <= 4096; ++i) {
+    const float f = float(i) / 4096.0f;
+    const float back =
+        VertexPacking::HalfToFloat(VertexPacking::FloatToHalf(f));
+    maxError = std::max(maxError, std::fabs(back - f));
+  }
+  CHECK(maxError <= 1.0f / 2048.0f);
+}
+
+void TestOctahedral() {
+  std::mt19937 rng(1);
+  std::normal_distribution<float> normal;
+  float maxError = 0.0f;
+  for (int i = 0; i < 200000; ++i) {
+    Vector3 n{normal(rng), normal(rng), normal(rng)};
+    const float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+    if (length < 1e-6f) {
+      continue;
+    }
+    n = {n.x / length, n.y / length, n.z / length};
+    int16_t encoded[2];
+    VertexPacking::EncodeOctahedral(n, encoded);
+    maxError = std::max(maxError,
+                        AngleDegrees(n, VertexPacking::DecodeOctahedral(encoded)));
+  }
+  // 軸と下半球の折り返しの境目
+  const Vector3 edges[] = {{1, 0, 0},  {-1, 0, 0}, {0, 1, 0},
+                           {0, -1, 0}, {0, 0, 1},  {0, 0, -1},
+                           {0.70710678f, 0, -0.70710678f}};
+  for (const Vector3 &n : edges) {
+    int16_t encoded[2];
+    VertexPacking::EncodeOctahedral(n, encoded);
+    const Vector3 decoded = VertexPacking::DecodeOctahedral(encoded);
+    maxError = std::max(maxError, AngleDegrees(n, decoded));
+    const float length = std::sqrt(decoded.x * decoded.x +
+                                   decoded.y * decoded.y + decoded.z * decoded.z);
+    CHECK_NEAR(length, 1.0f, 1e-4f);
+  }
+  std::printf("octahedral: max angular error %.4f deg\n", maxError);
+  CHECK(maxError < 0.01f);
+}
+
+void TestPosition() {
+  const float points[][3] = {{-50.0f, 0.0f, -50.0f},
+                             {50.0f, 3.0f, 50.0f},
+                             {0.0f, 1.5f, 0.0f},
+                             {12.345f, 0.001f, -7.77f}};
+  const PackedVertexBounds bounds =
+      VertexPacking::ComputeBounds(&points[0][0], sizeof(points[0]), 4);
+  CHECK(bounds.min.x == -50.0f && bounds.min.y == 0.0f);
+  CHECK(bounds.extent.x == 100.0f && bounds.extent.y == 3.0f);
+
+  const Matrix4x4 dequantize = VertexPacking::MakeDequantizeMatrix(bounds);
+  float maxError = 0.0f;
+  for (const auto &p : points) {
+    const PackedVertex packed =
+        VertexPacking::Pack({p[0], p[1], p[2], 1.0f}, {0.25f, 0.75f},
+                            {0.0f, 1.0f, 0.0f}, bounds);
+    Vector4 position;
+    Vector2 texcoord;
+    Vector3 normal;
+    VertexPacking::Unpack(packed, bounds, position, texcoord, normal);
+    CHECK(position.w == 1.0f);
+    CHECK(texcoord.x == 0.25f && texcoord.y == 0.75f);
+    CHECK_NEAR(normal.y, 1.0f, 1e-4f);
+    maxError = std::max({maxError, std::fabs(position.x - p[0]),
+                         std::fabs(position.y - p[1]),
+                         std::fabs(position.z - p[2])});
+
+    // シェーダ側: UNORM の値を行列に通すと同じ位置になる
+    float unorm[4];
+    for (int c = 0; c < 4; ++c) {
+      unorm[c] = float(packed.position[c]) / 65535.0f;
+    }
+    for (int c = 0; c < 3; ++c) {
+      float world = dequantize.m[3][c];
+      for (int r = 0; r < 3; ++r) {
+        world += unorm[r] * dequantize.m[r][c];
+      }
+      const float unpacked = c == 0 ? position.x : c == 1 ? position.y : position.z;
+      CHECK_NEAR(world, unpacked, 1e-4f);
+    }
+    CHECK(unorm[3] == 1.0f);
+  }
+  // 範囲 100 を 65535 段に分けた半分が誤差の上限
+  CHECK(maxError <= 100.0f / 65535.0f * 0.5f + 1e-5f);
+
+  // 平らなメッシュ（範囲 0 の軸）は 1 に置き換わる
+  const float flat[][3] = {{1.0f, 2.0f, 3.0f}, {4.0f, 2.0f, 5.0f}};
+  const PackedVertexBounds flatBounds =
+      VertexPacking::ComputeBounds(&flat[0][0], sizeof(flat[0]), 2);
+  CHECK(flatBounds.extent.y == 1.0f);
+}
+
+} // namespace
+
+int main() {
+  TestHalf();
+  TestOctahedral();
+  TestPosition();
+  return TestCommon::Finish("VertexPackingTest");
+}
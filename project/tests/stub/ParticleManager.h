@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "Vector.h"
+
+// テスト用の ParticleManager（D3D12 を使わず、Emit の引数を記録するだけ）
+// ParticleEmitter.cpp を Linux でそのままビルドするために、本物より先に見つかる場所に置く
+class ParticleManager {
+public:
+  struct EmitRecord {
+    std::string name;
+    Vector3 position;
+    Vector3 velocity;
+    Vector3 scale;
+    float lifetime;
+    Vector4 color;
+    float rotation;
+    float angularVelocity;
+  };
+
+  void Emit(const std::string &name, const Vector3 &position,
+            const Vector3 &velocity, const Vector3 &scale, float lifetime,
+            const Vector4 &color, float rotation = 0.0f,
+            float angularVelocity = 0.0f) {
+    records.push_back({name, position, velocity, scale, lifetime, color,
+                       rotation, angularVelocity});
+  }
+
+  std::vector<EmitRecord> records;
+};
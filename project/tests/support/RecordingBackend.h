@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RenderQueue.h"
+
+// 呼ばれた順に記録するだけの描画バックエンド（RenderQueue のテスト用）
+class RecordingBackend : public IRenderBackend {
+public:
+  struct Call {
+    enum Kind { Heaps, Pipeline, FrameConstants, Texture, Geometry, Draw };
+    Kind kind;
+    uint64_t value; // Pipeline: ID / Texture・Geometry: ハンドル / Draw: subset
+  };
+
+  void BindDescriptorHeaps() override { calls.push_back({Call::Heaps, 0}); }
+  void BindPipeline(uint32_t pipeline) override {
+    calls.push_back({Call::Pipeline, pipeline});
+  }
+  void BindFrameConstants(uint32_t pipeline) override {
+    calls.push_back({Call::FrameConstants, pipeline});
+  }
+  void BindTexture(const RenderCommand &cmd) override {
+    calls.push_back({Call::Texture, cmd.texture});
+  }
+  void BindGeometry(const RenderCommand &cmd) override {
+    calls.push_back({Call::Geometry, cmd.geometry});
+  }
+  void Draw(const RenderCommand &cmd) override {
+    calls.push_back({Call::Draw, cmd.subset});
+  }
+
+  size_t Count(Call::Kind kind) const {
+    size_t n = 0;
+    for (const Call &call : calls) {
+      n += call.kind == kind ? 1 : 0;
+    }
+    return n;
+  }
+
+  // Draw の subset を再生順に
+  std::vector<uint64_t> DrawOrder() const {
+    std::vector<uint64_t> order;
+    for (const Call &call : calls) {
+      if (call.kind == Call::Draw) {
+        order.push_back(call.value);
+      }
+    }
+    return order;
+  }
+
+  std::vector<Call> calls;
+};
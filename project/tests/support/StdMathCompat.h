@@ -0,0 +1,11 @@
+#pragma once
+// MSVC は std::cosf 等を <cmath> に置くが、libstdc++ には無い（Method.cpp 用）
+#include <cmath>
+#include <math.h>
+
+namespace std {
+using ::cosf;
+using ::sinf;
+using ::sqrtf;
+using ::tanf;
+} // namespace std